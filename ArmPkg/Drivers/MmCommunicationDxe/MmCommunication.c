@@ -41,6 +41,10 @@ STATIC EFI_HANDLE  mMmCommunicateHandle;
 
   This function provides a service to send and receive messages from a registered UEFI service.
 
+  If the communication buffer already lies within the buffer shared with the
+  secure world, it is passed to the MM environment in place, which validates
+  it, instead of being copied to the start of the shared buffer and back.
+
   @param[in] This                     The EFI_MM_COMMUNICATION_PROTOCOL instance.
   @param[in, out] CommBufferPhysical  Physical address of the MM communication buffer
   @param[in, out] CommBufferVirtual   Virtual address of the MM communication buffer
@@ -79,6 +83,9 @@ MmCommunication2Communicate (
   ARM_SMC_ARGS               CommunicateSmcArgs;
   EFI_STATUS                 Status;
   UINTN                      BufferSize;
+  UINTN                      ReplySize;
+  UINTN                      BufferOffset;
+  BOOLEAN                    InPlace;
 
   Status     = EFI_ACCESS_DENIED;
   BufferSize = 0;
@@ -145,11 +152,25 @@ MmCommunication2Communicate (
   // Cookie
   CommunicateSmcArgs.Arg1 = 0;
 
-  // Copy Communication Payload
-  CopyMem ((VOID *)mNsCommBuffMemRegion.VirtualBase, CommBufferVirtual, BufferSize);
+  //
+  // A payload which fits in the shared buffer at its current location does
+  // not need to be copied. This mirrors the checks of the MM environment.
+  //
+  BufferOffset = (UINTN)CommBufferPhysical - (UINTN)mNsCommBuffMemRegion.PhysicalBase;
+  InPlace      = ((UINTN)CommBufferPhysical >= mNsCommBuffMemRegion.PhysicalBase) &&
+                 (BufferOffset < mNsCommBuffMemRegion.Length) &&
+                 (BufferSize < mNsCommBuffMemRegion.Length - BufferOffset);
+
+  if (InPlace) {
+    // comm_buffer_address (64-bit physical address)
+    CommunicateSmcArgs.Arg2 = (UINTN)CommBufferPhysical;
+  } else {
+    // Copy Communication Payload
+    CopyMem ((VOID *)mNsCommBuffMemRegion.VirtualBase, CommBufferVirtual, BufferSize);
 
-  // comm_buffer_address (64-bit physical address)
-  CommunicateSmcArgs.Arg2 = (UINTN)mNsCommBuffMemRegion.PhysicalBase;
+    // comm_buffer_address (64-bit physical address)
+    CommunicateSmcArgs.Arg2 = (UINTN)mNsCommBuffMemRegion.PhysicalBase;
+  }
 
   // comm_size_address (not used, indicated by setting to zero)
   CommunicateSmcArgs.Arg3 = 0;
@@ -159,19 +180,30 @@ MmCommunication2Communicate (
 
   switch (CommunicateSmcArgs.Arg0) {
     case ARM_SMC_MM_RET_SUCCESS:
-      ZeroMem (CommBufferVirtual, BufferSize);
+      if (InPlace) {
+        // The MM environment has updated the payload in place
+        Status = EFI_SUCCESS;
+        break;
+      }
+
       // On successful return, the size of data being returned is inferred from
       // MessageLength + Header.
       CommunicateHeader = (EFI_MM_COMMUNICATE_HEADER *)mNsCommBuffMemRegion.VirtualBase;
-      BufferSize        = CommunicateHeader->MessageLength +
+      ReplySize         = CommunicateHeader->MessageLength +
                           sizeof (CommunicateHeader->HeaderGuid) +
                           sizeof (CommunicateHeader->MessageLength);
 
       CopyMem (
         CommBufferVirtual,
         (VOID *)mNsCommBuffMemRegion.VirtualBase,
-        BufferSize
+        ReplySize
         );
+
+      // Clear what is left of the request beyond the reply
+      if (ReplySize < BufferSize) {
+        ZeroMem ((UINT8 *)CommBufferVirtual + ReplySize, BufferSize - ReplySize);
+      }
+
       Status = EFI_SUCCESS;
       break;
 
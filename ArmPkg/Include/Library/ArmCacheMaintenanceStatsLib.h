@@ -0,0 +1,57 @@
+/** @file
+  Statistics of the range based cache maintenance operations.
+
+  Copyright (c) 2021, ARM Limited. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef ARM_CACHE_MAINTENANCE_STATS_LIB_H_
+#define ARM_CACHE_MAINTENANCE_STATS_LIB_H_
+
+typedef enum {
+  ArmCacheOperationInvalidateInstruction,
+  ArmCacheOperationWriteBackInvalidateData,
+  ArmCacheOperationWriteBackData,
+  ArmCacheOperationInvalidateData,
+  ArmCacheOperationMax
+} ARM_CACHE_OPERATION;
+
+typedef struct {
+  UINT64    Calls;      // number of calls of the range function
+  UINT64    Lines;      // number of cache lines maintained by these calls
+  UINT64    Barriers;   // number of DSB issued by these calls
+} ARM_CACHE_OPERATION_STATS;
+
+/**
+  Return the statistics of a range based cache maintenance operation.
+
+  The statistics are only collected when PcdArmCacheMaintenanceStats is TRUE
+  for the module, otherwise all the counters read as zero.
+
+  @param[in]  Operation   The cache maintenance operation.
+  @param[out] Stats       Receives the statistics of the operation.
+
+  @retval RETURN_SUCCESS            The statistics are returned.
+  @retval RETURN_INVALID_PARAMETER  Operation is not valid or Stats is NULL.
+
+**/
+RETURN_STATUS
+EFIAPI
+ArmGetCacheMaintenanceStats (
+  IN  ARM_CACHE_OPERATION        Operation,
+  OUT ARM_CACHE_OPERATION_STATS  *Stats
+  );
+
+/**
+  Reset the statistics of all the range based cache maintenance operations.
+
+**/
+VOID
+EFIAPI
+ArmResetCacheMaintenanceStats (
+  VOID
+  );
+
+#endif // ARM_CACHE_MAINTENANCE_STATS_LIB_H_
@@ -13,6 +13,16 @@
 
 #include <Library/ArmLib.h>
 
+///
+/// One range of a batch of memory attribute updates, see
+/// ArmSetMemoryAttributesBatch().
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT64                  Attributes;
+} ARM_MEMORY_ATTRIBUTES_RANGE;
+
 EFI_STATUS
 EFIAPI
 ArmConfigureMmu (
@@ -64,4 +74,21 @@ ArmSetMemoryAttributes (
   IN UINT64                Attributes
   );
 
+/**
+  Apply ArmSetMemoryAttributes() to a number of ranges, performing the TLB
+  maintenance for the whole batch only once, after the last range.
+
+  @param[in] Ranges      The ranges to update, in order.
+  @param[in] RangeCount  The number of entries in Ranges.
+
+  @retval EFI_SUCCESS  All the ranges have been updated.
+  @return              The status of the first range that failed. The ranges
+                       before it have been updated, the ones after it have not.
+**/
+EFI_STATUS
+ArmSetMemoryAttributesBatch (
+  IN CONST ARM_MEMORY_ATTRIBUTES_RANGE  *Ranges,
+  IN       UINTN                        RangeCount
+  );
+
 #endif // ARM_MMU_LIB_H_
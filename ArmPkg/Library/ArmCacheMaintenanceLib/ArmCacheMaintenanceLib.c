@@ -7,10 +7,82 @@
 
 **/
 #include <Base.h>
+#include <Library/ArmCacheMaintenanceStatsLib.h>
 #include <Library/ArmLib.h>
+#include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/PcdLib.h>
 
+//
+// Ranges spanning at least this number of cache lines are maintained in
+// groups of lines, so the loop overhead is only paid once per group.
+//
+#define CACHE_RANGE_LINES_PER_GROUP  4
+
+//
+// CTR_EL0.IDC: data cache clean to PoU is not required for I/D coherence.
+// CTR_EL0.DIC: instruction cache invalidation to PoU is not required for
+// I/D coherence. Both bits read as zero on ARMv7, where they are part of the
+// CTR format field.
+//
+#define CTR_IDC  BIT28
+#define CTR_DIC  BIT29
+
+STATIC ARM_CACHE_OPERATION_STATS  mCacheOperationStats[ArmCacheOperationMax];
+
+/**
+  Account a range based cache maintenance operation in the statistics.
+
+  @param[in]  Operation   The cache maintenance operation.
+  @param[in]  Start       The start of the range.
+  @param[in]  Length      The length of the range.
+  @param[in]  LineLength  The cache line length used for the range, or 0 if
+                          no line was maintained.
+  @param[in]  Barriers    The number of DSB issued for the range.
+
+**/
+STATIC
+VOID
+RecordCacheOperation (
+  IN  ARM_CACHE_OPERATION  Operation,
+  IN  VOID                 *Start,
+  IN  UINTN                Length,
+  IN  UINTN                LineLength,
+  IN  UINTN                Barriers
+  )
+{
+  UINTN  AlignedStart;
+  UINTN  AlignedEnd;
+
+  if (!FeaturePcdGet (PcdArmCacheMaintenanceStats)) {
+    return;
+  }
+
+  mCacheOperationStats[Operation].Calls++;
+  mCacheOperationStats[Operation].Barriers += Barriers;
+
+  if ((Length == 0) || (LineLength == 0)) {
+    return;
+  }
+
+  AlignedStart = (UINTN)Start & ~(LineLength - 1);
+  AlignedEnd   = ALIGN_VALUE ((UINTN)Start + Length, LineLength);
+  mCacheOperationStats[Operation].Lines +=
+    (AlignedEnd - AlignedStart) >> HighBitSet64 (LineLength);
+}
+
+/**
+  Perform a cache maintenance operation on each cache line of a range.
+
+  The caller is responsible for the barrier completing the operation, so
+  several ranges can share one barrier.
+
+  @param[in]  Start          The start of the range.
+  @param[in]  Length         The length of the range.
+  @param[in]  LineOperation  The operation on a single cache line.
+  @param[in]  LineLength     The length of the cache lines.
+
+**/
 STATIC
 VOID
 CacheRangeOperation (
@@ -24,18 +96,62 @@ CacheRangeOperation (
   // Align address (rounding down)
   UINTN  AlignedAddress;
   UINTN  EndAddress;
+  UINTN  GroupLength;
 
   ArmCacheLineAlignmentMask = LineLength - 1;
   AlignedAddress            = (UINTN)Start - ((UINTN)Start & ArmCacheLineAlignmentMask);
   EndAddress                = (UINTN)Start + Length;
+  GroupLength               = LineLength * CACHE_RANGE_LINES_PER_GROUP;
 
-  // Perform the line operation on an address in each cache line
+  // Perform the line operation on a group of cache lines at a time
+  while (EndAddress - AlignedAddress >= GroupLength) {
+    LineOperation (AlignedAddress);
+    LineOperation (AlignedAddress + LineLength);
+    LineOperation (AlignedAddress + 2 * LineLength);
+    LineOperation (AlignedAddress + 3 * LineLength);
+    AlignedAddress += GroupLength;
+  }
+
+  // Perform the line operation on an address in each remaining cache line
   while (AlignedAddress < EndAddress) {
     LineOperation (AlignedAddress);
     AlignedAddress += LineLength;
   }
+}
+
+/**
+  Perform a data cache maintenance operation on a range and complete it with
+  a single barrier.
+
+  Empty ranges do not issue any cache maintenance or barrier.
+
+  @param[in]  Operation      The cache maintenance operation, for statistics.
+  @param[in]  Start          The start of the range.
+  @param[in]  Length         The length of the range.
+  @param[in]  LineOperation  The operation on a single cache line.
+
+**/
+STATIC
+VOID
+DataCacheRangeOperation (
+  IN  ARM_CACHE_OPERATION  Operation,
+  IN  VOID                 *Start,
+  IN  UINTN                Length,
+  IN  LINE_OPERATION       LineOperation
+  )
+{
+  UINTN  LineLength;
+
+  if (Length == 0) {
+    RecordCacheOperation (Operation, Start, 0, 0, 0);
+    return;
+  }
 
+  LineLength = ArmDataCacheLineLength ();
+  CacheRangeOperation (Start, Length, LineOperation, LineLength);
   ArmDataSynchronizationBarrier ();
+
+  RecordCacheOperation (Operation, Start, Length, LineLength, 1);
 }
 
 VOID
@@ -63,21 +179,56 @@ InvalidateInstructionCacheRange (
   IN      UINTN  Length
   )
 {
-  CacheRangeOperation (
-    Address,
-    Length,
-    ArmCleanDataCacheEntryToPoUByMVA,
-    ArmDataCacheLineLength ()
-    );
-  CacheRangeOperation (
-    Address,
-    Length,
-    ArmInvalidateInstructionCacheEntryToPoUByMVA,
-    ArmInstructionCacheLineLength ()
-    );
+  UINTN  CacheInfo;
+  UINTN  Barriers;
+  UINTN  LineLength;
+
+  if (Length == 0) {
+    RecordCacheOperation (ArmCacheOperationInvalidateInstruction, Address, 0, 0, 0);
+    return Address;
+  }
+
+  CacheInfo  = ArmCacheInfo ();
+  LineLength = 0;
+
+  //
+  // The barrier orders the data cache clean, or the stores to the range if
+  // the clean is not required, before the instruction cache invalidation.
+  //
+  if ((CacheInfo & CTR_IDC) == 0) {
+    LineLength = ArmDataCacheLineLength ();
+    CacheRangeOperation (
+      Address,
+      Length,
+      ArmCleanDataCacheEntryToPoUByMVA,
+      LineLength
+      );
+  }
+
+  ArmDataSynchronizationBarrier ();
+  Barriers = 1;
+
+  if ((CacheInfo & CTR_DIC) == 0) {
+    LineLength = ArmInstructionCacheLineLength ();
+    CacheRangeOperation (
+      Address,
+      Length,
+      ArmInvalidateInstructionCacheEntryToPoUByMVA,
+      LineLength
+      );
+    ArmDataSynchronizationBarrier ();
+    Barriers++;
+  }
 
   ArmInstructionSynchronizationBarrier ();
 
+  RecordCacheOperation (
+    ArmCacheOperationInvalidateInstruction,
+    Address,
+    Length,
+    LineLength,
+    Barriers
+    );
   return Address;
 }
 
@@ -97,11 +248,11 @@ WriteBackInvalidateDataCacheRange (
   IN      UINTN  Length
   )
 {
-  CacheRangeOperation (
+  DataCacheRangeOperation (
+    ArmCacheOperationWriteBackInvalidateData,
     Address,
     Length,
-    ArmCleanInvalidateDataCacheEntryByMVA,
-    ArmDataCacheLineLength ()
+    ArmCleanInvalidateDataCacheEntryByMVA
     );
   return Address;
 }
@@ -122,11 +273,11 @@ WriteBackDataCacheRange (
   IN      UINTN  Length
   )
 {
-  CacheRangeOperation (
+  DataCacheRangeOperation (
+    ArmCacheOperationWriteBackData,
     Address,
     Length,
-    ArmCleanDataCacheEntryByMVA,
-    ArmDataCacheLineLength ()
+    ArmCleanDataCacheEntryByMVA
     );
   return Address;
 }
@@ -138,11 +289,62 @@ InvalidateDataCacheRange (
   IN      UINTN  Length
   )
 {
-  CacheRangeOperation (
+  DataCacheRangeOperation (
+    ArmCacheOperationInvalidateData,
     Address,
     Length,
-    ArmInvalidateDataCacheEntryByMVA,
-    ArmDataCacheLineLength ()
+    ArmInvalidateDataCacheEntryByMVA
     );
   return Address;
 }
+
+/**
+  Return the statistics of a range based cache maintenance operation.
+
+  The statistics are only collected when PcdArmCacheMaintenanceStats is TRUE
+  for the module, otherwise all the counters read as zero.
+
+  @param[in]  Operation   The cache maintenance operation.
+  @param[out] Stats       Receives the statistics of the operation.
+
+  @retval RETURN_SUCCESS            The statistics are returned.
+  @retval RETURN_INVALID_PARAMETER  Operation is not valid or Stats is NULL.
+
+**/
+RETURN_STATUS
+EFIAPI
+ArmGetCacheMaintenanceStats (
+  IN  ARM_CACHE_OPERATION        Operation,
+  OUT ARM_CACHE_OPERATION_STATS  *Stats
+  )
+{
+  if ((Operation >= ArmCacheOperationMax) || (Stats == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Stats = mCacheOperationStats[Operation];
+  return RETURN_SUCCESS;
+}
+
+/**
+  Reset the statistics of all the range based cache maintenance operations.
+
+**/
+VOID
+EFIAPI
+ArmResetCacheMaintenanceStats (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  if (!FeaturePcdGet (PcdArmCacheMaintenanceStats)) {
+    return;
+  }
+
+  for (Index = 0; Index < ArmCacheOperationMax; Index++) {
+    mCacheOperationStats[Index].Calls    = 0;
+    mCacheOperationStats[Index].Lines    = 0;
+    mCacheOperationStats[Index].Barriers = 0;
+  }
+}
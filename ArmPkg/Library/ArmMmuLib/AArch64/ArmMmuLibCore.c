@@ -77,6 +77,15 @@ GetRootTableLevel (
   return (T0SZ - MIN_T0SZ) / BITS_PER_LEVEL;
 }
 
+//
+// TRUE while ArmSetMemoryAttributesBatch() runs with the MMU enabled: entries
+// that need no break-before-make are then written without invalidating the
+// TLB, and mTlbInvalidatePending records that the whole TLB has to be
+// invalidated at the end of the batch.
+//
+STATIC BOOLEAN  mDeferTlbInvalidate;
+STATIC BOOLEAN  mTlbInvalidatePending;
+
 STATIC
 VOID
 ReplaceTableEntry (
@@ -88,7 +97,11 @@ ReplaceTableEntry (
 {
   if (!ArmMmuEnabled () || !IsLiveBlockMapping) {
     *Entry = Value;
-    ArmUpdateTranslationTableEntry (Entry, (VOID *)(UINTN)RegionStart);
+    if (mDeferTlbInvalidate) {
+      mTlbInvalidatePending = TRUE;
+    } else {
+      ArmUpdateTranslationTableEntry (Entry, (VOID *)(UINTN)RegionStart);
+    }
   } else {
     ArmReplaceLiveTranslationEntry (Entry, Value, RegionStart);
   }
@@ -152,6 +165,74 @@ IsTableEntry (
   return (Entry & TT_TYPE_MASK) == TT_TYPE_TABLE_ENTRY;
 }
 
+/**
+  Replace a table entry with a block entry, if the table it points to maps a
+  naturally aligned region contiguously with uniform attributes, i.e. all its
+  entries are blocks (or pages) that differ only in their output address.
+
+  This undoes the splitting of blocks once the attributes of the pages in it
+  have been set to the same value again, which saves page table memory and TLB
+  entries.
+
+  @param[in,out] Entry        The table entry to coalesce.
+  @param[in]     RegionStart  An address in the region mapped by Entry.
+  @param[in]     Level        The translation level of Entry.
+**/
+STATIC
+VOID
+CoalesceTableEntry (
+  IN OUT UINT64  *Entry,
+  IN     UINT64  RegionStart,
+  IN     UINTN   Level
+  )
+{
+  UINT64  *TranslationTable;
+  UINT64  FirstEntry;
+  UINT64  BlockSize;
+  UINTN   Index;
+
+  //
+  // No block mappings are allowed at level 0.
+  //
+  if ((Level == 0) || !IsTableEntry (*Entry, Level)) {
+    return;
+  }
+
+  TranslationTable = (UINT64 *)(UINTN)(*Entry & TT_ADDRESS_MASK_BLOCK_ENTRY);
+  FirstEntry       = TranslationTable[0];
+  BlockSize        = TT_BLOCK_ENTRY_SIZE_AT_LEVEL (Level + 1);
+
+  if (!IsBlockEntry (FirstEntry, Level + 1) ||
+      ((FirstEntry & TT_ADDRESS_MASK_BLOCK_ENTRY & (BlockSize * TT_ENTRY_COUNT - 1)) != 0))
+  {
+    return;
+  }
+
+  for (Index = 1; Index < TT_ENTRY_COUNT; Index++) {
+    if (TranslationTable[Index] != FirstEntry + Index * BlockSize) {
+      return;
+    }
+  }
+
+  ReplaceTableEntry (
+    Entry,
+    (FirstEntry & ~(UINT64)TT_TYPE_MASK) | TT_TYPE_BLOCK_ENTRY,
+    RegionStart,
+    TRUE
+    );
+
+  //
+  // ArmReplaceLiveTranslationEntry() only invalidates the TLB entries for
+  // RegionStart, but the walk caches may still refer to the table for other
+  // addresses in the region, so flush them all before the table is freed.
+  //
+  if (ArmMmuEnabled ()) {
+    ArmInvalidateTlb ();
+  }
+
+  FreePages (TranslationTable, 1);
+}
+
 STATIC
 EFI_STATUS
 UpdateRegionMappingRecursive (
@@ -288,6 +369,8 @@ UpdateRegionMappingRecursive (
           IsBlockEntry (*Entry, Level)
           );
       }
+
+      CoalesceTableEntry (Entry, RegionStart, Level);
     } else {
       EntryValue  = (*Entry & AttributeClearMask) | AttributeSetMask;
       EntryValue |= RegionStart;
@@ -430,6 +513,44 @@ ArmSetMemoryAttributes (
            );
 }
 
+EFI_STATUS
+ArmSetMemoryAttributesBatch (
+  IN CONST ARM_MEMORY_ATTRIBUTES_RANGE  *Ranges,
+  IN       UINTN                        RangeCount
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  //
+  // Entries replaced with the MMU disabled need no TLB maintenance, and block
+  // entries that are split or replaced while live still go through
+  // ArmReplaceLiveTranslationEntry() (break-before-make) one by one.
+  //
+  mDeferTlbInvalidate = ArmMmuEnabled ();
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = ArmSetMemoryAttributes (
+               Ranges[Index].BaseAddress,
+               Ranges[Index].Length,
+               Ranges[Index].Attributes
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  mDeferTlbInvalidate = FALSE;
+  if (mTlbInvalidatePending) {
+    mTlbInvalidatePending = FALSE;
+    ArmDataSynchronizationBarrier ();
+    ArmInvalidateTlb ();
+  }
+
+  return Status;
+}
+
 STATIC
 EFI_STATUS
 SetMemoryRegionAttribute (
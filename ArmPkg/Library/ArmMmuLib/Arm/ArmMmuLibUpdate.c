@@ -10,6 +10,7 @@
 #include <Uefi.h>
 
 #include <Library/ArmLib.h>
+#include <Library/ArmMmuLib.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
@@ -412,6 +413,30 @@ ArmSetMemoryAttributes (
   return Status;
 }
 
+EFI_STATUS
+ArmSetMemoryAttributesBatch (
+  IN CONST ARM_MEMORY_ATTRIBUTES_RANGE  *Ranges,
+  IN       UINTN                        RangeCount
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = ArmSetMemoryAttributes (
+               Ranges[Index].BaseAddress,
+               Ranges[Index].Length,
+               Ranges[Index].Attributes
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  return Status;
+}
+
 EFI_STATUS
 ArmSetMemoryRegionNoExec (
   IN  EFI_PHYSICAL_ADDRESS  BaseAddress,
@@ -1197,6 +1197,10 @@ Routine Description:
   This function adds a file to the FV image.  The file will pad to the
   appropriate alignment if required.
 
+  The file is read straight into its final location in the FV image.  Only
+  a file that may need a pad file in front of it is first read to the top of
+  the free space and then moved down once its position is known.
+
 Arguments:
 
   FvImage       The memory image of the FV to add it to.  The current offset
@@ -1219,12 +1223,16 @@ Returns:
 {
   FILE                  *NewFile;
   UINTN                 FileSize;
+  UINTN                 StagedFileSize;
   UINT8                 *FileBuffer;
   UINTN                 NumBytesRead;
   UINT32                CurrentFileAlignment;
+  UINTN                 Misalignment;
   EFI_STATUS            Status;
   UINTN                 Index1;
   UINT8                 FileGuidString[PRINTED_GUID_BUFFER_SIZE];
+  EFI_FFS_FILE_HEADER2  FfsHeader;
+  UINT8                 ErasePolarity;
 
   Index1 = 0;
   //
@@ -1235,7 +1243,7 @@ Returns:
   }
 
   //
-  // Read the file to add
+  // Open the file to add
   //
   NewFile = fopen (LongFilePath (FvInfo->FvFiles[Index]), "rb");
 
@@ -1250,19 +1258,82 @@ Returns:
   FileSize = _filelength (fileno (NewFile));
 
   //
-  // Read the file into a buffer
+  // For None PI Ffs file, directly add them into FvImage.
   //
-  FileBuffer = malloc (FileSize);
-  if (FileBuffer == NULL) {
+  if (!FvInfo->IsPiFvImage) {
+    if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
+      fclose (NewFile);
+      Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    NumBytesRead = fread (FvImage->CurrentFilePointer, sizeof (UINT8), FileSize, NewFile);
     fclose (NewFile);
-    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    if (NumBytesRead != sizeof (UINT8) * FileSize) {
+      Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
+      return EFI_ABORTED;
+    }
+    if (FvInfo->SizeofFvFiles[Index] > FileSize) {
+      FvImage->CurrentFilePointer += FvInfo->SizeofFvFiles[Index];
+    } else {
+      FvImage->CurrentFilePointer += FileSize;
+    }
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Read the Ffs header first, it decides where the file goes in the FV.
+  //
+  memset (&FfsHeader, 0, sizeof (FfsHeader));
+  NumBytesRead = fread (&FfsHeader, sizeof (UINT8), MIN (FileSize, sizeof (FfsHeader)), NewFile);
+  if (FileSize < sizeof (EFI_FFS_FILE_HEADER) || NumBytesRead != MIN (FileSize, sizeof (FfsHeader))) {
+    fclose (NewFile);
+    Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Verify space exists to add the file
+  //
+  if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
+    fclose (NewFile);
+    Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Check if alignment is required
+  //
+  ReadFfsAlignment ((EFI_FFS_FILE_HEADER *) &FfsHeader, &CurrentFileAlignment);
+
+  //
+  // Pick the location to read the file to. A VTF file goes to the top of the
+  // FV, a file that is already aligned at the current offset goes there, and
+  // any other file is staged at the top of the free space until the pad file
+  // in front of it has been added.
+  //
+  Misalignment = 0;
+  if (IsVtfFile ((EFI_FFS_FILE_HEADER *) &FfsHeader)) {
+    if ((UINTN) *VtfFileImage != (UINTN) FvImage->Eof) {
+      fclose (NewFile);
+      Error (NULL, 0, 3000, "Invalid", "multiple VTF files are not permitted within a single FV.");
+      return EFI_ABORTED;
+    }
+    FileBuffer = (UINT8 *) FvImage->FileImage + FvInfo->Size - FileSize;
+  } else {
+    Misalignment = ((UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage +
+                    GetFfsHeaderLength ((EFI_FFS_FILE_HEADER *) &FfsHeader)) & ((1 << CurrentFileAlignment) - 1);
+    if (Misalignment == 0) {
+      FileBuffer = (UINT8 *) FvImage->CurrentFilePointer;
+    } else {
+      FileBuffer = (UINT8 *) *VtfFileImage - FileSize;
+    }
+  }
+
+  fseek (NewFile, 0, SEEK_SET);
   NumBytesRead = fread (FileBuffer, sizeof (UINT8), FileSize, NewFile);
 
   //
-  // Done with the file, from this point on we will just use the buffer read.
+  // Done with the file, from this point on we will just use the data read.
   //
   fclose (NewFile);
 
@@ -1270,43 +1341,19 @@ Returns:
   // Verify read successful
   //
   if (NumBytesRead != sizeof (UINT8) * FileSize) {
-    free  (FileBuffer);
     Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
     return EFI_ABORTED;
   }
 
-  //
-  // For None PI Ffs file, directly add them into FvImage.
-  //
-  if (!FvInfo->IsPiFvImage) {
-    memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
-    if (FvInfo->SizeofFvFiles[Index] > FileSize) {
-      FvImage->CurrentFilePointer += FvInfo->SizeofFvFiles[Index];
-    } else {
-      FvImage->CurrentFilePointer += FileSize;
-    }
-    goto Done;
-  }
-
   //
   // Verify Ffs file
   //
   Status = VerifyFfsFile ((EFI_FFS_FILE_HEADER *)FileBuffer);
   if (EFI_ERROR (Status)) {
-    free (FileBuffer);
     Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
     return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Verify space exists to add the file
-  //
-  if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
-    free (FileBuffer);
-    Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
-    return EFI_OUT_OF_RESOURCES;
-  }
-
   //
   // Verify the input file is the duplicated file in this Fv image
   //
@@ -1314,7 +1361,6 @@ Returns:
     if (CompareGuid ((EFI_GUID *) FileBuffer, &mFileGuidArray [Index1]) == 0) {
       Error (NULL, 0, 2000, "Invalid parameter", "the %dth file and %uth file have the same file GUID.", (unsigned) Index1 + 1, (unsigned) Index + 1);
       PrintGuid ((EFI_GUID *) FileBuffer);
-      free (FileBuffer);
       return EFI_INVALID_PARAMETER;
     }
   }
@@ -1328,11 +1374,6 @@ Returns:
     (EFI_FIRMWARE_VOLUME_HEADER *) FvImage->FileImage
     );
 
-  //
-  // Check if alignment is required
-  //
-  ReadFfsAlignment ((EFI_FFS_FILE_HEADER *) FileBuffer, &CurrentFileAlignment);
-
   //
   // Find the largest alignment of all the FFS files in the FV
   //
@@ -1343,58 +1384,40 @@ Returns:
   // If we have a VTF file, add it at the top.
   //
   if (IsVtfFile ((EFI_FFS_FILE_HEADER *) FileBuffer)) {
-    if ((UINTN) *VtfFileImage == (UINTN) FvImage->Eof) {
-      //
-      // No previous VTF, add this one.
-      //
-      *VtfFileImage = (EFI_FFS_FILE_HEADER *) (UINTN) ((UINTN) FvImage->FileImage + FvInfo->Size - FileSize);
-      //
-      // Sanity check. The file MUST align appropriately
-      //
-      if (((UINTN) *VtfFileImage + GetFfsHeaderLength((EFI_FFS_FILE_HEADER *)FileBuffer) - (UINTN) FvImage->FileImage) % (1 << CurrentFileAlignment)) {
-        Error (NULL, 0, 3000, "Invalid", "VTF file cannot be aligned on a %u-byte boundary.", (unsigned) (1 << CurrentFileAlignment));
-        free (FileBuffer);
-        return EFI_ABORTED;
-      }
-      //
-      // Rebase the PE or TE image in FileBuffer of FFS file for XIP
-      // Rebase for the debug genfvmap tool
-      //
-      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
-      if (EFI_ERROR (Status)) {
-        Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-        return Status;
-      }
-      //
-      // copy VTF File
-      //
-      memcpy (*VtfFileImage, FileBuffer, FileSize);
-
-      PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
-      fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
-
-      free (FileBuffer);
-      DebugMsg (NULL, 0, 9, "Add VTF FFS file in FV image", NULL);
-      return EFI_SUCCESS;
-    } else {
-      //
-      // Already found a VTF file.
-      //
-      Error (NULL, 0, 3000, "Invalid", "multiple VTF files are not permitted within a single FV.");
-      free (FileBuffer);
+    *VtfFileImage = (EFI_FFS_FILE_HEADER *) FileBuffer;
+    //
+    // Sanity check. The file MUST align appropriately
+    //
+    if (((UINTN) *VtfFileImage + GetFfsHeaderLength((EFI_FFS_FILE_HEADER *)FileBuffer) - (UINTN) FvImage->FileImage) % (1 << CurrentFileAlignment)) {
+      Error (NULL, 0, 3000, "Invalid", "VTF file cannot be aligned on a %u-byte boundary.", (unsigned) (1 << CurrentFileAlignment));
       return EFI_ABORTED;
     }
+    //
+    // Rebase the PE or TE image in FileBuffer of FFS file for XIP
+    // Rebase for the debug genfvmap tool
+    //
+    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
+      return Status;
+    }
+
+    PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
+    fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
+
+    DebugMsg (NULL, 0, 9, "Add VTF FFS file in FV image", NULL);
+    return EFI_SUCCESS;
   }
 
   //
   // Add pad file if necessary
   //
+  StagedFileSize = FileSize;
   if (!AdjustInternalFfsPadding ((EFI_FFS_FILE_HEADER *) FileBuffer, FvImage,
          1 << CurrentFileAlignment, &FileSize)) {
-    Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, *VtfFileImage, NULL, FileSize);
+    Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, FileBuffer, NULL, FileSize);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 4002, "Resource", "FV space is full, could not add pad file for data alignment property.");
-      free (FileBuffer);
       return EFI_ABORTED;
     }
   }
@@ -1402,25 +1425,38 @@ Returns:
   // Add file
   //
   if ((UINTN) (FvImage->CurrentFilePointer + FileSize) <= (UINTN) (*VtfFileImage)) {
+    //
+    // Move a staged file down to its final location, and give the space it
+    // leaves behind back the erase polarity of the FV.
+    //
+    if (Misalignment != 0) {
+      memmove (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+      ErasePolarity = (((EFI_FIRMWARE_VOLUME_HEADER *) FvImage->FileImage)->Attributes & EFI_FVB2_ERASE_POLARITY) ? 0xFF : 0;
+      if ((UINTN) FileBuffer < (UINTN) (FvImage->CurrentFilePointer + FileSize)) {
+        memset (
+          FvImage->CurrentFilePointer + FileSize,
+          ErasePolarity,
+          (UINTN) FileBuffer + StagedFileSize - (UINTN) (FvImage->CurrentFilePointer + FileSize)
+          );
+      } else {
+        memset (FileBuffer, ErasePolarity, StagedFileSize);
+      }
+      FileBuffer = (UINT8 *) FvImage->CurrentFilePointer;
+    }
     //
     // Rebase the PE or TE image in FileBuffer of FFS file for XIP.
     // Rebase Bs and Rt drivers for the debug genfvmap tool.
     //
     Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
-  if (EFI_ERROR (Status)) {
-    Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-    return Status;
-  }
-    //
-    // Copy the file
-    //
-    memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
+      return Status;
+    }
     PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
   } else {
     Error (NULL, 0, 4002, "Resource", "FV space is full, cannot add file %s.", FvInfo->FvFiles[Index]);
-    free (FileBuffer);
     return EFI_ABORTED;
   }
   //
@@ -1430,12 +1466,6 @@ Returns:
     FvImage->CurrentFilePointer++;
   }
 
-Done:
-  //
-  // Free allocated memory.
-  //
-  free (FileBuffer);
-
   return EFI_SUCCESS;
 }
 
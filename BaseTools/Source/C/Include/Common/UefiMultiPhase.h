@@ -31,6 +31,7 @@ typedef enum {
   EfiMemoryMappedIOPortSpace,
   EfiPalCode,
   EfiPersistentMemory,
+  EfiUnacceptedMemoryType,
   EfiMaxMemoryType
 } EFI_MEMORY_TYPE;
 
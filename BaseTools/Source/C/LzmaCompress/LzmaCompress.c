@@ -27,6 +27,14 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// The split-stream format: the LZMA header, the size of the chunks and their
+// number, the encoded size of each chunk, then the chunks. Each chunk is a
+// raw LZMA stream of the same properties, encoded independently of the
+// other chunks, so that they can be decoded at the same time.
+//
+#define LZMA_SPLIT_HEADER_SIZE (LZMA_HEADER_SIZE + 8)
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -44,6 +52,8 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mSplitSize = 0;
+UINT64 mThreadNumber = 0;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -60,11 +70,14 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --split Size: encode Size byte chunks independently (split-stream format)\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
              "  -a: set compression mode 0 = fast, 1 = normal, default: 1 (normal)\n"
              "  d: sets Dictionary size - [0, 27], default: 24 (16MB)\n"
+             "  -j Threads, --threads Threads: set the number of encoder threads - [1, 2],\n"
+             "        default: 2 (the match finder runs in its own thread) unless -a 0\n"
              "  --version: display the program version and exit\n"
              "  -h, --help: display this help text\n"
              );
@@ -94,6 +107,59 @@ void PrintVersion(char *buffer)
   sprintf (buffer, "%s Version %d.%d %s ", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
 }
 
+static void WriteUInt32(Byte *buffer, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    buffer[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 ReadUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) |
+         ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+static SRes EncodeSplit(Byte *outBuffer, size_t *outSize, const Byte *inBuffer, size_t inSize, CLzmaEncProps *props)
+{
+  SRes res;
+  UInt32 chunkCount;
+  UInt32 index;
+  size_t offset;
+  size_t chunkSize;
+  size_t outSizeProcessed;
+  size_t outPropsSize;
+
+  chunkCount = (UInt32)((inSize + mSplitSize - 1) / mSplitSize);
+  offset = LZMA_SPLIT_HEADER_SIZE + (size_t)chunkCount * 4;
+  if (offset > *outSize)
+    return SZ_ERROR_OUTPUT_EOF;
+
+  WriteUInt32(outBuffer + LZMA_HEADER_SIZE, (UInt32)mSplitSize);
+  WriteUInt32(outBuffer + LZMA_HEADER_SIZE + 4, chunkCount);
+
+  for (index = 0; index < chunkCount; index++) {
+    chunkSize = (size_t)mSplitSize;
+    if (chunkSize > inSize - (size_t)index * mSplitSize)
+      chunkSize = inSize - (size_t)index * mSplitSize;
+
+    outSizeProcessed = *outSize - offset;
+    outPropsSize = LZMA_PROPS_SIZE;
+    res = LzmaEncode(outBuffer + offset, &outSizeProcessed,
+        inBuffer + (size_t)index * mSplitSize, chunkSize,
+        props, outBuffer, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK)
+      return res;
+
+    WriteUInt32(outBuffer + LZMA_SPLIT_HEADER_SIZE + (size_t)index * 4, (UInt32)outSizeProcessed);
+    offset += outSizeProcessed;
+  }
+
+  *outSize = offset;
+  return SZ_OK;
+}
+
 static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
 {
   SRes res;
@@ -118,6 +184,10 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
 
   // we allocate 105% of original size + 64KB for output buffer
   outSize = (size_t)fileSize / 20 * 21 + (1 << 16);
+  if (mSplitSize != 0) {
+    // and the chunk table, and 64KB more for each chunk
+    outSize += (size_t)(fileSize / mSplitSize + 1) * (4 + (1 << 16));
+  }
   outBuffer = (Byte *)MyAlloc(outSize);
   if (outBuffer == 0) {
     res = SZ_ERROR_MEM;
@@ -148,7 +218,11 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     }
   }
 
-  {
+  if (mSplitSize != 0) {
+    res = EncodeSplit(outBuffer, &outSize, inBuffer, inSize, props);
+    if (res != SZ_OK)
+      goto Done;
+  } else {
     size_t outSizeProcessed = outSize - LZMA_HEADER_SIZE;
     size_t outPropsSize = LZMA_PROPS_SIZE;
 
@@ -174,6 +248,49 @@ Done:
   return res;
 }
 
+static SRes DecodeSplit(Byte *outBuffer, size_t outSize, const Byte *inBuffer, size_t inSize)
+{
+  SRes res;
+  UInt32 splitSize;
+  UInt32 chunkCount;
+  UInt32 index;
+  size_t offset;
+  size_t chunkSize;
+  size_t encodedSize;
+  ELzmaStatus status;
+
+  if (inSize < LZMA_SPLIT_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  splitSize = ReadUInt32(inBuffer + LZMA_HEADER_SIZE);
+  chunkCount = ReadUInt32(inBuffer + LZMA_HEADER_SIZE + 4);
+  if (splitSize == 0 || chunkCount != (outSize + splitSize - 1) / splitSize)
+    return SZ_ERROR_DATA;
+
+  offset = LZMA_SPLIT_HEADER_SIZE + (size_t)chunkCount * 4;
+  if (offset > inSize)
+    return SZ_ERROR_INPUT_EOF;
+
+  for (index = 0; index < chunkCount; index++) {
+    chunkSize = splitSize;
+    if (chunkSize > outSize - (size_t)index * splitSize)
+      chunkSize = outSize - (size_t)index * splitSize;
+
+    encodedSize = ReadUInt32(inBuffer + LZMA_SPLIT_HEADER_SIZE + (size_t)index * 4);
+    if (encodedSize > inSize - offset)
+      return SZ_ERROR_INPUT_EOF;
+
+    res = LzmaDecode(outBuffer + (size_t)index * splitSize, &chunkSize, inBuffer + offset, &encodedSize,
+        inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      return res;
+
+    offset += encodedSize;
+  }
+
+  return SZ_OK;
+}
+
 static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -214,9 +331,13 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
-  inSizePure = inSize - LZMA_HEADER_SIZE;
-  res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
-      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+  if (mSplitSize != 0) {
+    res = DecodeSplit(outBuffer, outSize, inBuffer, inSize);
+  } else {
+    inSizePure = inSize - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+  }
 
   if (res != SZ_OK)
     goto Done;
@@ -272,6 +393,14 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--split") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[++param],FALSE,&mSplitSize);
+      if ((mSplitSize == 0) || (mSplitSize > 0xFFFFFFFF)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -296,6 +425,19 @@ int main2(int numArgs, const char *args[], char *rs)
       } else {
         return PrintError(rs, kInvalidParamValMessage);
       }
+    } else if (strcmp(args[param], "-j") == 0 ||
+               strcmp(args[param], "--threads") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[++param],FALSE,&mThreadNumber);
+      if ((mThreadNumber == 0) || (mThreadNumber > 2)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      //
+      // The encoder output does not depend on the number of threads.
+      //
+      props.numThreads = (int)mThreadNumber;
     } else if (strcmp(args[param], "d") == 0) {
       AsciiStringToUint64(args[param + 1],FALSE,&mDictionarySize);
       if (mDictionarySize <= 27) {
@@ -342,6 +484,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if ((mSplitSize != 0) && (mConType != NoConverter)) {
+    return PrintError(rs, "The x86 converter is not supported with --split");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
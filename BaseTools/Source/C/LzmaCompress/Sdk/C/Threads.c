@@ -3,12 +3,18 @@
 
 #include "Precomp.h"
 
+#ifdef _WIN32
 #ifndef UNDER_CE
 #include <process.h>
 #endif
+#else
+#include <errno.h>
+#endif
 
 #include "Threads.h"
 
+#ifdef _WIN32
+
 static WRes GetError()
 {
   DWORD res = GetLastError();
@@ -93,3 +99,160 @@ WRes CriticalSection_Init(CCriticalSection *p)
   #endif
   return 0;
 }
+
+#else
+
+WRes Thread_Create(CThread *p, THREAD_FUNC_TYPE func, void *param)
+{
+  WRes res = pthread_create(&p->_tid, NULL, func, param);
+  p->_created = (res == 0);
+  return res;
+}
+
+/* the thread can not be waited for again, as it is joined */
+WRes Thread_Wait(CThread *p)
+{
+  if (!p->_created)
+    return EINVAL;
+  p->_created = 0;
+  return pthread_join(p->_tid, NULL);
+}
+
+WRes Thread_Close(CThread *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  return pthread_detach(p->_tid);
+}
+
+static WRes Object_Create(pthread_mutex_t *mutex, pthread_cond_t *cond)
+{
+  WRes res = pthread_mutex_init(mutex, NULL);
+  if (res != 0)
+    return res;
+  res = pthread_cond_init(cond, NULL);
+  if (res != 0)
+    pthread_mutex_destroy(mutex);
+  return res;
+}
+
+static void Object_Close(pthread_mutex_t *mutex, pthread_cond_t *cond)
+{
+  pthread_cond_destroy(cond);
+  pthread_mutex_destroy(mutex);
+}
+
+static WRes Event_Create(CEvent *p, int manualReset, int signaled)
+{
+  WRes res = Object_Create(&p->_mutex, &p->_cond);
+  if (res != 0)
+    return res;
+  p->_manualReset = manualReset;
+  p->_state = (signaled ? True : False);
+  p->_created = 1;
+  return 0;
+}
+
+WRes Event_Set(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  p->_state = True;
+  pthread_cond_broadcast(&p->_cond);
+  pthread_mutex_unlock(&p->_mutex);
+  return 0;
+}
+
+WRes Event_Reset(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  p->_state = False;
+  pthread_mutex_unlock(&p->_mutex);
+  return 0;
+}
+
+WRes Event_Wait(CEvent *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  while (p->_state == False)
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  if (!p->_manualReset)
+    p->_state = False;
+  pthread_mutex_unlock(&p->_mutex);
+  return 0;
+}
+
+WRes Event_Close(CEvent *p)
+{
+  if (p->_created)
+  {
+    Object_Close(&p->_mutex, &p->_cond);
+    p->_created = 0;
+  }
+  return 0;
+}
+
+WRes ManualResetEvent_Create(CManualResetEvent *p, int signaled) { return Event_Create(p, True, signaled); }
+WRes AutoResetEvent_Create(CAutoResetEvent *p, int signaled) { return Event_Create(p, False, signaled); }
+WRes ManualResetEvent_CreateNotSignaled(CManualResetEvent *p) { return ManualResetEvent_Create(p, 0); }
+WRes AutoResetEvent_CreateNotSignaled(CAutoResetEvent *p) { return AutoResetEvent_Create(p, 0); }
+
+
+WRes Semaphore_Create(CSemaphore *p, UInt32 initCount, UInt32 maxCount)
+{
+  WRes res;
+  if (initCount > maxCount || maxCount < 1)
+    return EINVAL;
+  res = Object_Create(&p->_mutex, &p->_cond);
+  if (res != 0)
+    return res;
+  p->_count = initCount;
+  p->_maxCount = maxCount;
+  p->_created = 1;
+  return 0;
+}
+
+WRes Semaphore_ReleaseN(CSemaphore *p, UInt32 num)
+{
+  UInt32 newCount;
+  pthread_mutex_lock(&p->_mutex);
+  newCount = p->_count + num;
+  if (num < 1 || newCount > p->_maxCount || newCount < p->_count)
+  {
+    pthread_mutex_unlock(&p->_mutex);
+    return EINVAL;
+  }
+  p->_count = newCount;
+  pthread_cond_broadcast(&p->_cond);
+  pthread_mutex_unlock(&p->_mutex);
+  return 0;
+}
+
+WRes Semaphore_Release1(CSemaphore *p) { return Semaphore_ReleaseN(p, 1); }
+
+WRes Semaphore_Wait(CSemaphore *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+  while (p->_count < 1)
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  p->_count--;
+  pthread_mutex_unlock(&p->_mutex);
+  return 0;
+}
+
+WRes Semaphore_Close(CSemaphore *p)
+{
+  if (p->_created)
+  {
+    Object_Close(&p->_mutex, &p->_cond);
+    p->_created = 0;
+  }
+  return 0;
+}
+
+WRes CriticalSection_Init(CCriticalSection *p)
+{
+  return pthread_mutex_init(p, NULL);
+}
+
+#endif
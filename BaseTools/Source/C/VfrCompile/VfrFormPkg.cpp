@@ -30,6 +30,7 @@ SPendingAssign::SPendingAssign (
   mLineNo = LineNo;
   mMsg    = NULL;
   mNext   = NULL;
+  mHashNext = NULL;
   if (Key != NULL) {
     mKey = new CHAR8[strlen (Key) + 1];
     if (mKey != NULL) {
@@ -105,6 +106,7 @@ CFormPkg::CFormPkg (
   mReadBufferNode      = NULL;
   mReadBufferOffset    = 0;
   PendingAssignList    = NULL;
+  memset (mPendingAssignHash, 0, sizeof (mPendingAssignHash));
 
   Node = new SBufferNode;
   if (Node == NULL) {
@@ -254,6 +256,7 @@ CFormPkg::Read (
   )
 {
   UINT32       Index;
+  UINT32       CopySize;
 
   if ((Size == 0) || (Buffer == NULL)) {
     return 0;
@@ -263,17 +266,26 @@ CFormPkg::Read (
     return 0;
   }
 
-  for (Index = 0; Index < Size; Index++) {
-    if ((mReadBufferNode->mBufferStart + mReadBufferOffset) < mReadBufferNode->mBufferFree) {
-      Buffer[Index] = mReadBufferNode->mBufferStart[mReadBufferOffset++];
-    } else {
+  Index = 0;
+  while (Index < Size) {
+    CopySize = (UINT32) (mReadBufferNode->mBufferFree - mReadBufferNode->mBufferStart) - mReadBufferOffset;
+    if (CopySize == 0) {
       if ((mReadBufferNode = mReadBufferNode->mNext) == NULL) {
         return Index;
-      } else {
-        mReadBufferOffset = 0;
-        Index --;
       }
+      mReadBufferOffset = 0;
+      continue;
+    }
+
+    //
+    // Copy the rest of the current node in one go.
+    //
+    if (CopySize > Size - Index) {
+      CopySize = Size - Index;
     }
+    memcpy (Buffer + Index, mReadBufferNode->mBufferStart + mReadBufferOffset, CopySize);
+    mReadBufferOffset += CopySize;
+    Index             += CopySize;
   }
 
   return Size;
@@ -304,10 +316,6 @@ CFormPkg::BuildPkg (
   )
 {
 
-  CHAR8  *Temp;
-  UINT32 Size;
-  CHAR8  Buffer[1024];
-
   if (TBuffer.Buffer != NULL) {
     delete TBuffer.Buffer;
   }
@@ -320,12 +328,8 @@ CFormPkg::BuildPkg (
     return VFR_RETURN_SUCCESS;
   }
 
-  Temp = TBuffer.Buffer;
   Open ();
-  while ((Size = Read (Buffer, 1024)) != 0) {
-    memcpy (Temp, Buffer, Size);
-    Temp += Size;
-  }
+  Read (TBuffer.Buffer, TBuffer.Size);
   Close ();
   return VFR_RETURN_SUCCESS;
 }
@@ -494,6 +498,7 @@ CFormPkg::AssignPending (
   )
 {
   SPendingAssign *pNew;
+  UINT32         Bucket;
 
   pNew = new SPendingAssign (Key, ValAddr, ValLen, LineNo, Msg);
   if (pNew == NULL) {
@@ -502,6 +507,12 @@ CFormPkg::AssignPending (
 
   pNew->mNext       = PendingAssignList;
   PendingAssignList = pNew;
+
+  if (pNew->mKey != NULL) {
+    Bucket                     = _NAME_HASH (pNew->mKey) % VFR_PENDING_HASH_SIZE;
+    pNew->mHashNext            = mPendingAssignHash[Bucket];
+    mPendingAssignHash[Bucket] = pNew;
+  }
   return VFR_RETURN_SUCCESS;
 }
 
@@ -518,7 +529,7 @@ CFormPkg::DoPendingAssign (
     return;
   }
 
-  for (pNode = PendingAssignList; pNode != NULL; pNode = pNode->mNext) {
+  for (pNode = mPendingAssignHash[_NAME_HASH (Key) % VFR_PENDING_HASH_SIZE]; pNode != NULL; pNode = pNode->mHashNext) {
     if (strcmp (pNode->mKey, Key) == 0) {
       pNode->AssignValue (ValAddr, ValLen);
     }
@@ -1024,6 +1035,12 @@ CIfrRecordInfoDB::CIfrRecordInfoDB (
   mRecordCount       = EFI_IFR_RECORDINFO_IDX_START;
   mIfrRecordListHead = NULL;
   mIfrRecordListTail = NULL;
+  mRecordIndex       = NULL;
+  mRecordIndexCount  = 0;
+  mRecordIndexSize   = 0;
+  mRecordIndexValid  = FALSE;
+  mLineIndex         = NULL;
+  mLineIndexValid    = FALSE;
   mAllDefaultTypeCount = 0;
   for (UINT8 i = 0; i < EFI_HII_MAX_SUPPORT_DEFAULT_TYPE; i++) {
     mAllDefaultIdArray[i] = 0xffff;
@@ -1041,6 +1058,101 @@ CIfrRecordInfoDB::~CIfrRecordInfoDB (
     mIfrRecordListHead = mIfrRecordListHead->mNext;
     delete pNode;
   }
+
+  ARRAY_SAFE_FREE (mRecordIndex);
+  ARRAY_SAFE_FREE (mLineIndex);
+}
+
+VOID
+CIfrRecordInfoDB::InvalidateRecordIndex (
+  VOID
+  )
+{
+  mRecordIndexValid = FALSE;
+  mLineIndexValid   = FALSE;
+}
+
+VOID
+CIfrRecordInfoDB::BuildRecordIndex (
+  VOID
+  )
+{
+  SIfrRecord *pNode;
+  UINT32     Count;
+
+  Count = 0;
+  for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+    Count++;
+  }
+
+  if (Count > mRecordIndexSize) {
+    ARRAY_SAFE_FREE (mRecordIndex);
+    mRecordIndexSize = Count * 2;
+    mRecordIndex     = new SIfrRecord *[mRecordIndexSize];
+  }
+
+  mRecordIndexCount = 0;
+  for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+    mRecordIndex[mRecordIndexCount++] = pNode;
+  }
+  mRecordIndexValid = TRUE;
+}
+
+VOID
+CIfrRecordInfoDB::BuildLineIndex (
+  VOID
+  )
+{
+  SIfrRecord **Src;
+  SIfrRecord **Dst;
+  SIfrRecord **Tmp;
+  SIfrRecord **Scratch;
+  UINT32     Width;
+  UINT32     Left;
+  UINT32     Mid;
+  UINT32     Right;
+  UINT32     Index;
+  UINT32     IndexL;
+  UINT32     IndexR;
+
+  if (!mRecordIndexValid) {
+    BuildRecordIndex ();
+  }
+
+  ARRAY_SAFE_FREE (mLineIndex);
+  mLineIndex = new SIfrRecord *[mRecordIndexCount + 1];
+  Scratch    = new SIfrRecord *[mRecordIndexCount + 1];
+  memcpy (mLineIndex, mRecordIndex, mRecordIndexCount * sizeof (SIfrRecord *));
+
+  //
+  // Bottom-up merge sort by line number, stable so that the records of one
+  // line keep their list order.
+  //
+  Src = mLineIndex;
+  Dst = Scratch;
+  for (Width = 1; Width < mRecordIndexCount; Width *= 2) {
+    for (Left = 0; Left < mRecordIndexCount; Left += 2 * Width) {
+      Mid   = MIN (Left + Width, mRecordIndexCount);
+      Right = MIN (Left + 2 * Width, mRecordIndexCount);
+      for (Index = Left, IndexL = Left, IndexR = Mid; Index < Right; Index++) {
+        if ((IndexL < Mid) && ((IndexR >= Right) || (Src[IndexL]->mLineNo <= Src[IndexR]->mLineNo))) {
+          Dst[Index] = Src[IndexL++];
+        } else {
+          Dst[Index] = Src[IndexR++];
+        }
+      }
+    }
+    Tmp = Src;
+    Src = Dst;
+    Dst = Tmp;
+  }
+
+  if (Src != mLineIndex) {
+    memcpy (mLineIndex, Src, mRecordIndexCount * sizeof (SIfrRecord *));
+  }
+  delete[] Scratch;
+
+  mLineIndexValid = TRUE;
 }
 
 SIfrRecord *
@@ -1048,19 +1160,22 @@ CIfrRecordInfoDB::GetRecordInfoFromIdx (
   IN UINT32 RecordIdx
   )
 {
-  UINT32     Idx;
-  SIfrRecord *pNode = NULL;
-
   if (RecordIdx == EFI_IFR_RECORDINFO_IDX_INVALUD) {
     return NULL;
   }
 
-  for (Idx = (EFI_IFR_RECORDINFO_IDX_START + 1), pNode = mIfrRecordListHead;
-       (Idx != RecordIdx) && (pNode != NULL);
-       Idx++, pNode = pNode->mNext)
-  ;
+  if (!mRecordIndexValid) {
+    BuildRecordIndex ();
+  }
 
-  return pNode;
+  //
+  // The index is the position in the record list, counted from EFI_IFR_RECORDINFO_IDX_START + 1.
+  //
+  if ((RecordIdx <= EFI_IFR_RECORDINFO_IDX_START) || (RecordIdx - EFI_IFR_RECORDINFO_IDX_START > mRecordIndexCount)) {
+    return NULL;
+  }
+
+  return mRecordIndex[RecordIdx - EFI_IFR_RECORDINFO_IDX_START - 1];
 }
 
 UINT32
@@ -1072,6 +1187,7 @@ CIfrRecordInfoDB::IfrRecordRegister (
   )
 {
   SIfrRecord *pNew;
+  SIfrRecord **NewIndex;
 
   if (mSwitch == FALSE) {
     return EFI_IFR_RECORDINFO_IDX_INVALUD;
@@ -1090,6 +1206,20 @@ CIfrRecordInfoDB::IfrRecordRegister (
   }
   mRecordCount++;
 
+  if (mRecordIndexValid) {
+    if (mRecordIndexCount == mRecordIndexSize) {
+      mRecordIndexSize = (mRecordIndexSize == 0) ? 1024 : mRecordIndexSize * 2;
+      NewIndex         = new SIfrRecord *[mRecordIndexSize];
+      if (mRecordIndex != NULL) {
+        memcpy (NewIndex, mRecordIndex, mRecordIndexCount * sizeof (SIfrRecord *));
+        delete[] mRecordIndex;
+      }
+      mRecordIndex     = NewIndex;
+    }
+    mRecordIndex[mRecordIndexCount++] = pNew;
+  }
+  mLineIndexValid = FALSE;
+
   return mRecordCount;
 }
 
@@ -1123,6 +1253,7 @@ CIfrRecordInfoDB::IfrRecordInfoUpdate (
   pNode->mOffset    = Offset;
   pNode->mBinBufLen = BinBufLen;
   pNode->mIfrBinBuf = BinBuf;
+  mLineIndexValid   = FALSE;
 
 }
 
@@ -1177,6 +1308,9 @@ CIfrRecordInfoDB::IfrRecordOutput (
   SIfrRecord *pNode;
   UINT8      Index;
   UINT32     TotalSize;
+  UINT32     Low;
+  UINT32     High;
+  UINT32     Mid;
 
   if (mSwitch == FALSE) {
     return;
@@ -1187,8 +1321,30 @@ CIfrRecordInfoDB::IfrRecordOutput (
   }
 
   TotalSize = 0;
+  pNode     = mIfrRecordListHead;
+  Low       = 0;
 
-  for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+  if (LineNo != 0) {
+    //
+    // The listing asks for every line of the source in turn, so find the
+    // records of this line in the line sorted index instead of the list.
+    //
+    if (!mLineIndexValid) {
+      BuildLineIndex ();
+    }
+    High = mRecordIndexCount;
+    while (Low < High) {
+      Mid = Low + (High - Low) / 2;
+      if (mLineIndex[Mid]->mLineNo < LineNo) {
+        Low = Mid + 1;
+      } else {
+        High = Mid;
+      }
+    }
+    pNode = (Low < mRecordIndexCount) ? mLineIndex[Low] : NULL;
+  }
+
+  while (pNode != NULL) {
     if (pNode->mLineNo == LineNo || LineNo == 0) {
       fprintf (File, ">%08X: ", pNode->mOffset);
       TotalSize += pNode->mBinBufLen;
@@ -1198,6 +1354,15 @@ CIfrRecordInfoDB::IfrRecordOutput (
         }
       }
       fprintf (File, "\n");
+    } else {
+      break;
+    }
+
+    if (LineNo == 0) {
+      pNode = pNode->mNext;
+    } else {
+      Low++;
+      pNode = (Low < mRecordIndexCount) ? mLineIndex[Low] : NULL;
     }
   }
 
@@ -1348,6 +1513,7 @@ CIfrRecordInfoDB::IfrAdjustDynamicOpcodeInRecords (
   //
   // Adjust the node. pPreNode save the Node before mIfrRecordListTail
   //
+  InvalidateRecordIndex ();
   pNodeBeforeAdjust->mNext = pNodeBeforeDynamic->mNext;
   if (CreateOpcodeAfterParsingVfr) {
     //
@@ -1438,6 +1604,7 @@ CIfrRecordInfoDB::IfrRecordAdjust (
   Status = VFR_RETURN_SUCCESS;
   pNode = mIfrRecordListHead;
   preNode = pNode;
+  InvalidateRecordIndex ();
   QuestionScope = 0;
   while (pNode != NULL) {
     OpHead = (EFI_IFR_OP_HEADER *) pNode->mIfrBinBuf;
@@ -66,6 +66,11 @@ typedef enum {
   ASSIGNED
 } ASSIGN_FLAG;
 
+//
+// Bucket count of the pending assignment key hash table.
+//
+#define VFR_PENDING_HASH_SIZE  256
+
 struct SPendingAssign {
   CHAR8                   *mKey;  // key ! unique
   VOID                    *mAddr;
@@ -74,6 +79,7 @@ struct SPendingAssign {
   UINT32                  mLineNo;
   CHAR8                   *mMsg;
   struct SPendingAssign   *mNext;
+  struct SPendingAssign   *mHashNext;
 
   SPendingAssign (IN CHAR8 *, IN VOID *, IN UINT32, IN UINT32, IN CONST CHAR8 *);
   ~SPendingAssign ();
@@ -119,6 +125,7 @@ private:
 
 private:
   SPendingAssign      *PendingAssignList;
+  SPendingAssign      *mPendingAssignHash[VFR_PENDING_HASH_SIZE];
 
 public:
   CFormPkg (IN UINT32 BufferSize = 4096);
@@ -206,7 +213,21 @@ private:
   UINT8      mAllDefaultTypeCount;
   UINT16     mAllDefaultIdArray[EFI_HII_MAX_SUPPORT_DEFAULT_TYPE];
 
+  //
+  // Record list in list order, and sorted by line number for the listing file.
+  // Both are rebuilt on demand after the record list is relinked.
+  //
+  SIfrRecord **mRecordIndex;
+  UINT32     mRecordIndexCount;
+  UINT32     mRecordIndexSize;
+  bool       mRecordIndexValid;
+  SIfrRecord **mLineIndex;
+  bool       mLineIndexValid;
+
   SIfrRecord * GetRecordInfoFromIdx (IN UINT32);
+  VOID             BuildRecordIndex (VOID);
+  VOID             BuildLineIndex (VOID);
+  VOID             InvalidateRecordIndex (VOID);
   BOOLEAN          CheckQuestionOpCode (IN UINT8);
   BOOLEAN          CheckIdOpCode (IN UINT8);
   EFI_QUESTION_ID  GetOpcodeQuestionId (IN EFI_IFR_OP_HEADER *);
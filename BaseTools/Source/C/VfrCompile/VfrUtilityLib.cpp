@@ -510,6 +510,23 @@ _IS_INTERNAL_TYPE (
   return FALSE;
 }
 
+UINT32
+_NAME_HASH (
+  IN CONST CHAR8 *Name
+  )
+{
+  UINT32  Hash;
+
+  //
+  // FNV-1a over the name; callers reduce the result modulo the bucket count.
+  //
+  for (Hash = 2166136261U; *Name != '\0'; Name++) {
+    Hash = (Hash ^ (UINT8) *Name) * 16777619U;
+  }
+
+  return Hash;
+}
+
 STATIC
 CHAR8 *
 TrimHex (
@@ -568,8 +585,105 @@ CVfrVarDataTypeDB::RegisterNewType (
   IN SVfrDataType  *New
   )
 {
+  SVfrDataField *pField;
+  UINT32        Bucket;
+
   New->mNext               = mDataTypeList;
   mDataTypeList            = New;
+
+  Bucket                   = _NAME_HASH (New->mTypeName) % VFR_TYPE_HASH_SIZE;
+  New->mHashNext           = mDataTypeHash[Bucket];
+  mDataTypeHash[Bucket]    = New;
+
+  //
+  // Internal types are built with their member list already linked, index them here.
+  //
+  if (New->mMemberHash == NULL) {
+    for (pField = New->mMembers; pField != NULL; pField = pField->mNext) {
+      IndexTypeField (New, pField);
+    }
+  }
+}
+
+SVfrDataType *
+CVfrVarDataTypeDB::FindDataType (
+  IN CONST CHAR8   *TypeName
+  )
+{
+  SVfrDataType *pType;
+
+  for (pType = mDataTypeHash[_NAME_HASH (TypeName) % VFR_TYPE_HASH_SIZE]; pType != NULL; pType = pType->mHashNext) {
+    if (strcmp (pType->mTypeName, TypeName) == 0) {
+      return pType;
+    }
+  }
+
+  return NULL;
+}
+
+VOID
+CVfrVarDataTypeDB::AddTypeField (
+  IN SVfrDataType  *Type,
+  IN SVfrDataField *Field
+  )
+{
+  Field->mNext             = NULL;
+  if (Type->mMembers == NULL) {
+    Type->mMembers         = Field;
+  } else {
+    Type->mLastMember->mNext = Field;
+  }
+  Type->mLastMember        = Field;
+
+  IndexTypeField (Type, Field);
+}
+
+VOID
+CVfrVarDataTypeDB::IndexTypeField (
+  IN SVfrDataType  *Type,
+  IN SVfrDataField *Field
+  )
+{
+  UINT32        Bucket;
+
+  if (Type->mMemberHash == NULL) {
+    Type->mMemberHash = new SVfrDataField *[VFR_FIELD_HASH_SIZE];
+    memset (Type->mMemberHash, 0, VFR_FIELD_HASH_SIZE * sizeof (SVfrDataField *));
+  }
+
+  //
+  // Only the first member of a given name is reachable by name, as with the
+  // member list walk this replaces (anonymous bit fields all share "").
+  //
+  if (FindTypeField (Type, Field->mFieldName) != NULL) {
+    Field->mHashNext = NULL;
+    return;
+  }
+
+  Bucket                     = _NAME_HASH (Field->mFieldName) % VFR_FIELD_HASH_SIZE;
+  Field->mHashNext           = Type->mMemberHash[Bucket];
+  Type->mMemberHash[Bucket]  = Field;
+}
+
+SVfrDataField *
+CVfrVarDataTypeDB::FindTypeField (
+  IN SVfrDataType  *Type,
+  IN CONST CHAR8   *FieldName
+  )
+{
+  SVfrDataField *pField;
+
+  if (Type->mMemberHash == NULL) {
+    return NULL;
+  }
+
+  for (pField = Type->mMemberHash[_NAME_HASH (FieldName) % VFR_FIELD_HASH_SIZE]; pField != NULL; pField = pField->mHashNext) {
+    if (strcmp (pField->mFieldName, FieldName) == 0) {
+      return pField;
+    }
+  }
+
+  return NULL;
 }
 
 EFI_VFR_RETURN_CODE
@@ -723,25 +837,24 @@ CVfrVarDataTypeDB::GetTypeField (
     return VFR_RETURN_FATAL_ERROR;
   }
 
-  for (pField = Type->mMembers; pField != NULL; pField = pField->mNext) {
-    //
-    // For type EFI_IFR_TYPE_TIME, because field name is not correctly wrote,
-    // add code to adjust it.
-    //
-    if (Type->mType == EFI_IFR_TYPE_TIME) {
-      if (strcmp (FName, "Hour") == 0) {
-        FName = "Hours";
-      } else if (strcmp (FName, "Minute") == 0) {
-        FName = "Minuts";
-      } else if (strcmp (FName, "Second") == 0) {
-        FName = "Seconds";
-      }
+  //
+  // For type EFI_IFR_TYPE_TIME, because field name is not correctly wrote,
+  // add code to adjust it.
+  //
+  if (Type->mType == EFI_IFR_TYPE_TIME) {
+    if (strcmp (FName, "Hour") == 0) {
+      FName = "Hours";
+    } else if (strcmp (FName, "Minute") == 0) {
+      FName = "Minuts";
+    } else if (strcmp (FName, "Second") == 0) {
+      FName = "Seconds";
     }
+  }
 
-    if (strcmp (pField->mFieldName, FName) == 0) {
-      Field = pField;
-      return VFR_RETURN_SUCCESS;
-    }
+  pField = FindTypeField (Type, FName);
+  if (pField != NULL) {
+    Field = pField;
+    return VFR_RETURN_SUCCESS;
   }
 
   return VFR_RETURN_UNDEFINED;
@@ -832,6 +945,8 @@ CVfrVarDataTypeDB::InternalTypesListInit (
       New->mType        = gInternalTypesTable[Index].mType;
       New->mAlign       = gInternalTypesTable[Index].mAlign;
       New->mTotalSize   = gInternalTypesTable[Index].mSize;
+      New->mLastMember  = NULL;
+      New->mMemberHash  = NULL;
       if (strcmp (gInternalTypesTable[Index].mTypeName, "EFI_HII_DATE") == 0) {
         SVfrDataField *pYearField  = new SVfrDataField;
         SVfrDataField *pMonthField = new SVfrDataField;
@@ -936,6 +1051,7 @@ CVfrVarDataTypeDB::CVfrVarDataTypeDB (
   )
 {
   mDataTypeList  = NULL;
+  memset (mDataTypeHash, 0, sizeof (mDataTypeHash));
   mNewDataType   = NULL;
   mCurrDataField = NULL;
   mPackAlign     = DEFAULT_PACK_ALIGN;
@@ -955,6 +1071,7 @@ CVfrVarDataTypeDB::~CVfrVarDataTypeDB (
   SVfrPackStackNode *pPack;
 
   if (mNewDataType != NULL) {
+    delete[] mNewDataType->mMemberHash;
     delete mNewDataType;
   }
 
@@ -966,6 +1083,7 @@ CVfrVarDataTypeDB::~CVfrVarDataTypeDB (
       pType->mMembers = pType->mMembers->mNext;
       delete pField;
     }
+    delete[] pType->mMemberHash;
   delete pType;
   }
 
@@ -1042,6 +1160,8 @@ CVfrVarDataTypeDB::DeclareDataTypeBegin (
   pNewType->mAlign       = DEFAULT_ALIGN;
   pNewType->mTotalSize   = 0;
   pNewType->mMembers     = NULL;
+  pNewType->mLastMember  = NULL;
+  pNewType->mMemberHash  = NULL;
   pNewType->mNext        = NULL;
   pNewType->mHasBitField = FALSE;
 
@@ -1065,10 +1185,8 @@ CVfrVarDataTypeDB::SetNewTypeName (
     return VFR_RETURN_INVALID_PARAMETER;
   }
 
-  for (pType = mDataTypeList; pType != NULL; pType = pType->mNext) {
-    if (strcmp(pType->mTypeName, TypeName) == 0) {
-      return VFR_RETURN_REDEFINED;
-    }
+  if (FindDataType (TypeName) != NULL) {
+    return VFR_RETURN_REDEFINED;
   }
 
   strncpy(mNewDataType->mTypeName, TypeName, MAX_NAME_LEN - 1);
@@ -1118,10 +1236,8 @@ CVfrVarDataTypeDB::DataTypeAddBitField (
     return VFR_RETURN_INVALID_PARAMETER;
   }
 
-  for (pTmp = mNewDataType->mMembers; pTmp != NULL; pTmp = pTmp->mNext) {
-    if (FieldName != NULL && strcmp (pTmp->mFieldName, FieldName) == 0) {
-      return VFR_RETURN_REDEFINED;
-    }
+  if (FieldName != NULL && FindTypeField (mNewDataType, FieldName) != NULL) {
+    return VFR_RETURN_REDEFINED;
   }
 
   Align = MIN (mPackAlign, pFieldType->mAlign);
@@ -1145,15 +1261,8 @@ CVfrVarDataTypeDB::DataTypeAddBitField (
   pNewField->mBitOffset    = 0;
   pNewField->mOffset       = 0;
 
-  if (mNewDataType->mMembers == NULL) {
-    mNewDataType->mMembers = pNewField;
-    pNewField->mNext       = NULL;
-  } else {
-    for (pTmp = mNewDataType->mMembers; pTmp->mNext != NULL; pTmp = pTmp->mNext)
-      ;
-    pTmp->mNext            = pNewField;
-    pNewField->mNext       = NULL;
-  }
+  pTmp = mNewDataType->mLastMember;
+  AddTypeField (mNewDataType, pNewField);
 
   if (FieldInUnion) {
     pNewField->mOffset = 0;
@@ -1208,7 +1317,6 @@ CVfrVarDataTypeDB::DataTypeAddField (
 {
   SVfrDataField       *pNewField  = NULL;
   SVfrDataType        *pFieldType = NULL;
-  SVfrDataField       *pTmp;
   UINT32              Align;
   UINT32              MaxDataTypeSize;
 
@@ -1219,10 +1327,8 @@ CVfrVarDataTypeDB::DataTypeAddField (
    return VFR_RETURN_INVALID_PARAMETER;
   }
 
-  for (pTmp = mNewDataType->mMembers; pTmp != NULL; pTmp = pTmp->mNext) {
-    if (strcmp (pTmp->mFieldName, FieldName) == 0) {
-      return VFR_RETURN_REDEFINED;
-    }
+  if (FindTypeField (mNewDataType, FieldName) != NULL) {
+    return VFR_RETURN_REDEFINED;
   }
 
   Align = MIN (mPackAlign, pFieldType->mAlign);
@@ -1240,15 +1346,7 @@ CVfrVarDataTypeDB::DataTypeAddField (
   } else {
     pNewField->mOffset     = mNewDataType->mTotalSize + ALIGN_STUFF(mNewDataType->mTotalSize, Align);
   }
-  if (mNewDataType->mMembers == NULL) {
-    mNewDataType->mMembers = pNewField;
-    pNewField->mNext       = NULL;
-  } else {
-    for (pTmp = mNewDataType->mMembers; pTmp->mNext != NULL; pTmp = pTmp->mNext)
-      ;
-    pTmp->mNext            = pNewField;
-    pNewField->mNext       = NULL;
-  }
+  AddTypeField (mNewDataType, pNewField);
 
   mNewDataType->mAlign     = MIN (mPackAlign, MAX (pFieldType->mAlign, mNewDataType->mAlign));
 
@@ -1303,11 +1401,10 @@ CVfrVarDataTypeDB::GetDataType (
 
   *DataType = NULL;
 
-  for (pDataType = mDataTypeList; pDataType != NULL; pDataType = pDataType->mNext) {
-    if (strcmp (TypeName, pDataType->mTypeName) == 0) {
-      *DataType = pDataType;
-      return VFR_RETURN_SUCCESS;
-    }
+  pDataType = FindDataType (TypeName);
+  if (pDataType != NULL) {
+    *DataType = pDataType;
+    return VFR_RETURN_SUCCESS;
   }
 
   return VFR_RETURN_UNDEFINED;
@@ -1359,11 +1456,10 @@ CVfrVarDataTypeDB::GetDataTypeSize (
 
   *Size = 0;
 
-  for (pDataType = mDataTypeList; pDataType != NULL; pDataType = pDataType->mNext) {
-    if (strcmp (TypeName, pDataType->mTypeName) == 0) {
-      *Size = pDataType->mTotalSize;
-      return VFR_RETURN_SUCCESS;
-    }
+  pDataType = FindDataType (TypeName);
+  if (pDataType != NULL) {
+    *Size = pDataType->mTotalSize;
+    return VFR_RETURN_SUCCESS;
   }
 
   return VFR_RETURN_UNDEFINED;
@@ -1460,19 +1556,11 @@ CVfrVarDataTypeDB::IsTypeNameDefined (
   IN CHAR8 *TypeName
   )
 {
-  SVfrDataType *pType;
-
   if (TypeName == NULL) {
     return FALSE;
   }
 
-  for (pType = mDataTypeList; pType != NULL; pType = pType->mNext) {
-    if (strcmp (pType->mTypeName, TypeName) == 0) {
-      return TRUE;
-    }
-  }
-
-  return FALSE;
+  return (BOOLEAN) (FindDataType (TypeName) != NULL);
 }
 
 VOID
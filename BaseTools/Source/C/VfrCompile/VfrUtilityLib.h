@@ -42,6 +42,11 @@ _STR2U32 (
   IN CHAR8 *Str
   );
 
+UINT32
+_NAME_HASH (
+  IN CONST CHAR8 *Name
+  );
+
 struct SConfigInfo {
   UINT16             mOffset;
   UINT16             mWidth;
@@ -104,6 +109,12 @@ extern CVfrBufferConfig gCVfrBufferConfig;
 #define ALIGN_STUFF(Size, Align) ((Align) - (Size) % (Align))
 #define INVALID_ARRAY_INDEX      0xFFFFFFFF
 
+//
+// Bucket counts of the type name and member name hash tables.
+//
+#define VFR_TYPE_HASH_SIZE       256
+#define VFR_FIELD_HASH_SIZE      32
+
 struct SVfrDataType;
 
 struct SVfrDataField {
@@ -115,6 +126,7 @@ struct SVfrDataField {
   UINT8                     mBitWidth;
   UINT32                    mBitOffset;
   SVfrDataField             *mNext;
+  SVfrDataField             *mHashNext;
 };
 
 struct SVfrDataType {
@@ -124,7 +136,10 @@ struct SVfrDataType {
   UINT32                    mTotalSize;
   BOOLEAN                   mHasBitField;
   SVfrDataField             *mMembers;
+  SVfrDataField             *mLastMember;
+  SVfrDataField             **mMemberHash;
   SVfrDataType              *mNext;
+  SVfrDataType              *mHashNext;
 };
 
 #define VFR_PACK_ASSIGN     0x01
@@ -184,6 +199,7 @@ public:
 
 private:
   SVfrDataType              *mDataTypeList;
+  SVfrDataType              *mDataTypeHash[VFR_TYPE_HASH_SIZE];
 
   SVfrDataType              *mNewDataType;
   SVfrDataType              *mCurrDataType;
@@ -191,6 +207,10 @@ private:
 
   VOID InternalTypesListInit (VOID);
   VOID RegisterNewType (IN SVfrDataType *);
+  SVfrDataType *FindDataType (IN CONST CHAR8 *);
+  VOID AddTypeField (IN SVfrDataType *, IN SVfrDataField *);
+  VOID IndexTypeField (IN SVfrDataType *, IN SVfrDataField *);
+  SVfrDataField *FindTypeField (IN SVfrDataType *, IN CONST CHAR8 *);
 
   EFI_VFR_RETURN_CODE ExtractStructTypeName (IN CHAR8 *&, OUT CHAR8 *);
   EFI_VFR_RETURN_CODE GetTypeField (IN CONST CHAR8 *, IN SVfrDataType *, IN SVfrDataField *&);
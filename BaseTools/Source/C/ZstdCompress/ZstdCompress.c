@@ -0,0 +1,504 @@
+/** @file
+  Zstandard Compress/Decompress tool (ZstdCompress)
+
+  The input is split into frames of a fixed size, compressed independently
+  of one another. Each frame records its decompressed size, so the firmware
+  can decode all the frames of a section at the same time.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ParseInf.h"
+#include "EfiUtilityMsgs.h"
+#include "CommonLib.h"
+
+#include "zstd/lib/zstd.h"
+
+#define UTILITY_NAME            "ZstdCompress"
+#define UTILITY_MAJOR_VERSION   0
+#define UTILITY_MINOR_VERSION   1
+
+#define ZSTD_NULL               0
+#define ZSTD_ENCODE             1
+#define ZSTD_DECODE             2
+
+//
+// The frame size is a trade-off between the compression ratio, which grows
+// with the frame size, and the number of processors decoding a section.
+//
+#define DEFAULT_FRAME_SIZE      (1024 * 1024)
+#define DEFAULT_LEVEL           19
+
+VOID
+Version (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Displays the standard utility information to SDTOUT
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  fprintf (stdout, "%s Version %d.%d %s \n", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
+}
+
+VOID
+Usage (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Displays the utility usage syntax to STDOUT
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  //
+  // Summary usage
+  //
+  fprintf (stdout, "Usage: ZstdCompress -e|-d [options] <input_file>\n\n");
+
+  //
+  // Details Option
+  //
+  fprintf (stdout, "optional arguments:\n");
+  fprintf (stdout, "  -h, --help            Show this help message and exit\n");
+  fprintf (stdout, "  --version             Show program's version number and exit\n");
+  fprintf (stdout, "  --debug [DEBUG]       Output DEBUG statements, where DEBUG_LEVEL is 0 (min)\n\
+                        - 9 (max)\n");
+  fprintf (stdout, "  -v, --verbose         Print informational statements\n");
+  fprintf (stdout, "  -q, --quiet           Returns the exit code, error messages will be\n\
+                        displayed\n");
+  fprintf (stdout, "  -e, --encode          Compress the input file\n");
+  fprintf (stdout, "  -d, --decode          Decompress the input file\n");
+  fprintf (stdout, "  -o OUTPUT_FILENAME, --output OUTPUT_FILENAME\n\
+                        Output file name\n");
+  fprintf (stdout, "  -l LEVEL, --level LEVEL\n\
+                        Compression level, 1 - %d, default %d\n", ZSTD_maxCLevel (), DEFAULT_LEVEL);
+  fprintf (stdout, "  --frame-size SIZE     Size of the input compressed in each independent\n\
+                        frame, default %d\n", DEFAULT_FRAME_SIZE);
+}
+
+EFI_STATUS
+Encode (
+  IN  UINT8   *Input,
+  IN  UINT32  InputSize,
+  IN  UINT32  FrameSize,
+  IN  INT32   Level,
+  OUT UINT8   **Output,
+  OUT UINT32  *OutputSize
+  )
+/*++
+
+Routine Description:
+
+  Compress a buffer into a sequence of independent frames.
+
+Arguments:
+
+  Input       - The buffer to compress.
+  InputSize   - The size of the buffer to compress.
+  FrameSize   - The size of the input compressed in each frame.
+  Level       - The compression level.
+  Output      - Returns the compressed buffer, to free by the caller.
+  OutputSize  - Returns the size of the compressed buffer.
+
+Returns:
+
+  EFI_SUCCESS           - The buffer is compressed.
+  EFI_OUT_OF_RESOURCES  - Memory could not be allocated.
+  EFI_ABORTED           - The compression failed.
+
+--*/
+{
+  ZSTD_CCtx  *Cctx;
+  UINT8      *Buffer;
+  size_t     Capacity;
+  size_t     Offset;
+  size_t     Size;
+  size_t     Result;
+  UINT32     Index;
+
+  //
+  // An empty input still makes one frame, so that the section is valid.
+  //
+  Capacity = 0;
+  Index    = 0;
+  do {
+    Size      = (InputSize - Index < FrameSize) ? InputSize - Index : FrameSize;
+    Capacity += ZSTD_compressBound (Size);
+    Index    += (UINT32)Size;
+  } while (Index < InputSize);
+
+  Buffer = malloc (Capacity);
+  Cctx   = ZSTD_createCCtx ();
+  if ((Buffer == NULL) || (Cctx == NULL)) {
+    free (Buffer);
+    ZSTD_freeCCtx (Cctx);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Offset = 0;
+  Index  = 0;
+  do {
+    Size   = (InputSize - Index < FrameSize) ? InputSize - Index : FrameSize;
+    Result = ZSTD_compressCCtx (Cctx, Buffer + Offset, Capacity - Offset, Input + Index, Size, Level);
+    if (ZSTD_isError (Result)) {
+      Error (NULL, 0, 3000, "Compression failed", "%s", ZSTD_getErrorName (Result));
+      free (Buffer);
+      ZSTD_freeCCtx (Cctx);
+      return EFI_ABORTED;
+    }
+
+    VerboseMsg ("Frame at 0x%x: 0x%x bytes compressed to 0x%x", Index, (unsigned)Size, (unsigned)Result);
+    Offset += Result;
+    Index  += (UINT32)Size;
+  } while (Index < InputSize);
+
+  ZSTD_freeCCtx (Cctx);
+  *Output     = Buffer;
+  *OutputSize = (UINT32)Offset;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+Decode (
+  IN  UINT8   *Input,
+  IN  UINT32  InputSize,
+  OUT UINT8   **Output,
+  OUT UINT32  *OutputSize
+  )
+/*++
+
+Routine Description:
+
+  Decompress a sequence of frames.
+
+Arguments:
+
+  Input       - The buffer to decompress.
+  InputSize   - The size of the buffer to decompress.
+  Output      - Returns the decompressed buffer, to free by the caller.
+  OutputSize  - Returns the size of the decompressed buffer.
+
+Returns:
+
+  EFI_SUCCESS           - The buffer is decompressed.
+  EFI_OUT_OF_RESOURCES  - Memory could not be allocated.
+  EFI_ABORTED           - The input is not valid.
+
+--*/
+{
+  unsigned long long  Size;
+  UINT8               *Buffer;
+  size_t              Result;
+
+  Size = ZSTD_findDecompressedSize (Input, InputSize);
+  if ((Size == ZSTD_CONTENTSIZE_ERROR) || (Size == ZSTD_CONTENTSIZE_UNKNOWN) || (Size > MAX_UINT32)) {
+    Error (NULL, 0, 3000, "Invalid", "input is not a sequence of frames with known sizes");
+    return EFI_ABORTED;
+  }
+
+  //
+  // malloc(0) may return NULL.
+  //
+  Buffer = malloc ((size_t)Size + 1);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Result = ZSTD_decompress (Buffer, (size_t)Size, Input, InputSize);
+  if (ZSTD_isError (Result) || (Result != Size)) {
+    Error (NULL, 0, 3000, "Decompression failed", "%s", ZSTD_isError (Result) ? ZSTD_getErrorName (Result) : "size mismatch");
+    free (Buffer);
+    return EFI_ABORTED;
+  }
+
+  *Output     = Buffer;
+  *OutputSize = (UINT32)Size;
+  return EFI_SUCCESS;
+}
+
+int
+main (
+  int   argc,
+  CHAR8 *argv[]
+  )
+/*++
+
+Routine Description:
+
+  Main function.
+
+Arguments:
+
+  argc - Number of command line parameters.
+  argv - Array of pointers to parameter strings.
+
+Returns:
+  STATUS_SUCCESS - Utility exits successfully.
+  STATUS_ERROR   - Some error occurred during execution.
+
+--*/
+{
+  EFI_STATUS  Status;
+  CHAR8       *OutputFileName;
+  CHAR8       *InputFileName;
+  UINT8       *FileBuffer;
+  UINT32      FileSize;
+  UINT8       *OutputBuffer;
+  UINT32      OutputSize;
+  UINT64      LogLevel;
+  UINT64      Value;
+  UINT8       FileAction;
+  UINT32      FrameSize;
+  INT32       Level;
+  FILE        *InFile;
+  FILE        *OutFile;
+
+  //
+  // Init local variables
+  //
+  LogLevel       = 0;
+  InputFileName  = NULL;
+  OutputFileName = NULL;
+  FileAction     = ZSTD_NULL;
+  FrameSize      = DEFAULT_FRAME_SIZE;
+  Level          = DEFAULT_LEVEL;
+  FileBuffer     = NULL;
+  OutputBuffer   = NULL;
+  InFile         = NULL;
+  OutFile        = NULL;
+
+  SetUtilityName (UTILITY_NAME);
+
+  //
+  // Verify the correct number of arguments
+  //
+  if (argc == 1) {
+    Error (NULL, 0, 1001, "Missing options", "no options input");
+    Usage ();
+    return STATUS_ERROR;
+  }
+
+  //
+  // Parse command line
+  //
+  argc --;
+  argv ++;
+
+  if ((stricmp (argv[0], "-h") == 0) || (stricmp (argv[0], "--help") == 0)) {
+    Usage ();
+    return STATUS_SUCCESS;
+  }
+
+  if (stricmp (argv[0], "--version") == 0) {
+    Version ();
+    return STATUS_SUCCESS;
+  }
+
+  while (argc > 0) {
+    if ((stricmp (argv[0], "-o") == 0) || (stricmp (argv[0], "--output") == 0)) {
+      if (argv[1] == NULL || argv[1][0] == '-') {
+        Error (NULL, 0, 1003, "Invalid option value", "Output File name is missing for -o option");
+        goto Finish;
+      }
+      OutputFileName = argv[1];
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-e") == 0) || (stricmp (argv[0], "--encode") == 0)) {
+      FileAction = ZSTD_ENCODE;
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-d") == 0) || (stricmp (argv[0], "--decode") == 0)) {
+      FileAction = ZSTD_DECODE;
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-l") == 0) || (stricmp (argv[0], "--level") == 0)) {
+      if ((argv[1] == NULL) || EFI_ERROR (AsciiStringToUint64 (argv[1], FALSE, &Value)) ||
+          (Value < 1) || (Value > (UINT64)ZSTD_maxCLevel ())) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto Finish;
+      }
+      Level = (INT32)Value;
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if (stricmp (argv[0], "--frame-size") == 0) {
+      if ((argv[1] == NULL) || EFI_ERROR (AsciiStringToUint64 (argv[1], FALSE, &Value)) ||
+          (Value == 0) || (Value > MAX_UINT32)) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto Finish;
+      }
+      FrameSize = (UINT32)Value;
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-v") == 0) || (stricmp (argv[0], "--verbose") == 0)) {
+      SetPrintLevel (VERBOSE_LOG_LEVEL);
+      VerboseMsg ("Verbose output Mode Set!");
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-q") == 0) || (stricmp (argv[0], "--quiet") == 0)) {
+      SetPrintLevel (KEY_LOG_LEVEL);
+      KeyMsg ("Quiet output Mode Set!");
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if (stricmp (argv[0], "--debug") == 0) {
+      if ((argv[1] == NULL) || EFI_ERROR (AsciiStringToUint64 (argv[1], FALSE, &LogLevel)) || (LogLevel > 9)) {
+        Error (NULL, 0, 1003, "Invalid option value", "Debug Level range is 0-9, current input level is %s", argv[1]);
+        goto Finish;
+      }
+      SetPrintLevel (LogLevel);
+      DebugMsg (NULL, 0, 9, "Debug Mode Set", "Debug Output Mode Level %s is set!", argv[1]);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if (argv[0][0] == '-') {
+      Error (NULL, 0, 1000, "Unknown option", "%s", argv[0]);
+      goto Finish;
+    }
+
+    InputFileName = argv[0];
+    argc --;
+    argv ++;
+  }
+
+  if (FileAction == ZSTD_NULL) {
+    Error (NULL, 0, 1001, "Missing option", "either the encode or the decode action must be specified");
+    goto Finish;
+  }
+
+  if (InputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Input files are not specified");
+    goto Finish;
+  }
+
+  if (OutputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Output file is not specified");
+    goto Finish;
+  }
+
+  //
+  // Read the input file
+  //
+  InFile = fopen (LongFilePath (InputFileName), "rb");
+  if (InFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", InputFileName);
+    goto Finish;
+  }
+
+  fseek (InFile, 0, SEEK_END);
+  FileSize = ftell (InFile);
+  fseek (InFile, 0, SEEK_SET);
+
+  FileBuffer = (UINT8 *) malloc (FileSize + 1);
+  if (FileBuffer == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    goto Finish;
+  }
+
+  if (fread (FileBuffer, 1, FileSize, InFile) != FileSize) {
+    Error (NULL, 0, 0004, "Error reading file", InputFileName);
+    goto Finish;
+  }
+
+  fclose (InFile);
+  InFile = NULL;
+
+  if (FileAction == ZSTD_ENCODE) {
+    Status = Encode (FileBuffer, FileSize, FrameSize, Level, &OutputBuffer, &OutputSize);
+  } else {
+    Status = Decode (FileBuffer, FileSize, &OutputBuffer, &OutputSize);
+  }
+
+  if (Status == EFI_OUT_OF_RESOURCES) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
+  VerboseMsg ("0x%x bytes in, 0x%x bytes out", FileSize, OutputSize);
+
+  //
+  // Write the output file
+  //
+  OutFile = fopen (LongFilePath (OutputFileName), "wb");
+  if (OutFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", OutputFileName);
+    goto Finish;
+  }
+
+  if (fwrite (OutputBuffer, 1, OutputSize, OutFile) != OutputSize) {
+    Error (NULL, 0, 0002, "Error writing file", OutputFileName);
+    goto Finish;
+  }
+
+Finish:
+  if (InFile != NULL) {
+    fclose (InFile);
+  }
+
+  if (OutFile != NULL) {
+    fclose (OutFile);
+  }
+
+  if (FileBuffer != NULL) {
+    free (FileBuffer);
+  }
+
+  if (OutputBuffer != NULL) {
+    free (OutputBuffer);
+  }
+
+  VerboseMsg ("%s tool done with return code is 0x%x.", UTILITY_NAME, GetUtilityStatus ());
+
+  return GetUtilityStatus ();
+}
@@ -168,4 +168,6 @@ class MemoryDataPipe(DataPipe):
 
         self.DataContainer = {"BinCacheDest":GlobalData.gBinCacheDest}
 
+        self.DataContainer = {"UsePch":GlobalData.gUsePch}
+
         self.DataContainer = {"EnableGenfdsMultiThread":GlobalData.gEnableGenfdsMultiThread}
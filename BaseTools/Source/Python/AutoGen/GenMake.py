@@ -331,7 +331,7 @@ ${END}
 #
 FORCE_REBUILD = force_build
 INIT_TARGET = init
-PCH_TARGET =
+PCH_TARGET =${BEGIN} ${precompiled_header_target}${END}
 BC_TARGET = ${BEGIN}${backward_compatible_target} ${END}
 CODA_TARGET = ${BEGIN}${remaining_build_target} \\
               ${END}
@@ -435,6 +435,13 @@ cleanlib:
     _FILE_MACRO_TEMPLATE = TemplateString("${macro_name} = ${BEGIN} \\\n    ${source_file}${END}\n")
     _BUILD_TARGET_TEMPLATE = TemplateString("${BEGIN}${target} : ${deps}\n${END}\t${cmd}\n")
 
+    ## Compile AutoGen.h into a precompiled header. The "-include AutoGen.h" is dropped
+    #  so that a stale AutoGen.h.gch is not picked up while the new one is generated.
+    _PCH_COMMAND_TEMPLATE = '"$(CC)" $(DEPS_FLAGS) $(subst -include AutoGen.h,,$(CC_FLAGS)) -x c-header -c -o $@ $(INC) %(header)s'
+
+    ## Modules with fewer C files than this do not gain from a precompiled header
+    _PCH_MIN_SOURCE_NUMBER = 3
+
     ## Constructor of ModuleMakefile
     #
     #   @param  ModuleAutoGen   Object of ModuleAutoGen class
@@ -471,6 +478,7 @@ cleanlib:
         self.MacroList = ['FFS_OUTPUT_DIR', 'MODULE_GUID', 'OUTPUT_DIR']
         self.FfsOutputFileList = []
         self.DependencyHeaderFileSet = set()
+        self.PrecompiledHeader = None
 
     # Compose a dict object containing information used to do replacement in template
     @property
@@ -580,8 +588,18 @@ cleanlib:
             EdkLogger.error("build", AUTOGEN_ERROR, "Nothing to build",
                             ExtraData="[%s]" % str(MyAgo))
 
+        self.PrecompiledHeader = self.GetPrecompiledHeader()
         self.ProcessBuildTargetList(MyAgo.OutputDir, ToolsDef)
         self.ParserGenerateFfsCmd()
+        PchTargetList = []
+        if self.PrecompiledHeader:
+            PchTargetList.append(self.PrecompiledHeader)
+            Header = os.path.join("$(DEBUG_DIR)", "AutoGen.h")
+            self.BuildTargetList.append(self._BUILD_TARGET_TEMPLATE.Replace({
+                "target": self.PrecompiledHeader,
+                "deps"  : [Header, "$(MAKE_FILE)"],
+                "cmd"   : self._PCH_COMMAND_TEMPLATE % {"header": Header}
+                }))
 
         # Generate macros used to represent input files
         FileMacroList = [] # macro name = file list
@@ -704,6 +722,7 @@ cleanlib:
             "module_entry_point"        : ModuleEntryPoint,
             "image_entry_point"         : ImageEntryPoint,
             "arch_entry_point"          : ArchEntryPoint,
+            "precompiled_header_target" : PchTargetList,
             "remaining_build_target"    : self.ResultFileList,
             "common_dependency_file"    : self.CommonFileDependency,
             "create_directory_command"  : self.GetCreateDirectoryCommand(self.IntermediateDirectoryList),
@@ -721,6 +740,26 @@ cleanlib:
 
         return MakefileTemplateDict
 
+    ## Return the precompiled AutoGen.h to build for the module, or None
+    #
+    #   GCC picks up AutoGen.h.gch next to the AutoGen.h forced in by CC_FLAGS,
+    #   and falls back to the header itself when a source is compiled with
+    #   options the precompiled header does not match, so a single one per
+    #   module serves all of its C files.
+    #
+    def GetPrecompiledHeader(self):
+        MyAgo = self._AutoGenObject
+        if not GlobalData.gUsePch or MyAgo.ToolChainFamily != "GCC":
+            return None
+        CcOption = MyAgo.BuildOption.get("CC", {})
+        if not os.path.basename(CcOption.get("PATH", "")).lower().endswith(("gcc", "gcc.exe")):
+            return None
+        if "-include AutoGen.h" not in CcOption.get("FLAGS", ""):
+            return None
+        if len(MyAgo.Targets.get(TAB_C_CODE_FILE, [])) < self._PCH_MIN_SOURCE_NUMBER:
+            return None
+        return os.path.join("$(DEBUG_DIR)", "AutoGen.h.gch")
+
     def ParserGenerateFfsCmd(self):
         #Add Ffs cmd to self.BuildTargetList
         OutputFile = ''
@@ -1029,6 +1068,9 @@ cleanlib:
                 if len(T.Inputs) == 1 and T.Inputs[0] in FileDependencyDict:
                     for F in FileDependencyDict[T.Inputs[0]]:
                         Deps.append(self.PlaceMacro(str(F), self.Macros))
+                # Objects must not be compiled before their precompiled header is done
+                if self.PrecompiledHeader and Type == TAB_C_CODE_FILE:
+                    Deps.append(self.PrecompiledHeader)
                 # Add source-dependencies
                 for F in T.Inputs:
                     NewFile = self.PlaceMacro(str(F), self.Macros)
@@ -1612,6 +1654,10 @@ class TopLevelMakefile(BuildFile):
             ExtraOption += " --no-genfds-multi-thread"
         if GlobalData.gIgnoreSource:
             ExtraOption += " --ignore-sources"
+        if GlobalData.gFdsCacheDir:
+            ExtraOption += " --fds-cache " + GlobalData.gFdsCacheDir
+        if GlobalData.gThreadNumber > 1:
+            ExtraOption += " -n %d" % GlobalData.gThreadNumber
 
         for pcd in GlobalData.BuildOptionPcd:
             if pcd[2]:
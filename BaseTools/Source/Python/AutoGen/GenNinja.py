@@ -0,0 +1,149 @@
+## @file
+# Create a ninja build file covering all modules and libraries of a platform
+#
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+## Import Modules
+#
+from __future__ import absolute_import
+import Common.LongFilePathOs as os
+import sys
+from Common.Misc import SaveFileOnChange
+from Common.DataType import TAB_COMPILER_MSFT
+from AutoGen.IncludesAutoGen import NINJA_DEPFILE
+
+NINJA_FILE_NAME = "build.ninja"
+
+## NinjaBuildFile class
+#
+#  This class generates one ninja file for all the modules and libraries of a
+#  platform build. Each module is one edge which runs the module makefile, so
+#  the build rules stay in the makefiles while ninja schedules the modules as a
+#  single dependency graph:
+#
+#   - a module depends on the makefile, its source files and the outputs of
+#     the libraries it links;
+#   - header files come from the module depfile, which is created from the
+#     dependency list (deps.txt) IncludesAutoGen collects after the build;
+#   - "restat" prunes the modules whose libraries were remade but not changed.
+#
+class NinjaBuildFile(object):
+    _FILE_HEADER_ = '''#
+# DO NOT EDIT
+# This file is auto-generated by build utility
+#
+# Abstract:
+#
+#   Auto-generated ninja file for building all modules and libraries of platform
+#
+'''
+
+    ## command used to run the makefile of one module
+    _MODULE_COMMAND_ = {
+        "win32" :   'cmd /c "cd /d "$dir" && $make tbuild"',
+        "posix" :   'cd "$dir" && $make tbuild'
+    }
+
+    ## Constructor of NinjaBuildFile
+    #
+    #   @param  BuildDir        The directory the ninja file is created in
+    #   @param  BuildCommand    The make command (list) of the platform
+    #   @param  MakeFileName    The name of the module makefiles
+    #   @param  ModuleList      The list of ModuleAutoGen objects of the modules to build
+    #
+    def __init__(self, BuildDir, BuildCommand, MakeFileName, ModuleList):
+        self.BuildDir = BuildDir
+        self.BuildCommand = BuildCommand
+        self.MakeFileName = MakeFileName
+        self.FilePath = os.path.join(BuildDir, NINJA_FILE_NAME)
+
+        # modules and all the libraries they depend on, libraries first
+        self.ModuleList = []
+        Visited = set()
+        for Ma in ModuleList:
+            self._AddModule(Ma, Visited)
+
+        if sys.platform == "win32":
+            self._Platform = "win32"
+        else:
+            self._Platform = "posix"
+
+    def _AddModule(self, Ma, Visited):
+        if Ma in Visited or Ma.IsBinaryModule:
+            return
+        Visited.add(Ma)
+        for La in Ma.LibraryAutoGenList:
+            self._AddModule(La, Visited)
+        self.ModuleList.append(Ma)
+
+    ## Return the files a module edge produces, the first one is the depfile target
+    @staticmethod
+    def GetModuleOutputList(Ma):
+        return sorted(set(T.Target.Path for T in Ma.CodaTargetList))
+
+    ## Return True if the modules can be built by the ninja file
+    #
+    #   MSVC reports header dependencies on the compiler output only, which
+    # ninja does not pass back to the build tool.
+    #
+    def IsSupported(self):
+        return all(Ma.ToolChainFamily != TAB_COMPILER_MSFT for Ma in self.ModuleList)
+
+    ## Escape a path used in a build statement
+    @staticmethod
+    def _EscapePath(Path):
+        return Path.replace('$', '$$').replace(' ', '$ ').replace(':', '$:')
+
+    ## Escape a variable value
+    @staticmethod
+    def _EscapeValue(Value):
+        return Value.replace('$', '$$')
+
+    def _ModuleInputList(self, Ma):
+        InputList = [os.path.join(Ma.MakeFileDir, self.MakeFileName)]
+        InputList.extend(sorted(set(F.Path for F in Ma.SourceFileList)))
+        AutoGenC = os.path.join(Ma.DebugDir, "AutoGen.c")
+        if os.path.exists(AutoGenC):
+            InputList.append(AutoGenC)
+        return InputList
+
+    ## Create the ninja file
+    #
+    #   @retval TRUE     The ninja file is created or re-created
+    #   @retval FALSE    The ninja file exists and is the same as the one to be generated
+    #
+    def Generate(self):
+        Make = " ".join(self.BuildCommand)
+        Content = [
+            self._FILE_HEADER_,
+            "ninja_required_version = 1.5\n",
+            "rule module",
+            "  command = %s" % self._MODULE_COMMAND_[self._Platform],
+            "  description = Building $module [$arch]",
+            "  depfile = $dir%s%s" % (os.sep, NINJA_DEPFILE),
+            "  restat = 1\n",
+            ]
+
+        OutputDict = {}
+        for Ma in self.ModuleList:
+            OutputList = self.GetModuleOutputList(Ma)
+            if not OutputList:
+                continue
+            OutputDict[Ma] = OutputList
+            LibOutputList = []
+            for La in Ma.LibraryAutoGenList:
+                LibOutputList.extend(OutputDict.get(La, []))
+            Statement = "build %s: module %s" % (" ".join(self._EscapePath(F) for F in OutputList),
+                                                 " ".join(self._EscapePath(F) for F in self._ModuleInputList(Ma)))
+            if LibOutputList:
+                Statement += " | " + " ".join(self._EscapePath(F) for F in LibOutputList)
+            Content.append(Statement)
+            Content.append("  dir = %s" % self._EscapeValue(Ma.MakeFileDir))
+            Content.append("  make = %s" % self._EscapeValue(Make))
+            Content.append("  module = %s" % self._EscapeValue(str(Ma.MetaFile)))
+            Content.append("  arch = %s\n" % Ma.Arch)
+
+        Content.append("default %s\n" % " ".join(
+            self._EscapePath(F) for Ma in self.ModuleList for F in OutputDict.get(Ma, [])))
+        return SaveFileOnChange(self.FilePath, "\n".join(Content), False)
@@ -16,6 +16,9 @@ gIsFileMap = {}
 
 DEP_FILE_TAIL = "# Updated \n"
 
+## Name of the depfile read by the ninja build file for a module
+NINJA_DEPFILE = "deps.ninja"
+
 class IncludesAutoGen():
     """ This class is to manage the dependent files witch are used in Makefile to support incremental build.
         1. C files:
@@ -74,6 +77,11 @@ ${END}
     def CreateDepsTarget(self):
         SaveFileOnChange(os.path.join(self.makefile_folder,"deps_target"),"\n".join([item +":" for item in self.DepsCollection]),False)
 
+    def CreateNinjaDepfile(self, target):
+        """ Generate the depfile of the module's ninja build edge, target is the first output of the edge.
+            Like deps_target, an item of DepsCollection may hold several files separated by spaces. """
+        SaveFileOnChange(os.path.join(self.makefile_folder, NINJA_DEPFILE), " \\\n".join([target.replace(" ", "\\ ") + ":"] + list(self.DepsCollection)) + "\n", False)
+
     @cached_property
     def deps_files(self):
         """ Get all .deps file under module build folder. """
@@ -901,6 +901,9 @@ class WorkspaceAutoGen(AutoGen):
         FdsCommandDict["GenfdsMultiThread"] = GlobalData.gEnableGenfdsMultiThread
         if GlobalData.gIgnoreSource:
             FdsCommandDict["IgnoreSources"] = True
+        if GlobalData.gFdsCacheDir:
+            FdsCommandDict["FdsCacheDir"] = GlobalData.gFdsCacheDir
+        FdsCommandDict["ThreadNumber"] = GlobalData.gThreadNumber
 
         FdsCommandDict["OptionPcd"] = []
         for pcd in GlobalData.BuildOptionPcd:
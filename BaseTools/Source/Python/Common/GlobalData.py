@@ -119,6 +119,10 @@ gModuleAllCacheStatus = None
 gModuleCacheHit = None
 
 gEnableGenfdsMultiThread = True
+gFdsCacheDir = None
+gThreadNumber = 1
+gUsePch = False
+gUseNinja = False
 gSikpAutoGenCache = set()
 # Common lock for the file access in multiple process AutoGens
 file_lock = None
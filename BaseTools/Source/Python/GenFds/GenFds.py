@@ -18,6 +18,8 @@ from glob import glob
 from struct import unpack
 from linecache import getlines
 from io import BytesIO
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
+import threading
 
 import Common.LongFilePathOs as os
 from Common.TargetTxtClassObject import TargetTxtDict,gDefaultTargetTxtFile
@@ -25,16 +27,18 @@ from Common.DataType import *
 import Common.GlobalData as GlobalData
 from Common import EdkLogger
 from Common.StringUtils import NormPath
-from Common.Misc import DirCache, PathClass, GuidStructureStringToGuidString
+from Common.Misc import DirCache, PathClass, GuidStructureStringToGuidString, CreateDirectory
 from Common.Misc import SaveFileOnChange, ClearDuplicatedInf
 from Common.BuildVersion import gBUILD_VERSION
 from Common.MultipleWorkspace import MultipleWorkspace as mws
-from Common.BuildToolError import FatalError, GENFDS_ERROR, CODE_ERROR, FORMAT_INVALID, RESOURCE_NOT_AVAILABLE, FILE_NOT_FOUND, OPTION_MISSING, FORMAT_NOT_SUPPORTED, OPTION_VALUE_INVALID, PARAMETER_INVALID
+from Common.BuildToolError import FatalError, GENFDS_ERROR, CODE_ERROR, FORMAT_INVALID, RESOURCE_NOT_AVAILABLE, FILE_NOT_FOUND, OPTION_MISSING, FORMAT_NOT_SUPPORTED, OPTION_VALUE_INVALID, PARAMETER_INVALID, FILE_CREATE_FAILURE
 from Workspace.WorkspaceDatabase import WorkspaceDatabase
 
 from .FdfParser import FdfParser, Warning
 from .GenFdsGlobalVariable import GenFdsGlobalVariable
 from .FfsFileStatement import FileStatement
+from .FfsInfStatement import FfsInfStatement
+from .FvImageSection import FvImageSection
 import Common.DataType as DataType
 from struct import Struct
 
@@ -94,8 +98,10 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.FdsCacheDir = ''
 
-    GenFdsGlobalVariable.LargeFileInFvFlags = []
+    GenFdsGlobalVariable.ToolLock = None
+    GenFdsGlobalVariable.ThreadState = threading.local()
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     GenFdsGlobalVariable.LARGE_FILE_SIZE = 0x1000000
 
@@ -142,6 +148,11 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = True
             else:
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = False
+        GenFds.ThreadNumber = FdsCommandDict.get("ThreadNumber") or 1
+        if FdsCommandDict.get("FdsCacheDir"):
+            GenFdsGlobalVariable.FdsCacheDir = os.path.abspath(FdsCommandDict.get("FdsCacheDir"))
+            if not CreateDirectory(GenFdsGlobalVariable.FdsCacheDir):
+                EdkLogger.error("GenFds", FILE_CREATE_FAILURE, ExtraData="Could not create FDS cache directory %s" % GenFdsGlobalVariable.FdsCacheDir)
         os.chdir(GenFdsGlobalVariable.WorkSpaceDir)
 
         # set multiple workspace
@@ -414,6 +425,8 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["OptionPcd"] = Options.OptionPcd
     FdsCommandDict["conf_directory"] = Options.ConfDirectory
     FdsCommandDict["IgnoreSources"] = Options.IgnoreSources
+    FdsCommandDict["FdsCacheDir"] = Options.FdsCacheDir
+    FdsCommandDict["ThreadNumber"] = Options.ThreadNumber
     FdsCommandDict["macro"] = Options.Macros
     FdsCommandDict["build_architecture_list"] = Options.archList
     FdsCommandDict["platform_build_directory"] = Options.outputDir
@@ -465,6 +478,8 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("-n", "--thread-number", action="store", type="int", dest="ThreadNumber", default=1, help="Generate up to the specified number of independent FV images concurrently.")
+    Parser.add_option("--fds-cache", action="store", type="string", dest="FdsCacheDir", help="Reuse section, FFS and image files from a content-addressed cache in the specified directory.")
 
     Options, _ = Parser.parse_args()
     return Options
@@ -481,6 +496,7 @@ class GenFds(object):
     OnlyGenerateThisFd = None
     OnlyGenerateThisFv = None
     OnlyGenerateThisCap = None
+    ThreadNumber = 1
 
     ## GenFd()
     #
@@ -506,6 +522,8 @@ class GenFds(object):
                 FdObj.GenFd()
                 return
         elif GenFds.OnlyGenerateThisFd is None and GenFds.OnlyGenerateThisFv is None:
+            if GenFds.OnlyGenerateThisCap is None:
+                GenFds.PreGenerateFv(GenFds.ThreadNumber)
             for FdObj in GenFdsGlobalVariable.FdfParser.Profile.FdDict.values():
                 FdObj.GenFd()
 
@@ -534,6 +552,148 @@ class GenFds(object):
                 for OptRomObj in GenFdsGlobalVariable.FdfParser.Profile.OptRomDict.values():
                     OptRomObj.AddToBuffer(None)
 
+    ## GetNestedFv()
+    #
+    #   Collect the FVs nested in a section list through FV_IMAGE sections.
+    #
+    #   @param  SectionList     The sections to search, searched recursively
+    #   @param  FvNameSet       The set the upper case FV names are added to
+    #
+    @staticmethod
+    def GetNestedFv(SectionList, FvNameSet):
+        for Section in SectionList:
+            if isinstance(Section, FvImageSection):
+                if Section.FvName:
+                    FvNameSet.add(Section.FvName.upper())
+            else:
+                GenFds.GetNestedFv(getattr(Section, 'SectionList', []), FvNameSet)
+
+    ## PreGenerateFv()
+    #
+    #   Generate the FV images that are not placed at an address ahead of the
+    #   FDs, running the independent ones concurrently. Such an FV is built the
+    #   same way wherever it is first used, so the FD, FV and capsule generation
+    #   that follows simply picks it up from ImageBinDict.
+    #
+    #   An FV only runs once all FVs nested in it are done, and never together
+    #   with another FV that shares a module or FILE statement with it.
+    #
+    #   @param  ThreadNumber    The maximum number of FVs generated at once
+    #
+    @staticmethod
+    def PreGenerateFv(ThreadNumber):
+        #
+        # Module FFS files are only prebuilt by make in multi-thread mode,
+        # otherwise FVs sharing a module would rebuild it concurrently.
+        #
+        if ThreadNumber <= 1 or not GenFdsGlobalVariable.EnableGenfdsMultiThread:
+            return
+        Profile = GenFdsGlobalVariable.FdfParser.Profile
+
+        #
+        # FVs generated at an address, as part of a capsule, or with macros
+        # inherited from where they are used, depend on their first user.
+        #
+        Placed = set()
+        for FdObj in Profile.FdDict.values():
+            for RegionObj in FdObj.RegionList:
+                if RegionObj.RegionType == BINARY_FILE_TYPE_FV:
+                    Placed.update(RegionData.upper() for RegionData in RegionObj.RegionDataList)
+            if FdObj.DefineVarDict:
+                return
+        for CapsuleObj in Profile.CapsuleDict.values():
+            for CapsuleData in CapsuleObj.CapsuleDataList:
+                if getattr(CapsuleData, 'FvName', None):
+                    Placed.add(CapsuleData.FvName.upper())
+        for FmpPayload in Profile.FmpPayloadDict.values():
+            for CapsuleData in list(FmpPayload.ImageFile) + list(FmpPayload.VendorCodeFile):
+                if getattr(CapsuleData, 'FvName', None):
+                    Placed.add(CapsuleData.FvName.upper())
+        for RuleObj in Profile.RuleDict.values():
+            GenFds.GetNestedFv(getattr(RuleObj, 'SectionList', []), Placed)
+
+        NestedFv = {}
+        FfsKeys = {}
+        for FvName, FvObj in Profile.FvDict.items():
+            NestedFv[FvName] = set()
+            FfsKeys[FvName] = set()
+            if FvObj.DefineVarDict:
+                return
+            if FvObj.BaseAddress is not None or FvObj.FvBaseAddress is not None or FvObj.CapsuleName is not None:
+                Placed.add(FvName)
+            for FfsFile in FvObj.FfsList:
+                if isinstance(FfsFile, FfsInfStatement):
+                    FfsKeys[FvName].add(os.path.normcase(FfsFile.InfFileName))
+                    continue
+                if not isinstance(FfsFile, FileStatement):
+                    continue
+                FfsKeys[FvName].add(str(FfsFile.NameGuid).upper())
+                FileFv = set()
+                if FfsFile.FvName:
+                    FileFv.add(FfsFile.FvName.upper())
+                GenFds.GetNestedFv(FfsFile.SectionList, FileFv)
+                if FfsFile.FdName or FfsFile.DefineVarDict:
+                    Placed.add(FvName)
+                    Placed.update(FileFv)
+                NestedFv[FvName].update(FileFv)
+
+        #
+        # An FV can only be generated early if every FV nested in it can.
+        #
+        Candidates = {}
+        def IsCandidate(FvName):
+            if FvName not in Candidates:
+                Candidates[FvName] = (FvName in Profile.FvDict and FvName not in Placed and
+                                      all(IsCandidate(Nested) for Nested in NestedFv[FvName]))
+            return Candidates[FvName]
+        Pending = set(FvName for FvName in Profile.FvDict if IsCandidate(FvName))
+        if len(Pending) < 2:
+            return
+
+        GenFdsGlobalVariable.VerboseLogger("\n Generate %d independent FV images with %d threads!" % (len(Pending), ThreadNumber))
+        Done = set()
+        Running = {}
+        Errors = []
+        GenFdsGlobalVariable.ToolLock = threading.Lock()
+        try:
+            with ThreadPoolExecutor(max_workers=ThreadNumber) as Pool:
+                while Running or (Pending and not Errors):
+                    for FvName in sorted(Pending):
+                        if Errors or len(Running) >= ThreadNumber:
+                            break
+                        if NestedFv[FvName] - Done:
+                            continue
+                        if any(FfsKeys[FvName] & FfsKeys[Other] for Other in Running.values()):
+                            continue
+                        Pending.remove(FvName)
+                        Running[Pool.submit(GenFds.PreGenerateOneFv, Profile.FvDict[FvName])] = FvName
+                    if not Running:
+                        break
+                    Finished, _ = wait(list(Running), return_when=FIRST_COMPLETED)
+                    for Future in Finished:
+                        FvName = Running.pop(Future)
+                        if Future.exception() is not None:
+                            Errors.append(Future.exception())
+                        else:
+                            Done.add(FvName)
+        finally:
+            GenFdsGlobalVariable.ToolLock = None
+        if Errors:
+            raise Errors[0]
+
+    ## PreGenerateOneFv()
+    #
+    #   Worker of PreGenerateFv(), holds the tool lock except while a tool runs.
+    #
+    #   @param  FvObj           The FV to generate
+    #
+    @staticmethod
+    def PreGenerateOneFv(FvObj):
+        with GenFdsGlobalVariable.ToolLock:
+            Buffer = BytesIO()
+            FvObj.AddToBuffer(Buffer)
+            Buffer.close()
+
     @staticmethod
     def GenFfsMakefile(OutputDir, FdfParserObject, WorkSpace, ArchList, GlobalData):
         GenFdsGlobalVariable.SetEnv(FdfParserObject, WorkSpace, ArchList, GlobalData)
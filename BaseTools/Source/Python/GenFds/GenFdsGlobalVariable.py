@@ -14,6 +14,10 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import hashlib
+import shutil
+import threading
+from uuid import uuid4
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
@@ -75,15 +79,24 @@ class GenFdsGlobalVariable:
     EnableGenfdsMultiThread = True
 
     #
-    # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
-    # At the beginning of each generation of FV, false flag is appended to the list,
-    # after the call to GenerateSection returns, check the size of the output file,
-    # if it is greater than 0xFFFFFF, the tail flag in list is set to true,
-    # and EFI_FIRMWARE_FILE_SYSTEM3_GUID is passed to C GenFv.
-    # At the end of generation of FV, pop the flag.
-    # List is used as a stack to handle nested FV generation.
+    # Directory of the content-addressed cache of tool outputs, shared between
+    # build trees. Empty if the cache is disabled.
     #
-    LargeFileInFvFlags = []
+    FdsCacheDir = ''
+    FdsCacheVersion = b'GenFdsCache 1.0'
+    __FileHashCache = {}
+
+    #
+    # Lock serializing the FV images generated concurrently. The thread running
+    # an FV holds it except while it waits for an external tool. None if FVs
+    # are generated one at a time.
+    #
+    ToolLock = None
+
+    #
+    # Per-thread state of the FV being generated, see GetLargeFileInFvFlags().
+    #
+    ThreadState = threading.local()
     EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     LARGE_FILE_SIZE = 0x1000000
 
@@ -402,6 +415,25 @@ class GenFdsGlobalVariable:
             Str = mws.join(GenFdsGlobalVariable.WorkSpaceDir, String)
         return os.path.normpath(Str)
 
+    ## GetLargeFileInFvFlags()
+    #
+    #   The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
+    #   At the beginning of each generation of FV, false flag is appended to the list,
+    #   after the call to GenerateSection returns, check the size of the output file,
+    #   if it is greater than 0xFFFFFF, the tail flag in list is set to true,
+    #   and EFI_FIRMWARE_FILE_SYSTEM3_GUID is passed to C GenFv.
+    #   At the end of generation of FV, pop the flag.
+    #   List is used as a stack to handle nested FV generation, one per thread
+    #   so that FVs generated concurrently do not see each other's flags.
+    #
+    #   @retval list            The flag stack of the calling thread
+    #
+    @staticmethod
+    def GetLargeFileInFvFlags():
+        if not hasattr(GenFdsGlobalVariable.ThreadState, 'LargeFileInFvFlags'):
+            GenFdsGlobalVariable.ThreadState.LargeFileInFvFlags = []
+        return GenFdsGlobalVariable.ThreadState.LargeFileInFvFlags
+
     ## Check if the input files are newer than output files
     #
     #   @param  Output          Path of output file
@@ -501,7 +533,7 @@ class GenFdsGlobalVariable:
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedExternalTool(Cmd, Output, "Failed to generate section")
         else:
             Cmd += ("-o", Output)
             Cmd += Input
@@ -516,10 +548,11 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedExternalTool(Cmd, Output, "Failed to generate section")
+                LargeFileInFvFlags = GenFdsGlobalVariable.GetLargeFileInFvFlags()
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
-                    GenFdsGlobalVariable.LargeFileInFvFlags):
-                    GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
+                    LargeFileInFvFlags):
+                    LargeFileInFvFlags[-1] = True
 
     @staticmethod
     def GetAlignment (AlignString):
@@ -572,7 +605,7 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.CallCachedExternalTool(Cmd, Output, "Failed to generate FFS")
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -641,7 +674,7 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate firmware image")
+            GenFdsGlobalVariable.CallCachedExternalTool(Cmd, Output, "Failed to generate firmware image")
 
     @staticmethod
     def GenerateOptionRom(Output, EfiInput, BinaryInput, Compress=False, ClassCode=None,
@@ -700,7 +733,103 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            GenFdsGlobalVariable.CallCachedExternalTool(Cmd, Output, "Failed to call " + ToolPath, returnValue)
+
+    ## GetFileHash()
+    #
+    #   @param  File            The file to be hashed
+    #
+    #   @retval string          The SHA-256 digest of the file content
+    #
+    @staticmethod
+    def GetFileHash(File):
+        File = os.path.normcase(os.path.abspath(File))
+        Stat = os.stat(File)
+        Entry = GenFdsGlobalVariable.__FileHashCache.get(File)
+        if Entry and Entry[0] == Stat.st_mtime and Entry[1] == Stat.st_size:
+            return Entry[2]
+        Hash = hashlib.sha256()
+        with open(File, 'rb') as Fd:
+            for Chunk in iter(lambda: Fd.read(0x100000), b''):
+                Hash.update(Chunk)
+        GenFdsGlobalVariable.__FileHashCache[File] = (Stat.st_mtime, Stat.st_size, Hash.hexdigest())
+        return Hash.hexdigest()
+
+    ## GetToolCacheKey()
+    #
+    #   The key covers the tool binary and every argument of the command, with
+    #   the output file name left out and each existing input file replaced by
+    #   the hash of its content, so identical work in another build tree maps
+    #   to the same key.
+    #
+    #   @param  Cmd             The tool command line
+    #   @param  Output          The single file generated by the tool
+    #
+    #   @retval string          The cache key
+    #   @retval None            if the command can not be cached
+    #
+    @staticmethod
+    def GetToolCacheKey(Cmd, Output):
+        if not GenFdsGlobalVariable.FdsCacheDir:
+            return None
+        Tool = shutil.which(Cmd[0])
+        if not Tool:
+            return None
+        Hash = hashlib.sha256(GenFdsGlobalVariable.FdsCacheVersion)
+        Hash.update(GenFdsGlobalVariable.GetFileHash(Tool).encode())
+        OutputPath = os.path.normcase(os.path.abspath(Output))
+        OutputCount = 0
+        for Arg in Cmd[1:]:
+            if os.path.normcase(os.path.abspath(Arg)) == OutputPath:
+                OutputCount += 1
+                Arg = '<output>'
+            elif os.path.isfile(Arg):
+                Arg = '<file %s>' % GenFdsGlobalVariable.GetFileHash(Arg)
+            Hash.update(Arg.encode('utf-8') + b'\0')
+        #
+        # The tool updates the output in place, or does not name it at all.
+        #
+        if OutputCount != 1:
+            return None
+        return Hash.hexdigest()
+
+    ## CallCachedExternalTool()
+    #
+    #   Run a tool generating a single output file, reusing the output of an
+    #   identical earlier run from the FDS cache if there is one.
+    #
+    @staticmethod
+    def CallCachedExternalTool (cmd, Output, errorMess, returnValue=[]):
+        Key = GenFdsGlobalVariable.GetToolCacheKey(cmd, Output)
+        if Key is None:
+            GenFdsGlobalVariable.CallExternalTool(cmd, errorMess, returnValue)
+            return
+
+        CacheFile = os.path.join(GenFdsGlobalVariable.FdsCacheDir, Key[:2], Key)
+        if os.path.isfile(CacheFile):
+            CreateDirectory(os.path.dirname(Output))
+            shutil.copyfile(CacheFile, Output)
+            if returnValue != []:
+                returnValue[0] = 0
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s restored from FDS cache %s" % (Output, CacheFile))
+            return
+
+        GenFdsGlobalVariable.CallExternalTool(cmd, errorMess, returnValue)
+        if (returnValue != [] and returnValue[0] != 0) or not os.path.isfile(Output):
+            return
+
+        #
+        # Publish the entry with a rename so that concurrent builds sharing the
+        # cache never see a partial file. Failing to store is not an error.
+        #
+        TempFile = '%s.%s.tmp' % (CacheFile, uuid4().hex)
+        try:
+            CreateDirectory(os.path.dirname(CacheFile))
+            shutil.copyfile(Output, TempFile)
+            os.rename(TempFile, CacheFile)
+        except (IOError, OSError):
+            if os.path.exists(TempFile):
+                os.remove(TempFile)
 
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
@@ -722,14 +851,24 @@ class GenFdsGlobalVariable:
             if GenFdsGlobalVariable.SharpCounter % GenFdsGlobalVariable.SharpNumberPerLine == 0:
                 stdout.write('\n')
 
+        #
+        # Let other FVs make progress while this one waits for the tool.
+        #
+        ToolLock = GenFdsGlobalVariable.ToolLock
+        if ToolLock:
+            ToolLock.release()
         try:
-            PopenObject = Popen(' '.join(cmd), stdout=PIPE, stderr=PIPE, shell=True)
-        except Exception as X:
-            EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(X), cmd[0]))
-        (out, error) = PopenObject.communicate()
-
-        while PopenObject.returncode is None:
-            PopenObject.wait()
+            try:
+                PopenObject = Popen(' '.join(cmd), stdout=PIPE, stderr=PIPE, shell=True)
+            except Exception as X:
+                EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(X), cmd[0]))
+            (out, error) = PopenObject.communicate()
+
+            while PopenObject.returncode is None:
+                PopenObject.wait()
+        finally:
+            if ToolLock:
+                ToolLock.acquire()
         if returnValue != [] and returnValue[0] != 0:
             #get command return value
             returnValue[0] = PopenObject.returncode
@@ -255,10 +255,26 @@ class MetaFileParser(object):
         if not self._Finished:
             if self._RawTable.IsIntegrity():
                 self._Finished = True
+            elif self._UseTableCache and self._RawTable.DB.LoadMetaFileTable(self._RawTable):
+                self._Finished = True
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
                 self.Start()
+                if self._UseTableCache:
+                    self._RawTable.DB.StoreMetaFileTable(self._RawTable)
+
+    ## Whether the raw table may be restored from or saved to the workspace database cache
+    #
+    #   INF and DEC raw tables only depend on the file content. DSC raw tables
+    # depend on global and command line macros, and usage checking of INF files
+    # is done while parsing, so both of them are always parsed.
+    #
+    @property
+    def _UseTableCache(self):
+        if self._FileType == MODEL_FILE_DSC:
+            return False
+        return not (GlobalData.gOptions and GlobalData.gOptions.CheckUsage)
     ## Data parser for the common format in different type of file
     #
     #   The common format in the meatfile is like
@@ -10,6 +10,13 @@
 # Import Modules
 #
 from __future__ import absolute_import
+import sys
+import hashlib
+import pickle
+from os import getpid
+import Common.LongFilePathOs as os
+import Common.GlobalData as GlobalData
+import Common.EdkLogger as EdkLogger
 from Common.StringUtils import *
 from Common.DataType import *
 from Common.Misc import *
@@ -35,6 +42,9 @@ from Workspace.InfBuildData import InfBuildData
 #
 class WorkspaceDatabase(object):
 
+    # bump it whenever the layout of raw table rows changes
+    _META_FILE_CACHE_VERSION_ = 1
+
     #
     # internal class used for call corresponding file parser and caching the result
     # to avoid unnecessary re-parsing
@@ -154,6 +164,12 @@ class WorkspaceDatabase(object):
         self.TblFile = []
         self.Platform = None
 
+        # raw INF/DEC tables persisted in GlobalData.gDatabasePath
+        #   {FilePath : (ContentDigest, [Row, ...])}
+        self._MetaFileCache = None
+        self._MetaFileCacheChanged = False
+        self._MetaFileDigest = {}
+
         # conversion object for build or file format conversion purpose
         self.BuildObject = WorkspaceDatabase.BuildObjectFactory(self)
         self.TransformObject = WorkspaceDatabase.TransformObjectFactory(self)
@@ -187,6 +203,88 @@ class WorkspaceDatabase(object):
 
         return PackageList
 
+    ## Signature of the parser code the cached tables were created by
+    def _MetaFileCacheSignature(self):
+        Signature = [self._META_FILE_CACHE_VERSION_]
+        for Class in (InfParser, ModuleTable):
+            try:
+                Signature.append(os.path.getmtime(sys.modules[Class.__module__].__file__))
+            except (AttributeError, KeyError, OSError):
+                Signature.append(None)
+        return Signature
+
+    def _LoadMetaFileCache(self):
+        self._MetaFileCache = {}
+        DbPath = GlobalData.gDatabasePath
+        if not os.path.isabs(DbPath) or not os.path.isfile(DbPath):
+            return
+        try:
+            with open(DbPath, 'rb') as File:
+                Signature, Cache = pickle.load(File)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Ignore meta file cache %s: %s" % (DbPath, Exc))
+            return
+        if Signature == self._MetaFileCacheSignature():
+            self._MetaFileCache = Cache
+
+    def _GetMetaFileDigest(self, MetaFile):
+        if MetaFile.Path not in self._MetaFileDigest:
+            try:
+                with open(MetaFile.Path, 'rb') as File:
+                    self._MetaFileDigest[MetaFile.Path] = hashlib.md5(File.read()).hexdigest()
+            except IOError:
+                self._MetaFileDigest[MetaFile.Path] = None
+        return self._MetaFileDigest[MetaFile.Path]
+
+    ## Restore the raw table of a meta file parsed by a previous build
+    #
+    #   @param  Table   Empty raw table of the meta file
+    #
+    #   @retval True    The table is restored and complete
+    #   @retval False   No valid cache for the meta file, it must be parsed
+    #
+    def LoadMetaFileTable(self, Table):
+        if self._MetaFileCache is None:
+            self._LoadMetaFileCache()
+        Entry = self._MetaFileCache.get(Table.MetaFile.Path)
+        if Entry is None or Entry[0] != self._GetMetaFileDigest(Table.MetaFile):
+            return False
+        # row IDs depend on the order files are parsed in, so re-insert rows
+        # and map the owner of each row to its new ID
+        IdMapping = {}
+        for Row in Entry[1]:
+            IdMapping[Row[0]] = Table.Insert(Row[1], Row[2], Row[3], Row[4], Row[5], Row[6],
+                                             IdMapping.get(Row[7], Row[7]), *Row[8:])
+        Table.SetEndFlag()
+        return True
+
+    ## Remember the raw table of a meta file which has just been parsed
+    def StoreMetaFileTable(self, Table):
+        if self._MetaFileCache is None:
+            self._LoadMetaFileCache()
+        Digest = self._GetMetaFileDigest(Table.MetaFile)
+        if Digest is None:
+            return
+        self._MetaFileCache[Table.MetaFile.Path] = (Digest, [tuple(Row) for Row in Table.CurrentContent if Row[0] >= 0])
+        self._MetaFileCacheChanged = True
+
+    ## Write the raw tables parsed in this build back to the cache
+    def SaveMetaFileCache(self):
+        if not self._MetaFileCacheChanged or not os.path.isabs(GlobalData.gDatabasePath):
+            return
+        DbPath = GlobalData.gDatabasePath
+        TempPath = DbPath + '.%d' % getpid()
+        try:
+            if not os.path.isdir(os.path.dirname(DbPath)):
+                os.makedirs(os.path.dirname(DbPath))
+            with open(TempPath, 'wb') as File:
+                pickle.dump((self._MetaFileCacheSignature(), self._MetaFileCache), File, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempPath, DbPath)
+        except (IOError, OSError) as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to save meta file cache %s: %s" % (DbPath, Exc))
+            return
+        self._MetaFileCacheChanged = False
+
     def MapPlatform(self, Dscfile):
         Platform = self.BuildObject[PathClass(Dscfile), TAB_COMMON]
         if Platform is None:
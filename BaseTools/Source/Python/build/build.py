@@ -35,6 +35,7 @@ from AutoGen.WorkspaceAutoGen import WorkspaceAutoGen
 from AutoGen.AutoGenWorker import AutoGenWorkerInProcess,AutoGenManager,\
     LogAgent
 from AutoGen import GenMake
+from AutoGen.GenNinja import NinjaBuildFile
 from Common import Misc as Utils
 
 from Common.TargetTxtClassObject import TargetTxtDict
@@ -271,17 +272,29 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
 
         EdkLogger.error("build", COMMAND_FAILURE, ExtraData="%s [%s]" % (Command, WorkingDir))
     if ModuleAuto:
-        iau = IncludesAutoGen(WorkingDir,ModuleAuto)
-        if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
-            iau.CreateDepsFileForMsvc(Proc.ProcOut)
-        else:
-            iau.UpdateDepsFileforNonMsvc()
-        iau.UpdateDepsFileforTrim()
-        iau.CreateModuleDeps()
-        iau.CreateDepsInclude()
-        iau.CreateDepsTarget()
+        UpdateModuleDeps(WorkingDir, ModuleAuto, Proc.ProcOut)
     return "%dms" % (int(round((time.time() - BeginTime) * 1000)))
 
+## Update the dependency files of a module which has been built
+#
+# @param  WorkingDir            The build directory of the module
+# @param  ModuleAuto            The ModuleAutoGen object of the module
+# @param  ProcOut               The output of the build command, for MSVC /showIncludes
+# @param  NinjaTarget           The first output of the module in the ninja build file
+#
+def UpdateModuleDeps(WorkingDir, ModuleAuto, ProcOut, NinjaTarget=None):
+    iau = IncludesAutoGen(WorkingDir,ModuleAuto)
+    if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
+        iau.CreateDepsFileForMsvc(ProcOut)
+    else:
+        iau.UpdateDepsFileforNonMsvc()
+    iau.UpdateDepsFileforTrim()
+    iau.CreateModuleDeps()
+    iau.CreateDepsInclude()
+    iau.CreateDepsTarget()
+    if NinjaTarget:
+        iau.CreateNinjaDepfile(NinjaTarget)
+
 ## The smallest unit that can be built in multi-thread build mode
 #
 # This is the base class of build unit. The "Obj" parameter must provide
@@ -747,6 +760,9 @@ class Build():
         GlobalData.gBinCacheDest   = BuildOptions.BinCacheDest
         GlobalData.gBinCacheSource = BuildOptions.BinCacheSource
         GlobalData.gEnableGenfdsMultiThread = not BuildOptions.NoGenfdsMultiThread
+        GlobalData.gFdsCacheDir = os.path.abspath(BuildOptions.FdsCacheDir) if BuildOptions.FdsCacheDir else None
+        GlobalData.gUsePch = BuildOptions.UsePch
+        GlobalData.gUseNinja = BuildOptions.UseNinja
         GlobalData.gDisableIncludePathCheck = BuildOptions.DisableIncludePathCheck
 
         if GlobalData.gBinCacheDest and not GlobalData.gUseHashCache:
@@ -996,6 +1012,7 @@ class Build():
         self.ToolChainFamily = ToolChainFamily
 
         self.ThreadNumber   = ThreadNum()
+        GlobalData.gThreadNumber = self.ThreadNumber
     ## Initialize build configuration
     #
     #   This method will parse DSC file and merge the configurations from
@@ -2288,28 +2305,29 @@ class Build():
                     EdkLogger.quiet("[cache Summary]: PreMakecache miss num: %s " % len(self.PreMakeCacheMiss))
                     EdkLogger.quiet("[cache Summary]: Makecache miss num: %s " % len(self.MakeCacheMiss))
 
-                for Arch in Wa.ArchList:
-                    MakeStart = time.time()
-                    for Ma in set(self.BuildModules):
-                        # Generate build task for the module
-                        if not Ma.IsBinaryModule:
-                            Bt = BuildTask.New(ModuleMakeUnit(Ma, Pa.BuildCommand,self.Target))
-                        # Break build if any build thread has error
+                if not GlobalData.gUseNinja or not self._NinjaBuildPlatform(Wa, Pa):
+                    for Arch in Wa.ArchList:
+                        MakeStart = time.time()
+                        for Ma in set(self.BuildModules):
+                            # Generate build task for the module
+                            if not Ma.IsBinaryModule:
+                                Bt = BuildTask.New(ModuleMakeUnit(Ma, Pa.BuildCommand,self.Target))
+                            # Break build if any build thread has error
+                            if BuildTask.HasError():
+                                # we need a full version of makefile for platform
+                                ExitFlag.set()
+                                BuildTask.WaitForComplete()
+                                Pa.CreateMakeFile(False)
+                                EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
+                            # Start task scheduler
+                            if not BuildTask.IsOnGoing():
+                                BuildTask.StartScheduler(self.ThreadNumber, ExitFlag)
+
+                        # in case there's an interruption. we need a full version of makefile for platform
+
                         if BuildTask.HasError():
-                            # we need a full version of makefile for platform
-                            ExitFlag.set()
-                            BuildTask.WaitForComplete()
-                            Pa.CreateMakeFile(False)
                             EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
-                        # Start task scheduler
-                        if not BuildTask.IsOnGoing():
-                            BuildTask.StartScheduler(self.ThreadNumber, ExitFlag)
-
-                    # in case there's an interruption. we need a full version of makefile for platform
-
-                    if BuildTask.HasError():
-                        EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
-                    self.MakeTime += int(round((time.time() - MakeStart)))
+                        self.MakeTime += int(round((time.time() - MakeStart)))
 
                 MakeContiue = time.time()
                 #
@@ -2376,6 +2394,29 @@ class Build():
                     self._SaveMapFile(MapBuffer, Wa)
                 self.CreateGuidedSectionToolsFile(Wa)
 
+    ## Build all modules of the platform with one ninja build file
+    #
+    #   @retval True    The modules have been built
+    #   @retval False   The modules cannot be built by ninja
+    #
+    def _NinjaBuildPlatform(self, Wa, Pa):
+        NinjaFile = NinjaBuildFile(Wa.BuildDir, Pa.BuildCommand, Pa.MakeFileName, set(self.BuildModules))
+        if not NinjaFile.IsSupported():
+            EdkLogger.warn("build", "The ninja backend does not support MSVC tool chains, use the build scheduler instead")
+            return False
+        NinjaFile.Generate()
+        MakeStart = time.time()
+        try:
+            LaunchCommand(["ninja", "-f", NinjaFile.FilePath, "-j", str(self.ThreadNumber)], Wa.BuildDir)
+        finally:
+            # keep the header dependencies of the modules built before a failure
+            for Ma in NinjaFile.ModuleList:
+                OutputList = NinjaFile.GetModuleOutputList(Ma)
+                if OutputList and os.path.exists(OutputList[0]):
+                    UpdateModuleDeps(Ma.MakeFileDir, Ma, [], OutputList[0])
+            self.MakeTime += int(round((time.time() - MakeStart)))
+        return True
+
     ## GetFreeSizeThreshold()
     #
     #   @retval int             Threshold value
@@ -2482,15 +2523,20 @@ class Build():
         self.PreMakeCacheHit = set()
         self.MakeCacheMiss = set()
         self.MakeCacheHit = set()
-        if not self.ModuleFile:
-            if not self.SpawnMode or self.Target not in ["", "all"]:
-                self.SpawnMode = False
-                self._BuildPlatform()
+        try:
+            if not self.ModuleFile:
+                if not self.SpawnMode or self.Target not in ["", "all"]:
+                    self.SpawnMode = False
+                    self._BuildPlatform()
+                else:
+                    self._MultiThreadBuildPlatform()
             else:
-                self._MultiThreadBuildPlatform()
-        else:
-            self.SpawnMode = False
-            self._BuildModule()
+                self.SpawnMode = False
+                self._BuildModule()
+        finally:
+            # keep the meta files parsed so far even if the build failed
+            if self.Target != 'cleanall':
+                self.Db.SaveMetaFileCache()
 
         if self.Target == 'cleanall':
             RemoveDirectory(os.path.dirname(GlobalData.gDatabasePath), True)
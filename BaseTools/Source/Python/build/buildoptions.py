@@ -101,5 +101,8 @@ class MyOptionParser():
         Parser.add_option("--binary-source", action="store", type="string", dest="BinCacheSource", help="Consume a cache of binary files from the specified directory.")
         Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
         Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+        Parser.add_option("--fds-cache", action="store", type="string", dest="FdsCacheDir", help="Reuse section, FFS and image files generated by GenFds from a content-addressed cache in the specified directory.")
+        Parser.add_option("--pch", action="store_true", dest="UsePch", default=False, help="Precompile AutoGen.h for modules with several C source files when building with GCC.")
+        Parser.add_option("--ninja", action="store_true", dest="UseNinja", default=False, help="Generate a ninja file for all modules and libraries of the platform and build them with ninja.")
         Parser.add_option("--disable-include-path-check", action="store_true", dest="DisableIncludePathCheck", default=False, help="Disable the include path check for outside of package.")
         self.BuildOption, self.BuildTarget = Parser.parse_args()
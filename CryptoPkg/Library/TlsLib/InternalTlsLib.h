@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #undef _WIN64
 
 #include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -35,6 +36,57 @@ typedef struct {
   // Memory BIO for the TLS/SSL Writing operations.
   //
   BIO    *OutBio;
+  //
+  // Host name or IP address literal of the peer, if set with
+  // TlsSetVerifyHost(). It keys the session cache.
+  //
+  CHAR8    *HostName;
 } TLS_CONNECTION;
 
+//
+// The number of client sessions cached per SSL_CTX object.
+//
+#define TLS_SESSION_CACHE_SIZE  8
+
+typedef struct {
+  CHAR8          *HostName;
+  INT32          VerifyMode;
+  SSL_SESSION    *Session;
+} TLS_SESSION_CACHE_ENTRY;
+
+//
+// Client sessions of a SSL_CTX object, which new connections to the same
+// peer resume instead of running a full handshake. It is attached to the
+// SSL_CTX object as its application data.
+//
+typedef struct {
+  TLS_SESSION_CACHE_ENTRY    Entry[TLS_SESSION_CACHE_SIZE];
+  UINTN                      Next;
+} TLS_SESSION_CACHE;
+
+/**
+  Prepare a TLS connection to resume the session cached for its peer, if any.
+
+  This must be called before the handshake starts.
+
+  @param[in]  TlsConn    Pointer to the TLS connection.
+
+**/
+VOID
+TlsResumeSession (
+  IN TLS_CONNECTION  *TlsConn
+  );
+
+/**
+  Remove the session cached for the peer of a TLS connection, after the
+  handshake failed.
+
+  @param[in]  TlsConn    Pointer to the TLS connection.
+
+**/
+VOID
+TlsForgetSession (
+  IN TLS_CONNECTION  *TlsConn
+  );
+
 #endif
@@ -591,7 +591,21 @@ TlsSetVerifyHost (
     ParamStatus = X509_VERIFY_PARAM_set1_host (VerifyParam, HostName, 0);
   }
 
-  return (ParamStatus == 1) ? EFI_SUCCESS : EFI_ABORTED;
+  if (ParamStatus != 1) {
+    return EFI_ABORTED;
+  }
+
+  //
+  // Keep the host name for the session cache. Without it, the connection
+  // just doesn't resume or cache a session.
+  //
+  if (TlsConn->HostName != NULL) {
+    FreePool (TlsConn->HostName);
+  }
+
+  TlsConn->HostName = AllocateCopyPool (AsciiStrSize (HostName), HostName);
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -46,6 +46,188 @@ TlsInitialize (
   return RandomSeed (NULL, 0);
 }
 
+/**
+  Find the session cached for the peer of a TLS connection.
+
+  The peer is identified by the host name it is verified against, and the
+  session must have been established with the same verification mode.
+
+  @param[in]  Cache      Pointer to the session cache.
+  @param[in]  TlsConn    Pointer to the TLS connection.
+
+  @return  The cache entry of the session, or NULL if none is cached.
+
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsFindCachedSession (
+  IN TLS_SESSION_CACHE  *Cache,
+  IN TLS_CONNECTION     *TlsConn
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  UINTN                    Index;
+
+  if (TlsConn->HostName == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    Entry = &Cache->Entry[Index];
+    if ((Entry->Session != NULL) &&
+        (Entry->VerifyMode == SSL_get_verify_mode (TlsConn->Ssl)) &&
+        (AsciiStrCmp (Entry->HostName, TlsConn->HostName) == 0))
+    {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Release the session of a cache entry.
+
+  @param[in, out]  Entry    Pointer to the cache entry.
+
+**/
+STATIC
+VOID
+TlsFreeCachedSession (
+  IN OUT TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->Session != NULL) {
+    SSL_SESSION_free (Entry->Session);
+    Entry->Session = NULL;
+  }
+
+  if (Entry->HostName != NULL) {
+    FreePool (Entry->HostName);
+    Entry->HostName = NULL;
+  }
+}
+
+/**
+  Cache a new client session, called by OpenSSL when the handshake completes
+  or, with TLS 1.3, when the server sends a session ticket.
+
+  @param[in]  Ssl        Pointer to the SSL object of the connection.
+  @param[in]  Session    Pointer to the new session.
+
+  @retval 1    The session is cached, and its reference kept.
+  @retval 0    The session isn't cached.
+
+**/
+STATIC
+int
+TlsNewSessionCallback (
+  IN SSL          *Ssl,
+  IN SSL_SESSION  *Session
+  )
+{
+  TLS_CONNECTION           *TlsConn;
+  TLS_SESSION_CACHE        *Cache;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  CHAR8                    *HostName;
+
+  TlsConn = (TLS_CONNECTION *)SSL_get_app_data (Ssl);
+  Cache   = (TLS_SESSION_CACHE *)SSL_CTX_get_app_data (SSL_get_SSL_CTX (Ssl));
+  if ((TlsConn == NULL) || (Cache == NULL) || (TlsConn->HostName == NULL)) {
+    return 0;
+  }
+
+  Entry = TlsFindCachedSession (Cache, TlsConn);
+  if (Entry == NULL) {
+    HostName = AllocateCopyPool (AsciiStrSize (TlsConn->HostName), TlsConn->HostName);
+    if (HostName == NULL) {
+      return 0;
+    }
+
+    //
+    // Replace the oldest entry.
+    //
+    Entry       = &Cache->Entry[Cache->Next];
+    Cache->Next = (Cache->Next + 1) % TLS_SESSION_CACHE_SIZE;
+    TlsFreeCachedSession (Entry);
+
+    Entry->HostName   = HostName;
+    Entry->VerifyMode = SSL_get_verify_mode (Ssl);
+  } else {
+    SSL_SESSION_free (Entry->Session);
+  }
+
+  Entry->Session = Session;
+  return 1;
+}
+
+/**
+  Prepare a TLS connection to resume the session cached for its peer, if any.
+
+  This must be called before the handshake starts.
+
+  @param[in]  TlsConn    Pointer to the TLS connection.
+
+**/
+VOID
+TlsResumeSession (
+  IN TLS_CONNECTION  *TlsConn
+  )
+{
+  TLS_SESSION_CACHE        *Cache;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  //
+  // Leave any session set by the caller alone.
+  //
+  if (SSL_get_session (TlsConn->Ssl) != NULL) {
+    return;
+  }
+
+  Cache = (TLS_SESSION_CACHE *)SSL_CTX_get_app_data (SSL_get_SSL_CTX (TlsConn->Ssl));
+  if (Cache == NULL) {
+    return;
+  }
+
+  Entry = TlsFindCachedSession (Cache, TlsConn);
+  if (Entry == NULL) {
+    return;
+  }
+
+  if (!SSL_SESSION_is_resumable (Entry->Session)) {
+    TlsFreeCachedSession (Entry);
+    return;
+  }
+
+  SSL_set_session (TlsConn->Ssl, Entry->Session);
+}
+
+/**
+  Remove the session cached for the peer of a TLS connection, after the
+  handshake failed.
+
+  @param[in]  TlsConn    Pointer to the TLS connection.
+
+**/
+VOID
+TlsForgetSession (
+  IN TLS_CONNECTION  *TlsConn
+  )
+{
+  TLS_SESSION_CACHE        *Cache;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  Cache = (TLS_SESSION_CACHE *)SSL_CTX_get_app_data (SSL_get_SSL_CTX (TlsConn->Ssl));
+  if (Cache == NULL) {
+    return;
+  }
+
+  Entry = TlsFindCachedSession (Cache, TlsConn);
+  if (Entry != NULL) {
+    TlsFreeCachedSession (Entry);
+  }
+}
+
 /**
   Free an allocated SSL_CTX object.
 
@@ -58,10 +240,22 @@ TlsCtxFree (
   IN   VOID  *TlsCtx
   )
 {
+  TLS_SESSION_CACHE  *Cache;
+  UINTN              Index;
+
   if (TlsCtx == NULL) {
     return;
   }
 
+  Cache = (TLS_SESSION_CACHE *)SSL_CTX_get_app_data ((SSL_CTX *)TlsCtx);
+  if (Cache != NULL) {
+    for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+      TlsFreeCachedSession (&Cache->Entry[Index]);
+    }
+
+    FreePool (Cache);
+  }
+
   if (TlsCtx != NULL) {
     SSL_CTX_free ((SSL_CTX *)(TlsCtx));
   }
@@ -85,8 +279,9 @@ TlsCtxNew (
   IN     UINT8  MinorVer
   )
 {
-  SSL_CTX  *TlsCtx;
-  UINT16   ProtoVersion;
+  SSL_CTX            *TlsCtx;
+  UINT16             ProtoVersion;
+  TLS_SESSION_CACHE  *Cache;
 
   ProtoVersion = (MajorVer << 8) | MinorVer;
 
@@ -106,6 +301,23 @@ TlsCtxNew (
   //
   SSL_CTX_set_min_proto_version (TlsCtx, ProtoVersion);
 
+  //
+  // Cache the client sessions, so that the connections to a peer resume
+  // the session of the previous one with a TLS 1.3 session ticket or a
+  // TLS 1.2 session ID, instead of running a full handshake. OpenSSL only
+  // looks up the sessions of its internal store for servers: clients
+  // keep the sessions in TLS_SESSION_CACHE instead.
+  //
+  Cache = AllocateZeroPool (sizeof (TLS_SESSION_CACHE));
+  if (Cache == NULL) {
+    SSL_CTX_free (TlsCtx);
+    return NULL;
+  }
+
+  SSL_CTX_set_app_data (TlsCtx, Cache);
+  SSL_CTX_set_session_cache_mode (TlsCtx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb (TlsCtx, TlsNewSessionCallback);
+
   return (VOID *)TlsCtx;
 }
 
@@ -138,6 +350,10 @@ TlsFree (
     SSL_free (TlsConn->Ssl);
   }
 
+  if (TlsConn->HostName != NULL) {
+    FreePool (TlsConn->HostName);
+  }
+
   OPENSSL_free (Tls);
 }
 
@@ -174,7 +390,8 @@ TlsNew (
     return NULL;
   }
 
-  TlsConn->Ssl = NULL;
+  TlsConn->Ssl      = NULL;
+  TlsConn->HostName = NULL;
 
   //
   // Create a new SSL Object
@@ -185,6 +402,11 @@ TlsNew (
     return NULL;
   }
 
+  //
+  // The session cache callback finds the TLS_CONNECTION of the SSL object.
+  //
+  SSL_set_app_data (TlsConn->Ssl, TlsConn);
+
   //
   // This retains compatibility with previous version of OpenSSL.
   //
@@ -106,6 +106,7 @@ TlsDoHandshake (
     PendingBufferSize = (UINTN)BIO_ctrl_pending (TlsConn->OutBio);
     if (PendingBufferSize == 0) {
       SSL_set_connect_state (TlsConn->Ssl);
+      TlsResumeSession (TlsConn);
       Ret               = SSL_do_handshake (TlsConn->Ssl);
       PendingBufferSize = (UINTN)BIO_ctrl_pending (TlsConn->OutBio);
     }
@@ -150,6 +151,7 @@ TlsDoHandshake (
       }
 
       DEBUG_CODE_END ();
+      TlsForgetSession (TlsConn);
       return EFI_ABORTED;
     }
   }
@@ -0,0 +1,772 @@
+/** @file
+  Dynamic Table Manager ACPI table cache.
+
+  The tables generated on a boot are stored in non-volatile variables,
+  together with the list of Configuration Manager objects the generators
+  requested. On the next boot the objects are requested again, and if
+  none of them changed the stored tables are installed without invoking
+  the generators.
+
+  Copyright (c) 2017 - 2019, ARM Limited. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  @par Glossary:
+    - Cm or CM   - Configuration Manager
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Protocol/AcpiTable.h>
+
+// Module specific include files.
+#include <AcpiTableGenerator.h>
+#include <ConfigurationManagerObject.h>
+#include <Protocol/ConfigurationManagerProtocol.h>
+
+#include "DynamicTableCache.h"
+
+#define TABLE_CACHE_SIGNATURE  SIGNATURE_32 ('D', 'T', 'C', 'H')
+#define TABLE_CACHE_VERSION    1
+
+/// Name of the variable holding the TABLE_CACHE_HEADER.
+#define TABLE_CACHE_VARIABLE_NAME  L"DynamicTableCache"
+
+/// Maximum length of the name of a cache variable, including the NULL.
+#define TABLE_CACHE_VARIABLE_NAME_LENGTH  24
+
+/// Room left in a data variable for the variable header and name.
+#define TABLE_CACHE_VARIABLE_OVERHEAD  0x80
+
+#define TABLE_CACHE_VARIABLE_ATTRIBUTES  \
+          (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+/** The header of the cache.
+
+  The cache data is an array of ObjectCount TABLE_CACHE_OBJECT entries
+  followed by TableCount ACPI tables, each aligned on 8 bytes. It is
+  split in ChunkSize pieces stored in the "DynamicTableCacheNNNN"
+  variables.
+*/
+typedef struct {
+  UINT32    Signature;
+  UINT32    Version;
+  UINT32    FirmwareRevision;
+  UINT32    ObjectCount;
+  UINT32    TableCount;
+  UINT32    DataSize;
+  UINT32    ChunkSize;
+  UINT32    DataCrc;
+} TABLE_CACHE_HEADER;
+
+/** A Configuration Manager object requested by a generator.
+*/
+typedef struct {
+  /// Object Id
+  CM_OBJECT_ID    CmObjectId;
+
+  /// Size of the object or object list
+  UINT32          Size;
+
+  /// Token identifying the object
+  UINT64          Token;
+
+  /// Status returned by the Configuration Manager
+  UINT64          Status;
+
+  /// Count of objects in the list
+  UINT32          Count;
+
+  /// CRC32 of the object data
+  UINT32          DataCrc;
+} TABLE_CACHE_OBJECT;
+
+/// The Configuration Manager Protocol the recording forwards to.
+STATIC CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *mCfgMgrProtocol;
+
+/// The Configuration Manager Protocol given to the generators.
+STATIC EDKII_CONFIGURATION_MANAGER_PROTOCOL  mRecordingCfgMgrProtocol;
+
+/// TRUE while the tables are recorded.
+STATIC BOOLEAN  mRecording;
+
+/// TRUE if the recorded tables must not be cached.
+STATIC BOOLEAN  mRecordingDiscarded;
+
+/// The objects requested by the generators.
+STATIC TABLE_CACHE_OBJECT  *mObjects;
+STATIC UINTN               mObjectCount;
+STATIC UINTN               mObjectMax;
+
+/// The installed tables.
+STATIC UINT8  *mTables;
+STATIC UINTN  mTablesSize;
+STATIC UINTN  mTablesMax;
+STATIC UINTN  mTableCount;
+
+/** Fill a cache entry describing an object returned by the
+    Configuration Manager.
+
+  @param [in]  CmObjectId  The Configuration Manager Object ID.
+  @param [in]  Token       The token identifying the object.
+  @param [in]  Status      The status returned by GetObject.
+  @param [in]  CmObject    The object descriptor returned by GetObject.
+  @param [out] Object      The cache entry.
+**/
+STATIC
+VOID
+DescribeCmObject (
+  IN  CM_OBJECT_ID                     CmObjectId,
+  IN  CM_OBJECT_TOKEN                  Token,
+  IN  EFI_STATUS                       Status,
+  IN  CONST CM_OBJ_DESCRIPTOR  *CONST  CmObject,
+  OUT TABLE_CACHE_OBJECT               *Object
+  )
+{
+  ZeroMem (Object, sizeof (*Object));
+  Object->CmObjectId = CmObjectId;
+  Object->Token      = (UINT64)Token;
+  Object->Status     = (UINT64)Status;
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Object->Size  = CmObject->Size;
+  Object->Count = CmObject->Count;
+  if ((CmObject->Data != NULL) && (CmObject->Size != 0)) {
+    Object->DataCrc = CalculateCrc32 (CmObject->Data, CmObject->Size);
+  }
+}
+
+/** Grow a recording buffer.
+
+  @param [in, out] Buffer   The buffer.
+  @param [in, out] MaxSize  The size of the buffer.
+  @param [in]      Size     The size needed.
+
+  @retval TRUE   The buffer holds at least Size bytes.
+  @retval FALSE  Out of resources.
+**/
+STATIC
+BOOLEAN
+GrowRecordingBuffer (
+  IN OUT VOID   **Buffer,
+  IN OUT UINTN  *MaxSize,
+  IN     UINTN  Size
+  )
+{
+  UINTN  NewSize;
+  VOID   *NewBuffer;
+
+  if (Size <= *MaxSize) {
+    return TRUE;
+  }
+
+  NewSize = MAX (Size, 2 * *MaxSize);
+  NewSize = MAX (NewSize, SIZE_4KB);
+
+  NewBuffer = ReallocatePool (*MaxSize, NewSize, *Buffer);
+  if (NewBuffer == NULL) {
+    return FALSE;
+  }
+
+  *Buffer  = NewBuffer;
+  *MaxSize = NewSize;
+  return TRUE;
+}
+
+/** Record an object returned to a generator.
+
+  An object is only recorded once. If it is returned with a different
+  content later on, the tables cannot be cached.
+
+  @param [in]  CmObjectId  The Configuration Manager Object ID.
+  @param [in]  Token       The token identifying the object.
+  @param [in]  Status      The status returned by GetObject.
+  @param [in]  CmObject    The object descriptor returned by GetObject.
+**/
+STATIC
+VOID
+RecordCmObject (
+  IN  CM_OBJECT_ID                     CmObjectId,
+  IN  CM_OBJECT_TOKEN                  Token,
+  IN  EFI_STATUS                       Status,
+  IN  CONST CM_OBJ_DESCRIPTOR  *CONST  CmObject
+  )
+{
+  TABLE_CACHE_OBJECT  Object;
+  UINTN               Index;
+  UINTN               MaxSize;
+
+  if (mRecordingDiscarded) {
+    return;
+  }
+
+  DescribeCmObject (CmObjectId, Token, Status, CmObject, &Object);
+
+  for (Index = 0; Index < mObjectCount; Index++) {
+    if ((mObjects[Index].CmObjectId == Object.CmObjectId) &&
+        (mObjects[Index].Token == Object.Token))
+    {
+      if (CompareMem (&mObjects[Index], &Object, sizeof (Object)) != 0) {
+        DEBUG ((
+          DEBUG_INFO,
+          "INFO: CmObjectId 0x%x changed during table generation," \
+          " not caching the tables.\n",
+          CmObjectId
+          ));
+        mRecordingDiscarded = TRUE;
+      }
+
+      return;
+    }
+  }
+
+  MaxSize = mObjectMax * sizeof (TABLE_CACHE_OBJECT);
+  if (!GrowRecordingBuffer (
+         (VOID **)&mObjects,
+         &MaxSize,
+         (mObjectCount + 1) * sizeof (TABLE_CACHE_OBJECT)
+         ))
+  {
+    mRecordingDiscarded = TRUE;
+    return;
+  }
+
+  mObjectMax = MaxSize / sizeof (TABLE_CACHE_OBJECT);
+  CopyMem (&mObjects[mObjectCount++], &Object, sizeof (Object));
+}
+
+/** The GetObject function of the recording Configuration Manager
+    Protocol.
+
+  @param [in]  This        Pointer to the Configuration Manager Protocol.
+  @param [in]  CmObjectId  The Configuration Manager Object ID.
+  @param [in]  Token       An optional token identifying the object. If
+                           unused this must be CM_NULL_TOKEN.
+  @param [out] CmObject    Pointer to the Configuration Manager Object
+                           descriptor describing the requested Object.
+
+  @retval EFI_SUCCESS           Success.
+  @retval EFI_INVALID_PARAMETER A parameter is invalid.
+  @retval EFI_NOT_FOUND         The required object information is not found.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+RecordingGetObject (
+  IN  CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  This,
+  IN  CONST CM_OBJECT_ID                                  CmObjectId,
+  IN  CONST CM_OBJECT_TOKEN                               Token OPTIONAL,
+  IN  OUT   CM_OBJ_DESCRIPTOR                     *CONST  CmObject
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = mCfgMgrProtocol->GetObject (
+                              mCfgMgrProtocol,
+                              CmObjectId,
+                              Token,
+                              CmObject
+                              );
+  if (mRecording && (CmObject != NULL)) {
+    RecordCmObject (CmObjectId, Token, Status, CmObject);
+  }
+
+  return Status;
+}
+
+/** The SetObject function of the recording Configuration Manager
+    Protocol.
+
+  Tables generated by generators updating the Configuration Manager
+  objects are not cached.
+
+  @param [in]  This        Pointer to the Configuration Manager Protocol.
+  @param [in]  CmObjectId  The Configuration Manager Object ID.
+  @param [in]  Token       An optional token identifying the object. If
+                           unused this must be CM_NULL_TOKEN.
+  @param [out] CmObject    Pointer to the Configuration Manager Object
+                           descriptor describing the Object.
+
+  @retval EFI_SUCCESS           The operation completed successfully.
+  @retval EFI_INVALID_PARAMETER A parameter is invalid.
+  @retval EFI_NOT_FOUND         The required object information is not found.
+  @retval EFI_UNSUPPORTED       This operation is not supported.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+RecordingSetObject (
+  IN  CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  This,
+  IN  CONST CM_OBJECT_ID                                  CmObjectId,
+  IN  CONST CM_OBJECT_TOKEN                               Token OPTIONAL,
+  IN        CM_OBJ_DESCRIPTOR                     *CONST  CmObject
+  )
+{
+  mRecordingDiscarded = TRUE;
+  return mCfgMgrProtocol->SetObject (
+                            mCfgMgrProtocol,
+                            CmObjectId,
+                            Token,
+                            CmObject
+                            );
+}
+
+/** Build the name of a cache data variable.
+
+  @param [in]  Index  The index of the data chunk.
+  @param [out] Name   Buffer of TABLE_CACHE_VARIABLE_NAME_LENGTH characters
+                      receiving the name.
+**/
+STATIC
+VOID
+GetCacheVariableName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Name
+  )
+{
+  UnicodeSPrint (
+    Name,
+    TABLE_CACHE_VARIABLE_NAME_LENGTH * sizeof (CHAR16),
+    L"%s%04x",
+    TABLE_CACHE_VARIABLE_NAME,
+    Index
+    );
+}
+
+/** Delete the cache header, which invalidates the cache.
+**/
+STATIC
+VOID
+InvalidateAcpiTableCache (
+  VOID
+  )
+{
+  gRT->SetVariable (
+         TABLE_CACHE_VARIABLE_NAME,
+         &gEdkiiDynamicTableCacheVariableGuid,
+         0,
+         0,
+         NULL
+         );
+}
+
+/** Read and check the cache data.
+
+  @param [out] Header  The cache header.
+  @param [out] Data    The cache data, to be freed by the caller.
+
+  @retval EFI_SUCCESS     Success.
+  @retval EFI_NOT_FOUND   There is no cache or it is invalid.
+**/
+STATIC
+EFI_STATUS
+ReadAcpiTableCache (
+  OUT TABLE_CACHE_HEADER  *Header,
+  OUT UINT8               **Data
+  )
+{
+  EFI_STATUS                   Status;
+  UINTN                        Size;
+  UINTN                        Offset;
+  UINTN                        Index;
+  UINTN                        ChunkSize;
+  UINT8                        *Buffer;
+  CHAR16                       Name[TABLE_CACHE_VARIABLE_NAME_LENGTH];
+  EFI_ACPI_DESCRIPTION_HEADER  *AcpiTable;
+
+  Size   = sizeof (*Header);
+  Status = gRT->GetVariable (
+                  TABLE_CACHE_VARIABLE_NAME,
+                  &gEdkiiDynamicTableCacheVariableGuid,
+                  NULL,
+                  &Size,
+                  Header
+                  );
+  if (EFI_ERROR (Status) || (Size != sizeof (*Header))) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((Header->Signature != TABLE_CACHE_SIGNATURE) ||
+      (Header->Version != TABLE_CACHE_VERSION) ||
+      (Header->FirmwareRevision != gST->FirmwareRevision) ||
+      (Header->ChunkSize == 0) ||
+      (Header->TableCount == 0) ||
+      (Header->ObjectCount > Header->DataSize / sizeof (TABLE_CACHE_OBJECT)))
+  {
+    DEBUG ((DEBUG_INFO, "INFO: ACPI table cache is out of date.\n"));
+    return EFI_NOT_FOUND;
+  }
+
+  Buffer = AllocatePool (Header->DataSize);
+  if (Buffer == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Offset = 0, Index = 0; Offset < Header->DataSize; Index++) {
+    ChunkSize = MIN (Header->ChunkSize, Header->DataSize - Offset);
+    Size      = ChunkSize;
+    GetCacheVariableName (Index, Name);
+    Status = gRT->GetVariable (
+                    Name,
+                    &gEdkiiDynamicTableCacheVariableGuid,
+                    NULL,
+                    &Size,
+                    Buffer + Offset
+                    );
+    if (EFI_ERROR (Status) || (Size != ChunkSize)) {
+      goto Invalid;
+    }
+
+    Offset += ChunkSize;
+  }
+
+  if (CalculateCrc32 (Buffer, Header->DataSize) != Header->DataCrc) {
+    goto Invalid;
+  }
+
+  // Check the tables, so that nothing is installed from a bad cache.
+  Offset = Header->ObjectCount * sizeof (TABLE_CACHE_OBJECT);
+  for (Index = 0; Index < Header->TableCount; Index++) {
+    if ((Header->DataSize - Offset) < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) {
+      goto Invalid;
+    }
+
+    AcpiTable = (EFI_ACPI_DESCRIPTION_HEADER *)(Buffer + Offset);
+    if ((AcpiTable->Length < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) ||
+        (AcpiTable->Length > (Header->DataSize - Offset)) ||
+        (CalculateCheckSum8 ((UINT8 *)AcpiTable, AcpiTable->Length) != 0))
+    {
+      goto Invalid;
+    }
+
+    Offset += ALIGN_VALUE (AcpiTable->Length, 8);
+  }
+
+  if (Offset != Header->DataSize) {
+    goto Invalid;
+  }
+
+  *Data = Buffer;
+  return EFI_SUCCESS;
+
+Invalid:
+  DEBUG ((DEBUG_WARN, "WARNING: ACPI table cache is corrupted.\n"));
+  FreePool (Buffer);
+  return EFI_NOT_FOUND;
+}
+
+/** Install the ACPI tables cached by a previous boot.
+
+  The cache is only used if every Configuration Manager object the
+  cached tables were generated from is still returned unchanged, and
+  the firmware revision is the same.
+
+  @param [in]  CfgMgrProtocol     Pointer to the Configuration Manager
+                                  Protocol Interface.
+  @param [in]  AcpiTableProtocol  Pointer to the AcpiTable protocol.
+
+  @retval EFI_SUCCESS     The cached tables are installed.
+  @retval EFI_NOT_FOUND   There is no valid cache, the tables must
+                          be generated. Nothing was installed.
+  @retval Others          Installing a cached table failed.
+**/
+EFI_STATUS
+EFIAPI
+InstallCachedAcpiTables (
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol,
+  IN       EFI_ACPI_TABLE_PROTOCOL                       *AcpiTableProtocol
+  )
+{
+  EFI_STATUS                   Status;
+  TABLE_CACHE_HEADER           Header;
+  UINT8                        *Data;
+  TABLE_CACHE_OBJECT           *Objects;
+  TABLE_CACHE_OBJECT           Object;
+  CM_OBJ_DESCRIPTOR            CmObject;
+  EFI_ACPI_DESCRIPTION_HEADER  *AcpiTable;
+  UINTN                        TableHandle;
+  UINTN                        Offset;
+  UINTN                        Index;
+
+  ASSERT (CfgMgrProtocol != NULL);
+  ASSERT (AcpiTableProtocol != NULL);
+
+  Status = ReadAcpiTableCache (&Header, &Data);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Objects = (TABLE_CACHE_OBJECT *)Data;
+  for (Index = 0; Index < Header.ObjectCount; Index++) {
+    ZeroMem (&CmObject, sizeof (CmObject));
+    Status = CfgMgrProtocol->GetObject (
+                               CfgMgrProtocol,
+                               Objects[Index].CmObjectId,
+                               (CM_OBJECT_TOKEN)Objects[Index].Token,
+                               &CmObject
+                               );
+    DescribeCmObject (
+      Objects[Index].CmObjectId,
+      (CM_OBJECT_TOKEN)Objects[Index].Token,
+      Status,
+      &CmObject,
+      &Object
+      );
+    if (CompareMem (&Objects[Index], &Object, sizeof (Object)) != 0) {
+      DEBUG ((
+        DEBUG_INFO,
+        "INFO: CmObjectId 0x%x changed, ACPI table cache is out of date.\n",
+        Object.CmObjectId
+        ));
+      FreePool (Data);
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  Offset = Header.ObjectCount * sizeof (TABLE_CACHE_OBJECT);
+  for (Index = 0; Index < Header.TableCount; Index++) {
+    AcpiTable = (EFI_ACPI_DESCRIPTION_HEADER *)(Data + Offset);
+    DUMP_ACPI_TABLE_HEADER (AcpiTable);
+
+    Status = AcpiTableProtocol->InstallAcpiTable (
+                                  AcpiTableProtocol,
+                                  AcpiTable,
+                                  AcpiTable->Length,
+                                  &TableHandle
+                                  );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "ERROR: Failed to Install cached ACPI Table. Status = %r\n",
+        Status
+        ));
+      // Regenerate the tables on the next boot.
+      InvalidateAcpiTableCache ();
+      break;
+    }
+
+    Offset += ALIGN_VALUE (AcpiTable->Length, 8);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_INFO,
+      "INFO: %d cached ACPI Tables installed.\n",
+      Header.TableCount
+      ));
+  }
+
+  FreePool (Data);
+  return Status;
+}
+
+/** Start recording the ACPI tables to cache.
+
+  The returned Configuration Manager Protocol forwards all calls to
+  CfgMgrProtocol and records the objects returned to the generators.
+
+  @param [in]  CfgMgrProtocol     Pointer to the Configuration Manager
+                                  Protocol Interface.
+
+  @return The Configuration Manager Protocol the generators must use.
+**/
+CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL *
+EFIAPI
+StartAcpiTableCacheRecording (
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol
+  )
+{
+  ASSERT (CfgMgrProtocol != NULL);
+
+  mCfgMgrProtocol = CfgMgrProtocol;
+  CopyMem (
+    &mRecordingCfgMgrProtocol,
+    CfgMgrProtocol,
+    sizeof (mRecordingCfgMgrProtocol)
+    );
+  mRecordingCfgMgrProtocol.GetObject = RecordingGetObject;
+  mRecordingCfgMgrProtocol.SetObject = RecordingSetObject;
+
+  mRecording          = TRUE;
+  mRecordingDiscarded = FALSE;
+  mObjectCount        = 0;
+  mTablesSize         = 0;
+  mTableCount         = 0;
+
+  return &mRecordingCfgMgrProtocol;
+}
+
+/** Record an installed ACPI table.
+
+  Does nothing if no recording is in progress.
+
+  @param [in]  AcpiTable  Pointer to the ACPI table.
+**/
+VOID
+EFIAPI
+RecordCachedAcpiTable (
+  IN CONST EFI_ACPI_DESCRIPTION_HEADER  *CONST  AcpiTable
+  )
+{
+  UINTN  Size;
+
+  if (!mRecording || mRecordingDiscarded) {
+    return;
+  }
+
+  Size = ALIGN_VALUE (AcpiTable->Length, 8);
+  if (!GrowRecordingBuffer ((VOID **)&mTables, &mTablesMax, mTablesSize + Size)) {
+    mRecordingDiscarded = TRUE;
+    return;
+  }
+
+  ZeroMem (mTables + mTablesSize, Size);
+  CopyMem (mTables + mTablesSize, AcpiTable, AcpiTable->Length);
+  mTablesSize += Size;
+  mTableCount++;
+}
+
+/** Store the recorded tables.
+
+  The data variables are written first and the header last, so that
+  an interrupted update leaves no valid cache behind.
+
+  @retval EFI_SUCCESS           Success.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+  @retval Others                Writing a variable failed.
+**/
+STATIC
+EFI_STATUS
+WriteAcpiTableCache (
+  VOID
+  )
+{
+  EFI_STATUS          Status;
+  TABLE_CACHE_HEADER  Header;
+  UINT8               *Data;
+  UINTN               ObjectsSize;
+  UINTN               Offset;
+  UINTN               Index;
+  UINTN               ChunkSize;
+  CHAR16              Name[TABLE_CACHE_VARIABLE_NAME_LENGTH];
+
+  ObjectsSize = mObjectCount * sizeof (TABLE_CACHE_OBJECT);
+
+  ZeroMem (&Header, sizeof (Header));
+  Header.Signature        = TABLE_CACHE_SIGNATURE;
+  Header.Version          = TABLE_CACHE_VERSION;
+  Header.FirmwareRevision = gST->FirmwareRevision;
+  Header.ObjectCount      = (UINT32)mObjectCount;
+  Header.TableCount       = (UINT32)mTableCount;
+  Header.DataSize         = (UINT32)(ObjectsSize + mTablesSize);
+  Header.ChunkSize        = PcdGet32 (PcdMaxVariableSize) -
+                            TABLE_CACHE_VARIABLE_OVERHEAD;
+
+  Data = AllocatePool (Header.DataSize);
+  if (Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (Data, mObjects, ObjectsSize);
+  CopyMem (Data + ObjectsSize, mTables, mTablesSize);
+  Header.DataCrc = CalculateCrc32 (Data, Header.DataSize);
+
+  InvalidateAcpiTableCache ();
+
+  Status = EFI_SUCCESS;
+  for (Offset = 0, Index = 0; Offset < Header.DataSize; Index++) {
+    ChunkSize = MIN (Header.ChunkSize, Header.DataSize - Offset);
+    GetCacheVariableName (Index, Name);
+    Status = gRT->SetVariable (
+                    Name,
+                    &gEdkiiDynamicTableCacheVariableGuid,
+                    TABLE_CACHE_VARIABLE_ATTRIBUTES,
+                    ChunkSize,
+                    Data + Offset
+                    );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Offset += ChunkSize;
+  }
+
+  FreePool (Data);
+
+  if (!EFI_ERROR (Status)) {
+    // Delete the data variables left over by a larger cache.
+    do {
+      GetCacheVariableName (Index++, Name);
+    } while (!EFI_ERROR (
+                gRT->SetVariable (
+                       Name,
+                       &gEdkiiDynamicTableCacheVariableGuid,
+                       0,
+                       0,
+                       NULL
+                       )
+                ));
+
+    Status = gRT->SetVariable (
+                    TABLE_CACHE_VARIABLE_NAME,
+                    &gEdkiiDynamicTableCacheVariableGuid,
+                    TABLE_CACHE_VARIABLE_ATTRIBUTES,
+                    sizeof (Header),
+                    &Header
+                    );
+  }
+
+  return Status;
+}
+
+/** Stop recording and store the recorded tables for the next boot.
+
+  @param [in]  Success  TRUE if all the tables were generated and
+                        installed, FALSE to discard the recording.
+**/
+VOID
+EFIAPI
+StopAcpiTableCacheRecording (
+  IN BOOLEAN  Success
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!mRecording) {
+    return;
+  }
+
+  mRecording = FALSE;
+
+  if (Success && !mRecordingDiscarded && (mTableCount != 0)) {
+    Status = WriteAcpiTableCache ();
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_WARN,
+        "WARNING: Failed to store the ACPI table cache. Status = %r\n",
+        Status
+        ));
+    }
+  }
+
+  if (mObjects != NULL) {
+    FreePool (mObjects);
+    mObjects = NULL;
+  }
+
+  if (mTables != NULL) {
+    FreePool (mTables);
+    mTables = NULL;
+  }
+
+  mObjectMax = 0;
+  mTablesMax = 0;
+}
@@ -0,0 +1,76 @@
+/** @file
+  Dynamic Table Manager ACPI table cache.
+
+  Copyright (c) 2017 - 2019, ARM Limited. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  @par Glossary:
+    - Cm or CM   - Configuration Manager
+**/
+
+#ifndef DYNAMIC_TABLE_CACHE_H_
+#define DYNAMIC_TABLE_CACHE_H_
+
+/** Install the ACPI tables cached by a previous boot.
+
+  The cache is only used if every Configuration Manager object the
+  cached tables were generated from is still returned unchanged, and
+  the firmware revision is the same.
+
+  @param [in]  CfgMgrProtocol     Pointer to the Configuration Manager
+                                  Protocol Interface.
+  @param [in]  AcpiTableProtocol  Pointer to the AcpiTable protocol.
+
+  @retval EFI_SUCCESS     The cached tables are installed.
+  @retval EFI_NOT_FOUND   There is no valid cache, the tables must
+                          be generated. Nothing was installed.
+  @retval Others          Installing a cached table failed.
+**/
+EFI_STATUS
+EFIAPI
+InstallCachedAcpiTables (
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol,
+  IN       EFI_ACPI_TABLE_PROTOCOL                       *AcpiTableProtocol
+  );
+
+/** Start recording the ACPI tables to cache.
+
+  The returned Configuration Manager Protocol forwards all calls to
+  CfgMgrProtocol and records the objects returned to the generators.
+
+  @param [in]  CfgMgrProtocol     Pointer to the Configuration Manager
+                                  Protocol Interface.
+
+  @return The Configuration Manager Protocol the generators must use.
+**/
+CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL *
+EFIAPI
+StartAcpiTableCacheRecording (
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol
+  );
+
+/** Record an installed ACPI table.
+
+  Does nothing if no recording is in progress.
+
+  @param [in]  AcpiTable  Pointer to the ACPI table.
+**/
+VOID
+EFIAPI
+RecordCachedAcpiTable (
+  IN CONST EFI_ACPI_DESCRIPTION_HEADER  *CONST  AcpiTable
+  );
+
+/** Stop recording and store the recorded tables for the next boot.
+
+  @param [in]  Success  TRUE if all the tables were generated and
+                        installed, FALSE to discard the recording.
+**/
+VOID
+EFIAPI
+StopAcpiTableCacheRecording (
+  IN BOOLEAN  Success
+  );
+
+#endif // DYNAMIC_TABLE_CACHE_H_
@@ -10,7 +10,9 @@
 #include <Library/DebugLib.h>
 #include <Library/PcdLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
 #include <Protocol/AcpiTable.h>
+#include <Protocol/VariableWrite.h>
 
 // Module specific include files.
 #include <AcpiTableGenerator.h>
@@ -22,6 +24,8 @@
 #include <Protocol/DynamicTableFactoryProtocol.h>
 #include <SmbiosTableGenerator.h>
 
+#include "DynamicTableCache.h"
+
 /** This macro expands to a function that retrieves the ACPI Table
     List from the Configuration Manager.
 */
@@ -31,6 +35,10 @@ GET_OBJECT_LIST (
   CM_STD_OBJ_ACPI_TABLE_INFO
   )
 
+/// The protocols used once the variable write service is available.
+STATIC EDKII_DYNAMIC_TABLE_FACTORY_PROTOCOL  *mTableFactoryProtocol;
+STATIC EDKII_CONFIGURATION_MANAGER_PROTOCOL  *mCfgMgrProtocol;
+
 /** A helper function to build and install a single ACPI table.
 
   This is a helper function that invokes the Table generator interface
@@ -112,6 +120,10 @@ BuildAndInstallSingleAcpiTable (
     goto exit_handler;
   }
 
+  if (FeaturePcdGet (PcdDynamicTablesCacheEnable)) {
+    RecordCachedAcpiTable (AcpiTable);
+  }
+
   DEBUG ((
     DEBUG_INFO,
     "INFO: ACPI Table installed. Status = %r\n",
@@ -231,6 +243,10 @@ BuildAndInstallMultipleAcpiTable (
       goto exit_handler;
     }
 
+    if (FeaturePcdGet (PcdDynamicTablesCacheEnable)) {
+      RecordCachedAcpiTable (AcpiTable[Index]);
+    }
+
     DEBUG ((
       DEBUG_INFO,
       "INFO: ACPI Table installed. Status = %r\n",
@@ -484,6 +500,11 @@ VerifyMandatoryTablesArePresent (
   ACPI tables from the Configuration Manager, invokes the generators
   and installs them (via BuildAndInstallAcpiTable).
 
+  If PcdDynamicTablesCacheEnable is TRUE, the tables cached by a previous
+  boot are installed instead when the Configuration Manager objects they
+  were generated from are unchanged. Otherwise the generated tables are
+  recorded, and must be stored by StopAcpiTableCacheRecording().
+
   @param [in]  TableFactoryProtocol Pointer to the Table Factory Protocol
                                     interface.
   @param [in]  CfgMgrProtocol       Pointer to the Configuration Manager
@@ -497,7 +518,7 @@ EFI_STATUS
 EFIAPI
 ProcessAcpiTables (
   IN CONST EDKII_DYNAMIC_TABLE_FACTORY_PROTOCOL  *CONST  TableFactoryProtocol,
-  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL          *CfgMgrProtocol
   )
 {
   EFI_STATUS                  Status;
@@ -524,6 +545,16 @@ ProcessAcpiTables (
     return Status;
   }
 
+  if (FeaturePcdGet (PcdDynamicTablesCacheEnable)) {
+    Status = InstallCachedAcpiTables (CfgMgrProtocol, AcpiTableProtocol);
+    if (Status != EFI_NOT_FOUND) {
+      return Status;
+    }
+
+    // Record the objects the generators use and the generated tables.
+    CfgMgrProtocol = StartAcpiTableCacheRecording (CfgMgrProtocol);
+  }
+
   Status = GetEStdObjAcpiTableList (
              CfgMgrProtocol,
              CM_NULL_TOKEN,
@@ -645,6 +676,72 @@ ProcessAcpiTables (
   return Status;
 }
 
+/** Generate and install the tables.
+
+  @param [in]  TableFactoryProtocol Pointer to the Table Factory Protocol
+                                    interface.
+  @param [in]  CfgMgrProtocol       Pointer to the Configuration Manager
+                                    Protocol Interface.
+
+  @retval EFI_SUCCESS   Success.
+  @retval EFI_NOT_FOUND If a mandatory table or a generator is not found.
+**/
+STATIC
+EFI_STATUS
+ProcessDynamicTables (
+  IN CONST EDKII_DYNAMIC_TABLE_FACTORY_PROTOCOL  *CONST  TableFactoryProtocol,
+  IN CONST EDKII_CONFIGURATION_MANAGER_PROTOCOL  *CONST  CfgMgrProtocol
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = ProcessAcpiTables (TableFactoryProtocol, CfgMgrProtocol);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "ERROR: ACPI Table processing failure. Status = %r\n",
+      Status
+      ));
+  }
+
+  if (FeaturePcdGet (PcdDynamicTablesCacheEnable)) {
+    StopAcpiTableCacheRecording (!EFI_ERROR (Status));
+  }
+
+  return Status;
+}
+
+/** Process the tables once the variable write service is available,
+    so that the table cache can be read and updated.
+
+  @param [in]  Event    The Event that is being processed.
+  @param [in]  Context  The Event Context.
+**/
+STATIC
+VOID
+EFIAPI
+OnVariableWriteReady (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Interface;
+
+  Status = gBS->LocateProtocol (
+                  &gEfiVariableWriteArchProtocolGuid,
+                  NULL,
+                  &Interface
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+
+  ProcessDynamicTables (mTableFactoryProtocol, mCfgMgrProtocol);
+}
+
 /** Entrypoint of Dynamic Table Manager Dxe.
 
   The Dynamic Table Manager uses the Configuration Manager Protocol
@@ -675,6 +772,8 @@ DynamicTableManagerDxeInitialize (
   EDKII_CONFIGURATION_MANAGER_PROTOCOL   *CfgMgrProtocol;
   CM_STD_OBJ_CONFIGURATION_MANAGER_INFO  *CfgMfrInfo;
   EDKII_DYNAMIC_TABLE_FACTORY_PROTOCOL   *TableFactoryProtocol;
+  VOID                                   *Interface;
+  VOID                                   *Registration;
 
   // Locate the Dynamic Table Factory
   Status = gBS->LocateProtocol (
@@ -729,14 +828,25 @@ DynamicTableManagerDxeInitialize (
     CfgMfrInfo->OemId[5]
     ));
 
-  Status = ProcessAcpiTables (TableFactoryProtocol, CfgMgrProtocol);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "ERROR: ACPI Table processing failure. Status = %r\n",
-      Status
-      ));
+  if (FeaturePcdGet (PcdDynamicTablesCacheEnable)) {
+    Status = gBS->LocateProtocol (
+                    &gEfiVariableWriteArchProtocolGuid,
+                    NULL,
+                    &Interface
+                    );
+    if (EFI_ERROR (Status)) {
+      mTableFactoryProtocol = TableFactoryProtocol;
+      mCfgMgrProtocol       = CfgMgrProtocol;
+      EfiCreateProtocolNotifyEvent (
+        &gEfiVariableWriteArchProtocolGuid,
+        TPL_CALLBACK,
+        OnVariableWriteReady,
+        NULL,
+        &Registration
+        );
+      return EFI_SUCCESS;
+    }
   }
 
-  return Status;
+  return ProcessDynamicTables (TableFactoryProtocol, CfgMgrProtocol);
 }
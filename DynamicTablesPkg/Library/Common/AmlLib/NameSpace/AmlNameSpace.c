@@ -1052,6 +1052,64 @@ exit_handler:
 
 #endif // MDEPKG_NDEBUG
 
+/** Check whether the path of a namespace node can match a searched path.
+
+  The raw AML absolute path of a node ends with the last NameSeg of the
+  node's name, if its name has NameSegs. Comparing this NameSeg with the
+  last NameSeg of the searched path is much cheaper than building the
+  absolute path of the node, which requires to walk up the tree.
+
+  @param  [in]  Node                Namespace node.
+  @param  [in]  SearchPathBStream   Backward stream holding the raw AML
+                                    absolute searched path.
+
+  @retval TRUE   The path of Node may match the searched path.
+  @retval FALSE  The path of Node cannot match the searched path.
+**/
+STATIC
+BOOLEAN
+EFIAPI
+AmlIsNodePathCandidate (
+  IN  CONST AML_OBJECT_NODE  *Node,
+  IN  CONST AML_STREAM       *SearchPathBStream
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *NodeName;
+  UINT32      Root;
+  UINT32      ParentPrefix;
+  UINT32      SegCount;
+  UINT32      NameStringSize;
+  UINT32      SearchPathSize;
+
+  NodeName = AmlNodeGetName (Node);
+  if (NodeName == NULL) {
+    // The path cannot be predicted, build it.
+    return TRUE;
+  }
+
+  Status = AmlParseNameStringInfo (NodeName, &Root, &ParentPrefix, &SegCount);
+  if (EFI_ERROR (Status) || (SegCount == 0)) {
+    // E.g. Scope (\): the path ends with the NameSeg of an ancestor.
+    return TRUE;
+  }
+
+  NameStringSize = AmlComputeNameStringSize (Root, ParentPrefix, SegCount);
+  SearchPathSize = AmlStreamGetIndex (SearchPathBStream);
+  if ((NameStringSize < AML_NAME_SEG_SIZE) ||
+      (SearchPathSize < AML_NAME_SEG_SIZE))
+  {
+    return TRUE;
+  }
+
+  return CompareMem (
+           NodeName + NameStringSize - AML_NAME_SEG_SIZE,
+           AmlStreamGetCurrPos (SearchPathBStream) + SearchPathSize -
+           AML_NAME_SEG_SIZE,
+           AML_NAME_SEG_SIZE
+           ) == 0;
+}
+
 /** Callback function to find the node corresponding to an absolute pathname.
 
   For each namespace node, build its raw AML absolute path. Then compare this
@@ -1142,6 +1200,15 @@ AmlEnumeratePathCallback (
     goto exit_handler;
   }
 
+  // Only build the path of the nodes which can match.
+  if (!AmlIsNodePathCandidate (
+         (CONST AML_OBJECT_NODE *)Node,
+         SearchPathBStream
+         ))
+  {
+    goto exit_handler;
+  }
+
   // Get the raw AML absolute pathname of the current node.
   Status1 = AmlGetRawNameSpacePath (Node, 0, CurrNodePathBStream);
   if (EFI_ERROR (Status1)) {
@@ -158,6 +158,11 @@ error_handler:
   The content of BufferSize is always updated to the size needed to
   serialize the definition block.
 
+  The size of the definition block is read from the Length field of the
+  SDT header, which is kept up to date when the tree is modified. The tree
+  is serialized in a single pass, and the number of bytes written is checked
+  against this size.
+
   @param  [in]      RootNode    Pointer to a root node.
   @param  [in]      Buffer      Buffer to write the DSDT/SSDT table to.
                                 If Buffer is NULL, the size needed to
@@ -190,29 +195,16 @@ AmlSerializeTree (
     return EFI_INVALID_PARAMETER;
   }
 
-  // Compute the total size of the AML blob.
-  Status = AmlComputeSize (
-             (CONST AML_NODE_HEADER *)RootNode,
-             &TableSize
-             );
-  if (EFI_ERROR (Status)) {
-    ASSERT (0);
-    return Status;
-  }
-
-  // Add the size of the ACPI header.
-  TableSize += (UINT32)sizeof (EFI_ACPI_DESCRIPTION_HEADER);
-
-  // Check the size against the SDT header.
   // The Length field in the SDT Header is updated if the tree has
   // been modified.
-  if (TableSize != RootNode->SdtHeader->Length) {
+  TableSize = RootNode->SdtHeader->Length;
+  if (TableSize < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) {
     ASSERT (0);
     return EFI_INVALID_PARAMETER;
   }
 
   // Buffer is not big enough, or NULL.
-  if ((TableSize < *BufferSize) || (Buffer == NULL)) {
+  if ((*BufferSize < TableSize) || (Buffer == NULL)) {
     *BufferSize = TableSize;
     return EFI_SUCCESS;
   }
@@ -252,6 +244,13 @@ AmlSerializeTree (
     return Status;
   }
 
+  // The tree must have filled the whole table, as advertised by the
+  // SDT header.
+  if (AmlStreamGetIndex (&FStream) != TableSize) {
+    ASSERT (0);
+    return EFI_INVALID_PARAMETER;
+  }
+
   // Update the checksum.
   return AcpiPlatformChecksum ((EFI_ACPI_DESCRIPTION_HEADER *)Buffer);
 }
@@ -293,15 +292,7 @@ AmlSerializeDefinitionBlock (
   TableSize   = 0;
 
   // Get the size of the SSDT table.
-  Status = AmlSerializeTree (
-             RootNode,
-             TableBuffer,
-             &TableSize
-             );
-  if (EFI_ERROR (Status)) {
-    ASSERT (0);
-    return Status;
-  }
+  TableSize = RootNode->SdtHeader->Length;
 
   TableBuffer = (UINT8 *)AllocateZeroPool (TableSize);
   if (TableBuffer == NULL) {
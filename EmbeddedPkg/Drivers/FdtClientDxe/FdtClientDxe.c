@@ -12,6 +12,7 @@
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <libfdt.h>
 
 #include <Guid/Fdt.h>
@@ -20,7 +21,29 @@
 
 #include <Protocol/FdtClient.h>
 
-STATIC VOID  *mDeviceTreeBase;
+//
+// The node index maps the compatible strings of the enabled nodes and the
+// phandles of all the nodes to node offsets, so lookups do not walk the whole
+// tree. Updating the tree may move nodes and properties, so the index is
+// dropped on updates and rebuilt by the next lookup.
+//
+typedef struct {
+  CONST CHAR8    *Compatible;
+  INT32          Node;
+} FDT_COMPATIBLE_INDEX_ENTRY;
+
+typedef struct {
+  UINT32    Phandle;
+  INT32     Node;
+} FDT_PHANDLE_INDEX_ENTRY;
+
+STATIC VOID                        *mDeviceTreeBase;
+
+STATIC BOOLEAN                     mNodeIndexValid;
+STATIC FDT_COMPATIBLE_INDEX_ENTRY  *mCompatibleIndex;
+STATIC UINTN                       mCompatibleIndexCount;
+STATIC FDT_PHANDLE_INDEX_ENTRY     *mPhandleIndex;
+STATIC UINTN                       mPhandleIndexCount;
 
 STATIC
 EFI_STATUS
@@ -66,6 +89,7 @@ SetNodeProperty (
   ASSERT (mDeviceTreeBase != NULL);
 
   Ret = fdt_setprop (mDeviceTreeBase, Node, PropertyName, Prop, PropSize);
+  mNodeIndexValid = FALSE;
   if (Ret != 0) {
     return EFI_DEVICE_ERROR;
   }
@@ -103,6 +127,210 @@ IsNodeEnabled (
   return FALSE;
 }
 
+STATIC
+INTN
+EFIAPI
+CompareCompatibleIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST FDT_COMPATIBLE_INDEX_ENTRY  *Entry1;
+  CONST FDT_COMPATIBLE_INDEX_ENTRY  *Entry2;
+  INTN                              Result;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+
+  Result = AsciiStrCmp (Entry1->Compatible, Entry2->Compatible);
+  if (Result != 0) {
+    return Result;
+  }
+
+  return (INTN)Entry1->Node - (INTN)Entry2->Node;
+}
+
+STATIC
+INTN
+EFIAPI
+ComparePhandleIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST FDT_PHANDLE_INDEX_ENTRY  *Entry1;
+  CONST FDT_PHANDLE_INDEX_ENTRY  *Entry2;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+
+  if (Entry1->Phandle != Entry2->Phandle) {
+    return (Entry1->Phandle < Entry2->Phandle) ? -1 : 1;
+  }
+
+  return (INTN)Entry1->Node - (INTN)Entry2->Node;
+}
+
+STATIC
+VOID
+FreeNodeIndex (
+  VOID
+  )
+{
+  if (mCompatibleIndex != NULL) {
+    FreePool (mCompatibleIndex);
+    mCompatibleIndex = NULL;
+  }
+
+  if (mPhandleIndex != NULL) {
+    FreePool (mPhandleIndex);
+    mPhandleIndex = NULL;
+  }
+
+  mCompatibleIndexCount = 0;
+  mPhandleIndexCount    = 0;
+  mNodeIndexValid       = FALSE;
+}
+
+/**
+  Walk the device tree, and either count or record the entries of the node
+  index.
+
+  @param[out] CompatibleIndex  The compatible index to fill in, or NULL to
+                               count the entries only.
+  @param[out] CompatibleCount  The number of compatible index entries.
+  @param[out] PhandleIndex     The phandle index to fill in, or NULL to count
+                               the entries only.
+  @param[out] PhandleCount     The number of phandle index entries.
+
+**/
+STATIC
+VOID
+CollectNodeIndex (
+  OUT FDT_COMPATIBLE_INDEX_ENTRY  *CompatibleIndex OPTIONAL,
+  OUT UINTN                       *CompatibleCount,
+  OUT FDT_PHANDLE_INDEX_ENTRY     *PhandleIndex OPTIONAL,
+  OUT UINTN                       *PhandleCount
+  )
+{
+  INT32        Node;
+  UINT32       Phandle;
+  CONST CHAR8  *Type, *Compatible;
+  INT32        Len;
+
+  *CompatibleCount = 0;
+  *PhandleCount    = 0;
+
+  for (Node = 0; Node >= 0; Node = fdt_next_node (mDeviceTreeBase, Node, NULL)) {
+    Phandle = fdt_get_phandle (mDeviceTreeBase, Node);
+    if ((Phandle != 0) && (Phandle != (UINT32)-1)) {
+      if (PhandleIndex != NULL) {
+        PhandleIndex[*PhandleCount].Phandle = Phandle;
+        PhandleIndex[*PhandleCount].Node    = Node;
+      }
+
+      (*PhandleCount)++;
+    }
+
+    //
+    // The compatible lookups never return the root node
+    //
+    if ((Node == 0) || !IsNodeEnabled (Node)) {
+      continue;
+    }
+
+    Type = fdt_getprop (mDeviceTreeBase, Node, "compatible", &Len);
+    if (Type == NULL) {
+      continue;
+    }
+
+    for (Compatible = Type; Compatible < Type + Len && *Compatible;
+         Compatible += 1 + AsciiStrLen (Compatible))
+    {
+      if (CompatibleIndex != NULL) {
+        CompatibleIndex[*CompatibleCount].Compatible = Compatible;
+        CompatibleIndex[*CompatibleCount].Node       = Node;
+      }
+
+      (*CompatibleCount)++;
+    }
+  }
+}
+
+/**
+  Make sure the node index matches the current device tree.
+
+  @retval TRUE   The node index is valid.
+  @retval FALSE  The node index could not be built, the lookups must walk
+                 the device tree.
+
+**/
+STATIC
+BOOLEAN
+UpdateNodeIndex (
+  VOID
+  )
+{
+  UINTN                       CompatibleCount;
+  UINTN                       PhandleCount;
+  FDT_COMPATIBLE_INDEX_ENTRY  CompatibleEntry;
+  FDT_PHANDLE_INDEX_ENTRY     PhandleEntry;
+
+  if (mNodeIndexValid) {
+    return TRUE;
+  }
+
+  FreeNodeIndex ();
+
+  CollectNodeIndex (NULL, &CompatibleCount, NULL, &PhandleCount);
+
+  mCompatibleIndex = AllocatePool (
+                       MAX (CompatibleCount, 1) * sizeof *mCompatibleIndex
+                       );
+  mPhandleIndex = AllocatePool (
+                    MAX (PhandleCount, 1) * sizeof *mPhandleIndex
+                    );
+  if ((mCompatibleIndex == NULL) || (mPhandleIndex == NULL)) {
+    FreeNodeIndex ();
+    return FALSE;
+  }
+
+  CollectNodeIndex (
+    mCompatibleIndex,
+    &mCompatibleIndexCount,
+    mPhandleIndex,
+    &mPhandleIndexCount
+    );
+  ASSERT (mCompatibleIndexCount == CompatibleCount);
+  ASSERT (mPhandleIndexCount == PhandleCount);
+
+  QuickSort (
+    mCompatibleIndex,
+    mCompatibleIndexCount,
+    sizeof *mCompatibleIndex,
+    CompareCompatibleIndexEntry,
+    &CompatibleEntry
+    );
+  QuickSort (
+    mPhandleIndex,
+    mPhandleIndexCount,
+    sizeof *mPhandleIndex,
+    ComparePhandleIndexEntry,
+    &PhandleEntry
+    );
+
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "%a: %Lu compatible strings, %Lu phandles\n",
+    __FUNCTION__,
+    (UINT64)mCompatibleIndexCount,
+    (UINT64)mPhandleIndexCount
+    ));
+
+  mNodeIndexValid = TRUE;
+  return TRUE;
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -116,10 +344,38 @@ FindNextCompatibleNode (
   INT32        Prev, Next;
   CONST CHAR8  *Type, *Compatible;
   INT32        Len;
+  UINTN        Low, High, Middle;
+  INTN         Result;
 
   ASSERT (mDeviceTreeBase != NULL);
   ASSERT (Node != NULL);
 
+  if (UpdateNodeIndex ()) {
+    //
+    // Find the first entry for CompatibleString following PrevNode
+    //
+    Low  = 0;
+    High = mCompatibleIndexCount;
+    while (Low < High) {
+      Middle = Low + (High - Low) / 2;
+      Result = AsciiStrCmp (mCompatibleIndex[Middle].Compatible, CompatibleString);
+      if ((Result < 0) || ((Result == 0) && (mCompatibleIndex[Middle].Node <= PrevNode))) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+
+    if ((Low < mCompatibleIndexCount) &&
+        (AsciiStrCmp (mCompatibleIndex[Low].Compatible, CompatibleString) == 0))
+    {
+      *Node = mCompatibleIndex[Low].Node;
+      return EFI_SUCCESS;
+    }
+
+    return EFI_NOT_FOUND;
+  }
+
   for (Prev = PrevNode; ; Prev = Next) {
     Next = fdt_next_node (mDeviceTreeBase, Prev, NULL);
     if (Next < 0) {
@@ -342,7 +598,8 @@ GetOrInsertChosenNode (
 
   NewNode = fdt_path_offset (mDeviceTreeBase, "/chosen");
   if (NewNode < 0) {
-    NewNode = fdt_add_subnode (mDeviceTreeBase, 0, "/chosen");
+    NewNode         = fdt_add_subnode (mDeviceTreeBase, 0, "/chosen");
+    mNodeIndexValid = FALSE;
   }
 
   if (NewNode < 0) {
@@ -354,6 +611,54 @@ GetOrInsertChosenNode (
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+EFIAPI
+FindNodeByPhandle (
+  IN  FDT_CLIENT_PROTOCOL  *This,
+  IN  UINT32               Phandle,
+  OUT INT32                *Node
+  )
+{
+  UINTN  Low, High, Middle;
+  INT32  NewNode;
+
+  ASSERT (mDeviceTreeBase != NULL);
+  ASSERT (Node != NULL);
+
+  if ((Phandle == 0) || (Phandle == (UINT32)-1)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (UpdateNodeIndex ()) {
+    Low  = 0;
+    High = mPhandleIndexCount;
+    while (Low < High) {
+      Middle = Low + (High - Low) / 2;
+      if (mPhandleIndex[Middle].Phandle < Phandle) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+
+    if ((Low < mPhandleIndexCount) && (mPhandleIndex[Low].Phandle == Phandle)) {
+      *Node = mPhandleIndex[Low].Node;
+      return EFI_SUCCESS;
+    }
+
+    return EFI_NOT_FOUND;
+  }
+
+  NewNode = fdt_node_offset_by_phandle (mDeviceTreeBase, Phandle);
+  if (NewNode < 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Node = NewNode;
+  return EFI_SUCCESS;
+}
+
 STATIC FDT_CLIENT_PROTOCOL  mFdtClientProtocol = {
   GetNodeProperty,
   SetNodeProperty,
@@ -364,6 +669,7 @@ STATIC FDT_CLIENT_PROTOCOL  mFdtClientProtocol = {
   FindMemoryNodeReg,
   FindNextMemoryNodeReg,
   GetOrInsertChosenNode,
+  FindNodeByPhandle,
 };
 
 STATIC
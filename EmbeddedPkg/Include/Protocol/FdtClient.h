@@ -109,6 +109,25 @@ EFI_STATUS
   OUT INT32                   *Node
   );
 
+/**
+  Find the node with a given phandle.
+
+  @param[in]  This        The FDT_CLIENT_PROTOCOL instance.
+  @param[in]  Phandle     The phandle of the node, in CPU byte order.
+  @param[out] Node        The offset of the node.
+
+  @retval EFI_SUCCESS     The node was found.
+  @retval EFI_NOT_FOUND   No node has this phandle.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FDT_CLIENT_FIND_NODE_BY_PHANDLE)(
+  IN  FDT_CLIENT_PROTOCOL     *This,
+  IN  UINT32                  Phandle,
+  OUT INT32                   *Node
+  );
+
 struct _FDT_CLIENT_PROTOCOL {
   FDT_CLIENT_GET_NODE_PROPERTY                GetNodeProperty;
   FDT_CLIENT_SET_NODE_PROPERTY                SetNodeProperty;
@@ -122,6 +141,8 @@ struct _FDT_CLIENT_PROTOCOL {
   FDT_CLIENT_FIND_NEXT_MEMORY_NODE_REG        FindNextMemoryNodeReg;
 
   FDT_CLIENT_GET_OR_INSERT_CHOSEN_NODE        GetOrInsertChosenNode;
+
+  FDT_CLIENT_FIND_NODE_BY_PHANDLE             FindNodeByPhandle;
 };
 
 extern EFI_GUID  gFdtClientProtocolGuid;
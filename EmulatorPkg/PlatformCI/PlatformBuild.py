@@ -7,6 +7,7 @@
 import os
 import logging
 import io
+import time
 
 from edk2toolext.environment import shell_environment
 from edk2toolext.environment.uefi_build import UefiBuilder
@@ -240,7 +241,30 @@ class PlatformBuilder(UefiBuilder, BuildSettingsManager):
         else:
             logging.critical("Unsupported Host")
             return -1
-        return RunCmd(cmd, "", workingdir=OutputPath)
+
+        times = []
+        for run in range(int(self.env.GetValue("EMULATOR_BOOT_RUNS") or "1")):
+            start = time.perf_counter()
+            ret = RunCmd(cmd, "", workingdir=OutputPath)
+            if ret != 0:
+                return ret
+
+            times.append((time.perf_counter() - start) * 1000)
+
+        return self.CheckBootTime(times)
+
+    def CheckBootTime(self, times):
+        ''' Log the boot times and compare their median with the EMULATOR_BOOT_BUDGET_MS budget '''
+        times = sorted(times)
+        median = (times[(len(times) - 1) // 2] + times[len(times) // 2]) / 2
+        logging.info(f"boot time of {len(times)} run(s): min {times[0]:.0f} ms, median {median:.0f} ms, max {times[-1]:.0f} ms")
+
+        budget = self.env.GetValue("EMULATOR_BOOT_BUDGET_MS")
+        if budget and median > float(budget):
+            logging.error(f"median boot time {median:.0f} ms exceeds the budget of {budget} ms")
+            return 1
+
+        return 0
 
     def ConfigureLinuxDLinkPath(self):
         '''
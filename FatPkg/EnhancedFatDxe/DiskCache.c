@@ -81,48 +81,62 @@ FatFlushDataCacheRange (
 
 /**
 
-  Exchange the cache page with the image on the disk
+  Exchange a run of cache pages with the image on the disk.
+
+  The run starts at CacheTag and covers PageCount consecutive cache groups that
+  hold consecutive pages, so the whole run is moved with a single disk access.
+  Every page of the run except the last one must be a complete page.
 
   @param  Volume                - FAT file system volume.
   @param  DataType              - Indicate the cache type.
-  @param  IoMode                - Indicate whether to load this page from disk or store this page to disk.
-  @param  CacheTag              - The Cache Tag for the current cache page.
+  @param  IoMode                - Indicate whether to load these pages from disk or store these pages to disk.
+  @param  CacheTag              - The Cache Tag for the first cache page of the run.
+  @param  PageCount             - The number of cache pages in the run.
   @param  Task                    point to task instance.
 
-  @retval EFI_SUCCESS           - Cache page exchanged successfully.
-  @return Others                - An error occurred when exchanging cache page.
+  @retval EFI_SUCCESS           - Cache pages exchanged successfully.
+  @return Others                - An error occurred when exchanging cache pages.
 
 **/
 STATIC
 EFI_STATUS
-FatExchangeCachePage (
+FatExchangeCachePages (
   IN FAT_VOLUME       *Volume,
   IN CACHE_DATA_TYPE  DataType,
   IN IO_MODE          IoMode,
   IN CACHE_TAG        *CacheTag,
+  IN UINTN            PageCount,
   IN FAT_TASK         *Task
   )
 {
   EFI_STATUS  Status;
   UINTN       GroupNo;
   UINTN       PageNo;
+  UINTN       PageSize;
   UINTN       WriteCount;
   UINTN       RealSize;
+  UINTN       Index;
   UINT64      EntryPos;
   UINT64      MaxSize;
   DISK_CACHE  *DiskCache;
   VOID        *PageAddress;
   UINT8       PageAlignment;
 
+  ASSERT (PageCount > 0);
+
   DiskCache     = &Volume->DiskCache[DataType];
   PageNo        = CacheTag->PageNo;
   GroupNo       = PageNo & DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
   PageAddress   = DiskCache->CacheBase + (GroupNo << PageAlignment);
   EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
-  RealSize      = CacheTag->RealSize;
+  RealSize      = ((PageCount - 1) << PageAlignment) + CacheTag[PageCount - 1].RealSize;
+
+  ASSERT (GroupNo + PageCount - 1 <= DiskCache->GroupMask);
+
   if (IoMode == ReadDisk) {
-    RealSize = (UINTN)1 << PageAlignment;
+    RealSize = PageCount << PageAlignment;
     MaxSize  = DiskCache->LimitAddress - EntryPos;
     if (MaxSize < RealSize) {
       DEBUG ((DEBUG_INFO, "FatDiskIo: Cache Page OutBound occurred! \n"));
@@ -147,11 +161,107 @@ FatExchangeCachePage (
     EntryPos += Volume->FatSize;
   } while (--WriteCount > 0);
 
-  CacheTag->Dirty    = FALSE;
-  CacheTag->RealSize = RealSize;
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag[Index].Dirty    = FALSE;
+    CacheTag[Index].RealSize = MIN (RealSize, PageSize);
+    RealSize                -= CacheTag[Index].RealSize;
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+
+  Exchange the cache page with the image on the disk
+
+  @param  Volume                - FAT file system volume.
+  @param  DataType              - Indicate the cache type.
+  @param  IoMode                - Indicate whether to load this page from disk or store this page to disk.
+  @param  CacheTag              - The Cache Tag for the current cache page.
+  @param  Task                    point to task instance.
+
+  @retval EFI_SUCCESS           - Cache page exchanged successfully.
+  @return Others                - An error occurred when exchanging cache page.
+
+**/
+STATIC
+EFI_STATUS
+FatExchangeCachePage (
+  IN FAT_VOLUME       *Volume,
+  IN CACHE_DATA_TYPE  DataType,
+  IN IO_MODE          IoMode,
+  IN CACHE_TAG        *CacheTag,
+  IN FAT_TASK         *Task
+  )
+{
+  return FatExchangeCachePages (Volume, DataType, IoMode, CacheTag, 1, Task);
+}
+
+/**
+
+  Compute how many pages to load for a data cache miss on PageNo.
+
+  A miss on the page right after the last loaded run is treated as sequential
+  access and doubles the read-ahead window up to FAT_DATACACHE_READ_AHEAD_MAX_COUNT;
+  any other miss shrinks it back to a single page. The window never wraps around
+  the end of the cache, never goes beyond the end of the volume, and stops at the
+  first group that already holds valid dirty data or the wanted page itself.
+
+  @param  DiskCache             - The data cache.
+  @param  PageNo                - The page that missed in the cache.
+  @param  CacheTag              - The Cache Tag of the group PageNo maps to.
+
+  @return The number of consecutive pages to load, starting at PageNo.
+
+**/
+STATIC
+UINTN
+FatGetReadAheadCount (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  UINTN   Count;
+  UINTN   MaxCount;
+  UINTN   Index;
+  UINT64  EntryPos;
+  UINT64  PageLimit;
+
+  if ((PageNo == DiskCache->NextPageNo) && (DiskCache->ReadAheadCount > 0)) {
+    DiskCache->ReadAheadCount = MIN (DiskCache->ReadAheadCount * 2, FAT_DATACACHE_READ_AHEAD_MAX_COUNT);
+  } else {
+    DiskCache->ReadAheadCount = 1;
+  }
+
+  Count    = DiskCache->ReadAheadCount;
+  MaxCount = DiskCache->GroupMask - (PageNo & DiskCache->GroupMask) + 1;
+  if (Count > MaxCount) {
+    Count = MaxCount;
+  }
+
+  EntryPos  = LShiftU64 (PageNo, DiskCache->PageAlignment);
+  PageLimit = RShiftU64 (
+                DiskCache->LimitAddress - DiskCache->BaseAddress - EntryPos + ((UINTN)1 << DiskCache->PageAlignment) - 1,
+                DiskCache->PageAlignment
+                );
+  if (Count > PageLimit) {
+    Count = (UINTN)PageLimit;
+  }
+
+  for (Index = 1; Index < Count; Index++) {
+    if ((CacheTag[Index].RealSize > 0) &&
+        (CacheTag[Index].Dirty || (CacheTag[Index].PageNo == PageNo + Index)))
+    {
+      break;
+    }
+  }
+
+  Count                 = MAX (Index, 1);
+  DiskCache->NextPageNo = PageNo + Count;
+  return Count;
+}
+
 /**
 
   Get one cache page by specified PageNo.
@@ -176,6 +286,8 @@ FatGetCachePage (
 {
   EFI_STATUS  Status;
   UINTN       OldPageNo;
+  UINTN       PageCount;
+  UINTN       Index;
 
   OldPageNo = CacheTag->PageNo;
   if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
@@ -196,10 +308,24 @@ FatGetCachePage (
   }
 
   //
-  // Load new data from disk;
+  // Load new data from disk; sequential misses in the data cache also load
+  // the following pages in the same disk access.
   //
-  CacheTag->PageNo = PageNo;
-  Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
+  PageCount = 1;
+  if (CacheDataType == CacheData) {
+    PageCount = FatGetReadAheadCount (&Volume->DiskCache[CacheData], PageNo, CacheTag);
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag[Index].PageNo = PageNo + Index;
+  }
+
+  Status = FatExchangeCachePages (Volume, CacheDataType, ReadDisk, CacheTag, PageCount, NULL);
+  if (EFI_ERROR (Status)) {
+    for (Index = 0; Index < PageCount; Index++) {
+      CacheTag[Index].RealSize = 0;
+    }
+  }
 
   return Status;
 }
@@ -260,6 +386,99 @@ FatAccessUnalignedCachePage (
   return Status;
 }
 
+/**
+
+  Read BufferSize bytes of data from the position of Offset into Buffer,
+  without waiting for the disk.
+
+  The pages that are present in the Data cache, dirty or not, are copied from
+  the cache right away. The runs of pages in between are read with non-blocking
+  disk accesses belonging to Task, which complete into Buffer directly. Unlike
+  on the blocking path, the UnderRun and OverRun pages are not loaded into the
+  cache, and dirty cache data is never copied into a part of Buffer that a
+  pending disk read will overwrite later.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset to read from.
+  @param  BufferSize            - Size of Buffer.
+  @param  Buffer                - Buffer receiving the data.
+  @param  Task                    point to task instance.
+
+  @retval EFI_SUCCESS           - The data was copied, or its disk reads were queued.
+  @return Others                - An error occurred when queueing a disk read.
+
+**/
+STATIC
+EFI_STATUS
+FatReadDataNonBlocking (
+  IN     FAT_VOLUME  *Volume,
+  IN     UINT64      Offset,
+  IN     UINTN       BufferSize,
+  OUT    UINT8       *Buffer,
+  IN     FAT_TASK    *Task
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       PageSize;
+  UINTN       PageNo;
+  UINTN       PageOffset;
+  UINTN       GroupNo;
+  UINTN       Length;
+  UINT64      RunOffset;
+  UINTN       RunSize;
+  UINT8       *RunBuffer;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  PageSize  = (UINTN)1 << DiskCache->PageAlignment;
+  RunOffset = Offset;
+  RunSize   = 0;
+  RunBuffer = Buffer;
+
+  while (BufferSize > 0) {
+    PageNo     = (UINTN)RShiftU64 (Offset - DiskCache->BaseAddress, DiskCache->PageAlignment);
+    PageOffset = (UINTN)(Offset - DiskCache->BaseAddress) & (PageSize - 1);
+    Length     = MIN (BufferSize, PageSize - PageOffset);
+    GroupNo    = PageNo & DiskCache->GroupMask;
+    CacheTag   = &DiskCache->CacheTag[GroupNo];
+
+    if ((CacheTag->RealSize >= PageOffset + Length) && (CacheTag->PageNo == PageNo)) {
+      //
+      // Cache hit: queue the disk run collected so far, then take this page
+      // from the cache.
+      //
+      if (RunSize > 0) {
+        Status = FatDiskIo (Volume, ReadDisk, RunOffset, RunSize, RunBuffer, Task);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        RunSize = 0;
+      }
+
+      CopyMem (Buffer, DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + PageOffset, Length);
+    } else {
+      if (RunSize == 0) {
+        RunOffset = Offset;
+        RunBuffer = Buffer;
+      }
+
+      RunSize += Length;
+    }
+
+    Offset     += Length;
+    Buffer     += Length;
+    BufferSize -= Length;
+  }
+
+  if (RunSize > 0) {
+    return FatDiskIo (Volume, ReadDisk, RunOffset, RunSize, RunBuffer, Task);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Read BufferSize bytes from the position of Offset into Buffer,
@@ -275,6 +494,8 @@ FatAccessUnalignedCachePage (
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
      but the Aligned data will be accessed with disk directly.
+     Non-blocking reads of the Data cache are handled by FatReadDataNonBlocking()
+     instead, so that they don't wait for the disk.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -315,6 +536,10 @@ FatAccessCache (
 
   ASSERT (Volume->CacheBuffer != NULL);
 
+  if ((Task != NULL) && (CacheDataType == CacheData) && (IoMode == ReadDisk)) {
+    return FatReadDataNonBlocking (Volume, Offset, BufferSize, Buffer, Task);
+  }
+
   Status        = EFI_SUCCESS;
   DiskCache     = &Volume->DiskCache[CacheDataType];
   EntryPos      = Offset - DiskCache->BaseAddress;
@@ -401,6 +626,7 @@ FatVolumeFlushCache (
   CACHE_DATA_TYPE  CacheDataType;
   UINTN            GroupIndex;
   UINTN            GroupMask;
+  UINTN            PageCount;
   DISK_CACHE       *DiskCache;
   CACHE_TAG        *CacheTag;
 
@@ -415,12 +641,25 @@ FatVolumeFlushCache (
         CacheTag = &DiskCache->CacheTag[GroupIndex];
         if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
           //
-          // Write back all Dirty Data Cache Page to disk
+          // Coalesce the following dirty pages that are contiguous both in the
+          // cache and on the disk, and write the run back with one disk access
           //
-          Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, Task);
+          PageCount = 1;
+          while ((GroupIndex + PageCount <= GroupMask) &&
+                 (CacheTag[PageCount - 1].RealSize == ((UINTN)1 << DiskCache->PageAlignment)) &&
+                 (CacheTag[PageCount].RealSize > 0) &&
+                 CacheTag[PageCount].Dirty &&
+                 (CacheTag[PageCount].PageNo == CacheTag->PageNo + PageCount))
+          {
+            PageCount++;
+          }
+
+          Status = FatExchangeCachePages (Volume, CacheDataType, WriteDisk, CacheTag, PageCount, Task);
           if (EFI_ERROR (Status)) {
             return Status;
           }
+
+          GroupIndex += PageCount - 1;
         }
       }
 
@@ -84,6 +84,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// Maximum number of data cache pages loaded by one read-ahead
+//
+#define FAT_DATACACHE_READ_AHEAD_MAX_COUNT  16
+
 //
 // Used in 8.3 generation algorithm
 //
@@ -105,6 +110,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define FAT_MAX_DIR_CACHE_COUNT  8
 #define FAT_MAX_DIRENTRY_COUNT   0xFFFF
+
+//
+// Largest free cluster bitmap kept in memory, enough for 2^26 clusters
+//
+#define FAT_MAX_FREE_BITMAP_SIZE  0x800000
+
+//
+// Initial number of entries in the extent map of an OFile
+//
+#define FAT_EXTENT_MAP_INITIAL_COUNT  8
 typedef CHAR8 LC_ISO_639_2;
 
 //
@@ -155,6 +170,11 @@ typedef struct {
   BOOLEAN      Dirty;
   UINT8        PageAlignment;
   UINTN        GroupMask;
+  //
+  // Sequential access detection for the read-ahead of the data cache
+  //
+  UINTN        NextPageNo;
+  UINTN        ReadAheadCount;
   CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
 } DISK_CACHE;
 
@@ -228,6 +248,15 @@ typedef struct {
   LIST_ENTRY            Link;
 } FAT_SUBTASK;
 
+//
+// FAT_EXTENT - A run of clusters of a file that are contiguous on the disk
+//
+typedef struct {
+  UINTN    FileCluster;   // Index of the first cluster of the run within the file
+  UINTN    DiskCluster;   // The first cluster of the run on the disk
+  UINTN    Length;        // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -252,6 +281,17 @@ struct _FAT_OFILE {
   UINTN         FileCurrentCluster;
   UINTN         FileLastCluster;
 
+  //
+  // Extent map of the leading part of the cluster chain that has been
+  // walked so far, sorted by FileCluster. ExtentClusters is the number
+  // of file clusters it covers and ExtentLastCluster the last of them.
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         ExtentMaxCount;
+  UINTN         ExtentClusters;
+  UINTN         ExtentLastCluster;
+
   //
   // Dirty is set if there have been any updates to the
   // file
@@ -335,6 +375,10 @@ struct _FAT_VOLUME {
   UINTN                              FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                            FreeInfoValid;  // If free cluster info is valid
   //
+  // Free cluster bitmap, one bit per cluster, set if the cluster is free
+  //
+  UINT32                             *FreeClusterBitmap;
+  //
   // Unpacked Fat BPB info
   //
   UINTN                              NumFats;
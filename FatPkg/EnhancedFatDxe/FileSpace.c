@@ -122,6 +122,157 @@ FatGetFatEntry (
   return Accum;
 }
 
+/**
+
+  Build the in-memory free cluster bitmap of the volume.
+
+  The FAT is scanned once; FAT16 and FAT32 tables are read in blocks rather
+  than one entry at a time. From then on the bitmap is kept in sync by
+  FatSetFatEntry. Nothing is built if the bitmap would be larger than
+  FAT_MAX_FREE_BITMAP_SIZE or if the FAT cannot be read, in which case the
+  callers keep walking the FAT entries.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+STATIC
+VOID
+FatBuildFreeClusterBitmap (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      *Bitmap;
+  UINT32      Buffer[128];
+  UINTN       BitmapSize;
+  UINTN       EntryCount;
+  UINTN       EntrySize;
+  UINTN       Count;
+  UINTN       Index;
+  UINTN       Cluster;
+  UINTN       Value;
+
+  if ((Volume->FreeClusterBitmap != NULL) || Volume->DiskError) {
+    return;
+  }
+
+  EntryCount = Volume->MaxCluster + 2;
+  BitmapSize = ((EntryCount + 31) / 32) * sizeof (UINT32);
+  if (BitmapSize > FAT_MAX_FREE_BITMAP_SIZE) {
+    return;
+  }
+
+  Bitmap = AllocateZeroPool (BitmapSize);
+  if (Bitmap == NULL) {
+    return;
+  }
+
+  if (Volume->FatType == Fat12) {
+    for (Cluster = FAT_MIN_CLUSTER; Cluster < EntryCount; Cluster++) {
+      if (FatGetFatEntry (Volume, Cluster) == FAT_CLUSTER_FREE) {
+        Bitmap[Cluster / 32] |= (UINT32)1 << (Cluster % 32);
+      }
+    }
+  } else {
+    EntrySize = (Volume->FatType == Fat16) ? sizeof (UINT16) : sizeof (UINT32);
+    for (Cluster = 0; Cluster < EntryCount; Cluster += Count) {
+      Count  = MIN (sizeof (Buffer) / EntrySize, EntryCount - Cluster);
+      Status = FatDiskIo (Volume, ReadFat, Volume->FatPos + Cluster * EntrySize, Count * EntrySize, Buffer, NULL);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      for (Index = 0; Index < Count; Index++) {
+        if (Volume->FatType == Fat16) {
+          Value = ((UINT16 *)Buffer)[Index];
+        } else {
+          Value = Buffer[Index] & FAT_CLUSTER_MASK_FAT32;
+        }
+
+        if ((Value == FAT_CLUSTER_FREE) && (Cluster + Index >= FAT_MIN_CLUSTER)) {
+          Bitmap[(Cluster + Index) / 32] |= (UINT32)1 << ((Cluster + Index) % 32);
+        }
+      }
+    }
+  }
+
+  if (Volume->DiskError) {
+    FreePool (Bitmap);
+    return;
+  }
+
+  Volume->FreeClusterBitmap = Bitmap;
+}
+
+/**
+
+  Check whether the cluster is free, using the free cluster bitmap when it is built.
+
+  @param  Volume                - FAT file system volume.
+  @param  Cluster               - The cluster to check.
+
+  @retval TRUE                  - The cluster is free.
+  @retval FALSE                 - The cluster is used or out of range.
+
+**/
+STATIC
+BOOLEAN
+FatIsClusterFree (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Cluster
+  )
+{
+  if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+    return FALSE;
+  }
+
+  if (Volume->FreeClusterBitmap != NULL) {
+    return (BOOLEAN)((Volume->FreeClusterBitmap[Cluster / 32] & ((UINT32)1 << (Cluster % 32))) != 0);
+  }
+
+  return (BOOLEAN)(FatGetFatEntry (Volume, Cluster) == FAT_CLUSTER_FREE);
+}
+
+/**
+
+  Find the first free cluster at or after Start in the free cluster bitmap.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The cluster to start the search from.
+
+  @return The index of the free cluster, or a value above MaxCluster + 1 if none.
+
+**/
+STATIC
+UINTN
+FatFindFreeCluster (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Start
+  )
+{
+  UINTN   Limit;
+  UINTN   Cluster;
+  UINT32  Word;
+
+  ASSERT (Volume->FreeClusterBitmap != NULL);
+
+  Limit   = Volume->MaxCluster + 2;
+  Cluster = MAX (Start, FAT_MIN_CLUSTER);
+  while (Cluster < Limit) {
+    //
+    // Skip 32 used clusters at a time
+    //
+    Word = Volume->FreeClusterBitmap[Cluster / 32] >> (Cluster % 32);
+    if (Word != 0) {
+      return Cluster + (UINTN)LowBitSet32 (Word);
+    }
+
+    Cluster = (Cluster | 31) + 1;
+  }
+
+  return Limit;
+}
+
 /**
 
   Set the FAT entry value of the volume, which is identified with the Index.
@@ -167,6 +318,14 @@ FatSetFatEntry (
     }
   }
 
+  if ((Volume->FreeClusterBitmap != NULL) && (Index <= Volume->MaxCluster + 1)) {
+    if (Value == FAT_CLUSTER_FREE) {
+      Volume->FreeClusterBitmap[Index / 32] |= (UINT32)1 << (Index % 32);
+    } else {
+      Volume->FreeClusterBitmap[Index / 32] &= ~((UINT32)1 << (Index % 32));
+    }
+  }
+
   //
   // Make sure the entry is in memory
   //
@@ -263,7 +422,12 @@ FatFreeClusters (
 
   Allocate a free cluster and return the cluster index.
 
+  When the free cluster bitmap is available, the cluster following
+  PreviousCluster is preferred so that growing files stay contiguous.
+
   @param  Volume                - FAT file system volume.
+  @param  PreviousCluster       - The current last cluster of the chain being grown,
+                                  or FAT_CLUSTER_FREE for a new chain.
 
   @return The index of the free cluster
 
@@ -271,7 +435,8 @@ FatFreeClusters (
 STATIC
 UINTN
 FatAllocateCluster (
-  IN FAT_VOLUME  *Volume
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PreviousCluster
   )
 {
   UINTN  Cluster;
@@ -283,6 +448,24 @@ FatAllocateCluster (
     return (UINTN)FAT_CLUSTER_LAST;
   }
 
+  FatBuildFreeClusterBitmap (Volume);
+  if (Volume->FreeClusterBitmap != NULL) {
+    if ((PreviousCluster != FAT_CLUSTER_FREE) && FatIsClusterFree (Volume, PreviousCluster + 1)) {
+      Cluster = PreviousCluster + 1;
+    } else {
+      Cluster = FatFindFreeCluster (Volume, Volume->FatInfoSector.FreeInfo.NextCluster);
+      if (Cluster > Volume->MaxCluster + 1) {
+        Cluster = FatFindFreeCluster (Volume, FAT_MIN_CLUSTER);
+        if (Cluster > Volume->MaxCluster + 1) {
+          return (UINTN)FAT_CLUSTER_LAST;
+        }
+      }
+    }
+
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)(Cluster + 1);
+    return Cluster;
+  }
+
   for ( ; ;) {
     //
     // If the end of the list, return no available cluster
@@ -341,6 +524,136 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Extend the extent map of the open file until it covers ClusterCount clusters
+  of the file, or the end of the cluster chain is reached.
+
+  Clusters that were appended to the chain after the map was built are picked
+  up by continuing from the last cluster covered by the map.
+
+  @param  OFile                 - The open file.
+  @param  ClusterCount          - The number of leading file clusters the map must cover.
+
+  @retval EFI_SUCCESS           - The map covers ClusterCount clusters or the whole chain.
+  @retval EFI_OUT_OF_RESOURCES  - Can not grow the extent map.
+  @retval EFI_VOLUME_CORRUPTED  - Cluster chain corrupt.
+
+**/
+STATIC
+EFI_STATUS
+FatExtendExtentMap (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterCount
+  )
+{
+  FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       NewMaxCount;
+  UINTN       Cluster;
+
+  Volume = OFile->Volume;
+  if (OFile->ExtentClusters >= ClusterCount) {
+    return EFI_SUCCESS;
+  }
+
+  if (OFile->ExtentClusters == 0) {
+    Cluster = OFile->FileCluster;
+  } else {
+    Cluster = FatGetFatEntry (Volume, OFile->ExtentLastCluster);
+  }
+
+  while (OFile->ExtentClusters < ClusterCount) {
+    if (FAT_END_OF_FAT_CHAIN (Cluster)) {
+      break;
+    }
+
+    if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+      DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatExtendExtentMap: cluster chain corrupt\n"));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Extent = NULL;
+    if (OFile->ExtentCount > 0) {
+      Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    }
+
+    if ((Extent != NULL) && (Extent->DiskCluster + Extent->Length == Cluster)) {
+      Extent->Length += 1;
+    } else {
+      if (OFile->ExtentCount == OFile->ExtentMaxCount) {
+        NewMaxCount = MAX (OFile->ExtentMaxCount * 2, FAT_EXTENT_MAP_INITIAL_COUNT);
+        NewExtents  = ReallocatePool (
+                        OFile->ExtentMaxCount * sizeof (FAT_EXTENT),
+                        NewMaxCount * sizeof (FAT_EXTENT),
+                        OFile->Extents
+                        );
+        if (NewExtents == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+
+        OFile->Extents        = NewExtents;
+        OFile->ExtentMaxCount = NewMaxCount;
+      }
+
+      Extent              = &OFile->Extents[OFile->ExtentCount++];
+      Extent->FileCluster = OFile->ExtentClusters;
+      Extent->DiskCluster = Cluster;
+      Extent->Length      = 1;
+    }
+
+    OFile->ExtentClusters   += 1;
+    OFile->ExtentLastCluster = Cluster;
+    Cluster                  = FatGetFatEntry (Volume, Cluster);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Look up the extent that holds a cluster of the open file.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file.
+
+  @return The extent holding the cluster, or NULL if the map does not cover it.
+
+**/
+STATIC
+FAT_EXTENT *
+FatLookupExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterIndex
+  )
+{
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+  FAT_EXTENT  *Extent;
+
+  if (ClusterIndex >= OFile->ExtentClusters) {
+    return NULL;
+  }
+
+  Low  = 0;
+  High = OFile->ExtentCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Extent = &OFile->Extents[Middle];
+    if (ClusterIndex < Extent->FileCluster) {
+      High = Middle;
+    } else if (ClusterIndex >= Extent->FileCluster + Extent->Length) {
+      Low = Middle + 1;
+    } else {
+      return Extent;
+    }
+  }
+
+  return NULL;
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -367,6 +680,12 @@ FatShrinkEof (
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
 
+  //
+  // The cluster chain is about to be cut, drop the extent map
+  //
+  OFile->ExtentCount    = 0;
+  OFile->ExtentClusters = 0;
+
   //
   // Find the address of the last cluster
   //
@@ -494,7 +813,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateCluster (Volume, LastCluster);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN)FAT_CLUSTER_LAST);
@@ -566,7 +885,11 @@ FatOFilePosition (
   )
 {
   FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  EFI_STATUS  Status;
   UINTN       ClusterSize;
+  UINTN       ClusterIndex;
+  UINTN       RunClusters;
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
@@ -584,6 +907,51 @@ FatOFilePosition (
     OFile->PosDisk = Volume->RootPos + Position;
     Run            = OFile->FileSize - Position;
   } else {
+    //
+    // Resolve the position through the extent map of the file, extending
+    // the map far enough to also cover the contiguous run up to PosLimit
+    //
+    ClusterIndex = Position >> Volume->ClusterAlignment;
+    Status       = FatExtendExtentMap (
+                     OFile,
+                     ClusterIndex + 1 + MIN (PosLimit >> Volume->ClusterAlignment, Volume->MaxCluster)
+                     );
+    if (Status == EFI_VOLUME_CORRUPTED) {
+      return Status;
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Extent = FatLookupExtent (OFile, ClusterIndex);
+      if (Extent == NULL) {
+        DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
+        return EFI_VOLUME_CORRUPTED;
+      }
+
+      StartPos       = ClusterIndex << Volume->ClusterAlignment;
+      Cluster        = Extent->DiskCluster + (ClusterIndex - Extent->FileCluster);
+      OFile->PosDisk = Volume->FirstClusterPos +
+                       LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
+                       Position - StartPos;
+      OFile->FileCurrentCluster = Cluster;
+      OFile->Position           = StartPos;
+
+      //
+      // The rest of the extent is contiguous on the disk
+      //
+      Run         = StartPos + ClusterSize - Position;
+      RunClusters = Extent->FileCluster + Extent->Length - ClusterIndex - 1;
+      if (Run < PosLimit) {
+        RunClusters = MIN (RunClusters, (PosLimit - Run + ClusterSize - 1) >> Volume->ClusterAlignment);
+        Run        += RunClusters << Volume->ClusterAlignment;
+      }
+
+      OFile->PosRem = Run;
+      return EFI_SUCCESS;
+    }
+
+    //
+    // Fall back to walking the cluster chain if the map can not be grown
+    //
     //
     // Run the file's cluster chain to find the current position
     // If possible, run from the current cluster rather than
@@ -727,6 +1095,7 @@ FatComputeFreeInfo (
   // If we don't have valid info, compute it now
   //
   if (!Volume->FreeInfoValid) {
+    FatBuildFreeClusterBitmap (Volume);
     Volume->FreeInfoValid                       = TRUE;
     Volume->FatInfoSector.FreeInfo.ClusterCount = 0;
     for (Index = Volume->MaxCluster + 1; Index >= FAT_MIN_CLUSTER; Index--) {
@@ -734,7 +1103,7 @@ FatComputeFreeInfo (
         break;
       }
 
-      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+      if (FatIsClusterFree (Volume, Index)) {
         Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
         Volume->FatInfoSector.FreeInfo.NextCluster   = (UINT32)Index;
       }
@@ -468,6 +468,13 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
 
+  //
+  // Free the free cluster bitmap
+  //
+  if (Volume->FreeClusterBitmap != NULL) {
+    FreePool (Volume->FreeClusterBitmap);
+  }
+
   //
   // Free directory cache
   //
@@ -150,6 +150,32 @@ InitializeUnicodeCollationSupport (
   return Status;
 }
 
+/**
+  Check whether a string holds 7-bit ASCII characters only.
+
+  Every Unicode Collation protocol maps the ASCII letters the same way, so such
+  strings are compared and case converted here instead of through the protocol.
+
+  @param  String               A pointer to a Null-terminated Unicode string.
+
+  @retval TRUE                 String holds 7-bit ASCII characters only.
+  @retval FALSE                String holds other characters.
+**/
+STATIC
+BOOLEAN
+FatIsAsciiString (
+  IN CONST CHAR16  *String
+  )
+{
+  for ( ; *String != L'\0'; String++) {
+    if (*String >= 0x80) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Performs a case-insensitive comparison of two Null-terminated Unicode strings.
 
@@ -166,10 +192,31 @@ FatStriCmp (
   IN CHAR16  *S2
   )
 {
+  CHAR16  *Char1;
+  CHAR16  *Char2;
+  CHAR16  Upper1;
+  CHAR16  Upper2;
+
   ASSERT (StrSize (S1) != 0);
   ASSERT (StrSize (S2) != 0);
   ASSERT (mUnicodeCollationInterface != NULL);
 
+  //
+  // Compare the leading ASCII characters here. Leave the rest of the strings to
+  // the protocol as soon as either one holds any other character.
+  //
+  for (Char1 = S1, Char2 = S2; (*Char1 < 0x80) && (*Char2 < 0x80); Char1++, Char2++) {
+    Upper1 = CharToUpper (*Char1);
+    Upper2 = CharToUpper (*Char2);
+    if (Upper1 != Upper2) {
+      return (INTN)Upper1 - (INTN)Upper2;
+    }
+
+    if (Upper1 == L'\0') {
+      return 0;
+    }
+  }
+
   return mUnicodeCollationInterface->StriColl (
                                        mUnicodeCollationInterface,
                                        S1,
@@ -192,6 +239,16 @@ FatStrUpr (
   ASSERT (StrSize (String) != 0);
   ASSERT (mUnicodeCollationInterface != NULL);
 
+  if (FatIsAsciiString (String)) {
+    for ( ; *String != L'\0'; String++) {
+      if ((*String >= L'a') && (*String <= L'z')) {
+        *String = (CHAR16)(*String - (L'a' - L'A'));
+      }
+    }
+
+    return;
+  }
+
   mUnicodeCollationInterface->StrUpr (mUnicodeCollationInterface, String);
 }
 
@@ -210,6 +267,16 @@ FatStrLwr (
   ASSERT (StrSize (String) != 0);
   ASSERT (mUnicodeCollationInterface != NULL);
 
+  if (FatIsAsciiString (String)) {
+    for ( ; *String != L'\0'; String++) {
+      if ((*String >= L'A') && (*String <= L'Z')) {
+        *String = (CHAR16)(*String + (L'a' - L'A'));
+      }
+    }
+
+    return;
+  }
+
   mUnicodeCollationInterface->StrLwr (mUnicodeCollationInterface, String);
 }
 
@@ -1234,6 +1234,14 @@ SetTheImage (
     goto cleanup;
   }
 
+  //
+  // Authenticating a large image takes a while.  Report the start of the check
+  // so the caller can update its display and re-arm its watchdog timer first.
+  //
+  if (Progress != NULL) {
+    Progress (1);
+  }
+
   //
   // Call check image to verify the image
   //
@@ -533,6 +533,13 @@ FmpDeviceSetImage (
   have the option to provide a more detailed description of the abort reason to
   the caller.
 
+  The whole image has been authenticated by the caller before this function is
+  called, so it does not need to be authenticated again.  A device that stores
+  the image in several regions, or in a compressed form, may program the image
+  region by region, e.g. decompress the next region while the erase or program
+  operation of the current region is in progress, and report the completion of
+  each region through Progress.
+
   @param[in]  Image             Points to the new firmware image.
   @param[in]  ImageSize         Size, in bytes, of the new firmware image.
   @param[in]  VendorCode        This enables vendor to implement vendor-specific
@@ -88,7 +88,9 @@ S3EndOfPeiNotify (
   DEBUG ((DEBUG_INFO, "S3EndOfPeiNotify enter\n"));
 
   NotifyPhaseParams.Phase = EnumInitPhaseAfterPciEnumeration;
-  Status                  = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_START_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_POST_PCIE_ENUM_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_ENTRY);
+  Status = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_END_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_POST_PCIE_ENUM_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_EXIT);
   DEBUG ((DEBUG_INFO, "FSP S3NotifyPhase AfterPciEnumeration status: 0x%x\n", Status));
 
   //
@@ -100,7 +102,9 @@ S3EndOfPeiNotify (
   }
 
   NotifyPhaseParams.Phase = EnumInitPhaseReadyToBoot;
-  Status                  = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_START_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_READY_TO_BOOT_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_ENTRY);
+  Status = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_END_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_READY_TO_BOOT_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_EXIT);
   DEBUG ((DEBUG_INFO, "FSP S3NotifyPhase ReadyToBoot status: 0x%x\n", Status));
 
   //
@@ -112,7 +116,9 @@ S3EndOfPeiNotify (
   }
 
   NotifyPhaseParams.Phase = EnumInitPhaseEndOfFirmware;
-  Status                  = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_START_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_END_OF_FIRMWARE_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_ENTRY);
+  Status = CallFspNotifyPhase (&NotifyPhaseParams);
+  PERF_END_EX (&gFspApiPerformanceGuid, "EventRec", NULL, 0, FSP_STATUS_CODE_END_OF_FIRMWARE_NOTIFICATION | FSP_STATUS_CODE_COMMON_CODE | FSP_STATUS_CODE_API_EXIT);
   DEBUG ((DEBUG_INFO, "FSP S3NotifyPhase EndOfFirmware status: 0x%x\n", Status));
 
   //
@@ -87,6 +87,7 @@ CHAR8  *mMemoryTypeString[] = {
   "EfiMemoryMappedIOPortSpace",
   "EfiPalCode",
   "EfiPersistentMemory",
+  "EfiUnacceptedMemoryType",
   "EfiOSReserved",
   "EfiOemReserved",
 };
@@ -28,6 +28,15 @@ CHAR8  mNameString[PROFILE_NAME_STRING_LENGTH + 1];
 VOID   *mSmiHandlerProfileDatabase;
 UINTN  mSmiHandlerProfileDatabaseSize;
 
+EFI_SMM_COMMUNICATION_PROTOCOL  *mSmmCommunication;
+UINT8                           *mCommBuffer;
+UINTN                           mCommBufferSize;
+
+SMI_HANDLER_PROFILE_HANDLER_STATISTICS  *mSmiHandlerStatistics;
+UINTN                                   mSmiHandlerStatisticsCount;
+SMI_RENDEZVOUS_HISTOGRAM                mSmiRendezvousHistogram;
+BOOLEAN                                 mSmiRendezvousHistogramValid;
+
 /**
   This function dump raw data.
 
@@ -107,6 +116,10 @@ GetSmiHandlerProfileDatabase (
   ASSERT (Index < PiSmmCommunicationRegionTable->NumberOfEntries);
   CommBuffer = (UINT8 *)(UINTN)Entry->PhysicalStart;
 
+  mSmmCommunication = SmmCommunication;
+  mCommBuffer       = CommBuffer;
+  mCommBufferSize   = Size;
+
   //
   // Get Size
   //
@@ -185,6 +198,114 @@ GetSmiHandlerProfileDatabase (
   return;
 }
 
+/**
+  Get SMI handler statistics and SMI rendezvous histogram.
+
+  It uses the SMM communication buffer found by GetSmiHandlerProfileDatabase().
+**/
+VOID
+GetSmiHandlerProfileStatistics (
+  VOID
+  )
+{
+  EFI_STATUS                                              Status;
+  UINTN                                                   CommSize;
+  EFI_SMM_COMMUNICATE_HEADER                              *CommHeader;
+  SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS            *CommGetStatistics;
+  SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM  *CommGetHistogram;
+  SMI_HANDLER_PROFILE_HANDLER_STATISTICS                  *Statistics;
+  UINTN                                                   Count;
+
+  //
+  // Get the SMI handler statistics, as many as the buffer holds at a time.
+  //
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&mCommBuffer[0];
+  CopyMem (&CommHeader->HeaderGuid, &gSmiHandlerProfileGuid, sizeof (gSmiHandlerProfileGuid));
+  CommHeader->MessageLength = sizeof (SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS);
+
+  CommGetStatistics = (SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS *)&mCommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  CommSize          = sizeof (EFI_GUID) + sizeof (UINTN) + CommHeader->MessageLength;
+
+  while (TRUE) {
+    CommGetStatistics->Header.Command      = SMI_HANDLER_PROFILE_COMMAND_GET_STATISTICS;
+    CommGetStatistics->Header.DataLength   = sizeof (*CommGetStatistics);
+    CommGetStatistics->Header.ReturnStatus = (UINT64)-1;
+    CommGetStatistics->DataBuffer          = (PHYSICAL_ADDRESS)(UINTN)(mCommBuffer + CommSize);
+    CommGetStatistics->DataSize            = (UINT64)(mCommBufferSize - CommSize);
+    CommGetStatistics->HandlerIndex        = (UINT64)mSmiHandlerStatisticsCount;
+
+    Status = mSmmCommunication->Communicate (mSmmCommunication, mCommBuffer, &CommSize);
+    if (EFI_ERROR (Status) || (CommGetStatistics->Header.ReturnStatus != 0) || (CommGetStatistics->DataSize == 0)) {
+      break;
+    }
+
+    Count      = (UINTN)CommGetStatistics->DataSize / sizeof (SMI_HANDLER_PROFILE_HANDLER_STATISTICS);
+    Statistics = ReallocatePool (
+                   mSmiHandlerStatisticsCount * sizeof (SMI_HANDLER_PROFILE_HANDLER_STATISTICS),
+                   (mSmiHandlerStatisticsCount + Count) * sizeof (SMI_HANDLER_PROFILE_HANDLER_STATISTICS),
+                   mSmiHandlerStatistics
+                   );
+    if (Statistics == NULL) {
+      Print (L"SmiHandlerProfile: ReallocatePool for statistics - %r\n", EFI_OUT_OF_RESOURCES);
+      break;
+    }
+
+    CopyMem (
+      Statistics + mSmiHandlerStatisticsCount,
+      (VOID *)(UINTN)CommGetStatistics->DataBuffer,
+      Count * sizeof (SMI_HANDLER_PROFILE_HANDLER_STATISTICS)
+      );
+    mSmiHandlerStatistics       = Statistics;
+    mSmiHandlerStatisticsCount += Count;
+  }
+
+  //
+  // Get the SMI rendezvous histogram.
+  //
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&mCommBuffer[0];
+  CopyMem (&CommHeader->HeaderGuid, &gSmiHandlerProfileGuid, sizeof (gSmiHandlerProfileGuid));
+  CommHeader->MessageLength = sizeof (SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM);
+
+  CommGetHistogram                      = (SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM *)&mCommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  CommGetHistogram->Header.Command      = SMI_HANDLER_PROFILE_COMMAND_GET_RENDEZVOUS_HISTOGRAM;
+  CommGetHistogram->Header.DataLength   = sizeof (*CommGetHistogram);
+  CommGetHistogram->Header.ReturnStatus = (UINT64)-1;
+
+  CommSize = sizeof (EFI_GUID) + sizeof (UINTN) + CommHeader->MessageLength;
+  Status   = mSmmCommunication->Communicate (mSmmCommunication, mCommBuffer, &CommSize);
+  if (!EFI_ERROR (Status) && (CommGetHistogram->Header.ReturnStatus == 0)) {
+    CopyMem (&mSmiRendezvousHistogram, &CommGetHistogram->Histogram, sizeof (mSmiRendezvousHistogram));
+    mSmiRendezvousHistogramValid = TRUE;
+  }
+}
+
+/**
+  Get the statistics of an SMI handler.
+
+  @param HandlerType  The type of the SMI handler.
+  @param Handler      The address of the SMI handler.
+
+  @return the statistics of the SMI handler, or NULL if not found.
+**/
+SMI_HANDLER_PROFILE_HANDLER_STATISTICS *
+GetSmiHandlerStatistics (
+  IN EFI_GUID          *HandlerType,
+  IN PHYSICAL_ADDRESS  Handler
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mSmiHandlerStatisticsCount; Index++) {
+    if ((mSmiHandlerStatistics[Index].Handler == Handler) &&
+        CompareGuid (&mSmiHandlerStatistics[Index].HandlerType, HandlerType))
+    {
+      return &mSmiHandlerStatistics[Index];
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Get the file name portion of the Pdb File Name.
 
@@ -589,8 +710,9 @@ DumpSmiHandler (
   SMM_CORE_SMI_DATABASE_STRUCTURE    *SmiStruct;
   SMM_CORE_SMI_HANDLER_STRUCTURE     *SmiHandlerStruct;
   UINTN                              Index;
-  SMM_CORE_IMAGE_DATABASE_STRUCTURE  *ImageStruct;
-  CHAR8                              *NameString;
+  SMM_CORE_IMAGE_DATABASE_STRUCTURE       *ImageStruct;
+  CHAR8                                   *NameString;
+  SMI_HANDLER_PROFILE_HANDLER_STATISTICS  *Statistics;
 
   SmiStruct = (VOID *)mSmiHandlerProfileDatabase;
   while ((UINTN)SmiStruct < (UINTN)mSmiHandlerProfileDatabase + mSmiHandlerProfileDatabaseSize) {
@@ -629,6 +751,16 @@ DumpSmiHandler (
         }
 
         Print (L"      </Caller>\n", SmiHandlerStruct->Handler);
+        Statistics = GetSmiHandlerStatistics (&SmiStruct->HandlerType, SmiHandlerStruct->Handler);
+        if (Statistics != NULL) {
+          Print (
+            L"      <Statistics InvokeCount=\"%ld\" TotalTime=\"%ld\" MaxTime=\"%ld\"/>\n",
+            Statistics->InvokeCount,
+            Statistics->TotalTime,
+            Statistics->MaxTime
+            );
+        }
+
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print (L"    </SmiHandler>\n");
       }
@@ -642,6 +774,36 @@ DumpSmiHandler (
   return;
 }
 
+/**
+  Dump SMI rendezvous histogram.
+**/
+VOID
+DumpSmiRendezvousHistogram (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  Print (
+    L"  <SmiCount>%ld</SmiCount>\n  <MaxRendezvousTime>%ld</MaxRendezvousTime>\n  <MaxTotalTime>%ld</MaxTotalTime>\n",
+    mSmiRendezvousHistogram.SmiCount,
+    mSmiRendezvousHistogram.MaxRendezvousTime,
+    mSmiRendezvousHistogram.MaxTotalTime
+    );
+  for (Index = 0; Index < SMI_RENDEZVOUS_HISTOGRAM_BUCKET_COUNT; Index++) {
+    if ((mSmiRendezvousHistogram.RendezvousTime[Index] == 0) && (mSmiRendezvousHistogram.TotalTime[Index] == 0)) {
+      continue;
+    }
+
+    Print (
+      L"  <Bucket MinTime=\"%ld\" RendezvousCount=\"%ld\" TotalCount=\"%ld\"/>\n",
+      (Index == 0) ? 0 : LShiftU64 (1, Index - 1),
+      mSmiRendezvousHistogram.RendezvousTime[Index],
+      mSmiRendezvousHistogram.TotalTime[Index]
+      );
+  }
+}
+
 /**
   The Entry Point for SMI handler profile info application.
 
@@ -664,6 +826,8 @@ SmiHandlerProfileInfoEntrypoint (
     return EFI_SUCCESS;
   }
 
+  GetSmiHandlerProfileStatistics ();
+
   //
   // Dump all image
   //
@@ -695,11 +859,26 @@ SmiHandlerProfileInfoEntrypoint (
   Print (L"  </SmiHandlerCategory>\n\n");
 
   Print (L"</SmiHandlerDatabase>\n");
+
+  //
+  // Dump SMI rendezvous histogram
+  //
+  if (mSmiRendezvousHistogramValid) {
+    Print (L"\n<SmiRendezvousHistogram>\n");
+    Print (L"  <!-- SMI time on BSP in microseconds -->\n");
+    DumpSmiRendezvousHistogram ();
+    Print (L"</SmiRendezvousHistogram>\n");
+  }
+
   Print (L"</SmiHandlerProfile>\n");
 
   if (mSmiHandlerProfileDatabase != NULL) {
     FreePool (mSmiHandlerProfileDatabase);
   }
 
+  if (mSmiHandlerStatistics != NULL) {
+    FreePool (mSmiHandlerStatistics);
+  }
+
   return EFI_SUCCESS;
 }
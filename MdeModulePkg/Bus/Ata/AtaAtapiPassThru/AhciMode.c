@@ -2817,6 +2817,8 @@ AhciModeInitialization (
   EFI_ATA_TRANSFER_MODE    TransferMode;
   UINT32                   PhyDetectDelay;
   UINT32                   Value;
+  UINT32                   PendingPorts;
+  UINT32                   DetectedPorts;
 
   if (Instance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -2883,6 +2885,11 @@ AhciModeInitialization (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Start all implemented ports first, so that the devices on different ports
+  // detect their link and spin up at the same time.
+  //
+  PendingPorts = 0;
   for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
     if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
       //
@@ -2945,31 +2952,53 @@ AhciModeInitialization (
       Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
       AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_FRE);
 
-      //
-      // Wait for the Phy to detect the presence of a device.
-      //
-      PhyDetectDelay = EFI_AHCI_BUS_PHY_DETECT_TIMEOUT;
-      Offset         = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
-      do {
-        Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
+      PendingPorts |= ((UINT32)BIT0) << Port;
+    }
+  }
+
+  //
+  // Wait for the Phy to detect the presence of a device, on all started ports at once.
+  //
+  DetectedPorts  = 0;
+  PhyDetectDelay = EFI_AHCI_BUS_PHY_DETECT_TIMEOUT;
+  do {
+    for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+      if ((PendingPorts & (((UINT32)BIT0) << Port)) != 0) {
+        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
+        Data   = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
         if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
-          break;
+          PendingPorts  &= ~(((UINT32)BIT0) << Port);
+          DetectedPorts |= ((UINT32)BIT0) << Port;
         }
+      }
+    }
 
-        MicroSecondDelay (1000);
-        PhyDetectDelay--;
-      } while (PhyDetectDelay > 0);
+    if (PendingPorts == 0) {
+      break;
+    }
 
-      if (PhyDetectDelay == 0) {
-        //
-        // No device detected at this port.
-        // Clear PxCMD.SUD for those ports at which there are no device present.
-        //
-        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
-        AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_SUD));
-        continue;
-      }
+    MicroSecondDelay (1000);
+    PhyDetectDelay--;
+  } while (PhyDetectDelay > 0);
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((PendingPorts & (((UINT32)BIT0) << Port)) != 0) {
+      //
+      // No device detected at this port.
+      // Clear PxCMD.SUD for those ports at which there are no device present.
+      //
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+      AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_SUD));
+    }
+  }
 
+  //
+  // Identify the devices one port at a time, as all ports share one command
+  // table. The devices already spin up in parallel, so the wait for the
+  // first one mostly covers the others.
+  //
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((DetectedPorts & (((UINT32)BIT0) << Port)) != 0) {
       Status = AhciWaitDeviceReady (PciIo, Port);
       if (EFI_ERROR (Status)) {
         continue;
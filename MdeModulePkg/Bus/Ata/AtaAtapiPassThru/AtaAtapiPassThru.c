@@ -1402,6 +1402,13 @@ AtaPassThruPassThru (
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Instance->NonBlockingTaskList, &Task->Link);
+
+    //
+    // Start the task, or poll the ones ahead of it, now rather than on the next
+    // timer tick, so a caller keeping several requests in flight sees them
+    // complete at the rate it queues new ones.
+    //
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
     gBS->RestoreTPL (OldTpl);
 
     return EFI_SUCCESS;
@@ -672,16 +672,8 @@ ProcessAsyncTaskList (
           PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
         }
 
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
-
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
+        if (AsyncRequest->PrpList != NULL) {
+          NvmeReleasePrpList (Private, AsyncRequest->PrpList);
         }
 
         RemoveEntryList (Link);
@@ -974,6 +966,8 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
+    InitializeListHead (&Private->FreePrpLists);
+
     //
     // Save original PCI attributes
     //
@@ -1002,21 +996,28 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
+    // The asynchronous I/O submission queue holds PcdNvmeAsyncIoQueueDepth
+    // entries, which may span more than one page.
+    //
+    Private->AsyncSqSize = (UINT16)(MIN (MAX (PcdGet16 (PcdNvmeAsyncIoQueueDepth), 2), NVME_ASYNC_CSQ_MAX_SIZE + 1) - 1);
+    Private->BufferPages = 5 + NVME_ASYNC_CSQ_PAGES (Private->AsyncSqSize);
+
+    //
+    // BufferPages x 4kB aligned buffers will be carved out of this buffer.
     // 1st 4kB boundary is the start of the admin submission queue.
     // 2nd 4kB boundary is the start of the admin completion queue.
     // 3rd 4kB boundary is the start of I/O submission queue #1.
     // 4th 4kB boundary is the start of I/O completion queue #1.
     // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // The last 4kB boundary is the start of I/O completion queue #2.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate BufferPages pages of memory, then map it for bus master read and write.
     //
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      Private->BufferPages,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1024,7 +1025,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (Private->BufferPages);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1034,7 +1035,7 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Private->BufferPages))) {
       goto Exit;
     }
 
@@ -1139,12 +1140,16 @@ NvmExpressDriverBindingStart (
   return EFI_SUCCESS;
 
 Exit:
+  if (Private != NULL) {
+    NvmeFreeCachedPrpLists (Private);
+  }
+
   if ((Private != NULL) && (Private->Mapping != NULL)) {
     PciIo->Unmap (PciIo, Private->Mapping);
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, Private->BufferPages, Private->Buffer);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1261,12 +1266,14 @@ NvmExpressDriverBindingStop (
         gBS->CloseEvent (Private->TimerEvent);
       }
 
+      NvmeFreeCachedPrpLists (Private);
+
       if (Private->Mapping != NULL) {
         Private->PciIo->Unmap (Private->PciIo, Private->Mapping);
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, Private->BufferPages, Private->Buffer);
       }
 
       FreePool (Private->ControllerData);
@@ -40,6 +40,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA  NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA      NVME_DEVICE_PRIVATE_DATA;
@@ -63,10 +64,16 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 #define NVME_CCQ_SIZE  1                                // Number of I/O completion queue entries, which is 0-based
 
 //
-// Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// Maximum number of asynchronous I/O submission queue entries, which is 0-based.
+// The actual size comes from PcdNvmeAsyncIoQueueDepth and is kept in
+// NVME_CONTROLLER_PRIVATE_DATA.AsyncSqSize.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_ASYNC_CSQ_MAX_SIZE  255
+//
+// Number of 4kB pages taken by an asynchronous I/O submission queue of the given
+// 0-based size.
+//
+#define NVME_ASYNC_CSQ_PAGES(Size)  EFI_SIZE_TO_PAGES (((UINTN)(Size) + 1) * sizeof (NVME_SQ))
 //
 // Number of asynchronous I/O completion queue entries, which is 0-based.
 // The asynchronous I/O completion queue size is 4kB in total.
@@ -116,16 +123,18 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // BufferPages x 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // 5th 4kB boundary is the start of I/O submission queue #2, which takes
+  // NVME_ASYNC_CSQ_PAGES (AsyncSqSize) pages.
+  // The last 4kB boundary is the start of I/O completion queue #2.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
+  UINTN          BufferPages;
 
   //
   // Pointers to 4kB aligned submission & completion queues.
@@ -141,6 +150,7 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_SQTDBL    SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
   UINT16         AsyncSqHead;
+  UINT16         AsyncSqSize;
 
   //
   // Flag to indicate internal IO queue creation.
@@ -163,6 +173,12 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   EFI_EVENT      TimerEvent;
   LIST_ENTRY     AsyncPassThruQueue;
   LIST_ENTRY     UnsubmittedSubtasks;
+
+  //
+  // PRP lists released by completed commands, kept for reuse.
+  //
+  LIST_ENTRY     FreePrpLists;
+  UINTN          FreePrpListCount;
 };
 
 #define NVME_CONTROLLER_PRIVATE_DATA_FROM_PASS_THRU(a) \
@@ -281,6 +297,25 @@ typedef struct {
 #define NVME_BLKIO2_SUBTASK_FROM_LINK(a) \
   CR (a, NVME_BLKIO2_SUBTASK, Link, NVME_BLKIO2_SUBTASK_SIGNATURE)
 
+//
+// PRP list pages, allocated and mapped for common buffer access. Released PRP
+// lists are kept on NVME_CONTROLLER_PRIVATE_DATA.FreePrpLists for reuse.
+//
+#define NVME_PRP_LIST_SIGNATURE  SIGNATURE_32 ('N', 'P', 'R', 'P')
+
+typedef struct {
+  UINT32                  Signature;
+  LIST_ENTRY              Link;
+
+  VOID                    *Host;
+  EFI_PHYSICAL_ADDRESS    PciAddr;
+  UINTN                   Pages;
+  VOID                    *Mapping;
+} NVME_PRP_LIST;
+
+#define NVME_PRP_LIST_FROM_LINK(a) \
+  CR (a, NVME_PRP_LIST, Link, NVME_PRP_LIST_SIGNATURE)
+
 //
 // Nvme asynchronous passthru request.
 //
@@ -292,9 +327,7 @@ typedef struct {
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
   UINT16                                      CommandId;
-  VOID                                        *MapPrpList;
-  UINTN                                       PrpListNo;
-  VOID                                        *PrpListHost;
+  NVME_PRP_LIST                               *PrpList;
   VOID                                        *MapData;
   VOID                                        *MapMeta;
   EFI_EVENT                                   CallerEvent;
@@ -307,6 +340,18 @@ typedef struct {
       NVME_PASS_THRU_ASYNC_REQ_SIG                       \
       )
 
+//
+// Command slot used by blocking reads and writes that keep several commands
+// in flight on the asynchronous I/O queue.
+//
+typedef struct {
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                     Command;
+  EFI_NVM_EXPRESS_COMPLETION                  Completion;
+  EFI_EVENT                                   Event;
+  BOOLEAN                                     InUse;
+} NVME_QUEUED_IO_SLOT;
+
 /**
   Retrieves a Unicode string that is the user readable name of the driver.
 
@@ -710,6 +755,63 @@ NvmExpressBuildDevicePath (
   IN OUT EFI_DEVICE_PATH_PROTOCOL            **DevicePath
   );
 
+/**
+  Releases a PRP list returned by NvmeCreatePrpList(). The PRP list is kept for
+  reuse by later commands unless enough PRP lists are kept already.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] PrpList        The PRP list to release.
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN NVME_PRP_LIST                 *PrpList
+  );
+
+/**
+  Frees all the PRP lists kept for reuse.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+**/
+VOID
+NvmeFreeCachedPrpLists (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Dump the execution status from a given completion queue entry.
 
@@ -141,6 +141,218 @@ WriteSectors (
   return Status;
 }
 
+/**
+  Read or write some blocks with several commands in flight on the asynchronous
+  I/O queue, and wait for all of them to complete.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Opcode                 NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param  Buffer                 The buffer used to store the data read from the device,
+                                 or to be written into the device.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  MaxTransferBlocks      The maximum block number of a single command.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to queue the commands.
+  @retval EFI_TIMEOUT            A command did not complete in time, and the controller
+                                 has been reset.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+STATIC
+EFI_STATUS
+NvmeQueuedReadWrite (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN UINT8                     Opcode,
+  IN UINT64                    Buffer,
+  IN UINT64                    Lba,
+  IN UINTN                     Blocks,
+  IN UINT32                    MaxTransferBlocks
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  NVME_QUEUED_IO_SLOT           *Slots;
+  NVME_QUEUED_IO_SLOT           *Slot;
+  NVME_CQ                       *Cq;
+  UINTN                         SlotCount;
+  UINTN                         InFlight;
+  UINTN                         Index;
+  UINT32                        BlockSize;
+  UINT32                        TransferBlocks;
+  EFI_EVENT                     TimerEvent;
+  EFI_STATUS                    Status;
+  EFI_STATUS                    SubmitStatus;
+  EFI_TPL                       OldTpl;
+  BOOLEAN                       Progress;
+
+  Private    = Device->Controller;
+  BlockSize  = Device->Media.BlockSize;
+  TimerEvent = NULL;
+  InFlight   = 0;
+
+  //
+  // An N-entry submission queue holds at most N - 1 outstanding commands.
+  //
+  SlotCount = MIN (Private->AsyncSqSize, Private->Cap.Mqes);
+  SlotCount = MIN (SlotCount, Blocks / MaxTransferBlocks + 1);
+  Slots     = AllocateZeroPool (SlotCount * sizeof (NVME_QUEUED_IO_SLOT));
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < SlotCount; Index++) {
+    Status = gBS->CreateEvent (0, 0, NULL, NULL, &Slots[Index].Event);
+    if (EFI_ERROR (Status)) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Status = gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  while (((Blocks > 0) && !EFI_ERROR (Status)) || (InFlight > 0)) {
+    Progress = FALSE;
+
+    //
+    // Fill the free slots. EFI_NOT_READY means the queue is full, possibly of
+    // BlockIo2 or PassThru requests from other callers, so retry after reaping.
+    //
+    for (Index = 0; (Index < SlotCount) && (Blocks > 0) && !EFI_ERROR (Status); Index++) {
+      Slot = &Slots[Index];
+      if (Slot->InUse) {
+        continue;
+      }
+
+      TransferBlocks = (UINT32)MIN (Blocks, MaxTransferBlocks);
+
+      ZeroMem (&Slot->CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+      ZeroMem (&Slot->Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
+      ZeroMem (&Slot->Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+
+      Slot->CommandPacket.NvmeCmd        = &Slot->Command;
+      Slot->CommandPacket.NvmeCompletion = &Slot->Completion;
+      Slot->CommandPacket.TransferBuffer = (VOID *)(UINTN)Buffer;
+      Slot->CommandPacket.TransferLength = TransferBlocks * BlockSize;
+      Slot->CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+      Slot->CommandPacket.QueueType      = NVME_IO_QUEUE;
+
+      Slot->Command.Cdw0.Opcode = Opcode;
+      Slot->Command.Nsid        = Device->NamespaceId;
+      Slot->Command.Cdw10       = (UINT32)Lba;
+      Slot->Command.Cdw11       = (UINT32)RShiftU64 (Lba, 32);
+      Slot->Command.Cdw12       = (TransferBlocks - 1) & 0xFFFF;
+      if (Opcode == NVME_IO_WRITE_OPC) {
+        //
+        // Set Force Unit Access bit (bit 30) to use write-through behaviour
+        //
+        Slot->Command.Cdw12 |= BIT30;
+      }
+
+      Slot->Command.Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
+
+      SubmitStatus = Private->Passthru.PassThru (
+                                         &Private->Passthru,
+                                         Device->NamespaceId,
+                                         &Slot->CommandPacket,
+                                         Slot->Event
+                                         );
+      if (SubmitStatus == EFI_NOT_READY) {
+        break;
+      }
+
+      if (EFI_ERROR (SubmitStatus)) {
+        Status = SubmitStatus;
+        break;
+      }
+
+      Slot->InUse = TRUE;
+      InFlight++;
+      Progress = TRUE;
+
+      Blocks -= TransferBlocks;
+      Buffer += TransferBlocks * BlockSize;
+      Lba    += TransferBlocks;
+    }
+
+    //
+    // Reap the completions now rather than on the next tick of the
+    // asynchronous I/O timer.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+
+    for (Index = 0; Index < SlotCount; Index++) {
+      Slot = &Slots[Index];
+      if (!Slot->InUse || EFI_ERROR (gBS->CheckEvent (Slot->Event))) {
+        continue;
+      }
+
+      Slot->InUse = FALSE;
+      InFlight--;
+      Progress = TRUE;
+
+      Cq = (NVME_CQ *)&Slot->Completion;
+      if ((Cq->Sct != 0) || (Cq->Sc != 0)) {
+        //
+        // Dump completion entry status for debugging.
+        //
+        DEBUG_CODE_BEGIN ();
+        NvmeDumpStatus (Cq);
+        DEBUG_CODE_END ();
+
+        if (!EFI_ERROR (Status)) {
+          Status = EFI_DEVICE_ERROR;
+        }
+      }
+    }
+
+    if (Progress) {
+      gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+    } else if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      //
+      // Timeout occurs for an NVMe command. Reset the controller to abort the
+      // outstanding commands, which also releases the resources of the ones
+      // queued here.
+      //
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe command.\n", __FUNCTION__));
+
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+      Status = NvmeControllerInit (Private);
+      AbortAsyncPassThruTasks (Private);
+      gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+
+      Status = EFI_ERROR (Status) ? EFI_DEVICE_ERROR : EFI_TIMEOUT;
+      break;
+    }
+  }
+
+Exit:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+
+  for (Index = 0; Index < SlotCount; Index++) {
+    if (Slots[Index].Event != NULL) {
+      gBS->CloseEvent (Slots[Index].Event);
+    }
+  }
+
+  FreePool (Slots);
+
+  return Status;
+}
+
 /**
   Read some blocks from the device.
 
@@ -195,7 +407,20 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // The transfer takes more than one command, so keep several of them in
+    // flight. Fall back to one command at a time if they cannot be queued.
+    //
+    Status = NvmeQueuedReadWrite (Device, NVME_IO_READ_OPC, (UINT64)(UINTN)Buffer, Lba, Blocks, MaxTransferBlocks);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
+    } else if (Status == EFI_OUT_OF_RESOURCES) {
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  while ((Blocks > 0) && !EFI_ERROR (Status)) {
     if (Blocks > MaxTransferBlocks) {
       Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
 
@@ -281,7 +506,20 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // The transfer takes more than one command, so keep several of them in
+    // flight. Fall back to one command at a time if they cannot be queued.
+    //
+    Status = NvmeQueuedReadWrite (Device, NVME_IO_WRITE_OPC, (UINT64)(UINTN)Buffer, Lba, Blocks, MaxTransferBlocks);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
+    } else if (Status == EFI_OUT_OF_RESOURCES) {
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  while ((Blocks > 0) && !EFI_ERROR (Status)) {
     if (Blocks > MaxTransferBlocks) {
       Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
 
@@ -813,6 +1051,15 @@ NvmeAsyncRead (
     }
   }
 
+  //
+  // Submit the subtasks, and reap the completed ones, now rather than on the
+  // next tick of the asynchronous I/O timer, so a caller keeping several
+  // requests in flight sees them complete at the rate it queues new ones.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ProcessAsyncTaskList (Private->TimerEvent, Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -941,6 +1188,15 @@ NvmeAsyncWrite (
     }
   }
 
+  //
+  // Submit the subtasks, and reap the completed ones, now rather than on the
+  // next tick of the asynchronous I/O timer, so a caller keeping several
+  // requests in flight sees them complete at the rate it queues new ones.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ProcessAsyncTaskList (Private->TimerEvent, Private);
+  gBS->RestoreTPL (OldTpl);
+
   DEBUG ((
     DEBUG_BLKIO,
     "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
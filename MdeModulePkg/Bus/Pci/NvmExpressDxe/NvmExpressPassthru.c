@@ -195,38 +195,199 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Gets PRP list pages for a command, reusing a released PRP list if one is
+  large enough.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] Pages          The number of PRP list pages required.
+
+  @return The PRP list, or NULL if it could not be allocated and mapped.
+
+**/
+STATIC
+NVME_PRP_LIST *
+NvmeGetPrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINTN                         Pages
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  NVME_PRP_LIST        *PrpList;
+  LIST_ENTRY           *Link;
+  UINTN                Bytes;
+  EFI_STATUS           Status;
+  EFI_TPL              OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Link = GetFirstNode (&Private->FreePrpLists);
+       !IsNull (&Private->FreePrpLists, Link);
+       Link = GetNextNode (&Private->FreePrpLists, Link))
+  {
+    PrpList = NVME_PRP_LIST_FROM_LINK (Link);
+    if (PrpList->Pages >= Pages) {
+      RemoveEntryList (Link);
+      Private->FreePrpListCount--;
+      gBS->RestoreTPL (OldTpl);
+      return PrpList;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  PciIo   = Private->PciIo;
+  PrpList = AllocateZeroPool (sizeof (NVME_PRP_LIST));
+  if (PrpList == NULL) {
+    return NULL;
+  }
+
+  PrpList->Signature = NVME_PRP_LIST_SIGNATURE;
+  PrpList->Pages     = Pages;
+
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    Pages,
+                    &PrpList->Host,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    FreePool (PrpList);
+    return NULL;
+  }
+
+  Bytes  = EFI_PAGES_TO_SIZE (Pages);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    PrpList->Host,
+                    &Bytes,
+                    &PrpList->PciAddr,
+                    &PrpList->Mapping
+                    );
+
+  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Pages))) {
+    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, PrpList->Mapping);
+    }
+
+    PciIo->FreeBuffer (PciIo, Pages, PrpList->Host);
+    FreePool (PrpList);
+    return NULL;
+  }
+
+  return PrpList;
+}
+
+/**
+  Unmaps and frees the pages of a PRP list.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] PrpList        The PRP list to free.
+
+**/
+STATIC
+VOID
+NvmeDestroyPrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN NVME_PRP_LIST                 *PrpList
+  )
+{
+  Private->PciIo->Unmap (Private->PciIo, PrpList->Mapping);
+  Private->PciIo->FreeBuffer (Private->PciIo, PrpList->Pages, PrpList->Host);
+  FreePool (PrpList);
+}
+
+/**
+  Releases a PRP list returned by NvmeCreatePrpList(). The PRP list is kept for
+  reuse by later commands unless enough PRP lists are kept already.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] PrpList        The PRP list to release.
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN NVME_PRP_LIST                 *PrpList
+  )
+{
+  EFI_TPL  OldTpl;
+
+  //
+  // At most one command per submission queue entry of the two I/O queues
+  // can own a PRP list, so there is no point in keeping more than that.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Private->FreePrpListCount < (UINTN)Private->AsyncSqSize + NVME_CSQ_SIZE) {
+    InsertHeadList (&Private->FreePrpLists, &PrpList->Link);
+    Private->FreePrpListCount++;
+    PrpList = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (PrpList != NULL) {
+    NvmeDestroyPrpList (Private, PrpList);
+  }
+}
+
+/**
+  Frees all the PRP lists kept for reuse.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+**/
+VOID
+NvmeFreeCachedPrpLists (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  NVME_PRP_LIST  *PrpList;
+
+  while (!IsListEmpty (&Private->FreePrpLists)) {
+    PrpList = NVME_PRP_LIST_FROM_LINK (GetFirstNode (&Private->FreePrpLists));
+    RemoveEntryList (&PrpList->Link);
+    NvmeDestroyPrpList (Private, PrpList);
+  }
+
+  Private->FreePrpListCount = 0;
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
-  Note here we calcuate the number of required PRP lists and allocate them at one time.
+  Note here we calcuate the number of required PRP lists and get them at one time.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
-  @param[out]    PrpListHost         The host base address of PRP lists.
-  @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+  @param[out]    PrpList             The PRP list holding the PRP entries. It must be
+                                     released with NvmeReleasePrpList().
 
   @retval The pointer to the first PRP List of the PRP lists.
 
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT    NVME_PRP_LIST                 **PrpList
   )
 {
   UINTN                 PrpEntryNo;
+  UINTN                 PrpListNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
   UINTN                 PrpEntryIndex;
   UINT64                Remainder;
   EFI_PHYSICAL_ADDRESS  PrpListPhyAddr;
-  UINTN                 Bytes;
-  EFI_STATUS            Status;
 
   //
   // The number of Prp Entry in a memory page.
@@ -236,51 +397,30 @@ NvmeCreatePrpList (
   //
   // Calculate total PrpList number.
   //
-  *PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
-  if (*PrpListNo == 0) {
-    *PrpListNo = 1;
+  PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
+  if (PrpListNo == 0) {
+    PrpListNo = 1;
   } else if ((Remainder != 0) && (Remainder != 1)) {
-    *PrpListNo += 1;
+    PrpListNo += 1;
   } else if (Remainder == 1) {
     Remainder = PrpEntryNo;
   } else if (Remainder == 0) {
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
-
-  if (EFI_ERROR (Status)) {
+  *PrpList = NvmeGetPrpList (Private, PrpListNo);
+  if (*PrpList == NULL) {
     return NULL;
   }
 
-  Bytes  = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
-  }
+  PrpListPhyAddr = (*PrpList)->PciAddr;
 
   //
   // Fill all PRP lists except of last one.
   //
-  ZeroMem (*PrpListHost, Bytes);
-  for (PrpListIndex = 0; PrpListIndex < *PrpListNo - 1; ++PrpListIndex) {
-    PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  ZeroMem ((*PrpList)->Host, EFI_PAGES_TO_SIZE (PrpListNo));
+  for (PrpListIndex = 0; PrpListIndex < PrpListNo - 1; ++PrpListIndex) {
+    PrpListBase = (UINT64)(UINTN)(*PrpList)->Host + PrpListIndex * EFI_PAGE_SIZE;
 
     for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; ++PrpEntryIndex) {
       if (PrpEntryIndex != PrpEntryNo - 1) {
@@ -301,17 +441,13 @@ NvmeCreatePrpList (
   //
   // Fill last PRP list.
   //
-  PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  PrpListBase = (UINT64)(UINTN)(*PrpList)->Host + PrpListIndex * EFI_PAGE_SIZE;
   for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
     *((UINT64 *)(UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
     PhysicalAddr                                   += EFI_PAGE_SIZE;
   }
 
   return (VOID *)(UINTN)PrpListPhyAddr;
-
-EXIT:
-  PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
-  return NULL;
 }
 
 /**
@@ -384,16 +520,8 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
-    if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+    if (AsyncRequest->PrpList != NULL) {
+      NvmeReleasePrpList (Private, AsyncRequest->PrpList);
     }
 
     RemoveEntryList (Link);
@@ -470,11 +598,9 @@ NvmExpressPassThru (
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   VOID                           *MapData;
   VOID                           *MapMeta;
-  VOID                           *MapPrpList;
   UINTN                          MapLength;
   UINT64                         *Prp;
-  VOID                           *PrpListHost;
-  UINTN                          PrpListNo;
+  NVME_PRP_LIST                  *PrpList;
   UINT32                         Attributes;
   UINT32                         IoAlign;
   UINT32                         MaxTransLen;
@@ -547,13 +673,11 @@ NvmExpressPassThru (
   PciIo       = Private->PciIo;
   MapData     = NULL;
   MapMeta     = NULL;
-  MapPrpList  = NULL;
-  PrpListHost = NULL;
-  PrpListNo   = 0;
+  PrpList     = NULL;
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  QueueSize   = MIN (Private->AsyncSqSize, Private->Cap.Mqes) + 1;
 
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
     QueueId = 0;
@@ -680,7 +804,7 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -764,9 +888,7 @@ NvmExpressPassThru (
     AsyncRequest->CallerEvent = Event;
     AsyncRequest->MapData     = MapData;
     AsyncRequest->MapMeta     = MapMeta;
-    AsyncRequest->MapPrpList  = MapPrpList;
-    AsyncRequest->PrpListNo   = PrpListNo;
-    AsyncRequest->PrpListHost = PrpListHost;
+    AsyncRequest->PrpList     = PrpList;
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Private->AsyncPassThruQueue, &AsyncRequest->Link);
@@ -905,15 +1027,8 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
-    PciIo->Unmap (
-             PciIo,
-             MapPrpList
-             );
-  }
-
-  if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+  if (PrpList != NULL) {
+    NvmeReleasePrpList (Private, PrpList);
   }
 
   if (TimerEvent != NULL) {
@@ -17,6 +17,219 @@ extern EDKII_DEVICE_SECURITY_PROTOCOL  *mDeviceSecurityProtocol;
 #define SQUAD_ALIGN  0xFFFFFFFFFFFFFFFDULL
 #define DQUAD_ALIGN  0xFFFFFFFFFFFFFFFCULL
 
+//
+// The functions found by PciProbeDevicePresence() on segment 0, one bit per
+// function for every device of every probed bus.
+//
+BOOLEAN  mPciBusProbed[PCI_MAX_BUS + 1];
+UINT8    mPciFunctionPresent[PCI_MAX_BUS + 1][PCI_MAX_DEVICE + 1];
+
+typedef struct {
+  UINT64             EcamBase;
+  UINT8              Bus[PCI_MAX_BUS + 1];
+  UINT32             BusCount;
+  volatile UINT32    NextBus;
+} PCI_PRESENCE_PROBE_JOB;
+
+/**
+  Probe the buses of a presence probe job through ECAM until none is left.
+  The BSP and the APs all run this procedure at the same time.
+
+  Only memory-mapped configuration reads are done, which is safe on an AP.
+
+  @param Buffer   Pointer to the PCI_PRESENCE_PROBE_JOB.
+
+**/
+VOID
+EFIAPI
+PciProbeBusProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  PCI_PRESENCE_PROBE_JOB  *Job;
+  UINT32                  Index;
+  UINT8                   Bus;
+  UINT8                   Device;
+  UINT8                   Func;
+  UINT8                   Present;
+  UINTN                   Address;
+
+  Job = (PCI_PRESENCE_PROBE_JOB *)Buffer;
+
+  for (Index = InterlockedIncrement (&Job->NextBus) - 1;
+       Index < Job->BusCount;
+       Index = InterlockedIncrement (&Job->NextBus) - 1)
+  {
+    Bus = Job->Bus[Index];
+    for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
+      Present = 0;
+      for (Func = 0; Func <= PCI_MAX_FUNC; Func++) {
+        Address = (UINTN)(Job->EcamBase + PCI_ECAM_ADDRESS (Bus, Device, Func, 0));
+        if (MmioRead16 (Address + PCI_VENDOR_ID_OFFSET) == 0xffff) {
+          if (Func == 0) {
+            break;
+          }
+
+          continue;
+        }
+
+        Present |= (UINT8)(1 << Func);
+
+        if ((Func == 0) &&
+            ((MmioRead8 (Address + PCI_HEADER_TYPE_OFFSET) & HEADER_TYPE_MULTI_FUNCTION) == 0))
+        {
+          break;
+        }
+      }
+
+      mPciFunctionPresent[Bus][Device] = Present;
+    }
+  }
+}
+
+/**
+  Find the PCI functions present on the segment 0 buses of all root bridges
+  of a host bridge, before their resources are collected.
+
+  The buses are probed through the memory-mapped configuration space at
+  PcdPciExpressBaseAddress, by the BSP and, when the MP services are
+  available, all enabled APs at the same time. PciDevicePresent() then skips
+  the root bridge configuration reads for the functions found absent.
+
+  This does nothing unless PcdPciBusParallelProbe is TRUE. It must only be
+  called once all bus numbers are assigned.
+
+  @param PciResAlloc   Pointer to protocol instance of EFI_PCI_HOST_BRIDGE_RESOURCE_ALLOCATION_PROTOCOL.
+
+**/
+VOID
+PciProbeDevicePresence (
+  IN EFI_PCI_HOST_BRIDGE_RESOURCE_ALLOCATION_PROTOCOL  *PciResAlloc
+  )
+{
+  EFI_STATUS                         Status;
+  PCI_PRESENCE_PROBE_JOB             *Job;
+  EFI_HANDLE                         RootBridgeHandle;
+  EFI_PCI_ROOT_BRIDGE_IO_PROTOCOL    *PciRootBridgeIo;
+  EFI_ACPI_ADDRESS_SPACE_DESCRIPTOR  *Descriptors;
+  UINT16                             MinBus;
+  UINT16                             MaxBus;
+  UINT16                             Bus;
+  UINT64                             EcamBusCount;
+  EFI_MP_SERVICES_PROTOCOL           *MpServices;
+  EFI_EVENT                          WaitEvent;
+  UINT32                             Index;
+
+  PciInvalidateDevicePresence ();
+
+  if (!FeaturePcdGet (PcdPciBusParallelProbe)) {
+    return;
+  }
+
+  Job = AllocateZeroPool (sizeof (PCI_PRESENCE_PROBE_JOB));
+  if (Job == NULL) {
+    return;
+  }
+
+  Job->EcamBase = PcdGet64 (PcdPciExpressBaseAddress);
+  EcamBusCount  = RShiftU64 (PcdGet64 (PcdPciExpressBaseSize), 20);
+
+  RootBridgeHandle = NULL;
+  while (PciResAlloc->GetNextRootBridge (PciResAlloc, &RootBridgeHandle) == EFI_SUCCESS) {
+    Status = gBS->HandleProtocol (
+                    RootBridgeHandle,
+                    &gEfiPciRootBridgeIoProtocolGuid,
+                    (VOID **)&PciRootBridgeIo
+                    );
+    if (EFI_ERROR (Status) || (PciRootBridgeIo->SegmentNumber != 0)) {
+      continue;
+    }
+
+    Status = PciRootBridgeIo->Configuration (PciRootBridgeIo, (VOID **)&Descriptors);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    while (PciGetBusRange (&Descriptors, &MinBus, &MaxBus, NULL) == EFI_SUCCESS) {
+      for (Bus = MinBus; (Bus <= MaxBus) && (Bus <= PCI_MAX_BUS) && (Bus < EcamBusCount); Bus++) {
+        if (!mPciBusProbed[Bus]) {
+          mPciBusProbed[Bus]        = TRUE;
+          Job->Bus[Job->BusCount++] = (UINT8)Bus;
+        }
+      }
+
+      Descriptors++;
+    }
+  }
+
+  //
+  // Only trust the map once all the buses are probed.
+  //
+  PciInvalidateDevicePresence ();
+
+  if (Job->BusCount == 0) {
+    FreePool (Job);
+    return;
+  }
+
+  MpServices = NULL;
+  WaitEvent  = NULL;
+  if (Job->BusCount > 1) {
+    Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+    if (EFI_ERROR (Status)) {
+      MpServices = NULL;
+    }
+  }
+
+  if (MpServices != NULL) {
+    Status = gBS->CreateEvent (0, 0, NULL, NULL, &WaitEvent);
+    if (EFI_ERROR (Status)) {
+      //
+      // Without the event, StartupAllAPs() blocks until the APs are done, and
+      // the BSP only finds the remaining buses, if any, afterwards.
+      //
+      WaitEvent = NULL;
+    }
+
+    Status = MpServices->StartupAllAPs (MpServices, PciProbeBusProcedure, FALSE, WaitEvent, 0, Job, NULL);
+    if (EFI_ERROR (Status) && (Status != EFI_NOT_STARTED)) {
+      DEBUG ((DEBUG_WARN, "%a: APs not started - %r\n", __FUNCTION__, Status));
+    }
+  }
+
+  PciProbeBusProcedure (Job);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      while (gBS->CheckEvent (WaitEvent) == EFI_NOT_READY) {
+        CpuPause ();
+      }
+    }
+
+    gBS->CloseEvent (WaitEvent);
+  }
+
+  for (Index = 0; Index < Job->BusCount; Index++) {
+    mPciBusProbed[Job->Bus[Index]] = TRUE;
+  }
+
+  DEBUG ((DEBUG_INFO, "PciBus: Probed %d buses for present functions\n", Job->BusCount));
+  FreePool (Job);
+}
+
+/**
+  Forget the functions found by PciProbeDevicePresence(), so that
+  PciDevicePresent() reads the configuration space of every function again.
+
+**/
+VOID
+PciInvalidateDevicePresence (
+  VOID
+  )
+{
+  ZeroMem (mPciBusProbed, sizeof (mPciBusProbed));
+}
+
 /**
   This routine is used to check whether the pci device is present.
 
@@ -42,6 +255,15 @@ PciDevicePresent (
   UINT64      Address;
   EFI_STATUS  Status;
 
+  //
+  // Skip the functions that the presence probe found absent
+  //
+  if ((PciRootBridgeIo->SegmentNumber == 0) && mPciBusProbed[Bus] &&
+      ((mPciFunctionPresent[Bus][Device] & (1 << Func)) == 0))
+  {
+    return EFI_NOT_FOUND;
+  }
+
   //
   // Create PCI address map in terms of Bus, Device and Func
   //
@@ -9,6 +9,31 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _EFI_PCI_ENUMERATOR_SUPPORT_H_
 #define _EFI_PCI_ENUMERATOR_SUPPORT_H_
 
+/**
+  Find the PCI functions present on the segment 0 buses of all root bridges
+  of a host bridge, before their resources are collected.
+
+  This does nothing unless PcdPciBusParallelProbe is TRUE. It must only be
+  called once all bus numbers are assigned.
+
+  @param PciResAlloc   Pointer to protocol instance of EFI_PCI_HOST_BRIDGE_RESOURCE_ALLOCATION_PROTOCOL.
+
+**/
+VOID
+PciProbeDevicePresence (
+  IN EFI_PCI_HOST_BRIDGE_RESOURCE_ALLOCATION_PROTOCOL  *PciResAlloc
+  );
+
+/**
+  Forget the functions found by PciProbeDevicePresence(), so that
+  PciDevicePresent() reads the configuration space of every function again.
+
+**/
+VOID
+PciInvalidateDevicePresence (
+  VOID
+  );
+
 /**
   This routine is used to check whether the pci device is present.
 
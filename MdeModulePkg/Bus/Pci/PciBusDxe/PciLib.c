@@ -1678,6 +1678,12 @@ PciHostBridgeEnumerator (
     return Status;
   }
 
+  //
+  // All bus numbers are assigned now, find the present functions ahead of
+  // the resource collection if the platform asks for it
+  //
+  PciProbeDevicePresence (PciResAlloc);
+
   RootBridgeHandle = NULL;
   while (PciResAlloc->GetNextRootBridge (PciResAlloc, &RootBridgeHandle) == EFI_SUCCESS) {
     //
@@ -1686,26 +1692,27 @@ PciHostBridgeEnumerator (
     RootBridgeDev = CreateRootBridge (RootBridgeHandle);
 
     if (RootBridgeDev == NULL) {
-      return EFI_OUT_OF_RESOURCES;
+      Status = EFI_OUT_OF_RESOURCES;
+      break;
     }
 
     Status = StartManagingRootBridge (RootBridgeDev);
 
     if (EFI_ERROR (Status)) {
-      return Status;
+      break;
     }
 
     PciRootBridgeIo = RootBridgeDev->PciRootBridgeIo;
     Status          = PciRootBridgeIo->Configuration (PciRootBridgeIo, (VOID **)&Descriptors);
 
     if (EFI_ERROR (Status)) {
-      return Status;
+      break;
     }
 
     Status = PciGetBusRange (&Descriptors, &MinBus, NULL, NULL);
 
     if (EFI_ERROR (Status)) {
-      return Status;
+      break;
     }
 
     //
@@ -1728,7 +1735,7 @@ PciHostBridgeEnumerator (
                );
 
     if (EFI_ERROR (Status)) {
-      return Status;
+      break;
     }
 
     InsertRootBridge (RootBridgeDev);
@@ -1739,6 +1746,12 @@ PciHostBridgeEnumerator (
     AddHostBridgeEnumerator (RootBridgeDev->PciRootBridgeIo->ParentHandle);
   }
 
+  PciInvalidateDevicePresence ();
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   return EFI_SUCCESS;
 }
 
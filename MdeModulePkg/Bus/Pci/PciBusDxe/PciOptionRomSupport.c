@@ -8,6 +8,27 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PciBus.h"
 
+//
+// The size of the ROM BAR samples compared before an option ROM already read
+// from an identical device is shared.
+//
+#define OPROM_SHARE_SAMPLE_SIZE  SIZE_4KB
+
+typedef struct {
+  UINT16    VendorId;
+  UINT16    DeviceId;
+  UINT8     RevisionId;
+  UINT8     ClassCode[3];
+  UINT16    SubsystemVendorId;
+  UINT16    SubsystemId;
+  UINT64    RomImageSize;
+  UINT8     *RomImage;
+} PCI_LOADED_OPROM;
+
+UINTN             mNumberOfLoadedOpRoms    = 0;
+UINTN             mMaxNumberOfLoadedOpRoms = 0;
+PCI_LOADED_OPROM  *mLoadedOpRomTable       = NULL;
+
 /**
   Load the EFI Image from Option ROM
 
@@ -364,6 +385,173 @@ ContainEfiImage (
   return FALSE;
 }
 
+/**
+  Check whether the option ROM of a device matches a loaded option ROM, over
+  one sample of the ROM BAR.
+
+  @param PciDevice     Pci device instance, with its ROM BAR decoded.
+  @param RomBar        Base address the ROM BAR is decoded at.
+  @param RomImage      The loaded option ROM.
+  @param Offset        The offset of the sample.
+  @param Length        The length of the sample, a multiple of 4.
+  @param Sample        A buffer of at least Length bytes.
+
+  @retval TRUE   The sample matches.
+  @retval FALSE  The sample does not match, or could not be read.
+
+**/
+STATIC
+BOOLEAN
+OpRomSampleMatches (
+  IN PCI_IO_DEVICE  *PciDevice,
+  IN UINT32         RomBar,
+  IN UINT8          *RomImage,
+  IN UINT32         Offset,
+  IN UINT32         Length,
+  IN UINT8          *Sample
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = PciDevice->PciRootBridgeIo->Mem.Read (
+                                             PciDevice->PciRootBridgeIo,
+                                             EfiPciWidthUint32,
+                                             RomBar + Offset,
+                                             Length / sizeof (UINT32),
+                                             Sample
+                                             );
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(CompareMem (Sample, RomImage + Offset, Length) == 0);
+}
+
+/**
+  Find an option ROM already read from an identical device, so that it can be
+  shared instead of reading the whole ROM BAR again.
+
+  A loaded option ROM only matches if the vendor, device, revision, class and
+  subsystem IDs and the image size are the same, and the first and the last
+  OPROM_SHARE_SAMPLE_SIZE bytes of the ROM BAR are identical.
+
+  @param PciDevice     Pci device instance, with its ROM BAR decoded.
+  @param RomBar        Base address the ROM BAR is decoded at.
+  @param RomImageSize  The size of the option ROM images of the device.
+
+  @return The matching loaded option ROM, or NULL if there is none or
+          PcdPciOptionRomShareEnable is FALSE.
+
+**/
+STATIC
+UINT8 *
+FindLoadedOpRom (
+  IN PCI_IO_DEVICE  *PciDevice,
+  IN UINT32         RomBar,
+  IN UINT64         RomImageSize
+  )
+{
+  UINTN             Index;
+  PCI_LOADED_OPROM  *Entry;
+  UINT8             *Sample;
+  UINT32            SampleSize;
+  UINT8             *RomImage;
+
+  if (!FeaturePcdGet (PcdPciOptionRomShareEnable) || IS_PCI_BRIDGE (&PciDevice->Pci)) {
+    return NULL;
+  }
+
+  SampleSize = (UINT32)MIN (RomImageSize, OPROM_SHARE_SAMPLE_SIZE);
+  Sample     = NULL;
+  RomImage   = NULL;
+
+  for (Index = 0; Index < mNumberOfLoadedOpRoms; Index++) {
+    Entry = &mLoadedOpRomTable[Index];
+    if ((Entry->VendorId != PciDevice->Pci.Hdr.VendorId) ||
+        (Entry->DeviceId != PciDevice->Pci.Hdr.DeviceId) ||
+        (Entry->RevisionId != PciDevice->Pci.Hdr.RevisionID) ||
+        (CompareMem (Entry->ClassCode, PciDevice->Pci.Hdr.ClassCode, sizeof (Entry->ClassCode)) != 0) ||
+        (Entry->SubsystemVendorId != PciDevice->Pci.Device.SubsystemVendorID) ||
+        (Entry->SubsystemId != PciDevice->Pci.Device.SubsystemID) ||
+        (Entry->RomImageSize != RomImageSize))
+    {
+      continue;
+    }
+
+    if (Sample == NULL) {
+      Sample = AllocatePool (SampleSize);
+      if (Sample == NULL) {
+        return NULL;
+      }
+    }
+
+    if (OpRomSampleMatches (PciDevice, RomBar, Entry->RomImage, 0, SampleSize, Sample) &&
+        OpRomSampleMatches (PciDevice, RomBar, Entry->RomImage, (UINT32)RomImageSize - SampleSize, SampleSize, Sample))
+    {
+      RomImage = Entry->RomImage;
+      break;
+    }
+  }
+
+  if (Sample != NULL) {
+    FreePool (Sample);
+  }
+
+  return RomImage;
+}
+
+/**
+  Record an option ROM read from a device, so that identical devices can
+  share it.
+
+  @param PciDevice     Pci device instance.
+  @param RomImage      The option ROM read from the device.
+  @param RomImageSize  The size of the option ROM.
+
+**/
+STATIC
+VOID
+AddLoadedOpRom (
+  IN PCI_IO_DEVICE  *PciDevice,
+  IN UINT8          *RomImage,
+  IN UINT64         RomImageSize
+  )
+{
+  PCI_LOADED_OPROM  *NewTable;
+  PCI_LOADED_OPROM  *Entry;
+
+  if (!FeaturePcdGet (PcdPciOptionRomShareEnable) || IS_PCI_BRIDGE (&PciDevice->Pci)) {
+    return;
+  }
+
+  //
+  // Loaded option ROM table buffer needs to grow.
+  //
+  if (mNumberOfLoadedOpRoms == mMaxNumberOfLoadedOpRoms) {
+    NewTable = ReallocatePool (
+                 mMaxNumberOfLoadedOpRoms * sizeof (PCI_LOADED_OPROM),
+                 (mMaxNumberOfLoadedOpRoms + 0x20) * sizeof (PCI_LOADED_OPROM),
+                 mLoadedOpRomTable
+                 );
+    if (NewTable == NULL) {
+      return;
+    }
+
+    mLoadedOpRomTable         = NewTable;
+    mMaxNumberOfLoadedOpRoms += 0x20;
+  }
+
+  Entry                    = &mLoadedOpRomTable[mNumberOfLoadedOpRoms++];
+  Entry->VendorId          = PciDevice->Pci.Hdr.VendorId;
+  Entry->DeviceId          = PciDevice->Pci.Hdr.DeviceId;
+  Entry->RevisionId        = PciDevice->Pci.Hdr.RevisionID;
+  CopyMem (Entry->ClassCode, PciDevice->Pci.Hdr.ClassCode, sizeof (Entry->ClassCode));
+  Entry->SubsystemVendorId = PciDevice->Pci.Device.SubsystemVendorID;
+  Entry->SubsystemId       = PciDevice->Pci.Device.SubsystemID;
+  Entry->RomImageSize      = RomImageSize;
+  Entry->RomImage          = RomImage;
+}
+
 /**
   Load Option Rom image for specified PCI device.
 
@@ -518,7 +706,16 @@ LoadOpRomImage (
 
   if (RomImageSize > 0) {
     RetStatus = EFI_SUCCESS;
-    Image     = AllocatePool ((UINT32)RomImageSize);
+
+    //
+    // Share the option ROM already read from an identical device, if any.
+    // Option ROM buffers are never freed, so they can be shared.
+    //
+    RomInMemory = FindLoadedOpRom (PciDevice, RomBar, RomImageSize);
+  }
+
+  if ((RomImageSize > 0) && (RomInMemory == NULL)) {
+    Image = AllocatePool ((UINT32)RomImageSize);
     if (Image == NULL) {
       RomDecode (PciDevice, RomBarIndex, RomBar, FALSE);
       FreePool (RomHeader);
@@ -537,6 +734,7 @@ LoadOpRomImage (
                                       Image
                                       );
     RomInMemory = Image;
+    AddLoadedOpRom (PciDevice, RomInMemory, RomImageSize);
   }
 
   RomDecode (PciDevice, RomBarIndex, RomBar, FALSE);
@@ -215,6 +215,7 @@ struct _USB_XHCI_INSTANCE {
   XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
   XHC_HCSPARAMS2              HcSParams2; ///< Structural Parameters 2
   XHC_HCCPARAMS               HcCParams;  ///< Capability Parameters
+  UINT16                      HcVersion;  ///< Interface Version Number
   UINT32                      DBOff;      ///< Doorbell Offset
   UINT32                      RTSOff;     ///< Runtime Register Space Offset
   UINT16                      MaxInterrupt;
@@ -204,6 +204,47 @@ XhcFreeUrb (
   FreePool (Urb);
 }
 
+/**
+  Calculate the TD Size field of a Normal TRB, as described in 4.11.2.4 of the
+  xHCI specification.
+
+  @param  Xhc          The XHCI Instance.
+  @param  Urb          The urb the TRB belongs to.
+  @param  Transferred  The number of bytes covered by the earlier TRBs of the TD.
+  @param  TrbLen       The number of bytes covered by this TRB.
+
+  @return The TD Size field value.
+
+**/
+UINT32
+XhcCalcTdSize (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb,
+  IN UINTN              Transferred,
+  IN UINTN              TrbLen
+  )
+{
+  UINTN  Remainder;
+  UINTN  TotalPackets;
+
+  if (Xhc->HcVersion < 0x100) {
+    //
+    // xHCI 0.96 counts the remaining bytes, including this TRB, in 1KB units.
+    //
+    Remainder = (Urb->DataLen - Transferred) >> 10;
+  } else if ((Transferred + TrbLen == Urb->DataLen) || (Urb->Ep.MaxPacket == 0)) {
+    Remainder = 0;
+  } else {
+    //
+    // xHCI 1.0 counts the packets remaining after this TRB.
+    //
+    TotalPackets = (Urb->DataLen + Urb->Ep.MaxPacket - 1) / Urb->Ep.MaxPacket;
+    Remainder    = TotalPackets - (Transferred + TrbLen) / Urb->Ep.MaxPacket;
+  }
+
+  return (UINT32)MIN (Remainder, 31);
+}
+
 /**
   Create a transfer TRB.
 
@@ -228,6 +269,7 @@ XhcCreateTransferTrb (
   UINTN                          TotalLen;
   UINTN                          Len;
   UINTN                          TrbNum;
+  UINTN                          FreeTrbNum;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   VOID                           *Map;
@@ -381,26 +423,63 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // The whole transfer is a single TD: one Normal TRB per 64KB aligned
+      // piece of the data buffer, chained together, with only the last one
+      // generating a completion event. A short packet ends the TD early, and
+      // is reported through the ISP flag of the TRB it happened in.
+      //
+      PhyAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)Urb->DataPhy;
+      TrbNum  = 1;
+      if (Urb->DataLen > 0) {
+        TrbNum = (UINTN)(RShiftU64 (PhyAddr + Urb->DataLen - 1, 16) - RShiftU64 (PhyAddr, 16)) + 1;
+      }
+
+      if (TrbNum >= EPRing->TrbNumber) {
+        DEBUG ((DEBUG_ERROR, "XhcCreateTransferTrb: %d bytes do not fit in the transfer ring!\n", Urb->DataLen));
+        return EFI_INVALID_PARAMETER;
+      }
+
+      //
+      // Keep the TD clear of the Link TRB, so that it doesn't have to be cut
+      // at a TD fragment boundary (4.11.7.1): fill the end of the ring with
+      // No Op TRBs if the TD doesn't fit there.
+      //
+      FreeTrbNum = EPRing->TrbNumber - 1 - ((UINTN)EPRing->RingEnqueue - (UINTN)EPRing->RingSeg0) / sizeof (TRB_TEMPLATE);
+      if (TrbNum > FreeTrbNum) {
+        while (FreeTrbNum-- > 0) {
+          TrbStart                     = (TRB *)(UINTN)EPRing->RingEnqueue;
+          TrbStart->TrbNormal.Type     = TRB_TYPE_NO_OP;
+          TrbStart->TrbNormal.CycleBit = EPRing->RingPCS & BIT0;
+          XhcSyncTrsRing (Xhc, EPRing);
+        }
+
+        Urb->TrbStart = EPRing->RingEnqueue;
+      }
+
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
       TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
-      while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
-          Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
-        }
+      do {
+        Len = MIN (Urb->DataLen - TotalLen, SIZE_64KB - ((UINTN)PhyAddr & (SIZE_64KB - 1)));
 
         TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
-        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
-        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
+        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT (PhyAddr);
+        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT (PhyAddr);
         TrbStart->TrbNormal.Length    = (UINT32)Len;
-        TrbStart->TrbNormal.TDSize    = 0;
+        TrbStart->TrbNormal.TDSize    = XhcCalcTdSize (Xhc, Urb, TotalLen, Len);
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
+        if (TotalLen + Len < Urb->DataLen) {
+          TrbStart->TrbNormal.CH  = 1;
+          TrbStart->TrbNormal.IOC = 0;
+        } else {
+          TrbStart->TrbNormal.CH  = 0;
+          TrbStart->TrbNormal.IOC = 1;
+        }
+
         //
         // Update the cycle bit
         //
@@ -409,10 +488,15 @@ XhcCreateTransferTrb (
         XhcSyncTrsRing (Xhc, EPRing);
         TrbNum++;
         TotalLen += Len;
-      }
+        PhyAddr  += Len;
+      } while (TotalLen < Urb->DataLen);
 
-      Urb->TrbNum = TrbNum;
-      Urb->TrbEnd = (TRB_TEMPLATE *)(UINTN)TrbStart;
+      //
+      // Only the last TRB reports the completion of the TD.
+      //
+      Urb->StartDone = TRUE;
+      Urb->TrbNum    = TrbNum;
+      Urb->TrbEnd    = (TRB_TEMPLATE *)(UINTN)TrbStart;
       break;
 
     case ED_INTERRUPT_OUT:
@@ -805,6 +889,8 @@ CreateEventRing (
   EventRing->EventRingDequeue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
   EventRing->EventRingEnqueue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
 
+  EventRing->EventRingDequeueReported = EventRing->EventRingDequeue;
+
   DequeuePhy = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Buf, Size);
 
   //
@@ -1105,9 +1191,6 @@ XhcCheckUrbResult (
   EFI_STATUS            Status;
   URB                   *AsyncUrb;
   URB                   *CheckedUrb;
-  UINT64                XhcDequeue;
-  UINT32                High;
-  UINT32                Low;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
@@ -1168,6 +1251,13 @@ XhcCheckUrbResult (
       continue;
     }
 
+    if (CheckedUrb->Finished) {
+      //
+      // Some host controllers report a short packet in a chained TD twice.
+      //
+      continue;
+    }
+
     switch (EvtTrb->Completecode) {
       case TRB_COMPLETION_STALL_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_STALL;
@@ -1210,9 +1300,27 @@ XhcCheckUrbResult (
         }
 
         TRBType = (UINT8)(TRBPtr->Type);
-        if ((TRBType == TRB_TYPE_DATA_STAGE) ||
-            (TRBType == TRB_TYPE_NORMAL) ||
-            (TRBType == TRB_TYPE_ISOCH))
+        if ((EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) &&
+            (TRBType == TRB_TYPE_NORMAL) && (((TRANSFER_TRB_NORMAL *)TRBPtr)->CH != 0))
+        {
+          //
+          // A short packet in a chained TD. The xHC skips the rest of the TD,
+          // the transfer ends at this TRB.
+          //
+          PhyAddr               = (EFI_PHYSICAL_ADDRESS)(((TRANSFER_TRB_NORMAL *)TRBPtr)->TRBPtrLo | LShiftU64 ((UINT64)((TRANSFER_TRB_NORMAL *)TRBPtr)->TRBPtrHi, 32));
+          CheckedUrb->Completed = (UINTN)(PhyAddr - (EFI_PHYSICAL_ADDRESS)(UINTN)CheckedUrb->DataPhy) +
+                                  ((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length;
+          CheckedUrb->EndDone   = TRUE;
+        } else if ((TRBType == TRB_TYPE_NORMAL) && (TRBPtr == CheckedUrb->TrbEnd) &&
+                   (((TRANSFER_TRB_NORMAL *)CheckedUrb->TrbStart)->CH != 0))
+        {
+          //
+          // The end of a chained TD: all the TRBs before this one completed.
+          //
+          CheckedUrb->Completed = CheckedUrb->DataLen - EvtTrb->Length;
+        } else if ((TRBType == TRB_TYPE_DATA_STAGE) ||
+                   (TRBType == TRB_TYPE_NORMAL) ||
+                   (TRBType == TRB_TYPE_ISOCH))
         {
           CheckedUrb->Completed += (((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length);
         }
@@ -1246,24 +1354,20 @@ XhcCheckUrbResult (
 EXIT:
 
   //
-  // Advance event ring to last available entry
+  // Advance event ring to last available entry. Only the software writes the
+  // dequeue pointer, so there is no need to read it back from the ERDP
+  // register on every poll.
   //
-  // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
-  // So divide it to two 32-bytes width register access.
-  //
-  Low        = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET);
-  High       = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4);
-  XhcDequeue = (UINT64)(LShiftU64 ((UINT64)High, 32) | Low);
-
-  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
+  if (Xhc->EventRing.EventRingDequeueReported != Xhc->EventRing.EventRingDequeue) {
+    PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
 
-  if ((XhcDequeue & (~0x0F)) != (PhyAddr & (~0x0F))) {
     //
     // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
     // So divide it to two 32-bytes width register access.
     //
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET, XHC_LOW_32BIT (PhyAddr) | BIT3);
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4, XHC_HIGH_32BIT (PhyAddr));
+    Xhc->EventRing.EventRingDequeueReported = Xhc->EventRing.EventRingDequeue;
   }
 
   return Urb->Finished;
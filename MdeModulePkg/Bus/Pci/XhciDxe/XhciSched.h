@@ -153,6 +153,10 @@ typedef struct _EVENT_RING {
   TRB_TEMPLATE    *EventRingEnqueue;
   TRB_TEMPLATE    *EventRingDequeue;
   UINT32          EventRingCCS;
+  //
+  // The dequeue pointer last written to the ERDP register.
+  //
+  TRB_TEMPLATE    *EventRingDequeueReported;
 } EVENT_RING;
 
 //
@@ -1458,6 +1462,26 @@ XhcFreeUrb (
   IN URB                *Urb
   );
 
+/**
+  Calculate the TD Size field of a Normal TRB, as described in 4.11.2.4 of the
+  xHCI specification.
+
+  @param  Xhc          The XHCI Instance.
+  @param  Urb          The urb the TRB belongs to.
+  @param  Transferred  The number of bytes covered by the earlier TRBs of the TD.
+  @param  TrbLen       The number of bytes covered by this TRB.
+
+  @return The TD Size field value.
+
+**/
+UINT32
+XhcCalcTdSize (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb,
+  IN UINTN              Transferred,
+  IN UINTN              TrbLen
+  );
+
 /**
   Create a transfer TRB.
 
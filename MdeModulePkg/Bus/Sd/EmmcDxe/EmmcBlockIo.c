@@ -886,6 +886,8 @@ EmmcReadWrite (
 
   //
   // Start to execute data transfer. The max block number in single cmd is 65535 blocks.
+  // Each chunk costs one CMD23 and one CMD18/CMD25, so a large request is already
+  // moved with few commands; the command queueing engine is not used.
   //
   Remaining = BlockNum;
   MaxBlock  = 0xFFFF;
@@ -63,6 +63,12 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
 
   VOID                                  *UtpTrlBase;
   UINT8                                 Nutrs;
+  //
+  // Slots handed out by UfsFindAvailableSlotInTrl() and not yet stopped.
+  // A slot stays reserved until its completion is processed, after the
+  // doorbell bit has already been cleared by the host controller.
+  //
+  UINT32                                TrlSlotsInUse;
   VOID                                  *TrlMapping;
   VOID                                  *UtpTmrlBase;
   UINT8                                 Nutmrs;
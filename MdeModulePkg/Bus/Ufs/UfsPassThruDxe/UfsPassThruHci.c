@@ -724,26 +724,54 @@ UfsFindAvailableSlotInTrl (
   UINT8       Index;
   UINT32      Data;
   EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
+    gBS->RestoreTPL (OldTpl);
     return Status;
   }
 
+  Data |= Private->TrlSlotsInUse;
   Nutrs = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
 
   for (Index = 0; Index < Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
+      Private->TrlSlotsInUse |= BIT0 << Index;
+      gBS->RestoreTPL (OldTpl);
       *Slot = Index;
       return EFI_SUCCESS;
     }
   }
 
+  gBS->RestoreTPL (OldTpl);
   return EFI_NOT_READY;
 }
 
+/**
+  Return a slot found by UfsFindAvailableSlotInTrl() to the free slots.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be released.
+
+**/
+VOID
+UfsReleaseSlotInTrl (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl                  = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->TrlSlotsInUse &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Start specified slot in transfer list of a UFS device.
 
@@ -796,6 +824,11 @@ UfsStopExecCmd (
   UINT32      Data;
   EFI_STATUS  Status;
 
+  //
+  // The doorbell bit keeps the slot from being handed out again until it is cleared.
+  //
+  UfsReleaseSlotInTrl (Private, Slot);
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -924,6 +957,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -940,7 +974,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -1275,6 +1309,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD *)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -1519,6 +1554,7 @@ UfsExecScsiCmds (
   //
   Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
   if (EFI_ERROR (Status)) {
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1536,6 +1572,8 @@ UfsExecScsiCmds (
              &TransReq->CmdDescMapping
              );
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, TransReq->Slot);
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1543,6 +1581,7 @@ UfsExecScsiCmds (
 
   Status = UfsPrepareDataTransferBuffer (Private, TransReq);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, TransReq->Slot);
     goto Exit1;
   }
 
@@ -652,6 +652,9 @@ UsbFindChild (
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
   @param  ResetIsNeeded         The boolean to control whether skip the reset of the port.
+  @param  WaitPortStable        The boolean to control whether to wait for the
+                                connection to be stable. FALSE if the caller
+                                already waited after detecting the connection.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -662,7 +665,8 @@ EFI_STATUS
 UsbEnumerateNewDev (
   IN USB_INTERFACE  *HubIf,
   IN UINT8          Port,
-  IN BOOLEAN        ResetIsNeeded
+  IN BOOLEAN        ResetIsNeeded,
+  IN BOOLEAN        WaitPortStable
   )
 {
   USB_BUS              *Bus;
@@ -679,7 +683,9 @@ UsbEnumerateNewDev (
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  if (WaitPortStable) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
 
   //
   // Hub resets the device for at least 10 milliseconds.
@@ -875,11 +881,50 @@ ON_ERROR:
   return Status;
 }
 
+/**
+  Check whether UsbEnumeratePort() will enumerate a new device on the port.
+
+  @param  HubIf                 The HUB that has the device connected.
+  @param  Port                  The port index of the hub (started with zero).
+
+  @retval TRUE                  A device is connected and the port has a change to process.
+  @retval FALSE                 No new device will be enumerated on the port.
+
+**/
+BOOLEAN
+UsbPortHasNewDevice (
+  IN USB_INTERFACE  *HubIf,
+  IN UINT8          Port
+  )
+{
+  EFI_USB_PORT_STATUS  PortState;
+  EFI_STATUS           Status;
+
+  Status = HubIf->HubApi->GetPortStatus (HubIf, Port, &PortState);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  if ((PortState.PortChangeStatus & (USB_PORT_STAT_C_CONNECTION | USB_PORT_STAT_C_ENABLE | USB_PORT_STAT_C_OVERCURRENT | USB_PORT_STAT_C_RESET)) == 0) {
+    return FALSE;
+  }
+
+  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT) &&
+      USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_OVERCURRENT))
+  {
+    return FALSE;
+  }
+
+  return USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION);
+}
+
 /**
   Process the events on the port.
 
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  WaitPortStable        The boolean to control whether to wait for the
+                                connection of a new device to be stable.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -889,7 +934,8 @@ ON_ERROR:
 EFI_STATUS
 UsbEnumeratePort (
   IN USB_INTERFACE  *HubIf,
-  IN UINT8          Port
+  IN UINT8          Port,
+  IN BOOLEAN        WaitPortStable
   )
 {
   USB_HUB_API          *HubApi;
@@ -988,9 +1034,9 @@ UsbEnumeratePort (
     //
     DEBUG ((DEBUG_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
     if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
+      Status = UsbEnumerateNewDev (HubIf, Port, FALSE, WaitPortStable);
     } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
+      Status = UsbEnumerateNewDev (HubIf, Port, TRUE, WaitPortStable);
     }
   } else {
     DEBUG ((DEBUG_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
@@ -1019,6 +1065,7 @@ UsbHubEnumeration (
   UINT8          Bit;
   UINT8          Index;
   USB_DEVICE     *Child;
+  BOOLEAN        NewDevice;
 
   ASSERT (Context != NULL);
 
@@ -1039,12 +1086,31 @@ UsbHubEnumeration (
   //
   // HUB starts its port index with 1.
   //
+  // Wait once for the connections on all changed ports to be stable,
+  // rather than once per newly connected device.
+  //
+  Byte      = 0;
+  Bit       = 1;
+  NewDevice = FALSE;
+
+  for (Index = 0; (Index < HubIf->NumOfPort) && !NewDevice; Index++) {
+    if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
+      NewDevice = UsbPortHasNewDevice (HubIf, Index);
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  if (NewDevice) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
+
   Byte = 0;
   Bit  = 1;
 
   for (Index = 0; Index < HubIf->NumOfPort; Index++) {
     if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
+      UsbEnumeratePort (HubIf, Index, FALSE);
     }
 
     USB_NEXT_BIT (Byte, Bit);
@@ -1074,8 +1140,10 @@ UsbRootHubEnumeration (
   USB_INTERFACE  *RootHub;
   UINT8          Index;
   USB_DEVICE     *Child;
+  BOOLEAN        NewDevice;
 
-  RootHub = (USB_INTERFACE *)Context;
+  RootHub   = (USB_INTERFACE *)Context;
+  NewDevice = FALSE;
 
   for (Index = 0; Index < RootHub->NumOfPort; Index++) {
     Child = UsbFindChild (RootHub, Index);
@@ -1084,6 +1152,20 @@ UsbRootHubEnumeration (
       UsbRemoveDevice (Child);
     }
 
-    UsbEnumeratePort (RootHub, Index);
+    if (!NewDevice) {
+      NewDevice = UsbPortHasNewDevice (RootHub, Index);
+    }
+  }
+
+  //
+  // Wait once for the connections on all ports to be stable, rather than
+  // once per newly connected device.
+  //
+  if (NewDevice) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
+
+  for (Index = 0; Index < RootHub->NumOfPort; Index++) {
+    UsbEnumeratePort (RootHub, Index, FALSE);
   }
 }
@@ -24,6 +24,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _USB_MASS_TRANSPORT  USB_MASS_TRANSPORT;
 typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
@@ -181,6 +182,7 @@ struct _USB_MASS_DEVICE {
   EFI_DISK_INFO_PROTOCOL      DiskInfo;
   USB_BOOT_INQUIRY_DATA       InquiryData;
   BOOLEAN                     Cdb16Byte;
+  UINT32                      MaxTransferSize; ///< Max bytes carried by one READ/WRITE command
 };
 
 #endif
@@ -59,7 +59,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define USB_PDT_SIMPLE_DIRECT  0x0E                ///< Simplified direct access device
 
 //
-// Other parameters, Max carried size is 64KB.
+// Other parameters, Max carried size is 64KB. Devices attached at SuperSpeed
+// may carry up to PcdUsbMassStorageSuperSpeedMaxTransferSize.
 //
 #define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
 
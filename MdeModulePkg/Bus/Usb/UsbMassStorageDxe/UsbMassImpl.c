@@ -323,6 +323,47 @@ UsbMassFlushBlocks (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the maximum number of bytes to carry with one READ/WRITE command.
+
+  Bulk endpoints of 1024 bytes mean that the device is attached at SuperSpeed
+  or faster, where the per-command overhead of the transport would dominate
+  with the 64KB transfers that are safe on slower devices.
+
+  @param  UsbIo                  The USB I/O Protocol instance of the device.
+
+  @return The maximum transfer size in bytes.
+
+**/
+UINT32
+UsbMassGetMaxTransferSize (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo
+  )
+{
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR   EndPoint;
+  EFI_STATUS                    Status;
+  UINT8                         Index;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    return USB_BOOT_MAX_CARRY_SIZE;
+  }
+
+  for (Index = 0; Index < Interface.NumEndpoints; Index++) {
+    Status = UsbIo->UsbGetEndpointDescriptor (UsbIo, Index, &EndPoint);
+    if (EFI_ERROR (Status) || !USB_IS_BULK_ENDPOINT (EndPoint.Attributes)) {
+      continue;
+    }
+
+    if (EndPoint.MaxPacketSize >= 1024) {
+      return MAX (PcdGet32 (PcdUsbMassStorageSuperSpeedMaxTransferSize), USB_BOOT_MAX_CARRY_SIZE);
+    }
+  }
+
+  return USB_BOOT_MAX_CARRY_SIZE;
+}
+
 /**
   Initialize the media parameter data for EFI_BLOCK_IO_MEDIA of Block I/O Protocol.
 
@@ -353,6 +394,8 @@ UsbMassInitMedia (
   Media->IoAlign          = 0;
   Media->MediaId          = 1;
 
+  UsbMass->MaxTransferSize = UsbMassGetMaxTransferSize (UsbMass->UsbIo);
+
   Status = UsbBootGetParams (UsbMass);
   DEBUG ((DEBUG_INFO, "UsbMassInitMedia: UsbBootGetParams (%r)\n", Status));
   if (Status == EFI_MEDIA_CHANGED) {
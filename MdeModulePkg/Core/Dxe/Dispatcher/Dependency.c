@@ -193,8 +193,9 @@ CorePreProcessDepex (
                                 was found.
 
 **/
+STATIC
 BOOLEAN
-CoreIsSchedulable (
+CoreEvaluateDepex (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   )
 {
@@ -431,3 +432,106 @@ CoreIsSchedulable (
 Done:
   return FALSE;
 }
+
+/**
+  Check whether a DEPEX that evaluated to FALSE may evaluate to TRUE now.
+
+  A PUSH opcode is rewritten to EFI_DEP_REPLACE_TRUE as soon as its protocol
+  is found, so the only opcodes whose value can still change are the PUSH
+  opcodes left in the DEPEX, and they can only change when their protocol is
+  installed. A NULL DEPEX waits on the architectural protocols, so any
+  install counts.
+
+  @param  DriverEntry           DriverEntry element whose DEPEX is FALSE.
+
+  @retval TRUE                  A protocol the DEPEX waits on was installed
+                                since the DEPEX was evaluated.
+  @retval FALSE                 The DEPEX is still FALSE.
+
+**/
+STATIC
+BOOLEAN
+CoreDepexMayBeSatisfied (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8     *Iterator;
+  EFI_GUID  DriverGuid;
+
+  if (CoreGetProtocolInstallKey (NULL) == DriverEntry->DepexInstallKey) {
+    return FALSE;
+  }
+
+  if (DriverEntry->Depex == NULL) {
+    return TRUE;
+  }
+
+  for (Iterator = DriverEntry->Depex;
+       ((UINTN)Iterator - (UINTN)DriverEntry->Depex) < DriverEntry->DepexSize;
+       Iterator++)
+  {
+    switch (*Iterator) {
+      case EFI_DEP_PUSH:
+        if (((UINTN)Iterator - (UINTN)DriverEntry->Depex) + sizeof (EFI_GUID) >= DriverEntry->DepexSize) {
+          return FALSE;
+        }
+
+        CopyMem (&DriverGuid, Iterator + 1, sizeof (EFI_GUID));
+        if (CoreGetProtocolInstallKey (&DriverGuid) > DriverEntry->DepexInstallKey) {
+          return TRUE;
+        }
+
+        Iterator += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_BEFORE:
+      case EFI_DEP_AFTER:
+      case EFI_DEP_REPLACE_TRUE:
+        Iterator += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_END:
+        return FALSE;
+
+      default:
+        break;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Check whether a driver can be scheduled. A DEPEX that evaluated to FALSE is
+  only evaluated again once a protocol it waits on has been installed, so a
+  dispatcher pass costs time in proportion to the newly satisfied
+  dependencies rather than to the number of pending drivers.
+
+  @param  DriverEntry           DriverEntry element to update.
+
+  @retval TRUE                  If driver is ready to run.
+  @retval FALSE                 If driver is not ready to run or some fatal error
+                                was found.
+
+**/
+BOOLEAN
+CoreIsSchedulable (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT64  InstallKey;
+
+  if (DriverEntry->DepexUnsatisfied && !CoreDepexMayBeSatisfied (DriverEntry)) {
+    return FALSE;
+  }
+
+  InstallKey = CoreGetProtocolInstallKey (NULL);
+  if (CoreEvaluateDepex (DriverEntry)) {
+    DriverEntry->DepexUnsatisfied = FALSE;
+    return TRUE;
+  }
+
+  DriverEntry->DepexUnsatisfied = TRUE;
+  DriverEntry->DepexInstallKey  = InstallKey;
+  return FALSE;
+}
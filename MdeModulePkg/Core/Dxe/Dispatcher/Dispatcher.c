@@ -243,6 +243,11 @@ CoreGetDepexSectionAndPreProccess (
 
   Fv = DriverEntry->Fv;
 
+  //
+  // A Depex read again has to be evaluated from scratch.
+  //
+  DriverEntry->DepexUnsatisfied = FALSE;
+
   //
   // Grab Depex info, it will never be free'ed.
   //
@@ -319,8 +324,9 @@ CoreSchedule (
       // Move the driver from the Unrequested to the Dependent state
       //
       CoreAcquireDispatcherLock ();
-      DriverEntry->Unrequested = FALSE;
-      DriverEntry->Dependent   = TRUE;
+      DriverEntry->Unrequested      = FALSE;
+      DriverEntry->Dependent        = TRUE;
+      DriverEntry->DepexUnsatisfied = FALSE;
       CoreReleaseDispatcherLock ();
 
       DEBUG ((DEBUG_DISPATCH, "Schedule FFS(%g) - EFI_SUCCESS\n", DriverName));
@@ -450,6 +456,11 @@ CoreDispatcher (
       // skip the LoadImage
       //
       if ((DriverEntry->ImageHandle == NULL) && !DriverEntry->IsFvImage) {
+        //
+        // Let idle APs decode the drivers queued behind this one while it loads.
+        //
+        CoreStartImagePrefetch (&mScheduledQueue);
+
         DEBUG ((DEBUG_INFO, "Loading driver %g\n", &DriverEntry->FileName));
         Status = CoreLoadImage (
                    FALSE,
@@ -493,6 +504,11 @@ CoreDispatcher (
         }
       }
 
+      //
+      // The driver may use the MP Services Protocol, so retire prefetch work first.
+      //
+      CoreWaitForImagePrefetch ();
+
       CoreAcquireDispatcherLock ();
 
       DriverEntry->Scheduled   = FALSE;
@@ -515,6 +531,11 @@ CoreDispatcher (
           );
         ASSERT (DriverEntry->ImageHandle != NULL);
 
+        //
+        // Entry points run one at a time on the BSP, in the scheduled order:
+        // they call boot services, which may only be used on the BSP. Only
+        // the decoding of the queued images is handed to the APs above.
+        //
         Status = CoreStartImage (DriverEntry->ImageHandle, NULL, NULL);
 
         REPORT_STATUS_CODE_WITH_EXTENDED_DATA (
@@ -566,6 +587,8 @@ CoreDispatcher (
     }
   } while (ReadyToRun);
 
+  CoreFlushImagePrefetch ();
+
   //
   // Close DXE dispatch Event
   //
@@ -0,0 +1,649 @@
+/** @file
+  DXE Dispatcher image prefetch.
+
+  While the BSP loads the driver at the head of the scheduled queue, the
+  drivers queued behind it can have their compressed or GUIDed encapsulation
+  decoded on application processors through the MP Services Protocol. The
+  BSP reads the raw file and allocates every buffer up front, so the AP only
+  runs the decoder over memory that it owns exclusively. All outstanding work
+  is retired before the BSP calls a driver entry point, so drivers never find
+  the APs busy on behalf of the dispatcher.
+
+  Only the layouts that the section extraction code would resolve to the very
+  same PE32 section are handled: the first encapsulation section in the file
+  precedes any PE32 section, and the decoded stream holds a PE32 section ahead
+  of any further encapsulation. Every other file takes the regular path in
+  CoreLoadImage ().
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+#define IMAGE_PREFETCH_JOB_SIGNATURE  SIGNATURE_32('i','p','f','j')
+
+typedef struct {
+  UINTN                        Signature;
+  LIST_ENTRY                   Link;
+  EFI_CORE_DRIVER_ENTRY        *DriverEntry;
+  EFI_EVENT                    WaitEvent;
+  UINTN                        ProcessorNumber;
+  BOOLEAN                      Running;
+  //
+  // Raw file contents, read by the BSP.
+  //
+  VOID                         *FileBuffer;
+  UINT32                       FvAuthenticationStatus;
+  //
+  // The encapsulation section to decode and the buffers the AP decodes into.
+  //
+  EFI_COMMON_SECTION_HEADER    *Section;
+  VOID                         *OutputBuffer;
+  UINT32                       OutputSize;
+  VOID                         *ScratchBuffer;
+  UINT32                       ScratchSize;
+  //
+  // Results written by the AP.
+  //
+  VOID                         *DecodedBuffer;
+  UINT32                       AuthenticationStatus;
+  EFI_STATUS                   Status;
+} IMAGE_PREFETCH_JOB;
+
+//
+// Prefetch jobs, both running and completed. List of IMAGE_PREFETCH_JOB.
+//
+LIST_ENTRY  mImagePrefetchJobs = INITIALIZE_LIST_HEAD_VARIABLE (mImagePrefetchJobs);
+
+EFI_MP_SERVICES_PROTOCOL  *mImagePrefetchMpServices = NULL;
+UINTN                     mImagePrefetchBspNumber;
+UINTN                     mImagePrefetchProcessorCount;
+
+/**
+  Return the size of the section header preceding the section data.
+
+  @param  Section               The section.
+
+  @return The size of the common section header, in bytes.
+
+**/
+STATIC
+UINT32
+CoreImagePrefetchSectionHeaderSize (
+  IN EFI_COMMON_SECTION_HEADER  *Section
+  )
+{
+  return IS_SECTION2 (Section) ? sizeof (EFI_COMMON_SECTION_HEADER2) : sizeof (EFI_COMMON_SECTION_HEADER);
+}
+
+/**
+  Find the first PE32 or encapsulation section of a section stream.
+
+  @param  Stream                The section stream.
+  @param  StreamSize            The size of the section stream, in bytes.
+
+  @return The first PE32, compression or GUID defined section of the stream,
+          or NULL if the stream has none or is malformed.
+
+**/
+STATIC
+EFI_COMMON_SECTION_HEADER *
+CoreImagePrefetchFirstSection (
+  IN VOID   *Stream,
+  IN UINTN  StreamSize
+  )
+{
+  EFI_COMMON_SECTION_HEADER  *Section;
+  UINTN                      Offset;
+  UINTN                      SectionSize;
+
+  Offset = 0;
+  while (Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= StreamSize) {
+    Section     = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)Stream + Offset);
+    SectionSize = SECTION_SIZE (Section);
+    if (IS_SECTION2 (Section)) {
+      if (Offset + sizeof (EFI_COMMON_SECTION_HEADER2) > StreamSize) {
+        return NULL;
+      }
+
+      SectionSize = SECTION2_SIZE (Section);
+    }
+
+    if ((SectionSize < CoreImagePrefetchSectionHeaderSize (Section)) || (SectionSize > StreamSize - Offset)) {
+      return NULL;
+    }
+
+    if ((Section->Type == EFI_SECTION_PE32) ||
+        (Section->Type == EFI_SECTION_COMPRESSION) ||
+        (Section->Type == EFI_SECTION_GUID_DEFINED))
+    {
+      return Section;
+    }
+
+    Offset += ALIGN_VALUE (SectionSize, 4);
+  }
+
+  return NULL;
+}
+
+/**
+  Decode the encapsulation section of a prefetch job. This runs on an AP, so
+  it may only touch the buffers of the job and must not call any boot service.
+
+  @param  Buffer                The IMAGE_PREFETCH_JOB to process.
+
+**/
+STATIC
+VOID
+EFIAPI
+CoreImagePrefetchProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  IMAGE_PREFETCH_JOB       *Job;
+  EFI_COMPRESSION_SECTION  *Compression;
+  UINT32                   HeaderSize;
+
+  Job = (IMAGE_PREFETCH_JOB *)Buffer;
+
+  if (Job->Section->Type == EFI_SECTION_COMPRESSION) {
+    Compression = (EFI_COMPRESSION_SECTION *)Job->Section;
+    HeaderSize  = IS_SECTION2 (Compression) ? sizeof (EFI_COMPRESSION_SECTION2) : sizeof (EFI_COMPRESSION_SECTION);
+    Job->Status = UefiDecompress (
+                    (UINT8 *)Compression + HeaderSize,
+                    Job->OutputBuffer,
+                    Job->ScratchBuffer
+                    );
+    Job->DecodedBuffer        = Job->OutputBuffer;
+    Job->AuthenticationStatus = 0;
+  } else {
+    Job->DecodedBuffer = Job->OutputBuffer;
+    Job->Status        = ExtractGuidedSectionDecode (
+                           Job->Section,
+                           &Job->DecodedBuffer,
+                           Job->ScratchBuffer,
+                           &Job->AuthenticationStatus
+                           );
+  }
+}
+
+/**
+  Release a prefetch job and everything it owns. The job must not be running.
+
+  @param  Job                   The job to release.
+
+**/
+STATIC
+VOID
+CoreFreeImagePrefetchJob (
+  IN IMAGE_PREFETCH_JOB  *Job
+  )
+{
+  ASSERT (!Job->Running);
+
+  RemoveEntryList (&Job->Link);
+
+  if (Job->WaitEvent != NULL) {
+    CoreCloseEvent (Job->WaitEvent);
+  }
+
+  if (Job->OutputBuffer != NULL) {
+    CoreFreePool (Job->OutputBuffer);
+  }
+
+  if (Job->ScratchBuffer != NULL) {
+    CoreFreePool (Job->ScratchBuffer);
+  }
+
+  if (Job->FileBuffer != NULL) {
+    CoreFreePool (Job->FileBuffer);
+  }
+
+  CoreFreePool (Job);
+}
+
+/**
+  Wait until the AP running a prefetch job has finished with it and the MP
+  Services Protocol has returned that AP to the idle state.
+
+  @param  Job                   The job to wait for.
+
+**/
+STATIC
+VOID
+CoreWaitForImagePrefetchJob (
+  IN IMAGE_PREFETCH_JOB  *Job
+  )
+{
+  if (!Job->Running) {
+    return;
+  }
+
+  //
+  // The MP Services Protocol signals the event from a timer callback once it
+  // has seen the AP finish, which can only happen below TPL_NOTIFY.
+  //
+  ASSERT (gEfiCurrentTpl < TPL_NOTIFY);
+  while (CoreCheckEvent (Job->WaitEvent) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+
+  Job->Running = FALSE;
+}
+
+/**
+  Locate the MP Services Protocol the first time it is available.
+
+  @retval TRUE                  APs can be used for prefetching.
+  @retval FALSE                 APs cannot be used yet.
+
+**/
+STATIC
+BOOLEAN
+CoreImagePrefetchGetMpServices (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       EnabledProcessorCount;
+
+  if (mImagePrefetchMpServices != NULL) {
+    return TRUE;
+  }
+
+  //
+  // Completion is only reported from a timer event, so the timer must run.
+  //
+  if (gTimer == NULL) {
+    return FALSE;
+  }
+
+  Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mImagePrefetchMpServices);
+  if (EFI_ERROR (Status)) {
+    mImagePrefetchMpServices = NULL;
+    return FALSE;
+  }
+
+  Status = mImagePrefetchMpServices->GetNumberOfProcessors (
+                                       mImagePrefetchMpServices,
+                                       &mImagePrefetchProcessorCount,
+                                       &EnabledProcessorCount
+                                       );
+  if (!EFI_ERROR (Status)) {
+    Status = mImagePrefetchMpServices->WhoAmI (mImagePrefetchMpServices, &mImagePrefetchBspNumber);
+  }
+
+  if (EFI_ERROR (Status) || (EnabledProcessorCount < 2)) {
+    mImagePrefetchProcessorCount = 0;
+  }
+
+  return TRUE;
+}
+
+/**
+  Pick an AP that is not running a prefetch job.
+
+  @param  ProcessorNumber       Returns the number of the AP.
+
+  @retval TRUE                  An AP was found.
+  @retval FALSE                 Every AP is busy.
+
+**/
+STATIC
+BOOLEAN
+CoreImagePrefetchFindIdleAp (
+  OUT UINTN  *ProcessorNumber
+  )
+{
+  LIST_ENTRY          *Link;
+  IMAGE_PREFETCH_JOB  *Job;
+  UINTN               Index;
+
+  for (Index = 0; Index < mImagePrefetchProcessorCount; Index++) {
+    if (Index == mImagePrefetchBspNumber) {
+      continue;
+    }
+
+    for (Link = mImagePrefetchJobs.ForwardLink; Link != &mImagePrefetchJobs; Link = Link->ForwardLink) {
+      Job = CR (Link, IMAGE_PREFETCH_JOB, Link, IMAGE_PREFETCH_JOB_SIGNATURE);
+      if (Job->Running && (Job->ProcessorNumber == Index)) {
+        break;
+      }
+    }
+
+    if (Link == &mImagePrefetchJobs) {
+      *ProcessorNumber = Index;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Read a driver file and prepare the buffers its encapsulation decodes into.
+
+  @param  DriverEntry           The driver to prefetch.
+
+  @return The prepared job, or NULL if the driver cannot be prefetched.
+
+**/
+STATIC
+IMAGE_PREFETCH_JOB *
+CoreCreateImagePrefetchJob (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  EFI_STATUS               Status;
+  IMAGE_PREFETCH_JOB       *Job;
+  UINTN                    FileSize;
+  EFI_FV_FILETYPE          FileType;
+  EFI_FV_FILE_ATTRIBUTES   FileAttributes;
+  UINT16                   SectionAttribute;
+  EFI_COMPRESSION_SECTION  *Compression;
+  UINT32                   HeaderSize;
+  UINT32                   SectionSize;
+  UINT32                   UncompressedLength;
+  UINT8                    CompressionType;
+
+  Job = AllocateZeroPool (sizeof (IMAGE_PREFETCH_JOB));
+  if (Job == NULL) {
+    return NULL;
+  }
+
+  Job->Signature   = IMAGE_PREFETCH_JOB_SIGNATURE;
+  Job->DriverEntry = DriverEntry;
+  InsertTailList (&mImagePrefetchJobs, &Job->Link);
+
+  Status = DriverEntry->Fv->ReadFile (
+                              DriverEntry->Fv,
+                              &DriverEntry->FileName,
+                              &Job->FileBuffer,
+                              &FileSize,
+                              &FileType,
+                              &FileAttributes,
+                              &Job->FvAuthenticationStatus
+                              );
+  if (EFI_ERROR (Status)) {
+    Job->FileBuffer = NULL;
+    goto Error;
+  }
+
+  //
+  // A PE32 section ahead of the first encapsulation needs no decoding.
+  //
+  Job->Section = CoreImagePrefetchFirstSection (Job->FileBuffer, FileSize);
+  if ((Job->Section == NULL) || (Job->Section->Type == EFI_SECTION_PE32)) {
+    goto Error;
+  }
+
+  if (Job->Section->Type == EFI_SECTION_COMPRESSION) {
+    Compression = (EFI_COMPRESSION_SECTION *)Job->Section;
+    if (IS_SECTION2 (Compression)) {
+      HeaderSize         = sizeof (EFI_COMPRESSION_SECTION2);
+      SectionSize        = SECTION2_SIZE (Compression);
+      UncompressedLength = ((EFI_COMPRESSION_SECTION2 *)Compression)->UncompressedLength;
+      CompressionType    = ((EFI_COMPRESSION_SECTION2 *)Compression)->CompressionType;
+    } else {
+      HeaderSize         = sizeof (EFI_COMPRESSION_SECTION);
+      SectionSize        = SECTION_SIZE (Compression);
+      UncompressedLength = Compression->UncompressedLength;
+      CompressionType    = Compression->CompressionType;
+    }
+
+    if ((CompressionType != EFI_STANDARD_COMPRESSION) || (SectionSize < HeaderSize)) {
+      goto Error;
+    }
+
+    Status = UefiDecompressGetInfo (
+               (UINT8 *)Compression + HeaderSize,
+               SectionSize - HeaderSize,
+               &Job->OutputSize,
+               &Job->ScratchSize
+               );
+    if (EFI_ERROR (Status) || (Job->OutputSize != UncompressedLength)) {
+      goto Error;
+    }
+  } else {
+    //
+    // Only GUIDs the DXE Core decodes itself through ExtractGuidedSectionLib
+    // have a decoder that is known not to call boot services.
+    //
+    Status = ExtractGuidedSectionGetInfo (
+               Job->Section,
+               &Job->OutputSize,
+               &Job->ScratchSize,
+               &SectionAttribute
+               );
+    if (EFI_ERROR (Status)) {
+      goto Error;
+    }
+  }
+
+  if (Job->OutputSize == 0) {
+    goto Error;
+  }
+
+  Job->OutputBuffer = AllocatePool (Job->OutputSize);
+  if (Job->OutputBuffer == NULL) {
+    goto Error;
+  }
+
+  if (Job->ScratchSize > 0) {
+    Job->ScratchBuffer = AllocatePool (Job->ScratchSize);
+    if (Job->ScratchBuffer == NULL) {
+      goto Error;
+    }
+  }
+
+  Status = CoreCreateEvent (0, 0, NULL, NULL, &Job->WaitEvent);
+  if (EFI_ERROR (Status)) {
+    Job->WaitEvent = NULL;
+    goto Error;
+  }
+
+  Job->Status = EFI_NOT_READY;
+  return Job;
+
+Error:
+  CoreFreeImagePrefetchJob (Job);
+  return NULL;
+}
+
+/**
+  Start decoding the drivers queued behind the head of the scheduled queue on
+  idle APs, up to PcdDxeImagePrefetchDepth drivers ahead.
+
+  @param  ScheduledQueue        The scheduled queue of the DXE dispatcher.
+
+**/
+VOID
+CoreStartImagePrefetch (
+  IN LIST_ENTRY  *ScheduledQueue
+  )
+{
+  EFI_STATUS             Status;
+  LIST_ENTRY             *Link;
+  LIST_ENTRY             *JobLink;
+  EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  IMAGE_PREFETCH_JOB     *Job;
+  UINT32                 Depth;
+  UINTN                  ProcessorNumber;
+
+  if ((PcdGet32 (PcdDxeImagePrefetchDepth) == 0) || IsListEmpty (ScheduledQueue)) {
+    return;
+  }
+
+  if (!CoreImagePrefetchGetMpServices () || (mImagePrefetchProcessorCount == 0)) {
+    return;
+  }
+
+  Depth = 0;
+  for (Link = ScheduledQueue->ForwardLink->ForwardLink;
+       (Link != ScheduledQueue) && (Depth < PcdGet32 (PcdDxeImagePrefetchDepth));
+       Link = Link->ForwardLink, Depth++)
+  {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if ((DriverEntry->ImageHandle != NULL) || DriverEntry->IsFvImage || (DriverEntry->Fv == NULL)) {
+      continue;
+    }
+
+    for (JobLink = mImagePrefetchJobs.ForwardLink; JobLink != &mImagePrefetchJobs; JobLink = JobLink->ForwardLink) {
+      Job = CR (JobLink, IMAGE_PREFETCH_JOB, Link, IMAGE_PREFETCH_JOB_SIGNATURE);
+      if (Job->DriverEntry == DriverEntry) {
+        break;
+      }
+    }
+
+    if (JobLink != &mImagePrefetchJobs) {
+      continue;
+    }
+
+    if (!CoreImagePrefetchFindIdleAp (&ProcessorNumber)) {
+      break;
+    }
+
+    Job = CoreCreateImagePrefetchJob (DriverEntry);
+    if (Job == NULL) {
+      continue;
+    }
+
+    Job->ProcessorNumber = ProcessorNumber;
+    Job->Running         = TRUE;
+
+    Status = mImagePrefetchMpServices->StartupThisAP (
+                                         mImagePrefetchMpServices,
+                                         CoreImagePrefetchProcedure,
+                                         ProcessorNumber,
+                                         Job->WaitEvent,
+                                         0,
+                                         Job,
+                                         NULL
+                                         );
+    if (EFI_ERROR (Status)) {
+      Job->Running = FALSE;
+      CoreFreeImagePrefetchJob (Job);
+      break;
+    }
+  }
+}
+
+/**
+  Wait for every running prefetch job. This is called before a driver entry
+  point runs, so the driver finds the APs idle.
+
+**/
+VOID
+CoreWaitForImagePrefetch (
+  VOID
+  )
+{
+  LIST_ENTRY  *Link;
+
+  for (Link = mImagePrefetchJobs.ForwardLink; Link != &mImagePrefetchJobs; Link = Link->ForwardLink) {
+    CoreWaitForImagePrefetchJob (CR (Link, IMAGE_PREFETCH_JOB, Link, IMAGE_PREFETCH_JOB_SIGNATURE));
+  }
+}
+
+/**
+  Release every prefetch job, waiting for the running ones first. This is
+  called when the dispatcher finishes.
+
+**/
+VOID
+CoreFlushImagePrefetch (
+  VOID
+  )
+{
+  CoreWaitForImagePrefetch ();
+
+  while (!IsListEmpty (&mImagePrefetchJobs)) {
+    CoreFreeImagePrefetchJob (CR (mImagePrefetchJobs.ForwardLink, IMAGE_PREFETCH_JOB, Link, IMAGE_PREFETCH_JOB_SIGNATURE));
+  }
+}
+
+/**
+  Hand the prefetched PE32 image of a driver to CoreLoadImage (). The returned
+  buffer and authentication status are the ones GetFileBufferByFilePath ()
+  would have produced for the same file.
+
+  @param  FilePath              The device path of the image being loaded.
+  @param  Buffer                Returns the PE32 image, allocated from pool.
+  @param  BufferSize            Returns the size of the PE32 image, in bytes.
+  @param  AuthenticationStatus  Returns the authentication status of the image.
+
+  @retval TRUE                  The image was prefetched and is returned.
+  @retval FALSE                 The image must be read from its device path.
+
+**/
+BOOLEAN
+CoreGetPrefetchedImage (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT VOID                            **Buffer,
+  OUT UINTN                           *BufferSize,
+  OUT UINT32                          *AuthenticationStatus
+  )
+{
+  LIST_ENTRY                 *Link;
+  IMAGE_PREFETCH_JOB         *Job;
+  EFI_COMMON_SECTION_HEADER  *Section;
+  EFI_GUID_DEFINED_SECTION   *GuidedSection;
+  UINT16                     GuidedAttributes;
+  UINT32                     HeaderSize;
+  UINT32                     SectionSize;
+  BOOLEAN                    Found;
+
+  for (Link = mImagePrefetchJobs.ForwardLink; Link != &mImagePrefetchJobs; Link = Link->ForwardLink) {
+    Job = CR (Link, IMAGE_PREFETCH_JOB, Link, IMAGE_PREFETCH_JOB_SIGNATURE);
+    if (Job->DriverEntry->FvFileDevicePath == FilePath) {
+      break;
+    }
+  }
+
+  if (Link == &mImagePrefetchJobs) {
+    return FALSE;
+  }
+
+  CoreWaitForImagePrefetchJob (Job);
+
+  Found = FALSE;
+  if (!EFI_ERROR (Job->Status)) {
+    //
+    // The decoded stream must start with the PE32 section that the section
+    // extraction code would descend into first.
+    //
+    Section = CoreImagePrefetchFirstSection (Job->DecodedBuffer, Job->OutputSize);
+    if ((Section != NULL) && (Section->Type == EFI_SECTION_PE32)) {
+      HeaderSize  = CoreImagePrefetchSectionHeaderSize (Section);
+      SectionSize = IS_SECTION2 (Section) ? SECTION2_SIZE (Section) : SECTION_SIZE (Section);
+      *Buffer     = AllocateCopyPool (SectionSize - HeaderSize, (UINT8 *)Section + HeaderSize);
+      if (*Buffer != NULL) {
+        *BufferSize = SectionSize - HeaderSize;
+        Found       = TRUE;
+      }
+    }
+  }
+
+  if (Found) {
+    //
+    // Mirror the authentication status the section extraction code derives
+    // for an encapsulation in a freshly opened file stream.
+    //
+    *AuthenticationStatus = 0;
+    if (Job->Section->Type == EFI_SECTION_GUID_DEFINED) {
+      GuidedSection    = (EFI_GUID_DEFINED_SECTION *)Job->Section;
+      GuidedAttributes = IS_SECTION2 (GuidedSection) ?
+                         ((EFI_GUID_DEFINED_SECTION2 *)GuidedSection)->Attributes :
+                         GuidedSection->Attributes;
+      if ((GuidedAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) != 0) {
+        *AuthenticationStatus = Job->AuthenticationStatus;
+      }
+    }
+
+    *AuthenticationStatus |= Job->FvAuthenticationStatus;
+  }
+
+  CoreFreeImagePrefetchJob (Job);
+  return Found;
+}
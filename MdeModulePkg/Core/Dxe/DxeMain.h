@@ -45,6 +45,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/MpService.h>
+#include <Protocol/MemoryAccept.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
@@ -60,6 +62,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/LoadModuleAtFixedAddress.h>
 #include <Guid/IdleLoopEvent.h>
 #include <Guid/VectorHandoffTable.h>
+#include <Guid/HobGuidIndex.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
 
@@ -84,6 +87,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DxeServicesLib.h>
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
+#include <Library/OrderedCollectionLib.h>
 
 //
 // attributes for reserved memory before it is promoted to system memory
@@ -158,6 +162,14 @@ typedef struct {
   BOOLEAN                          Initialized;
   BOOLEAN                          DepexProtocolError;
 
+  //
+  // Set when the DEPEX last evaluated to FALSE, with the protocol install key
+  // at that time. The DEPEX is only evaluated again once one of the protocols
+  // it still waits on was installed after DepexInstallKey.
+  //
+  BOOLEAN                          DepexUnsatisfied;
+  UINT64                           DepexInstallKey;
+
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
 } EFI_CORE_DRIVER_ENTRY;
@@ -269,6 +281,7 @@ extern EFI_SECURITY_ARCH_PROTOCOL        *gSecurity;
 extern EFI_SECURITY2_ARCH_PROTOCOL       *gSecurity2;
 extern EFI_BDS_ARCH_PROTOCOL             *gBds;
 extern EFI_SMM_BASE2_PROTOCOL            *gSmmBase2;
+extern EDKII_MEMORY_ACCEPT_PROTOCOL      *gMemoryAccept;
 
 extern EFI_TPL  gEfiCurrentTpl;
 
@@ -1067,6 +1080,24 @@ CoreGetHandleDatabaseKey (
   VOID
   );
 
+/**
+  Return the protocol install key, either for the whole protocol database or
+  for a single protocol. The key grows every time a protocol interface is
+  installed or reinstalled, so comparing two values tells whether an install
+  happened in between.
+
+  @param  Protocol               The protocol to query, or NULL for the whole
+                                 protocol database.
+
+  @return The key of the last install of Protocol, or 0 if Protocol has never
+          been installed.
+
+**/
+UINT64
+CoreGetProtocolInstallKey (
+  IN EFI_GUID  *Protocol OPTIONAL
+  );
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -1968,6 +1999,60 @@ CoreTrust (
   IN  EFI_GUID    *DriverName
   );
 
+/**
+  Start decoding the drivers queued behind the head of the scheduled queue on
+  idle APs, up to PcdDxeImagePrefetchDepth drivers ahead.
+
+  @param  ScheduledQueue        The scheduled queue of the DXE dispatcher.
+
+**/
+VOID
+CoreStartImagePrefetch (
+  IN LIST_ENTRY  *ScheduledQueue
+  );
+
+/**
+  Wait for every running prefetch job. This is called before a driver entry
+  point runs, so the driver finds the APs idle.
+
+**/
+VOID
+CoreWaitForImagePrefetch (
+  VOID
+  );
+
+/**
+  Release every prefetch job, waiting for the running ones first. This is
+  called when the dispatcher finishes.
+
+**/
+VOID
+CoreFlushImagePrefetch (
+  VOID
+  );
+
+/**
+  Hand the prefetched PE32 image of a driver to CoreLoadImage (). The returned
+  buffer and authentication status are the ones GetFileBufferByFilePath ()
+  would have produced for the same file.
+
+  @param  FilePath              The device path of the image being loaded.
+  @param  Buffer                Returns the PE32 image, allocated from pool.
+  @param  BufferSize            Returns the size of the PE32 image, in bytes.
+  @param  AuthenticationStatus  Returns the authentication status of the image.
+
+  @retval TRUE                  The image was prefetched and is returned.
+  @retval FALSE                 The image must be read from its device path.
+
+**/
+BOOLEAN
+CoreGetPrefetchedImage (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT VOID                            **Buffer,
+  OUT UINTN                           *BufferSize,
+  OUT UINT32                          *AuthenticationStatus
+  );
+
 /**
   This routine is the driver initialization entry point.  It initializes the
   libraries, and registers two notification functions.  These notification
@@ -2382,6 +2467,18 @@ CoreUpdateDebugTableCrc32 (
   VOID
   );
 
+/**
+  Build a sorted index of the GUID extension HOBs in the HOB list and install
+  it into the EFI System Table.
+
+  @param[in] HobStart  The start of the HOB list.
+
+**/
+VOID
+CoreInstallHobGuidIndex (
+  IN VOID  *HobStart
+  );
+
 /**
   Adds a new DebugImageInfo structure to the DebugImageInfo Table.  Re-Allocates
   the table if it's not large enough to accomidate another entry.
@@ -27,7 +27,8 @@ EFI_WATCHDOG_TIMER_ARCH_PROTOCOL  *gWatchdogTimer = NULL;
 //
 // DXE Core globals for optional protocol dependencies
 //
-EFI_SMM_BASE2_PROTOCOL  *gSmmBase2 = NULL;
+EFI_SMM_BASE2_PROTOCOL        *gSmmBase2     = NULL;
+EDKII_MEMORY_ACCEPT_PROTOCOL  *gMemoryAccept = NULL;
 
 //
 // DXE Core Global used to update core loaded image protocol handle
@@ -340,6 +341,11 @@ DxeMain (
   Status = CoreInstallConfigurationTable (&gEfiHobListGuid, HobStart);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Install a sorted index of the GUID HOBs so that HobLib can find them quickly
+  //
+  CoreInstallHobGuidIndex (HobStart);
+
   //
   // Install Memory Type Information Table into the EFI System Tables's Configuration Table
   //
@@ -950,3 +956,97 @@ DxeMainUefiDecompress (
 
   return UefiDecompress (Source, Destination, Scratch);
 }
+
+/**
+  Compare two HOB GUID index entries by GUID and then by HOB address.
+
+  @param[in] Buffer1  The first EDKII_HOB_GUID_INDEX_ENTRY.
+  @param[in] Buffer2  The second EDKII_HOB_GUID_INDEX_ENTRY.
+
+  @retval <0  Buffer1 sorts before Buffer2.
+  @retval 0   Buffer1 and Buffer2 are identical.
+  @retval >0  Buffer1 sorts after Buffer2.
+
+**/
+INTN
+EFIAPI
+CoreCompareHobGuidIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST EDKII_HOB_GUID_INDEX_ENTRY  *Entry1;
+  CONST EDKII_HOB_GUID_INDEX_ENTRY  *Entry2;
+  INTN                              Result;
+
+  Entry1 = (CONST EDKII_HOB_GUID_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST EDKII_HOB_GUID_INDEX_ENTRY *)Buffer2;
+
+  Result = CompareMem (&Entry1->Name, &Entry2->Name, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->Hob == Entry2->Hob) {
+    return 0;
+  }
+
+  return (Entry1->Hob < Entry2->Hob) ? -1 : 1;
+}
+
+/**
+  Build a sorted index of the GUID extension HOBs in the HOB list and install
+  it into the EFI System Table so that HobLib can look GUID HOBs up with a
+  binary search instead of a linear walk of the HOB list.
+
+  The index is an optimization only. If it cannot be built, HobLib falls back
+  to walking the HOB list.
+
+  @param[in] HobStart  The start of the HOB list.
+
+**/
+VOID
+CoreInstallHobGuidIndex (
+  IN VOID  *HobStart
+  )
+{
+  EFI_PEI_HOB_POINTERS        Hob;
+  UINTN                       Count;
+  EDKII_HOB_GUID_INDEX        *Index;
+  EDKII_HOB_GUID_INDEX_ENTRY  *Entry;
+  EDKII_HOB_GUID_INDEX_ENTRY  Swap;
+  EFI_STATUS                  Status;
+
+  Count = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+  }
+
+  Index = AllocatePool (sizeof (EDKII_HOB_GUID_INDEX) + Count * sizeof (EDKII_HOB_GUID_INDEX_ENTRY));
+  if (Index == NULL) {
+    return;
+  }
+
+  Entry = (EDKII_HOB_GUID_INDEX_ENTRY *)(Index + 1);
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      CopyGuid (&Entry->Name, &Hob.Guid->Name);
+      Entry->Hob = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+      Entry++;
+    }
+  }
+
+  Index->Version      = EDKII_HOB_GUID_INDEX_VERSION;
+  Index->Count        = (UINT32)Count;
+  Index->HobListStart = (EFI_PHYSICAL_ADDRESS)(UINTN)HobStart;
+  Index->HobListEnd   = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+
+  QuickSort (Index + 1, Count, sizeof (EDKII_HOB_GUID_INDEX_ENTRY), CoreCompareHobGuidIndexEntry, &Swap);
+
+  Status = CoreInstallConfigurationTable (&gEdkiiHobGuidIndexTableGuid, Index);
+  if (EFI_ERROR (Status)) {
+    FreePool (Index);
+  }
+}
@@ -29,11 +29,28 @@ extern  UINTN  gEventPending;
 ///
 /// Timer event information
 ///
-typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
-} TIMER_EVENT_INFO;
+typedef struct _TIMER_EVENT_INFO TIMER_EVENT_INFO;
+
+struct _TIMER_EVENT_INFO {
+  ///
+  /// Node links in the timer queue, a leftist min-heap ordered by
+  /// (TriggerTime, Sequence)
+  ///
+  TIMER_EVENT_INFO    *Parent;
+  TIMER_EVENT_INFO    *Left;
+  TIMER_EVENT_INFO    *Right;
+  ///
+  /// Length of the right spine of the subtree rooted at this node.
+  /// Zero when the timer is not queued.
+  ///
+  UINTN               Rank;
+  ///
+  /// Insertion order, keeps timers with the same trigger time FIFO
+  ///
+  UINT64              Sequence;
+  UINT64              TriggerTime;
+  UINT64              Period;
+};
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
 typedef struct {
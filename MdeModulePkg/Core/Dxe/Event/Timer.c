@@ -13,9 +13,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+TIMER_EVENT_INFO  *mEfiTimerQueue     = NULL;
+UINT64            mEfiTimerSequence   = 0;
+EFI_LOCK          mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT         mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
@@ -24,6 +25,95 @@ UINT64    mEfiSystemTime     = 0;
 // Timer functions
 //
 
+/**
+  Returns the rank of a timer queue node.
+
+  @param  Timer                  The timer queue node, may be NULL
+
+  @return The rank of the node, 0 for NULL
+
+**/
+STATIC
+UINTN
+CoreTimerRank (
+  IN TIMER_EVENT_INFO  *Timer
+  )
+{
+  return (Timer == NULL) ? 0 : Timer->Rank;
+}
+
+/**
+  Checks whether a timer must be signaled before another one.
+
+  @param  Timer1                 The first timer queue node
+  @param  Timer2                 The second timer queue node
+
+  @retval TRUE                   Timer1 expires before Timer2
+  @retval FALSE                  Timer2 expires before Timer1
+
+**/
+STATIC
+BOOLEAN
+CoreTimerBefore (
+  IN TIMER_EVENT_INFO  *Timer1,
+  IN TIMER_EVENT_INFO  *Timer2
+  )
+{
+  if (Timer1->TriggerTime != Timer2->TriggerTime) {
+    return (BOOLEAN)(Timer1->TriggerTime < Timer2->TriggerTime);
+  }
+
+  return (BOOLEAN)(Timer1->Sequence < Timer2->Sequence);
+}
+
+/**
+  Merges two timer queues.
+
+  The recursion only follows the right spines of the two heaps, whose
+  length is logarithmic in the number of queued timers.
+
+  @param  Queue1                 The first timer queue, may be NULL
+  @param  Queue2                 The second timer queue, may be NULL
+
+  @return The root of the merged timer queue
+
+**/
+STATIC
+TIMER_EVENT_INFO *
+CoreMergeTimerQueue (
+  IN TIMER_EVENT_INFO  *Queue1,
+  IN TIMER_EVENT_INFO  *Queue2
+  )
+{
+  TIMER_EVENT_INFO  *Swap;
+
+  if (Queue1 == NULL) {
+    return Queue2;
+  }
+
+  if (Queue2 == NULL) {
+    return Queue1;
+  }
+
+  if (CoreTimerBefore (Queue2, Queue1)) {
+    Swap   = Queue1;
+    Queue1 = Queue2;
+    Queue2 = Swap;
+  }
+
+  Queue1->Right         = CoreMergeTimerQueue (Queue1->Right, Queue2);
+  Queue1->Right->Parent = Queue1;
+
+  if (CoreTimerRank (Queue1->Left) < CoreTimerRank (Queue1->Right)) {
+    Swap          = Queue1->Left;
+    Queue1->Left  = Queue1->Right;
+    Queue1->Right = Swap;
+  }
+
+  Queue1->Rank = CoreTimerRank (Queue1->Right) + 1;
+  return Queue1;
+}
+
 /**
   Inserts the timer event.
 
@@ -36,29 +126,86 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
+  TIMER_EVENT_INFO  *Timer;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  Timer           = &Event->Timer;
+  Timer->Parent   = NULL;
+  Timer->Left     = NULL;
+  Timer->Right    = NULL;
+  Timer->Rank     = 1;
+  Timer->Sequence = mEfiTimerSequence++;
+
+  mEfiTimerQueue         = CoreMergeTimerQueue (mEfiTimerQueue, Timer);
+  mEfiTimerQueue->Parent = NULL;
+}
+
+/**
+  Removes the timer event from the timer queue.
+
+  @param  Event                  Points to the internal structure of timer event
+                                 to be removed
+
+**/
+STATIC
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  TIMER_EVENT_INFO  *Timer;
+  TIMER_EVENT_INFO  *SubQueue;
+  TIMER_EVENT_INFO  *Parent;
+  TIMER_EVENT_INFO  *Swap;
+  UINTN             Rank;
 
   ASSERT_LOCKED (&mEfiTimerLock);
 
+  Timer = &Event->Timer;
+  ASSERT (Timer->Rank != 0);
+
   //
-  // Get the timer's trigger time
+  // Replace the node by the merge of its two subtrees
   //
-  TriggerTime = Event->Timer.TriggerTime;
+  SubQueue = CoreMergeTimerQueue (Timer->Left, Timer->Right);
+  Parent   = Timer->Parent;
+  if (SubQueue != NULL) {
+    SubQueue->Parent = Parent;
+  }
+
+  if (Parent == NULL) {
+    mEfiTimerQueue = SubQueue;
+  } else if (Parent->Left == Timer) {
+    Parent->Left = SubQueue;
+  } else {
+    Parent->Right = SubQueue;
+  }
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Restore the leftist property on the path to the root; stop as soon as
+  // the rank of a node is unchanged.
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (Parent != NULL) {
+    if (CoreTimerRank (Parent->Left) < CoreTimerRank (Parent->Right)) {
+      Swap          = Parent->Left;
+      Parent->Left  = Parent->Right;
+      Parent->Right = Swap;
+    }
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
+    Rank = CoreTimerRank (Parent->Right) + 1;
+    if (Rank == Parent->Rank) {
       break;
     }
+
+    Parent->Rank = Rank;
+    Parent       = Parent->Parent;
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  Timer->Parent = NULL;
+  Timer->Left   = NULL;
+  Timer->Right  = NULL;
+  Timer->Rank   = 0;
 }
 
 /**
@@ -82,7 +229,7 @@ CoreCurrentSystemTime (
 }
 
 /**
-  Checks the sorted timer list against the current system time.
+  Checks the timer queue against the current system time.
   Signals any expired event timer.
 
   @param  CheckEvent             Not used
@@ -105,8 +252,8 @@ CoreCheckTimers (
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (mEfiTimerQueue != NULL) {
+    Event = CR (mEfiTimerQueue, IEVENT, Timer, EVENT_SIGNATURE);
 
     //
     // If this timer is not expired, then we're done
@@ -119,8 +266,7 @@ CoreCheckTimers (
     // Remove this timer from the timer queue
     //
 
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
 
     //
     // Signal it
@@ -189,7 +335,7 @@ CoreTimerTick (
   IN UINT64  Duration
   )
 {
-  IEVENT  *Event;
+  TIMER_EVENT_INFO  *Timer;
 
   //
   // Check runtiem flag in case there are ticks while exiting boot services
@@ -202,15 +348,12 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the head of the queue is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
-      CoreSignalEvent (mEfiCheckTimerEvent);
-    }
+  Timer = mEfiTimerQueue;
+  if ((Timer != NULL) && (Timer->TriggerTime <= mEfiSystemTime)) {
+    CoreSignalEvent (mEfiCheckTimerEvent);
   }
 
   CoreReleaseLock (&mEfiSystemTimeLock);
@@ -260,9 +403,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (Event->Timer.Rank != 0) {
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
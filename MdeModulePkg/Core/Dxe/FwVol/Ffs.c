@@ -214,3 +214,33 @@ IsValidFfsFile (
       return FALSE;
   }
 }
+
+/**
+  Get the FileIndex bucket of FV_DEVICE for a file name.
+
+  @param  NameGuid       The file name
+  @param  FileIndexMask  The FileIndexMask of FV_DEVICE
+
+  @return The bucket number
+
+**/
+UINTN
+GetFileIndexBucket (
+  IN CONST EFI_GUID  *NameGuid,
+  IN UINTN           FileIndexMask
+  )
+{
+  UINT32  Hash;
+
+  //
+  // File names are GUIDs, so folding the four 32-bit words together
+  // gives a well distributed hash.
+  //
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)NameGuid);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)NameGuid + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)NameGuid + 2);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)NameGuid + 3);
+  Hash ^= Hash >> 16;
+
+  return (UINTN)Hash & FileIndexMask;
+}
@@ -38,6 +38,10 @@ FV_DEVICE  mFvDevice = {
   NULL,
   NULL,
   { NULL,                 NULL},
+  NULL,
+  0,
+  0,
+  0,
   0,
   0,
   FALSE,
@@ -281,6 +285,10 @@ FreeFvDeviceResource (
     FfsFileEntry = (FFS_FILE_LIST_ENTRY *)NextEntry;
   }
 
+  if (FvDevice->FileIndex != NULL) {
+    CoreFreePool (FvDevice->FileIndex);
+  }
+
   if (!FvDevice->IsMemoryMapped) {
     //
     // Free the cached FV buffer.
@@ -296,6 +304,63 @@ FreeFvDeviceResource (
   return;
 }
 
+/**
+  Build the FileIndex of an FvDevice from its FFS file list, so FvReadFile ()
+  finds a file by name without walking the list. Pad files are left out, as
+  a read by name never returns them. When a name appears more than once the
+  first file on the list wins, like it does for the list walk.
+
+  If the index cannot be allocated FileIndex stays NULL and the FFS file list
+  is walked instead.
+
+  @param  FvDevice              A pointer to the FvDevice to index.
+
+**/
+STATIC
+VOID
+FvBuildFileIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  LIST_ENTRY           *Link;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+  UINTN                FileCount;
+  UINTN                Bucket;
+
+  FileCount = 0;
+  for (Link = FvDevice->FfsFileListHeader.ForwardLink; Link != &FvDevice->FfsFileListHeader; Link = Link->ForwardLink) {
+    FileCount++;
+  }
+
+  //
+  // One bucket per file on average, with a power of two bucket count.
+  //
+  FvDevice->FileIndexMask = 15;
+  while (FvDevice->FileIndexMask < FileCount) {
+    FvDevice->FileIndexMask = (FvDevice->FileIndexMask << 1) | 1;
+  }
+
+  FvDevice->FileIndex = AllocateZeroPool ((FvDevice->FileIndexMask + 1) * sizeof (FFS_FILE_LIST_ENTRY *));
+  if (FvDevice->FileIndex == NULL) {
+    return;
+  }
+
+  //
+  // Insert from the tail so the first of several same-named files ends up
+  // at the head of its bucket.
+  //
+  for (Link = FvDevice->FfsFileListHeader.BackLink; Link != &FvDevice->FfsFileListHeader; Link = Link->BackLink) {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *)Link;
+    if (FfsFileEntry->FfsHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+      continue;
+    }
+
+    Bucket                      = GetFileIndexBucket (&FfsFileEntry->FfsHeader->Name, FvDevice->FileIndexMask);
+    FfsFileEntry->HashNext      = FvDevice->FileIndex[Bucket];
+    FvDevice->FileIndex[Bucket] = FfsFileEntry;
+  }
+}
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -559,6 +624,8 @@ Done:
     }
 
     FreeFvDeviceResource (FvDevice);
+  } else {
+    FvBuildFileIndex (FvDevice);
   }
 
   return Status;
@@ -12,15 +12,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define FV2_DEVICE_SIGNATURE  SIGNATURE_32 ('_', 'F', 'V', '2')
 
+typedef struct _FFS_FILE_LIST_ENTRY FFS_FILE_LIST_ENTRY;
+
 //
 // Used to track all non-deleted files
 //
-typedef struct {
+struct _FFS_FILE_LIST_ENTRY {
   LIST_ENTRY             Link;
   EFI_FFS_FILE_HEADER    *FfsHeader;
   UINTN                  StreamHandle;
   BOOLEAN                FileCached;
-} FFS_FILE_LIST_ENTRY;
+  //
+  // Next entry in the same FileIndex bucket of FV_DEVICE
+  //
+  FFS_FILE_LIST_ENTRY    *HashNext;
+};
 
 typedef struct {
   UINTN                                 Signature;
@@ -36,6 +42,16 @@ typedef struct {
 
   LIST_ENTRY                            FfsFileListHeader;
 
+  //
+  // Hash index of FfsFileListHeader by file name. FileIndexMask + 1 buckets,
+  // or NULL if the index could not be allocated. The hit and miss counters
+  // are only maintained when performance measurement is enabled.
+  //
+  FFS_FILE_LIST_ENTRY                   **FileIndex;
+  UINTN                                 FileIndexMask;
+  UINTN                                 FileIndexHits;
+  UINTN                                 FileIndexMisses;
+
   UINT32                                AuthenticationStatus;
   UINT8                                 ErasePolarity;
   BOOLEAN                               IsFfs3Fv;
@@ -384,4 +400,19 @@ IsValidFfsFile (
   IN EFI_FFS_FILE_HEADER  *FfsHeader
   );
 
+/**
+  Get the FileIndex bucket of FV_DEVICE for a file name.
+
+  @param  NameGuid       The file name
+  @param  FileIndexMask  The FileIndexMask of FV_DEVICE
+
+  @return The bucket number
+
+**/
+UINTN
+GetFileIndexBucket (
+  IN CONST EFI_GUID  *NameGuid,
+  IN UINTN           FileIndexMask
+  );
+
 #endif
@@ -285,6 +285,8 @@ FvReadFile (
   EFI_FFS_FILE_HEADER     *FfsHeader;
   UINTN                   InputBufferSize;
   UINTN                   WholeFileSize;
+  EFI_FV_ATTRIBUTES       FvAttributes;
+  FFS_FILE_LIST_ENTRY     *FfsFileEntry;
 
   if (NameGuid == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -292,25 +294,59 @@ FvReadFile (
 
   FvDevice = FV_DEVICE_FROM_THIS (This);
 
-  //
-  // Keep looking until we find the matching NameGuid.
-  // The Key is really a FfsFileEntry
-  //
-  FvDevice->LastKey = 0;
-  do {
-    LocalFoundType = 0;
-    Status         = FvGetNextFile (
-                       This,
-                       &FvDevice->LastKey,
-                       &LocalFoundType,
-                       &SearchNameGuid,
-                       &LocalAttributes,
-                       &FileSize
-                       );
-    if (EFI_ERROR (Status)) {
+  if (FvDevice->FileIndex != NULL) {
+    //
+    // Look the file up in the index, applying the same checks as FvGetNextFile ().
+    //
+    Status = FvGetVolumeAttributes (This, &FvAttributes);
+    if (EFI_ERROR (Status) || ((FvAttributes & EFI_FV2_READ_STATUS) == 0)) {
+      return EFI_NOT_FOUND;
+    }
+
+    FfsFileEntry = FvDevice->FileIndex[GetFileIndexBucket (NameGuid, FvDevice->FileIndexMask)];
+    while ((FfsFileEntry != NULL) && !CompareGuid (&FfsFileEntry->FfsHeader->Name, NameGuid)) {
+      FfsFileEntry = FfsFileEntry->HashNext;
+    }
+
+    if (FfsFileEntry == NULL) {
+      PERF_CODE (
+        FvDevice->FileIndexMisses++;
+        );
       return EFI_NOT_FOUND;
     }
-  } while (!CompareGuid (&SearchNameGuid, NameGuid));
+
+    PERF_CODE (
+      FvDevice->FileIndexHits++;
+      );
+
+    FvDevice->LastKey = FfsFileEntry;
+    FfsHeader         = FfsFileEntry->FfsHeader;
+    if (IS_FFS_FILE2 (FfsHeader)) {
+      FileSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+    } else {
+      FileSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+    }
+  } else {
+    //
+    // Keep looking until we find the matching NameGuid.
+    // The Key is really a FfsFileEntry
+    //
+    FvDevice->LastKey = 0;
+    do {
+      LocalFoundType = 0;
+      Status         = FvGetNextFile (
+                         This,
+                         &FvDevice->LastKey,
+                         &LocalFoundType,
+                         &SearchNameGuid,
+                         &LocalAttributes,
+                         &FileSize
+                         );
+      if (EFI_ERROR (Status)) {
+        return EFI_NOT_FOUND;
+      }
+    } while (!CompareGuid (&SearchNameGuid, NameGuid));
+  }
 
   //
   // Get a pointer to the header
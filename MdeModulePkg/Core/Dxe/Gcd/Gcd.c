@@ -43,6 +43,15 @@ EFI_LOCK    mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 LIST_ENTRY  mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY  mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// Optional red-black tree indexes of the GCD maps, keyed by address range.
+// They are only present when PcdGcdMapIndexEnable is TRUE, and are dropped
+// if they ever fail to track the maps, in which case the maps are searched
+// linearly.
+//
+ORDERED_COLLECTION  *mGcdMemorySpaceIndex = NULL;
+ORDERED_COLLECTION  *mGcdIoSpaceIndex     = NULL;
+
 EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -103,6 +112,7 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8  *mGcdMemoryTypeNames[] = {
   "MMIO     ",  // EfiGcdMemoryTypeMemoryMappedIo
   "PersisMem",  // EfiGcdMemoryTypePersistent
   "MoreRelia",  // EfiGcdMemoryTypeMoreReliable
+  "Unaccepte",  // EfiGcdMemoryTypeUnaccepted
   "Unknown  "   // EfiGcdMemoryTypeMaximum
 };
 
@@ -371,6 +381,217 @@ PageAlignLength (
 // GCD Memory Space Worker Functions
 //
 
+/**
+  Compare two GCD map entries by base address.
+
+  @param[in] UserStruct1  Pointer to the first EFI_GCD_MAP_ENTRY.
+  @param[in] UserStruct2  Pointer to the second EFI_GCD_MAP_ENTRY.
+
+  @retval <0  UserStruct1 is located below UserStruct2.
+  @retval  0  UserStruct1 and UserStruct2 start at the same address.
+  @retval >0  UserStruct1 is located above UserStruct2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CoreGcdMapEntryCompare (
+  IN CONST VOID  *UserStruct1,
+  IN CONST VOID  *UserStruct2
+  )
+{
+  CONST EFI_GCD_MAP_ENTRY  *Entry1;
+  CONST EFI_GCD_MAP_ENTRY  *Entry2;
+
+  Entry1 = UserStruct1;
+  Entry2 = UserStruct2;
+
+  if (Entry1->BaseAddress < Entry2->BaseAddress) {
+    return -1;
+  }
+
+  return (Entry1->BaseAddress > Entry2->BaseAddress) ? 1 : 0;
+}
+
+/**
+  Compare an address against the range of a GCD map entry.
+
+  The entries of a GCD map never overlap, so an entry "equal" to an address
+  is the one entry containing it.
+
+  @param[in] StandaloneKey  Pointer to the EFI_PHYSICAL_ADDRESS to look up.
+  @param[in] UserStruct     Pointer to an EFI_GCD_MAP_ENTRY.
+
+  @retval <0  The address is below the entry.
+  @retval  0  The address is inside the entry.
+  @retval >0  The address is above the entry.
+
+**/
+STATIC
+INTN
+EFIAPI
+CoreGcdMapAddressCompare (
+  IN CONST VOID  *StandaloneKey,
+  IN CONST VOID  *UserStruct
+  )
+{
+  EFI_PHYSICAL_ADDRESS     Address;
+  CONST EFI_GCD_MAP_ENTRY  *Entry;
+
+  Address = *(CONST EFI_PHYSICAL_ADDRESS *)StandaloneKey;
+  Entry   = UserStruct;
+
+  if (Address < Entry->BaseAddress) {
+    return -1;
+  }
+
+  return (Address > Entry->EndAddress) ? 1 : 0;
+}
+
+/**
+  Return the index of a GCD map.
+
+  @param  Map                    The GCD memory space map or GCD I/O space map.
+
+  @return The pointer to the index of Map, or NULL if Map is not indexed.
+
+**/
+STATIC
+ORDERED_COLLECTION **
+CoreGetGcdMapIndex (
+  IN LIST_ENTRY  *Map
+  )
+{
+  if (Map == &mGcdMemorySpaceMap) {
+    return &mGcdMemorySpaceIndex;
+  }
+
+  ASSERT (Map == &mGcdIoSpaceMap);
+  return &mGcdIoSpaceIndex;
+}
+
+/**
+  Drop the index of a GCD map so that it is searched linearly from now on.
+
+  @param  Map                    The GCD map whose index is released.
+
+**/
+STATIC
+VOID
+CoreReleaseGcdMapIndex (
+  IN LIST_ENTRY  *Map
+  )
+{
+  ORDERED_COLLECTION  **Index;
+
+  Index = CoreGetGcdMapIndex (Map);
+  if (*Index == NULL) {
+    return;
+  }
+
+  DEBUG ((DEBUG_WARN, "%a: dropping the GCD map index of %p\n", __func__, Map));
+  while (!OrderedCollectionIsEmpty (*Index)) {
+    OrderedCollectionDelete (*Index, OrderedCollectionMin (*Index), NULL);
+  }
+
+  OrderedCollectionUninit (*Index);
+  *Index = NULL;
+}
+
+/**
+  Add a GCD map entry to the index of its map.
+
+  @param  Map                    The GCD map Entry is linked into.
+  @param  Entry                  The entry to add.
+
+**/
+STATIC
+VOID
+CoreIndexGcdMapEntry (
+  IN LIST_ENTRY         *Map,
+  IN EFI_GCD_MAP_ENTRY  *Entry
+  )
+{
+  ORDERED_COLLECTION  **Index;
+  RETURN_STATUS       Status;
+
+  Index = CoreGetGcdMapIndex (Map);
+  if (*Index == NULL) {
+    return;
+  }
+
+  //
+  // The tree node must not be guarded by HeapGuard for the same reason the
+  // map entries are not, see CoreAllocateGcdMapEntry().
+  //
+  mOnGuarding = TRUE;
+  Status      = OrderedCollectionInsert (*Index, NULL, Entry);
+  mOnGuarding = FALSE;
+  if (RETURN_ERROR (Status)) {
+    ASSERT (Status != RETURN_ALREADY_STARTED);
+    CoreReleaseGcdMapIndex (Map);
+  }
+}
+
+/**
+  Remove a GCD map entry from the index of its map.
+
+  @param  Map                    The GCD map Entry is linked into.
+  @param  Entry                  The entry to remove.
+
+**/
+STATIC
+VOID
+CoreUnindexGcdMapEntry (
+  IN LIST_ENTRY         *Map,
+  IN EFI_GCD_MAP_ENTRY  *Entry
+  )
+{
+  ORDERED_COLLECTION        **Index;
+  ORDERED_COLLECTION_ENTRY  *Node;
+
+  Index = CoreGetGcdMapIndex (Map);
+  if (*Index == NULL) {
+    return;
+  }
+
+  Node = OrderedCollectionFind (*Index, &Entry->BaseAddress);
+  ASSERT (Node != NULL && OrderedCollectionUserStruct (Node) == Entry);
+  if (Node == NULL) {
+    CoreReleaseGcdMapIndex (Map);
+    return;
+  }
+
+  OrderedCollectionDelete (*Index, Node, NULL);
+}
+
+/**
+  Create the index of a GCD map holding its single initial entry.
+
+  @param  Map                    The GCD map to index.
+  @param  Entry                  The entry covering the whole map.
+
+**/
+STATIC
+VOID
+CoreInitializeGcdMapIndex (
+  IN LIST_ENTRY         *Map,
+  IN EFI_GCD_MAP_ENTRY  *Entry
+  )
+{
+  ORDERED_COLLECTION  **Index;
+
+  if (!FeaturePcdGet (PcdGcdMapIndexEnable)) {
+    return;
+  }
+
+  Index  = CoreGetGcdMapIndex (Map);
+  *Index = OrderedCollectionInit (CoreGcdMapEntryCompare, CoreGcdMapAddressCompare);
+  if (*Index != NULL) {
+    CoreIndexGcdMapEntry (Map, Entry);
+  }
+}
+
 /**
   Allocate pool for two entries.
 
@@ -420,6 +641,7 @@ CoreAllocateGcdMapEntry (
   @param  Length                 The length of the new range in bytes
   @param  TopEntry               Top pad entry to insert if needed.
   @param  BottomEntry            Bottom pad entry to insert if needed.
+  @param  Map                    The GCD map Link belongs to.
 
   @retval EFI_SUCCESS            The new range was inserted into the linked list
 
@@ -431,7 +653,8 @@ CoreInsertGcdMapEntry (
   IN EFI_PHYSICAL_ADDRESS  BaseAddress,
   IN UINT64                Length,
   IN EFI_GCD_MAP_ENTRY     *TopEntry,
-  IN EFI_GCD_MAP_ENTRY     *BottomEntry
+  IN EFI_GCD_MAP_ENTRY     *BottomEntry,
+  IN LIST_ENTRY            *Map
   )
 {
   ASSERT (Length != 0);
@@ -443,6 +666,7 @@ CoreInsertGcdMapEntry (
     Entry->BaseAddress      = BaseAddress;
     BottomEntry->EndAddress = BaseAddress - 1;
     InsertTailList (Link, &BottomEntry->Link);
+    CoreIndexGcdMapEntry (Map, BottomEntry);
   }
 
   if ((BaseAddress + Length - 1) < Entry->EndAddress) {
@@ -452,6 +676,7 @@ CoreInsertGcdMapEntry (
     TopEntry->BaseAddress = BaseAddress + Length;
     Entry->EndAddress     = BaseAddress + Length - 1;
     InsertHeadList (Link, &TopEntry->Link);
+    CoreIndexGcdMapEntry (Map, TopEntry);
   }
 
   return EFI_SUCCESS;
@@ -523,6 +748,11 @@ CoreMergeGcdMapEntry (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Drop the adjacent entry from the index before Entry grows over it
+  //
+  CoreUnindexGcdMapEntry (Map, AdjacentEntry);
+
   if (Forward) {
     Entry->EndAddress = AdjacentEntry->EndAddress;
   } else {
@@ -601,14 +831,42 @@ CoreSearchGcdMapEntry (
   IN  LIST_ENTRY            *Map
   )
 {
-  LIST_ENTRY         *Link;
-  EFI_GCD_MAP_ENTRY  *Entry;
+  LIST_ENTRY                *Link;
+  EFI_GCD_MAP_ENTRY         *Entry;
+  ORDERED_COLLECTION        *Index;
+  ORDERED_COLLECTION_ENTRY  *Node;
+  EFI_PHYSICAL_ADDRESS      EndAddress;
 
   ASSERT (Length != 0);
 
   *StartLink = NULL;
   *EndLink   = NULL;
 
+  Index = *CoreGetGcdMapIndex (Map);
+  if (Index != NULL) {
+    EndAddress = BaseAddress + Length - 1;
+    if (EndAddress < BaseAddress) {
+      return EFI_NOT_FOUND;
+    }
+
+    Node = OrderedCollectionFind (Index, &BaseAddress);
+    if (Node == NULL) {
+      return EFI_NOT_FOUND;
+    }
+
+    Entry = OrderedCollectionUserStruct (Node);
+    if (EndAddress > Entry->EndAddress) {
+      Node = OrderedCollectionFind (Index, &EndAddress);
+      if (Node == NULL) {
+        return EFI_NOT_FOUND;
+      }
+    }
+
+    *StartLink = &Entry->Link;
+    *EndLink   = &((EFI_GCD_MAP_ENTRY *)OrderedCollectionUserStruct (Node))->Link;
+    return EFI_SUCCESS;
+  }
+
   Link = Map->ForwardLink;
   while (Link != Map) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
@@ -931,7 +1189,7 @@ CoreConvertSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry, Map);
     switch (Operation) {
       //
       // Add operations
@@ -1319,7 +1577,7 @@ CoreAllocateSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry, Map);
     Entry->ImageHandle  = ImageHandle;
     Entry->DeviceHandle = DeviceHandle;
     Link                = Link->ForwardLink;
@@ -2113,7 +2371,9 @@ CoreConvertResourceDescriptorHobAttributesToCapabilities (
   // Convert the Resource HOB Attributes to an EFI Memory Capabilities mask
   //
   for (Capabilities = 0, Conversion = mAttributeConversionTable; Conversion->Attribute != 0; Conversion++) {
-    if (Conversion->Memory || ((GcdMemoryType != EfiGcdMemoryTypeSystemMemory) && (GcdMemoryType != EfiGcdMemoryTypeMoreReliable))) {
+    if (Conversion->Memory || ((GcdMemoryType != EfiGcdMemoryTypeSystemMemory) && (GcdMemoryType != EfiGcdMemoryTypeMoreReliable) &&
+                               (GcdMemoryType != EfiGcdMemoryTypeUnaccepted)))
+    {
       if (Attributes & Conversion->Attribute) {
         Capabilities |= Conversion->Capability;
       }
@@ -2544,6 +2804,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfMemorySpace) - 1;
 
   InsertHeadList (&mGcdMemorySpaceMap, &Entry->Link);
+  CoreInitializeGcdMapIndex (&mGcdMemorySpaceMap, Entry);
 
   CoreDumpGcdMemorySpaceMap (TRUE);
 
@@ -2556,6 +2817,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfIoSpace) - 1;
 
   InsertHeadList (&mGcdIoSpaceMap, &Entry->Link);
+  CoreInitializeGcdMapIndex (&mGcdIoSpaceMap, Entry);
 
   CoreDumpGcdIoSpaceMap (TRUE);
 
@@ -2600,6 +2862,9 @@ CoreInitializeGcdServices (
         case EFI_RESOURCE_MEMORY_RESERVED:
           GcdMemoryType = EfiGcdMemoryTypeReserved;
           break;
+        case EFI_RESOURCE_MEMORY_UNACCEPTED:
+          GcdMemoryType = EfiGcdMemoryTypeUnaccepted;
+          break;
         case EFI_RESOURCE_IO:
           GcdIoType = EfiGcdIoTypeIo;
           break;
@@ -59,6 +59,7 @@ CoreConnectController (
   EFI_HANDLE                *ChildHandleBuffer;
   UINTN                     ChildHandleCount;
   UINTN                     Index;
+  UINTN                     ChildIndex;
   UINTN                     HandleFilePathSize;
   UINTN                     RemainingDevicePathSize;
   EFI_DEVICE_PATH_PROTOCOL  *HandleFilePath;
@@ -197,7 +198,9 @@ CoreConnectController (
     }
 
     //
-    // Fill in a handle buffer with ControllerHandle's children
+    // Fill in a handle buffer with ControllerHandle's children. A child usually
+    // opens several of the parent's protocols, so only add each child once;
+    // connecting it again would walk its whole subtree a second time.
     //
     for (Link = Handle->Protocols.ForwardLink, ChildHandleCount = 0; Link != &Handle->Protocols; Link = Link->ForwardLink) {
       Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
@@ -207,8 +210,16 @@ CoreConnectController (
       {
         OpenData = CR (ProtLink, OPEN_PROTOCOL_DATA, Link, OPEN_PROTOCOL_DATA_SIGNATURE);
         if ((OpenData->Attributes & EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER) != 0) {
-          ChildHandleBuffer[ChildHandleCount] = OpenData->ControllerHandle;
-          ChildHandleCount++;
+          for (ChildIndex = 0; ChildIndex < ChildHandleCount; ChildIndex++) {
+            if (ChildHandleBuffer[ChildIndex] == OpenData->ControllerHandle) {
+              break;
+            }
+          }
+
+          if (ChildIndex == ChildHandleCount) {
+            ChildHandleBuffer[ChildHandleCount] = OpenData->ControllerHandle;
+            ChildHandleCount++;
+          }
         }
       }
     }
@@ -219,7 +230,8 @@ CoreConnectController (
     CoreReleaseProtocolLock ();
 
     //
-    // Recursively connect each child handle
+    // Recursively connect each child handle. The children are connected one
+    // after the other on the BSP: Start() is synchronous and cannot yield.
     //
     for (Index = 0; Index < ChildHandleCount; Index++) {
       CoreConnectController (
@@ -10,15 +10,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system.
+// mProtocolHashTable    - The protocols of mProtocolDatabase hashed by GUID
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
+// gProtocolInstallKey   -  The Key to show that a protocol interface has been installed
 //
 LIST_ENTRY  mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
 LIST_ENTRY  gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK    gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64      gHandleDatabaseKey    = 0;
+UINT64      gProtocolInstallKey   = 0;
+
+#define PROTOCOL_HASH_BUCKETS  256
+
+STATIC LIST_ENTRY  mProtocolHashTable[PROTOCOL_HASH_BUCKETS];
+STATIC BOOLEAN     mProtocolHashTableReady = FALSE;
 
 /**
   Acquire lock on gProtocolDatabaseLock.
@@ -78,6 +86,46 @@ CoreValidateHandle (
   return EFI_INVALID_PARAMETER;
 }
 
+/**
+  Get the mProtocolHashTable bucket that holds the protocol entry of a GUID.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The ID of the protocol
+
+  @return The head of the hash bucket list.
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetProtocolHashBucket (
+  IN EFI_GUID  *Protocol
+  )
+{
+  UINT32  Hash;
+  UINTN   Index;
+
+  if (!mProtocolHashTableReady) {
+    for (Index = 0; Index < PROTOCOL_HASH_BUCKETS; Index++) {
+      InitializeListHead (&mProtocolHashTable[Index]);
+    }
+
+    mProtocolHashTableReady = TRUE;
+  }
+
+  //
+  // GUIDs are random enough that folding the four 32-bit words together
+  // gives a well distributed hash.
+  //
+  Hash  = ReadUnaligned32 ((UINT32 *)Protocol);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 1);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 2);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &mProtocolHashTable[Hash % PROTOCOL_HASH_BUCKETS];
+}
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -94,6 +142,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY      *Bucket;
   LIST_ENTRY      *Link;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
@@ -101,15 +150,16 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the GUID for the matching entry
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = CoreGetProtocolHashBucket (Protocol);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
@@ -135,11 +185,14 @@ CoreFindProtocolEntry (
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
+      ProtEntry->InterfaceCount = 0;
+      ProtEntry->InstallKey     = 0;
 
       //
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertHeadList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -447,6 +500,9 @@ CoreInstallProtocolInterfaceNotify (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  ProtEntry->InterfaceCount++;
+  gProtocolInstallKey++;
+  ProtEntry->InstallKey = gProtocolInstallKey;
 
   //
   // Notify the notification list for this protocol
@@ -1504,6 +1560,39 @@ CoreGetHandleDatabaseKey (
   return gHandleDatabaseKey;
 }
 
+/**
+  Return the protocol install key, either for the whole protocol database or
+  for a single protocol. The key grows every time a protocol interface is
+  installed or reinstalled, so comparing two values tells whether an install
+  happened in between.
+
+  @param  Protocol               The protocol to query, or NULL for the whole
+                                 protocol database.
+
+  @return The key of the last install of Protocol, or 0 if Protocol has never
+          been installed.
+
+**/
+UINT64
+CoreGetProtocolInstallKey (
+  IN EFI_GUID  *Protocol OPTIONAL
+  )
+{
+  PROTOCOL_ENTRY  *ProtEntry;
+  UINT64          Key;
+
+  if (Protocol == NULL) {
+    return gProtocolInstallKey;
+  }
+
+  CoreAcquireProtocolLock ();
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  Key       = (ProtEntry != NULL) ? ProtEntry->InstallKey : 0;
+  CoreReleaseProtocolLock ();
+
+  return Key;
+}
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
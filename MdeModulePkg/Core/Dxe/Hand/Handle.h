@@ -38,10 +38,16 @@ typedef struct {
   UINTN         Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY    AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket of ProtocolID
+  LIST_ENTRY    HashLink;
   /// ID of the protocol
   EFI_GUID      ProtocolID;
   /// All protocol interfaces
   LIST_ENTRY    Protocols;
+  /// Number of entries on the Protocols list
+  UINTN         InterfaceCount;
+  /// Value of gProtocolInstallKey when an interface was last installed
+  UINT64        InstallKey;
   /// Registerd notification handlers
   LIST_ENTRY    Notify;
 } PROTOCOL_ENTRY;
@@ -248,5 +254,6 @@ CoreValidateHandle (
 extern EFI_LOCK    gProtocolDatabaseLock;
 extern LIST_ENTRY  gHandleList;
 extern UINT64      gHandleDatabaseKey;
+extern UINT64      gProtocolInstallKey;
 
 #endif
@@ -427,6 +427,50 @@ CoreGetNextLocateByProtocol (
   return Handle;
 }
 
+/**
+  Check whether a device path is the first part of another device path.
+
+  The nodes are compared as the device path is walked, so that a device path
+  differing from SourcePath in its first nodes is rejected without walking it
+  to its end.
+
+  @param  SourcePath            The device path to match against.
+  @param  SourceSize            The size of the first instance of SourcePath,
+                                without its end node.
+  @param  DevicePath            The device path to check.
+
+  @return The size of DevicePath without its end node, or -1 if DevicePath is
+          not the first part of SourcePath.
+
+**/
+STATIC
+INTN
+CoreDevicePathPrefixSize (
+  IN EFI_DEVICE_PATH_PROTOCOL  *SourcePath,
+  IN INTN                      SourceSize,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  INTN  Size;
+  INTN  NodeLength;
+
+  Size = 0;
+  while (!IsDevicePathEnd (DevicePath)) {
+    NodeLength = (INTN)DevicePathNodeLength (DevicePath);
+    if ((NodeLength < (INTN)sizeof (EFI_DEVICE_PATH_PROTOCOL)) ||
+        (NodeLength > SourceSize - Size) ||
+        (CompareMem ((UINT8 *)SourcePath + Size, DevicePath, (UINTN)NodeLength) != 0))
+    {
+      return -1;
+    }
+
+    Size      += NodeLength;
+    DevicePath = NextDevicePathNode (DevicePath);
+  }
+
+  return Size;
+}
+
 /**
   Locates the handle to a device on the device path that supports the specified protocol.
 
@@ -511,9 +555,8 @@ CoreLocateDevicePath (
     //
     // Check if DevicePath is first part of SourcePath
     //
-    Size = GetDevicePathSize (TmpDevicePath) - sizeof (EFI_DEVICE_PATH_PROTOCOL);
-    ASSERT (Size >= 0);
-    if ((Size <= SourceSize) && (CompareMem (SourcePath, TmpDevicePath, (UINTN)Size) == 0)) {
+    Size = CoreDevicePathPrefixSize (SourcePath, SourceSize, TmpDevicePath);
+    if (Size >= 0) {
       //
       // If the size is equal to the best match, then we
       // have a duplicate device path for 2 different device
@@ -672,8 +715,9 @@ CoreLocateHandleBuffer (
   OUT EFI_HANDLE             **Buffer
   )
 {
-  EFI_STATUS  Status;
-  UINTN       BufferSize;
+  EFI_STATUS      Status;
+  UINTN           BufferSize;
+  PROTOCOL_ENTRY  *ProtEntry;
 
   if (NumberHandles == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -691,13 +735,31 @@ CoreLocateHandleBuffer (
   // Lock the protocol database
   //
   CoreAcquireProtocolLock ();
-  Status = InternalCoreLocateHandle (
-             SearchType,
-             Protocol,
-             SearchKey,
-             &BufferSize,
-             *Buffer
-             );
+
+  //
+  // A protocol is installed at most once per handle, so the interface count
+  // of the protocol entry gives the exact buffer size for ByProtocol and the
+  // sizing pass over the handle database can be skipped.
+  //
+  if ((SearchType == ByProtocol) && (Protocol != NULL)) {
+    ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+    if ((ProtEntry == NULL) || (ProtEntry->InterfaceCount == 0)) {
+      CoreReleaseProtocolLock ();
+      return EFI_NOT_FOUND;
+    }
+
+    BufferSize = ProtEntry->InterfaceCount * sizeof (EFI_HANDLE);
+    Status     = EFI_BUFFER_TOO_SMALL;
+  } else {
+    Status = InternalCoreLocateHandle (
+               SearchType,
+               Protocol,
+               SearchKey,
+               &BufferSize,
+               *Buffer
+               );
+  }
+
   //
   // LocateHandleBuffer() returns incorrect status code if SearchType is
   // invalid.
@@ -76,6 +76,8 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+    ASSERT (ProtEntry->InterfaceCount > 0);
+    ProtEntry->InterfaceCount--;
   }
 
   return Prot;
@@ -242,6 +244,9 @@ CoreReinstallProtocolInterface (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  ProtEntry->InterfaceCount++;
+  gProtocolInstallKey++;
+  ProtEntry->InstallKey = gProtocolInstallKey;
 
   //
   // Update the Key to show that the handle has been created/modified
@@ -654,6 +654,10 @@ CoreLoadPeImage (
     // If the image relocations have not been stripped, then load at any address.
     // Otherwise load at the address at which it was linked.
     //
+    // The address at which the image was linked is tried first in either case.
+    // An image loaded there needs no fixups, and PeCoffLoaderRelocateImage ()
+    // leaves it untouched.
+    //
     // Memory below 1MB should be treated reserved for CSM and there should be
     // no modules whose preferred load addresses are below 1MB.
     //
@@ -1240,14 +1244,17 @@ CoreLoadImageCommon (
     }
 
     //
-    // Get the source file buffer by its device path.
+    // Get the source file buffer by its device path, unless the dispatcher
+    // already decoded it on an AP.
     //
-    FHand.Source = GetFileBufferByFilePath (
-                     BootPolicy,
-                     FilePath,
-                     &FHand.SourceSize,
-                     &AuthenticationStatus
-                     );
+    if (!CoreGetPrefetchedImage (FilePath, &FHand.Source, &FHand.SourceSize, &AuthenticationStatus)) {
+      FHand.Source = GetFileBufferByFilePath (
+                       BootPolicy,
+                       FilePath,
+                       &FHand.SourceSize,
+                       &AuthenticationStatus
+                       );
+    }
     if (FHand.Source == NULL) {
       Status = EFI_NOT_FOUND;
     } else {
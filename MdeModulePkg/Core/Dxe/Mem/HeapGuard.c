@@ -43,6 +43,11 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mLevelMask[GUARDED_HEAP_MAP_TABLE_DEPTH]
 //
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_PHYSICAL_ADDRESS  mLastPromotedPage = BASE_4GB;
 
+//
+// Allocations of the memory types to guard since the last guarded one.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32  mGuardSampleCount = 0;
+
 /**
   Set corresponding bits in bitmap table to 1 according to the address.
 
@@ -663,6 +668,34 @@ IsPageTypeToGuard (
   return IsMemoryTypeToGuard (MemoryType, AllocateType, GUARD_HEAP_TYPE_PAGE);
 }
 
+/**
+  Check to see if an allocation of a memory type to guard is sampled to be
+  guarded or not, according to PcdHeapGuardSampleRate.
+
+  @return TRUE  The allocation should be guarded.
+  @return FALSE The allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampled (
+  VOID
+  )
+{
+  UINT32  SampleRate;
+
+  SampleRate = PcdGet32 (PcdHeapGuardSampleRate);
+  if (SampleRate <= 1) {
+    return TRUE;
+  }
+
+  mGuardSampleCount++;
+  if (mGuardSampleCount < SampleRate) {
+    return FALSE;
+  }
+
+  mGuardSampleCount = 0;
+  return TRUE;
+}
+
 /**
   Check to see if the heap guard is enabled for page and/or pool allocation.
 
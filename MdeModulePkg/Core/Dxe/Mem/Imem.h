@@ -33,6 +33,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct {
   UINTN              Signature;
   LIST_ENTRY         Link;
+  ///
+  /// Link on mFreeMemoryMap, only valid while an EfiConventionalMemory
+  /// entry is on gMemoryMap
+  ///
+  LIST_ENTRY         FreeLink;
   BOOLEAN            FromPages;
 
   EFI_MEMORY_TYPE    Type;
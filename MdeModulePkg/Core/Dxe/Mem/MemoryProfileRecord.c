@@ -14,6 +14,14 @@
 #define GET_OCCUPIED_SIZE(ActualSize, Alignment) \
   ((ActualSize) + (((Alignment) - ((ActualSize) & ((Alignment) - 1))) & ((Alignment) - 1)))
 
+//
+// Alloc info records are also hashed by buffer address, so that a free can
+// find its record without walking the alloc info lists of all drivers.
+//
+#define MEMORY_PROFILE_ALLOC_HASH_SIZE  512
+#define MEMORY_PROFILE_ALLOC_HASH(Buffer) \
+  ((((UINTN)(Buffer) >> 3) ^ ((UINTN)(Buffer) >> 12)) & (MEMORY_PROFILE_ALLOC_HASH_SIZE - 1))
+
 typedef struct {
   UINT32                    Signature;
   MEMORY_PROFILE_CONTEXT    Context;
@@ -29,10 +37,12 @@ typedef struct {
 } MEMORY_PROFILE_DRIVER_INFO_DATA;
 
 typedef struct {
-  UINT32                       Signature;
-  MEMORY_PROFILE_ALLOC_INFO    AllocInfo;
-  CHAR8                        *ActionString;
-  LIST_ENTRY                   Link;
+  UINT32                             Signature;
+  MEMORY_PROFILE_ALLOC_INFO          AllocInfo;
+  CHAR8                              *ActionString;
+  LIST_ENTRY                         Link;
+  LIST_ENTRY                         HashLink;
+  MEMORY_PROFILE_DRIVER_INFO_DATA    *DriverInfoData;
 } MEMORY_PROFILE_ALLOC_INFO_DATA;
 
 GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                   mImageQueue           = INITIALIZE_LIST_HEAD_VARIABLE (mImageQueue);
@@ -61,6 +71,7 @@ GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mMemoryProfileGettingSta
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mMemoryProfileRecordingEnable = MEMORY_PROFILE_RECORDING_DISABLE;
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_DEVICE_PATH_PROTOCOL  *mMemoryProfileDriverPath;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN                     mMemoryProfileDriverPathSize;
+GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                mMemoryProfileAllocHash[MEMORY_PROFILE_ALLOC_HASH_SIZE];
 
 /**
   Get memory profile data.
@@ -594,6 +605,7 @@ MemoryProfileInit (
   )
 {
   MEMORY_PROFILE_CONTEXT_DATA  *ContextData;
+  UINTN                        Index;
 
   if (!IS_UEFI_MEMORY_PROFILE_ENABLED) {
     return;
@@ -604,6 +616,10 @@ MemoryProfileInit (
     return;
   }
 
+  for (Index = 0; Index < MEMORY_PROFILE_ALLOC_HASH_SIZE; Index++) {
+    InitializeListHead (&mMemoryProfileAllocHash[Index]);
+  }
+
   mMemoryProfileGettingStatus = FALSE;
   if ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT7) != 0) {
     mMemoryProfileRecordingEnable = MEMORY_PROFILE_RECORDING_DISABLE;
@@ -1055,7 +1071,9 @@ CoreUpdateProfileAllocate (
     AllocInfoData->ActionString   = NULL;
   }
 
+  AllocInfoData->DriverInfoData = DriverInfoData;
   InsertTailList (DriverInfoData->AllocInfoList, &AllocInfoData->Link);
+  InsertTailList (&mMemoryProfileAllocHash[MEMORY_PROFILE_ALLOC_HASH (Buffer)], &AllocInfoData->HashLink);
 
   Context    = &ContextData->Context;
   DriverInfo = &DriverInfoData->DriverInfo;
@@ -1156,6 +1174,57 @@ GetMemoryProfileAllocInfoFromAddress (
   return NULL;
 }
 
+/**
+  Get memory profile alloc info of the buffer starting at the given address.
+
+  @param BasicAction        The allocate basic action of the buffer.
+  @param Size               Size of the buffer to free, for pages.
+  @param Buffer             Buffer address.
+
+  @return Pointer to memory profile alloc info, or NULL if not found.
+
+**/
+MEMORY_PROFILE_ALLOC_INFO_DATA *
+GetMemoryProfileAllocInfoFromHash (
+  IN MEMORY_PROFILE_ACTION  BasicAction,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  LIST_ENTRY                      *HashList;
+  LIST_ENTRY                      *HashLink;
+  MEMORY_PROFILE_ALLOC_INFO       *AllocInfo;
+  MEMORY_PROFILE_ALLOC_INFO_DATA  *AllocInfoData;
+
+  HashList = &mMemoryProfileAllocHash[MEMORY_PROFILE_ALLOC_HASH (Buffer)];
+
+  for (HashLink = HashList->ForwardLink;
+       HashLink != HashList;
+       HashLink = HashLink->ForwardLink)
+  {
+    AllocInfoData = CR (
+                      HashLink,
+                      MEMORY_PROFILE_ALLOC_INFO_DATA,
+                      HashLink,
+                      MEMORY_PROFILE_ALLOC_INFO_SIGNATURE
+                      );
+    AllocInfo = &AllocInfoData->AllocInfo;
+    if ((AllocInfo->Buffer != (PHYSICAL_ADDRESS)(UINTN)Buffer) ||
+        ((AllocInfo->Action & MEMORY_PROFILE_ACTION_BASIC_MASK) != BasicAction))
+    {
+      continue;
+    }
+
+    if ((BasicAction == MemoryProfileActionAllocatePages) && (AllocInfo->Size < Size)) {
+      continue;
+    }
+
+    return AllocInfoData;
+  }
+
+  return NULL;
+}
+
 /**
   Update memory profile Free information.
 
@@ -1211,7 +1280,34 @@ CoreUpdateProfileFree (
   Found         = FALSE;
   AllocInfoData = NULL;
   do {
-    if (DriverInfoData != NULL) {
+    //
+    // Most buffers are freed as a whole, so look up the record of the buffer
+    // starting at the given address first.
+    //
+    switch (BasicAction) {
+      case MemoryProfileActionFreePages:
+        AllocInfoData = GetMemoryProfileAllocInfoFromHash (MemoryProfileActionAllocatePages, Size, Buffer);
+        break;
+      case MemoryProfileActionFreePool:
+        AllocInfoData = GetMemoryProfileAllocInfoFromHash (MemoryProfileActionAllocatePool, 0, Buffer);
+        if (AllocInfoData == NULL) {
+          //
+          // A pool is only found by its address, so there is no other record
+          // of it in the alloc info lists.
+          //
+          return (Found ? EFI_SUCCESS : EFI_NOT_FOUND);
+        }
+
+        break;
+      default:
+        ASSERT (FALSE);
+        AllocInfoData = NULL;
+        break;
+    }
+
+    if (AllocInfoData != NULL) {
+      DriverInfoData = AllocInfoData->DriverInfoData;
+    } else if (DriverInfoData != NULL) {
       switch (BasicAction) {
         case MemoryProfileActionFreePages:
           AllocInfoData = GetMemoryProfileAllocInfoFromAddress (DriverInfoData, MemoryProfileActionAllocatePages, Size, Buffer);
@@ -1298,6 +1394,7 @@ CoreUpdateProfileFree (
     }
 
     RemoveEntryList (&AllocInfoData->Link);
+    RemoveEntryList (&AllocInfoData->HashLink);
 
     if (BasicAction == MemoryProfileActionFreePages) {
       if (AllocInfo->Buffer != (PHYSICAL_ADDRESS)(UINTN)Buffer) {
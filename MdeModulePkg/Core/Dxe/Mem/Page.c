@@ -44,6 +44,17 @@ UINTN       mFreeMapStack = 0;
 ///
 LIST_ENTRY  mFreeMemoryMapEntryList           = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN     mMemoryTypeInformationInitialized = FALSE;
+///
+/// The EfiConventionalMemory entries of gMemoryMap, linked through FreeLink,
+/// so that searching for free pages does not have to skip over every
+/// allocated descriptor.
+///
+LIST_ENTRY  mFreeMemoryMap = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMap);
+///
+/// The gMemoryMap entry found by the last address lookup or free page
+/// search. Converting the pages just found usually hits it.
+///
+MEMORY_MAP  *mMemoryMapHint = NULL;
 
 EFI_MEMORY_TYPE_STATISTICS  mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
@@ -61,6 +72,7 @@ EFI_MEMORY_TYPE_STATISTICS  mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiMemoryMappedIOPortSpace
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  TRUE  },  // EfiPalCode
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiPersistentMemory
+  { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiUnacceptedMemoryType
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE }   // EfiMaxMemoryType
 };
 
@@ -83,6 +95,7 @@ EFI_MEMORY_TYPE_INFORMATION  gMemoryTypeInformation[EfiMaxMemoryType + 1] = {
   { EfiMemoryMappedIOPortSpace, 0 },
   { EfiPalCode,                 0 },
   { EfiPersistentMemory,        0 },
+  { EfiUnacceptedMemoryType,    0 },
   { EfiMaxMemoryType,           0 }
 };
 //
@@ -127,6 +140,14 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
+  if (Entry->Type == EfiConventionalMemory) {
+    RemoveEntryList (&Entry->FreeLink);
+  }
+
+  if (mMemoryMapHint == Entry) {
+    mMemoryMapHint = NULL;
+  }
+
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -138,6 +159,62 @@ RemoveMemoryMapEntry (
   }
 }
 
+/**
+  Internal function.  Links a descriptor entry into the memory map.
+
+  @param  Link                   The gMemoryMap link to insert Entry in front of
+  @param  Entry                  The entry to insert
+
+**/
+STATIC
+VOID
+InsertMemoryMapEntry (
+  IN LIST_ENTRY      *Link,
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  InsertTailList (Link, &Entry->Link);
+
+  if (Entry->Type == EfiConventionalMemory) {
+    InsertTailList (&mFreeMemoryMap, &Entry->FreeLink);
+  }
+}
+
+/**
+  Internal function.  Finds the memory map entry that covers an address.
+
+  @param  Address                The address to look up
+
+  @return The entry covering Address, or NULL if Address is not in the map
+
+**/
+STATIC
+MEMORY_MAP *
+FindMemoryMapEntry (
+  IN UINT64  Address
+  )
+{
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+
+  ASSERT_LOCKED (&gMemoryLock);
+
+  Entry = mMemoryMapHint;
+  if ((Entry != NULL) && (Entry->Start <= Address) && (Entry->End > Address)) {
+    return Entry;
+  }
+
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if ((Entry->Start <= Address) && (Entry->End > Address)) {
+      mMemoryMapHint = Entry;
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Internal function.  Adds a ranges to the memory map.
   The range must not already exist in the map.
@@ -158,6 +235,7 @@ CoreAddRange (
   IN UINT64                Attribute
   )
 {
+  LIST_ENTRY  *Head;
   LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
 
@@ -204,13 +282,20 @@ CoreAddRange (
   //
 
   // Two memory descriptors can only be merged if they have the same Type
-  // and the same Attribute
+  // and the same Attribute. Free memory only has to be checked against the
+  // other free descriptors.
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
+  Head = (Type == EfiConventionalMemory) ? &mFreeMemoryMap : &gMemoryMap;
+  Link = Head->ForwardLink;
+  while (Link != Head) {
+    if (Head == &mFreeMemoryMap) {
+      Entry = CR (Link, MEMORY_MAP, FreeLink, MEMORY_MAP_SIGNATURE);
+    } else {
+      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    }
+
+    Link = Link->ForwardLink;
 
     if (Entry->Type != Type) {
       continue;
@@ -240,7 +325,7 @@ CoreAddRange (
   mMapStack[mMapDepth].End          = End;
   mMapStack[mMapDepth].VirtualStart = 0;
   mMapStack[mMapDepth].Attribute    = Attribute;
-  InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  InsertMemoryMapEntry (&gMemoryMap, &mMapStack[mMapDepth]);
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -347,6 +432,14 @@ CoreFreeMemoryMapStack (
       //
       // Move this entry to general memory
       //
+      if (mMapStack[mMapDepth].Type == EfiConventionalMemory) {
+        RemoveEntryList (&mMapStack[mMapDepth].FreeLink);
+      }
+
+      if (mMemoryMapHint == &mMapStack[mMapDepth]) {
+        mMemoryMapHint = Entry;
+      }
+
       RemoveEntryList (&mMapStack[mMapDepth].Link);
       mMapStack[mMapDepth].Link.ForwardLink = NULL;
 
@@ -363,7 +456,7 @@ CoreFreeMemoryMapStack (
         }
       }
 
-      InsertTailList (Link2, &Entry->Link);
+      InsertMemoryMapEntry (Link2, Entry);
     } else {
       //
       // This item of mMapStack[mMapDepth] has already been dequeued from gMemoryMap list,
@@ -376,8 +469,90 @@ CoreFreeMemoryMapStack (
   mFreeMapStack -= 1;
 }
 
+/**
+  Find the lowest unaccepted memory region in GCD map, accept it with the
+  memory accept protocol and convert it to be DXE allocatable.
+
+  The caller must hold the memory lock.
+
+  @return TRUE   A memory region has been accepted.
+  @return FALSE  No memory region can be accepted.
+
+**/
+STATIC
+BOOLEAN
+PromoteUnacceptedMemory (
+  VOID
+  )
+{
+  EFI_STATUS         Status;
+  LIST_ENTRY         *Link;
+  EFI_GCD_MAP_ENTRY  *Entry;
+  BOOLEAN            Promoted;
+
+  if (gMemoryAccept == NULL) {
+    return FALSE;
+  }
+
+  CoreAcquireGcdMemoryLock ();
+
+  Promoted = FALSE;
+  for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+
+    if ((Entry->GcdMemoryType != EfiGcdMemoryTypeUnaccepted) ||
+        (Entry->EndAddress >= MAX_ALLOC_ADDRESS))
+    {
+      continue;
+    }
+
+    DEBUG ((DEBUG_PAGE, "Accept memory 0x%lx - 0x%lx\n", Entry->BaseAddress, Entry->EndAddress));
+
+    Status = gMemoryAccept->AcceptMemory (
+                              gMemoryAccept,
+                              Entry->BaseAddress,
+                              (UINTN)(Entry->EndAddress - Entry->BaseAddress + 1)
+                              );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to accept memory 0x%lx - 0x%lx: %r\n", Entry->BaseAddress, Entry->EndAddress, Status));
+      continue;
+    }
+
+    //
+    // Update the GCD map
+    //
+    if ((Entry->Capabilities & EFI_MEMORY_MORE_RELIABLE) == EFI_MEMORY_MORE_RELIABLE) {
+      Entry->GcdMemoryType = EfiGcdMemoryTypeMoreReliable;
+    } else {
+      Entry->GcdMemoryType = EfiGcdMemoryTypeSystemMemory;
+    }
+
+    Entry->ImageHandle  = gDxeCoreImageHandle;
+    Entry->DeviceHandle = NULL;
+
+    //
+    // Add to allocable system memory resource
+    //
+    CoreAddRange (
+      EfiConventionalMemory,
+      Entry->BaseAddress,
+      Entry->EndAddress,
+      Entry->Capabilities & ~(EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED | EFI_MEMORY_RUNTIME)
+      );
+    CoreFreeMemoryMapStack ();
+
+    Promoted = TRUE;
+    break;
+  }
+
+  CoreReleaseGcdMemoryLock ();
+
+  return Promoted;
+}
+
 /**
   Find untested but initialized memory regions in GCD map and convert them to be DXE allocatable.
+  If there is none, accept the memory which has not been accepted yet.
 
 **/
 BOOLEAN
@@ -457,6 +632,14 @@ PromoteMemoryResource (
     }
   }
 
+  if (!Promoted) {
+    //
+    // Unaccepted memory is only accepted when the accepted one runs out, so
+    // the memory which is never allocated is left to the OS to accept.
+    //
+    Promoted = PromoteUnacceptedMemory ();
+  }
+
   return Promoted;
 }
 
@@ -737,7 +920,6 @@ CoreConvertPagesEx (
   UINT64           RangeEnd;
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
-  LIST_ENTRY       *Link;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -762,15 +944,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if ((Entry->Start <= Start) && (Entry->End > Start)) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = FindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -840,6 +1015,11 @@ CoreConvertPagesEx (
         if (((Start >= mMemoryTypeStatistics[NewType].BaseAddress) && (Start <= mMemoryTypeStatistics[NewType].MaximumAddress)) ||
             ((Start >= mDefaultBaseAddress) && (Start <= mDefaultMaximumAddress)))
         {
+          //
+          // gMemoryTypeInformation keeps the peak usage of each memory type,
+          // which BDS saves to the MemoryTypeInformation variable to size the
+          // bins of the next boot.
+          //
           mMemoryTypeStatistics[NewType].CurrentNumberOfPages += NumberOfPages;
           if (mMemoryTypeStatistics[NewType].CurrentNumberOfPages > gMemoryTypeInformation[mMemoryTypeStatistics[NewType].InformationIndex].NumberOfPages) {
             gMemoryTypeInformation[mMemoryTypeStatistics[NewType].InformationIndex].NumberOfPages = (UINT32)mMemoryTypeStatistics[NewType].CurrentNumberOfPages;
@@ -884,7 +1064,7 @@ CoreConvertPagesEx (
       ASSERT (Entry->Start < Entry->End);
 
       Entry = &mMapStack[mMapDepth];
-      InsertTailList (&gMemoryMap, &Entry->Link);
+      InsertMemoryMapEntry (&gMemoryMap, Entry);
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1038,6 +1218,7 @@ CoreFindFreePagesI (
   UINT64      DescNumberOfBytes;
   LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
+  MEMORY_MAP  *TargetEntry;
 
   if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
     return 0;
@@ -1066,16 +1247,14 @@ CoreFindFreePagesI (
 
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target        = 0;
+  TargetEntry   = NULL;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
+  //
+  // Only free entries can satisfy the request
+  //
+  for (Link = mFreeMemoryMap.ForwardLink; Link != &mFreeMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, FreeLink, MEMORY_MAP_SIGNATURE);
+    ASSERT (Entry->Type == EfiConventionalMemory);
 
     DescStart = Entry->Start;
     DescEnd   = Entry->End;
@@ -1130,7 +1309,8 @@ CoreFindFreePagesI (
           }
         }
 
-        Target = DescEnd;
+        Target      = DescEnd;
+        TargetEntry = Entry;
       }
     }
   }
@@ -1147,6 +1327,11 @@ CoreFindFreePagesI (
     return 0;
   }
 
+  //
+  // The caller is about to convert the range just found
+  //
+  mMemoryMapHint = TargetEntry;
+
   return Target;
 }
 
@@ -1286,7 +1471,8 @@ CoreInternalAllocatePages (
   }
 
   if (((MemoryType >= EfiMaxMemoryType) && (MemoryType < MEMORY_TYPE_OEM_RESERVED_MIN)) ||
-      (MemoryType == EfiConventionalMemory) || (MemoryType == EfiPersistentMemory))
+      (MemoryType == EfiConventionalMemory) || (MemoryType == EfiPersistentMemory) ||
+      (MemoryType == EfiUnacceptedMemoryType))
   {
     return EFI_INVALID_PARAMETER;
   }
@@ -1461,7 +1647,8 @@ CoreAllocatePages (
   EFI_STATUS  Status;
   BOOLEAN     NeedGuard;
 
-  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding;
+  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding &&
+              IsGuardSampled ();
   Status    = CoreInternalAllocatePages (
                 Type,
                 MemoryType,
@@ -1511,7 +1698,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS  Status;
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
   UINTN       Alignment;
   BOOLEAN     IsGuarded;
@@ -1525,15 +1711,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry     = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if ((Entry->Start <= Memory) && (Entry->End > Memory)) {
-      break;
-    }
-  }
-
-  if (Link == &gMemoryMap) {
+  Entry     = FindMemoryMapEntry (Memory);
+  if (Entry == NULL) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
@@ -1766,12 +1945,13 @@ CoreGetMemoryMap (
 
   //
   // Count the number of Reserved and runtime MMIO entries
-  // And, count the number of Persistent entries.
+  // And, count the number of Persistent and Unaccepted entries.
   //
   NumberOfEntries = 0;
   for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
     GcdMapEntry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
     if ((GcdMapEntry->GcdMemoryType == EfiGcdMemoryTypePersistent) ||
+        (GcdMapEntry->GcdMemoryType == EfiGcdMemoryTypeUnaccepted) ||
         (GcdMapEntry->GcdMemoryType == EfiGcdMemoryTypeReserved) ||
         ((GcdMapEntry->GcdMemoryType == EfiGcdMemoryTypeMemoryMappedIo) &&
          ((GcdMapEntry->Attributes & EFI_MEMORY_RUNTIME) == EFI_MEMORY_RUNTIME)))
@@ -1947,6 +2127,31 @@ CoreGetMemoryMap (
       MemoryMap = MergeMemoryMapDescriptor (MemoryMapStart, MemoryMap, Size);
     }
 
+    if (MergeGcdMapEntry.GcdMemoryType == EfiGcdMemoryTypeUnaccepted) {
+      //
+      // Page Align GCD range is required. When it is converted to EFI_MEMORY_DESCRIPTOR,
+      // it will be recorded as page PhysicalStart and NumberOfPages.
+      //
+      ASSERT ((MergeGcdMapEntry.BaseAddress & EFI_PAGE_MASK) == 0);
+      ASSERT (((MergeGcdMapEntry.EndAddress - MergeGcdMapEntry.BaseAddress + 1) & EFI_PAGE_MASK) == 0);
+
+      //
+      // Create EFI_MEMORY_DESCRIPTOR for every Unaccepted GCD entries
+      //
+      MemoryMap->PhysicalStart = MergeGcdMapEntry.BaseAddress;
+      MemoryMap->VirtualStart  = 0;
+      MemoryMap->NumberOfPages = RShiftU64 ((MergeGcdMapEntry.EndAddress - MergeGcdMapEntry.BaseAddress + 1), EFI_PAGE_SHIFT);
+      MemoryMap->Attribute     = MergeGcdMapEntry.Attributes |
+                                 (MergeGcdMapEntry.Capabilities & (EFI_CACHE_ATTRIBUTE_MASK | EFI_MEMORY_ATTRIBUTE_MASK));
+      MemoryMap->Type = EfiUnacceptedMemoryType;
+
+      //
+      // Check to see if the new Memory Map Descriptor can be merged with an
+      // existing descriptor if they are adjacent and have the same attributes
+      //
+      MemoryMap = MergeMemoryMapDescriptor (MemoryMapStart, MemoryMap, Size);
+    }
+
     if (Link == &mGcdMemorySpaceMap) {
       //
       // break loop when arrive at head.
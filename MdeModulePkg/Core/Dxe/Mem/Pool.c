@@ -57,6 +57,18 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_LIST  (ARRAY_SIZE (mPoolSizeTable))
 
+//
+// All entries of mPoolSizeTable are multiples of POOL_SIZE_CLASS_UNIT, so a
+// size can be mapped to its bin in constant time through mPoolIndexTable,
+// which holds the bin index for every POOL_SIZE_CLASS_UNIT sized step up to
+// the largest bin.
+//
+#define POOL_SIZE_CLASS_SHIFT  7
+#define POOL_SIZE_CLASS_UNIT   (1 << POOL_SIZE_CLASS_SHIFT)
+#define POOL_SIZE_CLASS_COUNT  (29824 / POOL_SIZE_CLASS_UNIT)
+
+STATIC UINT8  mPoolIndexTable[POOL_SIZE_CLASS_COUNT];
+
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
 //
@@ -68,6 +80,10 @@ typedef struct {
   INTN               Signature;
   UINTN              Used;
   EFI_MEMORY_TYPE    MemoryType;
+  //
+  // Bit N is set when FreeList[N] is not empty.
+  //
+  UINT32             FreeListBitmap;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
   LIST_ENTRY         Link;
 } POOL;
@@ -82,6 +98,11 @@ POOL  mPoolHead[EfiMaxMemoryType];
 //
 LIST_ENTRY  mPoolHeadList = INITIALIZE_LIST_HEAD_VARIABLE (mPoolHeadList);
 
+//
+// Pool header of the OS/OEM memory type that was looked up last.
+//
+STATIC POOL  *mLastPoolHead = NULL;
+
 /**
   Get pool size table index from the specified size.
 
@@ -96,15 +117,94 @@ GetPoolIndexFromSize (
   UINTN  Size
   )
 {
-  UINTN  Index;
+  if ((Size == 0) || (Size > LIST_TO_SIZE (MAX_POOL_LIST - 1))) {
+    return (Size == 0) ? 0 : MAX_POOL_LIST;
+  }
 
-  for (Index = 0; Index < MAX_POOL_LIST; Index++) {
-    if (mPoolSizeTable[Index] >= Size) {
-      return Index;
-    }
+  return mPoolIndexTable[(Size - 1) >> POOL_SIZE_CLASS_SHIFT];
+}
+
+/**
+  Put a free block onto the free list of the specified bin and mark the bin
+  as non-empty.
+
+  @param  Pool          The pool header owning the free list.
+  @param  Free          The free block to insert.
+  @param  Index         The bin index of the free block.
+
+**/
+STATIC
+VOID
+InsertPoolFreeBlock (
+  IN POOL       *Pool,
+  IN POOL_FREE  *Free,
+  IN UINTN      Index
+  )
+{
+  ASSERT (Index < MAX_POOL_LIST);
+
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32)Index;
+  InsertHeadList (&Pool->FreeList[Index], &Free->Link);
+  Pool->FreeListBitmap |= (UINT32)(1 << Index);
+}
+
+/**
+  Take a free block off its free list and clear the bin bit once the bin
+  becomes empty.
+
+  @param  Pool          The pool header owning the free list.
+  @param  Free          The free block to remove.
+
+**/
+STATIC
+VOID
+RemovePoolFreeBlock (
+  IN POOL       *Pool,
+  IN POOL_FREE  *Free
+  )
+{
+  ASSERT (Free->Index < MAX_POOL_LIST);
+
+  RemoveEntryList (&Free->Link);
+  if (IsListEmpty (&Pool->FreeList[Free->Index])) {
+    Pool->FreeListBitmap &= ~(UINT32)(1 << Free->Index);
   }
+}
+
+/**
+  Find the smallest non-empty bin in the range [MinIndex, MaxIndex).
+
+  @param  Pool          The pool header to search.
+  @param  MinIndex      The first bin index to consider.
+  @param  MaxIndex      The bin index at which the search stops.
 
-  return MAX_POOL_LIST;
+  @return               The index of the bin found, or MaxIndex if all bins
+                        in the range are empty.
+
+**/
+STATIC
+UINTN
+FindNonEmptyPoolBin (
+  IN POOL   *Pool,
+  IN UINTN  MinIndex,
+  IN UINTN  MaxIndex
+  )
+{
+  UINT32  Bitmap;
+
+  if (MinIndex >= MaxIndex) {
+    return MaxIndex;
+  }
+
+  Bitmap  = Pool->FreeListBitmap;
+  Bitmap &= ~(UINT32)((1 << MinIndex) - 1);
+  Bitmap &= (UINT32)((1 << MaxIndex) - 1);
+  if (Bitmap == 0) {
+    return MaxIndex;
+  }
+
+  return (UINTN)LowBitSet32 (Bitmap);
 }
 
 /**
@@ -118,11 +218,25 @@ CoreInitializePool (
 {
   UINTN  Type;
   UINTN  Index;
+  UINTN  Class;
+
+  ASSERT (MAX_POOL_LIST <= 32);
+  ASSERT (LIST_TO_SIZE (MAX_POOL_LIST - 1) == POOL_SIZE_CLASS_COUNT * POOL_SIZE_CLASS_UNIT);
+
+  Index = 0;
+  for (Class = 0; Class < POOL_SIZE_CLASS_COUNT; Class++) {
+    while (LIST_TO_SIZE (Index) < (Class + 1) * POOL_SIZE_CLASS_UNIT) {
+      Index++;
+    }
+
+    mPoolIndexTable[Class] = (UINT8)Index;
+  }
 
   for (Type = 0; Type < EfiMaxMemoryType; Type++) {
-    mPoolHead[Type].Signature  = 0;
-    mPoolHead[Type].Used       = 0;
-    mPoolHead[Type].MemoryType = (EFI_MEMORY_TYPE)Type;
+    mPoolHead[Type].Signature      = 0;
+    mPoolHead[Type].Used           = 0;
+    mPoolHead[Type].MemoryType     = (EFI_MEMORY_TYPE)Type;
+    mPoolHead[Type].FreeListBitmap = 0;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
@@ -156,9 +270,14 @@ LookupPoolHead (
   // MemoryType values in the range 0x70000000..0x7FFFFFFF are reserved for OEM use.
   //
   if ((UINT32)MemoryType >= MEMORY_TYPE_OEM_RESERVED_MIN) {
+    if ((mLastPoolHead != NULL) && (mLastPoolHead->MemoryType == MemoryType)) {
+      return mLastPoolHead;
+    }
+
     for (Link = mPoolHeadList.ForwardLink; Link != &mPoolHeadList; Link = Link->ForwardLink) {
       Pool = CR (Link, POOL, Link, POOL_SIGNATURE);
       if (Pool->MemoryType == MemoryType) {
+        mLastPoolHead = Pool;
         return Pool;
       }
     }
@@ -168,14 +287,16 @@ LookupPoolHead (
       return NULL;
     }
 
-    Pool->Signature  = POOL_SIGNATURE;
-    Pool->Used       = 0;
-    Pool->MemoryType = MemoryType;
+    Pool->Signature      = POOL_SIGNATURE;
+    Pool->Used           = 0;
+    Pool->MemoryType     = MemoryType;
+    Pool->FreeListBitmap = 0;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
     }
 
     InsertHeadList (&mPoolHeadList, &Pool->Link);
+    mLastPoolHead = Pool;
 
     return Pool;
   }
@@ -194,6 +315,7 @@ LookupPoolHead (
   @retval EFI_INVALID_PARAMETER  Buffer is NULL.
                                  PoolType is in the range EfiMaxMemoryType..0x6FFFFFFF.
                                  PoolType is EfiPersistentMemory.
+                                 PoolType is EfiUnacceptedMemoryType.
   @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
   @retval EFI_SUCCESS            Pool successfully allocated.
 
@@ -213,7 +335,8 @@ CoreInternalAllocatePool (
   // If it's not a valid type, fail it
   //
   if (((PoolType >= EfiMaxMemoryType) && (PoolType < MEMORY_TYPE_OEM_RESERVED_MIN)) ||
-      (PoolType == EfiConventionalMemory) || (PoolType == EfiPersistentMemory))
+      (PoolType == EfiConventionalMemory) || (PoolType == EfiPersistentMemory) ||
+      (PoolType == EfiUnacceptedMemoryType))
   {
     return EFI_INVALID_PARAMETER;
   }
@@ -232,7 +355,8 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding;
+  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding &&
+              IsGuardSampled ();
 
   //
   // Acquire the memory lock and make the allocation
@@ -258,6 +382,7 @@ CoreInternalAllocatePool (
   @retval EFI_INVALID_PARAMETER  Buffer is NULL.
                                  PoolType is in the range EfiMaxMemoryType..0x6FFFFFFF.
                                  PoolType is EfiPersistentMemory.
+                                 PoolType is EfiUnacceptedMemoryType.
   @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
   @retval EFI_SUCCESS            Pool successfully allocated.
 
@@ -426,21 +551,21 @@ CoreAllocatePoolI (
   //
   // If there's no free pool in the proper list size, go get some more pages
   //
-  if (IsListEmpty (&Pool->FreeList[Index])) {
+  if ((Pool->FreeListBitmap & (1 << Index)) == 0) {
+    ASSERT (IsListEmpty (&Pool->FreeList[Index]));
     Offset    = LIST_TO_SIZE (Index);
     MaxOffset = Granularity;
 
     //
     // Check the bins holding larger blocks, and carve one up if needed
     //
-    while (++Index < SIZE_TO_LIST (Granularity)) {
-      if (!IsListEmpty (&Pool->FreeList[Index])) {
-        Free = CR (Pool->FreeList[Index].ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
-        RemoveEntryList (&Free->Link);
-        NewPage   = (VOID *)Free;
-        MaxOffset = LIST_TO_SIZE (Index);
-        goto Carve;
-      }
+    Index = FindNonEmptyPoolBin (Pool, Index + 1, SIZE_TO_LIST (Granularity));
+    if (Index < SIZE_TO_LIST (Granularity)) {
+      Free = CR (Pool->FreeList[Index].ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
+      RemovePoolFreeBlock (Pool, Free);
+      NewPage   = (VOID *)Free;
+      MaxOffset = LIST_TO_SIZE (Index);
+      goto Carve;
     }
 
     //
@@ -471,10 +596,8 @@ Carve:
       FSize = LIST_TO_SIZE (Index);
 
       while (Offset + FSize <= MaxOffset) {
-        Free            = (POOL_FREE *)&NewPage[Offset];
-        Free->Signature = POOL_FREE_SIGNATURE;
-        Free->Index     = (UINT32)Index;
-        InsertHeadList (&Pool->FreeList[Index], &Free->Link);
+        Free = (POOL_FREE *)&NewPage[Offset];
+        InsertPoolFreeBlock (Pool, Free, Index);
         Offset += FSize;
       }
 
@@ -489,7 +612,7 @@ Carve:
   // Remove entry from free pool list
   //
   Free = CR (Pool->FreeList[Index].ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
-  RemoveEntryList (&Free->Link);
+  RemovePoolFreeBlock (Pool, Free);
 
   Head = (POOL_HEAD *)Free;
 
@@ -802,9 +925,7 @@ CoreFreePoolI (
     //
     Free = (POOL_FREE *)Head;
     ASSERT (Free != NULL);
-    Free->Signature = POOL_FREE_SIGNATURE;
-    Free->Index     = (UINT32)Index;
-    InsertHeadList (&Pool->FreeList[Index], &Free->Link);
+    InsertPoolFreeBlock (Pool, Free, Index);
 
     //
     // See if all the pool entries in the same page as Free are freed pool
@@ -841,7 +962,7 @@ CoreFreePoolI (
         while (Offset < Granularity) {
           Free = (POOL_FREE *)&NewPage[Offset];
           ASSERT (Free != NULL);
-          RemoveEntryList (&Free->Link);
+          RemovePoolFreeBlock (Pool, Free);
           Offset += LIST_TO_SIZE (Free->Index);
         }
 
@@ -863,6 +984,10 @@ CoreFreePoolI (
   // list entry for that memory type
   //
   if (((UINT32)Pool->MemoryType >= MEMORY_TYPE_OEM_RESERVED_MIN) && (Pool->Used == 0)) {
+    if (mLastPoolHead == Pool) {
+      mLastPoolHead = NULL;
+    }
+
     RemoveEntryList (&Pool->Link);
     CoreFreePoolI (Pool, NULL);
   }
@@ -92,6 +92,15 @@ typedef struct {
   VOID                        *Registration;
 } RPN_EVENT_CONTEXT;
 
+//
+// Scratch buffers are pooled in power-of-two buckets from 4KB to 1MB, one free
+// buffer per bucket.
+//
+#define SCRATCH_BUFFER_POOL_MIN_SHIFT  12
+#define SCRATCH_BUFFER_POOL_BUCKETS    9
+#define SCRATCH_BUFFER_POOL_BUCKET_SIZE(Bucket) \
+  ((UINTN)1 << ((Bucket) + SCRATCH_BUFFER_POOL_MIN_SHIFT))
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -196,6 +205,9 @@ EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol =
   CustomGuidedSectionExtract
 };
 
+VOID      *mScratchBufferPool[SCRATCH_BUFFER_POOL_BUCKETS];
+EFI_LOCK  mScratchBufferPoolLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+
 /**
   Entry point of the section extraction code. Initializes an instance of the
   section extraction interface and installs it on a new handle.
@@ -640,6 +652,109 @@ CreateGuidedExtractionRpnEvent (
                                 );
 }
 
+/**
+  Worker function.  Find the scratch buffer pool bucket for a size.
+
+  @param  Size          The size in bytes of the scratch buffer.
+
+  @return The bucket index, or SCRATCH_BUFFER_POOL_BUCKETS if Size is larger
+          than the largest pooled buffer.
+
+**/
+UINTN
+GetScratchBufferBucket (
+  IN UINTN  Size
+  )
+{
+  UINTN  Bucket;
+
+  for (Bucket = 0; Bucket < SCRATCH_BUFFER_POOL_BUCKETS; Bucket++) {
+    if (Size <= SCRATCH_BUFFER_POOL_BUCKET_SIZE (Bucket)) {
+      break;
+    }
+  }
+
+  return Bucket;
+}
+
+/**
+  Worker function.  Get a scratch buffer for one decompression or GUIDed
+  section decode.
+
+  Requests up to the largest pool bucket are rounded up to a power of two and
+  served from the scratch buffer pool when a buffer of that bucket is free, so
+  nested and repeated FV decodes do not allocate and free the same sizes over
+  and over. Larger requests are allocated directly.
+
+  @param  Size          The size in bytes of the scratch buffer needed.
+
+  @return A pointer to the scratch buffer, or NULL if it cannot be allocated.
+          Release it with CoreFreeScratchBuffer() using the same Size.
+
+**/
+VOID *
+CoreAllocateScratchBuffer (
+  IN UINTN  Size
+  )
+{
+  UINTN  Bucket;
+  VOID   *Buffer;
+
+  Bucket = GetScratchBufferBucket (Size);
+  if (Bucket >= SCRATCH_BUFFER_POOL_BUCKETS) {
+    return AllocatePool (Size);
+  }
+
+  CoreAcquireLock (&mScratchBufferPoolLock);
+  Buffer                     = mScratchBufferPool[Bucket];
+  mScratchBufferPool[Bucket] = NULL;
+  CoreReleaseLock (&mScratchBufferPoolLock);
+
+  if (Buffer == NULL) {
+    Buffer = AllocatePool (SCRATCH_BUFFER_POOL_BUCKET_SIZE (Bucket));
+  }
+
+  return Buffer;
+}
+
+/**
+  Worker function.  Return a scratch buffer from CoreAllocateScratchBuffer().
+
+  The buffer is kept in the scratch buffer pool if its bucket is empty, and
+  freed otherwise.
+
+  @param  Buffer        The scratch buffer to release. May be NULL.
+  @param  Size          The size passed to CoreAllocateScratchBuffer().
+
+**/
+VOID
+CoreFreeScratchBuffer (
+  IN VOID   *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN  Bucket;
+
+  if (Buffer == NULL) {
+    return;
+  }
+
+  Bucket = GetScratchBufferBucket (Size);
+  if (Bucket < SCRATCH_BUFFER_POOL_BUCKETS) {
+    CoreAcquireLock (&mScratchBufferPoolLock);
+    if (mScratchBufferPool[Bucket] == NULL) {
+      mScratchBufferPool[Bucket] = Buffer;
+      Buffer                     = NULL;
+    }
+
+    CoreReleaseLock (&mScratchBufferPoolLock);
+  }
+
+  if (Buffer != NULL) {
+    CoreFreePool (Buffer);
+  }
+}
+
 /**
   Worker function.  Constructor for new child nodes.
 
@@ -785,7 +900,7 @@ CreateChildNode (
             return Status;
           }
 
-          ScratchBuffer = AllocatePool (ScratchSize);
+          ScratchBuffer = CoreAllocateScratchBuffer (ScratchSize);
           if (ScratchBuffer == NULL) {
             CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
@@ -801,7 +916,7 @@ CreateChildNode (
                                  ScratchBuffer,
                                  ScratchSize
                                  );
-          CoreFreePool (ScratchBuffer);
+          CoreFreeScratchBuffer (ScratchBuffer, ScratchSize);
           if (EFI_ERROR (Status)) {
             CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
@@ -1581,7 +1696,7 @@ CustomGuidedSectionExtract (
     //
     // Allocate scratch buffer
     //
-    ScratchBuffer = AllocatePool (ScratchBufferSize);
+    ScratchBuffer = CoreAllocateScratchBuffer (ScratchBufferSize);
     if (ScratchBuffer == NULL) {
       return EFI_OUT_OF_RESOURCES;
     }
@@ -1593,9 +1708,7 @@ CustomGuidedSectionExtract (
     //
     AllocatedOutputBuffer = AllocatePool (OutputBufferSize);
     if (AllocatedOutputBuffer == NULL) {
-      if (ScratchBuffer != NULL) {
-        FreePool (ScratchBuffer);
-      }
+      CoreFreeScratchBuffer (ScratchBuffer, ScratchBufferSize);
 
       return EFI_OUT_OF_RESOURCES;
     }
@@ -1620,9 +1733,7 @@ CustomGuidedSectionExtract (
       CoreFreePool (AllocatedOutputBuffer);
     }
 
-    if (ScratchBuffer != NULL) {
-      CoreFreePool (ScratchBuffer);
-    }
+    CoreFreeScratchBuffer (ScratchBuffer, ScratchBufferSize);
 
     DEBUG ((DEBUG_ERROR, "Extract guided section Failed - %r\n", Status));
     return Status;
@@ -1643,11 +1754,9 @@ CustomGuidedSectionExtract (
   *OutputSize = (UINTN)OutputBufferSize;
 
   //
-  // Free unused scratch buffer.
+  // Return the scratch buffer to the pool.
   //
-  if (ScratchBuffer != NULL) {
-    CoreFreePool (ScratchBuffer);
-  }
+  CoreFreeScratchBuffer (ScratchBuffer, ScratchBufferSize);
 
   return EFI_SUCCESS;
 }
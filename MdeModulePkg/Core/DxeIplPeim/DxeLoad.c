@@ -511,6 +511,64 @@ DxeIplFindDxeCore (
   }
 }
 
+/**
+  Return a scratch buffer of at least ScratchBufferSize bytes for one section
+  decode.
+
+  The buffer is recorded in the gEdkiiSectionScratchBufferHobGuid HOB and reused
+  by later decodes, so the caller must not free it. When a larger buffer is
+  needed, the pages are rounded up to a power of two so that a handful of
+  growth steps cover every section in the platform.
+
+  @param  ScratchBufferSize  The size in bytes of the scratch buffer needed.
+
+  @return A pointer to the scratch buffer, or NULL if it cannot be allocated.
+
+**/
+VOID *
+GetSectionScratchBuffer (
+  IN UINT32  ScratchBufferSize
+  )
+{
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  EDKII_SECTION_SCRATCH_BUFFER  *Scratch;
+  UINTN                         Pages;
+  VOID                          *Buffer;
+
+  Pages   = EFI_SIZE_TO_PAGES (ScratchBufferSize);
+  GuidHob = GetFirstGuidHob (&gEdkiiSectionScratchBufferHobGuid);
+  if (GuidHob != NULL) {
+    Scratch = GET_GUID_HOB_DATA (GuidHob);
+    if (Scratch->Pages >= Pages) {
+      return (VOID *)(UINTN)Scratch->Buffer;
+    }
+  } else {
+    Scratch = BuildGuidHob (&gEdkiiSectionScratchBufferHobGuid, sizeof (EDKII_SECTION_SCRATCH_BUFFER));
+    if (Scratch == NULL) {
+      return AllocatePages (Pages);
+    }
+
+    ZeroMem (Scratch, sizeof (EDKII_SECTION_SCRATCH_BUFFER));
+  }
+
+  if ((Pages & (Pages - 1)) != 0) {
+    Pages = (UINTN)GetPowerOfTwo64 (Pages) << 1;
+  }
+
+  Buffer = AllocatePages (Pages);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+
+  if (Scratch->Pages != 0) {
+    FreePages ((VOID *)(UINTN)Scratch->Buffer, Scratch->Pages);
+  }
+
+  Scratch->Buffer = (EFI_PHYSICAL_ADDRESS)(UINTN)Buffer;
+  Scratch->Pages  = Pages;
+  return Buffer;
+}
+
 /**
   The ExtractSection() function processes the input section and
   returns a pointer to the section contents. If the section being
@@ -605,7 +663,7 @@ CustomGuidedSectionExtract (
     //
     // Allocate scratch buffer
     //
-    ScratchBuffer = AllocatePages (EFI_SIZE_TO_PAGES (ScratchBufferSize));
+    ScratchBuffer = GetSectionScratchBuffer (ScratchBufferSize);
     if (ScratchBuffer == NULL) {
       return EFI_OUT_OF_RESOURCES;
     }
@@ -725,7 +783,7 @@ Decompress (
         //
         // Allocate scratch buffer
         //
-        ScratchBuffer = AllocatePages (EFI_SIZE_TO_PAGES (ScratchBufferSize));
+        ScratchBuffer = GetSectionScratchBuffer (ScratchBufferSize);
         if (ScratchBuffer == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -766,18 +824,15 @@ Decompress (
 
     case EFI_NOT_COMPRESSED:
       //
-      // Allocate destination buffer
+      // Stream is not actually compressed, just encapsulated. The caller only
+      // reads the section stream, so return it in place instead of copying it.
       //
-      DstBufferSize = UncompressedLength;
-      DstBuffer     = AllocatePages (EFI_SIZE_TO_PAGES (DstBufferSize));
-      if (DstBuffer == NULL) {
-        return EFI_OUT_OF_RESOURCES;
+      if (UncompressedLength > CompressionSourceSize) {
+        return EFI_NOT_FOUND;
       }
 
-      //
-      // stream is not actually compressed, just encapsulated.  So just copy it.
-      //
-      CopyMem (DstBuffer, CompressionSource, DstBufferSize);
+      DstBufferSize = UncompressedLength;
+      DstBuffer     = CompressionSource;
       break;
 
     default:
@@ -661,6 +661,57 @@ EnablePageTableProtection (
   AsmWriteCr0 (AsmReadCr0 () | CR0_WP);
 }
 
+/**
+  Return the number of physical address bits needed to map everything the HOB
+  list describes.
+
+  The resource descriptor, memory allocation and firmware volume HOBs, the
+  stack and the GHCB are taken into account. The first 4GB are always covered.
+
+  @param[in] StackBase  Stack base address.
+  @param[in] StackSize  Stack size.
+  @param[in] GhcbBase   GHCB base address.
+  @param[in] GhcbSize   GHCB size.
+
+  @return The number of physical address bits needed.
+
+**/
+UINT8
+GetPopulatedAddressBits (
+  IN EFI_PHYSICAL_ADDRESS  StackBase,
+  IN UINTN                 StackSize,
+  IN EFI_PHYSICAL_ADDRESS  GhcbBase,
+  IN UINTN                 GhcbSize
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  UINT64                Top;
+
+  Top = MAX (BASE_4GB, StackBase + StackSize);
+  Top = MAX (Top, GhcbBase + GhcbSize);
+
+  for (Hob.Raw = GetHobList (); !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    switch (GET_HOB_TYPE (Hob)) {
+      case EFI_HOB_TYPE_RESOURCE_DESCRIPTOR:
+        Top = MAX (Top, Hob.ResourceDescriptor->PhysicalStart + Hob.ResourceDescriptor->ResourceLength);
+        break;
+
+      case EFI_HOB_TYPE_MEMORY_ALLOCATION:
+        Top = MAX (Top, Hob.MemoryAllocation->AllocDescriptor.MemoryBaseAddress + Hob.MemoryAllocation->AllocDescriptor.MemoryLength);
+        break;
+
+      case EFI_HOB_TYPE_FV:
+        Top = MAX (Top, Hob.FirmwareVolume->BaseAddress + Hob.FirmwareVolume->Length);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return (UINT8)(HighBitSet64 (Top - 1) + 1);
+}
+
 /**
   Allocates and fills in the Page Directory and Page Table Entries to
   establish a 1:1 Virtual to Physical mapping.
@@ -685,6 +736,7 @@ CreateIdentityMappingPageTables (
   CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_ECX  EcxFlags;
   UINT32                                       RegEdx;
   UINT8                                        PhysicalAddressBits;
+  UINT8                                        PopulatedAddressBits;
   EFI_PHYSICAL_ADDRESS                         PageAddress;
   UINTN                                        IndexOfPml5Entries;
   UINTN                                        IndexOfPml4Entries;
@@ -744,6 +796,18 @@ CreateIdentityMappingPageTables (
     }
   }
 
+  //
+  // Page tables for the whole address space take a lot of memory and time to
+  // build with wide addresses (e.g. 52 bits), most of which is never used.
+  //
+  if (FeaturePcdGet (PcdDxeIplMapPopulatedRangesOnly)) {
+    PopulatedAddressBits = GetPopulatedAddressBits (StackBase, StackSize, GhcbBase, GhcbSize);
+    DEBUG ((DEBUG_INFO, "PopulatedAddressBits=%u\n", PopulatedAddressBits));
+    if (PopulatedAddressBits < PhysicalAddressBits) {
+      PhysicalAddressBits = PopulatedAddressBits;
+    }
+  }
+
   Page5LevelSupport = FALSE;
   if (PcdGetBool (PcdUse5LevelPageTable)) {
     AsmCpuidEx (
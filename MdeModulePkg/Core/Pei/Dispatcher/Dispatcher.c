@@ -1134,10 +1134,20 @@ MigratePeimsInFv (
 
         MigratedFileHandle = (EFI_PEI_FILE_HANDLE)((UINTN)FileHandle - OrgFvHandle + FvHandle);
 
-        DEBUG ((DEBUG_VERBOSE, "    Migrating FileHandle %2d ", FileIndex));
-        Status = MigratePeim (FileHandle, MigratedFileHandle);
-        DEBUG ((DEBUG_VERBOSE, "\n"));
-        ASSERT_EFI_ERROR (Status);
+        //
+        // A PEIM that has not been dispatched yet has no code or data in use. It is
+        // loaded into its own pages from the migrated FV when it is dispatched, so
+        // relocating it in place here would be wasted.
+        //
+        if (Private->Fv[FvIndex].PeimState[FileIndex] == PEIM_STATE_NOT_DISPATCHED) {
+          DEBUG ((DEBUG_VERBOSE, "    Skipping undispatched FileHandle %2d\n", FileIndex));
+          Status = EFI_SUCCESS;
+        } else {
+          DEBUG ((DEBUG_VERBOSE, "    Migrating FileHandle %2d ", FileIndex));
+          Status = MigratePeim (FileHandle, MigratedFileHandle);
+          DEBUG ((DEBUG_VERBOSE, "\n"));
+          ASSERT_EFI_ERROR (Status);
+        }
 
         if (!EFI_ERROR (Status)) {
           Private->Fv[FvIndex].FvFileHandles[FileIndex] = MigratedFileHandle;
@@ -262,8 +262,9 @@ FileHandleToVolume (
   @retval EFI_SUCCESS    Success to search given file
 
 **/
+STATIC
 EFI_STATUS
-FindFileEx (
+ScanFvForFile (
   IN  CONST EFI_PEI_FV_HANDLE    FvHandle,
   IN  CONST EFI_GUID             *FileName    OPTIONAL,
   IN        EFI_FV_FILETYPE      SearchType,
@@ -455,6 +456,196 @@ FindFileEx (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Build the file table of a firmware volume. The table lists, in FV order,
+  the offset of every file that ScanFvForFile () can return, so that
+  searches do not validate the file headers in flash again. Pad files are
+  left out, as no search type returns them.
+
+  The table is sized by a first scan and filled by a second one, because
+  pool allocated in temporary RAM cannot be freed or grown.
+
+  @param CoreFvHandle    The PEI_CORE_FV_HANDLE of the firmware volume.
+
+  @retval TRUE           The file table can be used.
+  @retval FALSE          The firmware volume has to be scanned.
+
+**/
+STATIC
+BOOLEAN
+GetFvFileTable (
+  IN OUT PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EFI_PEI_FILE_HANDLE  FileHandle;
+  UINT32               Count;
+
+  if (CoreFvHandle->FileTableBuilt) {
+    return (BOOLEAN)(CoreFvHandle->FileTable != NULL);
+  }
+
+  CoreFvHandle->FileTableBuilt = TRUE;
+
+  Count      = 0;
+  FileHandle = NULL;
+  while (!EFI_ERROR (ScanFvForFile (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    Count++;
+  }
+
+  if (Count == 0) {
+    return FALSE;
+  }
+
+  CoreFvHandle->FileTable = AllocatePool (Count * sizeof (UINT32));
+  if (CoreFvHandle->FileTable == NULL) {
+    return FALSE;
+  }
+
+  CoreFvHandle->FileTableCount = 0;
+  FileHandle                   = NULL;
+  while ((CoreFvHandle->FileTableCount < Count) &&
+         !EFI_ERROR (ScanFvForFile (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL)))
+  {
+    CoreFvHandle->FileTable[CoreFvHandle->FileTableCount++] = (UINT32)((UINTN)FileHandle - (UINTN)CoreFvHandle->FvHandle);
+  }
+
+  return TRUE;
+}
+
+/**
+  Search the file table of a firmware volume, applying the same filters as
+  ScanFvForFile ().
+
+  @param CoreFvHandle    The PEI_CORE_FV_HANDLE of the firmware volume.
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+STATIC
+EFI_STATUS
+FindFileInFvFileTable (
+  IN        PEI_CORE_FV_HANDLE   *CoreFvHandle,
+  IN  CONST EFI_GUID             *FileName    OPTIONAL,
+  IN        EFI_FV_FILETYPE      SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE  *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE  *AprioriFile  OPTIONAL
+  )
+{
+  EFI_FFS_FILE_HEADER  *FfsFileHeader;
+  UINTN                Offset;
+  UINT32               Index;
+  UINT32               Low;
+  UINT32               High;
+
+  //
+  // Start with the first file, or with the first file after *FileHandle.
+  //
+  Index = 0;
+  if ((*FileHandle != NULL) && (FileName == NULL)) {
+    Offset = (UINTN)*FileHandle - (UINTN)CoreFvHandle->FvHandle;
+    Low    = 0;
+    High   = CoreFvHandle->FileTableCount;
+    while (Low < High) {
+      Index = Low + (High - Low) / 2;
+      if (CoreFvHandle->FileTable[Index] <= Offset) {
+        Low = Index + 1;
+      } else {
+        High = Index;
+      }
+    }
+
+    Index = Low;
+  }
+
+  for ( ; Index < CoreFvHandle->FileTableCount; Index++) {
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)CoreFvHandle->FvHandle + CoreFvHandle->FileTable[Index]);
+
+    if (FileName != NULL) {
+      if (CompareGuid (&FfsFileHeader->Name, (EFI_GUID *)FileName)) {
+        *FileHandle = (EFI_PEI_FILE_HANDLE)FfsFileHeader;
+        return EFI_SUCCESS;
+      }
+    } else if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      if ((FfsFileHeader->Type == EFI_FV_FILETYPE_PEIM) ||
+          (FfsFileHeader->Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (FfsFileHeader->Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE))
+      {
+        *FileHandle = (EFI_PEI_FILE_HANDLE)FfsFileHeader;
+        return EFI_SUCCESS;
+      } else if (AprioriFile != NULL) {
+        if (FfsFileHeader->Type == EFI_FV_FILETYPE_FREEFORM) {
+          if (CompareGuid (&FfsFileHeader->Name, &gPeiAprioriFileNameGuid)) {
+            *AprioriFile = (EFI_PEI_FILE_HANDLE)FfsFileHeader;
+          }
+        }
+      }
+    } else if ((SearchType == FfsFileHeader->Type) || (SearchType == EFI_FV_FILETYPE_ALL)) {
+      *FileHandle = (EFI_PEI_FILE_HANDLE)FfsFileHeader;
+      return EFI_SUCCESS;
+    }
+  }
+
+  *FileHandle = NULL;
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Given the input file pointer, search for the first matching file in the
+  FFS volume as defined by SearchType. The search starts from FileHeader inside
+  the Firmware Volume defined by FwVolHeader.
+  If SearchType is EFI_FV_FILETYPE_ALL, the first FFS file will return without check its file type.
+  If SearchType is PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE,
+  the first PEIM, or COMBINED PEIM or FV file type FFS file will return.
+
+  When PcdPeiCoreFvFileTableEnable is TRUE, firmware volumes known to the PEI
+  Core are searched through their file table instead of being scanned.
+
+  @param FvHandle        Pointer to the FV header of the volume to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+EFI_STATUS
+FindFileEx (
+  IN  CONST EFI_PEI_FV_HANDLE    FvHandle,
+  IN  CONST EFI_GUID             *FileName    OPTIONAL,
+  IN        EFI_FV_FILETYPE      SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE  *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE  *AprioriFile  OPTIONAL
+  )
+{
+  PEI_CORE_FV_HANDLE  *CoreFvHandle;
+
+  if (FeaturePcdGet (PcdPeiCoreFvFileTableEnable)) {
+    CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+    if ((CoreFvHandle != NULL) && GetFvFileTable (CoreFvHandle)) {
+      //
+      // A file handle outside of the FV cannot be located in the table.
+      //
+      if ((*FileHandle == NULL) || (FileName != NULL) ||
+          (((UINTN)*FileHandle > (UINTN)FvHandle) &&
+           ((UINTN)*FileHandle - (UINTN)FvHandle < ((EFI_FIRMWARE_VOLUME_HEADER *)FvHandle)->FvLength)))
+      {
+        return FindFileInFvFileTable (CoreFvHandle, FileName, SearchType, FileHandle, AprioriFile);
+      }
+    }
+  }
+
+  return ScanFvForFile (FvHandle, FileName, SearchType, FileHandle, AprioriFile);
+}
+
 /**
   Initialize PeiCore FV List.
 
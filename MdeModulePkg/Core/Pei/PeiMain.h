@@ -68,11 +68,22 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP  32
 #define DISPATCH_NOTIFY_GROWTH_STEP  8
 
+///
+/// Number of buckets of the PPI GUID index, must be a power of 2
+///
+#define PPI_HASH_BUCKETS  256
+
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
   UINTN                    LastDispatchedCount;
   ///
+  /// For each bucket, one plus the lowest index of the PPIs whose GUID hashes
+  /// to the bucket, or 0 if there is none. PeiLocatePpi() starts its search
+  /// there. Being indexes, the entries stay valid when the PPIs migrate.
+  ///
+  UINT16                   HashFirst[PPI_HASH_BUCKETS];
+  ///
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS    *PpiPtrs;
@@ -146,6 +157,14 @@ typedef struct {
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // Offsets from FvHandle of the files FindFileEx () can return, in FV
+  // order. Built on first use when PcdPeiCoreFvFileTableEnable is TRUE.
+  // The offsets stay valid when the FV is migrated to permanent memory.
+  //
+  UINT32                         *FileTable;
+  UINT32                         FileTableCount;
+  BOOLEAN                        FileTableBuilt;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
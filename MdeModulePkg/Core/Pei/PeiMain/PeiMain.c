@@ -236,6 +236,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileTable != NULL) {
+            OldCoreData->Fv[Index].FileTable = (UINT32 *)((UINT8 *)OldCoreData->Fv[Index].FileTable + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -271,6 +275,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileTable != NULL) {
+            OldCoreData->Fv[Index].FileTable = (UINT32 *)((UINT8 *)OldCoreData->Fv[Index].FileTable - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -427,6 +427,53 @@ DumpPpiList (
   DEBUG_CODE_END ();
 }
 
+/**
+  Get the bucket of a PPI GUID in PEI_PPI_LIST.HashFirst.
+
+  @param Guid           Pointer to the GUID of the PPI.
+
+  @return The index of the bucket.
+
+**/
+STATIC
+UINTN
+PpiHashBucket (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  return (((UINT32 *)Guid)[0] ^ ((UINT32 *)Guid)[1] ^
+          ((UINT32 *)Guid)[2] ^ ((UINT32 *)Guid)[3]) & (PPI_HASH_BUCKETS - 1);
+}
+
+/**
+  Record in the GUID index that a PPI has been put at an index of the PPI list.
+
+  @param PpiListPointer Pointer to the PPI list.
+  @param Index          The index of the PPI in the list.
+
+**/
+STATIC
+VOID
+PpiHashAdd (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         Index
+  )
+{
+  UINT16  *First;
+
+  First = &PpiListPointer->HashFirst[PpiHashBucket (PpiListPointer->PpiPtrs[Index].Ppi->Guid)];
+  if (Index >= MAX_UINT16) {
+    //
+    // Too far in the list to record, search the bucket from the start.
+    //
+    Index = 0;
+  }
+
+  if ((*First == 0) || (*First > Index + 1)) {
+    *First = (UINT16)(Index + 1);
+  }
+}
+
 /**
 
   This function installs an interface in the PEI PPI database by GUID.
@@ -482,6 +529,12 @@ InternalPeiInstallPpi (
     //
     if ((PpiList->Flags & EFI_PEI_PPI_DESCRIPTOR_PPI) == 0) {
       PpiListPointer->CurrentCount = LastCount;
+      for (Index = 0; Index < PPI_HASH_BUCKETS; Index++) {
+        if (PpiListPointer->HashFirst[Index] > LastCount) {
+          PpiListPointer->HashFirst[Index] = 0;
+        }
+      }
+
       DEBUG ((DEBUG_ERROR, "ERROR -> InstallPpi: %g %p\n", PpiList->Guid, PpiList->Ppi));
       return EFI_INVALID_PARAMETER;
     }
@@ -505,6 +558,7 @@ InternalPeiInstallPpi (
 
     DEBUG ((DEBUG_INFO, "Install PPI: %g\n", PpiList->Guid));
     PpiListPointer->PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)PpiList;
+    PpiHashAdd (PpiListPointer, Index);
     Index++;
     PpiListPointer->CurrentCount++;
 
@@ -625,6 +679,7 @@ PeiReInstallPpi (
   //
   DEBUG ((DEBUG_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  PpiHashAdd (&PrivateData->PpiData.PpiList, Index);
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -674,10 +729,18 @@ PeiLocatePpi (
 
   PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
 
+  //
+  // No PPI before the first one in the bucket of the GUID can match.
+  //
+  Index = PrivateData->PpiData.PpiList.HashFirst[PpiHashBucket (Guid)];
+  if (Index == 0) {
+    return EFI_NOT_FOUND;
+  }
+
   //
   // Search the data base for the matching instance of the GUIDed PPI.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
+  for (Index--; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
     TempPtr   = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
     CheckGuid = TempPtr->Guid;
 
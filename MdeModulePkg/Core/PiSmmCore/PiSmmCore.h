@@ -92,6 +92,9 @@ typedef struct {
   SMI_ENTRY                       *SmiEntry;
   VOID                            *Context;    // for profile
   UINTN                           ContextSize; // for profile
+  UINT64                          InvokeCount; // for profile statistics
+  UINT64                          TotalTime;   // for profile statistics
+  UINT64                          MaxTime;     // for profile statistics
 } SMI_HANDLER;
 
 //
@@ -1206,6 +1209,8 @@ SmiHandlerProfileUnregisterHandler (
   IN UINTN                         ContextSize OPTIONAL
   );
 
+extern BOOLEAN  mSmiHandlerProfileStatistics;
+
 extern UINTN                 mFullSmramRangeCount;
 extern EFI_SMRAM_DESCRIPTOR  *mFullSmramRanges;
 
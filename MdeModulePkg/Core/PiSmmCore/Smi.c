@@ -17,6 +17,12 @@ SMI_ENTRY  mRootSmiEntry = {
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
 };
 
+//
+// The SMI handler SmiManage() is running, for the SMI handler statistics.
+// It is cleared if that SMI handler unregisters itself.
+//
+SMI_HANDLER  *mSmiManageCurrentHandler = NULL;
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -106,8 +112,11 @@ SmiManage (
   LIST_ENTRY   *Head;
   SMI_ENTRY    *SmiEntry;
   SMI_HANDLER  *SmiHandler;
+  SMI_HANDLER  *PreviousHandler;
   BOOLEAN      SuccessReturn;
   EFI_STATUS   Status;
+  UINT64       StartTime;
+  UINT64       Time;
 
   Status        = EFI_NOT_FOUND;
   SuccessReturn = FALSE;
@@ -134,6 +143,13 @@ SmiManage (
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
 
+    StartTime       = 0;
+    PreviousHandler = mSmiManageCurrentHandler;
+    if (mSmiHandlerProfileStatistics) {
+      mSmiManageCurrentHandler = SmiHandler;
+      StartTime                = AsmReadTsc ();
+    }
+
     Status = SmiHandler->Handler (
                            (EFI_HANDLE)SmiHandler,
                            Context,
@@ -141,6 +157,19 @@ SmiManage (
                            CommBufferSize
                            );
 
+    if (mSmiHandlerProfileStatistics) {
+      if (mSmiManageCurrentHandler == SmiHandler) {
+        Time                   = AsmReadTsc () - StartTime;
+        SmiHandler->TotalTime += Time;
+        SmiHandler->InvokeCount++;
+        if (Time > SmiHandler->MaxTime) {
+          SmiHandler->MaxTime = Time;
+        }
+      }
+
+      mSmiManageCurrentHandler = PreviousHandler;
+    }
+
     switch (Status) {
       case EFI_INTERRUPT_PENDING:
         //
@@ -318,6 +347,10 @@ SmiHandlerUnRegister (
 
   SmiEntry = SmiHandler->SmiEntry;
 
+  if (mSmiManageCurrentHandler == SmiHandler) {
+    mSmiManageCurrentHandler = NULL;
+  }
+
   RemoveEntryList (&SmiHandler->Link);
   FreePool (SmiHandler);
 
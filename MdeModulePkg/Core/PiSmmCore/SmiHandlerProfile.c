@@ -98,6 +98,8 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmHardwareSmiDatabaseSize;
 
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileRecordingStatus;
 
+BOOLEAN  mSmiHandlerProfileStatistics = FALSE;
+
 GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER_PROFILE_PROTOCOL  mSmiHandlerProfile = {
   SmiHandlerProfileRegisterHandler,
   SmiHandlerProfileUnregisterHandler,
@@ -974,6 +976,109 @@ Done:
   mSmiHandlerProfileRecordingStatus = SmiHandlerProfileRecordingStatus;
 }
 
+/**
+  SMI handler profile handler to get the SMI handler statistics.
+
+  @param SmiHandlerProfileParameterGetStatistics   The parameter of SMI handler profile get statistics.
+
+**/
+VOID
+SmiHandlerProfileHandlerGetStatistics (
+  IN SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS  *SmiHandlerProfileParameterGetStatistics
+  )
+{
+  SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS  SmiHandlerProfileGetStatistics;
+  SMI_HANDLER_PROFILE_HANDLER_STATISTICS        *Statistics;
+  LIST_ENTRY                                    *SmiEntryList[2];
+  LIST_ENTRY                                    *EntryLink;
+  LIST_ENTRY                                    *HandlerLink;
+  SMI_ENTRY                                     *SmiEntry;
+  SMI_HANDLER                                   *SmiHandler;
+  UINTN                                         ListIndex;
+  UINT64                                        HandlerIndex;
+  UINT64                                        Size;
+
+  CopyMem (&SmiHandlerProfileGetStatistics, SmiHandlerProfileParameterGetStatistics, sizeof (SmiHandlerProfileGetStatistics));
+
+  //
+  // Sanity check
+  //
+  if (!SmmIsBufferOutsideSmmValid ((UINTN)SmiHandlerProfileGetStatistics.DataBuffer, (UINTN)SmiHandlerProfileGetStatistics.DataSize)) {
+    DEBUG ((DEBUG_ERROR, "SmiHandlerProfileHandlerGetStatistics: SMI handler profile get statistics in SMRAM or overflow!\n"));
+    SmiHandlerProfileParameterGetStatistics->Header.ReturnStatus = (UINT64)(INT64)(INTN)EFI_ACCESS_DENIED;
+    return;
+  }
+
+  Statistics      = (SMI_HANDLER_PROFILE_HANDLER_STATISTICS *)(UINTN)SmiHandlerProfileGetStatistics.DataBuffer;
+  Size            = 0;
+  HandlerIndex    = 0;
+  SmiEntryList[0] = mSmmCoreRootSmiEntryList;
+  SmiEntryList[1] = mSmmCoreSmiEntryList;
+  for (ListIndex = 0; ListIndex < ARRAY_SIZE (SmiEntryList); ListIndex++) {
+    for (EntryLink = SmiEntryList[ListIndex]->ForwardLink;
+         EntryLink != SmiEntryList[ListIndex];
+         EntryLink = EntryLink->ForwardLink)
+    {
+      SmiEntry = CR (EntryLink, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+      for (HandlerLink = SmiEntry->SmiHandlers.ForwardLink;
+           HandlerLink != &SmiEntry->SmiHandlers;
+           HandlerLink = HandlerLink->ForwardLink)
+      {
+        if (HandlerIndex++ < SmiHandlerProfileGetStatistics.HandlerIndex) {
+          continue;
+        }
+
+        if (SmiHandlerProfileGetStatistics.DataSize - Size < sizeof (*Statistics)) {
+          goto Done;
+        }
+
+        SmiHandler = CR (HandlerLink, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+        CopyGuid (&Statistics->HandlerType, &SmiEntry->HandlerType);
+        Statistics->Handler     = (UINTN)SmiHandler->Handler;
+        Statistics->InvokeCount = SmiHandler->InvokeCount;
+        Statistics->TotalTime   = SmiHandler->TotalTime;
+        Statistics->MaxTime     = SmiHandler->MaxTime;
+        Statistics++;
+        Size += sizeof (*Statistics);
+      }
+    }
+  }
+
+Done:
+  SmiHandlerProfileGetStatistics.HandlerIndex += DivU64x32 (Size, sizeof (*Statistics));
+  SmiHandlerProfileGetStatistics.DataSize      = Size;
+  CopyMem (SmiHandlerProfileParameterGetStatistics, &SmiHandlerProfileGetStatistics, sizeof (SmiHandlerProfileGetStatistics));
+  SmiHandlerProfileParameterGetStatistics->Header.ReturnStatus = 0;
+}
+
+/**
+  SMI handler profile handler to get the SMI rendezvous histogram.
+
+  @param SmiHandlerProfileParameterGetHistogram   The parameter of SMI handler profile get rendezvous histogram.
+
+**/
+VOID
+SmiHandlerProfileHandlerGetRendezvousHistogram (
+  IN SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM  *SmiHandlerProfileParameterGetHistogram
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < gSmmCoreSmst.NumberOfTableEntries; Index++) {
+    if (CompareGuid (&gSmmCoreSmst.SmmConfigurationTable[Index].VendorGuid, &gSmiRendezvousHistogramGuid)) {
+      CopyMem (
+        &SmiHandlerProfileParameterGetHistogram->Histogram,
+        gSmmCoreSmst.SmmConfigurationTable[Index].VendorTable,
+        sizeof (SMI_RENDEZVOUS_HISTOGRAM)
+        );
+      SmiHandlerProfileParameterGetHistogram->Header.ReturnStatus = 0;
+      return;
+    }
+  }
+
+  SmiHandlerProfileParameterGetHistogram->Header.ReturnStatus = (UINT64)(INT64)(INTN)EFI_NOT_FOUND;
+}
+
 /**
   Dispatch function for a Software SMI handler.
 
@@ -1048,6 +1153,24 @@ SmiHandlerProfileHandler (
 
       SmiHandlerProfileHandlerGetDataByOffset ((SMI_HANDLER_PROFILE_PARAMETER_GET_DATA_BY_OFFSET *)(UINTN)CommBuffer);
       break;
+    case SMI_HANDLER_PROFILE_COMMAND_GET_STATISTICS:
+      DEBUG ((DEBUG_ERROR, "SmiHandlerProfileHandlerGetStatistics\n"));
+      if (TempCommBufferSize != sizeof (SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS)) {
+        DEBUG ((DEBUG_ERROR, "SmiHandlerProfileHandler: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      SmiHandlerProfileHandlerGetStatistics ((SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS *)(UINTN)CommBuffer);
+      break;
+    case SMI_HANDLER_PROFILE_COMMAND_GET_RENDEZVOUS_HISTOGRAM:
+      DEBUG ((DEBUG_ERROR, "SmiHandlerProfileHandlerGetRendezvousHistogram\n"));
+      if (TempCommBufferSize != sizeof (SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM)) {
+        DEBUG ((DEBUG_ERROR, "SmiHandlerProfileHandler: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      SmiHandlerProfileHandlerGetRendezvousHistogram ((SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM *)(UINTN)CommBuffer);
+      break;
     default:
       break;
   }
@@ -1398,6 +1521,8 @@ SmmCoreInitializeSmiHandlerProfile (
   EFI_HANDLE  Handle;
 
   if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x1) != 0) {
+    mSmiHandlerProfileStatistics = (BOOLEAN)((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x2) != 0);
+
     InsertTailList (&mRootSmiEntryList, &mRootSmiEntry.AllEntries);
 
     Status = gSmst->SmmRegisterProtocolNotify (
@@ -23,7 +23,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been compressed using LZMA
+/// in independent chunks, which can be decoded at the same time.
+///
+#define LZMA_SPLIT_CUSTOM_DECOMPRESS_GUID  \
+  { 0x9F1AD0BC, 0x6448, 0x472B, { 0x98, 0xFD, 0x6D, 0xA7, 0xAA, 0xD7, 0x6D, 0x6E } }
+
 extern GUID  gLzmaCustomDecompressGuid;
 extern GUID  gLzmaF86CustomDecompressGuid;
+extern GUID  gLzmaSplitCustomDecompressGuid;
 
 #endif
@@ -0,0 +1,28 @@
+/** @file
+  Section extraction scratch buffer HOB.
+
+  The PEI GUIDed section extraction and decompression services only need their
+  scratch buffer for the duration of one decode, but PEI memory is handed out
+  in pages and rarely freed. This HOB records one scratch buffer that those
+  services share and reuse, growing it in power-of-two page steps when a
+  section needs more.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SECTION_SCRATCH_BUFFER_GUID_H__
+#define __EDKII_SECTION_SCRATCH_BUFFER_GUID_H__
+
+#define EDKII_SECTION_SCRATCH_BUFFER_HOB_GUID \
+  { 0xd22e3774, 0x629e, 0x4775, { 0x8c, 0xaf, 0xda, 0x2, 0xa4, 0xe5, 0x91, 0xf3 } }
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    Buffer;     // Base of the shared scratch buffer
+  UINTN                   Pages;      // Size of the buffer in pages
+} EDKII_SECTION_SCRATCH_BUFFER;
+
+extern EFI_GUID  gEdkiiSectionScratchBufferHobGuid;
+
+#endif // #ifndef __EDKII_SECTION_SCRATCH_BUFFER_GUID_H__
@@ -105,11 +105,44 @@ typedef struct {
 // +-------------------------------------+
 //
 
+//
+// Statistics of an SMI handler, with PcdSmiHandlerProfilePropertyMask BIT1.
+// The time is in the CPU time stamp counter ticks, and includes the time
+// of the SMI handlers called by this one.
+//
+typedef struct {
+  EFI_GUID            HandlerType;
+  PHYSICAL_ADDRESS    Handler;
+  UINT64              InvokeCount;
+  UINT64              TotalTime;
+  UINT64              MaxTime;
+} SMI_HANDLER_PROFILE_HANDLER_STATISTICS;
+
+#define SMI_RENDEZVOUS_HISTOGRAM_BUCKET_COUNT  32
+
+//
+// Histogram of the SMI time measured by the BSP in SMM, with
+// PcdSmiHandlerProfilePropertyMask BIT1. The time is in microseconds:
+// bucket 0 counts the SMIs that take less than 1 microsecond, bucket N the
+// SMIs that take 2^(N-1) to 2^N - 1 microseconds, and the last bucket all
+// longer SMIs. The rendezvous time is the time the BSP spends outside the
+// SMM Foundation entry point, mostly synchronizing with the APs.
+//
+typedef struct {
+  UINT64    SmiCount;
+  UINT64    MaxRendezvousTime;
+  UINT64    MaxTotalTime;
+  UINT64    RendezvousTime[SMI_RENDEZVOUS_HISTOGRAM_BUCKET_COUNT];
+  UINT64    TotalTime[SMI_RENDEZVOUS_HISTOGRAM_BUCKET_COUNT];
+} SMI_RENDEZVOUS_HISTOGRAM;
+
 //
 // SMM_CORE dump command
 //
-#define SMI_HANDLER_PROFILE_COMMAND_GET_INFO            0x1
-#define SMI_HANDLER_PROFILE_COMMAND_GET_DATA_BY_OFFSET  0x2
+#define SMI_HANDLER_PROFILE_COMMAND_GET_INFO                  0x1
+#define SMI_HANDLER_PROFILE_COMMAND_GET_DATA_BY_OFFSET        0x2
+#define SMI_HANDLER_PROFILE_COMMAND_GET_STATISTICS            0x3
+#define SMI_HANDLER_PROFILE_COMMAND_GET_RENDEZVOUS_HISTOGRAM  0x4
 
 typedef struct {
   UINT32    Command;
@@ -137,10 +170,40 @@ typedef struct {
   UINT64                                  DataOffset;
 } SMI_HANDLER_PROFILE_PARAMETER_GET_DATA_BY_OFFSET;
 
+typedef struct {
+  SMI_HANDLER_PROFILE_PARAMETER_HEADER    Header;
+  //
+  // On input, data buffer size.
+  // On output, actual data buffer size copied, 0 after the last handler.
+  //
+  UINT64                                  DataSize;
+  //
+  // Buffer of SMI_HANDLER_PROFILE_HANDLER_STATISTICS.
+  //
+  PHYSICAL_ADDRESS                        DataBuffer;
+  //
+  // On input, index of the first SMI handler to copy.
+  // On output, index of the next SMI handler to copy.
+  //
+  UINT64                                  HandlerIndex;
+} SMI_HANDLER_PROFILE_PARAMETER_GET_STATISTICS;
+
+typedef struct {
+  SMI_HANDLER_PROFILE_PARAMETER_HEADER    Header;
+  SMI_RENDEZVOUS_HISTOGRAM                Histogram;
+} SMI_HANDLER_PROFILE_PARAMETER_GET_RENDEZVOUS_HISTOGRAM;
+
 #define SMI_HANDLER_PROFILE_GUID  {0x49174342, 0x7108, 0x409b, {0x8b, 0xbe, 0x65, 0xfd, 0xa8, 0x53, 0x89, 0xf5}}
 
 extern EFI_GUID  gSmiHandlerProfileGuid;
 
+//
+// The GUID of the SMM configuration table of the SMI_RENDEZVOUS_HISTOGRAM.
+//
+#define SMI_RENDEZVOUS_HISTOGRAM_GUID  {0xa74a73e7, 0xf9ef, 0x4fde, {0xad, 0x5b, 0x7c, 0x0e, 0xca, 0x95, 0x58, 0xf0}}
+
+extern EFI_GUID  gSmiRendezvousHistogramGuid;
+
 typedef struct _SMI_HANDLER_PROFILE_PROTOCOL SMI_HANDLER_PROFILE_PROTOCOL;
 
 /**
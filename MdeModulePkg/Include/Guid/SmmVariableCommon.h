@@ -77,6 +77,10 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO  14
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH
+//
+#define SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH  15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -99,6 +103,27 @@ typedef struct {
   CHAR16      Name[1];
 } SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE;
 
+///
+/// This structure is used to communicate with SMI handler by the batched SetVariable.
+/// It is followed by VariableCount records. Each record is a SMM_VARIABLE_COMMUNICATE_BATCH_RECORD
+/// followed by the variable data, and takes SMM_VARIABLE_BATCH_RECORD_SIZE bytes.
+///
+typedef struct {
+  UINTN    VariableCount;
+} SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH;
+
+///
+/// One variable of a SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH request. Status returns the
+/// status of setting this variable.
+///
+typedef struct {
+  EFI_STATUS                                  Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE    Variable;
+} SMM_VARIABLE_COMMUNICATE_BATCH_RECORD;
+
+#define SMM_VARIABLE_BATCH_RECORD_SIZE(NameSize, DataSize) \
+  ALIGN_VALUE (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD, Variable.Name) + (NameSize) + (DataSize), sizeof (UINTN))
+
 ///
 /// This structure is used to communicate with SMI handler by GetNextVariableName.
 ///
@@ -135,6 +160,7 @@ typedef struct {
   BOOLEAN                  *ReadLock;
   BOOLEAN                  *PendingUpdate;
   BOOLEAN                  *HobFlushComplete;
+  UINT32                   *Generation;
   VARIABLE_STORE_HEADER    *RuntimeHobCache;
   VARIABLE_STORE_HEADER    *RuntimeNvCache;
   VARIABLE_STORE_HEADER    *RuntimeVolatileCache;
@@ -0,0 +1,100 @@
+/** @file
+  Provides pool allocations that are safe to make on application processors.
+
+  Boot services, including AllocatePool() and FreePool(), may only be called
+  on the boot strap processor (BSP). This library gives each processor a
+  private cache of memory, allocated by the BSP, out of which the procedures
+  dispatched through the MP Services protocol can allocate and free small
+  buffers without taking a lock.
+
+  The BSP initializes the caches with ApPoolInitialize() before dispatching
+  work, and tops them up with ApPoolRefill() between dispatches.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __AP_POOL_LIB_H__
+#define __AP_POOL_LIB_H__
+
+///
+/// The largest buffer ApPoolAllocate() can return.
+///
+#define AP_POOL_MAX_ALLOCATION_SIZE  (SIZE_4KB - sizeof (UINT64))
+
+/**
+  Create the per-processor caches.
+
+  This function must be called on the BSP.
+
+  @param[in] ChunkSize    The size, in bytes, of the chunks each processor
+                          carves its allocations from. Each processor starts
+                          with one chunk in use and one spare chunk.
+
+  @retval EFI_SUCCESS           The caches are created.
+  @retval EFI_ALREADY_STARTED   The caches were already created.
+  @retval EFI_INVALID_PARAMETER ChunkSize is too small to hold one allocation
+                                of AP_POOL_MAX_ALLOCATION_SIZE bytes.
+  @retval EFI_NOT_FOUND         The MP Services protocol is not installed.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the caches.
+
+**/
+EFI_STATUS
+EFIAPI
+ApPoolInitialize (
+  IN UINTN  ChunkSize
+  );
+
+/**
+  Give a spare chunk to each processor that has used its spare chunk up.
+
+  This function must be called on the BSP while no procedure dispatched
+  through the MP Services protocol is running.
+
+  @retval EFI_SUCCESS           Each processor has a spare chunk.
+  @retval EFI_NOT_STARTED       ApPoolInitialize() was not called.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the chunks.
+
+**/
+EFI_STATUS
+EFIAPI
+ApPoolRefill (
+  VOID
+  );
+
+/**
+  Allocate a buffer from the cache of the calling processor.
+
+  This function may be called on any processor. The buffer is 8-byte aligned.
+  An application processor returns NULL once its chunks are used up; the
+  BSP allocates a new chunk instead.
+
+  @param[in] AllocationSize   The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0,
+          larger than AP_POOL_MAX_ALLOCATION_SIZE, or the cache is exhausted.
+
+**/
+VOID *
+EFIAPI
+ApPoolAllocate (
+  IN UINTN  AllocationSize
+  );
+
+/**
+  Free a buffer allocated by ApPoolAllocate().
+
+  This function may be called on any processor, including one other than
+  the processor the buffer was allocated on.
+
+  @param[in] Buffer   The buffer to free.
+
+**/
+VOID
+EFIAPI
+ApPoolFree (
+  IN VOID  *Buffer
+  );
+
+#endif
@@ -559,6 +559,28 @@ EfiBootManagerConnectAll (
   VOID
   );
 
+/**
+  Connect the device paths that boot options were loaded from in previous boots
+  and the platform default consoles, as a faster replacement of
+  EfiBootManagerConnectAll() on a normal boot.
+
+  Falls back to EfiBootManagerConnectAll() if PcdBootManagerConnectRecordedDevicePaths
+  is FALSE, nothing is recorded, or the most recently used device path fails to
+  connect.
+
+  @retval EFI_SUCCESS      Only the recorded device paths were connected.
+  @retval EFI_UNSUPPORTED  PcdBootManagerConnectRecordedDevicePaths is FALSE,
+                           all the controllers were connected.
+  @retval EFI_NOT_FOUND    No device path is recorded, all the controllers were connected.
+  @retval others           The most recently used device path failed to connect,
+                           all the controllers were connected.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerConnectRecordedDevicePaths (
+  VOID
+  );
+
 /**
   This function will create all handles associate with every device
   path node. If the handle associate with one device path node can not
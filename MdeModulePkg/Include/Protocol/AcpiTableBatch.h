@@ -0,0 +1,74 @@
+/** @file
+  ACPI Table Batch Protocol is related to EDK II-specific implementation of the
+  ACPI Table Protocol and intended for use as a means to install many ACPI tables
+  with a single request, so that the RSDT/XSDT, the common tables and their
+  checksums are updated and published only once for the whole batch.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ACPI_TABLE_BATCH_H__
+#define __ACPI_TABLE_BATCH_H__
+
+#define EDKII_ACPI_TABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0xc349c7be, 0x3a93, 0x42c3, { 0x8e, 0x5f, 0xf5, 0x6e, 0xa2, 0x0a, 0x8c, 0x71 } \
+  }
+
+typedef struct _EDKII_ACPI_TABLE_BATCH_PROTOCOL EDKII_ACPI_TABLE_BATCH_PROTOCOL;
+
+///
+/// One table of a batch. AcpiTableBuffer, AcpiTableBufferSize and TableKey have
+/// the meaning of the matching parameters of EFI_ACPI_TABLE_PROTOCOL.InstallAcpiTable().
+///
+typedef struct {
+  VOID          *AcpiTableBuffer;
+  UINTN         AcpiTableBufferSize;
+  UINTN         TableKey;
+  ///
+  /// The status of installing this table.
+  ///
+  EFI_STATUS    Status;
+} EDKII_ACPI_TABLE_BATCH_ENTRY;
+
+/**
+  Install a batch of ACPI tables into the RSDT/XSDT.
+
+  Every entry is checked first; if any of them is not a valid InstallAcpiTable()
+  request, no table is installed. The tables are then installed in order, and
+  the status and key of each one are returned in its entry. A failure does not
+  stop the tables that follow it from being installed. The tables that were
+  installed are published once, after the last entry.
+
+  @param[in]      This          The EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The tables to install.
+
+  @retval EFI_SUCCESS           All the tables were installed.
+  @retval EFI_INVALID_PARAMETER This or Entries is NULL, or an entry has a NULL
+                                AcpiTableBuffer or an AcpiTableBufferSize which is
+                                not in sync with the size field embedded in the
+                                table. No table was installed.
+  @return Others                The status of the first entry that failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_ACPI_TABLE_BATCH_PROTOCOL_INSTALL_ACPI_TABLES)(
+  IN CONST EDKII_ACPI_TABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                            EntryCount,
+  IN OUT   EDKII_ACPI_TABLE_BATCH_ENTRY     *Entries
+  );
+
+///
+/// ACPI Table Batch Protocol is related to EDK II-specific implementation of the
+/// ACPI Table Protocol and intended for use as a means to install many ACPI tables
+/// with a single request.
+///
+struct _EDKII_ACPI_TABLE_BATCH_PROTOCOL {
+  EDKII_ACPI_TABLE_BATCH_PROTOCOL_INSTALL_ACPI_TABLES    InstallAcpiTables;
+};
+
+extern EFI_GUID  gEdkiiAcpiTableBatchProtocolGuid;
+
+#endif
@@ -0,0 +1,184 @@
+/** @file
+  HII Config Block Routing and HII Config Block Access Protocols are EDK II-specific
+  companions of EFI_HII_CONFIG_ROUTING_PROTOCOL and EFI_HII_CONFIG_ACCESS_PROTOCOL.
+  They move the settings of a buffer varstore as binary (offset, width, value)
+  blocks instead of <ConfigRequest> and <ConfigResp> strings, so that bulk
+  configuration import and export don't have to encode every byte as hex text
+  and parse it back.
+
+  The HII Database driver produces the routing protocol. A driver that installs
+  EFI_HII_CONFIG_ACCESS_PROTOCOL may also install the access protocol on the same
+  handle; when it doesn't, the routing protocol falls back to the string based
+  EFI_HII_CONFIG_ACCESS_PROTOCOL.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HII_CONFIG_BLOCK_H__
+#define __HII_CONFIG_BLOCK_H__
+
+#include <Protocol/DevicePath.h>
+
+#define EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL_GUID \
+  { \
+    0xc1ea52c2, 0xe6e4, 0x4123, { 0x98, 0x29, 0x65, 0xa9, 0xd3, 0xc4, 0x05, 0x60 } \
+  }
+
+#define EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL_GUID \
+  { \
+    0x4fb9798a, 0x4b74, 0x4b77, { 0x96, 0x04, 0x6b, 0x2a, 0x01, 0xb0, 0x46, 0xa1 } \
+  }
+
+typedef struct _EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL;
+typedef struct _EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL  EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL;
+
+///
+/// One <BlockName> of a buffer varstore with its value, the binary form of
+/// "&OFFSET=<Number>&WIDTH=<Number>&VALUE=<Number>".
+///
+typedef struct {
+  UINT16    Offset;
+  UINT16    Width;
+  ///
+  /// Points to Width bytes. Filled on extraction, read on routing.
+  ///
+  UINT8     *Value;
+} EDKII_HII_CONFIG_BLOCK;
+
+/**
+  Read the current value of a set of blocks of a varstore.
+
+  The varstore is located the same way as the <ConfigHdr> of a <ConfigRequest>
+  given to EFI_HII_CONFIG_ROUTING_PROTOCOL.ExtractConfig().
+
+  @param[in]      This          The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param[in]      VarStoreGuid  The GUID of the varstore.
+  @param[in]      VarStoreName  The name of the varstore.
+  @param[in]      DevicePath    The device path of the driver that owns the varstore.
+  @param[in]      BlockCount    The number of entries in Blocks.
+  @param[in, out] Blocks        The blocks to read. On return, the Value buffer
+                                of each block holds its current value.
+
+  @retval EFI_SUCCESS           All the blocks were read.
+  @retval EFI_INVALID_PARAMETER A parameter is NULL, BlockCount is 0, or a block
+                                has a zero Width, a NULL Value or lies beyond the
+                                varstore.
+  @retval EFI_NOT_FOUND         No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to complete the request.
+  @return Others                The error returned by the driver that owns the varstore.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_BLOCK_ROUTING_EXTRACT)(
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN OUT   EDKII_HII_CONFIG_BLOCK                   *Blocks
+  );
+
+/**
+  Write a set of blocks of a varstore. When blocks overlap, the later one wins.
+
+  The varstore is located the same way as the <ConfigHdr> of a <ConfigResp>
+  given to EFI_HII_CONFIG_ROUTING_PROTOCOL.RouteConfig().
+
+  @param[in] This               The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param[in] VarStoreGuid       The GUID of the varstore.
+  @param[in] VarStoreName       The name of the varstore.
+  @param[in] DevicePath         The device path of the driver that owns the varstore.
+  @param[in] BlockCount         The number of entries in Blocks.
+  @param[in] Blocks             The blocks to write.
+
+  @retval EFI_SUCCESS           All the blocks were written.
+  @retval EFI_INVALID_PARAMETER A parameter is NULL, BlockCount is 0, or a block
+                                has a zero Width, a NULL Value or lies beyond the
+                                varstore.
+  @retval EFI_NOT_FOUND         No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to complete the request.
+  @return Others                The error returned by the driver that owns the varstore.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_BLOCK_ROUTING_ROUTE)(
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN CONST EDKII_HII_CONFIG_BLOCK                   *Blocks
+  );
+
+///
+/// Binary companion of EFI_HII_CONFIG_ROUTING_PROTOCOL.
+///
+struct _EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL {
+  EDKII_HII_CONFIG_BLOCK_ROUTING_EXTRACT    ExtractBlock;
+  EDKII_HII_CONFIG_BLOCK_ROUTING_ROUTE      RouteBlock;
+};
+
+/**
+  Read the current value of a set of blocks of a varstore owned by the driver.
+
+  @param[in]      This          The EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL instance.
+  @param[in]      VarStoreGuid  The GUID of the varstore.
+  @param[in]      VarStoreName  The name of the varstore.
+  @param[in]      BlockCount    The number of entries in Blocks.
+  @param[in, out] Blocks        The blocks to read. On return, the Value buffer
+                                of each block holds its current value.
+
+  @retval EFI_SUCCESS           All the blocks were read.
+  @retval EFI_INVALID_PARAMETER A block lies beyond the varstore.
+  @retval EFI_NOT_FOUND         The driver doesn't own the varstore.
+  @return Others                The blocks could not be read.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_BLOCK_ACCESS_EXTRACT)(
+  IN CONST EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL  *This,
+  IN CONST EFI_GUID                                *VarStoreGuid,
+  IN CONST CHAR16                                  *VarStoreName,
+  IN       UINTN                                   BlockCount,
+  IN OUT   EDKII_HII_CONFIG_BLOCK                  *Blocks
+  );
+
+/**
+  Write a set of blocks of a varstore owned by the driver. When blocks overlap,
+  the later one wins.
+
+  @param[in] This               The EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL instance.
+  @param[in] VarStoreGuid       The GUID of the varstore.
+  @param[in] VarStoreName       The name of the varstore.
+  @param[in] BlockCount         The number of entries in Blocks.
+  @param[in] Blocks             The blocks to write.
+
+  @retval EFI_SUCCESS           All the blocks were written.
+  @retval EFI_INVALID_PARAMETER A block lies beyond the varstore.
+  @retval EFI_NOT_FOUND         The driver doesn't own the varstore.
+  @return Others                The blocks could not be written.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_HII_CONFIG_BLOCK_ACCESS_ROUTE)(
+  IN CONST EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL  *This,
+  IN CONST EFI_GUID                                *VarStoreGuid,
+  IN CONST CHAR16                                  *VarStoreName,
+  IN       UINTN                                   BlockCount,
+  IN CONST EDKII_HII_CONFIG_BLOCK                  *Blocks
+  );
+
+///
+/// Binary companion of EFI_HII_CONFIG_ACCESS_PROTOCOL, installed by a driver on
+/// the handle of its EFI_HII_CONFIG_ACCESS_PROTOCOL.
+///
+struct _EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL {
+  EDKII_HII_CONFIG_BLOCK_ACCESS_EXTRACT    ExtractBlock;
+  EDKII_HII_CONFIG_BLOCK_ACCESS_ROUTE      RouteBlock;
+};
+
+extern EFI_GUID  gEdkiiHiiConfigBlockRoutingProtocolGuid;
+extern EFI_GUID  gEdkiiHiiConfigBlockAccessProtocolGuid;
+
+#endif
@@ -0,0 +1,73 @@
+/** @file
+  Variable Batch Protocol is related to EDK II-specific implementation of variables
+  and intended for use as a means to set many variables with a single request, so
+  that the variable driver can validate the whole batch up front and, when the
+  variable services live in SMM, hand it over in a single SMI.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_BATCH_H__
+#define __VARIABLE_BATCH_H__
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0xbb51d5ce, 0x5515, 0x47c3, { 0xbe, 0xf3, 0x31, 0x08, 0xc5, 0xc8, 0x8c, 0xaf } \
+  }
+
+typedef struct _EDKII_VARIABLE_BATCH_PROTOCOL EDKII_VARIABLE_BATCH_PROTOCOL;
+
+///
+/// One variable of a batch. The fields other than Status have the meaning of
+/// the matching parameters of the SetVariable() runtime service.
+///
+typedef struct {
+  CHAR16        *VariableName;
+  EFI_GUID      *VendorGuid;
+  UINT32        Attributes;
+  UINTN         DataSize;
+  VOID          *Data;
+  ///
+  /// The status SetVariable() returned for this variable.
+  ///
+  EFI_STATUS    Status;
+} EDKII_VARIABLE_BATCH_ENTRY;
+
+/**
+  Set a batch of variables.
+
+  Every entry is checked first; if any of them is not a valid SetVariable()
+  request, nothing is set. The variables are then set in order, and the status
+  of each one is returned in its entry. A failure does not stop the variables
+  that follow it from being set.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The variables to set.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER This or Entries is NULL, or an entry has a NULL or empty
+                                VariableName, a NULL VendorGuid, or a NULL Data with a non
+                                zero DataSize, or is too large. No variable was set.
+  @return Others                The status of the first entry that failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES)(
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          EntryCount,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
+///
+/// Variable Batch Protocol is related to EDK II-specific implementation of variables
+/// and intended for use as a means to set many variables with a single request.
+///
+struct _EDKII_VARIABLE_BATCH_PROTOCOL {
+  EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES    SetVariables;
+};
+
+extern EFI_GUID  gEdkiiVariableBatchProtocolGuid;
+
+#endif
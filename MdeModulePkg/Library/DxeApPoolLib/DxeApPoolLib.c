@@ -0,0 +1,482 @@
+/** @file
+  DXE instance of the AP Pool Library.
+
+  Each processor owns a cache with one free list per power-of-two size class,
+  from 16 to 4096 bytes including an 8-byte block header. A processor takes
+  blocks from its own free lists, or carves new ones from its current chunk,
+  without any lock. When the current chunk is used up, the processor moves to
+  its spare chunk; only the BSP may allocate further chunks from the UEFI
+  pool, so ApPoolRefill() replaces the spare chunks between dispatches.
+
+  A block freed on another processor is pushed onto the remote free list of
+  its owner with a compare-exchange. The owner takes the whole remote list at
+  once when one of its own free lists runs empty.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/MpService.h>
+
+#include <Library/ApPoolLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#define AP_POOL_MIN_BLOCK_SHIFT  4
+#define AP_POOL_SIZE_CLASSES     9
+
+typedef struct _AP_POOL_CHUNK AP_POOL_CHUNK;
+typedef struct _AP_POOL_BLOCK AP_POOL_BLOCK;
+
+struct _AP_POOL_CHUNK {
+  AP_POOL_CHUNK    *Next;
+  UINTN            Size;
+};
+
+struct _AP_POOL_BLOCK {
+  UINT32           ProcessorIndex;
+  UINT32           SizeClass;
+  //
+  // The buffer returned to the caller starts here, so Next is only valid
+  // while the block is free.
+  //
+  AP_POOL_BLOCK    *Next;
+};
+
+typedef struct {
+  AP_POOL_BLOCK             *FreeList[AP_POOL_SIZE_CLASSES];
+  AP_POOL_BLOCK *volatile   RemoteFreeList;
+  AP_POOL_CHUNK             *Chunk;
+  UINTN                     ChunkUsed;
+  AP_POOL_CHUNK             *Spare;
+} AP_POOL_CACHE;
+
+//
+// Keep the caches of different processors in different cache lines.
+//
+#define AP_POOL_CACHE_STRIDE  ALIGN_VALUE (sizeof (AP_POOL_CACHE), 64)
+
+EFI_MP_SERVICES_PROTOCOL  *mApPoolMpServices    = NULL;
+UINT8                     *mApPoolCaches        = NULL;
+UINTN                     mApPoolNumberOfCaches = 0;
+UINTN                     mApPoolBspIndex       = 0;
+UINTN                     mApPoolChunkSize      = 0;
+
+/**
+  Return the cache of a processor.
+
+  @param[in] ProcessorIndex   The index of the processor.
+
+  @return The cache of the processor.
+
+**/
+STATIC
+AP_POOL_CACHE *
+GetCache (
+  IN UINTN  ProcessorIndex
+  )
+{
+  return (AP_POOL_CACHE *)(mApPoolCaches + ProcessorIndex * AP_POOL_CACHE_STRIDE);
+}
+
+/**
+  Return the index of the calling processor.
+
+  @return The index of the calling processor, or mApPoolNumberOfCaches if
+          the processor has no cache.
+
+**/
+STATIC
+UINTN
+GetProcessorIndex (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ProcessorIndex;
+
+  Status = mApPoolMpServices->WhoAmI (mApPoolMpServices, &ProcessorIndex);
+  if (EFI_ERROR (Status) || (ProcessorIndex >= mApPoolNumberOfCaches)) {
+    return mApPoolNumberOfCaches;
+  }
+
+  return ProcessorIndex;
+}
+
+/**
+  Allocate a chunk from the UEFI pool. Must be called on the BSP.
+
+  The chunk comes from wherever the DXE Core places the pool. The DXE Core has
+  no proximity domain information, so chunks are not local to the processor
+  that will use them.
+
+  @return The chunk, or NULL if there is not enough memory.
+
+**/
+STATIC
+AP_POOL_CHUNK *
+AllocateChunk (
+  VOID
+  )
+{
+  AP_POOL_CHUNK  *Chunk;
+
+  Chunk = AllocatePool (mApPoolChunkSize);
+  if (Chunk != NULL) {
+    Chunk->Next = NULL;
+    Chunk->Size = mApPoolChunkSize;
+  }
+
+  return Chunk;
+}
+
+/**
+  Free all chunks and caches. Must be called on the BSP.
+
+**/
+STATIC
+VOID
+FreeCaches (
+  VOID
+  )
+{
+  UINTN          Index;
+  AP_POOL_CACHE  *Cache;
+  AP_POOL_CHUNK  *Chunk;
+
+  if (mApPoolCaches == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < mApPoolNumberOfCaches; Index++) {
+    Cache = GetCache (Index);
+    if (Cache->Spare != NULL) {
+      FreePool (Cache->Spare);
+    }
+
+    while (Cache->Chunk != NULL) {
+      Chunk        = Cache->Chunk;
+      Cache->Chunk = Chunk->Next;
+      FreePool (Chunk);
+    }
+  }
+
+  FreePool (mApPoolCaches);
+  mApPoolCaches         = NULL;
+  mApPoolNumberOfCaches = 0;
+}
+
+/**
+  Move the blocks other processors have freed to the free lists of a cache.
+
+  @param[in, out] Cache   The cache of the calling processor.
+
+**/
+STATIC
+VOID
+DrainRemoteFreeList (
+  IN OUT AP_POOL_CACHE  *Cache
+  )
+{
+  AP_POOL_BLOCK  *Block;
+  AP_POOL_BLOCK  *Next;
+
+  do {
+    Block = Cache->RemoteFreeList;
+    if (Block == NULL) {
+      return;
+    }
+  } while (InterlockedCompareExchangePointer ((VOID **)&Cache->RemoteFreeList, Block, NULL) != Block);
+
+  for ( ; Block != NULL; Block = Next) {
+    Next                              = Block->Next;
+    Block->Next                       = Cache->FreeList[Block->SizeClass];
+    Cache->FreeList[Block->SizeClass] = Block;
+  }
+}
+
+/**
+  Carve a new block from the current chunk of a cache.
+
+  @param[in, out] Cache           The cache of the calling processor.
+  @param[in]      ProcessorIndex  The index of the calling processor.
+  @param[in]      SizeClass       The size class of the block.
+
+  @return The block, or NULL if the cache is exhausted.
+
+**/
+STATIC
+AP_POOL_BLOCK *
+CarveBlock (
+  IN OUT AP_POOL_CACHE  *Cache,
+  IN     UINTN          ProcessorIndex,
+  IN     UINTN          SizeClass
+  )
+{
+  UINTN          BlockSize;
+  AP_POOL_CHUNK  *Chunk;
+  AP_POOL_BLOCK  *Block;
+
+  BlockSize = (UINTN)1 << (SizeClass + AP_POOL_MIN_BLOCK_SHIFT);
+  if ((Cache->Chunk == NULL) || (Cache->ChunkUsed + BlockSize > Cache->Chunk->Size)) {
+    if (Cache->Spare != NULL) {
+      Chunk        = Cache->Spare;
+      Cache->Spare = NULL;
+    } else if (ProcessorIndex == mApPoolBspIndex) {
+      Chunk = AllocateChunk ();
+      if (Chunk == NULL) {
+        return NULL;
+      }
+    } else {
+      return NULL;
+    }
+
+    Chunk->Next      = Cache->Chunk;
+    Cache->Chunk     = Chunk;
+    Cache->ChunkUsed = ALIGN_VALUE (sizeof (AP_POOL_CHUNK), 1 << AP_POOL_MIN_BLOCK_SHIFT);
+  }
+
+  Block                 = (AP_POOL_BLOCK *)((UINT8 *)Cache->Chunk + Cache->ChunkUsed);
+  Block->ProcessorIndex = (UINT32)ProcessorIndex;
+  Block->SizeClass      = (UINT32)SizeClass;
+  Cache->ChunkUsed     += BlockSize;
+  return Block;
+}
+
+/**
+  Create the per-processor caches.
+
+  This function must be called on the BSP.
+
+  @param[in] ChunkSize    The size, in bytes, of the chunks each processor
+                          carves its allocations from. Each processor starts
+                          with one chunk in use and one spare chunk.
+
+  @retval EFI_SUCCESS           The caches are created.
+  @retval EFI_ALREADY_STARTED   The caches were already created.
+  @retval EFI_INVALID_PARAMETER ChunkSize is too small to hold one allocation
+                                of AP_POOL_MAX_ALLOCATION_SIZE bytes.
+  @retval EFI_NOT_FOUND         The MP Services protocol is not installed.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the caches.
+
+**/
+EFI_STATUS
+EFIAPI
+ApPoolInitialize (
+  IN UINTN  ChunkSize
+  )
+{
+  EFI_STATUS     Status;
+  UINTN          NumberOfProcessors;
+  UINTN          NumberOfEnabledProcessors;
+  UINTN          Index;
+  AP_POOL_CACHE  *Cache;
+
+  if (mApPoolCaches != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  if (ChunkSize < ALIGN_VALUE (sizeof (AP_POOL_CHUNK), 1 << AP_POOL_MIN_BLOCK_SHIFT) + SIZE_4KB) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mApPoolMpServices);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = mApPoolMpServices->GetNumberOfProcessors (
+                                mApPoolMpServices,
+                                &NumberOfProcessors,
+                                &NumberOfEnabledProcessors
+                                );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = mApPoolMpServices->WhoAmI (mApPoolMpServices, &mApPoolBspIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mApPoolCaches = AllocateZeroPool (NumberOfProcessors * AP_POOL_CACHE_STRIDE);
+  if (mApPoolCaches == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mApPoolNumberOfCaches = NumberOfProcessors;
+  mApPoolChunkSize      = ChunkSize;
+  for (Index = 0; Index < NumberOfProcessors; Index++) {
+    Cache        = GetCache (Index);
+    Cache->Chunk = AllocateChunk ();
+    Cache->Spare = AllocateChunk ();
+    if ((Cache->Chunk == NULL) || (Cache->Spare == NULL)) {
+      FreeCaches ();
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Cache->ChunkUsed = ALIGN_VALUE (sizeof (AP_POOL_CHUNK), 1 << AP_POOL_MIN_BLOCK_SHIFT);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Give a spare chunk to each processor that has used its spare chunk up.
+
+  This function must be called on the BSP while no procedure dispatched
+  through the MP Services protocol is running.
+
+  @retval EFI_SUCCESS           Each processor has a spare chunk.
+  @retval EFI_NOT_STARTED       ApPoolInitialize() was not called.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory for the chunks.
+
+**/
+EFI_STATUS
+EFIAPI
+ApPoolRefill (
+  VOID
+  )
+{
+  UINTN          Index;
+  AP_POOL_CACHE  *Cache;
+
+  if (mApPoolCaches == NULL) {
+    return EFI_NOT_STARTED;
+  }
+
+  for (Index = 0; Index < mApPoolNumberOfCaches; Index++) {
+    Cache = GetCache (Index);
+    if (Cache->Spare == NULL) {
+      Cache->Spare = AllocateChunk ();
+      if (Cache->Spare == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Allocate a buffer from the cache of the calling processor.
+
+  This function may be called on any processor. The buffer is 8-byte aligned.
+  An application processor returns NULL once its chunks are used up; the
+  BSP allocates a new chunk instead.
+
+  @param[in] AllocationSize   The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0,
+          larger than AP_POOL_MAX_ALLOCATION_SIZE, or the cache is exhausted.
+
+**/
+VOID *
+EFIAPI
+ApPoolAllocate (
+  IN UINTN  AllocationSize
+  )
+{
+  UINTN          ProcessorIndex;
+  UINTN          SizeClass;
+  AP_POOL_CACHE  *Cache;
+  AP_POOL_BLOCK  *Block;
+
+  if ((mApPoolCaches == NULL) || (AllocationSize == 0) || (AllocationSize > AP_POOL_MAX_ALLOCATION_SIZE)) {
+    return NULL;
+  }
+
+  ProcessorIndex = GetProcessorIndex ();
+  if (ProcessorIndex == mApPoolNumberOfCaches) {
+    return NULL;
+  }
+
+  SizeClass = 0;
+  while (((UINTN)1 << (SizeClass + AP_POOL_MIN_BLOCK_SHIFT)) < AllocationSize + OFFSET_OF (AP_POOL_BLOCK, Next)) {
+    SizeClass++;
+  }
+
+  Cache = GetCache (ProcessorIndex);
+  if (Cache->FreeList[SizeClass] == NULL) {
+    DrainRemoteFreeList (Cache);
+  }
+
+  Block = Cache->FreeList[SizeClass];
+  if (Block != NULL) {
+    Cache->FreeList[SizeClass] = Block->Next;
+  } else {
+    Block = CarveBlock (Cache, ProcessorIndex, SizeClass);
+    if (Block == NULL) {
+      return NULL;
+    }
+  }
+
+  return &Block->Next;
+}
+
+/**
+  Free a buffer allocated by ApPoolAllocate().
+
+  This function may be called on any processor, including one other than
+  the processor the buffer was allocated on.
+
+  @param[in] Buffer   The buffer to free.
+
+**/
+VOID
+EFIAPI
+ApPoolFree (
+  IN VOID  *Buffer
+  )
+{
+  AP_POOL_BLOCK  *Block;
+  AP_POOL_BLOCK  *Head;
+  AP_POOL_CACHE  *Cache;
+
+  if (Buffer == NULL) {
+    return;
+  }
+
+  Block = BASE_CR (Buffer, AP_POOL_BLOCK, Next);
+  ASSERT (Block->ProcessorIndex < mApPoolNumberOfCaches);
+  ASSERT (Block->SizeClass < AP_POOL_SIZE_CLASSES);
+
+  Cache = GetCache (Block->ProcessorIndex);
+  if (Block->ProcessorIndex == GetProcessorIndex ()) {
+    Block->Next                       = Cache->FreeList[Block->SizeClass];
+    Cache->FreeList[Block->SizeClass] = Block;
+    return;
+  }
+
+  do {
+    Head        = Cache->RemoteFreeList;
+    Block->Next = Head;
+  } while (InterlockedCompareExchangePointer ((VOID **)&Cache->RemoteFreeList, Head, Block) != Head);
+}
+
+/**
+  Free the caches when the module that links the library is unloaded.
+
+  @param[in] ImageHandle  The image handle of the module.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS     The caches are freed.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeApPoolLibDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  FreeCaches ();
+  return EFI_SUCCESS;
+}
@@ -1408,6 +1408,38 @@ CoDClearCapsuleRelocationInfo (
                 );
 }
 
+/**
+  Write data at the current position of a file.
+
+  @param[in]    File                 The file to write.
+  @param[in]    Size                 Size of the data in bytes.
+  @param[in]    Buffer               The data to write.
+
+  @retval EFI_SUCCESS        All the data is written.
+  @retval EFI_DEVICE_ERROR   Only part of the data is written.
+  @retval Others             The write failed.
+
+**/
+STATIC
+EFI_STATUS
+WriteFileData (
+  IN EFI_FILE_HANDLE  File,
+  IN UINTN            Size,
+  IN VOID             *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       DataSize;
+
+  DataSize = Size;
+  Status   = File->Write (File, &DataSize, Buffer);
+  if (!EFI_ERROR (Status) && (DataSize != Size)) {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
 /**
   Relocate Capsule on Disk from EFI system partition to a platform-specific NV storage device
   with BlockIo protocol. Relocation device path, identified by PcdCodRelocationDevPath, must
@@ -1442,12 +1474,11 @@ RelocateCapsuleToDisk (
   EFI_HANDLE                       *HandleBuffer;
   UINTN                            NumberOfHandles;
   EFI_BLOCK_IO_PROTOCOL            *BlockIo;
-  UINT8                            *CapsuleDataBuf;
-  UINT8                            *CapsulePtr;
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *Fs;
   EFI_FILE_HANDLE                  RootDir;
   EFI_FILE_HANDLE                  TempCodFile;
   UINT64                           TempCodFileSize;
+  UINT64                           TotalCapsuleSize;
   EFI_DEVICE_PATH                  *TempDevicePath;
   BOOLEAN                          RelocationInfo;
   UINT16                           LoadOptionNumber;
@@ -1456,7 +1487,6 @@ RelocateCapsuleToDisk (
   RootDir          = NULL;
   TempCodFile      = NULL;
   HandleBuffer     = NULL;
-  CapsuleDataBuf   = NULL;
   CapsuleOnDiskBuf = NULL;
   NumberOfHandles  = 0;
 
@@ -1582,42 +1612,18 @@ RelocateCapsuleToDisk (
     goto EXIT;
   }
 
-  CapsuleDataBuf = AllocatePool ((UINTN)TempCodFileSize);
-  if (CapsuleDataBuf == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto EXIT;
-  }
-
   //
   // First UINT64 reserved for total image size, including capsule name capsule.
   //
-  *(UINT64 *)CapsuleDataBuf = TotalImageSize + sizeof (EFI_CAPSULE_HEADER) + TotalImageNameSize;
+  TotalCapsuleSize = TotalImageSize + sizeof (EFI_CAPSULE_HEADER) + TotalImageNameSize;
 
   //
-  // Line up all the Capsule on Disk and write to relocation disk at one time. It could save some time in disk write
-  //
-  for (Index = 0, CapsulePtr = CapsuleDataBuf + sizeof (UINT64); Index < CapsuleOnDiskNum; Index++) {
-    CopyMem (CapsulePtr, CapsuleOnDiskBuf[Index].ImageAddress, (UINTN)CapsuleOnDiskBuf[Index].FileInfo->FileSize);
-    CapsulePtr += CapsuleOnDiskBuf[Index].FileInfo->FileSize;
-  }
-
-  //
-  // Line the capsule header for capsule name capsule.
+  // The capsule header for capsule name capsule.
   //
   CopyGuid (&FileNameCapsuleHeader.CapsuleGuid, &gEdkiiCapsuleOnDiskNameGuid);
   FileNameCapsuleHeader.CapsuleImageSize = (UINT32)TotalImageNameSize + sizeof (EFI_CAPSULE_HEADER);
   FileNameCapsuleHeader.Flags            = CAPSULE_FLAGS_PERSIST_ACROSS_RESET;
   FileNameCapsuleHeader.HeaderSize       = sizeof (EFI_CAPSULE_HEADER);
-  CopyMem (CapsulePtr, &FileNameCapsuleHeader, FileNameCapsuleHeader.HeaderSize);
-  CapsulePtr += FileNameCapsuleHeader.HeaderSize;
-
-  //
-  // Line up all the Capsule file names.
-  //
-  for (Index = 0; Index < CapsuleOnDiskNum; Index++) {
-    CopyMem (CapsulePtr, CapsuleOnDiskBuf[Index].FileInfo->FileName, StrSize (CapsuleOnDiskBuf[Index].FileInfo->FileName));
-    CapsulePtr += StrSize (CapsuleOnDiskBuf[Index].FileInfo->FileName);
-  }
 
   //
   // 5. Flash all Capsules on Disk to TempCoD.tmp under RootDir
@@ -1655,21 +1661,34 @@ RelocateCapsuleToDisk (
   }
 
   //
-  // Always write at the begining of TempCap file
+  // Always write at the begining of TempCap file. Write the total size, all the Capsule on Disk
+  // images, the capsule name capsule header and all the Capsule file names one after the other
+  // from the buffers they are loaded in, instead of lining them up in another buffer of the
+  // size of the whole file first.
   //
-  DataSize = (UINTN)TempCodFileSize;
-  Status   = TempCodFile->Write (
-                            TempCodFile,
-                            &DataSize,
-                            CapsuleDataBuf
-                            );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "RelocateCapsule: Write TemCoD.tmp error. %x\n", Status));
-    goto EXIT;
+  Status = WriteFileData (TempCodFile, sizeof (UINT64), &TotalCapsuleSize);
+  for (Index = 0; !EFI_ERROR (Status) && Index < CapsuleOnDiskNum; Index++) {
+    Status = WriteFileData (
+               TempCodFile,
+               (UINTN)CapsuleOnDiskBuf[Index].FileInfo->FileSize,
+               CapsuleOnDiskBuf[Index].ImageAddress
+               );
   }
 
-  if (DataSize != TempCodFileSize) {
-    Status = EFI_DEVICE_ERROR;
+  if (!EFI_ERROR (Status)) {
+    Status = WriteFileData (TempCodFile, FileNameCapsuleHeader.HeaderSize, &FileNameCapsuleHeader);
+  }
+
+  for (Index = 0; !EFI_ERROR (Status) && Index < CapsuleOnDiskNum; Index++) {
+    Status = WriteFileData (
+               TempCodFile,
+               StrSize (CapsuleOnDiskBuf[Index].FileInfo->FileName),
+               CapsuleOnDiskBuf[Index].FileInfo->FileName
+               );
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "RelocateCapsule: Write TemCoD.tmp error. %x\n", Status));
     goto EXIT;
   }
 
@@ -1700,10 +1719,6 @@ RelocateCapsuleToDisk (
 
 EXIT:
 
-  if (CapsuleDataBuf != NULL) {
-    FreePool (CapsuleDataBuf);
-  }
-
   if (CapsuleOnDiskBuf != NULL) {
     //
     // Free resources allocated by CodLibGetAllCapsuleOnDisk
@@ -59,6 +59,33 @@ typedef struct {
 HANDLE_GUID_MAP  mCacheHandleGuidTable[CACHE_HANDLE_GUID_COUNT];
 UINTN            mCachePairCount = 0;
 
+//
+// Fixed-size record kept in the performance record ring. The strings, module
+// names and FPDT layout are only resolved when the record is drained.
+//
+#define PERF_RING_RECORD_GUID_VALID    BIT0
+#define PERF_RING_RECORD_STRING_VALID  BIT1
+
+typedef struct {
+  volatile UINT32    Sequence;
+  UINT16             PerfId;
+  UINT8              Attribute;
+  UINT8              Flags;
+  UINT64             Ticker;
+  UINT64             Address;
+  CONST VOID         *CallerIdentifier;
+  EFI_GUID           Guid;
+  CHAR8              String[FPDT_STRING_EVENT_RECORD_NAME_LENGTH];
+} PERF_RING_RECORD;
+
+PERF_RING_RECORD  *mPerfRing           = NULL;
+UINT32            mPerfRingCount      = 0;
+volatile UINT32   mPerfRingHead       = 0;
+volatile UINT32   mPerfRingTail       = 0;
+volatile UINT32   mPerfRingDropCount  = 0;
+UINT32            mPerfRingDropLogged = 0;
+BOOLEAN           mPerfRingActive     = FALSE;
+
 UINT32  mLoadImageCount       = 0;
 UINT32  mPerformanceLength    = 0;
 UINT32  mMaxPerformanceLength = 0;
@@ -1319,6 +1346,136 @@ InsertFpdtRecord (
   return EFI_SUCCESS;
 }
 
+/**
+  Reserve a slot in the performance record ring and fill it in.
+
+  Only the raw arguments and the current time stamp are captured. No lock is
+  taken, no memory is allocated and no boot services are called, so this may be
+  used from APs as well as from the BSP at any TPL.
+
+  @param CallerIdentifier  - Image handle or pointer to caller ID GUID.
+  @param Guid              - Pointer to a GUID.
+  @param String            - Pointer to a string describing the measurement.
+  @param Ticker            - 64-bit time stamp.
+  @param Address           - Pointer to a location in memory relevant to the measurement.
+  @param PerfId            - Performance identifier describing the type of measurement.
+  @param Attribute         - The attribute of the measurement.
+
+  @retval EFI_SUCCESS           - Successfully queued the performance record.
+  @retval EFI_OUT_OF_RESOURCES  - The ring is full and the record was dropped.
+
+**/
+EFI_STATUS
+InsertPerformanceRingRecord (
+  IN CONST VOID                        *CallerIdentifier   OPTIONAL,
+  IN CONST VOID                        *Guid     OPTIONAL,
+  IN CONST CHAR8                       *String   OPTIONAL,
+  IN       UINT64                      Ticker,
+  IN       UINT64                      Address   OPTIONAL,
+  IN       UINT16                      PerfId,
+  IN       PERF_MEASUREMENT_ATTRIBUTE  Attribute
+  )
+{
+  PERF_RING_RECORD  *Record;
+  UINT32            Head;
+  UINTN             Index;
+
+  if (Ticker == 0) {
+    Ticker = GetPerformanceCounter ();
+  }
+
+  do {
+    Head = mPerfRingHead;
+    if (Head - mPerfRingTail >= mPerfRingCount) {
+      InterlockedIncrement (&mPerfRingDropCount);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  } while (InterlockedCompareExchange32 (&mPerfRingHead, Head, Head + 1) != Head);
+
+  Record                   = &mPerfRing[Head % mPerfRingCount];
+  Record->PerfId           = PerfId;
+  Record->Attribute        = (UINT8)Attribute;
+  Record->Flags            = 0;
+  Record->Ticker           = Ticker;
+  Record->Address          = Address;
+  Record->CallerIdentifier = CallerIdentifier;
+
+  if (Guid != NULL) {
+    CopyGuid (&Record->Guid, Guid);
+    Record->Flags |= PERF_RING_RECORD_GUID_VALID;
+  }
+
+  if (String != NULL) {
+    for (Index = 0; Index < ARRAY_SIZE (Record->String) - 1 && String[Index] != '\0'; Index++) {
+      Record->String[Index] = String[Index];
+    }
+
+    Record->String[Index] = '\0';
+    Record->Flags        |= PERF_RING_RECORD_STRING_VALID;
+  }
+
+  //
+  // Publish the record only after all of its fields are visible.
+  //
+  MemoryFence ();
+  Record->Sequence = Head + 1;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Convert the published records in the performance record ring into FPDT records.
+
+  Records are drained in the order their slots were reserved and stop at the first
+  slot that is reserved but not yet published. This must only be called on the BSP.
+
+**/
+VOID
+DrainPerformanceRing (
+  VOID
+  )
+{
+  PERF_RING_RECORD  *Record;
+  UINT32            DropCount;
+
+  if ((mPerfRing == NULL) || mLockInsertRecord) {
+    return;
+  }
+
+  mLockInsertRecord = TRUE;
+
+  while (mPerfRingTail != mPerfRingHead) {
+    Record = &mPerfRing[mPerfRingTail % mPerfRingCount];
+    if (Record->Sequence != mPerfRingTail + 1) {
+      break;
+    }
+
+    InsertFpdtRecord (
+      Record->CallerIdentifier,
+      ((Record->Flags & PERF_RING_RECORD_GUID_VALID) != 0) ? &Record->Guid : NULL,
+      ((Record->Flags & PERF_RING_RECORD_STRING_VALID) != 0) ? Record->String : NULL,
+      Record->Ticker,
+      Record->Address,
+      Record->PerfId,
+      (PERF_MEASUREMENT_ATTRIBUTE)Record->Attribute
+      );
+
+    //
+    // Hand the slot back to the producers only once it has been consumed.
+    //
+    MemoryFence ();
+    mPerfRingTail++;
+  }
+
+  DropCount = mPerfRingDropCount;
+  if (DropCount != mPerfRingDropLogged) {
+    DEBUG ((DEBUG_WARN, "DxeCorePerformanceLib: %d records dropped because the performance record ring is full\n", DropCount - mPerfRingDropLogged));
+    mPerfRingDropLogged = DropCount;
+  }
+
+  mLockInsertRecord = FALSE;
+}
+
 /**
   Dumps all the PEI performance.
 
@@ -1391,6 +1548,11 @@ ReportFpdtRecordBuffer (
   UINT64      BPDTAddr;
 
   if (!mFpdtBufferIsReported) {
+    //
+    // Convert the queued ring records first so the boot performance table is sized for them.
+    //
+    DrainPerformanceRing ();
+
     Status = AllocateBootPerformanceTable ();
     if (!EFI_ERROR (Status)) {
       BPDTAddr = (UINT64)(UINTN)mAcpiBootPerformanceTable;
@@ -1431,6 +1593,12 @@ UpdateBootPerformanceTable (
   UINTN  AppendSize;
   UINT8  *FirmwarePerformanceTablePtr;
 
+  //
+  // Flush the ring and log any later records directly into the boot performance table.
+  //
+  mPerfRingActive = FALSE;
+  DrainPerformanceRing ();
+
   SmmBootRecordDataSize = 0;
 
   //
@@ -1494,6 +1662,19 @@ DxeCorePerformanceLibConstructor (
   //
   InternalGetPeiPerformance (GetHobList ());
 
+  //
+  // Preallocate the performance record ring if the platform asks for it.
+  //
+  mPerfRingCount = PcdGet32 (PcdEdkiiPerformanceRingRecordCount);
+  if (mPerfRingCount != 0) {
+    mPerfRing = AllocateZeroPool (mPerfRingCount * sizeof (PERF_RING_RECORD));
+    if (mPerfRing == NULL) {
+      DEBUG ((DEBUG_WARN, "DxeCorePerformanceLib: Fail to allocate the performance record ring\n"));
+    } else {
+      mPerfRingActive = TRUE;
+    }
+  }
+
   //
   // Install the protocol interfaces for DXE performance library instance.
   //
@@ -1584,6 +1765,15 @@ CreatePerformanceMeasurement (
 
   Status = EFI_SUCCESS;
 
+  if (mPerfRingActive) {
+    return InsertPerformanceRingRecord (CallerIdentifier, Guid, String, TimeStamp, Address, (UINT16)Identifier, Attribute);
+  }
+
+  //
+  // Keep the log in order if records are still waiting in the ring.
+  //
+  DrainPerformanceRing ();
+
   if (mLockInsertRecord) {
     return EFI_INVALID_PARAMETER;
   }
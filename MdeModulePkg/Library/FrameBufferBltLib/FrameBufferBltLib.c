@@ -35,6 +35,13 @@ CONST EFI_PIXEL_BITMASK  mBgrPixelMasks = {
   0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000
 };
 
+//
+// Masks used to swap the red and blue channels of two 32-bit pixels held in
+// one 64-bit word. The reserved byte is dropped, matching the generic path.
+//
+#define PIXEL_PAIR_GREEN_MASK      0x0000ff000000ff00ULL
+#define PIXEL_PAIR_LOW_BYTE_MASK   0x000000ff000000ffULL
+
 /**
   Initialize the bit mask in frame buffer configure.
 
@@ -339,6 +346,122 @@ FrameBufferBltLibVideoFill (
   return RETURN_SUCCESS;
 }
 
+/**
+  Convert one row of video pixels into BltBuffer pixels.
+
+  RGBX frame buffers are converted two pixels at a time by swapping the red
+  and blue bytes within a 64-bit word. Other bit mask formats fall back to
+  the per-pixel mask and shift conversion.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[out] Blt           Destination row in BltBuffer.
+  @param[in]  Source        Source row in video pixel format.
+  @param[in]  Width         Width (in pixels).
+**/
+STATIC
+VOID
+FrameBufferBltLibVideoToBltLine (
+  IN  FRAME_BUFFER_CONFIGURE         *Configure,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt,
+  IN  CONST UINT8                    *Source,
+  IN  UINTN                          Width
+  )
+{
+  UINTN   IndexX;
+  UINT64  Uint64;
+  UINT32  Uint32;
+  UINT32  RedMask;
+  UINT32  GreenMask;
+  UINT32  BlueMask;
+  UINT32  BytesPerPixel;
+
+  IndexX = 0;
+  if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    for ( ; IndexX + 2 <= Width; IndexX += 2) {
+      Uint64 = ReadUnaligned64 ((CONST UINT64 *)(Source + IndexX * sizeof (UINT32)));
+      WriteUnaligned64 (
+        (UINT64 *)&Blt[IndexX],
+        (Uint64 & PIXEL_PAIR_GREEN_MASK) |
+        ((Uint64 >> 16) & PIXEL_PAIR_LOW_BYTE_MASK) |
+        ((Uint64 & PIXEL_PAIR_LOW_BYTE_MASK) << 16)
+        );
+    }
+  }
+
+  RedMask       = Configure->PixelMasks.RedMask;
+  GreenMask     = Configure->PixelMasks.GreenMask;
+  BlueMask      = Configure->PixelMasks.BlueMask;
+  BytesPerPixel = Configure->BytesPerPixel;
+  for ( ; IndexX < Width; IndexX++) {
+    Uint32                 = *(UINT32 *)(Source + (IndexX * BytesPerPixel));
+    *(UINT32 *)&Blt[IndexX] =
+      (UINT32)(
+               (((Uint32 & RedMask) >> Configure->PixelShl[0]) << Configure->PixelShr[0]) |
+               (((Uint32 & GreenMask) >> Configure->PixelShl[1]) << Configure->PixelShr[1]) |
+               (((Uint32 & BlueMask) >> Configure->PixelShl[2]) << Configure->PixelShr[2])
+               );
+  }
+}
+
+/**
+  Convert one row of BltBuffer pixels into video pixels.
+
+  RGBX frame buffers are converted two pixels at a time by swapping the red
+  and blue bytes within a 64-bit word. Other bit mask formats fall back to
+  the per-pixel mask and shift conversion.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[out] Destination   Destination row in video pixel format.
+  @param[in]  Blt           Source row in BltBuffer.
+  @param[in]  Width         Width (in pixels).
+**/
+STATIC
+VOID
+FrameBufferBltLibBltToVideoLine (
+  IN  FRAME_BUFFER_CONFIGURE               *Configure,
+  OUT UINT8                                *Destination,
+  IN  CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt,
+  IN  UINTN                                Width
+  )
+{
+  UINTN   IndexX;
+  UINT64  Uint64;
+  UINT32  Uint32;
+  UINT32  RedMask;
+  UINT32  GreenMask;
+  UINT32  BlueMask;
+  UINT32  BytesPerPixel;
+
+  IndexX = 0;
+  if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    for ( ; IndexX + 2 <= Width; IndexX += 2) {
+      Uint64 = ReadUnaligned64 ((CONST UINT64 *)&Blt[IndexX]);
+      WriteUnaligned64 (
+        (UINT64 *)(Destination + IndexX * sizeof (UINT32)),
+        (Uint64 & PIXEL_PAIR_GREEN_MASK) |
+        ((Uint64 >> 16) & PIXEL_PAIR_LOW_BYTE_MASK) |
+        ((Uint64 & PIXEL_PAIR_LOW_BYTE_MASK) << 16)
+        );
+    }
+  }
+
+  RedMask       = Configure->PixelMasks.RedMask;
+  GreenMask     = Configure->PixelMasks.GreenMask;
+  BlueMask      = Configure->PixelMasks.BlueMask;
+  BytesPerPixel = Configure->BytesPerPixel;
+  for ( ; IndexX < Width; IndexX++) {
+    Uint32                                             = *(CONST UINT32 *)&Blt[IndexX];
+    *(UINT32 *)(Destination + (IndexX * BytesPerPixel)) =
+      (UINT32)(
+               (((Uint32 << Configure->PixelShl[0]) >> Configure->PixelShr[0]) & RedMask) |
+               (((Uint32 << Configure->PixelShl[1]) >> Configure->PixelShr[1]) & GreenMask) |
+               (((Uint32 << Configure->PixelShl[2]) >> Configure->PixelShr[2]) & BlueMask)
+               );
+  }
+}
+
 /**
   Performs a UEFI Graphics Output Protocol Blt Video to Buffer operation
   with extended parameters.
@@ -370,15 +493,12 @@ FrameBufferBltLibVideoToBltBuffer (
   IN     UINTN                       Delta
   )
 {
-  UINTN                          DstY;
-  UINTN                          SrcY;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
-  UINT8                          *Source;
-  UINT8                          *Destination;
-  UINTN                          IndexX;
-  UINT32                         Uint32;
-  UINTN                          Offset;
-  UINTN                          WidthInBytes;
+  UINTN  DstY;
+  UINTN  SrcY;
+  UINT8  *Source;
+  UINT8  *Destination;
+  UINTN  Offset;
+  UINTN  WidthInBytes;
 
   //
   // Video to BltBuffer: Source is Video, destination is BltBuffer
@@ -406,6 +526,22 @@ FrameBufferBltLibVideoToBltBuffer (
 
   WidthInBytes = Width * Configure->BytesPerPixel;
 
+  //
+  // When both the video rectangle and the BltBuffer rectangle are contiguous
+  // in memory, move the whole block with a single copy.
+  //
+  if ((Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) &&
+      (SourceX == 0) && (Width == Configure->PixelsPerScanLine) &&
+      (DestinationX == 0) && (Delta == WidthInBytes))
+  {
+    CopyMem (
+      (UINT8 *)BltBuffer + (DestinationY * Delta),
+      Configure->FrameBuffer + (SourceY * WidthInBytes),
+      WidthInBytes * Height
+      );
+    return RETURN_SUCCESS;
+  }
+
   //
   // Video to BltBuffer: Source is Video, destination is BltBuffer
   //
@@ -426,21 +562,13 @@ FrameBufferBltLibVideoToBltBuffer (
     CopyMem (Destination, Source, WidthInBytes);
 
     if (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)
-              ((UINT8 *)BltBuffer + (DstY * Delta) +
-               (DestinationX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-        Uint32         = *(UINT32 *)(Configure->LineBuffer + (IndexX * Configure->BytesPerPixel));
-        *(UINT32 *)Blt =
-          (UINT32)(
-                   (((Uint32 & Configure->PixelMasks.RedMask) >>
-                     Configure->PixelShl[0]) << Configure->PixelShr[0]) |
-                   (((Uint32 & Configure->PixelMasks.GreenMask) >>
-                     Configure->PixelShl[1]) << Configure->PixelShr[1]) |
-                   (((Uint32 & Configure->PixelMasks.BlueMask) >>
-                     Configure->PixelShl[2]) << Configure->PixelShr[2])
-                   );
-      }
+      FrameBufferBltLibVideoToBltLine (
+        Configure,
+        (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)((UINT8 *)BltBuffer + (DstY * Delta) +
+                                          DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)),
+        Configure->LineBuffer,
+        Width
+        );
     }
   }
 
@@ -478,15 +606,12 @@ FrameBufferBltLibBufferToVideo (
   IN  UINTN                          Delta
   )
 {
-  UINTN                          DstY;
-  UINTN                          SrcY;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
-  UINT8                          *Source;
-  UINT8                          *Destination;
-  UINTN                          IndexX;
-  UINT32                         Uint32;
-  UINTN                          Offset;
-  UINTN                          WidthInBytes;
+  UINTN  DstY;
+  UINTN  SrcY;
+  UINT8  *Source;
+  UINT8  *Destination;
+  UINTN  Offset;
+  UINTN  WidthInBytes;
 
   //
   // BltBuffer to Video: Source is BltBuffer, destination is Video
@@ -514,6 +639,23 @@ FrameBufferBltLibBufferToVideo (
 
   WidthInBytes = Width * Configure->BytesPerPixel;
 
+  //
+  // When both the BltBuffer rectangle and the video rectangle are contiguous
+  // in memory, move the whole block with a single copy. Large sequential
+  // writes make the best use of write-combining frame buffer mappings.
+  //
+  if ((Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) &&
+      (DestinationX == 0) && (Width == Configure->PixelsPerScanLine) &&
+      (SourceX == 0) && (Delta == WidthInBytes))
+  {
+    CopyMem (
+      Configure->FrameBuffer + (DestinationY * WidthInBytes),
+      (UINT8 *)BltBuffer + (SourceY * Delta),
+      WidthInBytes * Height
+      );
+    return RETURN_SUCCESS;
+  }
+
   for (SrcY = SourceY, DstY = DestinationY;
        SrcY < (Height + SourceY);
        SrcY++, DstY++)
@@ -525,25 +667,13 @@ FrameBufferBltLibBufferToVideo (
     if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
       Source = (UINT8 *)BltBuffer + (SrcY * Delta) + SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
     } else {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt =
-          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)(
-                                            (UINT8 *)BltBuffer +
-                                            (SrcY * Delta) +
-                                            ((SourceX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
-                                            );
-        Uint32                                                                   = *(UINT32 *)Blt;
-        *(UINT32 *)(Configure->LineBuffer + (IndexX * Configure->BytesPerPixel)) =
-          (UINT32)(
-                   (((Uint32 << Configure->PixelShl[0]) >> Configure->PixelShr[0]) &
-                    Configure->PixelMasks.RedMask) |
-                   (((Uint32 << Configure->PixelShl[1]) >> Configure->PixelShr[1]) &
-                    Configure->PixelMasks.GreenMask) |
-                   (((Uint32 << Configure->PixelShl[2]) >> Configure->PixelShr[2]) &
-                    Configure->PixelMasks.BlueMask)
-                   );
-      }
-
+      FrameBufferBltLibBltToVideoLine (
+        Configure,
+        Configure->LineBuffer,
+        (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)((UINT8 *)BltBuffer + (SrcY * Delta) +
+                                          SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)),
+        Width
+        );
       Source = Configure->LineBuffer;
     }
 
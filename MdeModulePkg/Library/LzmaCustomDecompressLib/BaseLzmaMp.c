@@ -0,0 +1,36 @@
+/** @file
+  LZMA split-stream decompression without MP services: the BSP decodes all the chunks.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+/**
+  Get the number of enabled processors.
+
+  @return  1, the chunks are decoded on the BSP only.
+**/
+UINTN
+LzmaGetProcessorCount (
+  VOID
+  )
+{
+  return 1;
+}
+
+/**
+  Run a procedure on the BSP.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+LzmaStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  Procedure (Argument);
+}
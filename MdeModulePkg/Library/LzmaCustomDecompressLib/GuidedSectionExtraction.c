@@ -183,7 +183,8 @@ LzmaGuidedSectionExtraction (
 }
 
 /**
-  Register LzmaDecompress and LzmaDecompressGetInfo handlers with LzmaCustomerDecompressGuid.
+  Register LzmaDecompress and LzmaDecompressGetInfo handlers with LzmaCustomerDecompressGuid,
+  and the split-stream ones with LzmaSplitCustomDecompressGuid.
 
   @retval  RETURN_SUCCESS            Register successfully.
   @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
@@ -194,9 +195,20 @@ LzmaDecompressLibConstructor (
   VOID
   )
 {
+  RETURN_STATUS  Status;
+
+  Status = ExtractGuidedSectionRegisterHandlers (
+             &gLzmaCustomDecompressGuid,
+             LzmaGuidedSectionGetInfo,
+             LzmaGuidedSectionExtraction
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
   return ExtractGuidedSectionRegisterHandlers (
-           &gLzmaCustomDecompressGuid,
-           LzmaGuidedSectionGetInfo,
-           LzmaGuidedSectionExtraction
+           &gLzmaSplitCustomDecompressGuid,
+           LzmaSplitGuidedSectionGetInfo,
+           LzmaSplitGuidedSectionExtraction
            );
 }
@@ -11,8 +11,6 @@
 #include "Sdk/C/7zVersion.h"
 #include "Sdk/C/LzmaDec.h"
 
-#define SCRATCH_BUFFER_REQUEST_SIZE  SIZE_64KB
-
 typedef struct {
   ISzAlloc    Functions;
   VOID        *Buffer;
@@ -156,34 +154,27 @@ LzmaUefiDecompressGetInfo (
 }
 
 /**
-  Decompresses a Lzma compressed source buffer.
+  Decode a raw LZMA stream, which has no header, into a buffer of known size.
 
-  Extracts decompressed data to its original form.
-  If the compressed source data specified by Source is successfully decompressed
-  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
-  specified by Source is not in a valid compressed data format,
-  then RETURN_INVALID_PARAMETER is returned.
+  @param  Props           The LZMA_PROPS_SIZE bytes of LZMA properties.
+  @param  Source          The raw LZMA stream.
+  @param  SourceSize      The size of the raw LZMA stream.
+  @param  Destination     The buffer receiving the decoded data.
+  @param  DestinationSize The size of the decoded data.
+  @param  Scratch         A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes.
 
-  @param  Source      The source buffer containing the compressed data.
-  @param  SourceSize  The size of source buffer.
-  @param  Destination The destination buffer to store the decompressed data
-  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
-                      This is an optional parameter that may be NULL if the
-                      required scratch buffer size is 0.
-
-  @retval  RETURN_SUCCESS Decompression completed successfully, and
-                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_SUCCESS The stream was decoded.
   @retval  RETURN_INVALID_PARAMETER
-                          The source buffer specified by Source is corrupted
-                          (not in a valid compressed format).
+                          The stream is corrupted.
 **/
 RETURN_STATUS
-EFIAPI
-LzmaUefiDecompress (
-  IN CONST VOID  *Source,
-  IN UINTN       SourceSize,
-  IN OUT VOID    *Destination,
-  IN OUT VOID    *Scratch
+LzmaDecodeRaw (
+  IN CONST UINT8  *Props,
+  IN CONST VOID   *Source,
+  IN UINTN        SourceSize,
+  OUT VOID        *Destination,
+  IN UINTN        DestinationSize,
+  IN VOID         *Scratch
   )
 {
   SRes              LzmaResult;
@@ -197,15 +188,15 @@ LzmaUefiDecompress (
   AllocFuncs.Buffer          = Scratch;
   AllocFuncs.BufferSize      = SCRATCH_BUFFER_REQUEST_SIZE;
 
-  DecodedBufSize  = (SizeT)GetDecodedSizeOfBuf ((UINT8 *)Source);
-  EncodedDataSize = (SizeT)(SourceSize - LZMA_HEADER_SIZE);
+  DecodedBufSize  = (SizeT)DestinationSize;
+  EncodedDataSize = (SizeT)SourceSize;
 
   LzmaResult = LzmaDecode (
                  Destination,
                  &DecodedBufSize,
-                 (Byte *)((UINT8 *)Source + LZMA_HEADER_SIZE),
-                 &EncodedDataSize,
                  Source,
+                 &EncodedDataSize,
+                 Props,
                  LZMA_PROPS_SIZE,
                  LZMA_FINISH_END,
                  &Status,
@@ -218,3 +209,44 @@ LzmaUefiDecompress (
     return RETURN_INVALID_PARAMETER;
   }
 }
+
+/**
+  Decompresses a Lzma compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
+                      This is an optional parameter that may be NULL if the
+                      required scratch buffer size is 0.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  return LzmaDecodeRaw (
+           Source,
+           (UINT8 *)Source + LZMA_HEADER_SIZE,
+           SourceSize - LZMA_HEADER_SIZE,
+           Destination,
+           (UINTN)GetDecodedSizeOfBuf ((UINT8 *)Source),
+           Scratch
+           );
+}
@@ -14,9 +14,105 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/SynchronizationLib.h>
 #include <Library/ExtractGuidedSectionLib.h>
 #include <Guid/LzmaDecompress.h>
 
+#define SCRATCH_BUFFER_REQUEST_SIZE  SIZE_64KB
+
+//
+// Most scratch buffers, hence processors, decoding the chunks of one
+// split-stream section at the same time.
+//
+#define LZMA_SPLIT_MAX_CONTEXTS  16
+
+//
+// A chunk of a split-stream section: a raw LZMA stream, encoded
+// independently of the other chunks.
+//
+typedef struct {
+  CONST UINT8    *Source;
+  UINTN          SourceSize;
+  UINTN          DestinationOffset;
+  UINTN          DestinationSize;
+  BOOLEAN        Decoded;
+} LZMA_SPLIT_CHUNK;
+
+//
+// The chunks of one section, shared by all the processors decoding them.
+//
+typedef struct {
+  CONST UINT8         *Props;
+  LZMA_SPLIT_CHUNK    *Chunks;
+  UINT32              ChunkCount;
+  volatile UINT32     NextChunk;
+  UINT8               *Destination;
+  UINT8               *Contexts;
+  UINT32              ContextCount;
+  volatile UINT32     NextContext;
+} LZMA_SPLIT_JOB;
+
+/**
+  Get the size of the uncompressed buffer by parsing EncodeData header.
+
+  @param EncodedData  Pointer to the compressed data.
+
+  @return The size of the uncompressed buffer.
+**/
+UINT64
+GetDecodedSizeOfBuf (
+  UINT8  *EncodedData
+  );
+
+/**
+  Decode a raw LZMA stream, which has no header, into a buffer of known size.
+
+  @param  Props           The LZMA_PROPS_SIZE bytes of LZMA properties.
+  @param  Source          The raw LZMA stream.
+  @param  SourceSize      The size of the raw LZMA stream.
+  @param  Destination     The buffer receiving the decoded data.
+  @param  DestinationSize The size of the decoded data.
+  @param  Scratch         A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes.
+
+  @retval  RETURN_SUCCESS The stream was decoded.
+  @retval  RETURN_INVALID_PARAMETER
+                          The stream is corrupted.
+**/
+RETURN_STATUS
+LzmaDecodeRaw (
+  IN CONST UINT8  *Props,
+  IN CONST VOID   *Source,
+  IN UINTN        SourceSize,
+  OUT VOID        *Destination,
+  IN UINTN        DestinationSize,
+  IN VOID         *Scratch
+  );
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+LzmaGetProcessorCount (
+  VOID
+  );
+
+/**
+  Run a procedure on the BSP and all the enabled APs, and wait for them.
+
+  Without MP services, the procedure runs on the BSP alone.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+LzmaStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  );
+
 /**
   Given a Lzma compressed source buffer, this function retrieves the size of
   the uncompressed buffer and the size of the scratch buffer required
@@ -91,4 +187,100 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Examines a split-stream GUIDed section and returns the size of the decoded
+  buffer and the size of the scratch buffer required to decode it.
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  );
+
+/**
+  Decompress a split-stream LZMA compressed GUIDed section into a caller
+  allocated output buffer.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer used as a scratch buffer.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  );
+
+/**
+  Given a split-stream Lzma compressed source buffer, this function retrieves
+  the size of the uncompressed buffer and the size of the scratch buffer
+  required to decompress the compressed source buffer.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+
+  @retval  RETURN_SUCCESS The size of the uncompressed data was returned
+                          in DestinationSize and the size of the scratch
+                          buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER
+                          The chunk table is corrupted.
+  @retval  RETURN_UNSUPPORTED
+                          The uncompressed buffer size does not fit in a UINT32.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a split-stream Lzma compressed source buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaSplitUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
 #endif
@@ -0,0 +1,285 @@
+/** @file
+  LZMA split-stream Decompress interfaces
+
+  A split-stream section starts with the LZMA header: the properties and the
+  size of all the decoded data. Then come the decoded size of the chunks, the
+  number of chunks, and the encoded size of each chunk, all little-endian
+  UINT32. Then come the chunks, raw LZMA streams of the same properties,
+  encoded independently of one another. Every chunk but the last decodes to
+  the chunk size, so the chunks are decoded on all the processors at the
+  same time.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include "Sdk/C/7zTypes.h"
+#include "Sdk/C/LzmaDec.h"
+
+#define LZMA_HEADER_SIZE        (LZMA_PROPS_SIZE + 8)
+#define LZMA_SPLIT_HEADER_SIZE  (LZMA_HEADER_SIZE + 8)
+
+/**
+  Walk the chunk table of a split-stream source buffer.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  Chunks          The array receiving the chunks, or NULL to check
+                          the table only.
+  @param  ChunkCount      Returns the number of chunks.
+  @param  DestinationSize Returns the size of the decompressed data.
+
+  @retval  RETURN_SUCCESS The chunk table was walked.
+  @retval  RETURN_INVALID_PARAMETER
+                          The chunk table is corrupted.
+  @retval  RETURN_UNSUPPORTED
+                          The decompressed size does not fit in a UINT32.
+**/
+RETURN_STATUS
+LzmaSplitParseChunks (
+  IN  CONST UINT8       *Source,
+  IN  UINTN             SourceSize,
+  OUT LZMA_SPLIT_CHUNK  *Chunks  OPTIONAL,
+  OUT UINT32            *ChunkCount,
+  OUT UINT32            *DestinationSize
+  )
+{
+  UINT64  DecodedSize;
+  UINT32  SplitSize;
+  UINT32  Count;
+  UINT32  Index;
+  UINTN   Offset;
+  UINTN   EncodedSize;
+
+  if (SourceSize < LZMA_SPLIT_HEADER_SIZE) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  DecodedSize = GetDecodedSizeOfBuf ((UINT8 *)Source);
+  if (DecodedSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  SplitSize = ReadUnaligned32 ((UINT32 *)(Source + LZMA_HEADER_SIZE));
+  Count     = ReadUnaligned32 ((UINT32 *)(Source + LZMA_HEADER_SIZE + sizeof (UINT32)));
+  if ((SplitSize == 0) || (Count == 0) ||
+      (Count != DivU64x32 (DecodedSize + SplitSize - 1, SplitSize)) ||
+      (Count > (SourceSize - LZMA_SPLIT_HEADER_SIZE) / sizeof (UINT32)))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Offset = LZMA_SPLIT_HEADER_SIZE + Count * sizeof (UINT32);
+  for (Index = 0; Index < Count; Index++) {
+    EncodedSize = ReadUnaligned32 ((UINT32 *)(Source + LZMA_SPLIT_HEADER_SIZE) + Index);
+    if (EncodedSize > SourceSize - Offset) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if (Chunks != NULL) {
+      Chunks[Index].Source            = Source + Offset;
+      Chunks[Index].SourceSize        = EncodedSize;
+      Chunks[Index].DestinationOffset = (UINTN)Index * SplitSize;
+      Chunks[Index].DestinationSize   = (UINTN)MIN (SplitSize, DecodedSize - (UINT64)Index * SplitSize);
+      Chunks[Index].Decoded           = FALSE;
+    }
+
+    Offset += EncodedSize;
+  }
+
+  *ChunkCount      = Count;
+  *DestinationSize = (UINT32)DecodedSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Get the number of scratch buffers used to decode a number of chunks.
+
+  @param  ChunkCount      The number of chunks.
+
+  @return The number of scratch buffers.
+**/
+UINT32
+LzmaSplitGetContextCount (
+  IN UINT32  ChunkCount
+  )
+{
+  UINTN  Count;
+
+  Count = MIN (LzmaGetProcessorCount (), LZMA_SPLIT_MAX_CONTEXTS);
+  return (UINT32)MAX (MIN (Count, ChunkCount), 1);
+}
+
+/**
+  Decode chunks of a job until none is left.
+
+  This runs on the BSP and the APs at the same time. Each processor takes a
+  scratch buffer of its own, then the next chunk nobody took yet. A
+  processor finding no free scratch buffer returns right away.
+
+  @param  Buffer          The LZMA_SPLIT_JOB instance.
+**/
+VOID
+EFIAPI
+LzmaSplitDecodeChunks (
+  IN OUT VOID  *Buffer
+  )
+{
+  RETURN_STATUS     Status;
+  LZMA_SPLIT_JOB    *Job;
+  LZMA_SPLIT_CHUNK  *Chunk;
+  VOID              *Scratch;
+  UINT32            Context;
+  UINT32            Index;
+
+  Job     = (LZMA_SPLIT_JOB *)Buffer;
+  Context = InterlockedIncrement (&Job->NextContext) - 1;
+  if (Context >= Job->ContextCount) {
+    return;
+  }
+
+  Scratch = Job->Contexts + Context * SCRATCH_BUFFER_REQUEST_SIZE;
+  for (Index = InterlockedIncrement (&Job->NextChunk) - 1;
+       Index < Job->ChunkCount;
+       Index = InterlockedIncrement (&Job->NextChunk) - 1)
+  {
+    Chunk  = &Job->Chunks[Index];
+    Status = LzmaDecodeRaw (
+               Job->Props,
+               Chunk->Source,
+               Chunk->SourceSize,
+               Job->Destination + Chunk->DestinationOffset,
+               Chunk->DestinationSize,
+               Scratch
+               );
+    Chunk->Decoded = (BOOLEAN)!RETURN_ERROR (Status);
+  }
+}
+
+/**
+  Given a split-stream Lzma compressed source buffer, this function retrieves
+  the size of the uncompressed buffer and the size of the scratch buffer
+  required to decompress the compressed source buffer.
+
+  The scratch buffer holds the chunk table, and one LZMA scratch buffer per
+  processor decoding the chunks.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+
+  @retval  RETURN_SUCCESS The size of the uncompressed data was returned
+                          in DestinationSize and the size of the scratch
+                          buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER
+                          The chunk table is corrupted.
+  @retval  RETURN_UNSUPPORTED
+                          The uncompressed buffer size does not fit in a UINT32.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         ChunkCount;
+  UINTN          Size;
+
+  Status = LzmaSplitParseChunks (Source, SourceSize, NULL, &ChunkCount, DestinationSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Size = ALIGN_VALUE (ChunkCount * sizeof (LZMA_SPLIT_CHUNK), sizeof (UINT64)) +
+         LzmaSplitGetContextCount (ChunkCount) * SCRATCH_BUFFER_REQUEST_SIZE;
+  if (Size > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  *ScratchSize = (UINT32)Size;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a split-stream Lzma compressed source buffer.
+
+  The chunks are decoded on the BSP and the enabled APs. A chunk an AP could
+  not decode is decoded again on the BSP before failing.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaSplitUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaSplitUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS     Status;
+  LZMA_SPLIT_JOB    Job;
+  LZMA_SPLIT_CHUNK  *Chunk;
+  UINT32            DestinationSize;
+  UINT32            Index;
+
+  ASSERT (Scratch != NULL);
+
+  ZeroMem (&Job, sizeof (Job));
+  Job.Chunks = (LZMA_SPLIT_CHUNK *)Scratch;
+  Status     = LzmaSplitParseChunks (Source, SourceSize, Job.Chunks, &Job.ChunkCount, &DestinationSize);
+  if (RETURN_ERROR (Status)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Job.Props        = Source;
+  Job.Destination  = Destination;
+  Job.Contexts     = (UINT8 *)Scratch + ALIGN_VALUE (Job.ChunkCount * sizeof (LZMA_SPLIT_CHUNK), sizeof (UINT64));
+  Job.ContextCount = LzmaSplitGetContextCount (Job.ChunkCount);
+
+  if (Job.ContextCount > 1) {
+    LzmaStartupAllCpus (LzmaSplitDecodeChunks, &Job);
+  }
+
+  //
+  // Decode on the BSP whatever is left: all the chunks without other
+  // processors, and the chunks an AP failed to decode.
+  //
+  for (Index = 0; Index < Job.ChunkCount; Index++) {
+    Chunk = &Job.Chunks[Index];
+    if (Chunk->Decoded) {
+      continue;
+    }
+
+    Status = LzmaDecodeRaw (
+               Job.Props,
+               Chunk->Source,
+               Chunk->SourceSize,
+               Job.Destination + Chunk->DestinationOffset,
+               Chunk->DestinationSize,
+               Job.Contexts
+               );
+    if (RETURN_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Chunk %d is corrupted\n", __FUNCTION__, Index));
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -109,6 +109,10 @@ DebugPrintMarker (
     return;
   }
 
+  //
+  // The message is not formatted here. The format string and the raw arguments
+  // are passed to the status code listeners, and only the listeners that output
+  // the message format it.
   //
   // Compute the total size of the record.
   // Note that the passing-in format string and variable parameters will be constructed to
@@ -1075,24 +1075,54 @@ BootScriptExecuteSmbusExecute (
 }
 
 /**
-  Interpret the boot script node with EFI_BOOT_SCRIPT_STALL OP code.
+  Interpret the boot script nodes with EFI_BOOT_SCRIPT_STALL OP code.
 
-  @param Script      The pointer of typed node in boot script table
+  The stall nodes following the first one are executed with it as one stall
+  of their total duration, which saves the overhead of a MicroSecondDelay ()
+  call for each of them.
+
+  @param Script      On input, the pointer of the first stall node in boot script table.
+                     On output, the pointer of the last stall node executed.
+  @param ScriptEnd   The end of the boot script table.
 
   @retval EFI_SUCCESS The operation was executed successfully
 **/
 EFI_STATUS
 BootScriptExecuteStall (
-  IN UINT8  *Script
+  IN OUT UINT8  **Script,
+  IN     UINTN  ScriptEnd
   )
 {
   EFI_BOOT_SCRIPT_STALL  Stall;
+  UINT64                 Duration;
+  UINT8                  *Next;
+
+  CopyMem ((VOID *)&Stall, (VOID *)*Script, sizeof (EFI_BOOT_SCRIPT_STALL));
+  Duration = Stall.Duration;
+
+  //
+  // The caller steps over the last stall node executed by the length of the
+  // first one, so only merge nodes of the standard length.
+  //
+  for (Next = *Script + sizeof (EFI_BOOT_SCRIPT_STALL);
+       (Stall.Length == sizeof (EFI_BOOT_SCRIPT_STALL)) && ((UINTN)Next + sizeof (EFI_BOOT_SCRIPT_STALL) <= ScriptEnd);
+       Next += sizeof (EFI_BOOT_SCRIPT_STALL))
+  {
+    CopyMem ((VOID *)&Stall, (VOID *)Next, sizeof (EFI_BOOT_SCRIPT_STALL));
+    if ((Stall.OpCode != EFI_BOOT_SCRIPT_STALL_OPCODE) ||
+        (Stall.Length != sizeof (EFI_BOOT_SCRIPT_STALL)) ||
+        (Stall.Duration > MAX_UINTN - Duration))
+    {
+      break;
+    }
 
-  CopyMem ((VOID *)&Stall, (VOID *)Script, sizeof (EFI_BOOT_SCRIPT_STALL));
+    Duration += Stall.Duration;
+    *Script   = Next;
+  }
 
-  DEBUG ((DEBUG_INFO, "BootScriptExecuteStall - 0x%08x\n", (UINTN)Stall.Duration));
+  DEBUG ((DEBUG_INFO, "BootScriptExecuteStall - 0x%08x\n", (UINTN)Duration));
 
-  MicroSecondDelay ((UINTN)Stall.Duration);
+  MicroSecondDelay ((UINTN)Duration);
   return EFI_SUCCESS;
 }
 
@@ -1751,7 +1781,7 @@ S3BootScriptExecute (
 
       case EFI_BOOT_SCRIPT_STALL_OPCODE:
         DEBUG ((DEBUG_INFO, "EFI_BOOT_SCRIPT_STALL_OPCODE\n"));
-        Status = BootScriptExecuteStall (Script);
+        Status = BootScriptExecuteStall (&Script, StartAddress + TableLength);
         break;
 
       case EFI_BOOT_SCRIPT_MEM_POLL_OPCODE:
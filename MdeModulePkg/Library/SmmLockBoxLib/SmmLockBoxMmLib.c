@@ -366,6 +366,11 @@ InternalGetLockBoxQueue (
 /**
   This function find LockBox by GUID.
 
+  The queue is a plain list in SMRAM on purpose: it is shared by every module
+  linking this library, and SmmLockBoxPeiLib walks the same SMM_LOCK_BOX_DATA
+  layout directly on S3 resume. A module private index could go stale when
+  another module saves a LockBox, and there are only a few dozen LockBoxes.
+
   @param Guid The guid to indentify the LockBox
 
   @return LockBoxData
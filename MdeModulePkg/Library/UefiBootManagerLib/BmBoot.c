@@ -1029,6 +1029,93 @@ BmExpandPartitionDevicePath (
   return FullPath;
 }
 
+/**
+  Record the device a boot option is loaded from, so that the next boot can
+  connect it by EfiBootManagerConnectRecordedDevicePaths() instead of
+  connecting all the controllers.
+
+  @param FilePath  The full device path the boot option is loaded from.
+**/
+VOID
+BmRecordBootDevicePath (
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+  EFI_DEVICE_PATH_PROTOCOL  *RecordedDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *TempDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Instance;
+  UINTN                     Size;
+  BOOLEAN                   Recorded;
+
+  //
+  // Images in firmware volumes or memory don't need any device to be connected.
+  //
+  if (DevicePathType (FilePath) == MEDIA_DEVICE_PATH) {
+    return;
+  }
+
+  //
+  // Strip the file name, e.g. ACPI()/PCI()/SATA()/HD()/\EFI\BOOT\BOOTX64.EFI
+  // is recorded as ACPI()/PCI()/SATA()/HD().
+  //
+  DevicePath = DuplicateDevicePath (FilePath);
+  if (DevicePath == NULL) {
+    return;
+  }
+
+  for (Node = DevicePath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH) && (DevicePathSubType (Node) == MEDIA_FILEPATH_DP)) {
+      SetDevicePathEndNode (Node);
+      break;
+    }
+  }
+
+  GetVariable2 (BM_CONNECT_DEVICE_PATH_VARIABLE_NAME, &mBmHardDriveBootVariableGuid, (VOID **)&RecordedDevicePath, &Size);
+  if ((RecordedDevicePath != NULL) && !IsDevicePathValid (RecordedDevicePath, Size)) {
+    FreePool (RecordedDevicePath);
+    RecordedDevicePath = NULL;
+  }
+
+  //
+  // Don't write the variable again when the device is already the most recent one.
+  //
+  Recorded = FALSE;
+  if (RecordedDevicePath != NULL) {
+    TempDevicePath = RecordedDevicePath;
+    Instance       = GetNextDevicePathInstance (&TempDevicePath, &Size);
+    if (Instance != NULL) {
+      Recorded = (BOOLEAN)((Size == GetDevicePathSize (DevicePath)) && (CompareMem (Instance, DevicePath, Size) == 0));
+      FreePool (Instance);
+    }
+  }
+
+  if (!Recorded) {
+    BmCachePartitionDevicePath (&RecordedDevicePath, DevicePath);
+    if (RecordedDevicePath != NULL) {
+      //
+      // Failing to save only makes the next boot connect all the controllers.
+      //
+      Status = gRT->SetVariable (
+                      BM_CONNECT_DEVICE_PATH_VARIABLE_NAME,
+                      &mBmHardDriveBootVariableGuid,
+                      EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_NON_VOLATILE,
+                      GetDevicePathSize (RecordedDevicePath),
+                      RecordedDevicePath
+                      );
+      DEBUG ((DEBUG_INFO, "[Bds] Record boot device path - %r\n", Status));
+    }
+  }
+
+  if (RecordedDevicePath != NULL) {
+    FreePool (RecordedDevicePath);
+  }
+
+  FreePool (DevicePath);
+}
+
 /**
   Expand the media device path which points to a BlockIo or SimpleFileSystem instance
   by appending EFI_REMOVABLE_MEDIA_FILE_NAME.
@@ -1943,6 +2030,12 @@ EfiBootManagerBoot (
       FreePool (FileBuffer);
     }
 
+    if (  FeaturePcdGet (PcdBootManagerConnectRecordedDevicePaths)
+       && !EFI_ERROR (Status) && (FilePath != NULL) && (RamDiskDevicePath == NULL))
+    {
+      BmRecordBootDevicePath (FilePath);
+    }
+
     if (FilePath != NULL) {
       FreePool (FilePath);
     }
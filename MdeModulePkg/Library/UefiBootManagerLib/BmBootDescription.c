@@ -18,6 +18,7 @@ CONST UINT16  mBmUsbLangId    = 0x0409; // English
 CHAR16        mBmUefiPrefix[] = L"UEFI ";
 
 LIST_ENTRY  mPlatformBootDescriptionHandlers = INITIALIZE_LIST_HEAD_VARIABLE (mPlatformBootDescriptionHandlers);
+LIST_ENTRY  mBmBootDescriptionCache          = INITIALIZE_LIST_HEAD_VARIABLE (mBmBootDescriptionCache);
 
 /**
   For a bootable Device path, return its boot type.
@@ -736,6 +737,135 @@ BmGetMiscDescription (
   return AllocateCopyPool (StrSize (Description), Description);
 }
 
+/**
+  Free all the cached boot descriptions.
+**/
+VOID
+BmFreeBootDescriptionCache (
+  VOID
+  )
+{
+  LIST_ENTRY                       *Link;
+  BM_BOOT_DESCRIPTION_CACHE_ENTRY  *Entry;
+
+  while (!IsListEmpty (&mBmBootDescriptionCache)) {
+    Link  = GetFirstNode (&mBmBootDescriptionCache);
+    Entry = CR (Link, BM_BOOT_DESCRIPTION_CACHE_ENTRY, Link, BM_BOOT_DESCRIPTION_CACHE_ENTRY_SIGNATURE);
+    RemoveEntryList (Link);
+    FreePool (Entry->DevicePath);
+    FreePool (Entry->Description);
+    FreePool (Entry);
+  }
+}
+
+/**
+  Find the cached boot description of the controller.
+
+  An entry of the same handle but with a different device path or media is
+  stale, it's removed from the cache.
+
+  @param Handle      Controller handle.
+  @param DevicePath  Device path of the controller.
+  @param Media       Media of the controller, NULL if it doesn't produce Block IO.
+
+  @return  The cache entry, or NULL if the description isn't cached.
+**/
+BM_BOOT_DESCRIPTION_CACHE_ENTRY *
+BmFindBootDescriptionCache (
+  IN EFI_HANDLE                Handle,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN EFI_BLOCK_IO_MEDIA        *Media
+  )
+{
+  LIST_ENTRY                       *Link;
+  BM_BOOT_DESCRIPTION_CACHE_ENTRY  *Entry;
+  UINTN                            DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  for ( Link = GetFirstNode (&mBmBootDescriptionCache)
+        ; !IsNull (&mBmBootDescriptionCache, Link)
+        ; Link = GetNextNode (&mBmBootDescriptionCache, Link)
+        )
+  {
+    Entry = CR (Link, BM_BOOT_DESCRIPTION_CACHE_ENTRY, Link, BM_BOOT_DESCRIPTION_CACHE_ENTRY_SIGNATURE);
+    if (Entry->Handle != Handle) {
+      continue;
+    }
+
+    if ((GetDevicePathSize (Entry->DevicePath) == DevicePathSize) &&
+        (CompareMem (Entry->DevicePath, DevicePath, DevicePathSize) == 0) &&
+        (((Media == NULL) && (Entry->BlockSize == 0)) ||
+         ((Media != NULL) &&
+          (Entry->RemovableMedia == Media->RemovableMedia) &&
+          (Entry->MediaPresent == Media->MediaPresent) &&
+          (Entry->MediaId == Media->MediaId) &&
+          (Entry->BlockSize == Media->BlockSize) &&
+          (Entry->LastBlock == Media->LastBlock))))
+    {
+      return Entry;
+    }
+
+    RemoveEntryList (Link);
+    FreePool (Entry->DevicePath);
+    FreePool (Entry->Description);
+    FreePool (Entry);
+    break;
+  }
+
+  return NULL;
+}
+
+/**
+  Cache the boot description of the controller.
+
+  @param Handle       Controller handle.
+  @param DevicePath   Device path of the controller.
+  @param Media        Media of the controller, NULL if it doesn't produce Block IO.
+  @param Description  The boot description of the controller.
+**/
+VOID
+BmAddBootDescriptionCache (
+  IN EFI_HANDLE                Handle,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN EFI_BLOCK_IO_MEDIA        *Media,
+  IN CHAR16                    *Description
+  )
+{
+  BM_BOOT_DESCRIPTION_CACHE_ENTRY  *Entry;
+
+  Entry = AllocateZeroPool (sizeof (BM_BOOT_DESCRIPTION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    return;
+  }
+
+  Entry->Signature   = BM_BOOT_DESCRIPTION_CACHE_ENTRY_SIGNATURE;
+  Entry->Handle      = Handle;
+  Entry->DevicePath  = DuplicateDevicePath (DevicePath);
+  Entry->Description = AllocateCopyPool (StrSize (Description), Description);
+  if ((Entry->DevicePath == NULL) || (Entry->Description == NULL)) {
+    if (Entry->DevicePath != NULL) {
+      FreePool (Entry->DevicePath);
+    }
+
+    if (Entry->Description != NULL) {
+      FreePool (Entry->Description);
+    }
+
+    FreePool (Entry);
+    return;
+  }
+
+  if (Media != NULL) {
+    Entry->RemovableMedia = Media->RemovableMedia;
+    Entry->MediaPresent   = Media->MediaPresent;
+    Entry->MediaId        = Media->MediaId;
+    Entry->BlockSize      = Media->BlockSize;
+    Entry->LastBlock      = Media->LastBlock;
+  }
+
+  InsertTailList (&mBmBootDescriptionCache, &Entry->Link);
+}
+
 /**
   Register the platform provided boot description handler.
 
@@ -773,6 +903,11 @@ EfiBootManagerRegisterBootDescriptionHandler (
   Entry->Signature = BM_BOOT_DESCRIPTION_ENTRY_SIGNATURE;
   Entry->Handler   = Handler;
   InsertTailList (&mPlatformBootDescriptionHandlers, &Entry->Link);
+
+  //
+  // The new handler may describe the devices differently.
+  //
+  BmFreeBootDescriptionCache ();
   return EFI_SUCCESS;
 }
 
@@ -797,12 +932,35 @@ BmGetBootDescription (
   IN EFI_HANDLE  Handle
   )
 {
-  LIST_ENTRY                 *Link;
-  BM_BOOT_DESCRIPTION_ENTRY  *Entry;
-  CHAR16                     *Description;
-  CHAR16                     *DefaultDescription;
-  CHAR16                     *Temp;
-  UINTN                      Index;
+  EFI_STATUS                       Status;
+  LIST_ENTRY                       *Link;
+  BM_BOOT_DESCRIPTION_ENTRY        *Entry;
+  BM_BOOT_DESCRIPTION_CACHE_ENTRY  *CacheEntry;
+  EFI_DEVICE_PATH_PROTOCOL         *DevicePath;
+  EFI_BLOCK_IO_PROTOCOL            *BlockIo;
+  EFI_BLOCK_IO_MEDIA               *Media;
+  CHAR16                           *Description;
+  CHAR16                           *DefaultDescription;
+  CHAR16                           *Temp;
+  UINTN                            Index;
+
+  //
+  // Reuse the description built before if the device and its media are unchanged,
+  // the description handlers may need to send commands to the device.
+  //
+  Media      = NULL;
+  DevicePath = DevicePathFromHandle (Handle);
+  Status     = gBS->HandleProtocol (Handle, &gEfiBlockIoProtocolGuid, (VOID **)&BlockIo);
+  if (!EFI_ERROR (Status)) {
+    Media = BlockIo->Media;
+  }
+
+  if (DevicePath != NULL) {
+    CacheEntry = BmFindBootDescriptionCache (Handle, DevicePath, Media);
+    if (CacheEntry != NULL) {
+      return AllocateCopyPool (StrSize (CacheEntry->Description), CacheEntry->Description);
+    }
+  }
 
   //
   // Firstly get the default boot description
@@ -830,6 +988,7 @@ BmGetBootDescription (
   //
   // Secondly query platform for the better boot description
   //
+  Description = NULL;
   for ( Link = GetFirstNode (&mPlatformBootDescriptionHandlers)
         ; !IsNull (&mPlatformBootDescriptionHandlers, Link)
         ; Link = GetNextNode (&mPlatformBootDescriptionHandlers, Link)
@@ -839,11 +998,19 @@ BmGetBootDescription (
     Description = Entry->Handler (Handle, DefaultDescription);
     if (Description != NULL) {
       FreePool (DefaultDescription);
-      return Description;
+      break;
     }
   }
 
-  return DefaultDescription;
+  if (Description == NULL) {
+    Description = DefaultDescription;
+  }
+
+  if (DevicePath != NULL) {
+    BmAddBootDescriptionCache (Handle, DevicePath, Media, Description);
+  }
+
+  return Description;
 }
 
 /**
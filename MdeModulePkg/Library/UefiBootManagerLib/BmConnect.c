@@ -8,6 +8,232 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "InternalBm.h"
 
+//
+// One media probe: a read from the start, and one from the end of a block
+// device, in flight at the same time.
+//
+typedef struct {
+  EFI_BLOCK_IO2_PROTOCOL    *BlockIo2;
+  UINT8                     *Buffer;
+  UINTN                     BufferPages;
+  EFI_BLOCK_IO2_TOKEN       Token[2];
+} BM_MEDIA_PROBE;
+
+#define BM_MEDIA_PROBE_TIMEOUT  EFI_TIMER_PERIOD_SECONDS (10)
+
+/**
+  Connect the controllers breadth first, one level at a time, but leave the
+  block devices alone, so that the drivers producing EFI_BLOCK_IO_PROTOCOL
+  instances get started, while the ones consuming them do not.
+**/
+VOID
+BmConnectAllControllersAboveBlockIo (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       HandleCount;
+  UINTN       LastHandleCount;
+  EFI_HANDLE  *HandleBuffer;
+  UINTN       Index;
+  VOID        *BlockIo;
+
+  HandleCount = 0;
+  do {
+    LastHandleCount = HandleCount;
+
+    Status = gBS->LocateHandleBuffer (
+                    AllHandles,
+                    NULL,
+                    NULL,
+                    &HandleCount,
+                    &HandleBuffer
+                    );
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+
+    if (HandleCount != LastHandleCount) {
+      for (Index = 0; Index < HandleCount; Index++) {
+        Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiBlockIoProtocolGuid, &BlockIo);
+        if (EFI_ERROR (Status)) {
+          gBS->ConnectController (HandleBuffer[Index], NULL, NULL, FALSE);
+        }
+      }
+    }
+
+    FreePool (HandleBuffer);
+  } while (HandleCount != LastHandleCount);
+}
+
+/**
+  Read the first blocks and the last block of every block device that has
+  media present, on all devices at the same time, and wait for the reads to
+  complete. The data is discarded.
+
+  The partition and file system drivers connected afterwards read the same
+  blocks one device after the other. Probing the media concurrently first lets
+  the devices pay their first access latency (spin-up, link setup, seeking)
+  in parallel.
+
+  @param BlockNum  The number of blocks to read from the start of each device.
+**/
+VOID
+BmProbeBlockIoMedia (
+  IN UINT32  BlockNum
+  )
+{
+  EFI_STATUS          Status;
+  UINTN               HandleCount;
+  EFI_HANDLE          *HandleBuffer;
+  BM_MEDIA_PROBE      *Probes;
+  BM_MEDIA_PROBE      *Probe;
+  UINTN               ProbeCount;
+  UINTN               Index;
+  UINTN               TokenIndex;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINTN               HeadSize;
+  UINTN               Pending;
+  EFI_EVENT           TimeoutEvent;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiBlockIo2ProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &HandleBuffer
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Probes = AllocateZeroPool (HandleCount * sizeof (BM_MEDIA_PROBE));
+  if (Probes == NULL) {
+    FreePool (HandleBuffer);
+    return;
+  }
+
+  //
+  // Issue all the reads.
+  //
+  ProbeCount = 0;
+  Pending    = 0;
+  for (Index = 0; Index < HandleCount; Index++) {
+    Probe  = &Probes[ProbeCount];
+    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiBlockIo2ProtocolGuid, (VOID **)&Probe->BlockIo2);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    Media = Probe->BlockIo2->Media;
+    if (!Media->MediaPresent || Media->LogicalPartition || (Media->BlockSize == 0)) {
+      continue;
+    }
+
+    HeadSize           = (UINTN)MIN (BlockNum, Media->LastBlock + 1) * Media->BlockSize;
+    Probe->BufferPages = EFI_SIZE_TO_PAGES (HeadSize + Media->BlockSize);
+    Probe->Buffer      = AllocateAlignedPages (Probe->BufferPages, Media->IoAlign);
+    if (Probe->Buffer == NULL) {
+      continue;
+    }
+
+    ProbeCount++;
+    for (TokenIndex = 0; TokenIndex < ARRAY_SIZE (Probe->Token); TokenIndex++) {
+      if ((TokenIndex == 1) && (BlockNum > Media->LastBlock)) {
+        //
+        // The last block is already part of the first read.
+        //
+        break;
+      }
+
+      Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Probe->Token[TokenIndex].Event);
+      if (EFI_ERROR (Status)) {
+        Probe->Token[TokenIndex].Event = NULL;
+        continue;
+      }
+
+      if (TokenIndex == 0) {
+        Status = Probe->BlockIo2->ReadBlocksEx (
+                                    Probe->BlockIo2,
+                                    Media->MediaId,
+                                    0,
+                                    &Probe->Token[TokenIndex],
+                                    HeadSize,
+                                    Probe->Buffer
+                                    );
+      } else {
+        Status = Probe->BlockIo2->ReadBlocksEx (
+                                    Probe->BlockIo2,
+                                    Media->MediaId,
+                                    Media->LastBlock,
+                                    &Probe->Token[TokenIndex],
+                                    Media->BlockSize,
+                                    Probe->Buffer + HeadSize
+                                    );
+      }
+
+      if (EFI_ERROR (Status)) {
+        gBS->CloseEvent (Probe->Token[TokenIndex].Event);
+        Probe->Token[TokenIndex].Event = NULL;
+      } else {
+        Pending++;
+      }
+    }
+  }
+
+  FreePool (HandleBuffer);
+
+  //
+  // Wait for the reads.
+  //
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimeoutEvent);
+  if (!EFI_ERROR (Status)) {
+    gBS->SetTimer (TimeoutEvent, TimerRelative, BM_MEDIA_PROBE_TIMEOUT);
+  } else {
+    TimeoutEvent = NULL;
+  }
+
+  while (Pending > 0) {
+    for (Index = 0; Index < ProbeCount; Index++) {
+      Probe = &Probes[Index];
+      for (TokenIndex = 0; TokenIndex < ARRAY_SIZE (Probe->Token); TokenIndex++) {
+        if ((Probe->Token[TokenIndex].Event != NULL) &&
+            !EFI_ERROR (gBS->CheckEvent (Probe->Token[TokenIndex].Event)))
+        {
+          gBS->CloseEvent (Probe->Token[TokenIndex].Event);
+          Probe->Token[TokenIndex].Event = NULL;
+          Pending--;
+        }
+      }
+    }
+
+    if ((TimeoutEvent != NULL) && !EFI_ERROR (gBS->CheckEvent (TimeoutEvent))) {
+      break;
+    }
+  }
+
+  if (TimeoutEvent != NULL) {
+    gBS->CloseEvent (TimeoutEvent);
+  }
+
+  //
+  // Release the probes whose reads have all completed. The buffers and events
+  // of the others stay allocated: their devices may still access them.
+  //
+  for (Index = 0; Index < ProbeCount; Index++) {
+    Probe = &Probes[Index];
+    if ((Probe->Token[0].Event == NULL) && (Probe->Token[1].Event == NULL)) {
+      FreeAlignedPages (Probe->Buffer, Probe->BufferPages);
+    }
+  }
+
+  if (Pending > 0) {
+    DEBUG ((DEBUG_WARN, "[Bds] %d media probe(s) timed out\n", Pending));
+  } else {
+    FreePool (Probes);
+  }
+}
+
 /**
   Connect all the drivers to all the controllers.
 
@@ -26,6 +252,15 @@ BmConnectAllDriversToAllControllers (
   UINTN       Index;
 
   do {
+    if (PcdGet32 (PcdBootManagerMediaProbeBlockNum) != 0) {
+      //
+      // Bring up the block devices first, and probe their media concurrently,
+      // before the recursive connect below parses them one after the other.
+      //
+      BmConnectAllControllersAboveBlockIo ();
+      BmProbeBlockIoMedia (PcdGet32 (PcdBootManagerMediaProbeBlockNum));
+    }
+
     //
     // Connect All EFI 1.10 drivers following EFI 1.10 algorithm
     //
@@ -85,6 +320,93 @@ EfiBootManagerConnectAll (
   EfiBootManagerConnectAllDefaultConsoles ();
 }
 
+/**
+  Connect the device paths that boot options were loaded from in previous boots
+  and the platform default consoles, as a faster replacement of
+  EfiBootManagerConnectAll() on a normal boot.
+
+  Falls back to EfiBootManagerConnectAll() if PcdBootManagerConnectRecordedDevicePaths
+  is FALSE, nothing is recorded, or the most recently used device path fails to
+  connect.
+
+  @retval EFI_SUCCESS      Only the recorded device paths were connected.
+  @retval EFI_UNSUPPORTED  PcdBootManagerConnectRecordedDevicePaths is FALSE,
+                           all the controllers were connected.
+  @retval EFI_NOT_FOUND    No device path is recorded, all the controllers were connected.
+  @retval others           The most recently used device path failed to connect,
+                           all the controllers were connected.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerConnectRecordedDevicePaths (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *RecordedDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *TempDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Instance;
+  UINTN                     Size;
+  EFI_HANDLE                Handle;
+  EFI_STATUS                LastBootStatus;
+  UINTN                     Count;
+
+  if (!FeaturePcdGet (PcdBootManagerConnectRecordedDevicePaths)) {
+    EfiBootManagerConnectAll ();
+    return EFI_UNSUPPORTED;
+  }
+
+  GetVariable2 (BM_CONNECT_DEVICE_PATH_VARIABLE_NAME, &mBmHardDriveBootVariableGuid, (VOID **)&RecordedDevicePath, &Size);
+  if ((RecordedDevicePath != NULL) && !IsDevicePathValid (RecordedDevicePath, Size)) {
+    FreePool (RecordedDevicePath);
+    RecordedDevicePath = NULL;
+  }
+
+  if (RecordedDevicePath == NULL) {
+    EfiBootManagerConnectAll ();
+    return EFI_NOT_FOUND;
+  }
+
+  EfiBootManagerConnectAllDefaultConsoles ();
+
+  //
+  // Only the first instance, which was booted last time, has to be connected.
+  // The older ones are connected on a best effort basis.
+  //
+  LastBootStatus = EFI_NOT_FOUND;
+  Count          = 0;
+  TempDevicePath = RecordedDevicePath;
+  while ((Instance = GetNextDevicePathInstance (&TempDevicePath, &Size)) != NULL) {
+    Handle = NULL;
+    Status = EfiBootManagerConnectDevicePath (Instance, &Handle);
+    if (!EFI_ERROR (Status)) {
+      //
+      // Also start the file system or network stack on the device.
+      //
+      gBS->ConnectController (Handle, NULL, NULL, TRUE);
+    }
+
+    DEBUG ((DEBUG_INFO, "[Bds] Connect recorded device path #%d - %r\n", Count, Status));
+    FreePool (Instance);
+    if (Count++ == 0) {
+      LastBootStatus = Status;
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+  }
+
+  FreePool (RecordedDevicePath);
+
+  if (EFI_ERROR (LastBootStatus)) {
+    EfiBootManagerConnectAll ();
+    return LastBootStatus;
+  }
+
+  EfiBootManagerConnectAllDefaultConsoles ();
+  return EFI_SUCCESS;
+}
+
 /**
   This function will create all handles associate with every device
   path node. If the handle associate with one device path node can not
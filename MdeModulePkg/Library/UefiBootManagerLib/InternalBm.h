@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/PciRootBridgeIo.h>
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/LoadedImage.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/LoadFile.h>
@@ -104,6 +105,13 @@ CHAR16 *
 #define BM_OPTION_NAME_LEN  sizeof ("PlatformRecovery####")
 extern CHAR16  *mBmLoadOptionName[];
 
+//
+// Variable storing the device paths boot options were loaded from, most recent
+// first, under mBmHardDriveBootVariableGuid.
+//
+#define BM_CONNECT_DEVICE_PATH_VARIABLE_NAME  L"BCDP"
+extern EFI_GUID  mBmHardDriveBootVariableGuid;
+
 //
 // Maximum number of reconnect retry to repair controller; it is to limit the
 // number of recursive call of BmRepairAllControllers.
@@ -145,6 +153,25 @@ typedef struct {
   EFI_BOOT_MANAGER_BOOT_DESCRIPTION_HANDLER    Handler;
 } BM_BOOT_DESCRIPTION_ENTRY;
 
+//
+// A boot description built for a controller handle. It is reused as long as
+// the handle still has the same device path and the same media, so that the
+// description handlers don't talk to the device again on every enumeration.
+//
+#define BM_BOOT_DESCRIPTION_CACHE_ENTRY_SIGNATURE  SIGNATURE_32 ('b', 'm', 'd', 'c')
+typedef struct {
+  UINT32                      Signature;
+  LIST_ENTRY                  Link;
+  EFI_HANDLE                  Handle;
+  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  BOOLEAN                     RemovableMedia;
+  BOOLEAN                     MediaPresent;
+  UINT32                      MediaId;
+  UINT32                      BlockSize;
+  EFI_LBA                     LastBlock;
+  CHAR16                      *Description;
+} BM_BOOT_DESCRIPTION_CACHE_ENTRY;
+
 /**
   Repair all the controllers according to the Driver Health status queried.
 
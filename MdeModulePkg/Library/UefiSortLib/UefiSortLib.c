@@ -56,13 +56,21 @@ PerformQuickSort (
   IN       SORT_COMPARE  CompareFunction
   )
 {
-  VOID  *Buffer;
+  UINT64  SmallBuffer[4];
+  VOID    *Buffer;
 
   ASSERT (BufferToSort     != NULL);
   ASSERT (CompareFunction  != NULL);
 
-  Buffer = AllocateZeroPool (ElementSize);
-  ASSERT (Buffer != NULL);
+  //
+  // Most elements are keys or pointers, swap them through the stack.
+  //
+  if (ElementSize <= sizeof (SmallBuffer)) {
+    Buffer = SmallBuffer;
+  } else {
+    Buffer = AllocateZeroPool (ElementSize);
+    ASSERT (Buffer != NULL);
+  }
 
   QuickSort (
     BufferToSort,
@@ -72,7 +80,10 @@ PerformQuickSort (
     Buffer
     );
 
-  FreePool (Buffer);
+  if (Buffer != SmallBuffer) {
+    FreePool (Buffer);
+  }
+
   return;
 }
 
@@ -45,12 +45,18 @@ STATIC  UINT32  mCurrentTableSize  = 0;
 STATIC  UINT32  mCurrentTableUsage = 0;
 STATIC  UINT32  mCurrentTableCount = 0;
 
-#define POLICY_TABLE_STEP_SIZE  0x1000
+// Offsets of the policies in mPolicyTable, sorted by Namespace. Policies that
+// share a Namespace keep their registration order.
+UINT32          *mPolicyIndex     = NULL;
+STATIC  UINT32  mPolicyIndexCount = 0;
+
+#define POLICY_TABLE_STEP_SIZE   0x1000
+#define POLICY_INDEX_STEP_COUNT  0x40
 
 // NOTE: DO NOT USE THESE MACROS on any structure that has not been validated.
 //       Current table data has already been sanitized.
-#define GET_NEXT_POLICY(CurPolicy)  (VARIABLE_POLICY_ENTRY*)((UINT8*)CurPolicy + CurPolicy->Size)
 #define GET_POLICY_NAME(CurPolicy)  (CHAR16*)((UINTN)CurPolicy + CurPolicy->OffsetToName)
+#define GET_INDEXED_POLICY(Index)   (VARIABLE_POLICY_ENTRY*)(mPolicyTable + mPolicyIndex[Index])
 
 #define MATCH_PRIORITY_EXACT  0
 #define MATCH_PRIORITY_MAX    MATCH_PRIORITY_EXACT
@@ -293,9 +299,47 @@ Exit:
 }
 
 /**
-  This helper function walks the current policy table and returns a pointer
-  to the best match, if any are found. Leverages EvaluatePolicyMatch() to
-  determine "best".
+  This helper function finds the first position in mPolicyIndex whose policy
+  Namespace does not sort before (or, if requested, after) VendorGuid.
+
+  @param[in]  VendorGuid    The namespace to look for.
+  @param[in]  After         FALSE to skip the policies sorting before VendorGuid.
+                            TRUE to also skip the policies in VendorGuid.
+
+  @return     The position in mPolicyIndex. mCurrentTableCount if there is none.
+
+**/
+STATIC
+UINT32
+FindPolicyIndex (
+  IN CONST  EFI_GUID  *VendorGuid,
+  IN        BOOLEAN   After
+  )
+{
+  UINT32  Low;
+  UINT32  High;
+  UINT32  Middle;
+  INTN    Order;
+
+  Low  = 0;
+  High = mCurrentTableCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Order  = CompareMem (&(GET_INDEXED_POLICY (Middle))->Namespace, VendorGuid, sizeof (EFI_GUID));
+    if ((Order < 0) || (After && (Order == 0))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  This helper function walks the policies in the namespace of VendorGuid and
+  returns a pointer to the best match, if any are found. Leverages
+  EvaluatePolicyMatch() to determine "best".
 
   @param[in]  VariableName       Same as EFI_SET_VARIABLE.
   @param[in]  VendorGuid         Same as EFI_SET_VARIABLE.
@@ -319,14 +363,19 @@ GetBestPolicyMatch (
   VARIABLE_POLICY_ENTRY  *CurrentEntry;
   UINT8                  MatchPriority;
   UINT8                  CurrentPriority;
-  UINTN                  Index;
+  UINT32                 Index;
 
   BestResult    = NULL;
   MatchPriority = MATCH_PRIORITY_EXACT;
 
-  // Walk all entries in the table, looking for matches.
-  CurrentEntry = (VARIABLE_POLICY_ENTRY *)mPolicyTable;
-  for (Index = 0; Index < mCurrentTableCount; Index++) {
+  // Only the policies in the same namespace can match, and the index keeps
+  // them together in registration order.
+  for (Index = FindPolicyIndex (VendorGuid, FALSE); Index < mCurrentTableCount; Index++) {
+    CurrentEntry = GET_INDEXED_POLICY (Index);
+    if (!CompareGuid (&CurrentEntry->Namespace, VendorGuid)) {
+      break;
+    }
+
     // Check for a match.
     if (EvaluatePolicyMatch (CurrentEntry, VariableName, VendorGuid, &CurrentPriority)) {
       // If match is better, take it.
@@ -340,9 +389,6 @@ GetBestPolicyMatch (
         break;
       }
     }
-
-    // If we're still in the loop, move to the next entry.
-    CurrentEntry = GET_NEXT_POLICY (CurrentEntry);
   }
 
   // If a return priority was requested, return it.
@@ -380,6 +426,8 @@ RegisterVariablePolicy (
   UINT8                  MatchPriority;
   UINT32                 NewSize;
   UINT8                  *NewTable;
+  UINT32                 *NewIndex;
+  UINT32                 Position;
 
   if (!IsVariablePolicyLibInitialized ()) {
     return EFI_NOT_READY;
@@ -404,6 +452,22 @@ RegisterVariablePolicy (
   }
 
   // If none exists, create it.
+  // If we need more index entries, allocate those first.
+  if (mCurrentTableCount == mPolicyIndexCount) {
+    NewIndex = AllocateRuntimePool ((mPolicyIndexCount + POLICY_INDEX_STEP_COUNT) * sizeof (UINT32));
+    if (NewIndex == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CopyMem (NewIndex, mPolicyIndex, mCurrentTableCount * sizeof (UINT32));
+    mPolicyIndexCount += POLICY_INDEX_STEP_COUNT;
+    if (mPolicyIndex != NULL) {
+      FreePool (mPolicyIndex);
+    }
+
+    mPolicyIndex = NewIndex;
+  }
+
   // If we need more space, allocate that now.
   Status = SafeUint32Add (mCurrentTableUsage, NewPolicy->Size, &NewSize);
   if (EFI_ERROR (Status)) {
@@ -436,9 +500,17 @@ RegisterVariablePolicy (
     mPolicyTable = NewTable;
   }
 
-  // Copy the policy into the table.
+  // Copy the policy into the table, and index it after the other policies
+  // in its namespace.
   CopyMem (mPolicyTable + mCurrentTableUsage, NewPolicy, NewPolicy->Size);
-  mCurrentTableUsage += NewPolicy->Size;
+  Position = FindPolicyIndex (&NewPolicy->Namespace, TRUE);
+  CopyMem (
+    &mPolicyIndex[Position + 1],
+    &mPolicyIndex[Position],
+    (mCurrentTableCount - Position) * sizeof (UINT32)
+    );
+  mPolicyIndex[Position] = mCurrentTableUsage;
+  mCurrentTableUsage    += NewPolicy->Size;
   mCurrentTableCount += 1;
 
   // We're done here.
@@ -797,6 +869,8 @@ InitVariablePolicyLib (
     mCurrentTableSize   = 0;
     mCurrentTableUsage  = 0;
     mCurrentTableCount  = 0;
+    mPolicyIndex        = NULL;
+    mPolicyIndexCount   = 0;
   }
 
   return Status;
@@ -852,11 +926,17 @@ DeinitVariablePolicyLib (
     mCurrentTableSize   = 0;
     mCurrentTableUsage  = 0;
     mCurrentTableCount  = 0;
+    mPolicyIndexCount   = 0;
 
     if (mPolicyTable != NULL) {
       FreePool (mPolicyTable);
       mPolicyTable = NULL;
     }
+
+    if (mPolicyIndex != NULL) {
+      FreePool (mPolicyIndex);
+      mPolicyIndex = NULL;
+    }
   }
 
   return Status;
@@ -0,0 +1,36 @@
+/** @file
+  Zstandard decompression without MP services: the BSP decodes all the frames.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <ZstdDecompressLibInternal.h>
+
+/**
+  Get the number of enabled processors.
+
+  @return  1, the frames are decoded on the BSP only.
+**/
+UINTN
+ZstdGetProcessorCount (
+  VOID
+  )
+{
+  return 1;
+}
+
+/**
+  Run a procedure on the BSP.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+ZstdStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  Procedure (Argument);
+}
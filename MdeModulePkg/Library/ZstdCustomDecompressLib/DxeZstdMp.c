@@ -0,0 +1,92 @@
+/** @file
+  Zstandard decompression functions for DXE, over EFI_MP_SERVICES_PROTOCOL.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <ZstdDecompressLibInternal.h>
+#include <Protocol/MpService.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+ZstdGetProcessorCount (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  return NumberOfEnabledProcessors;
+}
+
+/**
+  Run a procedure on the BSP and all the enabled APs, and wait for them.
+
+  The APs are started in non-blocking mode, so that the BSP runs the
+  procedure at the same time.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+ZstdStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  EFI_EVENT                 WaitEvent;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    Procedure (Argument);
+    return;
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &WaitEvent);
+  if (EFI_ERROR (Status)) {
+    //
+    // Without the event, StartupAllAPs() blocks until the APs are done, and
+    // the BSP only finds the remaining frames, if any, afterwards.
+    //
+    WaitEvent = NULL;
+  }
+
+  Status = MpServices->StartupAllAPs (MpServices, Procedure, FALSE, WaitEvent, 0, Argument, NULL);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_STARTED)) {
+    DEBUG ((DEBUG_WARN, "%a: APs not started - %r\n", __FUNCTION__, Status));
+  }
+
+  Procedure (Argument);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      while (gBS->CheckEvent (WaitEvent) == EFI_NOT_READY) {
+        CpuPause ();
+      }
+    }
+
+    gBS->CloseEvent (WaitEvent);
+  }
+}
@@ -0,0 +1,82 @@
+/** @file
+  Zstandard decompression functions for PEI, over EFI_PEI_MP_SERVICES_PPI.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <ZstdDecompressLibInternal.h>
+#include <Ppi/MpServices.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+ZstdGetProcessorCount (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         GetPeiServicesTablePointer (),
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  return NumberOfEnabledProcessors;
+}
+
+/**
+  Run a procedure on the enabled APs, then on the BSP.
+
+  StartupAllAPs() of the PPI only runs in blocking mode, so the BSP picks up
+  what the APs left once they are done.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+ZstdStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->StartupAllAPs (
+                           GetPeiServicesTablePointer (),
+                           MpServices,
+                           Procedure,
+                           FALSE,
+                           0,
+                           Argument
+                           );
+  }
+
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_STARTED)) {
+    DEBUG ((DEBUG_WARN, "%a: APs not started - %r\n", __FUNCTION__, Status));
+  }
+
+  Procedure (Argument);
+}
@@ -0,0 +1,101 @@
+/** @file
+  Implements for functions declared in ZstdDecUefiSupport.h
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <ZstdDecUefiSupport.h>
+
+/**
+  Dummy malloc function for compiler.
+
+  The decompression contexts are laid out in the scratch buffer with
+  ZSTD_initStaticDCtx(), so zstd never allocates memory.
+**/
+VOID *
+ZstdDummyMalloc (
+  IN size_t  Size
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Dummy calloc function for compiler.
+**/
+VOID *
+ZstdDummyCalloc (
+  IN size_t  Count,
+  IN size_t  Size
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Dummy free function for compiler.
+**/
+VOID
+ZstdDummyFree (
+  IN VOID  *Ptr
+  )
+{
+  ASSERT (FALSE);
+}
+
+#if defined (__GNUC__) || defined (__clang__)
+
+//
+// zstd copies and clears memory with the compiler builtins, which GCC turns
+// into calls to the C library routines when the size is not constant. They
+// are weak so that a module also linking IntrinsicLib keeps its copies.
+//
+#undef memcpy
+#undef memmove
+#undef memset
+
+/**
+  Copy a buffer for the compiler builtin.
+**/
+__attribute__ ((__weak__))
+VOID *
+memcpy (
+  OUT VOID        *Dest,
+  IN  CONST VOID  *Src,
+  IN  size_t      Count
+  )
+{
+  return CopyMem (Dest, Src, Count);
+}
+
+/**
+  Copy an overlapping buffer for the compiler builtin.
+**/
+__attribute__ ((__weak__))
+VOID *
+memmove (
+  OUT VOID        *Dest,
+  IN  CONST VOID  *Src,
+  IN  size_t      Count
+  )
+{
+  return CopyMem (Dest, Src, Count);
+}
+
+/**
+  Fill a buffer for the compiler builtin.
+**/
+__attribute__ ((__weak__))
+VOID *
+memset (
+  OUT VOID    *Dest,
+  IN  INT32   Char,
+  IN  size_t  Count
+  )
+{
+  return SetMem (Dest, Count, (UINT8)Char);
+}
+
+#endif
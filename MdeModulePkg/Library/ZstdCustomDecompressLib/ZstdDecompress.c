@@ -0,0 +1,299 @@
+/** @file
+  Zstandard Decompress interfaces
+
+  The compressed data is a sequence of zstd frames. Each frame records the
+  size of its decompressed data and decodes independently of the other ones,
+  so the frames are decoded on all the processors at the same time.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <ZstdDecompressLibInternal.h>
+
+/**
+  Walk the frames of a Zstandard compressed source buffer.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  Frames          The array receiving the frames, or NULL to count
+                          them only.
+  @param  FrameCount      Returns the number of frames.
+  @param  DestinationSize Returns the size of the decompressed data.
+
+  @retval EFI_SUCCESS           The frames were walked.
+  @retval EFI_INVALID_PARAMETER The source buffer is not a sequence of frames
+                                with known decompressed sizes, or the
+                                decompressed data is larger than 4GB.
+**/
+EFI_STATUS
+ZstdParseFrames (
+  IN  CONST UINT8  *Source,
+  IN  UINTN        SourceSize,
+  OUT ZSTD_FRAME   *Frames  OPTIONAL,
+  OUT UINT32       *FrameCount,
+  OUT UINT32       *DestinationSize
+  )
+{
+  size_t              FrameSize;
+  unsigned long long  ContentSize;
+  UINT64              TotalSize;
+  UINT32              Count;
+
+  Count     = 0;
+  TotalSize = 0;
+  while (SourceSize > 0) {
+    FrameSize   = ZSTD_findFrameCompressedSize (Source, SourceSize);
+    ContentSize = ZSTD_getFrameContentSize (Source, SourceSize);
+    if (ZSTD_isError (FrameSize) ||
+        (ContentSize == ZSTD_CONTENTSIZE_UNKNOWN) ||
+        (ContentSize == ZSTD_CONTENTSIZE_ERROR) ||
+        (ContentSize > MAX_UINT32 - TotalSize))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (Frames != NULL) {
+      Frames[Count].Source            = Source;
+      Frames[Count].SourceSize        = FrameSize;
+      Frames[Count].DestinationOffset = (UINTN)TotalSize;
+      Frames[Count].DestinationSize   = (UINTN)ContentSize;
+      Frames[Count].Decoded           = FALSE;
+    }
+
+    Source     += FrameSize;
+    SourceSize -= FrameSize;
+    TotalSize  += ContentSize;
+    Count++;
+  }
+
+  if (Count == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *FrameCount      = Count;
+  *DestinationSize = (UINT32)TotalSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the number of decompression contexts used to decode a number of frames.
+
+  @param  FrameCount      The number of frames.
+
+  @return The number of decompression contexts.
+**/
+UINT32
+ZstdGetContextCount (
+  IN UINT32  FrameCount
+  )
+{
+  UINTN  Count;
+
+  Count = MIN (ZstdGetProcessorCount (), ZSTD_DECODE_MAX_CONTEXTS);
+  return (UINT32)MAX (MIN (Count, FrameCount), 1);
+}
+
+/**
+  Decode one frame into its place in the destination buffer.
+
+  @param  Dctx            The decompression context.
+  @param  Destination     The destination buffer of all the frames.
+  @param  Frame           The frame to decode.
+**/
+VOID
+ZstdDecodeFrame (
+  IN     ZSTD_DCtx   *Dctx,
+  IN     UINT8       *Destination,
+  IN OUT ZSTD_FRAME  *Frame
+  )
+{
+  size_t  Result;
+
+  Result = ZSTD_decompressDCtx (
+             Dctx,
+             Destination + Frame->DestinationOffset,
+             Frame->DestinationSize,
+             Frame->Source,
+             Frame->SourceSize
+             );
+  Frame->Decoded = (BOOLEAN)(!ZSTD_isError (Result) && (Result == Frame->DestinationSize));
+}
+
+/**
+  Decode frames of a job until none is left.
+
+  This runs on the BSP and the APs at the same time. Each processor takes a
+  decompression context of its own, then the next frame nobody took yet. A
+  processor finding no free context returns right away.
+
+  @param  Buffer          The ZSTD_DECODE_JOB instance.
+**/
+VOID
+EFIAPI
+ZstdDecodeFrames (
+  IN OUT VOID  *Buffer
+  )
+{
+  ZSTD_DECODE_JOB  *Job;
+  ZSTD_DCtx        *Dctx;
+  UINT32           Context;
+  UINT32           Index;
+
+  Job     = (ZSTD_DECODE_JOB *)Buffer;
+  Context = InterlockedIncrement (&Job->NextContext) - 1;
+  if (Context >= Job->ContextCount) {
+    return;
+  }
+
+  Dctx = ZSTD_initStaticDCtx (Job->Contexts + Context * Job->ContextSize, Job->ContextSize);
+  if (Dctx == NULL) {
+    return;
+  }
+
+  for (Index = InterlockedIncrement (&Job->NextFrame) - 1;
+       Index < Job->FrameCount;
+       Index = InterlockedIncrement (&Job->NextFrame) - 1)
+  {
+    ZstdDecodeFrame (Dctx, Job->Destination, &Job->Frames[Index]);
+  }
+}
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the size of
+  the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  Retrieves the size of the uncompressed buffer and the temporary scratch buffer
+  required to decompress the buffer specified by Source and SourceSize.
+  The size of the uncompressed buffer is the sum of the decompressed sizes
+  recorded in the frame headers. The scratch buffer holds the frame table and
+  one decompression context per processor decoding the frames.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval EFI_SUCCESS     The size of the uncompressed data was returned
+                          in DestinationSize and the size of the scratch
+                          buffer was returned in ScratchSize.
+  @retval EFI_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+EFI_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      FrameCount;
+  UINTN       Size;
+
+  Status = ZstdParseFrames (Source, SourceSize, NULL, &FrameCount, DestinationSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Size = ALIGN_VALUE (FrameCount * sizeof (ZSTD_FRAME), sizeof (UINT64)) +
+         ZstdGetContextCount (FrameCount) * ALIGN_VALUE (ZSTD_estimateDCtxSize (), sizeof (UINT64));
+  if (Size > MAX_UINT32) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *ScratchSize = (UINT32)Size;
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  The frames are decoded on the BSP and the enabled APs. A frame an AP could
+  not decode is decoded again on the BSP before failing.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
+                      It must be the size returned by ZstdUefiDecompressGetInfo(), and
+                      aligned on 8 bytes.
+
+  @retval EFI_SUCCESS Decompression completed successfully, and
+                      the uncompressed buffer is returned in Destination.
+  @retval EFI_INVALID_PARAMETER
+                      The source buffer specified by Source is corrupted
+                      (not in a valid compressed format).
+**/
+EFI_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  EFI_STATUS       Status;
+  ZSTD_DECODE_JOB  Job;
+  ZSTD_DCtx        *Dctx;
+  UINT32           DestinationSize;
+  UINT32           Index;
+
+  ASSERT (Scratch != NULL);
+
+  ZeroMem (&Job, sizeof (Job));
+  Job.Frames = (ZSTD_FRAME *)Scratch;
+  Status     = ZstdParseFrames (Source, SourceSize, Job.Frames, &Job.FrameCount, &DestinationSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Job.Destination  = (UINT8 *)Destination;
+  Job.Contexts     = (UINT8 *)Scratch + ALIGN_VALUE (Job.FrameCount * sizeof (ZSTD_FRAME), sizeof (UINT64));
+  Job.ContextSize  = ALIGN_VALUE (ZSTD_estimateDCtxSize (), sizeof (UINT64));
+  Job.ContextCount = ZstdGetContextCount (Job.FrameCount);
+
+  if (Job.ContextCount > 1) {
+    ZstdStartupAllCpus (ZstdDecodeFrames, &Job);
+  }
+
+  //
+  // Decode on the BSP whatever is left: all the frames without other
+  // processors, and the frames an AP failed to decode.
+  //
+  Dctx = NULL;
+  for (Index = 0; Index < Job.FrameCount; Index++) {
+    if (Job.Frames[Index].Decoded) {
+      continue;
+    }
+
+    if (Dctx == NULL) {
+      Dctx = ZSTD_initStaticDCtx (Job.Contexts, Job.ContextSize);
+      if (Dctx == NULL) {
+        return EFI_INVALID_PARAMETER;
+      }
+    }
+
+    ZstdDecodeFrame (Dctx, Job.Destination, &Job.Frames[Index]);
+    if (!Job.Frames[Index].Decoded) {
+      DEBUG ((DEBUG_ERROR, "%a: Frame %d is corrupted\n", __FUNCTION__, Index));
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
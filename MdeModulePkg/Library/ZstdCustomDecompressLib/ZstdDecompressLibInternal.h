@@ -0,0 +1,98 @@
+/** @file
+  ZSTD UEFI header file
+
+  Allows ZSTD code to build under UEFI (edk2) build environment
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_INTERNAL_H__
+#define __ZSTD_DECOMPRESS_INTERNAL_H__
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd/lib/zstd.h>
+
+//
+// Most decompression contexts, hence processors, decoding the frames of one
+// section at the same time.
+//
+#define ZSTD_DECODE_MAX_CONTEXTS  16
+
+//
+// A frame of the compressed data. The frames are independent of one
+// another, and can be decoded in any order.
+//
+typedef struct {
+  CONST UINT8    *Source;
+  UINTN          SourceSize;
+  UINTN          DestinationOffset;
+  UINTN          DestinationSize;
+  BOOLEAN        Decoded;
+} ZSTD_FRAME;
+
+//
+// The frames of one section, shared by all the processors decoding them.
+//
+typedef struct {
+  ZSTD_FRAME         *Frames;
+  UINT32             FrameCount;
+  volatile UINT32    NextFrame;
+  UINT8              *Destination;
+  UINT8              *Contexts;
+  UINTN              ContextSize;
+  UINT32             ContextCount;
+  volatile UINT32    NextContext;
+} ZSTD_DECODE_JOB;
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+ZstdGetProcessorCount (
+  VOID
+  );
+
+/**
+  Run a procedure on the BSP and all the enabled APs, and wait for them.
+
+  Without MP services, the procedure runs on the BSP alone.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+ZstdStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  );
+
+EFI_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+EFI_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+#endif
@@ -0,0 +1,8 @@
+/** @file
+  Include file to support building the third-party zstd.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <ZstdDecUefiSupport.h>
@@ -14,6 +14,7 @@
 #include <Protocol/AcpiTable.h>
 #include <Guid/Acpi.h>
 #include <Protocol/AcpiSystemDescriptionTable.h>
+#include <Protocol/AcpiTableBatch.h>
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
@@ -114,6 +115,8 @@ typedef struct {
   EFI_ACPI_TABLE_PROTOCOL                         AcpiTableProtocol;
   EFI_ACPI_SDT_PROTOCOL                           AcpiSdtProtocol;
   LIST_ENTRY                                      NotifyList;
+  EDKII_ACPI_TABLE_BATCH_PROTOCOL                 AcpiTableBatchProtocol;
+  BOOLEAN                                         InBatch;               // Defer the common table checksums to PublishTables()
 } EFI_ACPI_TABLE_INSTANCE;
 
 //
@@ -126,6 +129,16 @@ typedef struct {
       EFI_ACPI_TABLE_SIGNATURE \
       )
 
+//
+// ACPI table batch protocol instance containing record macro
+//
+#define EFI_ACPI_TABLE_INSTANCE_FROM_BATCH(a) \
+  CR (a, \
+      EFI_ACPI_TABLE_INSTANCE, \
+      AcpiTableBatchProtocol, \
+      EFI_ACPI_TABLE_SIGNATURE \
+      )
+
 //
 // Protocol Constructor functions
 //
@@ -269,6 +269,132 @@ InstallAcpiTable (
   return Status;
 }
 
+/**
+  Install a batch of ACPI tables into the RSDT/XSDT.
+
+  Every entry is checked first; if any of them is not a valid InstallAcpiTable()
+  request, no table is installed. The tables are then installed in order, and
+  the status and key of each one are returned in its entry. A failure does not
+  stop the tables that follow it from being installed. The tables that were
+  installed are published once, after the last entry.
+
+  @param[in]      This          The EDKII_ACPI_TABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The tables to install.
+
+  @retval EFI_SUCCESS           All the tables were installed.
+  @retval EFI_INVALID_PARAMETER This or Entries is NULL, or an entry has a NULL
+                                AcpiTableBuffer or an AcpiTableBufferSize which is
+                                not in sync with the size field embedded in the
+                                table. No table was installed.
+  @return Others                The status of the first entry that failed.
+**/
+EFI_STATUS
+EFIAPI
+InstallAcpiTables (
+  IN CONST EDKII_ACPI_TABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                            EntryCount,
+  IN OUT   EDKII_ACPI_TABLE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_ACPI_TABLE_INSTANCE  *AcpiTableInstance;
+  EFI_STATUS               Status;
+  EFI_STATUS               PublishStatus;
+  VOID                     *AcpiTableBufferConst;
+  EFI_ACPI_TABLE_VERSION   Version;
+  UINTN                    Index;
+  UINTN                    NumInstalled;
+
+  if ((This == NULL) || ((Entries == NULL) && (EntryCount != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (  (Entries[Index].AcpiTableBuffer == NULL)
+       || (((EFI_ACPI_DESCRIPTION_HEADER *)Entries[Index].AcpiTableBuffer)->Length != Entries[Index].AcpiTableBufferSize))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Version           = PcdGet32 (PcdAcpiExposedTableVersions);
+  AcpiTableInstance = EFI_ACPI_TABLE_INSTANCE_FROM_BATCH (This);
+
+  //
+  // Add all the tables to the list first, so that the RSDT/XSDT and the
+  // common tables are checksummed and published only once.
+  //
+  Status                     = EFI_SUCCESS;
+  NumInstalled               = 0;
+  AcpiTableInstance->InBatch = TRUE;
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entries[Index].TableKey = 0;
+    AcpiTableBufferConst    = AllocateCopyPool (
+                                Entries[Index].AcpiTableBufferSize,
+                                Entries[Index].AcpiTableBuffer
+                                );
+    if (AcpiTableBufferConst == NULL) {
+      Entries[Index].Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      Entries[Index].Status = AddTableToList (
+                                AcpiTableInstance,
+                                AcpiTableBufferConst,
+                                TRUE,
+                                Version,
+                                FALSE,
+                                &Entries[Index].TableKey
+                                );
+      FreePool (AcpiTableBufferConst);
+    }
+
+    if (EFI_ERROR (Entries[Index].Status)) {
+      if (!EFI_ERROR (Status)) {
+        Status = Entries[Index].Status;
+      }
+    } else {
+      NumInstalled++;
+    }
+  }
+
+  AcpiTableInstance->InBatch = FALSE;
+
+  if (NumInstalled == 0) {
+    return Status;
+  }
+
+  PublishStatus = PublishTables (AcpiTableInstance, Version);
+  if (EFI_ERROR (PublishStatus)) {
+    //
+    // The tables are in the list but could not be published; report the
+    // failure on each of them, as InstallAcpiTable() would.
+    //
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (!EFI_ERROR (Entries[Index].Status)) {
+        Entries[Index].Status = PublishStatus;
+      }
+    }
+
+    return PublishStatus;
+  }
+
+  //
+  // Add new tables successfully, notify registed callback
+  //
+  if (FeaturePcdGet (PcdInstallAcpiSdtProtocol)) {
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (!EFI_ERROR (Entries[Index].Status)) {
+        SdtNotifyAcpiList (
+          AcpiTableInstance,
+          Version,
+          Entries[Index].TableKey
+          );
+      }
+    }
+  }
+
+  return Status;
+}
+
 /**
   Removes an ACPI table from the RSDT/XSDT.
 
@@ -1133,7 +1259,13 @@ AddTableToList (
     }
   }
 
-  ChecksumCommonTables (AcpiTableInstance);
+  //
+  // PublishTables() checksums the common tables once for the whole batch.
+  //
+  if (!AcpiTableInstance->InBatch) {
+    ChecksumCommonTables (AcpiTableInstance);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -1966,6 +2098,8 @@ AcpiTableAcpiTableConstructor (
   AcpiTableInstance->AcpiTableProtocol.InstallAcpiTable   = InstallAcpiTable;
   AcpiTableInstance->AcpiTableProtocol.UninstallAcpiTable = UninstallAcpiTable;
 
+  AcpiTableInstance->AcpiTableBatchProtocol.InstallAcpiTables = InstallAcpiTables;
+
   if (FeaturePcdGet (PcdInstallAcpiSdtProtocol)) {
     SdtAcpiTableAcpiSdtConstructor (AcpiTableInstance);
   }
@@ -4644,6 +4644,9 @@ ConSplitterTextOutOutputString (
 
   //
   // return the worst status met
+  // The string is written to every device before returning, rather than queued per device:
+  // callers read the cursor position from Mode right after OutputString(), and queued output
+  // would be lost on a reset or ExitBootServices(), or stall while the TPL is raised.
   //
   for (Index = 0, ReturnStatus = EFI_SUCCESS; Index < Private->CurrentNumberOfConsoles; Index++) {
     Status = Private->TextOutList[Index].TextOut->OutputString (
@@ -36,7 +36,15 @@ GRAPHICS_CONSOLE_DEV  mGraphicsConsoleDevTemplate = {
     FALSE
   },
   (GRAPHICS_CONSOLE_MODE_DATA *)NULL,
-  (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)NULL
+  (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)NULL,
+  (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)NULL,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  FALSE
 };
 
 GRAPHICS_CONSOLE_MODE_DATA  mGraphicsConsoleModeData[] = {
@@ -53,6 +61,8 @@ EFI_HII_FONT_PROTOCOL      *mHiiFont;
 EFI_HII_HANDLE             mHiiHandle;
 VOID                       *mHiiRegistration;
 
+GRAPHICS_CONSOLE_GLYPH  *mGlyphCache = NULL;
+
 EFI_GUID  mFontPackageListGuid = {
   0xf5f219d3, 0x7006, 0x4648, { 0xac, 0x8d, 0xd6, 0x1d, 0xfb, 0x7b, 0xc6, 0xad }
 };
@@ -657,6 +667,10 @@ Error:
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -745,6 +759,10 @@ GraphicsConsoleControllerDriverStop (
       FreePool (Private->LineBuffer);
     }
 
+    if (Private->ShadowBuffer != NULL) {
+      FreePool (Private->ShadowBuffer);
+    }
+
     if (Private->ModeData != NULL) {
       FreePool (Private->ModeData);
     }
@@ -947,6 +965,8 @@ GraphicsConsoleConOutOutputString (
   UINTN                          Index;
   INT32                          OriginAttribute;
   EFI_TPL                        OldTpl;
+  BOOLEAN                        DeferFlush;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *ShadowRow;
 
   if (This->Mode->Mode == -1) {
     //
@@ -966,6 +986,12 @@ GraphicsConsoleConOutOutputString (
   GraphicsOutput = Private->GraphicsOutput;
   UgaDraw        = Private->UgaDraw;
 
+  //
+  // The nested OutputString() calls below leave the screen update to this one.
+  //
+  DeferFlush          = Private->DeferFlush;
+  Private->DeferFlush = TRUE;
+
   MaxColumn = Private->ModeData[Mode].Columns;
   MaxRow    = Private->ModeData[Mode].Rows;
   DeltaX    = (UINTN)Private->ModeData[Mode].DeltaX;
@@ -1020,7 +1046,24 @@ GraphicsConsoleConOutOutputString (
       // down one row.
       //
       if (This->Mode->CursorRow == (INT32)(MaxRow - 1)) {
-        if (GraphicsOutput != NULL) {
+        if (Private->ShadowBuffer != NULL) {
+          //
+          // Scroll the shadow buffer up one row and blank its last line. The
+          // screen is updated once when the whole string has been processed.
+          //
+          CopyMem (
+            Private->ShadowBuffer,
+            Private->ShadowBuffer + Private->ShadowWidth * EFI_GLYPH_HEIGHT,
+            Private->ShadowWidth * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+            );
+          ShadowRow = Private->ShadowBuffer + Private->ShadowWidth * Height;
+          SetMem32 (
+            ShadowRow,
+            Private->ShadowWidth * EFI_GLYPH_HEIGHT * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+            ((EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *)&Background)->Raw
+            );
+          MarkShadowBufferDirty (Private, 0, 0, Private->ShadowWidth, Private->ShadowHeight);
+        } else if (GraphicsOutput != NULL) {
           //
           // Scroll Screen Up One Row
           //
@@ -1174,6 +1217,9 @@ GraphicsConsoleConOutOutputString (
 
   FlushCursor (This);
 
+  Private->DeferFlush = DeferFlush;
+  FlushShadowBuffer (Private);
+
   if (Warning) {
     Status = EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -1471,6 +1517,29 @@ GraphicsConsoleConOutSetMode (
   //
   This->Mode->Mode = (INT32)ModeNumber;
 
+  //
+  // The display has been cleared, so start the shadow buffer of the new text
+  // area cleared as well. If it can't be allocated, draw on the screen directly.
+  //
+  if (Private->ShadowBuffer != NULL) {
+    FreePool (Private->ShadowBuffer);
+    Private->ShadowBuffer = NULL;
+  }
+
+  Private->DirtyRight = 0;
+  if (FeaturePcdGet (PcdGraphicsConsoleShadowBuffer)) {
+    Private->ShadowWidth  = ModeData->Columns * EFI_GLYPH_WIDTH;
+    Private->ShadowHeight = ModeData->Rows * EFI_GLYPH_HEIGHT;
+    Private->ShadowBuffer = AllocatePool (Private->ShadowWidth * Private->ShadowHeight * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+    if (Private->ShadowBuffer != NULL) {
+      SetMem32 (
+        Private->ShadowBuffer,
+        Private->ShadowWidth * Private->ShadowHeight * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+        ((EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *)&mGraphicsEfiColors[0])->Raw
+        );
+    }
+  }
+
   //
   // Move the text cursor to the upper left hand corner of the display and flush it
   //
@@ -1478,6 +1547,7 @@ GraphicsConsoleConOutSetMode (
   This->Mode->CursorRow    = 0;
 
   FlushCursor (This);
+  FlushShadowBuffer (Private);
 
   Status = EFI_SUCCESS;
 
@@ -1526,6 +1596,7 @@ GraphicsConsoleConOutSetAttribute (
   This->Mode->Attribute = (INT32)Attribute;
 
   FlushCursor (This);
+  FlushShadowBuffer (GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This));
 
   gBS->RestoreTPL (OldTpl);
 
@@ -1605,10 +1676,23 @@ GraphicsConsoleConOutClearScreen (
     Status = EFI_UNSUPPORTED;
   }
 
+  //
+  // The whole display has been filled, so nothing of the shadow buffer is pending.
+  //
+  if (Private->ShadowBuffer != NULL) {
+    SetMem32 (
+      Private->ShadowBuffer,
+      Private->ShadowWidth * Private->ShadowHeight * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL),
+      ((EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *)&Background)->Raw
+      );
+    Private->DirtyRight = 0;
+  }
+
   This->Mode->CursorColumn = 0;
   This->Mode->CursorRow    = 0;
 
   FlushCursor (This);
+  FlushShadowBuffer (Private);
 
   gBS->RestoreTPL (OldTpl);
 
@@ -1677,6 +1761,7 @@ GraphicsConsoleConOutSetCursorPosition (
   This->Mode->CursorRow    = (INT32)Row;
 
   FlushCursor (This);
+  FlushShadowBuffer (Private);
 
 Done:
   gBS->RestoreTPL (OldTpl);
@@ -1721,6 +1806,7 @@ GraphicsConsoleConOutEnableCursor (
   This->Mode->CursorVisible = Visible;
 
   FlushCursor (This);
+  FlushShadowBuffer (GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This));
 
   gBS->RestoreTPL (OldTpl);
   return EFI_SUCCESS;
@@ -1753,6 +1839,298 @@ GetTextColors (
   return EFI_SUCCESS;
 }
 
+/**
+  Add a rectangle of the text area to the dirty rectangle of the shadow buffer.
+
+  @param  Private               Graphics Console device private data.
+  @param  X                     Left edge of the rectangle in the text area.
+  @param  Y                     Top edge of the rectangle in the text area.
+  @param  Width                 Width of the rectangle.
+  @param  Height                Height of the rectangle.
+
+**/
+VOID
+MarkShadowBufferDirty (
+  IN  GRAPHICS_CONSOLE_DEV  *Private,
+  IN  UINTN                 X,
+  IN  UINTN                 Y,
+  IN  UINTN                 Width,
+  IN  UINTN                 Height
+  )
+{
+  if ((Width == 0) || (Height == 0)) {
+    return;
+  }
+
+  Width  = MIN (Width, Private->ShadowWidth - X);
+  Height = MIN (Height, Private->ShadowHeight - Y);
+
+  if (Private->DirtyRight == 0) {
+    Private->DirtyLeft   = X;
+    Private->DirtyTop    = Y;
+    Private->DirtyRight  = X + Width;
+    Private->DirtyBottom = Y + Height;
+    return;
+  }
+
+  Private->DirtyLeft   = MIN (Private->DirtyLeft, X);
+  Private->DirtyTop    = MIN (Private->DirtyTop, Y);
+  Private->DirtyRight  = MAX (Private->DirtyRight, X + Width);
+  Private->DirtyBottom = MAX (Private->DirtyBottom, Y + Height);
+}
+
+/**
+  Copy the dirty rectangle of the shadow buffer to the screen with one Blt.
+
+  Nothing is done when there is no shadow buffer, when the dirty rectangle is
+  empty, or while an outer OutputString() call defers the copy.
+
+  @param  Private               Graphics Console device private data.
+
+  @retval EFI_SUCCESS           The screen is up to date.
+  @return Others                The status returned by Blt().
+
+**/
+EFI_STATUS
+FlushShadowBuffer (
+  IN  GRAPHICS_CONSOLE_DEV  *Private
+  )
+{
+  EFI_STATUS                  Status;
+  GRAPHICS_CONSOLE_MODE_DATA  *ModeData;
+
+  if ((Private->ShadowBuffer == NULL) || (Private->DirtyRight == 0) || Private->DeferFlush) {
+    return EFI_SUCCESS;
+  }
+
+  ModeData = &Private->ModeData[Private->SimpleTextOutputMode.Mode];
+  if (Private->GraphicsOutput != NULL) {
+    Status = Private->GraphicsOutput->Blt (
+                                        Private->GraphicsOutput,
+                                        Private->ShadowBuffer,
+                                        EfiBltBufferToVideo,
+                                        Private->DirtyLeft,
+                                        Private->DirtyTop,
+                                        ModeData->DeltaX + Private->DirtyLeft,
+                                        ModeData->DeltaY + Private->DirtyTop,
+                                        Private->DirtyRight - Private->DirtyLeft,
+                                        Private->DirtyBottom - Private->DirtyTop,
+                                        Private->ShadowWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                                        );
+  } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+    Status = Private->UgaDraw->Blt (
+                                 Private->UgaDraw,
+                                 (EFI_UGA_PIXEL *)Private->ShadowBuffer,
+                                 EfiUgaBltBufferToVideo,
+                                 Private->DirtyLeft,
+                                 Private->DirtyTop,
+                                 ModeData->DeltaX + Private->DirtyLeft,
+                                 ModeData->DeltaY + Private->DirtyTop,
+                                 Private->DirtyRight - Private->DirtyLeft,
+                                 Private->DirtyBottom - Private->DirtyTop,
+                                 Private->ShadowWidth * sizeof (EFI_UGA_PIXEL)
+                                 );
+  } else {
+    Status = EFI_UNSUPPORTED;
+  }
+
+  Private->DirtyRight = 0;
+
+  return Status;
+}
+
+/**
+  Get the rendered cell of a narrow character in the current text colors.
+
+  The cell is rendered by the HII Font protocol the first time it is needed
+  and kept in a direct mapped cache, so printing the same characters again
+  does not look up their glyph in the font database again.
+
+  @param  This                  Protocol instance pointer.
+  @param  Char                  The character to render.
+
+  @return The cached cell, or NULL when the character has no narrow glyph or
+          there is no memory for the cache.
+
+**/
+GRAPHICS_CONSOLE_GLYPH *
+GetCachedGlyph (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This,
+  IN  CHAR16                           Char
+  )
+{
+  EFI_STATUS                     Status;
+  GRAPHICS_CONSOLE_GLYPH         *Glyph;
+  UINT8                          Attribute;
+  CHAR16                         String[2];
+  EFI_FONT_DISPLAY_INFO          FontInfo;
+  EFI_IMAGE_OUTPUT               Image;
+  EFI_IMAGE_OUTPUT               *ImagePtr;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Bitmap[EFI_GLYPH_HEIGHT][EFI_GLYPH_WIDTH * 2];
+  EFI_HII_ROW_INFO               *RowInfoArray;
+  UINTN                          RowInfoArraySize;
+  UINTN                          PosY;
+
+  if (mGlyphCache == NULL) {
+    mGlyphCache = AllocateZeroPool (GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE * sizeof (GRAPHICS_CONSOLE_GLYPH));
+    if (mGlyphCache == NULL) {
+      return NULL;
+    }
+  }
+
+  Attribute = (UINT8)(This->Mode->Attribute & 0x7F);
+  Glyph     = &mGlyphCache[(Char ^ ((UINTN)Attribute << 3)) % GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE];
+  if (Glyph->Valid && (Glyph->Char == Char) && (Glyph->Attribute == Attribute)) {
+    return Glyph;
+  }
+
+  String[0] = Char;
+  String[1] = L'\0';
+
+  ZeroMem (&FontInfo, sizeof (FontInfo));
+  GetTextColors (This, &FontInfo.ForegroundColor, &FontInfo.BackgroundColor);
+
+  //
+  // Leave room for a wide glyph, so that it is detected rather than clipped.
+  //
+  Image.Width        = EFI_GLYPH_WIDTH * 2;
+  Image.Height       = EFI_GLYPH_HEIGHT;
+  Image.Image.Bitmap = &Bitmap[0][0];
+  ImagePtr           = &Image;
+  RowInfoArray       = NULL;
+  RowInfoArraySize   = 0;
+
+  Status = mHiiFont->StringToImage (
+                       mHiiFont,
+                       EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_IGNORE_LINE_BREAK,
+                       String,
+                       &FontInfo,
+                       &ImagePtr,
+                       0,
+                       0,
+                       &RowInfoArray,
+                       &RowInfoArraySize,
+                       NULL
+                       );
+  if (EFI_ERROR (Status) || (RowInfoArraySize != 1) ||
+      (RowInfoArray[0].LineWidth != EFI_GLYPH_WIDTH) ||
+      (RowInfoArray[0].LineHeight != EFI_GLYPH_HEIGHT))
+  {
+    Glyph = NULL;
+  } else {
+    for (PosY = 0; PosY < EFI_GLYPH_HEIGHT; PosY++) {
+      CopyMem (Glyph->Cell[PosY], Bitmap[PosY], sizeof (Glyph->Cell[PosY]));
+    }
+
+    Glyph->Char      = Char;
+    Glyph->Attribute = Attribute;
+    Glyph->Valid     = TRUE;
+  }
+
+  if (RowInfoArray != NULL) {
+    FreePool (RowInfoArray);
+  }
+
+  return Glyph;
+}
+
+/**
+  Draw Unicode string in the shadow buffer of the Graphics Console device.
+
+  Narrow characters are copied from the glyph cache. When one of them can't
+  be cached, or wide characters are displayed, the whole string is rendered
+  by the HII Font protocol into the shadow buffer instead.
+
+  @param  This                  Protocol instance pointer.
+  @param  UnicodeWeight         One Unicode string to be displayed.
+  @param  Count                 The count of Unicode string.
+
+  @retval EFI_OUT_OF_RESOURCES  If no memory resource to use.
+  @retval EFI_SUCCESS           Drawing Unicode string implemented successfully.
+
+**/
+EFI_STATUS
+DrawUnicodeWeightToShadowBuffer (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This,
+  IN  CHAR16                           *UnicodeWeight,
+  IN  UINTN                            Count
+  )
+{
+  EFI_STATUS                     Status;
+  GRAPHICS_CONSOLE_DEV           *Private;
+  GRAPHICS_CONSOLE_GLYPH         *Glyph;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Cell;
+  EFI_IMAGE_OUTPUT               Image;
+  EFI_IMAGE_OUTPUT               *ImagePtr;
+  EFI_FONT_DISPLAY_INFO          FontInfo;
+  EFI_STRING                     String;
+  UINTN                          X;
+  UINTN                          Y;
+  UINTN                          Index;
+  UINTN                          PosY;
+
+  Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  X       = This->Mode->CursorColumn * EFI_GLYPH_WIDTH;
+  Y       = This->Mode->CursorRow * EFI_GLYPH_HEIGHT;
+
+  if ((This->Mode->Attribute & EFI_WIDE_ATTRIBUTE) == 0) {
+    for (Index = 0; Index < Count; Index++) {
+      Glyph = GetCachedGlyph (This, UnicodeWeight[Index]);
+      if (Glyph == NULL) {
+        break;
+      }
+
+      Cell = Private->ShadowBuffer + Y * Private->ShadowWidth + X + Index * EFI_GLYPH_WIDTH;
+      for (PosY = 0; PosY < EFI_GLYPH_HEIGHT; PosY++) {
+        CopyMem (Cell, Glyph->Cell[PosY], sizeof (Glyph->Cell[PosY]));
+        Cell += Private->ShadowWidth;
+      }
+    }
+
+    if (Index == Count) {
+      MarkShadowBufferDirty (Private, X, Y, Count * EFI_GLYPH_WIDTH, EFI_GLYPH_HEIGHT);
+      return EFI_SUCCESS;
+    }
+  }
+
+  String = AllocateCopyPool ((Count + 1) * sizeof (CHAR16), UnicodeWeight);
+  if (String == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  String[Count] = L'\0';
+
+  ZeroMem (&FontInfo, sizeof (FontInfo));
+  GetTextColors (This, &FontInfo.ForegroundColor, &FontInfo.BackgroundColor);
+
+  Image.Width        = (UINT16)Private->ShadowWidth;
+  Image.Height       = (UINT16)Private->ShadowHeight;
+  Image.Image.Bitmap = Private->ShadowBuffer;
+  ImagePtr           = &Image;
+
+  Status = mHiiFont->StringToImage (
+                       mHiiFont,
+                       EFI_HII_IGNORE_IF_NO_GLYPH | EFI_HII_IGNORE_LINE_BREAK,
+                       String,
+                       &FontInfo,
+                       &ImagePtr,
+                       X,
+                       Y,
+                       NULL,
+                       NULL,
+                       NULL
+                       );
+
+  //
+  // The string never goes past the end of the row.
+  //
+  MarkShadowBufferDirty (Private, X, Y, Private->ShadowWidth - X, EFI_GLYPH_HEIGHT);
+
+  FreePool (String);
+
+  return Status;
+}
+
 /**
   Draw Unicode string on the Graphics Console device's screen.
 
@@ -1783,7 +2161,11 @@ DrawUnicodeWeightAtCursorN (
   UINTN                  RowInfoArraySize;
 
   Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
-  Blt     = (EFI_IMAGE_OUTPUT *)AllocateZeroPool (sizeof (EFI_IMAGE_OUTPUT));
+  if (Private->ShadowBuffer != NULL) {
+    return DrawUnicodeWeightToShadowBuffer (This, UnicodeWeight, Count);
+  }
+
+  Blt = (EFI_IMAGE_OUTPUT *)AllocateZeroPool (sizeof (EFI_IMAGE_OUTPUT));
   if (Blt == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1935,6 +2317,7 @@ FlushCursor (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Foreground;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Background;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  BltChar[EFI_GLYPH_HEIGHT][EFI_GLYPH_WIDTH];
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  *Cell;
   UINTN                                PosX;
   UINTN                                PosY;
 
@@ -1948,6 +2331,34 @@ FlushCursor (
   GraphicsOutput = Private->GraphicsOutput;
   UgaDraw        = Private->UgaDraw;
 
+  if (Private->ShadowBuffer != NULL) {
+    //
+    // Toggle the cursor in the shadow buffer, the caller updates the screen.
+    // A cursor past the right edge, while a line wraps, is outside of it.
+    //
+    PosX = CurrentMode->CursorColumn * EFI_GLYPH_WIDTH;
+    PosY = CurrentMode->CursorRow * EFI_GLYPH_HEIGHT;
+    if ((PosX + EFI_GLYPH_WIDTH > Private->ShadowWidth) || (PosY + EFI_GLYPH_HEIGHT > Private->ShadowHeight)) {
+      return EFI_SUCCESS;
+    }
+
+    GetTextColors (This, &Foreground.Pixel, &Background.Pixel);
+    Cell = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION *)(Private->ShadowBuffer + PosY * Private->ShadowWidth + PosX);
+    MarkShadowBufferDirty (Private, PosX, PosY, EFI_GLYPH_WIDTH, EFI_GLYPH_HEIGHT);
+
+    for (PosY = 0; PosY < EFI_GLYPH_HEIGHT; PosY++) {
+      for (PosX = 0; PosX < EFI_GLYPH_WIDTH; PosX++) {
+        if ((mCursorGlyph.GlyphCol1[PosY] & (BIT0 << PosX)) != 0) {
+          Cell[EFI_GLYPH_WIDTH - PosX - 1].Raw ^= Foreground.Raw;
+        }
+      }
+
+      Cell += Private->ShadowWidth;
+    }
+
+    return EFI_SUCCESS;
+  }
+
   //
   // In this driver, only narrow character was supported.
   //
@@ -64,8 +64,34 @@ typedef struct {
   EFI_SIMPLE_TEXT_OUTPUT_MODE        SimpleTextOutputMode;
   GRAPHICS_CONSOLE_MODE_DATA         *ModeData;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *LineBuffer;
+  //
+  // Off-screen copy of the text area of the current mode, NULL when the
+  // console draws on the screen directly. The dirty rectangle is the part
+  // of it that has not been copied to the screen yet, it is empty when
+  // DirtyRight is 0.
+  //
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *ShadowBuffer;
+  UINTN                              ShadowWidth;
+  UINTN                              ShadowHeight;
+  UINTN                              DirtyLeft;
+  UINTN                              DirtyTop;
+  UINTN                              DirtyRight;
+  UINTN                              DirtyBottom;
+  BOOLEAN                            DeferFlush;
 } GRAPHICS_CONSOLE_DEV;
 
+//
+// Rendered narrow character cell, cached by character and text attribute.
+//
+#define GRAPHICS_CONSOLE_GLYPH_CACHE_SIZE  256
+
+typedef struct {
+  CHAR16                           Char;
+  UINT8                            Attribute;
+  BOOLEAN                          Valid;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    Cell[EFI_GLYPH_HEIGHT][EFI_GLYPH_WIDTH];
+} GRAPHICS_CONSOLE_GLYPH;
+
 #define GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS(a) \
   CR (a, GRAPHICS_CONSOLE_DEV, SimpleTextOutput, GRAPHICS_CONSOLE_DEV_SIGNATURE)
 
@@ -556,6 +582,42 @@ FlushCursor (
   IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
   );
 
+/**
+  Add a rectangle of the text area to the dirty rectangle of the shadow buffer.
+
+  @param  Private               Graphics Console device private data.
+  @param  X                     Left edge of the rectangle in the text area.
+  @param  Y                     Top edge of the rectangle in the text area.
+  @param  Width                 Width of the rectangle.
+  @param  Height                Height of the rectangle.
+
+**/
+VOID
+MarkShadowBufferDirty (
+  IN  GRAPHICS_CONSOLE_DEV  *Private,
+  IN  UINTN                 X,
+  IN  UINTN                 Y,
+  IN  UINTN                 Width,
+  IN  UINTN                 Height
+  );
+
+/**
+  Copy the dirty rectangle of the shadow buffer to the screen with one Blt.
+
+  Nothing is done when there is no shadow buffer, when the dirty rectangle is
+  empty, or while an outer OutputString() call defers the copy.
+
+  @param  Private               Graphics Console device private data.
+
+  @retval EFI_SUCCESS           The screen is up to date.
+  @return Others                The status returned by Blt().
+
+**/
+EFI_STATUS
+FlushShadowBuffer (
+  IN  GRAPHICS_CONSOLE_DEV  *Private
+  );
+
 /**
   Check if the current specific mode supported the user defined resolution
   for the Graphics Console device based on Graphics Output Protocol.
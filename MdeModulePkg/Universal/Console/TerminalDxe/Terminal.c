@@ -108,7 +108,15 @@ TERMINAL_DEV  mTerminalDevTemplate = {
     NULL,
     NULL,
   },
-  NULL // KeyNotifyProcessEvent
+  NULL, // KeyNotifyProcessEvent
+  {
+    0
+  },    // OutputBuffer
+  0,    // OutputLength
+  NULL, // ScreenCells
+  0,    // ScreenColumns
+  0,    // ScreenRows
+  TRUE  // CursorSynced
 };
 
 TERMINAL_CONSOLE_MODE_DATA  mTerminalConsoleModeData[] = {
@@ -854,6 +862,10 @@ FreeResources:
     FreePool (TerminalDevice->TerminalConsoleModeData);
   }
 
+  if (TerminalDevice->ScreenCells != NULL) {
+    FreePool (TerminalDevice->ScreenCells);
+  }
+
   FreePool (TerminalDevice);
 
 CloseProtocols:
@@ -1010,6 +1022,10 @@ TerminalDriverBindingStop (
         TerminalFreeNotifyList (&TerminalDevice->NotifyList);
         FreePool (TerminalDevice->DevicePath);
         FreePool (TerminalDevice->TerminalConsoleModeData);
+        if (TerminalDevice->ScreenCells != NULL) {
+          FreePool (TerminalDevice->ScreenCells);
+        }
+
         FreePool (TerminalDevice);
       }
     }
@@ -61,6 +61,17 @@ typedef struct {
   UINTN    Rows;
 } TERMINAL_CONSOLE_MODE_DATA;
 
+//
+// One cell of the terminal screen model. A Char of CHAR_NULL means the
+// content of the cell on the terminal is unknown.
+//
+typedef struct {
+  CHAR16    Char;
+  UINT8     Attribute;
+} TERMINAL_SCREEN_CELL;
+
+#define TERMINAL_OUTPUT_BUFFER_SIZE  512
+
 #define KEYBOARD_TIMER_INTERVAL  200000         // 0.02s
 
 #define TERMINAL_DEV_SIGNATURE  SIGNATURE_32 ('t', 'm', 'n', 'l')
@@ -120,6 +131,22 @@ typedef struct {
   EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL    SimpleInputEx;
   LIST_ENTRY                           NotifyList;
   EFI_EVENT                            KeyNotifyProcessEvent;
+
+  //
+  // Bytes queued by OutputString() and sent to the serial port in one write.
+  //
+  UINT8                                OutputBuffer[TERMINAL_OUTPUT_BUFFER_SIZE];
+  UINTN                                OutputLength;
+
+  //
+  // Model of the terminal screen, used when PcdTerminalDifferentialUpdate is
+  // TRUE. CursorSynced is FALSE when the terminal cursor is not at the
+  // position in SimpleTextOutputMode because unchanged cells were skipped.
+  //
+  TERMINAL_SCREEN_CELL                 *ScreenCells;
+  UINTN                                ScreenColumns;
+  UINTN                                ScreenRows;
+  BOOLEAN                              CursorSynced;
 } TERMINAL_DEV;
 
 #define INPUT_STATE_DEFAULT              0x00
@@ -1404,6 +1431,86 @@ TerminalIsValidEfiCntlChar (
   IN  CHAR16  CharC
   );
 
+/**
+  Queue bytes to be sent to the terminal. The queue is written to the serial
+  port when it is full and at the end of every OutputString() call, so that a
+  string costs one serial write instead of one per character.
+
+  @param  TerminalDevice       The terminal device.
+  @param  Buffer               The bytes to send.
+  @param  Length               The number of bytes in Buffer.
+
+  @retval EFI_SUCCESS          The bytes are queued.
+  @retval others               The serial port failed to send the queue.
+
+**/
+EFI_STATUS
+TerminalWriteOutput (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN CONST VOID    *Buffer,
+  IN UINTN         Length
+  );
+
+/**
+  Send the bytes queued by TerminalWriteOutput() to the serial port.
+
+  @param  TerminalDevice       The terminal device.
+
+  @retval EFI_SUCCESS          The queue is sent.
+  @retval others               The serial port failed to send the queue. The
+                               queued bytes are dropped.
+
+**/
+EFI_STATUS
+TerminalFlushOutput (
+  IN TERMINAL_DEV  *TerminalDevice
+  );
+
+/**
+  Queue the control sequence that moves the terminal cursor to the position
+  recorded in the Simple Text Output mode.
+
+  @param  TerminalDevice       The terminal device.
+
+  @retval EFI_SUCCESS          The control sequence is queued.
+  @retval others               The serial port failed to send the queue.
+
+**/
+EFI_STATUS
+TerminalSyncCursor (
+  IN TERMINAL_DEV  *TerminalDevice
+  );
+
+/**
+  Allocate the screen model for a text mode. All cells start out unknown.
+  The model is dropped, and every cell is sent again, when it cannot be
+  allocated.
+
+  @param  TerminalDevice       The terminal device.
+  @param  Columns              The number of columns of the text mode.
+  @param  Rows                 The number of rows of the text mode.
+
+**/
+VOID
+TerminalResizeScreenModel (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN UINTN         Columns,
+  IN UINTN         Rows
+  );
+
+/**
+  Scroll the screen model up by one row, as the terminal does for a line feed
+  on its last row. The new last row is unknown since its attribute depends on
+  the terminal.
+
+  @param  TerminalDevice       The terminal device.
+
+**/
+VOID
+TerminalScrollScreenModel (
+  IN TERMINAL_DEV  *TerminalDevice
+  );
+
 /**
   Check if the device supports hot-plug through its device path.
 
@@ -182,15 +182,21 @@ TerminalConOutOutputString (
   EFI_STATUS                   Status;
   UINT8                        ValidBytes;
   CHAR8                        CrLfStr[2];
+  VOID                         *OutputBytes;
+  BOOLEAN                      UseScreenModel;
+  BOOLEAN                      SkipOutput;
+  TERMINAL_SCREEN_CELL         *Cell;
   //
   //  flag used to indicate whether condition happens which will cause
   //  return EFI_WARN_UNKNOWN_GLYPH
   //
   BOOLEAN  Warning;
 
-  ValidBytes = 0;
-  Warning    = FALSE;
-  AsciiChar  = 0;
+  ValidBytes  = 0;
+  Warning     = FALSE;
+  AsciiChar   = 0;
+  OutputBytes = NULL;
+  Length      = 0;
 
   //
   //  get Terminal device data structure pointer.
@@ -213,7 +219,41 @@ TerminalConOutOutputString (
           &MaxRow
           );
 
+  //
+  // Escape sequences sent by this driver do not change the screen, so they
+  // bypass the screen model.
+  //
+  UseScreenModel = (BOOLEAN)(!TerminalDevice->OutputEscChar &&
+                             (TerminalDevice->ScreenCells != NULL) &&
+                             (TerminalDevice->ScreenColumns == MaxColumn) &&
+                             (TerminalDevice->ScreenRows == MaxRow));
+
   for ( ; *WString != CHAR_NULL; WString++) {
+    SkipOutput = FALSE;
+    if (UseScreenModel) {
+      if (!TerminalIsValidEfiCntlChar (*WString)) {
+        //
+        // Skip the cell if the terminal already shows this character with
+        // the current attribute.
+        //
+        Cell = &TerminalDevice->ScreenCells[Mode->CursorRow * MaxColumn + Mode->CursorColumn];
+        if ((Cell->Char == *WString) && (Cell->Attribute == (UINT8)Mode->Attribute)) {
+          SkipOutput                   = TRUE;
+          TerminalDevice->CursorSynced = FALSE;
+        } else {
+          Cell->Char      = *WString;
+          Cell->Attribute = (UINT8)Mode->Attribute;
+        }
+      }
+
+      if (!SkipOutput && !TerminalDevice->CursorSynced) {
+        Status = TerminalSyncCursor (TerminalDevice);
+        if (EFI_ERROR (Status)) {
+          goto OutputError;
+        }
+      }
+    }
+
     switch (TerminalDevice->TerminalType) {
       case TerminalTypePcAnsi:
       case TerminalTypeVt100:
@@ -251,35 +291,24 @@ TerminalConOutOutputString (
           GraphicChar = AsciiChar;
         }
 
-        Length = 1;
-
-        Status = TerminalDevice->SerialIo->Write (
-                                             TerminalDevice->SerialIo,
-                                             &Length,
-                                             &GraphicChar
-                                             );
-
-        if (EFI_ERROR (Status)) {
-          goto OutputError;
-        }
-
+        Length      = 1;
+        OutputBytes = &GraphicChar;
         break;
 
       case TerminalTypeVtUtf8:
         UnicodeToUtf8 (*WString, &Utf8Char, &ValidBytes);
-        Length = ValidBytes;
-        Status = TerminalDevice->SerialIo->Write (
-                                             TerminalDevice->SerialIo,
-                                             &Length,
-                                             (UINT8 *)&Utf8Char
-                                             );
-        if (EFI_ERROR (Status)) {
-          goto OutputError;
-        }
-
+        Length      = ValidBytes;
+        OutputBytes = &Utf8Char;
         break;
     }
 
+    if (!SkipOutput) {
+      Status = TerminalWriteOutput (TerminalDevice, OutputBytes, Length);
+      if (EFI_ERROR (Status)) {
+        goto OutputError;
+      }
+    }
+
     //
     //  Update cursor position.
     //
@@ -294,6 +323,8 @@ TerminalConOutOutputString (
       case CHAR_LINEFEED:
         if (Mode->CursorRow < (INT32)(MaxRow - 1)) {
           Mode->CursorRow++;
+        } else if (UseScreenModel) {
+          TerminalScrollScreenModel (TerminalDevice);
         }
 
         break;
@@ -303,6 +334,26 @@ TerminalConOutOutputString (
         break;
 
       default:
+        if (UseScreenModel &&
+            (TerminalIsValidEfiCntlChar (*WString) || (Mode->CursorColumn == (INT32)(MaxColumn - 1))))
+        {
+          //
+          // The terminal may move its cursor differently for the other control
+          // characters, or defer the wrap at the end of the line, so position
+          // it explicitly before the next output.
+          //
+          TerminalDevice->CursorSynced = FALSE;
+          if ((Mode->CursorColumn == (INT32)(MaxColumn - 1)) &&
+              (Mode->CursorRow == (INT32)(MaxRow - 1)) &&
+              !SkipOutput)
+          {
+            //
+            // The terminal may scroll after the bottom right cell is written.
+            //
+            ZeroMem (TerminalDevice->ScreenCells, MaxColumn * MaxRow * sizeof (TERMINAL_SCREEN_CELL));
+          }
+        }
+
         if (Mode->CursorColumn < (INT32)(MaxColumn - 1)) {
           Mode->CursorColumn++;
         } else {
@@ -312,7 +363,7 @@ TerminalConOutOutputString (
           }
 
           if ((TerminalDevice->TerminalType == TerminalTypeTtyTerm) &&
-              !TerminalDevice->OutputEscChar)
+              !TerminalDevice->OutputEscChar && !SkipOutput)
           {
             //
             // We've written the last character on the line.  The
@@ -325,14 +376,7 @@ TerminalConOutOutputString (
             CrLfStr[0] = '\r';
             CrLfStr[1] = '\n';
 
-            Length = sizeof (CrLfStr);
-
-            Status = TerminalDevice->SerialIo->Write (
-                                                 TerminalDevice->SerialIo,
-                                                 &Length,
-                                                 CrLfStr
-                                                 );
-
+            Status = TerminalWriteOutput (TerminalDevice, CrLfStr, sizeof (CrLfStr));
             if (EFI_ERROR (Status)) {
               goto OutputError;
             }
@@ -343,6 +387,18 @@ TerminalConOutOutputString (
     }
   }
 
+  if (UseScreenModel && !TerminalDevice->CursorSynced) {
+    Status = TerminalSyncCursor (TerminalDevice);
+    if (EFI_ERROR (Status)) {
+      goto OutputError;
+    }
+  }
+
+  Status = TerminalFlushOutput (TerminalDevice);
+  if (EFI_ERROR (Status)) {
+    goto OutputError;
+  }
+
   if (Warning) {
     return EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -350,6 +406,7 @@ TerminalConOutOutputString (
   return EFI_SUCCESS;
 
 OutputError:
+  TerminalDevice->OutputLength = 0;
   REPORT_STATUS_CODE_WITH_DEVICE_PATH (
     EFI_ERROR_CODE | EFI_ERROR_MINOR,
     (EFI_PERIPHERAL_REMOTE_CONSOLE | EFI_P_EC_OUTPUT_ERROR),
@@ -488,6 +545,14 @@ TerminalConOutSetMode (
   //
   This->Mode->Mode = (INT32)ModeNumber;
 
+  if (FeaturePcdGet (PcdTerminalDifferentialUpdate)) {
+    TerminalResizeScreenModel (
+      TerminalDevice,
+      TerminalDevice->TerminalConsoleModeData[ModeNumber].Columns,
+      TerminalDevice->TerminalConsoleModeData[ModeNumber].Rows
+      );
+  }
+
   This->ClearScreen (This);
 
   TerminalDevice->OutputEscChar = TRUE;
@@ -699,6 +764,7 @@ TerminalConOutClearScreen (
 {
   EFI_STATUS    Status;
   TERMINAL_DEV  *TerminalDevice;
+  UINTN         Index;
 
   TerminalDevice = TERMINAL_CON_OUT_DEV_FROM_THIS (This);
 
@@ -713,6 +779,19 @@ TerminalConOutClearScreen (
     return EFI_DEVICE_ERROR;
   }
 
+  //
+  // The terminal now shows blanks in the current attribute. Where it left its
+  // cursor is not defined, so always position it below.
+  //
+  if (TerminalDevice->ScreenCells != NULL) {
+    for (Index = 0; Index < TerminalDevice->ScreenColumns * TerminalDevice->ScreenRows; Index++) {
+      TerminalDevice->ScreenCells[Index].Char      = L' ';
+      TerminalDevice->ScreenCells[Index].Attribute = (UINT8)This->Mode->Attribute;
+    }
+
+    TerminalDevice->CursorSynced = FALSE;
+  }
+
   Status = This->SetCursorPosition (This, 0, 0);
 
   return Status;
@@ -770,6 +849,15 @@ TerminalConOutSetCursorPosition (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Nothing to send if the terminal cursor is known to be there already.
+  //
+  if ((TerminalDevice->ScreenCells != NULL) && TerminalDevice->CursorSynced &&
+      ((UINTN)Mode->CursorColumn == Column) && ((UINTN)Mode->CursorRow == Row))
+  {
+    return EFI_SUCCESS;
+  }
+
   //
   // control sequence to move the cursor
   //
@@ -778,6 +866,7 @@ TerminalConOutSetCursorPosition (
   // it isn't necessary.
   //
   if ((TerminalDevice->TerminalType == TerminalTypeTtyTerm) &&
+      TerminalDevice->CursorSynced &&
       ((UINTN)Mode->CursorRow == Row))
   {
     if ((UINTN)Mode->CursorColumn > Column) {
@@ -811,8 +900,9 @@ TerminalConOutSetCursorPosition (
   //  update current cursor position
   //  in the Mode data structure.
   //
-  Mode->CursorColumn = (INT32)Column;
-  Mode->CursorRow    = (INT32)Row;
+  Mode->CursorColumn           = (INT32)Column;
+  Mode->CursorRow              = (INT32)Row;
+  TerminalDevice->CursorSynced = TRUE;
 
   return EFI_SUCCESS;
 }
@@ -943,3 +1033,180 @@ TerminalIsValidEfiCntlChar (
 
   return FALSE;
 }
+
+/**
+  Queue bytes to be sent to the terminal. The queue is written to the serial
+  port when it is full and at the end of every OutputString() call, so that a
+  string costs one serial write instead of one per character.
+
+  @param  TerminalDevice       The terminal device.
+  @param  Buffer               The bytes to send.
+  @param  Length               The number of bytes in Buffer.
+
+  @retval EFI_SUCCESS          The bytes are queued.
+  @retval others               The serial port failed to send the queue.
+
+**/
+EFI_STATUS
+TerminalWriteOutput (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN CONST VOID    *Buffer,
+  IN UINTN         Length
+  )
+{
+  EFI_STATUS  Status;
+
+  if (TerminalDevice->OutputLength + Length > TERMINAL_OUTPUT_BUFFER_SIZE) {
+    Status = TerminalFlushOutput (TerminalDevice);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  ASSERT (Length <= TERMINAL_OUTPUT_BUFFER_SIZE);
+  CopyMem (&TerminalDevice->OutputBuffer[TerminalDevice->OutputLength], Buffer, Length);
+  TerminalDevice->OutputLength += Length;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Send the bytes queued by TerminalWriteOutput() to the serial port.
+
+  @param  TerminalDevice       The terminal device.
+
+  @retval EFI_SUCCESS          The queue is sent.
+  @retval others               The serial port failed to send the queue. The
+                               queued bytes are dropped.
+
+**/
+EFI_STATUS
+TerminalFlushOutput (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+
+  if (TerminalDevice->OutputLength == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Length                       = TerminalDevice->OutputLength;
+  TerminalDevice->OutputLength = 0;
+
+  Status = TerminalDevice->SerialIo->Write (
+                                       TerminalDevice->SerialIo,
+                                       &Length,
+                                       TerminalDevice->OutputBuffer
+                                       );
+
+  return Status;
+}
+
+/**
+  Queue the control sequence that moves the terminal cursor to the position
+  recorded in the Simple Text Output mode.
+
+  @param  TerminalDevice       The terminal device.
+
+  @retval EFI_SUCCESS          The control sequence is queued.
+  @retval others               The serial port failed to send the queue.
+
+**/
+EFI_STATUS
+TerminalSyncCursor (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       String[sizeof (mSetCursorPositionString) / sizeof (CHAR16) - 1];
+  UINTN       Row;
+  UINTN       Column;
+  UINTN       Index;
+
+  Row    = (UINTN)TerminalDevice->SimpleTextOutputMode.CursorRow + 1;
+  Column = (UINTN)TerminalDevice->SimpleTextOutputMode.CursorColumn + 1;
+
+  for (Index = 0; Index < ARRAY_SIZE (String); Index++) {
+    String[Index] = (CHAR8)mSetCursorPositionString[Index];
+  }
+
+  String[ROW_OFFSET + 0]    = (CHAR8)('0' + (Row / 10));
+  String[ROW_OFFSET + 1]    = (CHAR8)('0' + (Row % 10));
+  String[COLUMN_OFFSET + 0] = (CHAR8)('0' + (Column / 10));
+  String[COLUMN_OFFSET + 1] = (CHAR8)('0' + (Column % 10));
+
+  Status = TerminalWriteOutput (TerminalDevice, String, sizeof (String));
+  if (!EFI_ERROR (Status)) {
+    TerminalDevice->CursorSynced = TRUE;
+  }
+
+  return Status;
+}
+
+/**
+  Allocate the screen model for a text mode. All cells start out unknown.
+  The model is dropped, and every cell is sent again, when it cannot be
+  allocated.
+
+  @param  TerminalDevice       The terminal device.
+  @param  Columns              The number of columns of the text mode.
+  @param  Rows                 The number of rows of the text mode.
+
+**/
+VOID
+TerminalResizeScreenModel (
+  IN TERMINAL_DEV  *TerminalDevice,
+  IN UINTN         Columns,
+  IN UINTN         Rows
+  )
+{
+  if ((TerminalDevice->ScreenCells != NULL) &&
+      ((TerminalDevice->ScreenColumns != Columns) || (TerminalDevice->ScreenRows != Rows)))
+  {
+    FreePool (TerminalDevice->ScreenCells);
+    TerminalDevice->ScreenCells = NULL;
+  }
+
+  if (TerminalDevice->ScreenCells == NULL) {
+    TerminalDevice->ScreenCells = AllocatePool (Columns * Rows * sizeof (TERMINAL_SCREEN_CELL));
+    if (TerminalDevice->ScreenCells == NULL) {
+      TerminalDevice->ScreenColumns = 0;
+      TerminalDevice->ScreenRows    = 0;
+      return;
+    }
+  }
+
+  ZeroMem (TerminalDevice->ScreenCells, Columns * Rows * sizeof (TERMINAL_SCREEN_CELL));
+  TerminalDevice->ScreenColumns = Columns;
+  TerminalDevice->ScreenRows    = Rows;
+  TerminalDevice->CursorSynced  = FALSE;
+}
+
+/**
+  Scroll the screen model up by one row, as the terminal does for a line feed
+  on its last row. The new last row is unknown since its attribute depends on
+  the terminal.
+
+  @param  TerminalDevice       The terminal device.
+
+**/
+VOID
+TerminalScrollScreenModel (
+  IN TERMINAL_DEV  *TerminalDevice
+  )
+{
+  UINTN  RowSize;
+
+  RowSize = TerminalDevice->ScreenColumns * sizeof (TERMINAL_SCREEN_CELL);
+  CopyMem (
+    TerminalDevice->ScreenCells,
+    TerminalDevice->ScreenCells + TerminalDevice->ScreenColumns,
+    RowSize * (TerminalDevice->ScreenRows - 1)
+    );
+  ZeroMem (
+    TerminalDevice->ScreenCells + TerminalDevice->ScreenColumns * (TerminalDevice->ScreenRows - 1),
+    RowSize
+    );
+}
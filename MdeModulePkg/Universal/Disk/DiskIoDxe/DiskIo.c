@@ -48,6 +48,349 @@ DISK_IO_PRIVATE_DATA  gDiskIoPrivateDataTemplate = {
   }
 };
 
+/**
+  Destroy the block cache of a Disk I/O instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE  *Cache;
+  UINT32         LineSize;
+
+  Cache = Instance->Cache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  LineSize = Cache->LineBlocks * Instance->BlockIo->Media->BlockSize;
+  if (Cache->Staging != NULL) {
+    FreeAlignedPages (Cache->Staging, EFI_SIZE_TO_PAGES ((UINTN)Cache->ReadAheadNum * LineSize));
+  }
+
+  if (Cache->Data != NULL) {
+    FreePages (Cache->Data, EFI_SIZE_TO_PAGES ((UINTN)Cache->LineNum * LineSize));
+  }
+
+  if (Cache->Lines != NULL) {
+    FreePool (Cache->Lines);
+  }
+
+  FreePool (Cache);
+  Instance->Cache = NULL;
+}
+
+/**
+  Create the block cache of a Disk I/O instance, as configured by
+  PcdDiskIoCacheLineNum and PcdDiskIoCacheReadAheadLineNum.
+
+  The block cache is an optimization only; failing to create it leaves
+  Instance->Cache NULL, and all requests go to the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheCreate (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              LineNum;
+  UINT32              LineSize;
+  UINT32              Index;
+
+  LineNum = PcdGet32 (PcdDiskIoCacheLineNum);
+  Media   = Instance->BlockIo->Media;
+  if ((LineNum == 0) || (Media->BlockSize == 0)) {
+    return;
+  }
+
+  Cache = AllocateZeroPool (sizeof (DISK_IO_CACHE));
+  if (Cache == NULL) {
+    return;
+  }
+
+  Cache->MediaId      = Media->MediaId;
+  Cache->LineBlocks   = ((Media->BlockSize < DISK_IO_CACHE_LINE_SIZE) && (DISK_IO_CACHE_LINE_SIZE % Media->BlockSize == 0))
+                        ? DISK_IO_CACHE_LINE_SIZE / Media->BlockSize
+                        : 1;
+  Cache->LineNum      = LineNum;
+  Cache->ReadAheadNum = MIN (MAX (PcdGet32 (PcdDiskIoCacheReadAheadLineNum), 1), LineNum);
+  Cache->NextIndex    = MAX_UINT64;
+  InitializeListHead (&Cache->Lru);
+
+  LineSize       = Cache->LineBlocks * Media->BlockSize;
+  Cache->Lines   = AllocateZeroPool (LineNum * sizeof (DISK_IO_CACHE_LINE));
+  Cache->Data    = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN)LineNum * LineSize));
+  Cache->Staging = AllocateAlignedPages (
+                     EFI_SIZE_TO_PAGES ((UINTN)Cache->ReadAheadNum * LineSize),
+                     Media->IoAlign
+                     );
+  if ((Cache->Lines == NULL) || (Cache->Data == NULL) || (Cache->Staging == NULL)) {
+    DEBUG ((DEBUG_WARN, "DiskIo: Out of resources, block cache disabled.\n"));
+    Instance->Cache = Cache;
+    DiskIoCacheDestroy (Instance);
+    return;
+  }
+
+  for (Index = 0; Index < LineNum; Index++) {
+    Cache->Lines[Index].Data = Cache->Data + (UINTN)Index * LineSize;
+    InsertTailList (&Cache->Lru, &Cache->Lines[Index].Link);
+  }
+
+  Instance->Cache = Cache;
+}
+
+/**
+  Invalidate the lines of the block cache which overlap with a byte range of
+  the device. Invalidated lines become the least recently used ones.
+
+  The caller must be at TPL_CALLBACK.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Offset      The starting byte offset of the range.
+  @param Length      The size in bytes of the range. MAX_UINT64 invalidates
+                     from Offset to the end of the device.
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINT64                Length
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  UINT32              LineSize;
+  UINT64              First;
+  UINT64              Last;
+  UINT32              Index;
+  DISK_IO_CACHE_LINE  *Line;
+
+  Cache    = Instance->Cache;
+  LineSize = Cache->LineBlocks * Instance->BlockIo->Media->BlockSize;
+  if (Length == 0) {
+    return;
+  }
+
+  First = DivU64x32 (Offset, LineSize);
+  Last  = (Length > MAX_UINT64 - Offset) ? MAX_UINT64 : DivU64x32 (Offset + Length - 1, LineSize);
+
+  for (Index = 0; Index < Cache->LineNum; Index++) {
+    Line = &Cache->Lines[Index];
+    if (Line->Valid && (Line->Index >= First) && (Line->Index <= Last)) {
+      Line->Valid = FALSE;
+      RemoveEntryList (&Line->Link);
+      InsertTailList (&Cache->Lru, &Line->Link);
+    }
+  }
+
+  Cache->NextIndex = MAX_UINT64;
+}
+
+/**
+  Look up a line of the block cache; on a hit, make it the most recently used
+  one.
+
+  @param Cache       Pointer to the DISK_IO_CACHE.
+  @param Index       The line index on the media.
+
+  @return  The cache line holding the data, or NULL on a miss.
+**/
+DISK_IO_CACHE_LINE *
+DiskIoCacheLookup (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Index
+  )
+{
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *Line;
+
+  for (Link = GetFirstNode (&Cache->Lru); !IsNull (&Cache->Lru, Link); Link = GetNextNode (&Cache->Lru, Link)) {
+    Line = BASE_CR (Link, DISK_IO_CACHE_LINE, Link);
+    if (!Line->Valid) {
+      //
+      // Invalid lines are kept at the tail, no valid line follows.
+      //
+      break;
+    }
+
+    if (Line->Index == Index) {
+      RemoveEntryList (&Line->Link);
+      InsertHeadList (&Cache->Lru, &Line->Link);
+      return Line;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Fill the block cache from the device, starting with a missed line. If the
+  missed line follows the lines of the previous fill, the following lines are
+  read ahead in the same request.
+
+  The caller must be at TPL_CALLBACK.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Index       The index of the missed line on the media.
+
+  @return  The cache line holding the data, or NULL if the device read failed.
+**/
+DISK_IO_CACHE_LINE *
+DiskIoCacheFill (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Index
+  )
+{
+  EFI_STATUS          Status;
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              LineSize;
+  UINT64              Lba;
+  UINT64              Blocks;
+  UINT32              Count;
+  UINT32              Position;
+  DISK_IO_CACHE_LINE  *Line;
+
+  Cache    = Instance->Cache;
+  Media    = Instance->BlockIo->Media;
+  LineSize = Cache->LineBlocks * Media->BlockSize;
+
+  Count = (Index == Cache->NextIndex) ? Cache->ReadAheadNum : 1;
+  Lba   = MultU64x32 (Index, Cache->LineBlocks);
+  ASSERT (Lba <= Media->LastBlock);
+  Blocks = MIN (MultU64x32 (Count, Cache->LineBlocks), Media->LastBlock - Lba + 1);
+  Count  = (UINT32)DivU64x32 (Blocks + Cache->LineBlocks - 1, Cache->LineBlocks);
+
+  Status = Instance->BlockIo->ReadBlocks (
+                                Instance->BlockIo,
+                                Cache->MediaId,
+                                Lba,
+                                (UINTN)Blocks * Media->BlockSize,
+                                Cache->Staging
+                                );
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  //
+  // Install the lines backwards, so that the missed line ends up as the most
+  // recently used one, and read-ahead lines don't evict each other.
+  //
+  Position = Count;
+  do {
+    Position--;
+    Line = DiskIoCacheLookup (Cache, Index + Position);
+    if (Line == NULL) {
+      Line = BASE_CR (GetPreviousNode (&Cache->Lru, &Cache->Lru), DISK_IO_CACHE_LINE, Link);
+      RemoveEntryList (&Line->Link);
+      InsertHeadList (&Cache->Lru, &Line->Link);
+      Line->Index = Index + Position;
+      Line->Valid = TRUE;
+    }
+
+    //
+    // The tail of the last line may lie beyond the end of the media; it is
+    // never copied out.
+    //
+    CopyMem (
+      Line->Data,
+      Cache->Staging + (UINTN)Position * LineSize,
+      (UINTN)MIN (LineSize, (Blocks - MultU64x32 (Position, Cache->LineBlocks)) * Media->BlockSize)
+      );
+  } while (Position > 0);
+
+  Cache->NextIndex = Index + Count;
+  return Line;
+}
+
+/**
+  Serve a blocking read request from the block cache, filling the cache from
+  the device as necessary.
+
+  Requests which the block cache does not handle -- media changed or not
+  present, out of range, or larger than a quarter of the cache -- and device
+  errors while filling the cache are left to the uncached path, which reports
+  the appropriate status.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to access.
+  @param Offset      The starting byte offset to read from.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the destination buffer for the data.
+
+  @retval TRUE   The request has been served successfully.
+  @retval FALSE  The request has to be served by the uncached path.
+**/
+BOOLEAN
+DiskIoCacheRead (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize,
+  OUT UINT8                *Buffer
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              LineSize;
+  UINT32              LineOffset;
+  UINT64              Index;
+  UINT64              MediaSize;
+  UINTN               Length;
+  DISK_IO_CACHE_LINE  *Line;
+  EFI_TPL             OldTpl;
+  BOOLEAN             Served;
+
+  Cache    = Instance->Cache;
+  Media    = Instance->BlockIo->Media;
+  LineSize = Cache->LineBlocks * Media->BlockSize;
+
+  if (!Media->MediaPresent || (MediaId != Media->MediaId) || (BufferSize == 0) ||
+      (BufferSize > MultU64x32 (Cache->LineNum, LineSize) / 4))
+  {
+    return FALSE;
+  }
+
+  MediaSize = MultU64x32 (Media->LastBlock + 1, Media->BlockSize);
+  if ((Offset > MediaSize) || (BufferSize > MediaSize - Offset)) {
+    return FALSE;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (Cache->MediaId != Media->MediaId) {
+    DiskIoCacheInvalidate (Instance, 0, MAX_UINT64);
+    Cache->MediaId = Media->MediaId;
+  }
+
+  Served = TRUE;
+  while (BufferSize > 0) {
+    Index  = DivU64x32Remainder (Offset, LineSize, &LineOffset);
+    Length = MIN (BufferSize, LineSize - LineOffset);
+    Line   = DiskIoCacheLookup (Cache, Index);
+    if (Line == NULL) {
+      Line = DiskIoCacheFill (Instance, Index);
+      if (Line == NULL) {
+        Served = FALSE;
+        break;
+      }
+    }
+
+    CopyMem (Buffer, Line->Data + LineOffset, Length);
+    Buffer     += Length;
+    Offset     += Length;
+    BufferSize -= Length;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Served;
+}
+
 /**
   Test to see if this driver supports ControllerHandle.
 
@@ -186,6 +529,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  DiskIoCacheCreate (Instance);
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -209,6 +554,10 @@ DiskIoDriverBindingStart (
 
 ErrorExit:
   if (EFI_ERROR (Status)) {
+    if (Instance != NULL) {
+      DiskIoCacheDestroy (Instance);
+    }
+
     if ((Instance != NULL) && (Instance->SharedWorkingBuffer != NULL)) {
       FreeAlignedPages (
         Instance->SharedWorkingBuffer,
@@ -347,6 +696,7 @@ DiskIoDriverBindingStop (
       ASSERT_EFI_ERROR (Status);
     }
 
+    DiskIoCacheDestroy (Instance);
     FreePool (Instance);
   }
 
@@ -858,6 +1208,12 @@ DiskIo2ReadWriteDisk (
   Status   = EFI_SUCCESS;
   Blocking = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
 
+  if (Write && (Instance->Cache != NULL)) {
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    DiskIoCacheInvalidate (Instance, Offset, BufferSize);
+    gBS->RestoreTPL (OldTpl);
+  }
+
   if (Blocking) {
     //
     // Wait till pending async task is completed.
@@ -865,6 +1221,16 @@ DiskIo2ReadWriteDisk (
     while (!DiskIo2RemoveCompletedTask (Instance)) {
     }
 
+    //
+    // The block cache only serves blocking reads; non-blocking reads bypass it,
+    // and writes invalidate it.
+    //
+    if (!Write && (Instance->Cache != NULL) &&
+        DiskIoCacheRead (Instance, MediaId, Offset, BufferSize, Buffer))
+    {
+      return EFI_SUCCESS;
+    }
+
     SubtasksPtr = &Subtasks;
   } else {
     DiskIo2RemoveCompletedTask (Instance);
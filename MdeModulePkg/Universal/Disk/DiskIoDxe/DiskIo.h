@@ -23,6 +23,32 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/PcdLib.h>
+
+//
+// Nominal size of a block cache line. Devices with larger blocks use one block
+// per line.
+//
+#define DISK_IO_CACHE_LINE_SIZE  SIZE_4KB
+
+typedef struct {
+  LIST_ENTRY    Link;                       /// < link in the LRU list, most recently used first
+  BOOLEAN       Valid;
+  UINT64        Index;                      /// < line index on the media, in units of line size
+  UINT8         *Data;
+} DISK_IO_CACHE_LINE;
+
+typedef struct {
+  UINT32                MediaId;            /// < media the cached lines belong to
+  UINT32                LineBlocks;         /// < blocks per line
+  UINT32                LineNum;
+  UINT32                ReadAheadNum;       /// < lines read at once by a sequential miss
+  UINT64                NextIndex;          /// < line right after the previous fill
+  LIST_ENTRY            Lru;
+  DISK_IO_CACHE_LINE    *Lines;
+  UINT8                 *Data;              /// < LineNum lines of data
+  UINT8                 *Staging;           /// < ReadAheadNum lines, for filling
+} DISK_IO_CACHE;
 
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
@@ -37,6 +63,8 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  DISK_IO_CACHE             *Cache;         /// < NULL if the block cache is disabled
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -82,6 +82,12 @@ typedef struct {
   EFI_BLOCK_IO_MEDIA          Media;
   EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
 
+  //
+  // The RAM disk is always backed by the whole, contiguous memory range
+  // [StartingAddr, StartingAddr + Size). The range is part of the RAM disk
+  // device path and may be published to the OS in the NFIT, so consumers
+  // other than the Block IO protocols can access the memory directly.
+  //
   UINT64                      StartingAddr;
   UINT64                      Size;
   EFI_GUID                    TypeGuid;
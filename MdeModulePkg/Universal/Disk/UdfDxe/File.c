@@ -273,6 +273,10 @@ UdfOpen (
     (VOID *)&NewPrivFileData->ReadDirInfo,
     sizeof (UDF_READ_DIRECTORY_INFO)
     );
+  ZeroMem (
+    (VOID *)&NewPrivFileData->ExtentMap,
+    sizeof (UDF_FILE_EXTENT_MAP)
+    );
 
   *NewHandle = &NewPrivFileData->FileIo;
 
@@ -383,6 +387,7 @@ UdfRead (
                Volume,
                Parent,
                PrivFileData->FileSize,
+               &PrivFileData->ExtentMap,
                &PrivFileData->FilePosition,
                Buffer,
                &BufferSizeUint64
@@ -570,6 +575,10 @@ UdfClose (
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
     }
+
+    if (PrivFileData->ExtentMap.Extents != NULL) {
+      FreePool (PrivFileData->ExtentMap.Extents);
+    }
   }
 
   FreePool ((VOID *)PrivFileData);
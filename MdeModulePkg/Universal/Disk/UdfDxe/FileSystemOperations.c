@@ -1053,6 +1053,70 @@ GrowUpBufferToNextAd (
   return EFI_SUCCESS;
 }
 
+/**
+  Append an extent to the extent map of a file.
+
+  The extent is merged into the last one of the map if it immediately follows
+  it on the disk, so that it can be read with a single DiskIo request.
+
+  @param[in, out] ExtentMap       Extent map of the file.
+  @param[in]      FileOffset      Offset of the extent in the file.
+  @param[in]      DiskOffset      Offset of the extent on the disk.
+  @param[in]      Length          Length of the extent.
+
+  @retval EFI_SUCCESS             The extent was appended.
+  @retval EFI_OUT_OF_RESOURCES    The extent map could not be grown.
+
+**/
+STATIC
+EFI_STATUS
+AppendFileExtent (
+  IN OUT  UDF_FILE_EXTENT_MAP  *ExtentMap,
+  IN      UINT64               FileOffset,
+  IN      UINT64               DiskOffset,
+  IN      UINT64               Length
+  )
+{
+  UDF_FILE_EXTENT  *Extent;
+  UINTN            MaxCount;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (ExtentMap->Count > 0) {
+    Extent = &ExtentMap->Extents[ExtentMap->Count - 1];
+    if ((Extent->FileOffset + Extent->Length == FileOffset) &&
+        (Extent->DiskOffset + Extent->Length == DiskOffset))
+    {
+      Extent->Length += Length;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (ExtentMap->Count == ExtentMap->MaxCount) {
+    MaxCount = (ExtentMap->MaxCount == 0) ? 8 : ExtentMap->MaxCount * 2;
+    Extent   = ReallocatePool (
+                 ExtentMap->MaxCount * sizeof (UDF_FILE_EXTENT),
+                 MaxCount * sizeof (UDF_FILE_EXTENT),
+                 ExtentMap->Extents
+                 );
+    if (Extent == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ExtentMap->Extents  = Extent;
+    ExtentMap->MaxCount = MaxCount;
+  }
+
+  Extent             = &ExtentMap->Extents[ExtentMap->Count++];
+  Extent->FileOffset = FileOffset;
+  Extent->DiskOffset = DiskOffset;
+  Extent->Length     = Length;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read data or size of either a File Entry or an Extended File Entry.
 
@@ -1069,7 +1133,8 @@ GrowUpBufferToNextAd (
   @retval EFI_INVALID_PARAMETER   The read file flag given in ReadFileInfo is
                                   invalid.
   @retval EFI_UNSUPPORTED         The FE recording flag given in FileEntryData
-                                  is not supported.
+                                  is not supported, or the extents of a FE/EFE
+                                  with inline data were requested.
   @retval other                   Data or size of a FE/EFE was not read.
 
 **/
@@ -1116,9 +1181,10 @@ ReadFile (
   switch (ReadFileInfo->Flags) {
     case ReadFileGetFileSize:
     case ReadFileAllocateAndRead:
+    case ReadFileGetExtents:
       //
-      // Initialise ReadFileInfo structure for either getting file size, or
-      // reading file's recorded data.
+      // Initialise ReadFileInfo structure for either getting file size,
+      // reading file's recorded data or resolving file's extents.
       //
       ReadFileInfo->ReadLength = 0;
       ReadFileInfo->FileData   = NULL;
@@ -1185,6 +1251,11 @@ ReadFile (
           );
 
         ReadFileInfo->FilePosition += ReadFileInfo->FileDataSize;
+      } else if (ReadFileInfo->Flags == ReadFileGetExtents) {
+        //
+        // Inline data is not recorded in extents of its own.
+        //
+        return EFI_UNSUPPORTED;
       } else {
         ASSERT (FALSE);
         return EFI_INVALID_PARAMETER;
@@ -1368,6 +1439,19 @@ Skip_File_Seek:
               goto Done;
             }
 
+            break;
+          case ReadFileGetExtents:
+            Status = AppendFileExtent (
+                       ReadFileInfo->ExtentMap,
+                       ReadFileInfo->ReadLength,
+                       MultU64x32 (Lsn, LogicalBlockSize),
+                       ExtentLength
+                       );
+            if (EFI_ERROR (Status)) {
+              goto Done;
+            }
+
+            ReadFileInfo->ReadLength += ExtentLength;
             break;
         }
 
@@ -2848,14 +2932,104 @@ Out_Free:
   return Status;
 }
 
+/**
+  Read file data from the extents resolved for the file.
+
+  @param[in]      BlockIo       BlockIo interface.
+  @param[in]      DiskIo        DiskIo interface.
+  @param[in]      ExtentMap     Extent map of the file.
+  @param[in]      FileSize      Size of the file.
+  @param[in, out] FilePosition  File position.
+  @param[in, out] Buffer        File data.
+  @param[in, out] BufferSize    Read size.
+
+  @retval EFI_SUCCESS          File data was read.
+  @retval other                The device reported an error.
+
+**/
+STATIC
+EFI_STATUS
+ReadFileExtents (
+  IN      EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN      EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN      UDF_FILE_EXTENT_MAP    *ExtentMap,
+  IN      UINT64                 FileSize,
+  IN OUT  UINT64                 *FilePosition,
+  IN OUT  VOID                   *Buffer,
+  IN OUT  UINT64                 *BufferSize
+  )
+{
+  EFI_STATUS       Status;
+  UDF_FILE_EXTENT  *Extent;
+  UINTN            Low;
+  UINTN            High;
+  UINTN            Middle;
+  UINT64           Offset;
+  UINT64           DataLength;
+  UINT64           BytesLeft;
+  UINT8            *Data;
+
+  if (*BufferSize > FileSize - *FilePosition) {
+    //
+    // About to read beyond the EOF -- truncate it.
+    //
+    *BufferSize = FileSize - *FilePosition;
+  }
+
+  //
+  // Find the first extent which ends beyond the file position.
+  //
+  Low  = 0;
+  High = ExtentMap->Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Extent = &ExtentMap->Extents[Middle];
+    if (Extent->FileOffset + Extent->Length <= *FilePosition) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  Data      = Buffer;
+  BytesLeft = *BufferSize;
+  for ( ; BytesLeft > 0 && Low < ExtentMap->Count; Low++) {
+    Extent     = &ExtentMap->Extents[Low];
+    Offset     = *FilePosition - Extent->FileOffset;
+    DataLength = MIN (BytesLeft, Extent->Length - Offset);
+
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       BlockIo->Media->MediaId,
+                       Extent->DiskOffset + Offset,
+                       (UINTN)DataLength,
+                       Data
+                       );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Data          += DataLength;
+    *FilePosition += DataLength;
+    BytesLeft     -= DataLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Seek a file and read its data into memory on an UDF volume.
 
+  The extents of the file are resolved on the first read, and later reads are
+  served from them. Files whose data is not recorded in extents are read by
+  walking their allocation descriptors.
+
   @param[in]      BlockIo       BlockIo interface.
   @param[in]      DiskIo        DiskIo interface.
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file, resolved on first use.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -2876,6 +3050,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_FILE_EXTENT_MAP    *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
@@ -2884,6 +3059,38 @@ ReadFileData (
   EFI_STATUS          Status;
   UDF_READ_FILE_INFO  ReadFileInfo;
 
+  if (!ExtentMap->Resolved) {
+    ExtentMap->Resolved    = TRUE;
+    ReadFileInfo.Flags     = ReadFileGetExtents;
+    ReadFileInfo.ExtentMap = ExtentMap;
+
+    Status = ReadFile (
+               BlockIo,
+               DiskIo,
+               Volume,
+               &File->FileIdentifierDesc->Icb,
+               File->FileEntry,
+               &ReadFileInfo
+               );
+    if (EFI_ERROR (Status) && (ExtentMap->Extents != NULL)) {
+      FreePool (ExtentMap->Extents);
+      ZeroMem (ExtentMap, sizeof (UDF_FILE_EXTENT_MAP));
+      ExtentMap->Resolved = TRUE;
+    }
+  }
+
+  if (ExtentMap->Extents != NULL) {
+    return ReadFileExtents (
+             BlockIo,
+             DiskIo,
+             ExtentMap,
+             FileSize,
+             FilePosition,
+             Buffer,
+             BufferSize
+             );
+  }
+
   ReadFileInfo.Flags        = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition = *FilePosition;
   ReadFileInfo.FileData     = Buffer;
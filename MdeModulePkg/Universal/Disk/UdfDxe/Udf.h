@@ -134,8 +134,29 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtents,
 } UDF_READ_FILE_FLAGS;
 
+//
+// A run of file data recorded contiguously on the disk
+//
+typedef struct {
+  UINT64    FileOffset;
+  UINT64    DiskOffset;
+  UINT64    Length;
+} UDF_FILE_EXTENT;
+
+//
+// Extents of a file, in file offset order, resolved on the first read of an
+// open file so that later reads do not walk the allocation descriptors again
+//
+typedef struct {
+  BOOLEAN            Resolved;
+  UINTN              Count;
+  UINTN              MaxCount;
+  UDF_FILE_EXTENT    *Extents;
+} UDF_FILE_EXTENT_MAP;
+
 typedef struct {
   VOID                   *FileData;
   UDF_READ_FILE_FLAGS    Flags;
@@ -143,6 +164,7 @@ typedef struct {
   UINT64                 FilePosition;
   UINT64                 FileSize;
   UINT64                 ReadLength;
+  UDF_FILE_EXTENT_MAP    *ExtentMap;
 } UDF_READ_FILE_INFO;
 
 #pragma pack(1)
@@ -353,6 +375,7 @@ typedef struct {
   CHAR16                             FileName[UDF_FILENAME_LENGTH];
   UINT64                             FileSize;
   UINT64                             FilePosition;
+  UDF_FILE_EXTENT_MAP                ExtentMap;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE  SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -962,6 +985,7 @@ GetVolumeSize (
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file, resolved on first use.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -982,6 +1006,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_FILE_EXTENT_MAP    *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
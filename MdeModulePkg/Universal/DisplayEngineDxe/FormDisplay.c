@@ -103,6 +103,11 @@ LIST_ENTRY                   gMenuOption;
 DISPLAY_HIGHLIGHT_MENU_INFO  gHighligthMenuInfo = { 0 };
 BOOLEAN                      mIsFirstForm       = TRUE;
 FORM_ENTRY_INFO              gOldFormEntry      = { 0 };
+BOOLEAN                      mFormRefreshed     = FALSE;
+DISPLAY_PAINTED_MENU         *mPaintedMenu      = NULL;
+UINTN                        mPaintedMenuCount  = 0;
+UINTN                        mPaintedMenuMax    = 0;
+UINTN                        mPaintedMenuHint   = 0;
 
 //
 // Browser Global Strings
@@ -2368,6 +2373,170 @@ FxConfirmPopup (
   return RetVal;
 }
 
+/**
+  Forget what was painted for the menu options, so that the next paint of
+  every menu option really goes to the screen.
+
+**/
+VOID
+InvalidatePaintedMenu (
+  VOID
+  )
+{
+  mPaintedMenuCount = 0;
+  mPaintedMenuHint  = 0;
+}
+
+/**
+  Find the painted record of one menu option, adding an empty record if the
+  menu option has not been painted yet.
+
+  @param  MenuOption               The menu opton to look for.
+
+  @return The painted record, or NULL if there is no memory for a new record.
+
+**/
+DISPLAY_PAINTED_MENU *
+GetPaintedMenu (
+  IN UI_MENU_OPTION  *MenuOption
+  )
+{
+  UINTN                 Index;
+  UINTN                 Count;
+  DISPLAY_PAINTED_MENU  *PaintedMenu;
+
+  //
+  // Menu options are painted in list order, so start after the last match.
+  //
+  Index = mPaintedMenuHint;
+  for (Count = 0; Count < mPaintedMenuCount; Count++, Index++) {
+    if (Index >= mPaintedMenuCount) {
+      Index = 0;
+    }
+
+    PaintedMenu = &mPaintedMenu[Index];
+    if ((PaintedMenu->OpCode == MenuOption->ThisTag->OpCode) && (PaintedMenu->Sequence == MenuOption->Sequence)) {
+      mPaintedMenuHint = Index + 1;
+      return PaintedMenu;
+    }
+  }
+
+  if (mPaintedMenuCount == mPaintedMenuMax) {
+    PaintedMenu = ReallocatePool (
+                    mPaintedMenuMax * sizeof (DISPLAY_PAINTED_MENU),
+                    (mPaintedMenuMax + DISPLAY_PAINTED_MENU_GROWTH) * sizeof (DISPLAY_PAINTED_MENU),
+                    mPaintedMenu
+                    );
+    if (PaintedMenu == NULL) {
+      return NULL;
+    }
+
+    mPaintedMenu     = PaintedMenu;
+    mPaintedMenuMax += DISPLAY_PAINTED_MENU_GROWTH;
+  }
+
+  PaintedMenu = &mPaintedMenu[mPaintedMenuCount];
+  ZeroMem (PaintedMenu, sizeof (DISPLAY_PAINTED_MENU));
+  PaintedMenu->OpCode   = MenuOption->ThisTag->OpCode;
+  PaintedMenu->Sequence = MenuOption->Sequence;
+
+  mPaintedMenuCount++;
+  mPaintedMenuHint = mPaintedMenuCount;
+
+  return PaintedMenu;
+}
+
+/**
+  Check whether one menu option is still on the screen exactly as it is about
+  to be painted. If not, record the new paint in its painted record.
+
+  @param  MenuOption               The menu opton to be painted.
+  @param  OptionString             The option string to be painted, may be NULL.
+  @param  SkipWidth                The skip width between the left to the start of the prompt.
+  @param  BeginCol                 The begin column for one menu.
+  @param  SkipLine                 The skip line for this menu.
+  @param  BottomRow                The bottom row for this form.
+  @param  Highlight                Whether this menu will be highlight.
+  @param  PaintedMenu              Return the painted record of this menu option,
+                                   NULL if it can't be recorded.
+
+  @retval TRUE                     The menu option is shown unchanged, no need to paint it.
+  @retval FALSE                    The menu option needs to be painted.
+
+**/
+BOOLEAN
+IsMenuPainted (
+  IN  UI_MENU_OPTION        *MenuOption,
+  IN  CHAR16                *OptionString,
+  IN  UINTN                 SkipWidth,
+  IN  UINTN                 BeginCol,
+  IN  UINTN                 SkipLine,
+  IN  UINTN                 BottomRow,
+  IN  BOOLEAN               Highlight,
+  OUT DISPLAY_PAINTED_MENU  **PaintedMenu
+  )
+{
+  DISPLAY_PAINTED_MENU           Paint;
+  DISPLAY_PAINTED_MENU           *Record;
+  FORM_DISPLAY_ENGINE_STATEMENT  *Statement;
+  CHAR16                         *StringPtr;
+  UINT32                         StringCrc[3];
+
+  *PaintedMenu = NULL;
+  Statement    = MenuOption->ThisTag;
+
+  Record = GetPaintedMenu (MenuOption);
+  if (Record == NULL) {
+    return FALSE;
+  }
+
+  ZeroMem (StringCrc, sizeof (StringCrc));
+  if (OptionString != NULL) {
+    StringCrc[0] = CalculateCrc32 (OptionString, StrSize (OptionString));
+  }
+
+  if (MenuOption->Description != NULL) {
+    StringCrc[1] = CalculateCrc32 (MenuOption->Description, StrSize (MenuOption->Description));
+  }
+
+  if ((Statement->OpCode->OpCode == EFI_IFR_TEXT_OP) && (((EFI_IFR_TEXT *)Statement->OpCode)->TextTwo != 0)) {
+    StringPtr    = GetToken (((EFI_IFR_TEXT *)Statement->OpCode)->TextTwo, gFormData->HiiHandle);
+    StringCrc[2] = CalculateCrc32 (StringPtr, StrSize (StringPtr));
+    FreePool (StringPtr);
+  }
+
+  ZeroMem (&Paint, sizeof (DISPLAY_PAINTED_MENU));
+  Paint.OpCode           = Record->OpCode;
+  Paint.Sequence         = Record->Sequence;
+  Paint.Row              = MenuOption->Row;
+  Paint.Col              = MenuOption->Col;
+  Paint.OptCol           = MenuOption->OptCol;
+  Paint.SkipWidth        = SkipWidth;
+  Paint.BeginCol         = BeginCol;
+  Paint.SkipLine         = SkipLine;
+  Paint.BottomRow        = BottomRow;
+  Paint.OptionBlockWidth = gOptionBlockWidth;
+  Paint.Skip             = MenuOption->Skip;
+  Paint.PaintedSkip      = Record->PaintedSkip;
+  Paint.StringCrc        = CalculateCrc32 (StringCrc, sizeof (StringCrc));
+  Paint.Highlight        = Highlight;
+  Paint.GrayOut          = MenuOption->GrayOut;
+  Paint.ReadOnly         = MenuOption->ReadOnly;
+  Paint.Painted          = Record->Painted;
+
+  *PaintedMenu = Record;
+  if (CompareMem (&Paint, Record, sizeof (DISPLAY_PAINTED_MENU)) == 0) {
+    return Record->Painted;
+  }
+
+  //
+  // Not painted until the caller finishes the paint.
+  //
+  CopyMem (Record, &Paint, sizeof (DISPLAY_PAINTED_MENU));
+  Record->Painted = FALSE;
+  return FALSE;
+}
+
 /**
   Print string for this menu option.
 
@@ -2412,6 +2581,7 @@ DisplayOneMenu (
   UINTN                          OptionLineNum;
   CHAR16                         AdjustValue;
   UINTN                          MaxRow;
+  DISPLAY_PAINTED_MENU           *PaintedMenu;
 
   Statement            = MenuOption->ThisTag;
   Temp                 = SkipLine;
@@ -2422,6 +2592,7 @@ DisplayOneMenu (
   OptionLineNum        = 0;
   MaxRow               = 0;
   IsProcessingFirstRow = TRUE;
+  PaintedMenu          = NULL;
 
   //
   // Set default color.
@@ -2436,14 +2607,30 @@ DisplayOneMenu (
     return Status;
   }
 
-  if (OptionString != NULL) {
-    if ((Statement->OpCode->OpCode == EFI_IFR_DATE_OP) || (Statement->OpCode->OpCode == EFI_IFR_TIME_OP)) {
-      //
-      // Adjust option string for date/time opcode.
-      //
-      ProcessStringForDateTime (MenuOption, OptionString, UpdateCol);
+  if ((OptionString != NULL) &&
+      ((Statement->OpCode->OpCode == EFI_IFR_DATE_OP) || (Statement->OpCode->OpCode == EFI_IFR_TIME_OP)))
+  {
+    //
+    // Adjust option string for date/time opcode.
+    //
+    ProcessStringForDateTime (MenuOption, OptionString, UpdateCol);
+  }
+
+  //
+  // Skip the paint if this menu option is still shown on the screen the same way.
+  //
+  if (  FeaturePcdGet (PcdBrowserIncrementalRefresh)
+     && IsMenuPainted (MenuOption, OptionString, SkipWidth, BeginCol, SkipLine, BottomRow, Highlight, &PaintedMenu))
+  {
+    MenuOption->Skip = PaintedMenu->PaintedSkip;
+    if (OptionString != NULL) {
+      FreePool (OptionString);
     }
 
+    return EFI_SUCCESS;
+  }
+
+  if (OptionString != NULL) {
     Width         = (UINT16)gOptionBlockWidth - 1;
     Row           = MenuOption->Row;
     GlyphWidth    = 1;
@@ -2616,6 +2803,11 @@ DisplayOneMenu (
     }
   }
 
+  if (PaintedMenu != NULL) {
+    PaintedMenu->PaintedSkip = MenuOption->Skip;
+    PaintedMenu->Painted     = TRUE;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -3225,6 +3417,7 @@ UiDisplayMenu (
         if (EventType == UIEventDriver) {
           gMisMatch          = TRUE;
           gUserInput->Action = BROWSER_ACTION_NONE;
+          mFormRefreshed     = TRUE;
           ControlFlag        = CfExit;
           break;
         }
@@ -3409,7 +3602,9 @@ UiDisplayMenu (
           default:
             //
             // Editable Questions: oneof, ordered list, checkbox, numeric, string, password
+            // Their input popups and in place editing paint over the menu options.
             //
+            InvalidatePaintedMenu ();
             RefreshKeyHelp (gFormData, Statement, TRUE);
             Status = ProcessOptions (MenuOption, TRUE, &OptionString, TRUE);
 
@@ -3436,6 +3631,7 @@ UiDisplayMenu (
         // If the policy is not exit front page when user press ESC, process here.
         //
         if (!FormExitPolicy ()) {
+          InvalidatePaintedMenu ();
           Repaint     = TRUE;
           NewLine     = TRUE;
           ControlFlag = CfRepaint;
@@ -3451,6 +3647,7 @@ UiDisplayMenu (
 
         ASSERT (HotKey != NULL);
 
+        InvalidatePaintedMenu ();
         if (FxConfirmPopup (HotKey->Action)) {
           gUserInput->Action = HotKey->Action;
           if ((HotKey->Action & BROWSER_ACTION_DEFAULT) == BROWSER_ACTION_DEFAULT) {
@@ -4114,6 +4311,7 @@ FormDisplay (
   )
 {
   EFI_STATUS  Status;
+  BOOLEAN     FormRefreshed;
 
   ASSERT (FormData != NULL);
   if (FormData == NULL) {
@@ -4123,6 +4321,13 @@ FormDisplay (
   gUserInput = UserInputData;
   gFormData  = FormData;
 
+  //
+  // The menu options painted by the last call are only known to be still on
+  // the screen if that call returned for a refresh event.
+  //
+  FormRefreshed  = mFormRefreshed;
+  mFormRefreshed = FALSE;
+
   //
   // Process the status info first.
   //
@@ -4167,6 +4372,13 @@ FormDisplay (
     mStatementLayoutIsChanged = FALSE;
   }
 
+  if (  !FormRefreshed
+     || mStatementLayoutIsChanged
+     || ((FormData->Attribute & HII_DISPLAY_MODAL) != 0))
+  {
+    InvalidatePaintedMenu ();
+  }
+
   Status = UiDisplayMenu (FormData);
 
   //
@@ -4196,6 +4408,7 @@ DriverClearDisplayPage (
 {
   ClearDisplayPage ();
   mIsFirstForm = TRUE;
+  InvalidatePaintedMenu ();
 }
 
 /**
@@ -277,6 +277,34 @@ typedef struct {
 
 #define MENU_OPTION_FROM_LINK(a)  CR (a, UI_MENU_OPTION, Link, UI_MENU_OPTION_SIGNATURE)
 
+//
+// What was last painted on the screen for one menu option. The menu options
+// are rebuilt on every FormDisplay() call, so the entry is found again by the
+// statement opcode and the date/time sequence.
+//
+typedef struct {
+  EFI_IFR_OP_HEADER    *OpCode;
+  UINTN                Sequence;
+
+  UINTN                Row;
+  UINTN                Col;
+  UINTN                OptCol;
+  UINTN                SkipWidth;
+  UINTN                BeginCol;
+  UINTN                SkipLine;
+  UINTN                BottomRow;
+  UINTN                OptionBlockWidth;
+  UINTN                Skip;          // Number of lines before painting
+  UINTN                PaintedSkip;   // Number of lines after painting
+  UINT32               StringCrc;     // CRC32 of the option, prompt and text two strings
+  BOOLEAN              Highlight;
+  BOOLEAN              GrayOut;
+  BOOLEAN              ReadOnly;
+  BOOLEAN              Painted;
+} DISPLAY_PAINTED_MENU;
+
+#define DISPLAY_PAINTED_MENU_GROWTH  0x20
+
 #define USER_SELECTABLE_OPTION_OK_WIDTH          StrLen (gOkOption)
 #define USER_SELECTABLE_OPTION_OK_CAL_WIDTH      (StrLen (gOkOption) + StrLen (gCancelOption))
 #define USER_SELECTABLE_OPTION_YES_NO_WIDTH      (StrLen (gYesOption) + StrLen (gNoOption))
@@ -708,6 +736,16 @@ UpdateHighlightMenuInfo (
   IN  UINTN       SkipValue
   );
 
+/**
+  Forget what was painted for the menu options, so that the next paint of
+  every menu option really goes to the screen.
+
+**/
+VOID
+InvalidatePaintedMenu (
+  VOID
+  );
+
 /**
   Displays a popup window.
 
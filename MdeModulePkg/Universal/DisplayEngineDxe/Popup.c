@@ -715,6 +715,12 @@ CreatePopup (
   gMaxRowWidth   = 0;
   gMesStrLineNum = 0;
 
+  //
+  // The popup covers part of the form, so the menu options under it have to
+  // be painted again.
+  //
+  InvalidatePaintedMenu ();
+
   CopyMem (&SavedConsoleMode, ConOut->Mode, sizeof (SavedConsoleMode));
   ConOut->EnableCursor (ConOut, FALSE);
   ConOut->SetAttribute (ConOut, GetPopupColor ());
@@ -1363,10 +1363,10 @@ EbcExecuteInstructions (
   IN OUT UINTN                 *InstructionCount
   )
 {
-  UINTN       ExecFunc;
-  EFI_STATUS  Status;
-  UINTN       InstructionsLeft;
-  UINTN       SavedInstructionCount;
+  CONST VM_TABLE_ENTRY  *Instruction;
+  EFI_STATUS            Status;
+  UINTN                 InstructionsLeft;
+  UINTN                 SavedInstructionCount;
 
   Status = EFI_SUCCESS;
 
@@ -1385,12 +1385,12 @@ EbcExecuteInstructions (
   // call it if it's not null.
   //
   while (InstructionsLeft != 0) {
-    ExecFunc = (UINTN)mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction;
-    if (ExecFunc == (UINTN)NULL) {
+    Instruction = &mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)];
+    if (Instruction->ExecuteFunction == NULL) {
       EbcDebugSignalException (EXCEPT_EBC_INVALID_OPCODE, EXCEPTION_FLAG_FATAL, VmPtr);
       return EFI_UNSUPPORTED;
     } else {
-      mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+      Instruction->ExecuteFunction (VmPtr);
       *InstructionCount = *InstructionCount + 1;
     }
 
@@ -1419,7 +1419,7 @@ EbcExecute (
   IN VM_CONTEXT  *VmPtr
   )
 {
-  UINTN                             ExecFunc;
+  CONST VM_TABLE_ENTRY              *Instruction;
   UINT8                             StackCorrupted;
   EFI_STATUS                        Status;
   EFI_EBC_SIMPLE_DEBUGGER_PROTOCOL  *EbcSimpleDebugger;
@@ -1478,10 +1478,11 @@ EbcExecute (
 
     //
     // Use the opcode bits to index into the opcode dispatch table. If the
-    // function pointer is null then generate an exception.
+    // function pointer is null then generate an exception. The entry is
+    // looked up once, the instruction is decoded by its execute function.
     //
-    ExecFunc = (UINTN)mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction;
-    if (ExecFunc == (UINTN)NULL) {
+    Instruction = &mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)];
+    if (Instruction->ExecuteFunction == NULL) {
       EbcDebugSignalException (EXCEPT_EBC_INVALID_OPCODE, EXCEPTION_FLAG_FATAL, VmPtr);
       Status = EFI_UNSUPPORTED;
       goto Done;
@@ -1495,7 +1496,7 @@ EbcExecute (
     //
     MemoryFence ();
 
-    mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+    Instruction->ExecuteFunction (VmPtr);
 
     MemoryFence ();
 
@@ -4213,6 +4214,43 @@ ExecuteDataManip (
   Opcode   = GETOPCODE (VmPtr);
   Operands = GETOPERANDS (VmPtr);
 
+  //
+  // Register to register forms are most of the arithmetic in compiled EBC
+  // code. They have no memory operand to fetch or write back, so handle them
+  // without going through the general operand decoding below.
+  //
+  DataManipDispatchTableIndex = (Opcode & OPCODE_M_OPCODE) - OPCODE_NOT;
+  if ((DataManipDispatchTableIndex >= 0) &&
+      (DataManipDispatchTableIndex < ARRAY_SIZE (mDataManipDispatchTable)) &&
+      ((Operands & (OPERAND_M_INDIRECT1 | OPERAND_M_INDIRECT2)) == 0))
+  {
+    Op1 = (UINT64)VmPtr->Gpr[OPERAND1_REGNUM (Operands)];
+    Op2 = (UINT64)VmPtr->Gpr[OPERAND2_REGNUM (Operands)];
+    if ((Opcode & DATAMANIP_M_IMMDATA) != 0) {
+      Op2 += VmReadImmed16 (VmPtr, 2);
+      Size = 4;
+    } else {
+      Size = 2;
+    }
+
+    if ((Opcode & DATAMANIP_M_64) != 0) {
+      VmPtr->Gpr[OPERAND1_REGNUM (Operands)] = mDataManipDispatchTable[DataManipDispatchTableIndex](VmPtr, Op1, Op2);
+    } else {
+      if (IsSignedOp) {
+        Op1 = (UINT64)(INT64)((INT32)Op1);
+        Op2 = (UINT64)(INT64)((INT32)Op2);
+      } else {
+        Op1 = (UINT64)((UINT32)Op1);
+        Op2 = (UINT64)((UINT32)Op2);
+      }
+
+      VmPtr->Gpr[OPERAND1_REGNUM (Operands)] = mDataManipDispatchTable[DataManipDispatchTableIndex](VmPtr, Op1, Op2) & 0xFFFFFFFF;
+    }
+
+    VmPtr->Ip += Size;
+    return EFI_SUCCESS;
+  }
+
   //
   // Determine if we have immediate data by the opcode
   //
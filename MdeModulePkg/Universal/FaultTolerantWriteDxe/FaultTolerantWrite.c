@@ -338,6 +338,7 @@ FtwWrite (
   UINTN                               NumberOfBlocks;
   UINTN                               NumberOfWriteBlocks;
   UINTN                               WriteLength;
+  UINTN                               NumberOfSpareBlocks;
 
   FtwDevice = FTW_CONTEXT_FROM_THIS (This);
 
@@ -437,6 +438,17 @@ FtwWrite (
     ASSERT ((BlockSize == FtwDevice->SpareBlockSize) && (NumberOfWriteBlocks == FtwDevice->NumberOfSpareBlock));
   }
 
+  //
+  // The working block and the boot block are flushed from the whole spare area.
+  // Other targets are only flushed from the spare blocks the write lands in, so
+  // only those have to be saved, erased, written and restored.
+  //
+  if (IsWorkingBlock (FtwDevice, Fvb, Lba) || IsBootBlock (FtwDevice, Fvb)) {
+    NumberOfSpareBlocks = FtwDevice->NumberOfSpareBlock;
+  } else {
+    NumberOfSpareBlocks = FTW_BLOCKS (WriteLength, FtwDevice->SpareBlockSize);
+  }
+
   //
   // Write the record to the work space.
   //
@@ -500,7 +512,7 @@ FtwWrite (
   // Try to keep the content of spare block
   // Save spare block into a spare backup memory buffer (Sparebuffer)
   //
-  SpareBufferSize = FtwDevice->SpareAreaLength;
+  SpareBufferSize = NumberOfSpareBlocks * FtwDevice->SpareBlockSize;
   SpareBuffer     = AllocatePool (SpareBufferSize);
   if (SpareBuffer == NULL) {
     FreePool (MyBuffer);
@@ -508,7 +520,7 @@ FtwWrite (
   }
 
   Ptr = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; Index < NumberOfSpareBlocks; Index += 1) {
     MyLength = FtwDevice->SpareBlockSize;
     Status   = FtwDevice->FtwBackupFvb->Read (
                                           FtwDevice->FtwBackupFvb,
@@ -530,7 +542,7 @@ FtwWrite (
   // Write the memory buffer to spare block
   // Do not assume Spare Block and Target Block have same block size
   //
-  Status = FtwEraseSpareBlock (FtwDevice);
+  Status = FtwEraseBlock (FtwDevice, FtwDevice->FtwBackupFvb, FtwDevice->FtwSpareLba, NumberOfSpareBlocks);
   if (EFI_ERROR (Status)) {
     FreePool (MyBuffer);
     FreePool (SpareBuffer);
@@ -598,14 +610,14 @@ FtwWrite (
   //
   // Restore spare backup buffer into spare block , if no failure happened during FtwWrite.
   //
-  Status = FtwEraseSpareBlock (FtwDevice);
+  Status = FtwEraseBlock (FtwDevice, FtwDevice->FtwBackupFvb, FtwDevice->FtwSpareLba, NumberOfSpareBlocks);
   if (EFI_ERROR (Status)) {
     FreePool (SpareBuffer);
     return EFI_ABORTED;
   }
 
   Ptr = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; Index < NumberOfSpareBlocks; Index += 1) {
     MyLength = FtwDevice->SpareBlockSize;
     Status   = FtwDevice->FtwBackupFvb->Write (
                                           FtwDevice->FtwBackupFvb,
@@ -271,6 +271,27 @@ FtwGetLastWrite (
   OUT BOOLEAN                           *Complete
   );
 
+/**
+  To erase the block with specified blocks.
+
+
+  @param FtwDevice       The private data of FTW driver
+  @param FvBlock         FVB Protocol interface
+  @param Lba             Lba of the firmware block
+  @param NumberOfBlocks  The number of consecutive blocks starting with Lba
+
+  @retval  EFI_SUCCESS    Block LBA is Erased successfully
+  @retval  Others         Error occurs
+
+**/
+EFI_STATUS
+FtwEraseBlock (
+  IN EFI_FTW_DEVICE                   *FtwDevice,
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *FvBlock,
+  EFI_LBA                             Lba,
+  UINTN                               NumberOfBlocks
+  );
+
 /**
   Erase spare block.
 
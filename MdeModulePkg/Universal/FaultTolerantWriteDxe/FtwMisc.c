@@ -456,11 +456,51 @@ FlushSpareBlockToBootBlock (
   return Status;
 }
 
+/**
+  Check whether a target block already holds the given content.
+
+  @param FvBlock         FVB Protocol interface to access target block
+  @param Lba             Lba of the target block
+  @param BlockSize       The size of the block
+  @param Expected        The content the block should hold, BlockSize bytes
+  @param Scratch         A buffer of BlockSize bytes to read the block into
+
+  @retval  TRUE          The block holds the expected content.
+  @retval  FALSE         The block differs or could not be read.
+
+**/
+STATIC
+BOOLEAN
+IsTargetBlockUpToDate (
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *FvBlock,
+  EFI_LBA                             Lba,
+  UINTN                               BlockSize,
+  UINT8                               *Expected,
+  UINT8                               *Scratch
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Count;
+
+  Count  = BlockSize;
+  Status = FvBlock->Read (FvBlock, Lba, 0, &Count, Scratch);
+  if (EFI_ERROR (Status) || (Count != BlockSize)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(CompareMem (Scratch, Expected, BlockSize) == 0);
+}
+
 /**
   Copy the content of spare block to a target block.
   Spare block is accessed by FTW backup FVB protocol interface.
   Target block is accessed by FvBlock protocol interface.
 
+  Only the part of the spare area covering the target blocks is read. Target
+  blocks that already hold the spare content, such as the unchanged blocks of a
+  write spanning several blocks or the blocks already done by an interrupted
+  flush, are neither erased nor programmed. Each run of blocks that differ is
+  erased with a single erase request before it is programmed.
 
   @param FtwDevice       The private data of FTW driver
   @param FvBlock         FVB Protocol interface to access target block
@@ -486,29 +526,37 @@ FlushSpareBlockToTargetBlock (
   EFI_STATUS  Status;
   UINTN       Length;
   UINT8       *Buffer;
+  UINT8       *Scratch;
   UINTN       Count;
   UINT8       *Ptr;
   UINTN       Index;
+  UINTN       RunStart;
 
   if ((FtwDevice == NULL) || (FvBlock == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
+  Length = NumberOfBlocks * BlockSize;
+  if ((BlockSize == 0) || (Length / BlockSize != NumberOfBlocks) || (Length > FtwDevice->SpareAreaLength)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   //
-  // Allocate a memory buffer
+  // Allocate a memory buffer for the spare content, and one block to read the target into
   //
-  Length = FtwDevice->SpareAreaLength;
-  Buffer = AllocatePool (Length);
+  Buffer = AllocatePool (Length + BlockSize);
   if (Buffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Scratch = Buffer + Length;
+
   //
-  // Read all content of spare block to memory buffer
+  // Read the content of spare block covering the target blocks to memory buffer
   //
   Ptr = Buffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
-    Count  = FtwDevice->SpareBlockSize;
+  for (Index = 0; (UINTN)(Ptr - Buffer) < Length; Index += 1) {
+    Count  = MIN (FtwDevice->SpareBlockSize, Length - (UINTN)(Ptr - Buffer));
     Status = FtwDevice->FtwBackupFvb->Read (
                                         FtwDevice->FtwBackupFvb,
                                         FtwDevice->FtwSpareLba + Index,
@@ -524,29 +572,52 @@ FlushSpareBlockToTargetBlock (
     Ptr += Count;
   }
 
-  //
-  // Erase the target block
-  //
-  Status = FtwEraseBlock (FtwDevice, FvBlock, Lba, NumberOfBlocks);
-  if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
-    return EFI_ABORTED;
-  }
+  Status = EFI_SUCCESS;
+  Index  = 0;
+  while (Index < NumberOfBlocks) {
+    //
+    // Skip the target blocks that already hold the spare content
+    //
+    if (IsTargetBlockUpToDate (FvBlock, Lba + Index, BlockSize, Buffer + Index * BlockSize, Scratch)) {
+      Index += 1;
+      continue;
+    }
 
-  //
-  // Write memory buffer to block, using the FvBlock protocol interface
-  //
-  Ptr = Buffer;
-  for (Index = 0; Index < NumberOfBlocks; Index += 1) {
-    Count  = BlockSize;
-    Status = FvBlock->Write (FvBlock, Lba + Index, 0, &Count, Ptr);
+    RunStart = Index;
+    for (Index += 1; Index < NumberOfBlocks; Index += 1) {
+      if (IsTargetBlockUpToDate (FvBlock, Lba + Index, BlockSize, Buffer + Index * BlockSize, Scratch)) {
+        break;
+      }
+    }
+
+    //
+    // Erase the run of target blocks
+    //
+    Status = FtwEraseBlock (FtwDevice, FvBlock, Lba + RunStart, Index - RunStart);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "Ftw: FVB Write block - %r\n", Status));
       FreePool (Buffer);
-      return Status;
+      return EFI_ABORTED;
     }
 
-    Ptr += Count;
+    //
+    // Write memory buffer to the run of blocks, using the FvBlock protocol interface
+    //
+    for (Ptr = Buffer + RunStart * BlockSize; RunStart < Index; RunStart += 1) {
+      Count  = BlockSize;
+      Status = FvBlock->Write (FvBlock, Lba + RunStart, 0, &Count, Ptr);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "Ftw: FVB Write block - %r\n", Status));
+        FreePool (Buffer);
+        return Status;
+      }
+
+      Ptr += Count;
+    }
+
+    //
+    // The block ending the run is known to be up to date
+    //
+    Index += 1;
   }
 
   FreePool (Buffer);
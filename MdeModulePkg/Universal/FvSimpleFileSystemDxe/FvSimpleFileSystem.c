@@ -621,6 +621,10 @@ FvSimpleFileSystemClose (
 
   if (File != Instance->Root) {
     RemoveEntryList (&File->Link);
+    if (File->FileBuffer != NULL) {
+      FreePool (File->FileBuffer);
+    }
+
     FreePool (File);
   }
 
@@ -699,26 +703,32 @@ FvSimpleFileSystemRead (
   } else {
     FileSize = (UINTN)File->FvFileInfo->FileInfo.FileSize;
 
-    FileBuffer = AllocateZeroPool (FileSize);
-    if (FileBuffer == NULL) {
-      return EFI_DEVICE_ERROR;
-    }
+    //
+    // Read the file out of the FV on the first read only. Reading it may mean
+    // decompressing the whole file, so keep it until the file is closed.
+    //
+    if (File->FileBuffer == NULL) {
+      FileBuffer = AllocateZeroPool (FileSize);
+      if (FileBuffer == NULL) {
+        return EFI_DEVICE_ERROR;
+      }
 
-    Status = FvFsReadFile (File->Instance->FvProtocol, File->FvFileInfo, &FileSize, &FileBuffer);
-    if (EFI_ERROR (Status)) {
-      FreePool (FileBuffer);
-      return EFI_DEVICE_ERROR;
+      Status = FvFsReadFile (File->Instance->FvProtocol, File->FvFileInfo, &FileSize, &FileBuffer);
+      if (EFI_ERROR (Status)) {
+        FreePool (FileBuffer);
+        return EFI_DEVICE_ERROR;
+      }
+
+      File->FileBuffer = FileBuffer;
     }
 
     if (*BufferSize + File->Position > FileSize) {
       *BufferSize = (UINTN)(FileSize - File->Position);
     }
 
-    CopyMem (Buffer, (UINT8 *)FileBuffer + File->Position, *BufferSize);
+    CopyMem (Buffer, (UINT8 *)File->FileBuffer + File->Position, *BufferSize);
     File->Position += *BufferSize;
 
-    FreePool (FileBuffer);
-
     return EFI_SUCCESS;
   }
 }
@@ -64,6 +64,7 @@ struct _FV_FILESYSTEM_FILE {
   EFI_FILE_PROTOCOL          FileProtocol;
   FV_FILESYSTEM_FILE_INFO    *FvFileInfo;
   UINT64                     Position;
+  VOID                       *FileBuffer;
 };
 
 //
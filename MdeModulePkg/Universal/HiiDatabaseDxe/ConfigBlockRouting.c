@@ -0,0 +1,564 @@
+/** @file
+Implementation of EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL, which moves the
+settings of a buffer varstore as binary blocks instead of <ConfigResp> strings.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HiiDatabase.h"
+
+//
+// Length of "&OFFSET=XXXX&WIDTH=XXXX".
+//
+#define CONFIG_BLOCK_NAME_LENGTH  (8 + 4 + 7 + 4)
+
+/**
+  Check the blocks of an ExtractBlock() or RouteBlock() request and compute the
+  size of the smallest buffer that holds all of them.
+
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks of the request.
+  @param  BufferSize             Returns the end of the last byte of the blocks.
+
+  @retval EFI_SUCCESS            The blocks are valid.
+  @retval EFI_INVALID_PARAMETER  A block has a zero Width or a NULL Value.
+
+**/
+EFI_STATUS
+ValidateConfigBlocks (
+  IN  UINTN                         BlockCount,
+  IN  CONST EDKII_HII_CONFIG_BLOCK  *Blocks,
+  OUT UINTN                         *BufferSize
+  )
+{
+  UINTN  Index;
+
+  *BufferSize = 0;
+  for (Index = 0; Index < BlockCount; Index++) {
+    if ((Blocks[Index].Width == 0) || (Blocks[Index].Value == NULL)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    *BufferSize = MAX (*BufferSize, (UINTN)Blocks[Index].Offset + Blocks[Index].Width);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the package list and the driver that own a varstore, the same way
+  ExtractConfig() and RouteConfig() do for a <ConfigHdr>.
+
+  @param  Private                The HII database private data.
+  @param  VarStoreGuid           The GUID of the varstore.
+  @param  VarStoreName           The name of the varstore.
+  @param  DevicePath             The device path of the driver that owns the varstore.
+  @param  ConfigHdr              Returns the <ConfigHdr> of the varstore. It's
+                                 caller's responsibility to free this buffer.
+  @param  Database               Returns the package list that declares the
+                                 varstore, or NULL when there is none.
+  @param  DriverHandle           Returns the handle of the driver.
+
+  @retval EFI_SUCCESS            The driver is found.
+  @retval EFI_NOT_FOUND          No driver matches the device path.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory for the <ConfigHdr>.
+
+**/
+EFI_STATUS
+LocateConfigBlockVarStore (
+  IN  HII_DATABASE_PRIVATE_DATA  *Private,
+  IN  CONST EFI_GUID             *VarStoreGuid,
+  IN  CONST CHAR16               *VarStoreName,
+  IN  EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  OUT EFI_STRING                 *ConfigHdr,
+  OUT HII_DATABASE_RECORD        **Database,
+  OUT EFI_HANDLE                 *DriverHandle
+  )
+{
+  EFI_STATUS                Status;
+  IFR_VARSTORAGE_DATA       VarStorage;
+  LIST_ENTRY                *Link;
+  HII_DATABASE_RECORD       *Record;
+  UINT8                     *DevicePathPkg;
+  UINT8                     *CurrentDevicePath;
+  UINTN                     DevicePathSize;
+  EFI_DEVICE_PATH_PROTOCOL  *TempDevicePath;
+
+  *Database     = NULL;
+  *DriverHandle = NULL;
+
+  ZeroMem (&VarStorage, sizeof (VarStorage));
+  CopyGuid (&VarStorage.Guid, VarStoreGuid);
+  VarStorage.Name = (CHAR16 *)VarStoreName;
+  Status          = GenerateHdr (&VarStorage, DevicePath, ConfigHdr);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Record = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    if ((DevicePathPkg = Record->PackageList->DevicePathPkg) != NULL) {
+      CurrentDevicePath = DevicePathPkg + sizeof (EFI_HII_PACKAGE_HEADER);
+      if ((GetDevicePathSize ((EFI_DEVICE_PATH_PROTOCOL *)CurrentDevicePath) == DevicePathSize) &&
+          (CompareMem (DevicePath, CurrentDevicePath, DevicePathSize) == 0) &&
+          IsThisPackageList (Record, *ConfigHdr))
+      {
+        *Database     = Record;
+        *DriverHandle = Record->DriverHandle;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  //
+  // Try to find driver handle by device path.
+  //
+  TempDevicePath = DevicePath;
+  Status         = gBS->LocateDevicePath (&gEfiDevicePathProtocolGuid, &TempDevicePath, DriverHandle);
+  if (EFI_ERROR (Status) || (*DriverHandle == NULL)) {
+    FreePool (*ConfigHdr);
+    *ConfigHdr = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the EFI variable behind an efi varstore.
+
+  @param  EfiVarStoreInfo        The efi varstore.
+  @param  VarStoreName           Returns the name of the variable. It's caller's
+                                 responsibility to free this buffer.
+  @param  VarStore               Returns the content of the variable. It's caller's
+                                 responsibility to free this buffer.
+  @param  VarStoreSize           Returns the size of the variable.
+
+  @retval EFI_SUCCESS            The variable is read.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to read the variable.
+  @return Others                 The status returned by GetVariable().
+
+**/
+EFI_STATUS
+ReadConfigBlockEfiVarStore (
+  IN  EFI_IFR_VARSTORE_EFI  *EfiVarStoreInfo,
+  OUT CHAR16                **VarStoreName,
+  OUT UINT8                 **VarStore,
+  OUT UINTN                 *VarStoreSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       NameSize;
+
+  *VarStore     = NULL;
+  *VarStoreSize = 0;
+
+  NameSize      = AsciiStrSize ((CHAR8 *)EfiVarStoreInfo->Name);
+  *VarStoreName = AllocateZeroPool (NameSize * sizeof (CHAR16));
+  if (*VarStoreName == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS ((CHAR8 *)EfiVarStoreInfo->Name, *VarStoreName, NameSize);
+
+  Status = gRT->GetVariable (*VarStoreName, &EfiVarStoreInfo->Guid, NULL, VarStoreSize, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR (Status) ? Status : EFI_NOT_FOUND;
+  }
+
+  *VarStore = AllocateZeroPool (*VarStoreSize);
+  if (*VarStore == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return gRT->GetVariable (*VarStoreName, &EfiVarStoreInfo->Guid, NULL, VarStoreSize, *VarStore);
+}
+
+/**
+  Build the <ConfigRequest> of a set of blocks, for the drivers which only
+  install EFI_HII_CONFIG_ACCESS_PROTOCOL.
+
+  @param  ConfigHdr              The <ConfigHdr> of the varstore.
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks of the request.
+
+  @return The <ConfigRequest>, or NULL when there is not enough memory. It's
+          caller's responsibility to free this buffer.
+
+**/
+EFI_STRING
+GenerateConfigBlockRequest (
+  IN EFI_STRING                    ConfigHdr,
+  IN UINTN                         BlockCount,
+  IN CONST EDKII_HII_CONFIG_BLOCK  *Blocks
+  )
+{
+  EFI_STRING  ConfigRequest;
+  EFI_STRING  StringPtr;
+  UINTN       Length;
+  UINTN       Index;
+
+  Length        = StrLen (ConfigHdr) + BlockCount * CONFIG_BLOCK_NAME_LENGTH + 1;
+  ConfigRequest = AllocateZeroPool (Length * sizeof (CHAR16));
+  if (ConfigRequest == NULL) {
+    return NULL;
+  }
+
+  StrCpyS (ConfigRequest, Length, ConfigHdr);
+  StringPtr = ConfigRequest + StrLen (ConfigRequest);
+  for (Index = 0; Index < BlockCount; Index++) {
+    UnicodeSPrint (
+      StringPtr,
+      (CONFIG_BLOCK_NAME_LENGTH + 1) * sizeof (CHAR16),
+      L"&OFFSET=%04X&WIDTH=%04X",
+      Blocks[Index].Offset,
+      Blocks[Index].Width
+      );
+    StringPtr += StrLen (StringPtr);
+  }
+
+  HiiToLower (ConfigRequest);
+
+  return ConfigRequest;
+}
+
+/**
+  Read the current value of a set of blocks of a varstore.
+
+  Efi varstores are read with GetVariable() directly. Other varstores are read
+  through the EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL of the owning driver, or
+  through its EFI_HII_CONFIG_ACCESS_PROTOCOL when it only installs that one.
+
+  @param  This                   The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param  VarStoreGuid           The GUID of the varstore.
+  @param  VarStoreName           The name of the varstore.
+  @param  DevicePath             The device path of the driver that owns the varstore.
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks to read. On return, the Value buffer
+                                 of each block holds its current value.
+
+  @retval EFI_SUCCESS            All the blocks were read.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, BlockCount is 0, or a block
+                                 has a zero Width, a NULL Value or lies beyond the
+                                 varstore.
+  @retval EFI_NOT_FOUND          No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to complete the request.
+  @return Others                 The error returned by the driver that owns the varstore.
+
+**/
+EFI_STATUS
+EFIAPI
+HiiConfigBlockRoutingExtractBlock (
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN OUT   EDKII_HII_CONFIG_BLOCK                   *Blocks
+  )
+{
+  EFI_STATUS                              Status;
+  HII_DATABASE_PRIVATE_DATA               *Private;
+  HII_DATABASE_RECORD                     *Database;
+  EFI_HANDLE                              DriverHandle;
+  EFI_STRING                              ConfigHdr;
+  EFI_STRING                              ConfigRequest;
+  EFI_STRING                              AccessResults;
+  EFI_STRING                              AccessProgress;
+  BOOLEAN                                 IsEfiVarStore;
+  EFI_IFR_VARSTORE_EFI                    *EfiVarStoreInfo;
+  CHAR16                                  *EfiVarStoreName;
+  UINT8                                   *Buffer;
+  UINTN                                   BufferSize;
+  UINTN                                   RequiredSize;
+  UINTN                                   Index;
+  EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL  *BlockAccess;
+  EFI_HII_CONFIG_ACCESS_PROTOCOL          *ConfigAccess;
+
+  if ((This == NULL) || (VarStoreGuid == NULL) || (VarStoreName == NULL) ||
+      (DevicePath == NULL) || (BlockCount == 0) || (Blocks == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ValidateConfigBlocks (BlockCount, Blocks, &RequiredSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Private         = CONFIG_BLOCK_ROUTING_DATABASE_PRIVATE_DATA_FROM_THIS (This);
+  ConfigHdr       = NULL;
+  ConfigRequest   = NULL;
+  AccessResults   = NULL;
+  EfiVarStoreInfo = NULL;
+  EfiVarStoreName = NULL;
+  Buffer          = NULL;
+
+  Status = LocateConfigBlockVarStore (Private, VarStoreGuid, VarStoreName, DevicePath, &ConfigHdr, &Database, &DriverHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Efi varstore is read by the routing itself.
+  //
+  IsEfiVarStore = FALSE;
+  if (Database != NULL) {
+    Status = GetVarStoreType (Database, ConfigHdr, &IsEfiVarStore, &EfiVarStoreInfo);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+  }
+
+  if (IsEfiVarStore) {
+    Status = ReadConfigBlockEfiVarStore (EfiVarStoreInfo, &EfiVarStoreName, &Buffer, &BufferSize);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    if (RequiredSize > BufferSize) {
+      Status = EFI_INVALID_PARAMETER;
+      goto Done;
+    }
+
+    for (Index = 0; Index < BlockCount; Index++) {
+      CopyMem (Blocks[Index].Value, Buffer + Blocks[Index].Offset, Blocks[Index].Width);
+    }
+
+    goto Done;
+  }
+
+  Status = gBS->HandleProtocol (DriverHandle, &gEdkiiHiiConfigBlockAccessProtocolGuid, (VOID **)&BlockAccess);
+  if (!EFI_ERROR (Status)) {
+    Status = BlockAccess->ExtractBlock (BlockAccess, VarStoreGuid, VarStoreName, BlockCount, Blocks);
+    goto Done;
+  }
+
+  //
+  // The driver only understands <ConfigRequest> strings.
+  //
+  Status = gBS->HandleProtocol (DriverHandle, &gEfiHiiConfigAccessProtocolGuid, (VOID **)&ConfigAccess);
+  if (EFI_ERROR (Status)) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
+
+  ConfigRequest = GenerateConfigBlockRequest (ConfigHdr, BlockCount, Blocks);
+  Buffer        = AllocateZeroPool (RequiredSize);
+  if ((ConfigRequest == NULL) || (Buffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  Status = ConfigAccess->ExtractConfig (ConfigAccess, ConfigRequest, &AccessProgress, &AccessResults);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  BufferSize = RequiredSize;
+  Status     = HiiConfigToBlock (&Private->ConfigRouting, AccessResults, Buffer, &BufferSize, &AccessProgress);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Status = EFI_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  for (Index = 0; Index < BlockCount; Index++) {
+    CopyMem (Blocks[Index].Value, Buffer + Blocks[Index].Offset, Blocks[Index].Width);
+  }
+
+Done:
+  FreePool (ConfigHdr);
+
+  if (ConfigRequest != NULL) {
+    FreePool (ConfigRequest);
+  }
+
+  if (AccessResults != NULL) {
+    FreePool (AccessResults);
+  }
+
+  if (EfiVarStoreInfo != NULL) {
+    FreePool (EfiVarStoreInfo);
+  }
+
+  if (EfiVarStoreName != NULL) {
+    FreePool (EfiVarStoreName);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+
+  return Status;
+}
+
+/**
+  Write a set of blocks of a varstore. When blocks overlap, the later one wins.
+
+  Efi varstores are updated with GetVariable() and SetVariable() directly.
+  Other varstores are written through the EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL
+  of the owning driver, or through its EFI_HII_CONFIG_ACCESS_PROTOCOL when it
+  only installs that one.
+
+  @param  This                   The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param  VarStoreGuid           The GUID of the varstore.
+  @param  VarStoreName           The name of the varstore.
+  @param  DevicePath             The device path of the driver that owns the varstore.
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks to write.
+
+  @retval EFI_SUCCESS            All the blocks were written.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, BlockCount is 0, or a block
+                                 has a zero Width, a NULL Value or lies beyond the
+                                 varstore.
+  @retval EFI_NOT_FOUND          No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to complete the request.
+  @return Others                 The error returned by the driver that owns the varstore.
+
+**/
+EFI_STATUS
+EFIAPI
+HiiConfigBlockRoutingRouteBlock (
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN CONST EDKII_HII_CONFIG_BLOCK                   *Blocks
+  )
+{
+  EFI_STATUS                              Status;
+  HII_DATABASE_PRIVATE_DATA               *Private;
+  HII_DATABASE_RECORD                     *Database;
+  EFI_HANDLE                              DriverHandle;
+  EFI_STRING                              ConfigHdr;
+  EFI_STRING                              ConfigRequest;
+  EFI_STRING                              ConfigResp;
+  EFI_STRING                              AccessProgress;
+  BOOLEAN                                 IsEfiVarStore;
+  EFI_IFR_VARSTORE_EFI                    *EfiVarStoreInfo;
+  CHAR16                                  *EfiVarStoreName;
+  UINT8                                   *Buffer;
+  UINTN                                   BufferSize;
+  UINTN                                   RequiredSize;
+  UINTN                                   Index;
+  EDKII_HII_CONFIG_BLOCK_ACCESS_PROTOCOL  *BlockAccess;
+  EFI_HII_CONFIG_ACCESS_PROTOCOL          *ConfigAccess;
+
+  if ((This == NULL) || (VarStoreGuid == NULL) || (VarStoreName == NULL) ||
+      (DevicePath == NULL) || (BlockCount == 0) || (Blocks == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ValidateConfigBlocks (BlockCount, Blocks, &RequiredSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Private         = CONFIG_BLOCK_ROUTING_DATABASE_PRIVATE_DATA_FROM_THIS (This);
+  ConfigHdr       = NULL;
+  ConfigRequest   = NULL;
+  ConfigResp      = NULL;
+  EfiVarStoreInfo = NULL;
+  EfiVarStoreName = NULL;
+  Buffer          = NULL;
+
+  Status = LocateConfigBlockVarStore (Private, VarStoreGuid, VarStoreName, DevicePath, &ConfigHdr, &Database, &DriverHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Efi varstore is updated by the routing itself.
+  //
+  IsEfiVarStore = FALSE;
+  if (Database != NULL) {
+    Status = GetVarStoreType (Database, ConfigHdr, &IsEfiVarStore, &EfiVarStoreInfo);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+  }
+
+  if (IsEfiVarStore) {
+    Status = ReadConfigBlockEfiVarStore (EfiVarStoreInfo, &EfiVarStoreName, &Buffer, &BufferSize);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    if (RequiredSize > BufferSize) {
+      Status = EFI_INVALID_PARAMETER;
+      goto Done;
+    }
+
+    for (Index = 0; Index < BlockCount; Index++) {
+      CopyMem (Buffer + Blocks[Index].Offset, Blocks[Index].Value, Blocks[Index].Width);
+    }
+
+    Status = gRT->SetVariable (EfiVarStoreName, &EfiVarStoreInfo->Guid, EfiVarStoreInfo->Attributes, BufferSize, Buffer);
+    goto Done;
+  }
+
+  Status = gBS->HandleProtocol (DriverHandle, &gEdkiiHiiConfigBlockAccessProtocolGuid, (VOID **)&BlockAccess);
+  if (!EFI_ERROR (Status)) {
+    Status = BlockAccess->RouteBlock (BlockAccess, VarStoreGuid, VarStoreName, BlockCount, Blocks);
+    goto Done;
+  }
+
+  //
+  // The driver only understands <ConfigResp> strings.
+  //
+  Status = gBS->HandleProtocol (DriverHandle, &gEfiHiiConfigAccessProtocolGuid, (VOID **)&ConfigAccess);
+  if (EFI_ERROR (Status)) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
+
+  ConfigRequest = GenerateConfigBlockRequest (ConfigHdr, BlockCount, Blocks);
+  Buffer        = AllocateZeroPool (RequiredSize);
+  if ((ConfigRequest == NULL) || (Buffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  for (Index = 0; Index < BlockCount; Index++) {
+    CopyMem (Buffer + Blocks[Index].Offset, Blocks[Index].Value, Blocks[Index].Width);
+  }
+
+  Status = HiiBlockToConfig (&Private->ConfigRouting, ConfigRequest, Buffer, RequiredSize, &ConfigResp, &AccessProgress);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = ConfigAccess->RouteConfig (ConfigAccess, ConfigResp, &AccessProgress);
+
+Done:
+  FreePool (ConfigHdr);
+
+  if (ConfigRequest != NULL) {
+    FreePool (ConfigRequest);
+  }
+
+  if (ConfigResp != NULL) {
+    FreePool (ConfigResp);
+  }
+
+  if (EfiVarStoreInfo != NULL) {
+    FreePool (EfiVarStoreInfo);
+  }
+
+  if (EfiVarStoreName != NULL) {
+    FreePool (EfiVarStoreName);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+
+  return Status;
+}
@@ -9,6 +9,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "HiiDatabase.h"
 extern HII_DATABASE_PRIVATE_DATA  mPrivate;
 
+//
+// Results of previous IFR parses, in least recently used order.
+//
+LIST_ENTRY  mIfrDefaultCacheList      = INITIALIZE_LIST_HEAD_VARIABLE (mIfrDefaultCacheList);
+UINTN       mIfrDefaultCacheCount     = 0;
+CHAR8       *mIfrDefaultCacheLanguage = NULL;
+
 /**
   Calculate the number of Unicode characters of the incoming Configuration string,
   not including NULL terminator.
@@ -4114,6 +4121,256 @@ GenerateAltConfigResp (
   return EFI_SUCCESS;
 }
 
+/**
+  Free one cached IFR default entry.
+
+  @param  CacheEntry             The cache entry to be freed.
+
+**/
+VOID
+FreeIfrDefaultCacheEntry (
+  IN IFR_DEFAULT_CACHE_ENTRY  *CacheEntry
+  )
+{
+  RemoveEntryList (&CacheEntry->Entry);
+  mIfrDefaultCacheCount--;
+
+  FreePool (CacheEntry->DevicePath);
+  if (CacheEntry->Request != NULL) {
+    FreePool (CacheEntry->Request);
+  }
+
+  if (CacheEntry->FullRequest != NULL) {
+    FreePool (CacheEntry->FullRequest);
+  }
+
+  if (CacheEntry->DefaultAltCfgResp != NULL) {
+    FreePool (CacheEntry->DefaultAltCfgResp);
+  }
+
+  FreePool (CacheEntry);
+}
+
+/**
+  Drop the cached IFR default strings of one package list, or of all package
+  lists when Handle is NULL. It must be called whenever the form or string
+  packages of a package list change.
+
+  @param  Handle                 The package list whose entries are dropped,
+                                 or NULL to drop the whole cache.
+
+**/
+VOID
+InvalidateIfrDefaultCache (
+  IN EFI_HII_HANDLE  Handle OPTIONAL
+  )
+{
+  LIST_ENTRY               *Link;
+  IFR_DEFAULT_CACHE_ENTRY  *CacheEntry;
+
+  Link = GetFirstNode (&mIfrDefaultCacheList);
+  while (!IsNull (&mIfrDefaultCacheList, Link)) {
+    CacheEntry = BASE_CR (Link, IFR_DEFAULT_CACHE_ENTRY, Entry);
+    Link       = GetNextNode (&mIfrDefaultCacheList, Link);
+    if ((Handle == NULL) || (CacheEntry->Handle == Handle)) {
+      FreeIfrDefaultCacheEntry (CacheEntry);
+    }
+  }
+}
+
+/**
+  Look up the result of a previous IFR parse for the same package list,
+  device path and request string.
+
+  The default string of a string question is read in the current platform
+  language, so the whole cache is dropped when PlatformLang has changed since
+  the cache was filled.
+
+  @param  DataBaseRecord         The DataBaseRecord instance contains the Hii handle.
+  @param  DevicePath             Device Path which Hii Config Access Protocol is registered.
+  @param  Request                Pointer to the request string. When the cached
+                                 parse expanded the request, it is replaced by
+                                 a copy of the full request string.
+  @param  DefaultAltCfgResp      Returns a copy of the cached default value
+                                 string, or NULL when the parse produced none.
+
+  @retval EFI_SUCCESS            The cached result is returned.
+  @retval EFI_NOT_FOUND          No cached result matches the input.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to copy the cached strings.
+
+**/
+EFI_STATUS
+GetIfrDefaultFromCache (
+  IN     HII_DATABASE_RECORD       *DataBaseRecord,
+  IN     EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN OUT EFI_STRING                *Request,
+  OUT    EFI_STRING                *DefaultAltCfgResp
+  )
+{
+  LIST_ENTRY               *Link;
+  IFR_DEFAULT_CACHE_ENTRY  *CacheEntry;
+  CHAR8                    *PlatformLanguage;
+  UINTN                    DevicePathSize;
+  EFI_STRING               FullRequest;
+
+  *DefaultAltCfgResp = NULL;
+
+  if (IsListEmpty (&mIfrDefaultCacheList)) {
+    return EFI_NOT_FOUND;
+  }
+
+  PlatformLanguage = NULL;
+  GetEfiGlobalVariable2 (L"PlatformLang", (VOID **)&PlatformLanguage, NULL);
+  if (AsciiStrCmp (
+        PlatformLanguage != NULL ? PlatformLanguage : "",
+        mIfrDefaultCacheLanguage != NULL ? mIfrDefaultCacheLanguage : ""
+        ) != 0)
+  {
+    InvalidateIfrDefaultCache (NULL);
+  }
+
+  if (PlatformLanguage != NULL) {
+    FreePool (PlatformLanguage);
+  }
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  for (Link = GetFirstNode (&mIfrDefaultCacheList); !IsNull (&mIfrDefaultCacheList, Link); Link = GetNextNode (&mIfrDefaultCacheList, Link)) {
+    CacheEntry = BASE_CR (Link, IFR_DEFAULT_CACHE_ENTRY, Entry);
+    if ((CacheEntry->Handle != DataBaseRecord->Handle) ||
+        (GetDevicePathSize (CacheEntry->DevicePath) != DevicePathSize) ||
+        (CompareMem (CacheEntry->DevicePath, DevicePath, DevicePathSize) != 0))
+    {
+      continue;
+    }
+
+    if ((CacheEntry->Request == NULL) || (*Request == NULL)) {
+      if (CacheEntry->Request != *Request) {
+        continue;
+      }
+    } else if (StrCmp (CacheEntry->Request, *Request) != 0) {
+      continue;
+    }
+
+    FullRequest = NULL;
+    if (CacheEntry->FullRequest != NULL) {
+      FullRequest = AllocateCopyPool (StrSize (CacheEntry->FullRequest), CacheEntry->FullRequest);
+      if (FullRequest == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+
+    if (CacheEntry->DefaultAltCfgResp != NULL) {
+      *DefaultAltCfgResp = AllocateCopyPool (StrSize (CacheEntry->DefaultAltCfgResp), CacheEntry->DefaultAltCfgResp);
+      if (*DefaultAltCfgResp == NULL) {
+        if (FullRequest != NULL) {
+          FreePool (FullRequest);
+        }
+
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+
+    if (FullRequest != NULL) {
+      if (*Request != NULL) {
+        FreePool (*Request);
+      }
+
+      *Request = FullRequest;
+    }
+
+    //
+    // Keep the list in least recently used order.
+    //
+    RemoveEntryList (&CacheEntry->Entry);
+    InsertTailList (&mIfrDefaultCacheList, &CacheEntry->Entry);
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Save the result of an IFR parse, so that the next extraction of the same
+  request only has to copy the strings. The cache is best effort: nothing is
+  saved when memory can't be allocated.
+
+  @param  DataBaseRecord         The DataBaseRecord instance contains the Hii handle.
+  @param  DevicePath             Device Path which Hii Config Access Protocol is registered.
+  @param  Request                The request string given to the parse, may be NULL.
+  @param  FullRequest            The request string returned by the parse, may be NULL.
+  @param  DefaultAltCfgResp      The default value string produced by the parse,
+                                 may be NULL.
+
+**/
+VOID
+AddIfrDefaultToCache (
+  IN HII_DATABASE_RECORD       *DataBaseRecord,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN EFI_STRING                Request            OPTIONAL,
+  IN EFI_STRING                FullRequest        OPTIONAL,
+  IN EFI_STRING                DefaultAltCfgResp  OPTIONAL
+  )
+{
+  IFR_DEFAULT_CACHE_ENTRY  *CacheEntry;
+
+  if (IsListEmpty (&mIfrDefaultCacheList)) {
+    //
+    // Record the platform language the cached default strings are read in.
+    //
+    if (mIfrDefaultCacheLanguage != NULL) {
+      FreePool (mIfrDefaultCacheLanguage);
+      mIfrDefaultCacheLanguage = NULL;
+    }
+
+    GetEfiGlobalVariable2 (L"PlatformLang", (VOID **)&mIfrDefaultCacheLanguage, NULL);
+  }
+
+  if (mIfrDefaultCacheCount >= IFR_DEFAULT_CACHE_MAX_COUNT) {
+    FreeIfrDefaultCacheEntry (BASE_CR (GetFirstNode (&mIfrDefaultCacheList), IFR_DEFAULT_CACHE_ENTRY, Entry));
+  }
+
+  CacheEntry = AllocateZeroPool (sizeof (IFR_DEFAULT_CACHE_ENTRY));
+  if (CacheEntry == NULL) {
+    return;
+  }
+
+  CacheEntry->DevicePath = DuplicateDevicePath (DevicePath);
+  if (CacheEntry->DevicePath == NULL) {
+    FreePool (CacheEntry);
+    return;
+  }
+
+  CacheEntry->Handle = DataBaseRecord->Handle;
+  InsertTailList (&mIfrDefaultCacheList, &CacheEntry->Entry);
+  mIfrDefaultCacheCount++;
+
+  if (Request != NULL) {
+    CacheEntry->Request = AllocateCopyPool (StrSize (Request), Request);
+    if (CacheEntry->Request == NULL) {
+      FreeIfrDefaultCacheEntry (CacheEntry);
+      return;
+    }
+  }
+
+  //
+  // Only keep the returned request when the parse has expanded it.
+  //
+  if ((FullRequest != NULL) && ((Request == NULL) || (StrCmp (Request, FullRequest) != 0))) {
+    CacheEntry->FullRequest = AllocateCopyPool (StrSize (FullRequest), FullRequest);
+    if (CacheEntry->FullRequest == NULL) {
+      FreeIfrDefaultCacheEntry (CacheEntry);
+      return;
+    }
+  }
+
+  if (DefaultAltCfgResp != NULL) {
+    CacheEntry->DefaultAltCfgResp = AllocateCopyPool (StrSize (DefaultAltCfgResp), DefaultAltCfgResp);
+    if (CacheEntry->DefaultAltCfgResp == NULL) {
+      FreeIfrDefaultCacheEntry (CacheEntry);
+    }
+  }
+}
+
 /**
   This function gets the full request string and full default value string by
   parsing IFR data in HII form packages.
@@ -4180,6 +4437,8 @@ GetFullStringFromHiiFormPackages (
   EFI_STRING           ConfigHdr;
   EFI_STRING           StringPtr;
   EFI_STRING           Progress;
+  EFI_STRING           CacheRequest;
+  BOOLEAN              Cacheable;
 
   if ((DataBaseRecord == NULL) || (DevicePath == NULL) || (Request == NULL) || (AltCfgResp == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -4196,6 +4455,27 @@ GetFullStringFromHiiFormPackages (
   HiiFormPackage    = NULL;
   PackageSize       = 0;
   Progress          = *Request;
+  CacheRequest      = NULL;
+  Cacheable         = FALSE;
+
+  //
+  // Reuse the result of a previous parse of the same request when it is cached.
+  //
+  Status = GetIfrDefaultFromCache (DataBaseRecord, DevicePath, Request, &DefaultAltCfgResp);
+  if (Status == EFI_SUCCESS) {
+    goto MergeDefault;
+  } else if (Status != EFI_NOT_FOUND) {
+    goto Done;
+  }
+
+  //
+  // Keep the input request, GenerateConfigRequest() may free it.
+  //
+  Cacheable = TRUE;
+  if (*Request != NULL) {
+    CacheRequest = AllocateCopyPool (StrSize (*Request), *Request);
+    Cacheable    = (BOOLEAN)(CacheRequest != NULL);
+  }
 
   Status = GetFormPackageData (DataBaseRecord, &HiiFormPackage, &PackageSize);
   if (EFI_ERROR (Status)) {
@@ -4312,6 +4592,10 @@ GetFullStringFromHiiFormPackages (
   // No requested varstore in IFR data and directly return
   //
   if ((VarStorageData->Type == 0) && (VarStorageData->Name == NULL)) {
+    if (Cacheable) {
+      AddIfrDefaultToCache (DataBaseRecord, DevicePath, CacheRequest, *Request, NULL);
+    }
+
     Status = EFI_SUCCESS;
     goto Done;
   }
@@ -4340,9 +4624,14 @@ GetFullStringFromHiiFormPackages (
     goto Done;
   }
 
+  if (Cacheable) {
+    AddIfrDefaultToCache (DataBaseRecord, DevicePath, CacheRequest, *Request, DefaultAltCfgResp);
+  }
+
   //
   // 5. Merge string into the input AltCfgResp if the input *AltCfgResp is not NULL.
   //
+MergeDefault:
   if ((*AltCfgResp != NULL) && (DefaultAltCfgResp != NULL)) {
     Status = MergeDefaultString (AltCfgResp, DefaultAltCfgResp);
     FreePool (DefaultAltCfgResp);
@@ -4426,6 +4715,10 @@ Done:
     FreePool (HiiFormPackage);
   }
 
+  if (CacheRequest != NULL) {
+    FreePool (CacheRequest);
+  }
+
   if (PointerProgress != NULL) {
     if (*Request == NULL) {
       *PointerProgress = NULL;
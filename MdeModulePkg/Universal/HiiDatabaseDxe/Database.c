@@ -1536,6 +1536,7 @@ AdjustStringPackage (
       // Append a EFI_HII_SIBT_END block to the end.
       //
       *BlockPtr = EFI_HII_SIBT_END;
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = StringBlock;
       StringPackage->StringPkgHdr->Header.Length += Skip2BlockSize;
@@ -1676,6 +1677,7 @@ RemoveStringPackages (
 
     RemoveEntryList (&Package->StringEntry);
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
+    InvalidateStringBlockIndex (Package);
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
     //
@@ -1826,6 +1828,7 @@ InsertFontPackage (
   //
   InsertTailList (&PackageList->FontPkgHdr, &FontPackage->FontEntry);
   *Package = FontPackage;
+  InvalidateGlyphCache ();
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
     PackageList->PackageListHdr.PackageLength += FontPackage->FontPkgHdr->Header.Length;
@@ -1989,6 +1992,7 @@ RemoveFontPackages (
 
     RemoveEntryList (&Package->FontEntry);
     PackageList->PackageListHdr.PackageLength -= Package->FontPkgHdr->Header.Length;
+    InvalidateGlyphCache ();
 
     if (Package->GlyphBlock != NULL) {
       FreePool (Package->GlyphBlock);
@@ -2366,6 +2370,7 @@ InsertSimpleFontPackage (
   //
   InsertTailList (&PackageList->SimpleFontPkgHdr, &SimpleFontPackage->SimpleFontEntry);
   *Package = SimpleFontPackage;
+  InvalidateGlyphCache ();
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
     PackageList->PackageListHdr.PackageLength += Header.Length;
@@ -2505,6 +2510,7 @@ RemoveSimpleFontPackages (
 
     RemoveEntryList (&Package->SimpleFontEntry);
     PackageList->PackageListHdr.PackageLength -= Package->SimpleFontPkgHdr->Header.Length;
+    InvalidateGlyphCache ();
     FreePool (Package->SimpleFontPkgHdr);
     FreePool (Package);
   }
@@ -3682,6 +3688,8 @@ HiiRemovePackageList (
 
   Private = HII_DATABASE_DATABASE_PRIVATE_DATA_FROM_THIS (This);
 
+  InvalidateIfrDefaultCache (Handle);
+
   //
   // Get the packagelist to be removed.
   //
@@ -3842,6 +3850,9 @@ HiiUpdatePackageList (
   Status = EFI_SUCCESS;
 
   EfiAcquireLock (&mHiiDatabaseLock);
+
+  InvalidateIfrDefaultCache (Handle);
+
   //
   // Get original packagelist to be updated
   //
@@ -31,6 +31,12 @@ EFI_GRAPHICS_OUTPUT_BLT_PIXEL  mHiiEfiColors[16] = {
   { 0xff, 0xff, 0xff, 0x00 },  // WHITE
 };
 
+//
+// Glyphs found by GetGlyphBuffer(), indexed by font package and character.
+//
+HII_GLYPH_CACHE_ENTRY  *mGlyphCache[HII_GLYPH_CACHE_SIZE];
+UINTN                  mGlyphCacheCount = 0;
+
 /**
   Insert a character cell information to the list specified by GlyphInfoList.
 
@@ -128,33 +134,110 @@ GetCell (
 }
 
 /**
-  Convert the glyph for a single character into a bitmap.
+  Drop all glyphs cached by GetGlyphBuffer(). It must be called whenever a
+  font or simplified font package is added to or removed from the database.
+
+**/
+VOID
+InvalidateGlyphCache (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  if (mGlyphCacheCount == 0) {
+    return;
+  }
+
+  for (Index = 0; Index < HII_GLYPH_CACHE_SIZE; Index++) {
+    if (mGlyphCache[Index] != NULL) {
+      FreePool (mGlyphCache[Index]);
+      mGlyphCache[Index] = NULL;
+    }
+  }
+
+  mGlyphCacheCount = 0;
+}
+
+/**
+  Remember the glyph found for a character so that later lookups of the same
+  character in the same font skip the walk over the font packages. The cache
+  is best effort: the glyph is silently not cached when memory runs out.
+
+  This is a internal function.
+
+  @param  FontPackage             The font package the glyph was found in, or
+                                  NULL for the simplified font packages.
+  @param  Char                    Character of the glyph.
+  @param  GlyphBuffer             Bitmap data of the glyph.
+  @param  GlyphBufferLen          Length of GlyphBuffer.
+  @param  Cell                    Cell information of the glyph.
+  @param  Attributes              Attributes of the glyph.
+
+**/
+VOID
+AddGlyphToCache (
+  IN HII_FONT_PACKAGE_INSTANCE  *FontPackage OPTIONAL,
+  IN CHAR16                     Char,
+  IN UINT8                      *GlyphBuffer,
+  IN UINTN                      GlyphBufferLen,
+  IN EFI_HII_GLYPH_INFO         *Cell,
+  IN UINT8                      Attributes
+  )
+{
+  HII_GLYPH_CACHE_ENTRY  *CacheEntry;
+  UINTN                  Index;
+
+  CacheEntry = AllocatePool (OFFSET_OF (HII_GLYPH_CACHE_ENTRY, GlyphBuffer) + GlyphBufferLen);
+  if (CacheEntry == NULL) {
+    return;
+  }
+
+  CacheEntry->FontPackage    = FontPackage;
+  CacheEntry->CharValue      = Char;
+  CacheEntry->Attributes     = Attributes;
+  CacheEntry->GlyphBufferLen = GlyphBufferLen;
+  CopyMem (&CacheEntry->Cell, Cell, sizeof (EFI_HII_GLYPH_INFO));
+  CopyMem (CacheEntry->GlyphBuffer, GlyphBuffer, GlyphBufferLen);
+
+  Index = HII_GLYPH_CACHE_INDEX (FontPackage, Char);
+  if (mGlyphCache[Index] != NULL) {
+    FreePool (mGlyphCache[Index]);
+  } else {
+    mGlyphCacheCount++;
+  }
+
+  mGlyphCache[Index] = CacheEntry;
+}
+
+/**
+  Look up the glyph for a single character in the font packages.
 
   This is a internal function.
 
   @param  Private                 HII database driver private data.
   @param  Char                    Character to retrieve.
-  @param  StringInfo              Points to the string font and color information
-                                  or NULL  if the string should use the default
-                                  system font and color.
+  @param  FontPackage             The font package to search, or NULL to search
+                                  the simplified font packages.
   @param  GlyphBuffer             Buffer to store the retrieved bitmap data.
   @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
-  @param  Attributes              If not NULL, output the glyph attributes if any.
+  @param  Attributes              Output the glyph attributes.
+  @param  GlyphBufferLen          Output the length of GlyphBuffer.
 
   @retval EFI_SUCCESS             Glyph bitmap outputted.
   @retval EFI_OUT_OF_RESOURCES    Unable to allocate the output buffer GlyphBuffer.
   @retval EFI_NOT_FOUND           The glyph was unknown can not be found.
-  @retval EFI_INVALID_PARAMETER   Any input parameter is invalid.
 
 **/
 EFI_STATUS
-GetGlyphBuffer (
+FindGlyphInPackages (
   IN  HII_DATABASE_PRIVATE_DATA  *Private,
   IN  CHAR16                     Char,
-  IN  EFI_FONT_INFO              *StringInfo,
+  IN  HII_FONT_PACKAGE_INSTANCE  *FontPackage OPTIONAL,
   OUT UINT8                      **GlyphBuffer,
   OUT EFI_HII_GLYPH_INFO         *Cell,
-  OUT UINT8                      *Attributes OPTIONAL
+  OUT UINT8                      *Attributes,
+  OUT UINTN                      *GlyphBufferLen
   )
 {
   HII_DATABASE_RECORD               *Node;
@@ -164,11 +247,115 @@ GetGlyphBuffer (
   UINT16                            Index;
   EFI_NARROW_GLYPH                  Narrow;
   EFI_WIDE_GLYPH                    Wide;
-  HII_GLOBAL_FONT_INFO              *GlobalFont;
   UINTN                             HeaderSize;
   EFI_NARROW_GLYPH                  *NarrowPtr;
   EFI_WIDE_GLYPH                    *WidePtr;
 
+  if (FontPackage != NULL) {
+    *Attributes = PROPORTIONAL_GLYPH;
+    return FindGlyphBlock (FontPackage, Char, GlyphBuffer, Cell, GlyphBufferLen);
+  }
+
+  HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
+         Link1 != &Node->PackageList->SimpleFontPkgHdr;
+         Link1 = Link1->ForwardLink
+         )
+    {
+      SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
+      //
+      // Search the narrow glyph array
+      //
+      NarrowPtr = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + HeaderSize);
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
+        CopyMem (&Narrow, NarrowPtr + Index, sizeof (EFI_NARROW_GLYPH));
+        if (Narrow.UnicodeWeight == Char) {
+          *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
+          if (*GlyphBuffer == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+          }
+
+          Cell->Width    = EFI_GLYPH_WIDTH;
+          Cell->Height   = EFI_GLYPH_HEIGHT;
+          Cell->AdvanceX = Cell->Width;
+          CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
+          *Attributes     = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
+          *GlyphBufferLen = EFI_GLYPH_HEIGHT;
+          return EFI_SUCCESS;
+        }
+      }
+
+      //
+      // Search the wide glyph array
+      //
+      WidePtr = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
+        CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
+        if (Wide.UnicodeWeight == Char) {
+          *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
+          if (*GlyphBuffer == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+          }
+
+          Cell->Width    = EFI_GLYPH_WIDTH * 2;
+          Cell->Height   = EFI_GLYPH_HEIGHT;
+          Cell->AdvanceX = Cell->Width;
+          CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
+          CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
+          *Attributes     = (UINT8)(Wide.Attributes | EFI_GLYPH_WIDE);
+          *GlyphBufferLen = EFI_GLYPH_HEIGHT * 2;
+          return EFI_SUCCESS;
+        }
+      }
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Convert the glyph for a single character into a bitmap.
+
+  Glyphs found in the font packages are cached per font, so that redrawing a
+  page does not walk the font packages again for every character.
+
+  This is a internal function.
+
+  @param  Private                 HII database driver private data.
+  @param  Char                    Character to retrieve.
+  @param  StringInfo              Points to the string font and color information
+                                  or NULL  if the string should use the default
+                                  system font and color.
+  @param  GlyphBuffer             Buffer to store the retrieved bitmap data.
+  @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
+  @param  Attributes              If not NULL, output the glyph attributes if any.
+
+  @retval EFI_SUCCESS             Glyph bitmap outputted.
+  @retval EFI_OUT_OF_RESOURCES    Unable to allocate the output buffer GlyphBuffer.
+  @retval EFI_NOT_FOUND           The glyph was unknown can not be found.
+  @retval EFI_INVALID_PARAMETER   Any input parameter is invalid.
+
+**/
+EFI_STATUS
+GetGlyphBuffer (
+  IN  HII_DATABASE_PRIVATE_DATA  *Private,
+  IN  CHAR16                     Char,
+  IN  EFI_FONT_INFO              *StringInfo,
+  OUT UINT8                      **GlyphBuffer,
+  OUT EFI_HII_GLYPH_INFO         *Cell,
+  OUT UINT8                      *Attributes OPTIONAL
+  )
+{
+  EFI_STATUS                 Status;
+  HII_GLOBAL_FONT_INFO       *GlobalFont;
+  HII_FONT_PACKAGE_INSTANCE  *FontPackage;
+  HII_GLYPH_CACHE_ENTRY      *CacheEntry;
+  UINT8                      GlyphAttributes;
+  UINTN                      GlyphBufferLen;
+
   if ((GlyphBuffer == NULL) || (Cell == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
@@ -185,80 +372,60 @@ GetGlyphBuffer (
   // If NULL, try to find the character in simplified font packages since
   // default system font is the fixed font (narrow or wide glyph).
   //
+  FontPackage = NULL;
   if (StringInfo != NULL) {
     if (!IsFontInfoExisted (Private, StringInfo, NULL, NULL, &GlobalFont)) {
       return EFI_INVALID_PARAMETER;
     }
 
-    if (Attributes != NULL) {
-      *Attributes = PROPORTIONAL_GLYPH;
-    }
-
-    return FindGlyphBlock (GlobalFont->FontPackage, Char, GlyphBuffer, Cell, NULL);
-  } else {
-    HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
-
-    for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
-      Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
-      for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
-           Link1 != &Node->PackageList->SimpleFontPkgHdr;
-           Link1 = Link1->ForwardLink
-           )
-      {
-        SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
-        //
-        // Search the narrow glyph array
-        //
-        NarrowPtr = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + HeaderSize);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
-          CopyMem (&Narrow, NarrowPtr + Index, sizeof (EFI_NARROW_GLYPH));
-          if (Narrow.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
+    FontPackage = GlobalFont->FontPackage;
+  }
 
-            Cell->Width    = EFI_GLYPH_WIDTH;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
-            }
+  CacheEntry = mGlyphCache[HII_GLYPH_CACHE_INDEX (FontPackage, Char)];
+  if ((CacheEntry != NULL) && (CacheEntry->FontPackage == FontPackage) && (CacheEntry->CharValue == Char)) {
+    if (CacheEntry->GlyphBufferLen > 0) {
+      *GlyphBuffer = AllocateCopyPool (CacheEntry->GlyphBufferLen, CacheEntry->GlyphBuffer);
+      if (*GlyphBuffer == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
 
-            return EFI_SUCCESS;
-          }
-        }
+    CopyMem (Cell, &CacheEntry->Cell, sizeof (EFI_HII_GLYPH_INFO));
+    if (Attributes != NULL) {
+      *Attributes = CacheEntry->Attributes;
+    }
 
-        //
-        // Search the wide glyph array
-        //
-        WidePtr = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
-          CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
-          if (Wide.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
+    return EFI_SUCCESS;
+  }
 
-            Cell->Width    = EFI_GLYPH_WIDTH * 2;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
-            CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Wide.Attributes | EFI_GLYPH_WIDE);
-            }
+  GlyphBufferLen = 0;
+  Status         = FindGlyphInPackages (
+                     Private,
+                     Char,
+                     FontPackage,
+                     GlyphBuffer,
+                     Cell,
+                     &GlyphAttributes,
+                     &GlyphBufferLen
+                     );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-            return EFI_SUCCESS;
-          }
-        }
-      }
-    }
+  if (Attributes != NULL) {
+    *Attributes = GlyphAttributes;
   }
 
-  return EFI_NOT_FOUND;
+  AddGlyphToCache (
+    FontPackage,
+    Char,
+    (GlyphBufferLen > 0) ? *GlyphBuffer : NULL,
+    GlyphBufferLen,
+    Cell,
+    GlyphAttributes
+    );
+
+  return EFI_SUCCESS;
 }
 
 /**
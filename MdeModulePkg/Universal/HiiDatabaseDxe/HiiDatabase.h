@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiConfigRouting.h>
 #include <Protocol/HiiConfigAccess.h>
 #include <Protocol/HiiConfigKeyword.h>
+#include <Protocol/HiiConfigBlock.h>
 #include <Protocol/SimpleTextOut.h>
 
 #include <Guid/HiiKeyBoardLayout.h>
@@ -112,6 +113,20 @@ typedef struct {
   EFI_IFR_TYPE_VALUE    Value;
 } IFR_DEFAULT_DATA;
 
+//
+// Result of one IFR parse done to extract the default settings of a request.
+//
+#define IFR_DEFAULT_CACHE_MAX_COUNT  0x40
+
+typedef struct {
+  LIST_ENTRY                  Entry;
+  EFI_HII_HANDLE              Handle;
+  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  EFI_STRING                  Request;           // Request string given to the parse, may be NULL
+  EFI_STRING                  FullRequest;       // Expanded request string, NULL when not expanded
+  EFI_STRING                  DefaultAltCfgResp; // Default value string, may be NULL
+} IFR_DEFAULT_CACHE_ENTRY;
+
 //
 // Storage types
 //
@@ -150,14 +165,27 @@ typedef struct {
 // String Package definitions
 //
 #define HII_STRING_PACKAGE_SIGNATURE  SIGNATURE_32 ('h','i','s','p')
+
+//
+// Location of the string block holding one StringId. BlockType is
+// EFI_HII_SIBT_END if the StringId has no string text.
+//
+typedef struct {
+  UINT32    BlockOffset;          // offset of the block in StringBlock
+  UINT32    TextOffset;           // offset of the text in the block
+  UINT8     BlockType;
+} HII_STRING_BLOCK_INDEX_ENTRY;
+
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
-  UINTN                         Signature;
-  EFI_HII_STRING_PACKAGE_HDR    *StringPkgHdr;
-  UINT8                         *StringBlock;
-  LIST_ENTRY                    StringEntry;
-  LIST_ENTRY                    FontInfoList;          // local font info list
-  UINT8                         FontId;
-  EFI_STRING_ID                 MaxStringId;           // record StringId
+  UINTN                           Signature;
+  EFI_HII_STRING_PACKAGE_HDR      *StringPkgHdr;
+  UINT8                           *StringBlock;
+  LIST_ENTRY                      StringEntry;
+  LIST_ENTRY                      FontInfoList;        // local font info list
+  UINT8                           FontId;
+  EFI_STRING_ID                   MaxStringId;         // record StringId
+  HII_STRING_BLOCK_INDEX_ENTRY    *StringIndex;        // lazily built, indexed by StringId
+  UINTN                           StringIndexCount;
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -220,6 +248,23 @@ typedef struct _HII_GLOBAL_FONT_INFO {
   EFI_FONT_INFO                *FontInfo;
 } HII_GLOBAL_FONT_INFO;
 
+//
+// Glyph found by a previous lookup of a character in a font. The cache is
+// direct mapped, one entry per slot.
+//
+#define HII_GLYPH_CACHE_SIZE  0x200
+#define HII_GLYPH_CACHE_INDEX(FontPackage, Char) \
+  ((((UINTN)(FontPackage) >> 4) ^ (UINTN)(Char)) & (HII_GLYPH_CACHE_SIZE - 1))
+
+typedef struct {
+  HII_FONT_PACKAGE_INSTANCE    *FontPackage;    // NULL for the simplified fonts
+  CHAR16                       CharValue;
+  UINT8                        Attributes;
+  EFI_HII_GLYPH_INFO           Cell;
+  UINTN                        GlyphBufferLen;
+  UINT8                        GlyphBuffer[1];
+} HII_GLYPH_CACHE_ENTRY;
+
 //
 // Image Package definitions
 //
@@ -303,22 +348,23 @@ typedef struct _HII_DATABASE_NOTIFY {
 #define HII_DATABASE_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('H', 'i', 'D', 'p')
 
 typedef struct _HII_DATABASE_PRIVATE_DATA {
-  UINTN                                  Signature;
-  LIST_ENTRY                             DatabaseList;
-  LIST_ENTRY                             DatabaseNotifyList;
-  EFI_HII_FONT_PROTOCOL                  HiiFont;
-  EFI_HII_IMAGE_PROTOCOL                 HiiImage;
-  EFI_HII_IMAGE_EX_PROTOCOL              HiiImageEx;
-  EFI_HII_STRING_PROTOCOL                HiiString;
-  EFI_HII_DATABASE_PROTOCOL              HiiDatabase;
-  EFI_HII_CONFIG_ROUTING_PROTOCOL        ConfigRouting;
-  EFI_CONFIG_KEYWORD_HANDLER_PROTOCOL    ConfigKeywordHandler;
-  LIST_ENTRY                             HiiHandleList;
-  INTN                                   HiiHandleCount;
-  LIST_ENTRY                             FontInfoList; // global font info list
-  UINTN                                  Attribute;    // default system color
-  EFI_GUID                               CurrentLayoutGuid;
-  EFI_HII_KEYBOARD_LAYOUT                *CurrentLayout;
+  UINTN                                      Signature;
+  LIST_ENTRY                                 DatabaseList;
+  LIST_ENTRY                                 DatabaseNotifyList;
+  EFI_HII_FONT_PROTOCOL                      HiiFont;
+  EFI_HII_IMAGE_PROTOCOL                     HiiImage;
+  EFI_HII_IMAGE_EX_PROTOCOL                  HiiImageEx;
+  EFI_HII_STRING_PROTOCOL                    HiiString;
+  EFI_HII_DATABASE_PROTOCOL                  HiiDatabase;
+  EFI_HII_CONFIG_ROUTING_PROTOCOL            ConfigRouting;
+  EFI_CONFIG_KEYWORD_HANDLER_PROTOCOL        ConfigKeywordHandler;
+  EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL    ConfigBlockRouting;
+  LIST_ENTRY                                 HiiHandleList;
+  INTN                                       HiiHandleCount;
+  LIST_ENTRY                                 FontInfoList; // global font info list
+  UINTN                                      Attribute;    // default system color
+  EFI_GUID                                   CurrentLayoutGuid;
+  EFI_HII_KEYBOARD_LAYOUT                    *CurrentLayout;
 } HII_DATABASE_PRIVATE_DATA;
 
 #define HII_FONT_DATABASE_PRIVATE_DATA_FROM_THIS(a) \
@@ -370,6 +416,13 @@ typedef struct _HII_DATABASE_PRIVATE_DATA {
       HII_DATABASE_PRIVATE_DATA_SIGNATURE \
       )
 
+#define CONFIG_BLOCK_ROUTING_DATABASE_PRIVATE_DATA_FROM_THIS(a) \
+  CR (a, \
+      HII_DATABASE_PRIVATE_DATA, \
+      ConfigBlockRouting, \
+      HII_DATABASE_PRIVATE_DATA_SIGNATURE \
+      )
+
 //
 // Internal function prototypes.
 //
@@ -497,6 +550,105 @@ GetSystemFont (
   OUT UINTN                      *FontInfoSize OPTIONAL
   );
 
+/**
+  Drop the StringId index of a string package. It must be called whenever the
+  string blocks of the package are reallocated or its MaxStringId changes, so
+  that the next lookup rebuilds the index from the new string blocks.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+InvalidateStringBlockIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  );
+
+/**
+  Drop the cached IFR default strings of one package list, or of all package
+  lists when Handle is NULL. It must be called whenever the form or string
+  packages of a package list change.
+
+  @param  Handle                 The package list whose entries are dropped,
+                                 or NULL to drop the whole cache.
+
+**/
+VOID
+InvalidateIfrDefaultCache (
+  IN EFI_HII_HANDLE  Handle OPTIONAL
+  );
+
+/**
+  Drop all glyphs cached by GetGlyphBuffer(). It must be called whenever a
+  font or simplified font package is added to or removed from the database.
+
+**/
+VOID
+InvalidateGlyphCache (
+  VOID
+  );
+
+/**
+  Converts the unicode character of the string from uppercase to lowercase.
+  This is a internal function.
+
+  @param ConfigString  String to be converted
+
+**/
+VOID
+EFIAPI
+HiiToLower (
+  IN EFI_STRING  ConfigString
+  );
+
+/**
+  Generate ConfigRequest Header base on the varstore info.
+
+  @param      VarStorageData        The varstore info.
+  @param      DevicePath            Device path for this varstore.
+  @param      ConfigHdr             The config header for this varstore.
+
+  @retval     EFI_SUCCESS           Generate the header success.
+  @retval     EFI_OUT_OF_RESOURCES  Allocate buffer fail.
+**/
+EFI_STATUS
+GenerateHdr (
+  IN   IFR_VARSTORAGE_DATA       *VarStorageData,
+  IN   EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT  EFI_STRING                *ConfigHdr
+  );
+
+/**
+  This function parses Form Package to get the efi varstore info according to the request ConfigHdr.
+
+  @param  DataBaseRecord        The DataBaseRecord instance contains the found Hii handle and package.
+  @param  ConfigHdr             Request string ConfigHdr. If it is NULL,
+                                the first found varstore will be as ConfigHdr.
+  @retval  TRUE                 This hii package is the request one.
+  @retval  FALSE                This hii package is not the request one.
+**/
+BOOLEAN
+IsThisPackageList (
+  IN     HII_DATABASE_RECORD  *DataBaseRecord,
+  IN     EFI_STRING           ConfigHdr
+  );
+
+/**
+  This function parses Form Package to get the efi varstore info according to the request ConfigHdr.
+
+  @param  DataBaseRecord        The DataBaseRecord instance contains the found Hii handle and package.
+  @param  ConfigHdr             Request string ConfigHdr. If it is NULL,
+                                the first found varstore will be as ConfigHdr.
+  @param  IsEfiVarstore         Whether the request storage type is efi varstore type.
+  @param  EfiVarStore           The efi varstore info which will return.
+**/
+EFI_STATUS
+GetVarStoreType (
+  IN     HII_DATABASE_RECORD   *DataBaseRecord,
+  IN     EFI_STRING            ConfigHdr,
+  OUT    BOOLEAN               *IsEfiVarstore,
+  OUT    EFI_IFR_VARSTORE_EFI  **EfiVarStore
+  );
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -2092,6 +2244,67 @@ HiiGetAltCfg (
   OUT EFI_STRING                             *AltCfgResp
   );
 
+/**
+  Read the current value of a set of blocks of a varstore.
+
+  @param  This                   The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param  VarStoreGuid           The GUID of the varstore.
+  @param  VarStoreName           The name of the varstore.
+  @param  DevicePath             The device path of the driver that owns the varstore.
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks to read. On return, the Value buffer
+                                 of each block holds its current value.
+
+  @retval EFI_SUCCESS            All the blocks were read.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, BlockCount is 0, or a block
+                                 has a zero Width, a NULL Value or lies beyond the
+                                 varstore.
+  @retval EFI_NOT_FOUND          No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to complete the request.
+  @return Others                 The error returned by the driver that owns the varstore.
+
+**/
+EFI_STATUS
+EFIAPI
+HiiConfigBlockRoutingExtractBlock (
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN OUT   EDKII_HII_CONFIG_BLOCK                   *Blocks
+  );
+
+/**
+  Write a set of blocks of a varstore. When blocks overlap, the later one wins.
+
+  @param  This                   The EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL instance.
+  @param  VarStoreGuid           The GUID of the varstore.
+  @param  VarStoreName           The name of the varstore.
+  @param  DevicePath             The device path of the driver that owns the varstore.
+  @param  BlockCount             The number of entries in Blocks.
+  @param  Blocks                 The blocks to write.
+
+  @retval EFI_SUCCESS            All the blocks were written.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, BlockCount is 0, or a block
+                                 has a zero Width, a NULL Value or lies beyond the
+                                 varstore.
+  @retval EFI_NOT_FOUND          No driver owns the varstore.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to complete the request.
+  @return Others                 The error returned by the driver that owns the varstore.
+
+**/
+EFI_STATUS
+EFIAPI
+HiiConfigBlockRoutingRouteBlock (
+  IN CONST EDKII_HII_CONFIG_BLOCK_ROUTING_PROTOCOL  *This,
+  IN CONST EFI_GUID                                 *VarStoreGuid,
+  IN CONST CHAR16                                   *VarStoreName,
+  IN       EFI_DEVICE_PATH_PROTOCOL                 *DevicePath,
+  IN       UINTN                                    BlockCount,
+  IN CONST EDKII_HII_CONFIG_BLOCK                   *Blocks
+  );
+
 /**
 
   This function accepts a <MultiKeywordResp> formatted string, finds the associated
@@ -78,6 +78,10 @@ HII_DATABASE_PRIVATE_DATA  mPrivate = {
     EfiConfigKeywordHandlerSetData,
     EfiConfigKeywordHandlerGetData
   },
+  {
+    HiiConfigBlockRoutingExtractBlock,
+    HiiConfigBlockRoutingRouteBlock
+  },
   {
     (LIST_ENTRY *)NULL,
     (LIST_ENTRY *)NULL
@@ -216,6 +220,8 @@ InitializeHiiDatabase (
                   &mPrivate.ConfigRouting,
                   &gEfiConfigKeywordHandlerProtocolGuid,
                   &mPrivate.ConfigKeywordHandler,
+                  &gEdkiiHiiConfigBlockRoutingProtocolGuid,
+                  &mPrivate.ConfigBlockRouting,
                   NULL
                   );
 
@@ -225,6 +225,236 @@ GetStringFontInfo (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Drop the StringId index of a string package. It must be called whenever the
+  string blocks of the package are reallocated or its MaxStringId changes, so
+  that the next lookup rebuilds the index from the new string blocks.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+InvalidateStringBlockIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex      = NULL;
+    StringPackage->StringIndexCount = 0;
+  }
+}
+
+/**
+  Record the string block of one StringId in the index being built.
+
+  @param  Index                   The StringId index.
+  @param  Count                   The number of entries in Index.
+  @param  StringId                The string's id.
+  @param  BlockType               The block type of the string block.
+  @param  BlockOffset             The offset of the string block, or the target
+                                  StringId of an EFI_HII_SIBT_DUPLICATE block.
+  @param  TextOffset              The offset of the string text in the block.
+
+**/
+STATIC
+VOID
+SetStringBlockIndexEntry (
+  IN HII_STRING_BLOCK_INDEX_ENTRY  *Index,
+  IN UINTN                         Count,
+  IN UINTN                         StringId,
+  IN UINT8                         BlockType,
+  IN UINTN                         BlockOffset,
+  IN UINTN                         TextOffset
+  )
+{
+  if (StringId < Count) {
+    Index[StringId].BlockType   = BlockType;
+    Index[StringId].BlockOffset = (UINT32)BlockOffset;
+    Index[StringId].TextOffset  = (UINT32)TextOffset;
+  }
+}
+
+/**
+  Parse all string blocks once and build the StringId index of a string package,
+  so that the string block of any StringId can be found without parsing the
+  blocks which precede it. EFI_HII_SIBT_DUPLICATE blocks are resolved to the
+  string block they refer to.
+
+  @param  StringPackage           Hii string package instance.
+
+  @retval EFI_SUCCESS             The index is built.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to build the index.
+  @retval EFI_UNSUPPORTED         The string blocks contain an unknown block type.
+
+**/
+STATIC
+EFI_STATUS
+BuildStringBlockIndex (
+  IN HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  HII_STRING_BLOCK_INDEX_ENTRY  *Index;
+  UINTN                         Count;
+  UINT8                         *BlockHdr;
+  UINTN                         BlockSize;
+  UINTN                         CurrentStringId;
+  UINTN                         Offset;
+  UINTN                         Loop;
+  UINTN                         Target;
+  UINTN                         Steps;
+  UINT8                         *StringTextPtr;
+  UINTN                         StringSize;
+  UINT16                        StringCount;
+  UINT16                        SkipCount;
+  EFI_STRING_ID                 DuplicateId;
+  UINT8                         Length8;
+  UINT32                        Length32;
+  EFI_HII_SIBT_EXT2_BLOCK       Ext2;
+
+  Count = (UINTN)StringPackage->MaxStringId + 1;
+  Index = AllocateZeroPool (Count * sizeof (HII_STRING_BLOCK_INDEX_ENTRY));
+  if (Index == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CurrentStringId = 1;
+  StringSize      = 0;
+  BlockHdr        = StringPackage->StringBlock;
+  BlockSize       = 0;
+  while (*BlockHdr != EFI_HII_SIBT_END) {
+    switch (*BlockHdr) {
+      case EFI_HII_SIBT_STRING_SCSU:
+      case EFI_HII_SIBT_STRING_SCSU_FONT:
+        if (*BlockHdr == EFI_HII_SIBT_STRING_SCSU) {
+          Offset = sizeof (EFI_HII_STRING_BLOCK);
+        } else {
+          Offset = sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        }
+
+        SetStringBlockIndexEntry (Index, Count, CurrentStringId, *BlockHdr, BlockSize, Offset);
+        BlockSize += Offset + AsciiStrSize ((CHAR8 *)(BlockHdr + Offset));
+        CurrentStringId++;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_SCSU:
+      case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+        if (*BlockHdr == EFI_HII_SIBT_STRINGS_SCSU) {
+          CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+          Offset = sizeof (EFI_HII_SIBT_STRINGS_SCSU_BLOCK) - sizeof (UINT8);
+        } else {
+          CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+          Offset = sizeof (EFI_HII_SIBT_STRINGS_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        }
+
+        StringTextPtr = BlockHdr + Offset;
+        for (Loop = 0; Loop < StringCount; Loop++) {
+          SetStringBlockIndexEntry (Index, Count, CurrentStringId, *BlockHdr, BlockSize, StringTextPtr - BlockHdr);
+          StringTextPtr += AsciiStrSize ((CHAR8 *)StringTextPtr);
+          CurrentStringId++;
+        }
+
+        BlockSize += StringTextPtr - BlockHdr;
+        break;
+
+      case EFI_HII_SIBT_STRING_UCS2:
+      case EFI_HII_SIBT_STRING_UCS2_FONT:
+        if (*BlockHdr == EFI_HII_SIBT_STRING_UCS2) {
+          Offset = sizeof (EFI_HII_STRING_BLOCK);
+        } else {
+          Offset = sizeof (EFI_HII_SIBT_STRING_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        }
+
+        SetStringBlockIndexEntry (Index, Count, CurrentStringId, *BlockHdr, BlockSize, Offset);
+        GetUnicodeStringTextOrSize (NULL, BlockHdr + Offset, &StringSize);
+        BlockSize += Offset + StringSize;
+        CurrentStringId++;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_UCS2:
+      case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+        if (*BlockHdr == EFI_HII_SIBT_STRINGS_UCS2) {
+          CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+          Offset = sizeof (EFI_HII_SIBT_STRINGS_UCS2_BLOCK) - sizeof (CHAR16);
+        } else {
+          CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+          Offset = sizeof (EFI_HII_SIBT_STRINGS_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        }
+
+        StringTextPtr = BlockHdr + Offset;
+        for (Loop = 0; Loop < StringCount; Loop++) {
+          SetStringBlockIndexEntry (Index, Count, CurrentStringId, *BlockHdr, BlockSize, StringTextPtr - BlockHdr);
+          GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
+          StringTextPtr += StringSize;
+          CurrentStringId++;
+        }
+
+        BlockSize += StringTextPtr - BlockHdr;
+        break;
+
+      case EFI_HII_SIBT_DUPLICATE:
+        CopyMem (&DuplicateId, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (EFI_STRING_ID));
+        SetStringBlockIndexEntry (Index, Count, CurrentStringId, EFI_HII_SIBT_DUPLICATE, DuplicateId, 0);
+        BlockSize += sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
+        CurrentStringId++;
+        break;
+
+      case EFI_HII_SIBT_SKIP1:
+        SkipCount        = (UINT16)(*(UINT8 *)((UINTN)BlockHdr + sizeof (EFI_HII_STRING_BLOCK)));
+        CurrentStringId += SkipCount;
+        BlockSize       += sizeof (EFI_HII_SIBT_SKIP1_BLOCK);
+        break;
+
+      case EFI_HII_SIBT_SKIP2:
+        CopyMem (&SkipCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        CurrentStringId += SkipCount;
+        BlockSize       += sizeof (EFI_HII_SIBT_SKIP2_BLOCK);
+        break;
+
+      case EFI_HII_SIBT_EXT1:
+        CopyMem (&Length8, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT8));
+        BlockSize += Length8;
+        break;
+
+      case EFI_HII_SIBT_EXT2:
+        CopyMem (&Ext2, BlockHdr, sizeof (EFI_HII_SIBT_EXT2_BLOCK));
+        BlockSize += Ext2.Length;
+        break;
+
+      case EFI_HII_SIBT_EXT4:
+        CopyMem (&Length32, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT32));
+        BlockSize += Length32;
+        break;
+
+      default:
+        FreePool (Index);
+        return EFI_UNSUPPORTED;
+    }
+
+    BlockHdr = StringPackage->StringBlock + BlockSize;
+  }
+
+  //
+  // Point each duplicate string to the string block it finally refers to.
+  //
+  for (Loop = 1; Loop < Count; Loop++) {
+    Target = Loop;
+    for (Steps = 0; Steps < Count && Target < Count && Index[Target].BlockType == EFI_HII_SIBT_DUPLICATE; Steps++) {
+      Target = Index[Target].BlockOffset;
+    }
+
+    if ((Target < Count) && (Index[Target].BlockType != EFI_HII_SIBT_DUPLICATE)) {
+      CopyMem (&Index[Loop], &Index[Target], sizeof (HII_STRING_BLOCK_INDEX_ENTRY));
+    } else {
+      ZeroMem (&Index[Loop], sizeof (HII_STRING_BLOCK_INDEX_ENTRY));
+    }
+  }
+
+  StringPackage->StringIndex      = Index;
+  StringPackage->StringIndexCount = Count;
+  return EFI_SUCCESS;
+}
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -295,6 +525,27 @@ FindStringBlock (
     if (StringId > StringPackage->MaxStringId) {
       return EFI_NOT_FOUND;
     }
+
+    //
+    // Look the string block up in the StringId index, building it on first use.
+    // The skip block information needed for StartStringId is not indexed.
+    //
+    if (StartStringId == NULL) {
+      if (StringPackage->StringIndex == NULL) {
+        BuildStringBlockIndex (StringPackage);
+      }
+
+      if ((StringPackage->StringIndex != NULL) && (StringId < StringPackage->StringIndexCount)) {
+        if (StringPackage->StringIndex[StringId].BlockType == EFI_HII_SIBT_END) {
+          return EFI_NOT_FOUND;
+        }
+
+        *BlockType        = StringPackage->StringIndex[StringId].BlockType;
+        *StringBlockAddr  = StringPackage->StringBlock + StringPackage->StringIndex[StringId].BlockOffset;
+        *StringTextOffset = StringPackage->StringIndex[StringId].TextOffset;
+        return EFI_SUCCESS;
+      }
+    }
   } else {
     ASSERT (Private != NULL && Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
     if ((StringId == 0) && (LastStringId != NULL)) {
@@ -853,6 +1104,7 @@ InsertLackStringBlock (
     *BlockType = EFI_HII_SIBT_STRING_UCS2;
   }
 
+  InvalidateStringBlockIndex (StringPackage);
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock                  = StringBlock;
   StringPackage->StringPkgHdr->Header.Length += NewBlockSize - OldBlockSize;
@@ -1024,6 +1276,7 @@ SetStringWorker (
         );
 
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = Block;
       StringPackage->StringPkgHdr->Header.Length += (UINT32)(BlockSize - OldBlockSize);
@@ -1058,6 +1311,7 @@ SetStringWorker (
         );
 
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = Block;
       StringPackage->StringPkgHdr->Header.Length += (UINT32)(BlockSize - OldBlockSize);
@@ -1110,6 +1364,7 @@ SetStringWorker (
   CopyMem (BlockPtr, StringPackage->StringBlock, OldBlockSize);
 
   ZeroMem (StringPackage->StringBlock, OldBlockSize);
+  InvalidateStringBlockIndex (StringPackage);
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock                  = Block;
   StringPackage->StringPkgHdr->Header.Length += Ext2.Length;
@@ -1224,6 +1479,8 @@ HiiNewString (
 
   EfiAcquireLock (&mHiiDatabaseLock);
 
+  InvalidateIfrDefaultCache (PackageList);
+
   Status                  = EFI_SUCCESS;
   NewStringPackageCreated = FALSE;
   NewStringId             = 0;
@@ -1298,6 +1555,7 @@ HiiNewString (
       //
       *BlockPtr = EFI_HII_SIBT_END;
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                     = StringBlock;
       StringPackage->StringPkgHdr->Header.Length    += Ucs2BlockSize;
@@ -1434,6 +1692,7 @@ HiiNewString (
     //
     *BlockPtr = EFI_HII_SIBT_END;
     ZeroMem (StringPackage->StringBlock, OldBlockSize);
+    InvalidateStringBlockIndex (StringPackage);
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock                     = StringBlock;
     StringPackage->StringPkgHdr->Header.Length    += Ucs2BlockSize;
@@ -1477,6 +1736,7 @@ HiiNewString (
       //
       *BlockPtr = EFI_HII_SIBT_END;
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                     = StringBlock;
       StringPackage->StringPkgHdr->Header.Length    += Ucs2FontBlockSize;
@@ -1539,6 +1799,7 @@ HiiNewString (
       //
       *BlockPtr = EFI_HII_SIBT_END;
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
+      InvalidateStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                     = StringBlock;
       StringPackage->StringPkgHdr->Header.Length    += FontBlockSize + Ucs2FontBlockSize;
@@ -1577,12 +1838,14 @@ Done:
     {
       StringPackage              = CR (Link, HII_STRING_PACKAGE_INSTANCE, StringEntry, HII_STRING_PACKAGE_SIGNATURE);
       StringPackage->MaxStringId = *StringId;
+      InvalidateStringBlockIndex (StringPackage);
     }
   } else if (NewStringPackageCreated) {
     //
     // Free the allocated new string Package when new string can't be added.
     //
     RemoveEntryList (&StringPackage->StringEntry);
+    InvalidateStringBlockIndex (StringPackage);
     FreePool (StringPackage->StringBlock);
     FreePool (StringPackage->StringPkgHdr);
     FreePool (StringPackage);
@@ -1770,6 +2033,8 @@ HiiSetString (
 
   EfiAcquireLock (&mHiiDatabaseLock);
 
+  InvalidateIfrDefaultCache (PackageList);
+
   Private         = HII_STRING_DATABASE_PRIVATE_DATA_FROM_THIS (This);
   PackageListNode = NULL;
 
@@ -315,6 +315,250 @@ ConstructNonTestedMemoryRange (
   return EFI_SUCCESS;
 }
 
+/**
+  Check whether a range is covered end to end by the default test pattern, so
+  that it can be written and verified as one run of 64-bit words.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @retval TRUE   The range can be tested as one run of 64-bit words.
+  @retval FALSE  The range must be tested one test unit at a time.
+
+**/
+BOOLEAN
+IsContiguousPatternRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  return (BOOLEAN)((Private->MonoPattern == GenericMemoryTestMonoPattern) &&
+                   (Private->MonoTestSize == GENERIC_CACHELINE_SIZE) &&
+                   (Private->CoverageSpan == GENERIC_CACHELINE_SIZE) &&
+                   (((Start | Size) & (GENERIC_CACHELINE_SIZE - 1)) == 0));
+}
+
+/**
+  Write the memory test pattern into a range of physical memory, without
+  flushing the cache. This function may run on an AP.
+
+  In extensive mode the whole range is written with SetMem64(), whose string
+  store implementation streams full cache lines to memory on large ranges
+  instead of reading each line in first.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+**/
+VOID
+WriteMemoryPattern (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+
+  if (IsContiguousPatternRange (Private, Start, Size)) {
+    SetMem64 ((VOID *)(UINTN)Start, (UINTN)Size, GENERIC_MONO_PATTERN_UINT64);
+    return;
+  }
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
+    Address += Private->CoverageSpan;
+  }
+}
+
+/**
+  Find the first test unit in a range of physical memory that does not hold
+  the memory test pattern. This function may run on an AP.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @return The address of the first miscompared test unit, or MAX_UINT64 if the
+          whole range holds the test pattern.
+
+**/
+EFI_PHYSICAL_ADDRESS
+FindMemoryMiscompare (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+  UINT64                *Qword;
+  UINT64                *End;
+
+  if (IsContiguousPatternRange (Private, Start, Size)) {
+    End = (UINT64 *)(UINTN)(Start + Size);
+    for (Qword = (UINT64 *)(UINTN)Start; Qword < End; Qword++) {
+      if (*Qword != GENERIC_MONO_PATTERN_UINT64) {
+        return (EFI_PHYSICAL_ADDRESS)(UINTN)Qword & ~((EFI_PHYSICAL_ADDRESS)GENERIC_CACHELINE_SIZE - 1);
+      }
+    }
+
+    return MAX_UINT64;
+  }
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    if (CompareMemWithoutCheckArgument (
+          (VOID *)(UINTN)(Address),
+          Private->MonoPattern,
+          Private->MonoTestSize
+          ) != 0)
+    {
+      return Address;
+    }
+
+    Address += Private->CoverageSpan;
+  }
+
+  return MAX_UINT64;
+}
+
+/**
+  Write or verify the slices of a memory test job until none is left. The BSP
+  and the APs all run this procedure at the same time.
+
+  @param[in, out] Buffer  Point to the MEMORY_TEST_JOB.
+
+**/
+VOID
+EFIAPI
+MemoryTestSliceProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  MEMORY_TEST_JOB       *Job;
+  UINT32                Index;
+  EFI_PHYSICAL_ADDRESS  SliceStart;
+  UINT64                SliceSize;
+  EFI_PHYSICAL_ADDRESS  ErrorAddress;
+  UINT64                Current;
+
+  Job = (MEMORY_TEST_JOB *)Buffer;
+
+  for (Index = InterlockedIncrement (&Job->NextSlice) - 1;
+       Index < Job->SliceCount;
+       Index = InterlockedIncrement (&Job->NextSlice) - 1)
+  {
+    SliceStart = Job->Start + MultU64x32 (Job->SliceSize, Index);
+    SliceSize  = MIN (Job->SliceSize, Job->Start + Job->Size - SliceStart);
+
+    if (!Job->Verify) {
+      WriteMemoryPattern (Job->Private, SliceStart, SliceSize);
+      continue;
+    }
+
+    ErrorAddress = FindMemoryMiscompare (Job->Private, SliceStart, SliceSize);
+    if (ErrorAddress == MAX_UINT64) {
+      continue;
+    }
+
+    //
+    // Keep the lowest error address found by any processor.
+    //
+    do {
+      Current = Job->ErrorAddress;
+      if (ErrorAddress >= Current) {
+        break;
+      }
+    } while (InterlockedCompareExchange64 (&Job->ErrorAddress, Current, ErrorAddress) != Current);
+  }
+}
+
+/**
+  Write or verify the memory test pattern over a range of physical memory.
+
+  The range is cut into slices that the BSP and, when the MP services are
+  available, the enabled APs take in turn, so every processor streams through
+  its own contiguous slices.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+  @param[in] Verify   FALSE to write the test pattern, TRUE to verify it.
+
+  @return The address of the first miscompared test unit, or MAX_UINT64 if no
+          error was found or Verify is FALSE.
+
+**/
+EFI_PHYSICAL_ADDRESS
+RunMemoryTestJob (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size,
+  IN  BOOLEAN                      Verify
+  )
+{
+  EFI_STATUS       Status;
+  MEMORY_TEST_JOB  Job;
+  EFI_EVENT        WaitEvent;
+
+  //
+  // Slices are a multiple of the coverage span, so that every slice samples
+  // the same addresses as a single pass over the whole range would.
+  //
+  Job.Private      = Private;
+  Job.Start        = Start;
+  Job.Size         = Size;
+  Job.SliceSize    = (TEST_SLICE_SIZE + Private->CoverageSpan - 1) / Private->CoverageSpan * Private->CoverageSpan;
+  Job.SliceCount   = (UINT32)DivU64x64Remainder (Size + Job.SliceSize - 1, Job.SliceSize, NULL);
+  Job.NextSlice    = 0;
+  Job.Verify       = Verify;
+  Job.ErrorAddress = MAX_UINT64;
+
+  if ((Private->MpServices == NULL) || (Job.SliceCount < 2)) {
+    MemoryTestSliceProcedure (&Job);
+    return Job.ErrorAddress;
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &WaitEvent);
+  if (EFI_ERROR (Status)) {
+    //
+    // Without the event, StartupAllAPs() blocks until the APs are done, and
+    // the BSP only finds the remaining slices, if any, afterwards.
+    //
+    WaitEvent = NULL;
+  }
+
+  Status = Private->MpServices->StartupAllAPs (
+                                  Private->MpServices,
+                                  MemoryTestSliceProcedure,
+                                  FALSE,
+                                  WaitEvent,
+                                  0,
+                                  &Job,
+                                  NULL
+                                  );
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_STARTED)) {
+    DEBUG ((DEBUG_WARN, "%a: APs not started - %r\n", __FUNCTION__, Status));
+  }
+
+  MemoryTestSliceProcedure (&Job);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      while (gBS->CheckEvent (WaitEvent) == EFI_NOT_READY) {
+        CpuPause ();
+      }
+    }
+
+    gBS->CloseEvent (WaitEvent);
+  }
+
+  return Job.ErrorAddress;
+}
+
 /**
   Write the memory test pattern into a range of physical memory.
 
@@ -333,10 +577,6 @@ WriteMemory (
   IN  UINT64                       Size
   )
 {
-  EFI_PHYSICAL_ADDRESS  Address;
-
-  Address = Start;
-
   //
   // Add 4G memory address check for IA32 platform
   // NOTE: Without page table, there is no way to use memory above 4G.
@@ -345,10 +585,7 @@ WriteMemory (
     return EFI_SUCCESS;
   }
 
-  while (Address < (Start + Size)) {
-    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
-    Address += Private->CoverageSpan;
-  }
+  RunMemoryTestJob (Private, Start, Size, FALSE);
 
   //
   // bug bug: we may need GCD service to make the code cache and data uncache,
@@ -383,10 +620,8 @@ VerifyMemory (
   )
 {
   EFI_PHYSICAL_ADDRESS            Address;
-  INTN                            ErrorFound;
   EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
 
-  Address           = Start;
   ExtendedErrorData = NULL;
 
   //
@@ -402,43 +637,35 @@ VerifyMemory (
   // error here. If there is miscompare error here then check if generic
   // memory test driver can disable the bad DIMM.
   //
-  while (Address < (Start + Size)) {
-    ErrorFound = CompareMemWithoutCheckArgument (
-                   (VOID *)(UINTN)(Address),
-                   Private->MonoPattern,
-                   Private->MonoTestSize
-                   );
-    if (ErrorFound != 0) {
-      //
-      // Report uncorrectable errors
-      //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome              = 0x0;
-      ExtendedErrorData->Address               = Address;
-      ExtendedErrorData->Resolution            = 0x40;
-
-      REPORT_STATUS_CODE_EX (
-        EFI_ERROR_CODE,
-        EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-        0,
-        &gEfiGenericMemTestProtocolGuid,
-        NULL,
-        (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-        ExtendedErrorData->DataHeader.Size
-        );
-
-      return EFI_DEVICE_ERROR;
+  Address = RunMemoryTestJob (Private, Start, Size, TRUE);
+  if (Address != MAX_UINT64) {
+    //
+    // Report uncorrectable errors
+    //
+    ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+    if (ExtendedErrorData == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
-    Address += Private->CoverageSpan;
+    ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
+    ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+    ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
+    ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
+    ExtendedErrorData->Syndrome              = 0x0;
+    ExtendedErrorData->Address               = Address;
+    ExtendedErrorData->Resolution            = 0x40;
+
+    REPORT_STATUS_CODE_EX (
+      EFI_ERROR_CODE,
+      EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+      0,
+      &gEfiGenericMemTestProtocolGuid,
+      NULL,
+      (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+      ExtendedErrorData->DataHeader.Size
+      );
+
+    return EFI_DEVICE_ERROR;
   }
 
   return EFI_SUCCESS;
@@ -466,6 +693,9 @@ InitializeMemoryTest (
   EFI_STATUS                   Status;
   GENERIC_MEMORY_TEST_PRIVATE  *Private;
   EFI_CPU_ARCH_PROTOCOL        *Cpu;
+  EFI_MP_SERVICES_PROTOCOL     *MpServices;
+  UINTN                        NumberOfProcessors;
+  UINTN                        NumberOfEnabledProcessors;
 
   Private             = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
   *RequireSoftECCInit = FALSE;
@@ -501,6 +731,25 @@ InitializeMemoryTest (
     Private->Cpu = Cpu;
   }
 
+  //
+  // Share every test block out to all enabled processors when the MP
+  // services are available, and grow the block so each processor still
+  // gets a full TEST_BLOCK_SIZE of work per call.
+  //
+  Private->MpServices = NULL;
+  Status              = gBS->LocateProtocol (
+                               &gEfiMpServiceProtocolGuid,
+                               NULL,
+                               (VOID **)&MpServices
+                               );
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+    if (!EFI_ERROR (Status) && (NumberOfEnabledProcessors > 1)) {
+      Private->MpServices   = MpServices;
+      Private->BdsBlockSize = MultU64x32 (TEST_BLOCK_SIZE, (UINT32)NumberOfEnabledProcessors);
+    }
+  }
+
   //
   // Create the CoverageSpan of the memory test base on the coverage level
   //
@@ -853,6 +1102,7 @@ GENERIC_MEMORY_TEST_PRIVATE  mGenericMemoryTestPrivate = {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE,
   NULL,
   NULL,
+  NULL,
   {
     InitializeMemoryTest,
     GenPerformMemoryTest,
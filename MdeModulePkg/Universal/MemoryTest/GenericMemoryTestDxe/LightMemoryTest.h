@@ -13,6 +13,7 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpService.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -23,6 +24,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/SynchronizationLib.h>
 
 //
 // Some global define
@@ -43,6 +45,13 @@
 #define QUICK_SPAN_SIZE   (TEST_BLOCK_SIZE >> 2)
 #define SPARSE_SPAN_SIZE  (TEST_BLOCK_SIZE >> 4)
 
+//
+// The granularity in which the processors share out a test block, and the
+// default test pattern as a 64-bit value.
+//
+#define TEST_SLICE_SIZE               0x200000
+#define GENERIC_MONO_PATTERN_UINT64  0xa5a5a5a55a5a5a5aULL
+
 //
 // This structure records every nontested memory range parsed through GCD
 // service.
@@ -81,6 +90,11 @@ typedef struct {
   //
   EFI_CPU_ARCH_PROTOCOL               *Cpu;
 
+  //
+  // MP services protocol's pointer, NULL if the test runs on the BSP only
+  //
+  EFI_MP_SERVICES_PROTOCOL            *MpServices;
+
   //
   // generic memory test driver's protocol
   //
@@ -118,6 +132,21 @@ typedef struct {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE \
   )
 
+//
+// This structure describes one pass over a memory range that the BSP and the
+// APs share out slice by slice.
+//
+typedef struct {
+  GENERIC_MEMORY_TEST_PRIVATE    *Private;
+  EFI_PHYSICAL_ADDRESS           Start;
+  UINT64                         Size;
+  UINT64                         SliceSize;
+  UINT32                         SliceCount;
+  volatile UINT32                NextSlice;
+  BOOLEAN                        Verify;
+  volatile UINT64                ErrorAddress;
+} MEMORY_TEST_JOB;
+
 //
 // Function Prototypes
 //
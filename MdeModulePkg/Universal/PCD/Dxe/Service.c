@@ -36,6 +36,28 @@ PEI_PCD_DATABASE  *mPeiPcdDbBinary = NULL;
 UINTN             mDxePcdDbSize    = 0;
 DXE_PCD_DATABASE  *mDxePcdDbBinary = NULL;
 
+//
+// Copies of the PEI and DXE ExMap tables sorted by {ExGuidIndex, ExTokenNumber},
+// so that GetExPcdTokenNumber () can binary search them. NULL if the copy could
+// not be allocated, then the ExMap table is scanned.
+//
+STATIC DYNAMICEX_MAPPING  *mPeiExMapSorted = NULL;
+STATIC DYNAMICEX_MAPPING  *mDxeExMapSorted = NULL;
+
+//
+// The token space GUID last looked up in the PEI and DXE GUID tables.
+// Callers pass the same token space GUID over and over.
+//
+STATIC CONST EFI_GUID  *mPeiLastExGuid   = NULL;
+STATIC UINTN           mPeiLastExGuidIdx = 0;
+STATIC CONST EFI_GUID  *mDxeLastExGuid   = NULL;
+STATIC UINTN           mDxeLastExGuidIdx = 0;
+
+//
+// The variables backing Dynamic HII PCDs read so far, when PcdHiiPcdVariableCacheEnable is TRUE.
+//
+STATIC LIST_ENTRY  mHiiVariableCache = INITIALIZE_LIST_HEAD_VARIABLE (mHiiVariableCache);
+
 /**
   Get Local Token Number by Token Number.
 
@@ -842,6 +864,72 @@ UpdatePcdDatabase (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Compare two DynamicEx mapping entries by {ExGuidIndex, ExTokenNumber}.
+
+  @param[in] Buffer1  The first DYNAMICEX_MAPPING entry.
+  @param[in] Buffer2  The second DYNAMICEX_MAPPING entry.
+
+  @retval <0          Buffer1 sorts before Buffer2.
+  @retval 0           Buffer1 and Buffer2 map the same {token space guid: token number}.
+  @retval >0          Buffer1 sorts after Buffer2.
+**/
+STATIC
+INTN
+EFIAPI
+CompareExMapEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST DYNAMICEX_MAPPING  *Entry1;
+  CONST DYNAMICEX_MAPPING  *Entry2;
+
+  Entry1 = (CONST DYNAMICEX_MAPPING *)Buffer1;
+  Entry2 = (CONST DYNAMICEX_MAPPING *)Buffer2;
+
+  if (Entry1->ExGuidIndex != Entry2->ExGuidIndex) {
+    return (Entry1->ExGuidIndex < Entry2->ExGuidIndex) ? -1 : 1;
+  }
+
+  if (Entry1->ExTokenNumber != Entry2->ExTokenNumber) {
+    return (Entry1->ExTokenNumber < Entry2->ExTokenNumber) ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+  Make a copy of a DynamicEx mapping table sorted by {ExGuidIndex, ExTokenNumber}.
+
+  @param[in] ExMapTable       DynamicEx token number mapping table.
+  @param[in] ExTokenCount     The number of entries in the mapping table.
+
+  @return The sorted copy, or NULL if the table is empty or the copy can't be allocated.
+**/
+STATIC
+DYNAMICEX_MAPPING *
+BuildSortedExMap (
+  IN DYNAMICEX_MAPPING  *ExMapTable,
+  IN UINTN              ExTokenCount
+  )
+{
+  DYNAMICEX_MAPPING  *SortedExMap;
+  DYNAMICEX_MAPPING  Swap;
+
+  if (ExTokenCount == 0) {
+    return NULL;
+  }
+
+  SortedExMap = AllocateCopyPool (ExTokenCount * sizeof (DYNAMICEX_MAPPING), ExMapTable);
+  if (SortedExMap == NULL) {
+    return NULL;
+  }
+
+  QuickSort (SortedExMap, ExTokenCount, sizeof (DYNAMICEX_MAPPING), CompareExMapEntry, &Swap);
+  return SortedExMap;
+}
+
 /**
   Initialize the PCD database in DXE phase.
 
@@ -931,6 +1019,21 @@ BuildPcdDxeDataBase (
   TmpTokenSpaceBufferCount = mPcdDatabase.PeiDb->ExTokenCount + mPcdDatabase.DxeDb->ExTokenCount;
   TmpTokenSpaceBuffer      = (EFI_GUID **)AllocateZeroPool (TmpTokenSpaceBufferCount * sizeof (EFI_GUID *));
 
+  //
+  // Sort the ExMap tables for the {token space guid: token number} lookups.
+  //
+  if (!mPeiDatabaseEmpty) {
+    mPeiExMapSorted = BuildSortedExMap (
+                        (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset),
+                        mPcdDatabase.PeiDb->ExTokenCount
+                        );
+  }
+
+  mDxeExMapSorted = BuildSortedExMap (
+                      (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset),
+                      mPcdDatabase.DxeDb->ExTokenCount
+                      );
+
   //
   // Initialized the Callback Function Table
   //
@@ -948,7 +1051,7 @@ BuildPcdDxeDataBase (
 }
 
 /**
-  Get Variable which contains HII type PCD entry.
+  Read the variable which contains HII type PCD entry from the variable services.
 
   @param VariableGuid    Variable's guid
   @param VariableName    Variable's unicode name string
@@ -957,8 +1060,9 @@ BuildPcdDxeDataBase (
 
   @return the status of gRT->GetVariable
 **/
+STATIC
 EFI_STATUS
-GetHiiVariable (
+ReadHiiVariable (
   IN  EFI_GUID  *VariableGuid,
   IN  UINT16    *VariableName,
   OUT UINT8     **VariableData,
@@ -1013,6 +1117,122 @@ GetHiiVariable (
   return Status;
 }
 
+/**
+  Find a variable in the Dynamic HII PCD variable cache.
+
+  @param VariableGuid    Variable's guid
+  @param VariableName    Variable's unicode name string
+
+  @return The cache entry of the variable, or NULL if the variable is not cached.
+**/
+STATIC
+HII_VARIABLE_CACHE_ENTRY *
+FindHiiVariableCacheEntry (
+  IN  EFI_GUID  *VariableGuid,
+  IN  UINT16    *VariableName
+  )
+{
+  LIST_ENTRY                *Link;
+  HII_VARIABLE_CACHE_ENTRY  *Entry;
+
+  for (Link = GetFirstNode (&mHiiVariableCache); !IsNull (&mHiiVariableCache, Link); Link = GetNextNode (&mHiiVariableCache, Link)) {
+    Entry = CR_FNENTRY_FROM_LISTNODE (Link, HII_VARIABLE_CACHE_ENTRY, Node);
+    if (CompareGuid (Entry->VariableGuid, VariableGuid) && (StrCmp (Entry->VariableName, VariableName) == 0)) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop a variable from the Dynamic HII PCD variable cache.
+
+  @param VariableGuid    Variable's guid
+  @param VariableName    Variable's unicode name string
+**/
+STATIC
+VOID
+InvalidateHiiVariableCacheEntry (
+  IN  EFI_GUID  *VariableGuid,
+  IN  UINT16    *VariableName
+  )
+{
+  HII_VARIABLE_CACHE_ENTRY  *Entry;
+
+  Entry = FindHiiVariableCacheEntry (VariableGuid, VariableName);
+  if (Entry != NULL) {
+    RemoveEntryList (&Entry->Node);
+    FreePool (Entry->VariableData);
+    FreePool (Entry);
+  }
+}
+
+/**
+  Get Variable which contains HII type PCD entry.
+
+  When PcdHiiPcdVariableCacheEnable is TRUE, a variable is only read from the
+  variable services the first time one of its PCDs is read, and again after
+  SetHiiVariable() updates it. A variable that is not found is not cached.
+
+  @param VariableGuid    Variable's guid
+  @param VariableName    Variable's unicode name string
+  @param VariableData    Variable's data pointer, allocated for the caller to free.
+  @param VariableSize    Variable's size.
+
+  @return the status of gRT->GetVariable
+**/
+EFI_STATUS
+GetHiiVariable (
+  IN  EFI_GUID  *VariableGuid,
+  IN  UINT16    *VariableName,
+  OUT UINT8     **VariableData,
+  OUT UINTN     *VariableSize
+  )
+{
+  EFI_STATUS                Status;
+  HII_VARIABLE_CACHE_ENTRY  *Entry;
+  UINT8                     *Buffer;
+
+  if (!FeaturePcdGet (PcdHiiPcdVariableCacheEnable)) {
+    return ReadHiiVariable (VariableGuid, VariableName, VariableData, VariableSize);
+  }
+
+  Entry = FindHiiVariableCacheEntry (VariableGuid, VariableName);
+  if (Entry == NULL) {
+    Status = ReadHiiVariable (VariableGuid, VariableName, VariableData, VariableSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Entry = AllocatePool (sizeof (HII_VARIABLE_CACHE_ENTRY));
+    if (Entry == NULL) {
+      return Status;
+    }
+
+    Entry->VariableData = AllocateCopyPool (*VariableSize, *VariableData);
+    if (Entry->VariableData == NULL) {
+      FreePool (Entry);
+      return Status;
+    }
+
+    Entry->VariableGuid = VariableGuid;
+    Entry->VariableName = VariableName;
+    Entry->VariableSize = *VariableSize;
+    InsertTailList (&mHiiVariableCache, &Entry->Node);
+    return Status;
+  }
+
+  Buffer = AllocateCopyPool (Entry->VariableSize, Entry->VariableData);
+  if (Buffer == NULL) {
+    return ReadHiiVariable (VariableGuid, VariableName, VariableData, VariableSize);
+  }
+
+  *VariableData = Buffer;
+  *VariableSize = Entry->VariableSize;
+  return EFI_SUCCESS;
+}
+
 /**
   Invoke the callback function when dynamic PCD entry was set, if this PCD entry
   has registered callback function.
@@ -1473,6 +1693,13 @@ SetHiiVariable (
   Size    = 0;
   SetSize = 0;
 
+  //
+  // The variable is about to change, drop its cached copy.
+  //
+  if (FeaturePcdGet (PcdHiiPcdVariableCacheEnable)) {
+    InvalidateHiiVariableCacheEntry (VariableGuid, VariableName);
+  }
+
   //
   // Try to get original variable size information.
   //
@@ -1563,6 +1790,111 @@ SetHiiVariable (
   return Status;
 }
 
+/**
+  Find the index of a token space guid in a PCD database GUID table.
+
+  The last GUID looked up is remembered, as callers usually look up the same
+  token space GUID repeatedly.
+
+  @param[in]      GuidTable       The GUID table of the PCD database.
+  @param[in]      GuidTableSize   The size in bytes of the GUID table.
+  @param[in]      Guid            The token space guid to find.
+  @param[in, out] LastGuid        The last GUID found in this GUID table.
+  @param[in, out] LastGuidIdx     The index of the last GUID found in this GUID table.
+  @param[out]     GuidIdx         The index of Guid in the GUID table.
+
+  @retval TRUE                    Guid is in the GUID table.
+  @retval FALSE                   Guid is not in the GUID table.
+**/
+STATIC
+BOOLEAN
+FindExGuidIndex (
+  IN     EFI_GUID        *GuidTable,
+  IN     UINTN           GuidTableSize,
+  IN     CONST EFI_GUID  *Guid,
+  IN OUT CONST EFI_GUID  **LastGuid,
+  IN OUT UINTN           *LastGuidIdx,
+  OUT    UINTN           *GuidIdx
+  )
+{
+  EFI_GUID  *MatchGuid;
+
+  if ((*LastGuid == Guid) && CompareGuid (&GuidTable[*LastGuidIdx], Guid)) {
+    *GuidIdx = *LastGuidIdx;
+    return TRUE;
+  }
+
+  MatchGuid = ScanGuid (GuidTable, GuidTableSize, Guid);
+  if (MatchGuid == NULL) {
+    return FALSE;
+  }
+
+  *GuidIdx     = MatchGuid - GuidTable;
+  *LastGuid    = Guid;
+  *LastGuidIdx = *GuidIdx;
+  return TRUE;
+}
+
+/**
+  Find the Token Number of a dynamic-ex PCD in a DynamicEx mapping table.
+
+  @param[in] ExMapTable       DynamicEx token number mapping table.
+  @param[in] SortedExMap      ExMapTable sorted by {ExGuidIndex, ExTokenNumber}, or NULL.
+  @param[in] ExTokenCount     The number of entries in the mapping table.
+  @param[in] GuidTableIdx     The index of the token space guid in the GUID table.
+  @param[in] ExTokenNumber    Dynamic-ex PCD token number.
+
+  @return Token Number for dynamic-ex PCD, or PCD_INVALID_TOKEN_NUMBER if it is not in the table.
+**/
+STATIC
+UINTN
+FindExMapTokenNumber (
+  IN DYNAMICEX_MAPPING  *ExMapTable,
+  IN DYNAMICEX_MAPPING  *SortedExMap OPTIONAL,
+  IN UINTN              ExTokenCount,
+  IN UINTN              GuidTableIdx,
+  IN UINT32             ExTokenNumber
+  )
+{
+  DYNAMICEX_MAPPING  Key;
+  UINTN              Low;
+  UINTN              High;
+  UINTN              Middle;
+  INTN               Result;
+  UINTN              Index;
+
+  if (SortedExMap == NULL) {
+    for (Index = 0; Index < ExTokenCount; Index++) {
+      if ((ExTokenNumber == ExMapTable[Index].ExTokenNumber) &&
+          (GuidTableIdx == ExMapTable[Index].ExGuidIndex))
+      {
+        return ExMapTable[Index].TokenNumber;
+      }
+    }
+
+    return PCD_INVALID_TOKEN_NUMBER;
+  }
+
+  Key.ExTokenNumber = ExTokenNumber;
+  Key.ExGuidIndex   = (UINT16)GuidTableIdx;
+
+  Low  = 0;
+  High = ExTokenCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareExMapEntry (&Key, &SortedExMap[Middle]);
+    if (Result == 0) {
+      return SortedExMap[Middle].TokenNumber;
+    } else if (Result < 0) {
+      High = Middle;
+    } else {
+      Low = Middle + 1;
+    }
+  }
+
+  return PCD_INVALID_TOKEN_NUMBER;
+}
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -1582,27 +1914,25 @@ GetExPcdTokenNumber (
   IN UINT32          ExTokenNumber
   )
 {
-  UINT32             Index;
   DYNAMICEX_MAPPING  *ExMap;
   EFI_GUID           *GuidTable;
-  EFI_GUID           *MatchGuid;
   UINTN              MatchGuidIdx;
+  UINTN              TokenNumber;
 
   if (!mPeiDatabaseEmpty) {
     ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset);
     GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->GuidTableOffset);
 
-    MatchGuid = ScanGuid (GuidTable, mPeiGuidTableSize, Guid);
-
-    if (MatchGuid != NULL) {
-      MatchGuidIdx = MatchGuid - GuidTable;
-
-      for (Index = 0; Index < mPcdDatabase.PeiDb->ExTokenCount; Index++) {
-        if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-            (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-        {
-          return ExMap[Index].TokenNumber;
-        }
+    if (FindExGuidIndex (GuidTable, mPeiGuidTableSize, Guid, &mPeiLastExGuid, &mPeiLastExGuidIdx, &MatchGuidIdx)) {
+      TokenNumber = FindExMapTokenNumber (
+                      ExMap,
+                      mPeiExMapSorted,
+                      mPcdDatabase.PeiDb->ExTokenCount,
+                      MatchGuidIdx,
+                      ExTokenNumber
+                      );
+      if (TokenNumber != PCD_INVALID_TOKEN_NUMBER) {
+        return TokenNumber;
       }
     }
   }
@@ -1610,20 +1940,22 @@ GetExPcdTokenNumber (
   ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->GuidTableOffset);
 
-  MatchGuid = ScanGuid (GuidTable, mDxeGuidTableSize, Guid);
   //
   // We need to ASSERT here. If GUID can't be found in GuidTable, this is a
   // error in the BUILD system.
   //
-  ASSERT (MatchGuid != NULL);
-
-  MatchGuidIdx = MatchGuid - GuidTable;
-
-  for (Index = 0; Index < mPcdDatabase.DxeDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-        (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-    {
-      return ExMap[Index].TokenNumber;
+  if (!FindExGuidIndex (GuidTable, mDxeGuidTableSize, Guid, &mDxeLastExGuid, &mDxeLastExGuidIdx, &MatchGuidIdx)) {
+    ASSERT (FALSE);
+  } else {
+    TokenNumber = FindExMapTokenNumber (
+                    ExMap,
+                    mDxeExMapSorted,
+                    mPcdDatabase.DxeDb->ExTokenCount,
+                    MatchGuidIdx,
+                    ExTokenNumber
+                    );
+    if (TokenNumber != PCD_INVALID_TOKEN_NUMBER) {
+      return TokenNumber;
     }
   }
 
@@ -807,6 +807,17 @@ typedef struct {
 
 #define CR_FNENTRY_FROM_LISTNODE(Record, Type, Field)  BASE_CR(Record, Type, Field)
 
+///
+/// A variable backing Dynamic HII PCDs, cached when PcdHiiPcdVariableCacheEnable is TRUE.
+///
+typedef struct {
+  LIST_ENTRY    Node;
+  EFI_GUID      *VariableGuid;
+  UINT16        *VariableName;
+  UINTN         VariableSize;
+  UINT8         *VariableData;
+} HII_VARIABLE_CACHE_ENTRY;
+
 //
 // Internal Functions
 //
@@ -24,6 +24,129 @@ EFI_REGULAR_EXPRESSION_PROTOCOL  mProtocolInstance = {
 
 #define CHAR16_ENCODING  ONIG_ENCODING_UTF16_LE
 
+//
+// Compiled patterns, most recently used first.
+//
+STATIC LIST_ENTRY  mRegexCache      = INITIALIZE_LIST_HEAD_VARIABLE (mRegexCache);
+STATIC UINTN       mRegexCacheCount = 0;
+
+/**
+  Take a compiled pattern out of the regex cache.
+
+  The entry is removed from the cache while it is in use, so that a nested
+  match with the same pattern compiles its own copy.
+
+  @param Pattern        The pattern to look for.
+  @param Syntax         The syntax the pattern was compiled with.
+
+  @return The cache entry of the pattern, or NULL if it is not cached.
+
+**/
+STATIC
+REGEX_CACHE_ENTRY *
+RegexCacheAcquire (
+  IN CHAR16          *Pattern,
+  IN OnigSyntaxType  *Syntax
+  )
+{
+  LIST_ENTRY         *Link;
+  REGEX_CACHE_ENTRY  *CacheEntry;
+  EFI_TPL            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Link = GetFirstNode (&mRegexCache); !IsNull (&mRegexCache, Link); Link = GetNextNode (&mRegexCache, Link)) {
+    CacheEntry = REGEX_CACHE_ENTRY_FROM_LINK (Link);
+    if ((CacheEntry->Syntax == Syntax) && (StrCmp (CacheEntry->Pattern, Pattern) == 0)) {
+      RemoveEntryList (Link);
+      mRegexCacheCount--;
+      gBS->RestoreTPL (OldTpl);
+      return CacheEntry;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return NULL;
+}
+
+/**
+  Create the regex cache entry of a pattern which has just been compiled.
+
+  @param Pattern        The pattern.
+  @param Syntax         The syntax the pattern was compiled with.
+  @param Regex          The compiled pattern.
+
+  @return The cache entry, or NULL if it cannot be allocated.
+
+**/
+STATIC
+REGEX_CACHE_ENTRY *
+RegexCacheCreateEntry (
+  IN CHAR16          *Pattern,
+  IN OnigSyntaxType  *Syntax,
+  IN regex_t         *Regex
+  )
+{
+  REGEX_CACHE_ENTRY  *CacheEntry;
+
+  CacheEntry = AllocatePool (sizeof (REGEX_CACHE_ENTRY));
+  if (CacheEntry == NULL) {
+    return NULL;
+  }
+
+  CacheEntry->Pattern = AllocateCopyPool (StrSize (Pattern), Pattern);
+  if (CacheEntry->Pattern == NULL) {
+    FreePool (CacheEntry);
+    return NULL;
+  }
+
+  CacheEntry->Signature = REGEX_CACHE_ENTRY_SIGNATURE;
+  CacheEntry->Syntax    = Syntax;
+  CacheEntry->Regex     = Regex;
+  return CacheEntry;
+}
+
+/**
+  Put a compiled pattern back into the regex cache, and evict the least
+  recently used pattern if the cache is full.
+
+  @param CacheEntry     The cache entry of the pattern. NULL if the pattern
+                        could not be cached.
+  @param Regex          The compiled pattern, freed if CacheEntry is NULL.
+
+**/
+STATIC
+VOID
+RegexCacheRelease (
+  IN REGEX_CACHE_ENTRY  *CacheEntry  OPTIONAL,
+  IN regex_t            *Regex
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (CacheEntry == NULL) {
+    onig_free (Regex);
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertHeadList (&mRegexCache, &CacheEntry->Link);
+  if (mRegexCacheCount < REGEX_CACHE_SIZE) {
+    mRegexCacheCount++;
+    CacheEntry = NULL;
+  } else {
+    CacheEntry = REGEX_CACHE_ENTRY_FROM_LINK (GetPreviousNode (&mRegexCache, &mRegexCache));
+    RemoveEntryList (&CacheEntry->Link);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (CacheEntry != NULL) {
+    onig_free (CacheEntry->Regex);
+    FreePool (CacheEntry->Pattern);
+    FreePool (CacheEntry);
+  }
+}
+
 /**
   Call the Oniguruma regex match API.
 
@@ -81,9 +204,10 @@ OnigurumaMatch (
   INT32           OnigResult;
   OnigErrorInfo   ErrorInfo;
   OnigUChar       ErrorMessage[ONIG_MAX_ERROR_MESSAGE_LEN];
-  UINT32          Index;
-  OnigUChar       *Start;
-  EFI_STATUS      Status;
+  UINT32             Index;
+  OnigUChar          *Start;
+  EFI_STATUS         Status;
+  REGEX_CACHE_ENTRY  *CacheEntry;
 
   Status = EFI_SUCCESS;
 
@@ -101,23 +225,30 @@ OnigurumaMatch (
   }
 
   //
-  // Compile pattern
+  // Compile pattern, unless it is in the cache
   //
-  Start      = (OnigUChar *)Pattern;
-  OnigResult = onig_new (
-                 &OnigRegex,
-                 Start,
-                 Start + onigenc_str_bytelen_null (CHAR16_ENCODING, Start),
-                 ONIG_OPTION_DEFAULT,
-                 CHAR16_ENCODING,
-                 OnigSyntax,
-                 &ErrorInfo
-                 );
+  CacheEntry = RegexCacheAcquire (Pattern, OnigSyntax);
+  if (CacheEntry != NULL) {
+    OnigRegex = CacheEntry->Regex;
+  } else {
+    Start      = (OnigUChar *)Pattern;
+    OnigResult = onig_new (
+                   &OnigRegex,
+                   Start,
+                   Start + onigenc_str_bytelen_null (CHAR16_ENCODING, Start),
+                   ONIG_OPTION_DEFAULT,
+                   CHAR16_ENCODING,
+                   OnigSyntax,
+                   &ErrorInfo
+                   );
+
+    if (OnigResult != ONIG_NORMAL) {
+      onig_error_code_to_str (ErrorMessage, OnigResult, &ErrorInfo);
+      DEBUG ((DEBUG_ERROR, "Regex compilation failed: %a\n", ErrorMessage));
+      return EFI_DEVICE_ERROR;
+    }
 
-  if (OnigResult != ONIG_NORMAL) {
-    onig_error_code_to_str (ErrorMessage, OnigResult, &ErrorInfo);
-    DEBUG ((DEBUG_ERROR, "Regex compilation failed: %a\n", ErrorMessage));
-    return EFI_DEVICE_ERROR;
+    CacheEntry = RegexCacheCreateEntry (Pattern, OnigSyntax, OnigRegex);
   }
 
   //
@@ -126,7 +257,7 @@ OnigurumaMatch (
   Start  = (OnigUChar *)String;
   Region = onig_region_new ();
   if (Region == NULL) {
-    onig_free (OnigRegex);
+    RegexCacheRelease (CacheEntry, OnigRegex);
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -148,7 +279,7 @@ OnigurumaMatch (
       onig_error_code_to_str (ErrorMessage, OnigResult);
       DEBUG ((DEBUG_ERROR, "Regex match failed: %a\n", ErrorMessage));
       onig_region_free (Region, 1);
-      onig_free (OnigRegex);
+      RegexCacheRelease (CacheEntry, OnigRegex);
       return EFI_DEVICE_ERROR;
     }
   }
@@ -188,7 +319,7 @@ OnigurumaMatch (
   }
 
   onig_region_free (Region, 1);
-  onig_free (OnigRegex);
+  RegexCacheRelease (CacheEntry, OnigRegex);
 
   return Status;
 }
@@ -21,6 +21,26 @@
 #include <Library/DebugLib.h>
 #include <Library/BaseLib.h>
 
+//
+// Number of compiled patterns kept in the regex cache.
+//
+#define REGEX_CACHE_SIZE  16
+
+#define REGEX_CACHE_ENTRY_SIGNATURE  SIGNATURE_32 ('R', 'x', 'C', 'e')
+
+//
+// Compiled pattern in the regex cache, keyed by pattern and syntax.
+//
+typedef struct {
+  UINT32            Signature;
+  LIST_ENTRY        Link;
+  OnigSyntaxType    *Syntax;
+  CHAR16            *Pattern;
+  regex_t           *Regex;
+} REGEX_CACHE_ENTRY;
+
+#define REGEX_CACHE_ENTRY_FROM_LINK(a)  CR (a, REGEX_CACHE_ENTRY, Link, REGEX_CACHE_ENTRY_SIGNATURE)
+
 /**
   Checks if the input string matches to the regular expression pattern.
 
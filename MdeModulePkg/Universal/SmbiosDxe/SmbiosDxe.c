@@ -19,6 +19,12 @@ SMBIOS_INSTANCE  mPrivateData;
 UINTN  mPreAllocatedPages      = 0;
 UINTN  mPre64BitAllocatedPages = 0;
 
+//
+// Context of the EndOfDxe and ReadyToBoot events flushing the deferred table construction.
+//
+STATIC BOOLEAN  mSmbiosEndOfDxe    = FALSE;
+STATIC BOOLEAN  mSmbiosReadyToBoot = TRUE;
+
 //
 // Chassis for SMBIOS entry point structure that is to be installed into EFI system config table.
 //
@@ -246,7 +252,7 @@ GetSmbiosStructureSize (
 
   Determin whether an SmbiosHandle has already in use.
 
-  @param Head        Pointer to the beginning of SMBIOS structure.
+  @param Private     Pointer to the SMBIOS instance.
   @param Handle      A unique handle will be assigned to the SMBIOS record.
 
   @retval TRUE       Smbios handle already in use.
@@ -256,21 +262,188 @@ GetSmbiosStructureSize (
 BOOLEAN
 EFIAPI
 CheckSmbiosHandleExistance (
-  IN  LIST_ENTRY         *Head,
+  IN  SMBIOS_INSTANCE    *Private,
   IN  EFI_SMBIOS_HANDLE  Handle
   )
 {
-  LIST_ENTRY           *Link;
-  SMBIOS_HANDLE_ENTRY  *HandleEntry;
+  return (BOOLEAN)((Private->AllocatedHandleBitmap[Handle / 8] & (1 << (Handle % 8))) != 0);
+}
+
+/**
+  Find the SMBIOS entry of an SMBIOS handle.
+
+  @param Private     Pointer to the SMBIOS instance.
+  @param Handle      The SMBIOS handle to look for.
+
+  @return The SMBIOS entry, or NULL if no record has the handle.
 
+**/
+STATIC
+EFI_SMBIOS_ENTRY *
+SmbiosFindEntry (
+  IN SMBIOS_INSTANCE    *Private,
+  IN EFI_SMBIOS_HANDLE  Handle
+  )
+{
+  LIST_ENTRY               *Head;
+  LIST_ENTRY               *Link;
+  EFI_SMBIOS_ENTRY         *SmbiosEntry;
+  EFI_SMBIOS_TABLE_HEADER  *Record;
+
+  Head = &Private->HandleHashHead[SMBIOS_HANDLE_HASH (Handle)];
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK (Link);
-    if (HandleEntry->SmbiosHandle == Handle) {
-      return TRUE;
+    SmbiosEntry = SMBIOS_ENTRY_FROM_HANDLE_LINK (Link);
+    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+    if (Record->Handle == Handle) {
+      return SmbiosEntry;
     }
   }
 
-  return FALSE;
+  return NULL;
+}
+
+/**
+  Account the size of an SMBIOS record in the length of the tables it is added to.
+
+  @param Private        Pointer to the SMBIOS instance.
+  @param SmbiosEntry    The SMBIOS entry of the record.
+  @param StructureSize  Size of the SMBIOS structure of the record, strings included.
+  @param Add            TRUE to add the record to the tables, FALSE to remove it.
+
+**/
+STATIC
+VOID
+SmbiosUpdateTableLength (
+  IN SMBIOS_INSTANCE   *Private,
+  IN EFI_SMBIOS_ENTRY  *SmbiosEntry,
+  IN UINTN             StructureSize,
+  IN BOOLEAN           Add
+  )
+{
+  if (SmbiosEntry->Smbios32BitTable) {
+    if (Add) {
+      Private->Table32BitLength += StructureSize;
+    } else {
+      Private->Table32BitLength -= StructureSize;
+    }
+  }
+
+  if (SmbiosEntry->Smbios64BitTable) {
+    if (Add) {
+      Private->Table64BitLength += StructureSize;
+    } else {
+      Private->Table64BitLength -= StructureSize;
+    }
+  }
+}
+
+/**
+  Construct the SMBIOS tables, or defer the construction to the next timer tick
+  so that a burst of updates only constructs them once.
+
+  The caller must hold the data lock.
+
+  @param  Smbios32BitTable    The flag to update 32-bit table.
+  @param  Smbios64BitTable    The flag to update 64-bit table.
+
+**/
+STATIC
+VOID
+SmbiosScheduleTableConstruction (
+  IN BOOLEAN  Smbios32BitTable,
+  IN BOOLEAN  Smbios64BitTable
+  )
+{
+  EFI_STATUS  Status;
+
+  if (mPrivateData.ConstructionEvent != NULL) {
+    Status = gBS->SetTimer (mPrivateData.ConstructionEvent, TimerRelative, 0);
+    if (!EFI_ERROR (Status)) {
+      mPrivateData.Pending32BitTable = (BOOLEAN)(mPrivateData.Pending32BitTable || Smbios32BitTable);
+      mPrivateData.Pending64BitTable = (BOOLEAN)(mPrivateData.Pending64BitTable || Smbios64BitTable);
+      return;
+    }
+  }
+
+  SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+}
+
+/**
+  Construct the SMBIOS tables whose construction is deferred.
+
+  The caller must hold the data lock.
+
+**/
+STATIC
+VOID
+SmbiosFlushTableConstruction (
+  VOID
+  )
+{
+  BOOLEAN  Smbios32BitTable;
+  BOOLEAN  Smbios64BitTable;
+
+  Smbios32BitTable               = mPrivateData.Pending32BitTable;
+  Smbios64BitTable               = mPrivateData.Pending64BitTable;
+  mPrivateData.Pending32BitTable = FALSE;
+  mPrivateData.Pending64BitTable = FALSE;
+  if (Smbios32BitTable || Smbios64BitTable) {
+    SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+  }
+}
+
+/**
+  Construct the deferred SMBIOS tables once the timer expires.
+
+  @param  Event     The timer event.
+  @param  Context   Not used.
+
+**/
+STATIC
+VOID
+EFIAPI
+SmbiosConstructionTimerNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  if (EFI_ERROR (EfiAcquireLockOrFail (&mPrivateData.DataLock))) {
+    return;
+  }
+
+  SmbiosFlushTableConstruction ();
+  EfiReleaseLock (&mPrivateData.DataLock);
+}
+
+/**
+  Construct the deferred SMBIOS tables before the tables are consumed at
+  EndOfDxe and ReadyToBoot. From ReadyToBoot on the tables are constructed on
+  each update again.
+
+  @param  Event     The EndOfDxe or ReadyToBoot event.
+  @param  Context   TRUE for ReadyToBoot.
+
+**/
+STATIC
+VOID
+EFIAPI
+SmbiosConstructionFlushNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  if (EFI_ERROR (EfiAcquireLockOrFail (&mPrivateData.DataLock))) {
+    return;
+  }
+
+  SmbiosFlushTableConstruction ();
+  if ((*(BOOLEAN *)Context) && (mPrivateData.ConstructionEvent != NULL)) {
+    gBS->CloseEvent (mPrivateData.ConstructionEvent);
+    mPrivateData.ConstructionEvent = NULL;
+  }
+
+  EfiReleaseLock (&mPrivateData.DataLock);
+  gBS->CloseEvent (Event);
 }
 
 /**
@@ -313,7 +486,6 @@ GetAvailableSmbiosHandle (
   IN OUT   EFI_SMBIOS_HANDLE    *Handle
   )
 {
-  LIST_ENTRY         *Head;
   SMBIOS_INSTANCE    *Private;
   EFI_SMBIOS_HANDLE  MaxSmbiosHandle;
   EFI_SMBIOS_HANDLE  AvailableHandle;
@@ -321,9 +493,16 @@ GetAvailableSmbiosHandle (
   GetMaxSmbiosHandle (This, &MaxSmbiosHandle);
 
   Private = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head    = &Private->AllocatedHandleListHead;
   for (AvailableHandle = 0; AvailableHandle < MaxSmbiosHandle; AvailableHandle++) {
-    if (!CheckSmbiosHandleExistance (Head, AvailableHandle)) {
+    //
+    // Skip 8 handles at a time while they are all allocated.
+    //
+    if (((AvailableHandle % 8) == 0) && (Private->AllocatedHandleBitmap[AvailableHandle / 8] == MAX_UINT8)) {
+      AvailableHandle += 7;
+      continue;
+    }
+
+    if (!CheckSmbiosHandleExistance (Private, AvailableHandle)) {
       *Handle = AvailableHandle;
       return EFI_SUCCESS;
     }
@@ -366,11 +545,9 @@ SmbiosAdd (
   UINTN                     StructureSize;
   UINTN                     NumberOfStrings;
   EFI_STATUS                Status;
-  LIST_ENTRY                *Head;
   SMBIOS_INSTANCE           *Private;
   EFI_SMBIOS_ENTRY          *SmbiosEntry;
   EFI_SMBIOS_HANDLE         MaxSmbiosHandle;
-  SMBIOS_HANDLE_ENTRY       *HandleEntry;
   EFI_SMBIOS_RECORD_HEADER  *InternalRecord;
   BOOLEAN                   Smbios32BitTable;
   BOOLEAN                   Smbios64BitTable;
@@ -383,8 +560,7 @@ SmbiosAdd (
   //
   // Check whether SmbiosHandle is already in use
   //
-  Head = &Private->AllocatedHandleListHead;
-  if ((*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) && CheckSmbiosHandleExistance (Head, *SmbiosHandle)) {
+  if ((*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) && CheckSmbiosHandleExistance (Private, *SmbiosHandle)) {
     return EFI_ALREADY_STARTED;
   }
 
@@ -424,9 +600,7 @@ SmbiosAdd (
     // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
     // which is a WORD field limited to 65,535 bytes. So the max size of 32-bit table should not exceed 65,535 bytes.
     //
-    if ((EntryPointStructure != NULL) &&
-        (EntryPointStructure->TableLength + StructureSize > SMBIOS_TABLE_MAX_LENGTH))
-    {
+    if (Private->Table32BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_TABLE_MAX_LENGTH) {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Total length exceeds max 32-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       Smbios32BitTable = TRUE;
@@ -442,9 +616,7 @@ SmbiosAdd (
     // For SMBIOS 64-bit table, Structure table maximum size in SMBIOS 3.0 (64-bit) Entry Point
     // is a DWORD field limited to 0xFFFFFFFF bytes. So the max size of 64-bit table should not exceed 0xFFFFFFFF bytes.
     //
-    if ((Smbios30EntryPointStructure != NULL) &&
-        (Smbios30EntryPointStructure->TableMaximumSize + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH))
-    {
+    if (Private->Table64BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Total length exceeds max 64-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Smbios type %d with size 0x%x is added to 64-bit table\n", Record->Type, StructureSize));
@@ -479,18 +651,10 @@ SmbiosAdd (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  HandleEntry = AllocateZeroPool (sizeof (SMBIOS_HANDLE_ENTRY));
-  if (HandleEntry == NULL) {
-    EfiReleaseLock (&Private->DataLock);
-    return EFI_OUT_OF_RESOURCES;
-  }
-
   //
-  // Build Handle Entry and insert into linked list
+  // Mark the handle allocated
   //
-  HandleEntry->Signature    = SMBIOS_HANDLE_ENTRY_SIGNATURE;
-  HandleEntry->SmbiosHandle = *SmbiosHandle;
-  InsertTailList (&Private->AllocatedHandleListHead, &HandleEntry->Link);
+  Private->AllocatedHandleBitmap[*SmbiosHandle / 8] |= (UINT8)(1 << (*SmbiosHandle % 8));
 
   InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(SmbiosEntry + 1);
   Raw            = (VOID *)(InternalRecord + 1);
@@ -511,7 +675,11 @@ SmbiosAdd (
   SmbiosEntry->RecordSize       = TotalSize;
   SmbiosEntry->Smbios32BitTable = Smbios32BitTable;
   SmbiosEntry->Smbios64BitTable = Smbios64BitTable;
+  SmbiosEntry->Sequence         = Private->NextSequence++;
   InsertTailList (&Private->DataListHead, &SmbiosEntry->Link);
+  InsertTailList (&Private->HandleHashHead[SMBIOS_HANDLE_HASH (*SmbiosHandle)], &SmbiosEntry->HandleLink);
+  InsertTailList (&Private->TypeListHead[Record->Type], &SmbiosEntry->TypeLink);
+  SmbiosUpdateTableLength (Private, SmbiosEntry, StructureSize, TRUE);
 
   CopyMem (Raw, Record, StructureSize);
   ((EFI_SMBIOS_TABLE_HEADER *)Raw)->Handle = *SmbiosHandle;
@@ -522,7 +690,7 @@ SmbiosAdd (
   // configuration table, so other UEFI drivers can get SMBIOS table from
   // configuration table without depending on PI SMBIOS protocol.
   //
-  SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+  SmbiosScheduleTableConstruction (Smbios32BitTable, Smbios64BitTable);
 
   //
   // Leave critical section
@@ -559,10 +727,10 @@ SmbiosUpdateString (
   UINTN                     StrIndex;
   UINTN                     TargetStrOffset;
   UINTN                     NewEntrySize;
+  UINTN                     StructureSize;
+  UINTN                     NewStructureSize;
   CHAR8                     *StrStart;
   VOID                      *Raw;
-  LIST_ENTRY                *Link;
-  LIST_ENTRY                *Head;
   EFI_STATUS                Status;
   SMBIOS_INSTANCE           *Private;
   EFI_SMBIOS_ENTRY          *SmbiosEntry;
@@ -623,166 +791,173 @@ SmbiosUpdateString (
     return Status;
   }
 
-  Head = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK (Link);
-    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+  SmbiosEntry = SmbiosFindEntry (Private, *SmbiosHandle);
+  if (SmbiosEntry != NULL) {
+    Record = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
 
-    if (Record->Handle == *SmbiosHandle) {
+    //
+    // Find out the specified SMBIOS record
+    //
+    if (*StringNumber > SmbiosEntry->RecordHeader->NumberOfStrings) {
+      EfiReleaseLock (&Private->DataLock);
+      return EFI_NOT_FOUND;
+    }
+
+    //
+    // Point to unformed string section
+    //
+    StrStart = (CHAR8 *)Record + Record->Length;
+
+    for (StrIndex = 1, TargetStrOffset = 0; StrIndex < *StringNumber; StrStart++, TargetStrOffset++) {
       //
-      // Find out the specified SMBIOS record
+      // A string ends in 00h
       //
-      if (*StringNumber > SmbiosEntry->RecordHeader->NumberOfStrings) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_NOT_FOUND;
+      if (*StrStart == 0) {
+        StrIndex++;
       }
 
       //
-      // Point to unformed string section
+      // String section ends in double-null (0000h)
       //
-      StrStart = (CHAR8 *)Record + Record->Length;
-
-      for (StrIndex = 1, TargetStrOffset = 0; StrIndex < *StringNumber; StrStart++, TargetStrOffset++) {
-        //
-        // A string ends in 00h
-        //
-        if (*StrStart == 0) {
-          StrIndex++;
-        }
-
-        //
-        // String section ends in double-null (0000h)
-        //
-        if ((*StrStart == 0) && (*(StrStart + 1) == 0)) {
-          EfiReleaseLock (&Private->DataLock);
-          return EFI_NOT_FOUND;
-        }
+      if ((*StrStart == 0) && (*(StrStart + 1) == 0)) {
+        EfiReleaseLock (&Private->DataLock);
+        return EFI_NOT_FOUND;
       }
+    }
 
-      if (*StrStart == 0) {
-        StrStart++;
-        TargetStrOffset++;
-      }
+    if (*StrStart == 0) {
+      StrStart++;
+      TargetStrOffset++;
+    }
 
+    //
+    // Now we get the string target
+    //
+    TargetStrLen = AsciiStrLen (StrStart);
+    if (InputStrLen == TargetStrLen) {
+      AsciiStrCpyS (StrStart, TargetStrLen + 1, String);
       //
-      // Now we get the string target
+      // Some UEFI drivers (such as network) need some information in SMBIOS table.
+      // Here we create SMBIOS table and publish it in
+      // configuration table, so other UEFI drivers can get SMBIOS table from
+      // configuration table without depending on PI SMBIOS protocol.
       //
-      TargetStrLen = AsciiStrLen (StrStart);
-      if (InputStrLen == TargetStrLen) {
-        AsciiStrCpyS (StrStart, TargetStrLen + 1, String);
-        //
-        // Some UEFI drivers (such as network) need some information in SMBIOS table.
-        // Here we create SMBIOS table and publish it in
-        // configuration table, so other UEFI drivers can get SMBIOS table from
-        // configuration table without depending on PI SMBIOS protocol.
-        //
-        SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_SUCCESS;
-      }
+      SmbiosScheduleTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+      EfiReleaseLock (&Private->DataLock);
+      return EFI_SUCCESS;
+    }
 
-      SmbiosEntry->Smbios32BitTable = FALSE;
-      SmbiosEntry->Smbios64BitTable = FALSE;
-      if ((This->MajorVersion < 0x3) ||
-          ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT0) == BIT0)))
-      {
+    //
+    // Take the record out of the table length before checking the resized record.
+    //
+    StructureSize    = SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
+    NewStructureSize = StructureSize + InputStrLen - TargetStrLen;
+    SmbiosUpdateTableLength (Private, SmbiosEntry, StructureSize, FALSE);
+
+    SmbiosEntry->Smbios32BitTable = FALSE;
+    SmbiosEntry->Smbios64BitTable = FALSE;
+    if ((This->MajorVersion < 0x3) ||
+        ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT0) == BIT0)))
+    {
+      //
+      // 32-bit table is produced, check the valid length.
+      //
+      if (Private->Table32BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + NewStructureSize > SMBIOS_TABLE_MAX_LENGTH) {
         //
-        // 32-bit table is produced, check the valid length.
+        // The length of the entire structure table (including all strings) must be reported
+        // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
+        // which is a WORD field limited to 65,535 bytes.
         //
-        if ((EntryPointStructure != NULL) &&
-            (EntryPointStructure->TableLength + InputStrLen - TargetStrLen > SMBIOS_TABLE_MAX_LENGTH))
-        {
-          //
-          // The length of the entire structure table (including all strings) must be reported
-          // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
-          // which is a WORD field limited to 65,535 bytes.
-          //
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 32-bit table length\n"));
-        } else {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 32-bit table\n"));
-          SmbiosEntry->Smbios32BitTable = TRUE;
-        }
+        DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 32-bit table length\n"));
+      } else {
+        DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 32-bit table\n"));
+        SmbiosEntry->Smbios32BitTable = TRUE;
       }
+    }
 
-      if ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT1) == BIT1)) {
-        //
-        // 64-bit table is produced, check the valid length.
-        //
-        if ((Smbios30EntryPointStructure != NULL) &&
-            (Smbios30EntryPointStructure->TableMaximumSize + InputStrLen - TargetStrLen > SMBIOS_3_0_TABLE_MAX_LENGTH))
-        {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 64-bit table length\n"));
-        } else {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 64-bit table\n"));
-          SmbiosEntry->Smbios64BitTable = TRUE;
-        }
+    if ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT1) == BIT1)) {
+      //
+      // 64-bit table is produced, check the valid length.
+      //
+      if (Private->Table64BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + NewStructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
+        DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 64-bit table length\n"));
+      } else {
+        DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 64-bit table\n"));
+        SmbiosEntry->Smbios64BitTable = TRUE;
       }
+    }
 
-      if ((!SmbiosEntry->Smbios32BitTable) && (!SmbiosEntry->Smbios64BitTable)) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_UNSUPPORTED;
-      }
+    if ((!SmbiosEntry->Smbios32BitTable) && (!SmbiosEntry->Smbios64BitTable)) {
+      EfiReleaseLock (&Private->DataLock);
+      return EFI_UNSUPPORTED;
+    }
 
-      //
-      // Original string buffer size is not exactly match input string length.
-      // Re-allocate buffer is needed.
-      //
-      NewEntrySize       = SmbiosEntry->RecordSize + InputStrLen - TargetStrLen;
-      ResizedSmbiosEntry = AllocateZeroPool (NewEntrySize);
+    //
+    // Original string buffer size is not exactly match input string length.
+    // Re-allocate buffer is needed.
+    //
+    NewEntrySize       = SmbiosEntry->RecordSize + InputStrLen - TargetStrLen;
+    ResizedSmbiosEntry = AllocateZeroPool (NewEntrySize);
 
-      if (ResizedSmbiosEntry == NULL) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_OUT_OF_RESOURCES;
-      }
+    if (ResizedSmbiosEntry == NULL) {
+      SmbiosUpdateTableLength (Private, SmbiosEntry, StructureSize, TRUE);
+      EfiReleaseLock (&Private->DataLock);
+      return EFI_OUT_OF_RESOURCES;
+    }
 
-      InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(ResizedSmbiosEntry + 1);
-      Raw            = (VOID *)(InternalRecord + 1);
+    InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(ResizedSmbiosEntry + 1);
+    Raw            = (VOID *)(InternalRecord + 1);
 
-      //
-      // Build internal record Header
-      //
-      InternalRecord->Version         = EFI_SMBIOS_RECORD_HEADER_VERSION;
-      InternalRecord->HeaderSize      = (UINT16)sizeof (EFI_SMBIOS_RECORD_HEADER);
-      InternalRecord->RecordSize      = SmbiosEntry->RecordHeader->RecordSize + InputStrLen - TargetStrLen;
-      InternalRecord->ProducerHandle  = SmbiosEntry->RecordHeader->ProducerHandle;
-      InternalRecord->NumberOfStrings = SmbiosEntry->RecordHeader->NumberOfStrings;
+    //
+    // Build internal record Header
+    //
+    InternalRecord->Version         = EFI_SMBIOS_RECORD_HEADER_VERSION;
+    InternalRecord->HeaderSize      = (UINT16)sizeof (EFI_SMBIOS_RECORD_HEADER);
+    InternalRecord->RecordSize      = SmbiosEntry->RecordHeader->RecordSize + InputStrLen - TargetStrLen;
+    InternalRecord->ProducerHandle  = SmbiosEntry->RecordHeader->ProducerHandle;
+    InternalRecord->NumberOfStrings = SmbiosEntry->RecordHeader->NumberOfStrings;
 
-      //
-      // Copy SMBIOS structure and optional strings.
-      //
-      CopyMem (Raw, SmbiosEntry->RecordHeader + 1, Record->Length + TargetStrOffset);
-      CopyMem ((VOID *)((UINTN)Raw + Record->Length + TargetStrOffset), String, InputStrLen + 1);
-      CopyMem (
-        (CHAR8 *)((UINTN)Raw + Record->Length + TargetStrOffset + InputStrLen + 1),
-        (CHAR8 *)Record + Record->Length + TargetStrOffset + TargetStrLen + 1,
-        SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) - Record->Length - TargetStrOffset - TargetStrLen - 1
-        );
+    //
+    // Copy SMBIOS structure and optional strings.
+    //
+    CopyMem (Raw, SmbiosEntry->RecordHeader + 1, Record->Length + TargetStrOffset);
+    CopyMem ((VOID *)((UINTN)Raw + Record->Length + TargetStrOffset), String, InputStrLen + 1);
+    CopyMem (
+      (CHAR8 *)((UINTN)Raw + Record->Length + TargetStrOffset + InputStrLen + 1),
+      (CHAR8 *)Record + Record->Length + TargetStrOffset + TargetStrLen + 1,
+      SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) - Record->Length - TargetStrOffset - TargetStrLen - 1
+      );
 
-      //
-      // Insert new record
-      //
-      ResizedSmbiosEntry->Signature        = EFI_SMBIOS_ENTRY_SIGNATURE;
-      ResizedSmbiosEntry->RecordHeader     = InternalRecord;
-      ResizedSmbiosEntry->RecordSize       = NewEntrySize;
-      ResizedSmbiosEntry->Smbios32BitTable = SmbiosEntry->Smbios32BitTable;
-      ResizedSmbiosEntry->Smbios64BitTable = SmbiosEntry->Smbios64BitTable;
-      InsertTailList (Link->ForwardLink, &ResizedSmbiosEntry->Link);
+    //
+    // Insert new record
+    //
+    ResizedSmbiosEntry->Signature        = EFI_SMBIOS_ENTRY_SIGNATURE;
+    ResizedSmbiosEntry->RecordHeader     = InternalRecord;
+    ResizedSmbiosEntry->RecordSize       = NewEntrySize;
+    ResizedSmbiosEntry->Smbios32BitTable = SmbiosEntry->Smbios32BitTable;
+    ResizedSmbiosEntry->Smbios64BitTable = SmbiosEntry->Smbios64BitTable;
+    ResizedSmbiosEntry->Sequence         = SmbiosEntry->Sequence;
+    InsertTailList (SmbiosEntry->Link.ForwardLink, &ResizedSmbiosEntry->Link);
+    InsertTailList (SmbiosEntry->TypeLink.ForwardLink, &ResizedSmbiosEntry->TypeLink);
+    InsertTailList (&Private->HandleHashHead[SMBIOS_HANDLE_HASH (*SmbiosHandle)], &ResizedSmbiosEntry->HandleLink);
+    SmbiosUpdateTableLength (Private, ResizedSmbiosEntry, NewStructureSize, TRUE);
 
-      //
-      // Remove old record
-      //
-      RemoveEntryList (Link);
-      FreePool (SmbiosEntry);
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
-      //
-      SmbiosTableConstruction (ResizedSmbiosEntry->Smbios32BitTable, ResizedSmbiosEntry->Smbios64BitTable);
-      EfiReleaseLock (&Private->DataLock);
-      return EFI_SUCCESS;
-    }
+    //
+    // Remove old record
+    //
+    RemoveEntryList (&SmbiosEntry->Link);
+    RemoveEntryList (&SmbiosEntry->TypeLink);
+    RemoveEntryList (&SmbiosEntry->HandleLink);
+    FreePool (SmbiosEntry);
+    //
+    // Some UEFI drivers (such as network) need some information in SMBIOS table.
+    // Here we create SMBIOS table and publish it in
+    // configuration table, so other UEFI drivers can get SMBIOS table from
+    // configuration table without depending on PI SMBIOS protocol.
+    //
+    SmbiosScheduleTableConstruction (ResizedSmbiosEntry->Smbios32BitTable, ResizedSmbiosEntry->Smbios64BitTable);
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_SUCCESS;
   }
 
   EfiReleaseLock (&Private->DataLock);
@@ -806,14 +981,10 @@ SmbiosRemove (
   IN EFI_SMBIOS_HANDLE          SmbiosHandle
   )
 {
-  LIST_ENTRY               *Link;
-  LIST_ENTRY               *Head;
-  EFI_STATUS               Status;
-  EFI_SMBIOS_HANDLE        MaxSmbiosHandle;
-  SMBIOS_INSTANCE          *Private;
-  EFI_SMBIOS_ENTRY         *SmbiosEntry;
-  SMBIOS_HANDLE_ENTRY      *HandleEntry;
-  EFI_SMBIOS_TABLE_HEADER  *Record;
+  EFI_STATUS         Status;
+  EFI_SMBIOS_HANDLE  MaxSmbiosHandle;
+  SMBIOS_INSTANCE    *Private;
+  EFI_SMBIOS_ENTRY   *SmbiosEntry;
 
   //
   // Check args validity
@@ -833,50 +1004,46 @@ SmbiosRemove (
     return Status;
   }
 
-  Head = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK (Link);
-    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
-    if (Record->Handle == SmbiosHandle) {
-      //
-      // Remove specified smobios record from DataList
-      //
-      RemoveEntryList (Link);
-      //
-      // Remove this handle from AllocatedHandleList
-      //
-      Head = &Private->AllocatedHandleListHead;
-      for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-        HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK (Link);
-        if (HandleEntry->SmbiosHandle == SmbiosHandle) {
-          RemoveEntryList (Link);
-          FreePool (HandleEntry);
-          break;
-        }
-      }
-
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
-      //
-      if (SmbiosEntry->Smbios32BitTable) {
-        DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 32-bit table\n"));
-      }
+  SmbiosEntry = SmbiosFindEntry (Private, SmbiosHandle);
+  if (SmbiosEntry != NULL) {
+    //
+    // Remove specified smobios record from DataList and the indexes
+    //
+    RemoveEntryList (&SmbiosEntry->Link);
+    RemoveEntryList (&SmbiosEntry->HandleLink);
+    RemoveEntryList (&SmbiosEntry->TypeLink);
+    SmbiosUpdateTableLength (
+      Private,
+      SmbiosEntry,
+      SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER),
+      FALSE
+      );
+    //
+    // Release this handle
+    //
+    Private->AllocatedHandleBitmap[SmbiosHandle / 8] &= (UINT8) ~(1 << (SmbiosHandle % 8));
 
-      if (SmbiosEntry->Smbios64BitTable) {
-        DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 64-bit table\n"));
-      }
+    //
+    // Some UEFI drivers (such as network) need some information in SMBIOS table.
+    // Here we create SMBIOS table and publish it in
+    // configuration table, so other UEFI drivers can get SMBIOS table from
+    // configuration table without depending on PI SMBIOS protocol.
+    //
+    if (SmbiosEntry->Smbios32BitTable) {
+      DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 32-bit table\n"));
+    }
 
-      //
-      // Update the whole SMBIOS table again based on which table the removed SMBIOS record is in.
-      //
-      SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
-      FreePool (SmbiosEntry);
-      EfiReleaseLock (&Private->DataLock);
-      return EFI_SUCCESS;
+    if (SmbiosEntry->Smbios64BitTable) {
+      DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 64-bit table\n"));
     }
+
+    //
+    // Update the whole SMBIOS table again based on which table the removed SMBIOS record is in.
+    //
+    SmbiosScheduleTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+    FreePool (SmbiosEntry);
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_SUCCESS;
   }
 
   //
@@ -914,10 +1081,10 @@ SmbiosGetNext (
   OUT EFI_HANDLE                *ProducerHandle OPTIONAL
   )
 {
-  BOOLEAN                  StartPointFound;
   LIST_ENTRY               *Link;
   LIST_ENTRY               *Head;
   SMBIOS_INSTANCE          *Private;
+  EFI_SMBIOS_ENTRY         *StartEntry;
   EFI_SMBIOS_ENTRY         *SmbiosEntry;
   EFI_SMBIOS_TABLE_HEADER  *SmbiosTableHeader;
 
@@ -925,51 +1092,60 @@ SmbiosGetNext (
     return EFI_INVALID_PARAMETER;
   }
 
-  StartPointFound = FALSE;
-  Private         = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head            = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry       = SMBIOS_ENTRY_FROM_LINK (Link);
-    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+  Private = SMBIOS_INSTANCE_FROM_THIS (This);
 
-    //
-    // If SmbiosHandle is 0xFFFE, the first matched SMBIOS record handle will be returned
-    //
-    if (*SmbiosHandle == SMBIOS_HANDLE_PI_RESERVED) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
-      }
+  //
+  // If SmbiosHandle is 0xFFFE, the first matched SMBIOS record handle will be returned,
+  // otherwise start this round search from the next SMBIOS handle
+  //
+  StartEntry = NULL;
+  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) {
+    StartEntry = SmbiosFindEntry (Private, *SmbiosHandle);
+    if (StartEntry == NULL) {
+      *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
+      return EFI_NOT_FOUND;
+    }
+  }
 
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record       = SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
+  SmbiosEntry = NULL;
+  if (Type == NULL) {
+    Head = &Private->DataListHead;
+    Link = (StartEntry == NULL) ? Head->ForwardLink : StartEntry->Link.ForwardLink;
+    if (Link != Head) {
+      SmbiosEntry = SMBIOS_ENTRY_FROM_LINK (Link);
+    }
+  } else {
+    Head = &Private->TypeListHead[*Type];
+    if ((StartEntry != NULL) && (((EFI_SMBIOS_TABLE_HEADER *)(StartEntry->RecordHeader + 1))->Type == *Type)) {
+      Link = StartEntry->TypeLink.ForwardLink;
+    } else {
+      //
+      // The next record of this type is the first one behind the start record in DataListHead
+      //
+      for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
+        SmbiosEntry = SMBIOS_ENTRY_FROM_TYPE_LINK (Link);
+        if ((StartEntry == NULL) || (SmbiosEntry->Sequence > StartEntry->Sequence)) {
+          break;
+        }
       }
 
-      return EFI_SUCCESS;
+      SmbiosEntry = NULL;
     }
 
-    //
-    // Start this round search from the next SMBIOS handle
-    //
-    if (!StartPointFound && (*SmbiosHandle == SmbiosTableHeader->Handle)) {
-      StartPointFound = TRUE;
-      continue;
+    if (Link != Head) {
+      SmbiosEntry = SMBIOS_ENTRY_FROM_TYPE_LINK (Link);
     }
+  }
 
-    if (StartPointFound) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
-      }
-
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record       = SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
-      }
-
-      return EFI_SUCCESS;
+  if (SmbiosEntry != NULL) {
+    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+    *SmbiosHandle     = SmbiosTableHeader->Handle;
+    *Record           = SmbiosTableHeader;
+    if (ProducerHandle != NULL) {
+      *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
     }
+
+    return EFI_SUCCESS;
   }
 
   *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
@@ -1746,6 +1922,8 @@ SmbiosDriverEntryPoint (
   )
 {
   EFI_STATUS  Status;
+  UINTN       Index;
+  EFI_EVENT   Event;
 
   mPrivateData.Signature           = SMBIOS_INSTANCE_SIGNATURE;
   mPrivateData.Smbios.Add          = SmbiosAdd;
@@ -1756,9 +1934,48 @@ SmbiosDriverEntryPoint (
   mPrivateData.Smbios.MinorVersion = (UINT8)(PcdGet16 (PcdSmbiosVersion) & 0x00ff);
 
   InitializeListHead (&mPrivateData.DataListHead);
-  InitializeListHead (&mPrivateData.AllocatedHandleListHead);
+  for (Index = 0; Index < SMBIOS_HANDLE_HASH_SIZE; Index++) {
+    InitializeListHead (&mPrivateData.HandleHashHead[Index]);
+  }
+
+  for (Index = 0; Index <= MAX_UINT8; Index++) {
+    InitializeListHead (&mPrivateData.TypeListHead[Index]);
+  }
+
   EfiInitializeLock (&mPrivateData.DataLock, TPL_NOTIFY);
 
+  if (FeaturePcdGet (PcdSmbiosDeferTableConstruction)) {
+    //
+    // Construct the tables at most once per timer tick while records are added,
+    // and before they are consumed at EndOfDxe and ReadyToBoot.
+    //
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    SmbiosConstructionTimerNotify,
+                    NULL,
+                    &mPrivateData.ConstructionEvent
+                    );
+    if (!EFI_ERROR (Status)) {
+      Status = gBS->CreateEventEx (
+                      EVT_NOTIFY_SIGNAL,
+                      TPL_NOTIFY,
+                      SmbiosConstructionFlushNotify,
+                      &mSmbiosEndOfDxe,
+                      &gEfiEndOfDxeEventGroupGuid,
+                      &Event
+                      );
+      ASSERT_EFI_ERROR (Status);
+      Status = EfiCreateEventReadyToBootEx (
+                 TPL_NOTIFY,
+                 SmbiosConstructionFlushNotify,
+                 &mSmbiosReadyToBoot,
+                 &Event
+                 );
+      ASSERT_EFI_ERROR (Status);
+    }
+  }
+
   //
   // Make a new handle and install the protocol
   //
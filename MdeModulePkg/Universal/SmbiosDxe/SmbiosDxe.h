@@ -26,6 +26,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HobLib.h>
 #include <UniversalPayload/SmbiosTable.h>
 
+//
+// Number of buckets of the SMBIOS handle hash, must be a power of 2.
+//
+#define SMBIOS_HANDLE_HASH_SIZE  128
+#define SMBIOS_HANDLE_HASH(Handle)  ((Handle) & (SMBIOS_HANDLE_HASH_SIZE - 1))
+
 #define SMBIOS_INSTANCE_SIGNATURE  SIGNATURE_32 ('S', 'B', 'i', 's')
 typedef struct {
   UINT32                 Signature;
@@ -43,9 +49,33 @@ typedef struct {
   //
   LIST_ENTRY             DataListHead;
   //
-  // List of allocated SMBIOS handle.
+  // Allocated SMBIOS handles, one bit per handle.
+  //
+  UINT8                  AllocatedHandleBitmap[(MAX_UINT16 + 1) / 8];
+  //
+  // EFI_SMBIOS_ENTRY structures hashed by SMBIOS handle.
+  //
+  LIST_ENTRY             HandleHashHead[SMBIOS_HANDLE_HASH_SIZE];
+  //
+  // EFI_SMBIOS_ENTRY structures of each SMBIOS type, in the order of DataListHead.
+  //
+  LIST_ENTRY             TypeListHead[MAX_UINT8 + 1];
+  //
+  // Sequence number of the next record added to DataListHead.
+  //
+  UINTN                  NextSequence;
+  //
+  // Size of the records in the 32-bit and 64-bit tables, End-of-Table structure excluded.
+  //
+  UINTN                  Table32BitLength;
+  UINT64                 Table64BitLength;
+  //
+  // Timer event the table construction is deferred to. NULL when the tables
+  // are constructed on each update.
   //
-  LIST_ENTRY             AllocatedHandleListHead;
+  EFI_EVENT              ConstructionEvent;
+  BOOLEAN                Pending32BitTable;
+  BOOLEAN                Pending64BitTable;
 } SMBIOS_INSTANCE;
 
 #define SMBIOS_INSTANCE_FROM_THIS(this)  CR (this, SMBIOS_INSTANCE, Smbios, SMBIOS_INSTANCE_SIGNATURE)
@@ -74,6 +104,15 @@ typedef struct {
 typedef struct {
   UINT32                      Signature;
   LIST_ENTRY                  Link;
+  //
+  // Links in SMBIOS_INSTANCE.HandleHashHead and SMBIOS_INSTANCE.TypeListHead.
+  //
+  LIST_ENTRY                  HandleLink;
+  LIST_ENTRY                  TypeLink;
+  //
+  // Position of the record in DataListHead.
+  //
+  UINTN                       Sequence;
   EFI_SMBIOS_RECORD_HEADER    *RecordHeader;
   UINTN                       RecordSize;
   //
@@ -83,23 +122,9 @@ typedef struct {
   BOOLEAN                     Smbios64BitTable;
 } EFI_SMBIOS_ENTRY;
 
-#define SMBIOS_ENTRY_FROM_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, Link, EFI_SMBIOS_ENTRY_SIGNATURE)
-
-//
-// Private data to contain the Smbios handle that already allocated.
-//
-#define SMBIOS_HANDLE_ENTRY_SIGNATURE  SIGNATURE_32 ('S', 'h', 'r', 'd')
-
-typedef struct {
-  UINT32               Signature;
-  LIST_ENTRY           Link;
-  //
-  // Filter driver will register what record guid filter should be used.
-  //
-  EFI_SMBIOS_HANDLE    SmbiosHandle;
-} SMBIOS_HANDLE_ENTRY;
-
-#define SMBIOS_HANDLE_ENTRY_FROM_LINK(link)  CR (link, SMBIOS_HANDLE_ENTRY, Link, SMBIOS_HANDLE_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_LINK(link)         CR (link, EFI_SMBIOS_ENTRY, Link, EFI_SMBIOS_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_HANDLE_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, HandleLink, EFI_SMBIOS_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_TYPE_LINK(link)    CR (link, EFI_SMBIOS_ENTRY, TypeLink, EFI_SMBIOS_ENTRY_SIGNATURE)
 
 typedef struct {
   EFI_SMBIOS_TABLE_HEADER    Header;
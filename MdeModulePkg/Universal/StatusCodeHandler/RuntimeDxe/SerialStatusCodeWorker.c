@@ -8,6 +8,248 @@
 
 #include "StatusCodeHandlerRuntimeDxe.h"
 
+//
+// Ring buffer the serial status code messages are queued in when
+// PcdStatusCodeSerialBufferSize is not zero. The buffer is drained by a
+// periodic timer so a status code report does not wait for the UART.
+//
+UINT8      *mSerialBuffer = NULL;
+UINTN      mSerialBufferSize;
+UINTN      mSerialBufferHead;
+UINTN      mSerialBufferCount;
+UINTN      mSerialBufferDropped;
+EFI_EVENT  mSerialDrainEvent = NULL;
+
+/**
+  Copy data into the serial ring buffer.
+
+  The caller must hold TPL_HIGH_LEVEL and make sure the data fits.
+
+  @param  Data    Data to queue.
+  @param  Length  Number of bytes of Data.
+
+**/
+STATIC
+VOID
+SerialBufferPut (
+  IN CONST UINT8  *Data,
+  IN UINTN        Length
+  )
+{
+  UINTN  Tail;
+  UINTN  Chunk;
+
+  Tail = (mSerialBufferHead + mSerialBufferCount) % mSerialBufferSize;
+  while (Length > 0) {
+    Chunk = MIN (Length, mSerialBufferSize - Tail);
+    CopyMem (&mSerialBuffer[Tail], Data, Chunk);
+    mSerialBufferCount += Chunk;
+    Data               += Chunk;
+    Length             -= Chunk;
+    Tail                = 0;
+  }
+}
+
+/**
+  Write up to Length bytes from the serial ring buffer to the serial port.
+
+  The caller must hold TPL_HIGH_LEVEL.
+
+  @param  Length  The maximum number of bytes to write.
+
+**/
+STATIC
+VOID
+SerialBufferWrite (
+  IN UINTN  Length
+  )
+{
+  UINTN  Chunk;
+
+  Length = MIN (Length, mSerialBufferCount);
+  while (Length > 0) {
+    Chunk = MIN (Length, mSerialBufferSize - mSerialBufferHead);
+    SerialPortWrite (&mSerialBuffer[mSerialBufferHead], Chunk);
+    mSerialBufferHead   = (mSerialBufferHead + Chunk) % mSerialBufferSize;
+    mSerialBufferCount -= Chunk;
+    Length             -= Chunk;
+  }
+}
+
+/**
+  Queue a message in the serial ring buffer.
+
+  A message which does not fit is dropped as a whole and counted, and the
+  number of dropped messages is reported once the buffer has room again.
+
+  @param  Message  Message to queue.
+  @param  Length   Number of bytes of Message.
+
+**/
+STATIC
+VOID
+SerialBufferQueue (
+  IN CONST CHAR8  *Message,
+  IN UINTN        Length
+  )
+{
+  EFI_TPL  OldTpl;
+  CHAR8    Notice[64];
+  UINTN    NoticeLength;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  NoticeLength = 0;
+  if (mSerialBufferDropped != 0) {
+    NoticeLength = AsciiSPrint (
+                     Notice,
+                     sizeof (Notice),
+                     "\n\r[%d status code messages dropped]\n\r",
+                     mSerialBufferDropped
+                     );
+  }
+
+  if (NoticeLength + Length > mSerialBufferSize - mSerialBufferCount) {
+    mSerialBufferDropped++;
+  } else {
+    if (NoticeLength != 0) {
+      SerialBufferPut ((UINT8 *)Notice, NoticeLength);
+      mSerialBufferDropped = 0;
+    }
+
+    SerialBufferPut ((CONST UINT8 *)Message, Length);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Write everything queued in the serial ring buffer to the serial port.
+
+**/
+STATIC
+VOID
+SerialBufferFlush (
+  VOID
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  SerialBufferWrite (mSerialBufferCount);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Timer notification which moves a burst of the serial ring buffer to the
+  serial port whenever the UART is able to take it without waiting.
+
+  @param  Event    Event whose notification function is being invoked.
+  @param  Context  Pointer to the notification function's context.
+
+**/
+STATIC
+VOID
+EFIAPI
+SerialBufferDrain (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Control;
+  EFI_TPL     OldTpl;
+
+  if (mSerialBufferCount == 0) {
+    return;
+  }
+
+  //
+  // Skip this tick if the UART is still sending the previous burst. A serial
+  // port library that cannot tell gets one burst per tick.
+  //
+  Status = SerialPortGetControl (&Control);
+  if (!EFI_ERROR (Status) && ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) == 0)) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  SerialBufferWrite (PcdGet32 (PcdStatusCodeSerialDrainSize));
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Allocate the serial ring buffer and start the timer draining it, if
+  PcdStatusCodeSerialBufferSize is not zero.
+
+  @retval EFI_SUCCESS           The serial ring buffer is ready, or it is not
+                                enabled and status codes are written directly.
+  @retval EFI_OUT_OF_RESOURCES  The ring buffer could not be allocated.
+  @retval others                Errors from creating or setting the timer.
+
+**/
+EFI_STATUS
+SerialStatusCodeInitializeBuffer (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Buffer;
+
+  if (PcdGet32 (PcdStatusCodeSerialBufferSize) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Buffer = AllocatePool (PcdGet32 (PcdStatusCodeSerialBufferSize));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  SerialBufferDrain,
+                  NULL,
+                  &mSerialDrainEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (Buffer);
+    return Status;
+  }
+
+  Status = gBS->SetTimer (mSerialDrainEvent, TimerPeriodic, SERIAL_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mSerialDrainEvent);
+    mSerialDrainEvent = NULL;
+    FreePool (Buffer);
+    return Status;
+  }
+
+  mSerialBufferSize = PcdGet32 (PcdStatusCodeSerialBufferSize);
+  mSerialBuffer     = Buffer;
+  return EFI_SUCCESS;
+}
+
+/**
+  Write out what is left in the serial ring buffer and stop queuing status
+  codes, so the ones reported from now on are written directly.
+
+  It is called while exiting boot services, when neither timer events nor
+  freeing memory are allowed any more, so the buffer and the timer event are
+  left alone.
+
+**/
+VOID
+SerialStatusCodeStopBuffer (
+  VOID
+  )
+{
+  if (mSerialBuffer != NULL) {
+    SerialBufferFlush ();
+    mSerialBuffer = NULL;
+  }
+}
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
 
@@ -45,8 +287,10 @@ SerialStatusCodeReportWorker (
   UINT32     LineNumber;
   UINTN      CharCount;
   BASE_LIST  Marker;
+  BOOLEAN    IsAssert;
 
   Buffer[0] = '\0';
+  IsAssert  = FALSE;
 
   if ((Data != NULL) &&
       ReportStatusCodeExtractAssertInfo (CodeType, Value, Data, &Filename, &Description, &LineNumber))
@@ -54,6 +298,7 @@ SerialStatusCodeReportWorker (
     //
     // Print ASSERT() information into output buffer.
     //
+    IsAssert  = TRUE;
     CharCount = AsciiSPrint (
                   Buffer,
                   sizeof (Buffer),
@@ -149,10 +394,21 @@ SerialStatusCodeReportWorker (
                   );
   }
 
-  //
-  // Call SerialPort Lib function to do print.
-  //
-  SerialPortWrite ((UINT8 *)Buffer, CharCount);
+  if (mSerialBuffer == NULL) {
+    //
+    // Call SerialPort Lib function to do print.
+    //
+    SerialPortWrite ((UINT8 *)Buffer, CharCount);
+  } else if (IsAssert) {
+    //
+    // The system may stop in the ASSERT(), so write the queued messages and
+    // the ASSERT() information out right now.
+    //
+    SerialBufferFlush ();
+    SerialPortWrite ((UINT8 *)Buffer, CharCount);
+  } else {
+    SerialBufferQueue (Buffer, CharCount);
+  }
 
   //
   // If register an unregister function of gEfiEventExitBootServicesGuid,
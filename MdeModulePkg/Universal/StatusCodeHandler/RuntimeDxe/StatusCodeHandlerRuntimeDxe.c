@@ -24,6 +24,7 @@ UnregisterSerialBootTimeHandlers (
   )
 {
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
+    SerialStatusCodeStopBuffer ();
     mRscHandlerProtocol->Unregister (SerialStatusCodeReportWorker);
   }
 }
@@ -80,6 +81,12 @@ InitializationDispatcherWorker (
     //
     Status = SerialPortInitialize ();
     ASSERT_EFI_ERROR (Status);
+
+    //
+    // Queue the serial output in a ring buffer if the platform asks for it.
+    //
+    Status = SerialStatusCodeInitializeBuffer ();
+    ASSERT_EFI_ERROR (Status);
   }
 
   if (PcdGetBool (PcdStatusCodeUseMemory)) {
@@ -35,6 +35,11 @@
 //
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 
+//
+// Period of the timer draining the serial ring buffer, in 100ns units (1ms)
+//
+#define SERIAL_DRAIN_PERIOD  10000
+
 extern RUNTIME_MEMORY_STATUSCODE_HEADER  *mRtMemoryStatusCodeTable;
 
 /**
@@ -48,6 +53,31 @@ EfiSerialStatusCodeInitializeWorker (
   VOID
   );
 
+/**
+  Allocate the serial ring buffer and start the timer draining it, if
+  PcdStatusCodeSerialBufferSize is not zero.
+
+  @retval EFI_SUCCESS           The serial ring buffer is ready, or it is not
+                                enabled and status codes are written directly.
+  @retval EFI_OUT_OF_RESOURCES  The ring buffer could not be allocated.
+  @retval others                Errors from creating or setting the timer.
+
+**/
+EFI_STATUS
+SerialStatusCodeInitializeBuffer (
+  VOID
+  );
+
+/**
+  Write out what is left in the serial ring buffer and stop queuing status
+  codes, so the ones reported from now on are written directly.
+
+**/
+VOID
+SerialStatusCodeStopBuffer (
+  VOID
+  );
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
 
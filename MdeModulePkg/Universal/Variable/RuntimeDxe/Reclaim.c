@@ -92,6 +92,11 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Reclaim keeps the order of the variables it copies, so the blocks before
+  the first dropped variable and the blocks that were already erased usually
+  hold the new content already. Only the range of blocks from the first to
+  the last one that differs is written, still as a single FTW write record.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
 
@@ -106,12 +111,21 @@ FtwVariableSpace (
   IN VARIABLE_STORE_HEADER  *VariableBuffer
   )
 {
-  EFI_STATUS                         Status;
-  EFI_HANDLE                         FvbHandle;
-  EFI_LBA                            VarLba;
-  UINTN                              VarOffset;
-  UINTN                              FtwBufferSize;
-  EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
+  EFI_STATUS                          Status;
+  EFI_HANDLE                          FvbHandle;
+  EFI_LBA                             VarLba;
+  UINTN                               VarOffset;
+  UINTN                               FtwBufferSize;
+  EFI_FAULT_TOLERANT_WRITE_PROTOCOL   *FtwProtocol;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
+  UINTN                               BlockSize;
+  UINTN                               NumberOfBlocks;
+  UINTN                               FirstBlock;
+  UINTN                               LastBlock;
+  UINTN                               WriteStart;
+  UINTN                               WriteEnd;
+  UINT8                               *Flash;
+  UINT8                               *Buffer;
 
   //
   // Locate fault tolerant write protocol.
@@ -124,7 +138,7 @@ FtwVariableSpace (
   //
   // Locate Fvb handle by address.
   //
-  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, NULL);
+  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, &Fvb);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -140,17 +154,61 @@ FtwVariableSpace (
   FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
 
+  WriteStart = 0;
+  WriteEnd   = FtwBufferSize;
+  Status     = Fvb->GetBlockSize (Fvb, VarLba, &BlockSize, &NumberOfBlocks);
+  if (!EFI_ERROR (Status) && (BlockSize != 0)) {
+    //
+    // Block N of the range covers store bytes [N * BlockSize - VarOffset, (N + 1) * BlockSize - VarOffset).
+    // Skip the leading and trailing blocks whose content is unchanged.
+    //
+    Flash      = (UINT8 *)(UINTN)VariableBase;
+    Buffer     = (UINT8 *)VariableBuffer;
+    FirstBlock = 0;
+    LastBlock  = (VarOffset + FtwBufferSize - 1) / BlockSize;
+    while (FirstBlock <= LastBlock) {
+      WriteStart = (FirstBlock == 0) ? 0 : FirstBlock * BlockSize - VarOffset;
+      WriteEnd   = MIN ((FirstBlock + 1) * BlockSize - VarOffset, FtwBufferSize);
+      if (CompareMem (Flash + WriteStart, Buffer + WriteStart, WriteEnd - WriteStart) != 0) {
+        break;
+      }
+
+      FirstBlock++;
+    }
+
+    if (FirstBlock > LastBlock) {
+      return EFI_SUCCESS;
+    }
+
+    while (LastBlock > FirstBlock) {
+      WriteStart = LastBlock * BlockSize - VarOffset;
+      WriteEnd   = MIN ((LastBlock + 1) * BlockSize - VarOffset, FtwBufferSize);
+      if (CompareMem (Flash + WriteStart, Buffer + WriteStart, WriteEnd - WriteStart) != 0) {
+        break;
+      }
+
+      LastBlock--;
+    }
+
+    WriteStart = (FirstBlock == 0) ? 0 : FirstBlock * BlockSize - VarOffset;
+    WriteEnd   = MIN ((LastBlock + 1) * BlockSize - VarOffset, FtwBufferSize);
+    if (FirstBlock != 0) {
+      VarLba   += FirstBlock;
+      VarOffset = 0;
+    }
+  }
+
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,                // LBA
-                          VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
-                          NULL,                  // PrivateData NULL
-                          FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          VarLba,                                       // LBA
+                          VarOffset,                                    // Offset
+                          WriteEnd - WriteStart,                        // NumBytes
+                          NULL,                                         // PrivateData NULL
+                          FvbHandle,                                    // Fvb Handle
+                          (VOID *)((UINT8 *)VariableBuffer + WriteStart) // write buffer
                           );
 
   return Status;
@@ -29,6 +29,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "VariableNonVolatile.h"
 #include "VariableParsing.h"
 #include "VariableRuntimeCache.h"
+#include "VariableHashIndex.h"
 
 VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 
@@ -814,6 +815,11 @@ Done:
     ASSERT_EFI_ERROR (DoneStatus);
   }
 
+  //
+  // The store has been rewritten, its hash index no longer matches.
+  //
+  VariableHashIndexReset (IsVolatile ? VariableStoreTypeVolatile : VariableStoreTypeNv);
+
   if (!EFI_ERROR (Status) && EFI_ERROR (DoneStatus)) {
     Status = DoneStatus;
   }
@@ -885,13 +891,25 @@ FindVariable (
     PtrTrack->EndPtr   = GetEndPointer (VariableStoreHeader[Type]);
     PtrTrack->Volatile = (BOOLEAN)(Type == VariableStoreTypeVolatile);
 
-    Status =  FindVariableEx (
-                VariableName,
-                VendorGuid,
-                IgnoreRtCheck,
-                PtrTrack,
-                mVariableModuleGlobal->VariableGlobal.AuthFormat
-                );
+    Status = VariableHashIndexFind (
+               Type,
+               VariableStoreHeader[Type],
+               VariableName,
+               VendorGuid,
+               IgnoreRtCheck,
+               PtrTrack,
+               mVariableModuleGlobal->VariableGlobal.AuthFormat
+               );
+    if (Status == EFI_UNSUPPORTED) {
+      Status =  FindVariableEx (
+                  VariableName,
+                  VendorGuid,
+                  IgnoreRtCheck,
+                  PtrTrack,
+                  mVariableModuleGlobal->VariableGlobal.AuthFormat
+                  );
+    }
+
     if (!EFI_ERROR (Status)) {
       return Status;
     }
@@ -1656,6 +1674,61 @@ AutoUpdateLangVariable (
   }
 }
 
+/**
+  Synchronizes a runtime variable cache with the parts of its variable store touched by UpdateVariable().
+
+  UpdateVariable() only changes the header of the variable it replaces and appends the new
+  variable at the end of the store, so only those ranges are copied to the runtime cache.
+  A reclaim of the store synchronizes the whole runtime cache on its own.
+
+  @param[in] VariableRuntimeCache  The runtime cache mirroring the variable store.
+  @param[in] VariableStoreHeader   The variable store UpdateVariable() changed.
+  @param[in] OldVariable           The variable UpdateVariable() replaced or deleted, NULL if none.
+  @param[in] FirstOffset           The last variable offset of the store before the update.
+  @param[in] LastOffset            The last variable offset of the store after the update.
+
+  @retval EFI_SUCCESS              The touched ranges were added to the runtime cache pending updates.
+  @return Others                   The runtime cache could not be synchronized.
+
+**/
+STATIC
+EFI_STATUS
+SynchronizeRuntimeVariableCacheForUpdate (
+  IN VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN VARIABLE_STORE_HEADER   *VariableStoreHeader,
+  IN VARIABLE_HEADER         *OldVariable OPTIONAL,
+  IN UINTN                   FirstOffset,
+  IN UINTN                   LastOffset
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       HeaderSize;
+
+  HeaderSize = GetVariableHeaderSize (mVariableModuleGlobal->VariableGlobal.AuthFormat);
+  if ((OldVariable != NULL) &&
+      ((UINTN)OldVariable >= (UINTN)GetStartPointer (VariableStoreHeader)) &&
+      ((UINTN)OldVariable + HeaderSize <= (UINTN)VariableStoreHeader + VariableStoreHeader->Size))
+  {
+    Status = SynchronizeRuntimeVariableCache (
+               VariableRuntimeCache,
+               (UINTN)OldVariable - (UINTN)VariableStoreHeader,
+               HeaderSize
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (LastOffset >= FirstOffset) {
+    return SynchronizeRuntimeVariableCache (VariableRuntimeCache, FirstOffset, LastOffset - FirstOffset);
+  }
+
+  //
+  // The store shrank, it was reclaimed.
+  //
+  return SynchronizeRuntimeVariableCache (VariableRuntimeCache, 0, VariableStoreHeader->Size);
+}
+
 /**
   Update the variable region with Variable information. If EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS is set,
   index of associated public key is needed.
@@ -1710,6 +1783,8 @@ UpdateVariable (
   BOOLEAN                             IsCommonUserVariable;
   AUTHENTICATED_VARIABLE_HEADER       *AuthVariable;
   BOOLEAN                             AuthFormat;
+  UINTN                               NonVolatileLastVariableOffset;
+  UINTN                               VolatileLastVariableOffset;
 
   if ((mVariableModuleGlobal->FvbInstance == NULL) && !mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     //
@@ -1733,6 +1808,13 @@ UpdateVariable (
 
   AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
 
+  //
+  // Remember where the stores end, only what is appended past these offsets has to be
+  // synchronized to the runtime cache.
+  //
+  NonVolatileLastVariableOffset = mVariableModuleGlobal->NonVolatileLastVariableOffset;
+  VolatileLastVariableOffset    = mVariableModuleGlobal->VolatileLastVariableOffset;
+
   //
   // Check if CacheVariable points to the variable in variable HOB.
   // If yes, let CacheVariable points to the variable in NV variable cache.
@@ -2389,17 +2471,28 @@ Done:
   if (!EFI_ERROR (Status)) {
     if (((Variable->CurrPtr != NULL) && !Variable->Volatile) || ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)) {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache);
+      if (VolatileCacheInstance->Store != NULL) {
+        Status = SynchronizeRuntimeVariableCacheForUpdate (
+                   VolatileCacheInstance,
+                   mNvVariableCache,
+                   CacheVariable->CurrPtr,
+                   NonVolatileLastVariableOffset,
+                   mVariableModuleGlobal->NonVolatileLastVariableOffset
+                   );
+        ASSERT_EFI_ERROR (Status);
+      }
     } else {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache);
-    }
-
-    if (VolatileCacheInstance->Store != NULL) {
-      Status =  SynchronizeRuntimeVariableCache (
-                  VolatileCacheInstance,
-                  0,
-                  VolatileCacheInstance->Store->Size
-                  );
-      ASSERT_EFI_ERROR (Status);
+      if (VolatileCacheInstance->Store != NULL) {
+        Status = SynchronizeRuntimeVariableCacheForUpdate (
+                   VolatileCacheInstance,
+                   (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase,
+                   CacheVariable->CurrPtr,
+                   VolatileLastVariableOffset,
+                   mVariableModuleGlobal->VolatileLastVariableOffset
+                   );
+        ASSERT_EFI_ERROR (Status);
+      }
     }
   }
 
@@ -3805,6 +3898,8 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved  = 0;
   VolatileVariableStore->Reserved1 = 0;
 
+  VariableHashIndexInitialize ();
+
   return EFI_SUCCESS;
 }
 
@@ -64,16 +64,28 @@ typedef enum {
   VariableStoreTypeMax
 } VARIABLE_STORE_TYPE;
 
+///
+/// The number of disjoint byte ranges a runtime cache tracks as pending.
+/// Updates beyond this are merged into the closest pending range.
+///
+#define VARIABLE_RUNTIME_CACHE_MAX_PENDING_RANGES  8
+
+typedef struct {
+  UINT32    Offset;
+  UINT32    Length;
+} VARIABLE_RUNTIME_CACHE_RANGE;
+
 typedef struct {
-  UINT32                   PendingUpdateOffset;
-  UINT32                   PendingUpdateLength;
-  VARIABLE_STORE_HEADER    *Store;
+  UINTN                           PendingUpdateCount;
+  VARIABLE_RUNTIME_CACHE_RANGE    PendingUpdate[VARIABLE_RUNTIME_CACHE_MAX_PENDING_RANGES];
+  VARIABLE_STORE_HEADER           *Store;
 } VARIABLE_RUNTIME_CACHE;
 
 typedef struct {
   BOOLEAN                   *ReadLock;
   BOOLEAN                   *PendingUpdate;
   BOOLEAN                   *HobFlushComplete;
+  UINT32                    *Generation;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeVolatileCache;
@@ -11,8 +11,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Variable.h"
+#include "VariableHashIndex.h"
 
 #include <Protocol/VariablePolicy.h>
+#include <Protocol/VariableBatch.h>
 #include <Library/VariablePolicyLib.h>
 
 EFI_STATUS
@@ -21,12 +23,21 @@ ProtocolIsVariablePolicyEnabled (
   OUT BOOLEAN  *State
   );
 
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          EntryCount,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
 EFI_HANDLE                      mHandle                      = NULL;
 EFI_EVENT                       mVirtualAddressChangeEvent   = NULL;
 VOID                            *mFtwRegistration            = NULL;
 VOID                            ***mVarCheckAddressPointer   = NULL;
 UINTN                           mVarCheckAddressPointerCount = 0;
 EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock                = { VariableLockRequestToLock };
+EDKII_VARIABLE_BATCH_PROTOCOL   mVariableBatch               = { VariableBatchSetVariables };
 EDKII_VARIABLE_POLICY_PROTOCOL  mVariablePolicyProtocol      = {
   EDKII_VARIABLE_POLICY_PROTOCOL_REVISION,
   DisableVariablePolicy,
@@ -266,6 +277,11 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **)&mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **)&mNvFvHeaderCache);
 
+  for (Index = 0; Index < VariableStoreTypeMax; Index++) {
+    EfiConvertPointer (0x0, (VOID **)&mVariableHashIndex[Index].Buckets);
+    EfiConvertPointer (0x0, (VOID **)&mVariableHashIndex[Index].Entries);
+  }
+
   if (mAuthContextOut.AddressPointer != NULL) {
     for (Index = 0; Index < mAuthContextOut.AddressPointerCount; Index++) {
       EfiConvertPointer (0x0, (VOID **)mAuthContextOut.AddressPointer[Index]);
@@ -362,6 +378,66 @@ OnEndOfDxe (
   gBS->CloseEvent (Event);
 }
 
+/**
+  Set a batch of variables.
+
+  Every entry is checked first; if any of them is not a valid SetVariable()
+  request, nothing is set. The variables are then set in order, and the status
+  of each one is returned in its entry. A failure does not stop the variables
+  that follow it from being set.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The variables to set.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER This or Entries is NULL, or an entry has a NULL or empty
+                                VariableName, a NULL VendorGuid, or a NULL Data with a non
+                                zero DataSize. No variable was set.
+  @return Others                The status of the first entry that failed.
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          EntryCount,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  if ((This == NULL) || ((EntryCount != 0) && (Entries == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((Entries[Index].VariableName == NULL) || (Entries[Index].VariableName[0] == 0) ||
+        (Entries[Index].VendorGuid == NULL) || ((Entries[Index].DataSize != 0) && (Entries[Index].Data == NULL)))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Entries[Index].Status = EFI_NOT_STARTED;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entries[Index].Status = VariableServiceSetVariable (
+                              Entries[Index].VariableName,
+                              Entries[Index].VendorGuid,
+                              Entries[Index].Attributes,
+                              Entries[Index].DataSize,
+                              Entries[Index].Data
+                              );
+    if (EFI_ERROR (Entries[Index].Status) && !EFI_ERROR (Status)) {
+      Status = Entries[Index].Status;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Initializes variable write service for DXE.
 
@@ -385,12 +461,14 @@ VariableWriteServiceInitializeDxe (
   RecordSecureBootPolicyVarData ();
 
   //
-  // Install the Variable Write Architectural protocol.
+  // Install the Variable Write Architectural protocol and the Variable Batch protocol.
   //
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &mHandle,
                   &gEfiVariableWriteArchProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
+                  NULL,
+                  &gEdkiiVariableBatchProtocolGuid,
+                  &mVariableBatch,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -0,0 +1,324 @@
+/** @file
+  Name and GUID hash index over the volatile and non-volatile variable stores.
+
+  Each indexed store keeps one entry per variable header, keyed by a hash of the
+  variable name and vendor GUID and holding the offset of the header from the
+  start of the store. Headers are only appended to a store between two
+  reclaims, so the index is kept current by scanning the part of the store past
+  the last indexed header before every lookup. A reclaim rewrites the store and
+  resets its index. The variable state is not part of the index: it is checked
+  on the header itself, as FindVariableEx() does.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableHashIndex.h"
+#include "VariableParsing.h"
+
+VARIABLE_HASH_INDEX  mVariableHashIndex[VariableStoreTypeMax];
+
+/**
+  Compute the hash of a variable name and vendor GUID (32-bit FNV-1a).
+
+  @param[in] Name               Pointer to the variable name.
+  @param[in] NameSize           Size of the variable name in bytes, including the terminator.
+  @param[in] VendorGuid         Pointer to the vendor GUID.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+VariableHashIndexHash (
+  IN CONST VOID      *Name,
+  IN UINTN           NameSize,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  CONST UINT8  *Byte;
+  UINT32       Hash;
+  UINTN        Index;
+
+  Hash = 0x811C9DC5;
+  Byte = Name;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Byte[Index]) * 0x01000193;
+  }
+
+  Byte = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Byte[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Allocate the hash index of one variable store.
+
+  @param[in] Type               The variable store to index.
+  @param[in] StoreSize          Size of the variable store in bytes.
+
+**/
+STATIC
+VOID
+VariableHashIndexAllocate (
+  IN VARIABLE_STORE_TYPE  Type,
+  IN UINTN                StoreSize
+  )
+{
+  VARIABLE_HASH_INDEX  *HashIndex;
+  UINT32               MaxEntryCount;
+  UINT32               BucketCount;
+
+  HashIndex = &mVariableHashIndex[Type];
+
+  //
+  // Every variable takes at least a header and a one character name.
+  //
+  MaxEntryCount = (UINT32)(StoreSize / (GetVariableHeaderSize (mVariableModuleGlobal->VariableGlobal.AuthFormat) + 2 * sizeof (CHAR16)));
+  BucketCount   = MAX (GetPowerOfTwo32 (MaxEntryCount), 16);
+
+  HashIndex->Buckets = AllocateRuntimeZeroPool (BucketCount * sizeof (UINT32));
+  HashIndex->Entries = AllocateRuntimePool (MaxEntryCount * sizeof (VARIABLE_HASH_ENTRY));
+  if ((HashIndex->Buckets == NULL) || (HashIndex->Entries == NULL)) {
+    if (HashIndex->Buckets != NULL) {
+      FreePool (HashIndex->Buckets);
+    }
+
+    if (HashIndex->Entries != NULL) {
+      FreePool (HashIndex->Entries);
+    }
+
+    ZeroMem (HashIndex, sizeof (*HashIndex));
+    return;
+  }
+
+  HashIndex->BucketMask    = BucketCount - 1;
+  HashIndex->MaxEntryCount = MaxEntryCount;
+  VariableHashIndexReset (Type);
+}
+
+/**
+  Allocate the hash indexes of the volatile store and of the non-volatile
+  variable cache. The indexes are filled on the first lookup.
+
+  Does nothing unless PcdVariableHashIndexEnable is TRUE. Lookups fall back to
+  walking the store if the memory can not be allocated.
+
+**/
+VOID
+VariableHashIndexInitialize (
+  VOID
+  )
+{
+  if (!FeaturePcdGet (PcdVariableHashIndexEnable)) {
+    return;
+  }
+
+  VariableHashIndexAllocate (
+    VariableStoreTypeVolatile,
+    ((VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase)->Size
+    );
+  if (mNvVariableCache != NULL) {
+    VariableHashIndexAllocate (VariableStoreTypeNv, mNvVariableCache->Size);
+  }
+}
+
+/**
+  Drop all the entries of the hash index of a variable store, so that it is
+  rebuilt on the next lookup. Must be called whenever the store is rewritten
+  rather than appended to, as it is by Reclaim().
+
+  @param[in] Type               The variable store whose index is reset.
+
+**/
+VOID
+VariableHashIndexReset (
+  IN VARIABLE_STORE_TYPE  Type
+  )
+{
+  VARIABLE_HASH_INDEX  *HashIndex;
+
+  HashIndex = &mVariableHashIndex[Type];
+  if (HashIndex->Buckets == NULL) {
+    return;
+  }
+
+  ZeroMem (HashIndex->Buckets, (HashIndex->BucketMask + 1) * sizeof (UINT32));
+  HashIndex->EntryCount  = 0;
+  HashIndex->IndexedSize = 0;
+  HashIndex->Overflow    = FALSE;
+}
+
+/**
+  Add the variable headers appended to the store since the last call to its index.
+
+  A header whose variable is not completely added yet is only skipped if other
+  headers follow it, as the variable being written is always the last one.
+
+  @param[in] HashIndex          The hash index of the store.
+  @param[in] VariableStore      The header of the variable store.
+  @param[in] AuthFormat         TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+VariableHashIndexSync (
+  IN VARIABLE_HASH_INDEX    *HashIndex,
+  IN VARIABLE_STORE_HEADER  *VariableStore,
+  IN BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER      *StartPtr;
+  VARIABLE_HEADER      *EndPtr;
+  VARIABLE_HEADER      *Variable;
+  VARIABLE_HEADER      *NextVariable;
+  VARIABLE_HASH_ENTRY  *Entry;
+  UINTN                NameSize;
+  UINT8                *Name;
+  UINT32               Bucket;
+
+  StartPtr = GetStartPointer (VariableStore);
+  EndPtr   = GetEndPointer (VariableStore);
+  Variable = (VARIABLE_HEADER *)((UINTN)StartPtr + HashIndex->IndexedSize);
+
+  while (!HashIndex->Overflow && IsValidVariableHeader (Variable, EndPtr)) {
+    NextVariable = GetNextVariablePtr (Variable, AuthFormat);
+    if (Variable->State == VAR_HEADER_VALID_ONLY) {
+      if (!IsValidVariableHeader (NextVariable, EndPtr)) {
+        break;
+      }
+    } else if ((Variable->State == VAR_ADDED) || (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+      if (HashIndex->EntryCount == HashIndex->MaxEntryCount) {
+        HashIndex->Overflow = TRUE;
+        break;
+      }
+
+      NameSize = NameSizeOfVariable (Variable, AuthFormat);
+      Name     = (UINT8 *)GetVariableNamePtr (Variable, AuthFormat);
+      if ((NameSize != 0) && (Name + NameSize <= (UINT8 *)EndPtr)) {
+        Entry         = &HashIndex->Entries[HashIndex->EntryCount];
+        Entry->Hash   = VariableHashIndexHash (Name, NameSize, GetVendorGuidPtr (Variable, AuthFormat));
+        Entry->Offset = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+        Bucket        = Entry->Hash & HashIndex->BucketMask;
+        Entry->Next   = HashIndex->Buckets[Bucket];
+        HashIndex->EntryCount++;
+        HashIndex->Buckets[Bucket] = HashIndex->EntryCount;
+      }
+    }
+
+    Variable               = NextVariable;
+    HashIndex->IndexedSize = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+  }
+}
+
+/**
+  Find a variable by name and GUID through the hash index of a variable store.
+
+  The result is the same as the one FindVariableEx() returns for the store.
+  Variables appended to the store since the last lookup are added to the
+  index first.
+
+  @param[in]       Type                The variable store to search.
+  @param[in]       VariableStore       The header of the variable store to search.
+  @param[in]       VariableName        Name of the variable to be found.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+                                       StartPtr and EndPtr must describe VariableStore.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval EFI_SUCCESS           Variable found successfully.
+  @retval EFI_NOT_FOUND         Variable not found.
+  @retval EFI_UNSUPPORTED       The store has no usable index; use FindVariableEx() instead.
+
+**/
+EFI_STATUS
+VariableHashIndexFind (
+  IN     VARIABLE_STORE_TYPE     Type,
+  IN     VARIABLE_STORE_HEADER   *VariableStore,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_HASH_INDEX  *HashIndex;
+  VARIABLE_HASH_ENTRY  *Entry;
+  VARIABLE_HEADER      *Variable;
+  VARIABLE_HEADER      *AddedVariable;
+  VARIABLE_HEADER      *InDeletedVariable;
+  UINTN                NameSize;
+  UINT32               Hash;
+  UINT32               EntryIndex;
+
+  if (!FeaturePcdGet (PcdVariableHashIndexEnable) || (Type >= VariableStoreTypeMax) || (VariableName[0] == 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  HashIndex = &mVariableHashIndex[Type];
+  if (HashIndex->Buckets == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  VariableHashIndexSync (HashIndex, VariableStore, AuthFormat);
+  if (HashIndex->Overflow) {
+    return EFI_UNSUPPORTED;
+  }
+
+  NameSize = StrSize (VariableName);
+  Hash     = VariableHashIndexHash (VariableName, NameSize, VendorGuid);
+
+  //
+  // Bucket chains are in descending offset order. Like the walk in
+  // FindVariableEx(), pick the first added variable in store order, and the
+  // last in-deleted-transition one before it.
+  //
+  AddedVariable     = NULL;
+  InDeletedVariable = NULL;
+  for (EntryIndex = HashIndex->Buckets[Hash & HashIndex->BucketMask]; EntryIndex != 0; EntryIndex = Entry->Next) {
+    Entry = &HashIndex->Entries[EntryIndex - 1];
+    if (Entry->Hash != Hash) {
+      continue;
+    }
+
+    Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry->Offset);
+    if ((Variable->State != VAR_ADDED) && (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+      continue;
+    }
+
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+
+    if ((NameSizeOfVariable (Variable, AuthFormat) != NameSize) ||
+        !CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSize) != 0))
+    {
+      continue;
+    }
+
+    if (Variable->State == VAR_ADDED) {
+      AddedVariable     = Variable;
+      InDeletedVariable = NULL;
+    } else if (InDeletedVariable == NULL) {
+      InDeletedVariable = Variable;
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+  } else {
+    PtrTrack->CurrPtr                = InDeletedVariable;
+    PtrTrack->InDeletedTransitionPtr = NULL;
+  }
+
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
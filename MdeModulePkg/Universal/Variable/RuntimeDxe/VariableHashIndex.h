@@ -0,0 +1,92 @@
+/** @file
+  Name and GUID hash index over the volatile and non-volatile variable stores,
+  shared by the DXE_RUNTIME variable module and the DXE_SMM variable module.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_HASH_INDEX_H_
+#define _VARIABLE_HASH_INDEX_H_
+
+#include "Variable.h"
+
+typedef struct {
+  UINT32    Hash;
+  UINT32    Offset;               // Offset of the variable header from the start of the store
+  UINT32    Next;                 // Index + 1 of the next entry in the bucket, 0 for the last
+} VARIABLE_HASH_ENTRY;
+
+typedef struct {
+  UINT32                 *Buckets;
+  VARIABLE_HASH_ENTRY    *Entries;
+  UINT32                 BucketMask;
+  UINT32                 MaxEntryCount;
+  UINT32                 EntryCount;
+  UINT32                 IndexedSize; // Bytes from the start of the store covered by the index
+  BOOLEAN                Overflow;
+} VARIABLE_HASH_INDEX;
+
+extern VARIABLE_HASH_INDEX  mVariableHashIndex[VariableStoreTypeMax];
+
+/**
+  Allocate the hash indexes of the volatile store and of the non-volatile
+  variable cache. The indexes are filled on the first lookup.
+
+  Does nothing unless PcdVariableHashIndexEnable is TRUE. Lookups fall back to
+  walking the store if the memory can not be allocated.
+
+**/
+VOID
+VariableHashIndexInitialize (
+  VOID
+  );
+
+/**
+  Drop all the entries of the hash index of a variable store, so that it is
+  rebuilt on the next lookup. Must be called whenever the store is rewritten
+  rather than appended to, as it is by Reclaim().
+
+  @param[in] Type               The variable store whose index is reset.
+
+**/
+VOID
+VariableHashIndexReset (
+  IN VARIABLE_STORE_TYPE  Type
+  );
+
+/**
+  Find a variable by name and GUID through the hash index of a variable store.
+
+  The result is the same as the one FindVariableEx() returns for the store.
+  Variables appended to the store since the last lookup are added to the
+  index first.
+
+  @param[in]       Type                The variable store to search.
+  @param[in]       VariableStore       The header of the variable store to search.
+  @param[in]       VariableName        Name of the variable to be found.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+                                       StartPtr and EndPtr must describe VariableStore.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval EFI_SUCCESS           Variable found successfully.
+  @retval EFI_NOT_FOUND         Variable not found.
+  @retval EFI_UNSUPPORTED       The store has no usable index; use FindVariableEx() instead.
+
+**/
+EFI_STATUS
+VariableHashIndexFind (
+  IN     VARIABLE_STORE_TYPE     Type,
+  IN     VARIABLE_STORE_HEADER   *VariableStore,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
+#endif
@@ -18,9 +18,119 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 extern VARIABLE_STORE_HEADER   *mNvVariableCache;
 
+/**
+  Copies the pending ranges of a runtime variable cache from its source store.
+
+  @param[in, out] VariableRuntimeCache  The runtime cache to update.
+  @param[in]      Source                The variable store the runtime cache mirrors.
+
+**/
+STATIC
+VOID
+FlushRuntimeVariableCacheRanges (
+  IN OUT VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN     VOID                    *Source
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < VariableRuntimeCache->PendingUpdateCount; Index++) {
+    CopyMem (
+      (UINT8 *)VariableRuntimeCache->Store + VariableRuntimeCache->PendingUpdate[Index].Offset,
+      (UINT8 *)Source + VariableRuntimeCache->PendingUpdate[Index].Offset,
+      VariableRuntimeCache->PendingUpdate[Index].Length
+      );
+  }
+
+  VariableRuntimeCache->PendingUpdateCount = 0;
+}
+
+/**
+  Adds a byte range to the pending ranges of a runtime variable cache.
+
+  Overlapping and adjacent ranges are merged. When all the range slots are in use,
+  the range is merged with the closest pending range, so the cache is never left
+  without a range covering an update.
+
+  @param[in, out] VariableRuntimeCache  The runtime cache to update.
+  @param[in]      Offset                Offset in bytes of the range.
+  @param[in]      Length                Length in bytes of the range.
+
+**/
+STATIC
+VOID
+AddRuntimeVariableCachePendingRange (
+  IN OUT VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN     UINTN                   Offset,
+  IN     UINTN                   Length
+  )
+{
+  VARIABLE_RUNTIME_CACHE_RANGE  *Range;
+  UINTN                         Start;
+  UINTN                         End;
+  UINTN                         Index;
+  UINTN                         Closest;
+  UINTN                         Gap;
+  UINTN                         ClosestGap;
+
+  Start = Offset;
+  End   = Offset + Length;
+
+  while (TRUE) {
+    //
+    // Absorb every pending range that overlaps or touches [Start, End).
+    //
+    Index = 0;
+    while (Index < VariableRuntimeCache->PendingUpdateCount) {
+      Range = &VariableRuntimeCache->PendingUpdate[Index];
+      if ((Range->Offset <= End) && (Start <= (UINTN)Range->Offset + Range->Length)) {
+        Start = MIN (Start, (UINTN)Range->Offset);
+        End   = MAX (End, (UINTN)Range->Offset + Range->Length);
+        VariableRuntimeCache->PendingUpdateCount--;
+        *Range = VariableRuntimeCache->PendingUpdate[VariableRuntimeCache->PendingUpdateCount];
+        continue;
+      }
+
+      Index++;
+    }
+
+    if (VariableRuntimeCache->PendingUpdateCount < VARIABLE_RUNTIME_CACHE_MAX_PENDING_RANGES) {
+      break;
+    }
+
+    //
+    // No free slot, merge with the closest pending range and check the overlaps again.
+    //
+    Closest    = 0;
+    ClosestGap = MAX_UINTN;
+    for (Index = 0; Index < VariableRuntimeCache->PendingUpdateCount; Index++) {
+      Range = &VariableRuntimeCache->PendingUpdate[Index];
+      Gap   = (Range->Offset > End) ? (Range->Offset - End) : (Start - (Range->Offset + Range->Length));
+      if (Gap < ClosestGap) {
+        Closest    = Index;
+        ClosestGap = Gap;
+      }
+    }
+
+    Range = &VariableRuntimeCache->PendingUpdate[Closest];
+    Start = MIN (Start, (UINTN)Range->Offset);
+    End   = MAX (End, (UINTN)Range->Offset + Range->Length);
+    VariableRuntimeCache->PendingUpdateCount--;
+    *Range = VariableRuntimeCache->PendingUpdate[VariableRuntimeCache->PendingUpdateCount];
+  }
+
+  Range                                    = &VariableRuntimeCache->PendingUpdate[VariableRuntimeCache->PendingUpdateCount];
+  Range->Offset                            = (UINT32)Start;
+  Range->Length                            = (UINT32)(End - Start);
+  VariableRuntimeCache->PendingUpdateCount = VariableRuntimeCache->PendingUpdateCount + 1;
+}
+
 /**
   Copies any pending updates to runtime variable caches.
 
+  Only the pending ranges are copied. The runtime cache generation is advanced so the
+  runtime cache consumer can tell that the cache content changed.
+
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
   @retval EFI_SUCCESS             The volatile store was updated successfully.
 
@@ -36,7 +146,8 @@ FlushPendingRuntimeVariableCacheUpdates (
 
   if ((VariableRuntimeCacheContext->VariableRuntimeNvCache.Store == NULL) ||
       (VariableRuntimeCacheContext->VariableRuntimeVolatileCache.Store == NULL) ||
-      (VariableRuntimeCacheContext->PendingUpdate == NULL))
+      (VariableRuntimeCacheContext->PendingUpdate == NULL) ||
+      (VariableRuntimeCacheContext->Generation == NULL))
   {
     return EFI_UNSUPPORTED;
   }
@@ -45,49 +156,25 @@ FlushPendingRuntimeVariableCacheUpdates (
     if ((VariableRuntimeCacheContext->VariableRuntimeHobCache.Store != NULL) &&
         (mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0))
     {
-      CopyMem (
-        (VOID *)(
-                 ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeHobCache.Store) +
-                 VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-                 ),
-        (VOID *)(
-                 ((UINT8 *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase) +
-                 VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-                 ),
-        VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength
+      FlushRuntimeVariableCacheRanges (
+        &VariableRuntimeCacheContext->VariableRuntimeHobCache,
+        (VOID *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase
         );
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
+    } else {
+      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateCount = 0;
     }
 
-    CopyMem (
-      (VOID *)(
-               ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeNvCache.Store) +
-               VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-               ),
-      (VOID *)(
-               ((UINT8 *)(UINTN)mNvVariableCache) +
-               VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-               ),
-      VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength
+    FlushRuntimeVariableCacheRanges (
+      &VariableRuntimeCacheContext->VariableRuntimeNvCache,
+      mNvVariableCache
       );
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-
-    CopyMem (
-      (VOID *)(
-               ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeVolatileCache.Store) +
-               VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-               ),
-      (VOID *)(
-               ((UINT8 *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase) +
-               VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-               ),
-      VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength
+    FlushRuntimeVariableCacheRanges (
+      &VariableRuntimeCacheContext->VariableRuntimeVolatileCache,
+      (VOID *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase
       );
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
-    *(VariableRuntimeCacheContext->PendingUpdate)                                 = FALSE;
+
+    *(VariableRuntimeCacheContext->Generation)    = *(VariableRuntimeCacheContext->Generation) + 1;
+    *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
   }
 
   return EFI_SUCCESS;
@@ -131,21 +218,12 @@ SynchronizeRuntimeVariableCache (
     return EFI_UNSUPPORTED;
   }
 
-  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) &&
-      (VariableRuntimeCache->PendingUpdateLength > 0))
-  {
-    VariableRuntimeCache->PendingUpdateLength =
-      (UINT32)(
-               MAX (
-                 (UINTN)(VariableRuntimeCache->PendingUpdateOffset + VariableRuntimeCache->PendingUpdateLength),
-                 Offset + Length
-                 ) - MIN ((UINTN)VariableRuntimeCache->PendingUpdateOffset, Offset)
-               );
-    VariableRuntimeCache->PendingUpdateOffset =
-      (UINT32)MIN ((UINTN)VariableRuntimeCache->PendingUpdateOffset, Offset);
-  } else {
-    VariableRuntimeCache->PendingUpdateLength = (UINT32)Length;
-    VariableRuntimeCache->PendingUpdateOffset = (UINT32)Offset;
+  if (!*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate)) {
+    VariableRuntimeCache->PendingUpdateCount = 0;
+  }
+
+  if (Length > 0) {
+    AddRuntimeVariableCachePendingRange (VariableRuntimeCache, Offset, Length);
   }
 
   *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) = TRUE;
@@ -424,6 +424,95 @@ SmmVariableGetStatistics (
   return EFI_SUCCESS;
 }
 
+/**
+  Set the variables of a SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH request.
+
+  Caution: This function may receive untrusted input.
+  The batch is external input, so every record is validated before any variable is set.
+
+  @param[in, out] Batch         The batch, copied into SMRAM. The status of every record is
+                                updated.
+  @param[in]      BatchSize     The size of the batch in bytes.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_ACCESS_DENIED     The batch is malformed. No variable was set.
+  @return Others                The status of the first record that failed.
+
+**/
+STATIC
+EFI_STATUS
+SmmSetVariableBatch (
+  IN OUT SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *Batch,
+  IN     UINTN                                        BatchSize
+  )
+{
+  EFI_STATUS                             Status;
+  SMM_VARIABLE_COMMUNICATE_BATCH_RECORD  *Record;
+  UINTN                                  Offset;
+  UINTN                                  RecordSize;
+  UINTN                                  Index;
+
+  //
+  // Validate all the records first.
+  //
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < Batch->VariableCount; Index++) {
+    if (BatchSize - Offset < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD, Variable.Name)) {
+      return EFI_ACCESS_DENIED;
+    }
+
+    Record = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)((UINT8 *)Batch + Offset);
+    if ((Record->Variable.NameSize > BatchSize) || (Record->Variable.DataSize > BatchSize)) {
+      //
+      // Prevent RecordSize overflow happen
+      //
+      return EFI_ACCESS_DENIED;
+    }
+
+    RecordSize = SMM_VARIABLE_BATCH_RECORD_SIZE (Record->Variable.NameSize, Record->Variable.DataSize);
+    if (RecordSize > BatchSize - Offset) {
+      DEBUG ((DEBUG_ERROR, "SetVariableBatch: Data size exceed communication buffer size limit!\n"));
+      return EFI_ACCESS_DENIED;
+    }
+
+    if ((Record->Variable.NameSize < sizeof (CHAR16)) || (Record->Variable.Name[Record->Variable.NameSize/sizeof (CHAR16) - 1] != L'\0')) {
+      //
+      // Make sure VariableName is A Null-terminated string.
+      //
+      return EFI_ACCESS_DENIED;
+    }
+
+    Offset += RecordSize;
+  }
+
+  //
+  // The VariableSpeculationBarrier() call here is to ensure the previous
+  // range/content checks for the batch have been completed before the
+  // subsequent consumption of the batch content.
+  //
+  VariableSpeculationBarrier ();
+
+  Status = EFI_SUCCESS;
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < Batch->VariableCount; Index++) {
+    Record         = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)((UINT8 *)Batch + Offset);
+    Record->Status = VariableServiceSetVariable (
+                       Record->Variable.Name,
+                       &Record->Variable.Guid,
+                       Record->Variable.Attributes,
+                       Record->Variable.DataSize,
+                       (UINT8 *)Record->Variable.Name + Record->Variable.NameSize
+                       );
+    if (EFI_ERROR (Record->Status) && !EFI_ERROR (Status)) {
+      Status = Record->Status;
+    }
+
+    Offset += SMM_VARIABLE_BATCH_RECORD_SIZE (Record->Variable.NameSize, Record->Variable.DataSize);
+  }
+
+  return Status;
+}
+
 /**
   Communication service SMI Handler entry.
 
@@ -665,6 +754,24 @@ SmmVariableHandler (
                  );
       break;
 
+    case SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+        DEBUG ((DEBUG_ERROR, "SetVariableBatch: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload,
+      // and return the status of every record through the communicate buffer.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      Status = SmmSetVariableBatch (
+                 (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *)mVariableBufferPayload,
+                 CommBufferPayloadSize
+                 );
+      CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
+      break;
+
     case SMM_VARIABLE_FUNCTION_QUERY_VARIABLE_INFO:
       if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_QUERY_VARIABLE_INFO)) {
         DEBUG ((DEBUG_ERROR, "QueryVariableInfo: SMM communication buffer size invalid!\n"));
@@ -840,7 +947,8 @@ SmmVariableHandler (
           (RuntimeVariableCacheContext->RuntimeNvCache == NULL) ||
           (RuntimeVariableCacheContext->PendingUpdate == NULL) ||
           (RuntimeVariableCacheContext->ReadLock == NULL) ||
-          (RuntimeVariableCacheContext->HobFlushComplete == NULL))
+          (RuntimeVariableCacheContext->HobFlushComplete == NULL) ||
+          (RuntimeVariableCacheContext->Generation == NULL))
       {
         DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Required runtime cache buffer is NULL!\n"));
         Status = EFI_ACCESS_DENIED;
@@ -924,6 +1032,16 @@ SmmVariableHandler (
         goto EXIT;
       }
 
+      if (!VariableSmmIsBufferOutsideSmmValid (
+             (UINTN)RuntimeVariableCacheContext->Generation,
+             sizeof (*(RuntimeVariableCacheContext->Generation))
+             ))
+      {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache generation buffer in SMRAM or overflow!\n"));
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
+
       VariableCacheContext                                     = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
       VariableCacheContext->VariableRuntimeVolatileCache.Store = RuntimeVariableCacheContext->RuntimeVolatileCache;
@@ -931,26 +1049,30 @@ SmmVariableHandler (
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
       VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->Generation                         = RuntimeVariableCacheContext->Generation;
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
+      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateCount = 0;
       if ((mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0) &&
           (VariableCacheContext->VariableRuntimeHobCache.Store != NULL))
       {
-        VariableCache                                                     = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase;
-        VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+        VariableCache                                                         = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase;
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdateCount      = 1;
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdate[0].Offset = 0;
+        VariableCacheContext->VariableRuntimeHobCache.PendingUpdate[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
         CopyGuid (&(VariableCacheContext->VariableRuntimeHobCache.Store->Signature), &(VariableCache->Signature));
       }
 
-      VariableCache                                                          = (VARIABLE_STORE_HEADER  *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+      VariableCache                                                              = (VARIABLE_STORE_HEADER  *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateCount      = 1;
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdate[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdate[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
       CopyGuid (&(VariableCacheContext->VariableRuntimeVolatileCache.Store->Signature), &(VariableCache->Signature));
 
-      VariableCache                                                    = (VARIABLE_STORE_HEADER  *)(UINTN)mNvVariableCache;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+      VariableCache                                                        = (VARIABLE_STORE_HEADER  *)(UINTN)mNvVariableCache;
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateCount      = 1;
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdate[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeNvCache.PendingUpdate[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
       CopyGuid (&(VariableCacheContext->VariableRuntimeNvCache.Store->Signature), &(VariableCache->Signature));
 
       *(VariableCacheContext->PendingUpdate)    = TRUE;
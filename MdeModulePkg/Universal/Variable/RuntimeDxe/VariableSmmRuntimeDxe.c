@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmVariable.h>
 #include <Protocol/VariableLock.h>
 #include <Protocol/VarCheck.h>
+#include <Protocol/VariableBatch.h>
 
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -53,6 +54,7 @@ VARIABLE_INFO_ENTRY             *mVariableInfo                       = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeHobCacheBuffer      = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeNvCacheBuffer       = NULL;
 VARIABLE_STORE_HEADER           *mVariableRuntimeVolatileCacheBuffer = NULL;
+VARIABLE_HEADER                 *mVariableRuntimeCacheLastVariable   = NULL;
 UINTN                           mVariableBufferSize;
 UINTN                           mVariableRuntimeHobCacheBufferSize;
 UINTN                           mVariableRuntimeNvCacheBufferSize;
@@ -60,11 +62,16 @@ UINTN                           mVariableRuntimeVolatileCacheBufferSize;
 UINTN                           mVariableBufferPayloadSize;
 BOOLEAN                         mVariableRuntimeCachePendingUpdate;
 BOOLEAN                         mVariableRuntimeCacheReadLock;
+UINT32                          mVariableRuntimeCacheGeneration;
+UINT32                          mVariableRuntimeCacheLastGeneration;
+BOOLEAN                         mVariableRuntimeCacheLastVolatile;
+BOOLEAN                         mVariableRuntimeCacheLastAtRuntime;
 BOOLEAN                         mVariableAuthFormat;
 BOOLEAN                         mHobFlushComplete;
 EFI_LOCK                        mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
+EDKII_VARIABLE_BATCH_PROTOCOL   mVariableBatch;
 
 /**
   The logic to initialize the VariablePolicy engine is in its own file.
@@ -584,10 +591,47 @@ CheckForRuntimeCacheSync (
       FreePages (mVariableRuntimeHobCacheBuffer, EFI_SIZE_TO_PAGES (mVariableRuntimeHobCacheBufferSize));
     }
 
-    mVariableRuntimeHobCacheBuffer = NULL;
+    mVariableRuntimeHobCacheBuffer    = NULL;
+    mVariableRuntimeCacheLastVariable = NULL;
   }
 }
 
+/**
+  Check whether the variable found by the last runtime cache lookup is the given variable.
+
+  The runtime cache generation is advanced by SMM every time it updates the runtime cache,
+  so while it is unchanged the last lookup result is still valid and the cache does not
+  have to be searched again.
+
+  @param[in] VariableName       Name of Variable to be found.
+  @param[in] VendorGuid         Variable vendor GUID.
+
+  @retval TRUE                  The last lookup found this variable and the runtime cache did not change since.
+  @retval FALSE                 The runtime cache must be searched.
+
+**/
+STATIC
+BOOLEAN
+IsLastRuntimeCacheVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  )
+{
+  VARIABLE_HEADER  *Variable;
+
+  Variable = mVariableRuntimeCacheLastVariable;
+  if ((Variable == NULL) ||
+      (mVariableRuntimeCacheLastGeneration != mVariableRuntimeCacheGeneration) ||
+      (mVariableRuntimeCacheLastAtRuntime != EfiAtRuntime ()))
+  {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, mVariableAuthFormat)) &&
+                   (NameSizeOfVariable (Variable, mVariableAuthFormat) == StrSize (VariableName)) &&
+                   (CompareMem (VariableName, GetVariableNamePtr (Variable, mVariableAuthFormat), StrSize (VariableName)) == 0));
+}
+
 /**
   Finds the given variable in a runtime cache variable store.
 
@@ -641,27 +685,37 @@ FindVariableInRuntimeCache (
   CheckForRuntimeCacheSync ();
 
   if (!mVariableRuntimeCachePendingUpdate) {
-    //
-    // 0: Volatile, 1: HOB, 2: Non-Volatile.
-    // The index and attributes mapping must be kept in this order as FindVariable
-    // makes use of this mapping to implement search algorithm.
-    //
-    VariableStoreList[VariableStoreTypeVolatile] = mVariableRuntimeVolatileCacheBuffer;
-    VariableStoreList[VariableStoreTypeHob]      = mVariableRuntimeHobCacheBuffer;
-    VariableStoreList[VariableStoreTypeNv]       = mVariableRuntimeNvCacheBuffer;
+    if (IsLastRuntimeCacheVariable (VariableName, VendorGuid)) {
+      RtPtrTrack.CurrPtr  = mVariableRuntimeCacheLastVariable;
+      RtPtrTrack.Volatile = mVariableRuntimeCacheLastVolatile;
+      Status              = EFI_SUCCESS;
+    } else {
+      //
+      // 0: Volatile, 1: HOB, 2: Non-Volatile.
+      // The index and attributes mapping must be kept in this order as FindVariable
+      // makes use of this mapping to implement search algorithm.
+      //
+      VariableStoreList[VariableStoreTypeVolatile] = mVariableRuntimeVolatileCacheBuffer;
+      VariableStoreList[VariableStoreTypeHob]      = mVariableRuntimeHobCacheBuffer;
+      VariableStoreList[VariableStoreTypeNv]       = mVariableRuntimeNvCacheBuffer;
 
-    for (StoreType = (VARIABLE_STORE_TYPE)0; StoreType < VariableStoreTypeMax; StoreType++) {
-      if (VariableStoreList[StoreType] == NULL) {
-        continue;
-      }
+      for (StoreType = (VARIABLE_STORE_TYPE)0; StoreType < VariableStoreTypeMax; StoreType++) {
+        if (VariableStoreList[StoreType] == NULL) {
+          continue;
+        }
 
-      RtPtrTrack.StartPtr = GetStartPointer (VariableStoreList[StoreType]);
-      RtPtrTrack.EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
-      RtPtrTrack.Volatile = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
+        RtPtrTrack.StartPtr = GetStartPointer (VariableStoreList[StoreType]);
+        RtPtrTrack.EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
+        RtPtrTrack.Volatile = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
 
-      Status = FindVariableEx (VariableName, VendorGuid, FALSE, &RtPtrTrack, mVariableAuthFormat);
-      if (!EFI_ERROR (Status)) {
-        break;
+        Status = FindVariableEx (VariableName, VendorGuid, FALSE, &RtPtrTrack, mVariableAuthFormat);
+        if (!EFI_ERROR (Status)) {
+          mVariableRuntimeCacheLastVariable   = RtPtrTrack.CurrPtr;
+          mVariableRuntimeCacheLastVolatile   = RtPtrTrack.Volatile;
+          mVariableRuntimeCacheLastGeneration = mVariableRuntimeCacheGeneration;
+          mVariableRuntimeCacheLastAtRuntime  = EfiAtRuntime ();
+          break;
+        }
       }
     }
 
@@ -1198,6 +1252,148 @@ Done:
   return Status;
 }
 
+/**
+  Set a batch of variables.
+
+  Every entry is checked first; if any of them is not a valid SetVariable()
+  request, nothing is set. As many entries as fit in the communicate buffer are
+  sent to SMM together, so that a batch costs one SMI per buffer instead of one
+  SMI per variable. The status of each variable is returned in its entry.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The variables to set.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER This or Entries is NULL, an entry is not a valid SetVariable()
+                                request, or an entry does not fit in the communicate buffer.
+                                No variable was set.
+  @return Others                The status of the first entry that failed.
+**/
+EFI_STATUS
+EFIAPI
+SmmVariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          EntryCount,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_STATUS                                   Status;
+  EFI_STATUS                                   SendStatus;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *SmmBatchHeader;
+  SMM_VARIABLE_COMMUNICATE_BATCH_RECORD        *Record;
+  UINTN                                        PayloadSize;
+  UINTN                                        RecordSize;
+  UINTN                                        VariableNameSize;
+  UINTN                                        First;
+  UINTN                                        Last;
+  UINTN                                        Index;
+
+  if ((This == NULL) || ((EntryCount != 0) && (Entries == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((Entries[Index].VariableName == NULL) || (Entries[Index].VariableName[0] == 0) ||
+        (Entries[Index].VendorGuid == NULL) || ((Entries[Index].DataSize != 0) && (Entries[Index].Data == NULL)))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    //
+    // Every entry must fit in a batch of its own.
+    //
+    VariableNameSize = StrSize (Entries[Index].VariableName);
+    if ((VariableNameSize > mVariableBufferPayloadSize) ||
+        (Entries[Index].DataSize > mVariableBufferPayloadSize) ||
+        (SMM_VARIABLE_BATCH_RECORD_SIZE (VariableNameSize, Entries[Index].DataSize) >
+         mVariableBufferPayloadSize - sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Entries[Index].Status = EFI_NOT_STARTED;
+  }
+
+  AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+
+  Status = EFI_SUCCESS;
+  for (First = 0; First < EntryCount; First = Last) {
+    //
+    // Pick the entries that fit in the communicate buffer.
+    //
+    PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+    for (Last = First; Last < EntryCount; Last++) {
+      RecordSize = SMM_VARIABLE_BATCH_RECORD_SIZE (StrSize (Entries[Last].VariableName), Entries[Last].DataSize);
+      if (RecordSize > mVariableBufferPayloadSize - PayloadSize) {
+        break;
+      }
+
+      PayloadSize += RecordSize;
+    }
+
+    ASSERT (Last > First);
+
+    SmmBatchHeader = NULL;
+    SendStatus     = InitCommunicateBuffer ((VOID **)&SmmBatchHeader, PayloadSize, SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH);
+    if (EFI_ERROR (SendStatus)) {
+      Status = SendStatus;
+      break;
+    }
+
+    ASSERT (SmmBatchHeader != NULL);
+
+    SmmBatchHeader->VariableCount = Last - First;
+    Record                        = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)(SmmBatchHeader + 1);
+    for (Index = First; Index < Last; Index++) {
+      Record->Status = EFI_NOT_STARTED;
+      CopyGuid (&Record->Variable.Guid, Entries[Index].VendorGuid);
+      Record->Variable.DataSize   = Entries[Index].DataSize;
+      Record->Variable.NameSize   = StrSize (Entries[Index].VariableName);
+      Record->Variable.Attributes = Entries[Index].Attributes;
+      CopyMem (Record->Variable.Name, Entries[Index].VariableName, Record->Variable.NameSize);
+      CopyMem ((UINT8 *)Record->Variable.Name + Record->Variable.NameSize, Entries[Index].Data, Entries[Index].DataSize);
+      Record = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)((UINT8 *)Record +
+                                                         SMM_VARIABLE_BATCH_RECORD_SIZE (Record->Variable.NameSize, Record->Variable.DataSize));
+    }
+
+    //
+    // Send data to SMM.
+    //
+    SendStatus = SendCommunicateBuffer (PayloadSize);
+
+    //
+    // Collect the status of every variable. A record that SMM did not get to
+    // takes the status of the whole request.
+    //
+    Record = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)(SmmBatchHeader + 1);
+    for (Index = First; Index < Last; Index++) {
+      Entries[Index].Status = (Record->Status == EFI_NOT_STARTED) ? SendStatus : Record->Status;
+      if (EFI_ERROR (Entries[Index].Status) && !EFI_ERROR (Status)) {
+        Status = Entries[Index].Status;
+      }
+
+      Record = (SMM_VARIABLE_COMMUNICATE_BATCH_RECORD *)((UINT8 *)Record +
+                                                         SMM_VARIABLE_BATCH_RECORD_SIZE (Record->Variable.NameSize, Record->Variable.DataSize));
+    }
+  }
+
+  ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+  if (!EfiAtRuntime ()) {
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (!EFI_ERROR (Entries[Index].Status)) {
+        SecureBootHook (
+          Entries[Index].VariableName,
+          Entries[Index].VendorGuid
+          );
+      }
+    }
+  }
+
+  return Status;
+}
+
 /**
   This code returns information about the EFI variables.
 
@@ -1361,6 +1557,11 @@ VariableAddressChangeEvent (
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeVolatileCacheBuffer);
+
+  //
+  // The last runtime cache lookup result is a physical address, look the variable up again.
+  //
+  mVariableRuntimeCacheLastVariable = NULL;
 }
 
 /**
@@ -1570,6 +1771,7 @@ SendRuntimeVariableCacheContextToSmm (
   SmmRuntimeVarCacheContext->PendingUpdate        = &mVariableRuntimeCachePendingUpdate;
   SmmRuntimeVarCacheContext->ReadLock             = &mVariableRuntimeCacheReadLock;
   SmmRuntimeVarCacheContext->HobFlushComplete     = &mHobFlushComplete;
+  SmmRuntimeVarCacheContext->Generation           = &mVariableRuntimeCacheGeneration;
 
   //
   // Request to unblock this region to be accessible from inside MM environment
@@ -1599,6 +1801,14 @@ SendRuntimeVariableCacheContextToSmm (
     goto Done;
   }
 
+  Status = MmUnblockMemoryRequest (
+             (EFI_PHYSICAL_ADDRESS)ALIGN_VALUE ((UINTN)SmmRuntimeVarCacheContext->Generation - EFI_PAGE_SIZE + 1, EFI_PAGE_SIZE),
+             EFI_SIZE_TO_PAGES (sizeof (mVariableRuntimeCacheGeneration))
+             );
+  if ((Status != EFI_UNSUPPORTED) && EFI_ERROR (Status)) {
+    goto Done;
+  }
+
   //
   // Send data to SMM.
   //
@@ -1765,12 +1975,15 @@ SmmVariableWriteReady (
   //
   RecordSecureBootPolicyVarData ();
 
-  Status = gBS->InstallProtocolInterface (
-                  &mHandle,
-                  &gEfiVariableWriteArchProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  NULL
-                  );
+  mVariableBatch.SetVariables = SmmVariableBatchSetVariables;
+  Status                      = gBS->InstallMultipleProtocolInterfaces (
+                                       &mHandle,
+                                       &gEfiVariableWriteArchProtocolGuid,
+                                       NULL,
+                                       &gEdkiiVariableBatchProtocolGuid,
+                                       &mVariableBatch,
+                                       NULL
+                                       );
   ASSERT_EFI_ERROR (Status);
 
   gBS->CloseEvent (Event);
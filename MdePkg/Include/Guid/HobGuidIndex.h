@@ -0,0 +1,59 @@
+/** @file
+  GUID and layout of the HOB GUID index configuration table.
+
+  The DXE Core installs this table after it has published the HOB list. It
+  lists every GUID extension HOB in the HOB list, sorted by GUID and then by
+  address, so that HobLib can find GUID HOBs with a binary search instead of
+  walking the whole HOB list.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HOB_GUID_INDEX_H__
+#define __HOB_GUID_INDEX_H__
+
+#define EDKII_HOB_GUID_INDEX_TABLE_GUID \
+  { \
+    0xe5ee7ca3, 0x2165, 0x4ebd, { 0xa4, 0x97, 0xf7, 0xee, 0x85, 0xc2, 0x1e, 0x17 } \
+  }
+
+#define EDKII_HOB_GUID_INDEX_VERSION  1
+
+typedef struct {
+  ///
+  /// The Name of the GUID extension HOB.
+  ///
+  EFI_GUID                Name;
+  ///
+  /// The address of the EFI_HOB_GUID_TYPE header.
+  ///
+  EFI_PHYSICAL_ADDRESS    Hob;
+} EDKII_HOB_GUID_INDEX_ENTRY;
+
+typedef struct {
+  ///
+  /// EDKII_HOB_GUID_INDEX_VERSION.
+  ///
+  UINT32                  Version;
+  ///
+  /// The number of EDKII_HOB_GUID_INDEX_ENTRY structures following this header.
+  ///
+  UINT32                  Count;
+  ///
+  /// The address of the first HOB in the indexed HOB list.
+  ///
+  EFI_PHYSICAL_ADDRESS    HobListStart;
+  ///
+  /// The address of the EFI_HOB_TYPE_END_OF_HOB_LIST HOB of the indexed HOB list.
+  ///
+  EFI_PHYSICAL_ADDRESS    HobListEnd;
+  //
+  // EDKII_HOB_GUID_INDEX_ENTRY  Entry[Count];
+  //
+} EDKII_HOB_GUID_INDEX;
+
+extern EFI_GUID  gEdkiiHobGuidIndexTableGuid;
+
+#endif
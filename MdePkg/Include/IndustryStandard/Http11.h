@@ -74,6 +74,22 @@
 /// indicate its acceptance of range requests for a resource:
 ///
 #define HTTP_HEADER_ACCEPT_RANGES  "Accept-Ranges"
+#define HTTP_ACCEPT_RANGES_BYTES   "bytes"
+
+///
+/// Range Request Header
+/// The Range request-header field requests only part of the entity, as
+/// one or more byte ranges, e.g. "bytes=0-499".
+///
+#define HTTP_HEADER_RANGE  "Range"
+
+///
+/// Content-Range Header
+/// The Content-Range entity-header field is sent with a partial entity-body
+/// to specify where in the full entity-body it belongs, e.g.
+/// "bytes 0-499/1234".
+///
+#define HTTP_HEADER_CONTENT_RANGE  "Content-Range"
 
 ///
 /// Accept-Encoding Request Header
@@ -170,6 +186,16 @@
 ///
 #define HTTP_HEADER_HOST  "Host"
 
+///
+/// Connection General Header
+///
+/// The Connection general-header field allows the sender to specify options that are
+/// desired for that particular connection. The "close" option signals that the connection
+/// will be closed after the completion of the response.
+///
+#define HTTP_HEADER_CONNECTION  "Connection"
+#define HTTP_CONNECTION_CLOSE   "close"
+
 ///
 /// Location Response Header
 ///
@@ -219,6 +245,14 @@
 ///
 #define HTTP_HEADER_ETAG  "ETag"
 
+///
+/// Digest Response Headers
+/// The Repr-Digest (RFC 9530) and Digest (RFC 3230) response-header fields carry
+/// digests of the whole selected representation, as a list of algorithm=value pairs.
+///
+#define HTTP_HEADER_REPR_DIGEST  "Repr-Digest"
+#define HTTP_HEADER_DIGEST       "Digest"
+
 ///
 /// Custom header field checked by the iLO web server to
 /// specify a client session key.
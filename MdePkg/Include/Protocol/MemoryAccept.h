@@ -0,0 +1,46 @@
+/** @file
+  The file provides the protocol to accept memory which is not accepted yet
+  by the underlying isolation architecture, e.g. the private memory of an
+  Intel TDX guest.
+
+  The DXE Core reports such memory as EfiGcdMemoryTypeUnaccepted and uses the
+  protocol to turn it into system memory when the accepted memory runs out.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MEMORY_ACCEPT_H_
+#define MEMORY_ACCEPT_H_
+
+#define EDKII_MEMORY_ACCEPT_PROTOCOL_GUID \
+  { 0x38c74800, 0x5590, 0x4db4, { 0xa0, 0xf3, 0x67, 0x5d, 0x9b, 0x8e, 0x80, 0x26 } }
+
+typedef struct _EDKII_MEMORY_ACCEPT_PROTOCOL EDKII_MEMORY_ACCEPT_PROTOCOL;
+
+/**
+  Accept a range of memory so that it can be used as system memory.
+
+  @param[in]  This              A pointer to the EDKII_MEMORY_ACCEPT_PROTOCOL instance.
+  @param[in]  StartAddress      The start address of the memory range, page aligned.
+  @param[in]  Size              The size in bytes of the memory range, page aligned.
+
+  @retval EFI_SUCCESS           The memory range has been accepted.
+  @retval EFI_INVALID_PARAMETER StartAddress or Size is not page aligned.
+  @retval Others                The memory range could not be accepted.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_ACCEPT_MEMORY)(
+  IN EDKII_MEMORY_ACCEPT_PROTOCOL  *This,
+  IN EFI_PHYSICAL_ADDRESS          StartAddress,
+  IN UINTN                         Size
+  );
+
+struct _EDKII_MEMORY_ACCEPT_PROTOCOL {
+  EDKII_ACCEPT_MEMORY    AcceptMemory;
+};
+
+extern EFI_GUID  gEdkiiMemoryAcceptProtocolGuid;
+
+#endif
@@ -1545,9 +1545,13 @@ typedef union {
     ///
     UINT32    AVX512_4FMAPS                           : 1;
     ///
-    /// [Bit 14:4] Reserved.
+    /// [Bit 4] Fast Short REP MOVSB. REP MOVSB is fast for short lengths.
     ///
-    UINT32    Reserved4                               : 11;
+    UINT32    FastShortRepMovsb                       : 1;
+    ///
+    /// [Bit 14:5] Reserved.
+    ///
+    UINT32    Reserved4                               : 10;
     ///
     /// [Bit 15] Hybrid. If 1, the processor is identified as a hybrid part.
     ///
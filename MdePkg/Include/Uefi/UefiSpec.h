@@ -177,7 +177,7 @@ typedef struct {
                                 2) MemoryType is in the range
                                 EfiMaxMemoryType..0x6FFFFFFF.
                                 3) Memory is NULL.
-                                4) MemoryType is EfiPersistentMemory.
+                                4) MemoryType is EfiPersistentMemory or EfiUnacceptedMemoryType.
   @retval EFI_OUT_OF_RESOURCES  The pages could not be allocated.
   @retval EFI_NOT_FOUND         The requested pages could not be found.
 
@@ -261,7 +261,7 @@ EFI_STATUS
   @retval EFI_OUT_OF_RESOURCES  The pool requested could not be allocated.
   @retval EFI_INVALID_PARAMETER Buffer is NULL.
                                 PoolType is in the range EfiMaxMemoryType..0x6FFFFFFF.
-                                PoolType is EfiPersistentMemory.
+                                PoolType is EfiPersistentMemory or EfiUnacceptedMemoryType.
 
 **/
 typedef
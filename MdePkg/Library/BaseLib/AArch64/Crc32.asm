@@ -0,0 +1,83 @@
+;------------------------------------------------------------------------------
+;
+; CRC32 instruction helpers for CalculateCrc32() on AArch64
+;
+; SPDX-License-Identifier: BSD-2-Clause-Patent
+;
+;------------------------------------------------------------------------------
+
+  EXPORT InternalCrc32InstructionsSupported
+  EXPORT InternalCrc32Arm
+  AREA BaseLib_LowLevel, CODE, READONLY
+
+;/**
+;  Checks whether the processor implements the CRC32 instructions, as reported
+;  by the CRC32 field of ID_AA64ISAR0_EL1.
+;
+;  @retval TRUE   The CRC32 instructions are implemented.
+;  @retval FALSE  The CRC32 instructions are not implemented.
+;
+;**/
+;BOOLEAN
+;EFIAPI
+;InternalCrc32InstructionsSupported (
+;  VOID
+;  );
+;
+InternalCrc32InstructionsSupported
+    mrs   x0, ID_AA64ISAR0_EL1
+    ubfx  x0, x0, #16, #4
+    cmp   x0, #0
+    cset  x0, ne
+    ret
+
+;/**
+;  Folds a data buffer into a 32-bit CRC using the CRC32B and CRC32X instructions.
+;
+;  @param  Crc     The CRC of the data before Buffer, not inverted.
+;  @param  Buffer  A pointer to the buffer on which the 32-bit CRC is to be computed.
+;  @param  Length  The number of bytes in the buffer Data.
+;
+;  @return The CRC of the data followed by Buffer, not inverted.
+;
+;**/
+;UINT32
+;EFIAPI
+;InternalCrc32Arm (
+;  IN      UINT32      Crc,
+;  IN      CONST VOID  *Buffer,
+;  IN      UINTN       Length
+;  );
+;
+InternalCrc32Arm
+    ; Fold the leading bytes until Buffer is 8-byte aligned
+Crc32Head
+    cbz   x2, Crc32Done
+    tst   x1, #7
+    b.eq  Crc32Body
+    ldrb  w3, [x1], #1
+    crc32b w0, w0, w3
+    sub   x2, x2, #1
+    b     Crc32Head
+
+    ; Fold eight bytes at a time
+Crc32Body
+    cmp   x2, #8
+    b.lo  Crc32Tail
+    ldr   x3, [x1], #8
+    crc32x w0, w0, x3
+    sub   x2, x2, #8
+    b     Crc32Body
+
+    ; Fold the trailing bytes
+Crc32Tail
+    cbz   x2, Crc32Done
+    ldrb  w3, [x1], #1
+    crc32b w0, w0, w3
+    sub   x2, x2, #1
+    b     Crc32Tail
+
+Crc32Done
+    ret
+
+  END
@@ -850,6 +850,40 @@ InternalX86RdRand64  (
   OUT     UINT64  *Rand
   );
 
+#elif defined (MDE_CPU_AARCH64)
+
+/**
+  Checks whether the processor implements the CRC32 instructions, as reported
+  by the CRC32 field of ID_AA64ISAR0_EL1.
+
+  @retval TRUE   The CRC32 instructions are implemented.
+  @retval FALSE  The CRC32 instructions are not implemented.
+
+**/
+BOOLEAN
+EFIAPI
+InternalCrc32InstructionsSupported (
+  VOID
+  );
+
+/**
+  Folds a data buffer into a 32-bit CRC using the CRC32B and CRC32X instructions.
+
+  @param  Crc     The CRC of the data before Buffer, not inverted.
+  @param  Buffer  A pointer to the buffer on which the 32-bit CRC is to be computed.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC of the data followed by Buffer, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Arm (
+  IN      UINT32      Crc,
+  IN      CONST VOID  *Buffer,
+  IN      UINTN       Length
+  );
+
 #else
 
 #endif
@@ -8,6 +8,270 @@
 
 #include "BaseLibInternals.h"
 
+///
+/// Partitions smaller than this are sorted by insertion sort.
+///
+#define QUICK_SORT_INSERTION_THRESHOLD  16
+
+/**
+  Copy one element, without calling CopyMem () for aligned 32-bit and 64-bit
+  elements.
+
+  @param[out] Destination   The element to copy to.
+  @param[in]  Source        The element to copy from.
+  @param[in]  ElementSize   Size of an element in bytes.
+**/
+STATIC
+VOID
+QuickSortCopyElement (
+  OUT VOID        *Destination,
+  IN  CONST VOID  *Source,
+  IN  UINTN       ElementSize
+  )
+{
+  if ((ElementSize == sizeof (UINT64)) && ((((UINTN)Destination | (UINTN)Source) & (sizeof (UINT64) - 1)) == 0)) {
+    *(UINT64 *)Destination = *(CONST UINT64 *)Source;
+  } else if ((ElementSize == sizeof (UINT32)) && ((((UINTN)Destination | (UINTN)Source) & (sizeof (UINT32) - 1)) == 0)) {
+    *(UINT32 *)Destination = *(CONST UINT32 *)Source;
+  } else {
+    CopyMem (Destination, Source, ElementSize);
+  }
+}
+
+/**
+  Swap two elements.
+
+  @param[in, out] Element1          The first element.
+  @param[in, out] Element2          The second element.
+  @param[in]      ElementSize       Size of an element in bytes.
+  @param[out]     BufferOneElement  Buffer of ElementSize bytes used for the swap.
+**/
+STATIC
+VOID
+QuickSortSwapElements (
+  IN OUT VOID   *Element1,
+  IN OUT VOID   *Element2,
+  IN     UINTN  ElementSize,
+  OUT    VOID   *BufferOneElement
+  )
+{
+  if (Element1 == Element2) {
+    return;
+  }
+
+  QuickSortCopyElement (BufferOneElement, Element1, ElementSize);
+  QuickSortCopyElement (Element1, Element2, ElementSize);
+  QuickSortCopyElement (Element2, BufferOneElement, ElementSize);
+}
+
+/**
+  Sort a small buffer by insertion sort.
+
+  @param[in, out] BufferToSort      Buffer of elements to sort.
+  @param[in]      Count             The number of elements in the buffer.
+  @param[in]      ElementSize       Size of an element in bytes.
+  @param[in]      CompareFunction   The function to compare two elements.
+  @param[out]     BufferOneElement  Buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+QuickSortInsertion (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  OUT    VOID               *BufferOneElement
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Index;
+  UINTN  Position;
+
+  Buffer = (UINT8 *)BufferToSort;
+  for (Index = 1; Index < Count; Index++) {
+    if (CompareFunction (Buffer + (Index - 1) * ElementSize, Buffer + Index * ElementSize) <= 0) {
+      continue;
+    }
+
+    QuickSortCopyElement (BufferOneElement, Buffer + Index * ElementSize, ElementSize);
+    Position = Index;
+    do {
+      QuickSortCopyElement (Buffer + Position * ElementSize, Buffer + (Position - 1) * ElementSize, ElementSize);
+      Position--;
+    } while ((Position > 0) && (CompareFunction (Buffer + (Position - 1) * ElementSize, BufferOneElement) > 0));
+
+    QuickSortCopyElement (Buffer + Position * ElementSize, BufferOneElement, ElementSize);
+  }
+}
+
+/**
+  Sort a buffer by heap sort. This bounds the time when quick sort picks bad
+  pivots.
+
+  @param[in, out] BufferToSort      Buffer of elements to sort.
+  @param[in]      Count             The number of elements in the buffer.
+  @param[in]      ElementSize       Size of an element in bytes.
+  @param[in]      CompareFunction   The function to compare two elements.
+  @param[out]     BufferOneElement  Buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+QuickSortHeap (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  OUT    VOID               *BufferOneElement
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Start;
+  UINTN  End;
+  UINTN  Root;
+  UINTN  Child;
+
+  Buffer = (UINT8 *)BufferToSort;
+  Start  = Count / 2;
+  End    = Count;
+  while (End > 1) {
+    if (Start > 0) {
+      //
+      // Build the heap.
+      //
+      Start--;
+    } else {
+      //
+      // Move the largest element behind the heap.
+      //
+      End--;
+      QuickSortSwapElements (Buffer, Buffer + End * ElementSize, ElementSize, BufferOneElement);
+    }
+
+    //
+    // Sift the root down.
+    //
+    Root = Start;
+    for (Child = 2 * Root + 1; Child < End; Child = 2 * Root + 1) {
+      if ((Child + 1 < End) &&
+          (CompareFunction (Buffer + Child * ElementSize, Buffer + (Child + 1) * ElementSize) < 0))
+      {
+        Child++;
+      }
+
+      if (CompareFunction (Buffer + Root * ElementSize, Buffer + Child * ElementSize) >= 0) {
+        break;
+      }
+
+      QuickSortSwapElements (Buffer + Root * ElementSize, Buffer + Child * ElementSize, ElementSize, BufferOneElement);
+      Root = Child;
+    }
+  }
+}
+
+/**
+  Sort a buffer by quick sort, falling back to heap sort once DepthLimit
+  partitions did not split the buffer well, and to insertion sort for
+  small partitions.
+
+  @param[in, out] BufferToSort      Buffer of elements to sort.
+  @param[in]      Count             The number of elements in the buffer.
+  @param[in]      ElementSize       Size of an element in bytes.
+  @param[in]      CompareFunction   The function to compare two elements.
+  @param[out]     BufferOneElement  Buffer of ElementSize bytes.
+  @param[in]      DepthLimit        The number of partitions left before heap sort.
+**/
+STATIC
+VOID
+QuickSortWorker (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  OUT    VOID               *BufferOneElement,
+  IN     UINTN              DepthLimit
+  )
+{
+  UINT8  *Buffer;
+  UINT8  *First;
+  UINT8  *Middle;
+  UINT8  *Pivot;
+  UINTN  LoopCount;
+  UINTN  NextSwapLocation;
+
+  Buffer = (UINT8 *)BufferToSort;
+  while (Count > QUICK_SORT_INSERTION_THRESHOLD) {
+    if (DepthLimit == 0) {
+      QuickSortHeap (Buffer, Count, ElementSize, CompareFunction, BufferOneElement);
+      return;
+    }
+
+    DepthLimit--;
+
+    //
+    // Pick the median of the first, middle and last elements as the pivot,
+    // and move it to the last position. Sorted input then splits evenly.
+    //
+    First  = Buffer;
+    Middle = Buffer + (Count / 2) * ElementSize;
+    Pivot  = Buffer + (Count - 1) * ElementSize;
+    if (CompareFunction (Middle, First) < 0) {
+      QuickSortSwapElements (Middle, First, ElementSize, BufferOneElement);
+    }
+
+    if (CompareFunction (Pivot, First) < 0) {
+      QuickSortSwapElements (Pivot, First, ElementSize, BufferOneElement);
+    }
+
+    if (CompareFunction (Middle, Pivot) < 0) {
+      QuickSortSwapElements (Middle, Pivot, ElementSize, BufferOneElement);
+    }
+
+    //
+    // Now get the pivot such that all on "left" are below it
+    // and everything "right" are above it
+    //
+    NextSwapLocation = 0;
+    for (LoopCount = 0; LoopCount < Count - 1; LoopCount++) {
+      if (CompareFunction (Buffer + LoopCount * ElementSize, Pivot) <= 0) {
+        QuickSortSwapElements (
+          Buffer + NextSwapLocation * ElementSize,
+          Buffer + LoopCount * ElementSize,
+          ElementSize,
+          BufferOneElement
+          );
+        NextSwapLocation++;
+      }
+    }
+
+    //
+    // swap pivot to it's final position (NextSwapLocation)
+    //
+    QuickSortSwapElements (Pivot, Buffer + NextSwapLocation * ElementSize, ElementSize, BufferOneElement);
+
+    //
+    // Recurse on the smaller partial list and loop on the larger one, so that
+    // the stack depth stays logarithmic. Neither has the 'pivot' element.
+    //
+    if (NextSwapLocation < Count - NextSwapLocation - 1) {
+      QuickSortWorker (Buffer, NextSwapLocation, ElementSize, CompareFunction, BufferOneElement, DepthLimit);
+      Buffer += (NextSwapLocation + 1) * ElementSize;
+      Count  -= NextSwapLocation + 1;
+    } else {
+      QuickSortWorker (
+        Buffer + (NextSwapLocation + 1) * ElementSize,
+        Count - NextSwapLocation - 1,
+        ElementSize,
+        CompareFunction,
+        BufferOneElement,
+        DepthLimit
+        );
+      Count = NextSwapLocation;
+    }
+  }
+
+  QuickSortInsertion (Buffer, Count, ElementSize, CompareFunction, BufferOneElement);
+}
+
 /**
   This function is identical to perform QuickSort,
   except that is uses the pre-allocated buffer so the in place sorting does not need to
@@ -15,6 +279,10 @@
 
   Each element must be equal sized.
 
+  The sort is an introsort: quick sort with a median of three pivot, heap
+  sort when the partitions degrade, and insertion sort for small partitions.
+  It takes O(n log n) time in the worst case.
+
   if BufferToSort is NULL, then ASSERT.
   if CompareFunction is NULL, then ASSERT.
   if BufferOneElement is NULL, then ASSERT.
@@ -41,10 +309,6 @@ QuickSort (
   OUT VOID                    *BufferOneElement
   )
 {
-  VOID   *Pivot;
-  UINTN  LoopCount;
-  UINTN  NextSwapLocation;
-
   ASSERT (BufferToSort     != NULL);
   ASSERT (CompareFunction  != NULL);
   ASSERT (BufferOneElement != NULL);
@@ -54,64 +318,12 @@ QuickSort (
     return;
   }
 
-  NextSwapLocation = 0;
-
-  //
-  // pick a pivot (we choose last element)
-  //
-  Pivot = ((UINT8 *)BufferToSort + ((Count - 1) * ElementSize));
-
-  //
-  // Now get the pivot such that all on "left" are below it
-  // and everything "right" are above it
-  //
-  for (LoopCount = 0; LoopCount < Count -1; LoopCount++) {
-    //
-    // if the element is less than or equal to the pivot
-    //
-    if (CompareFunction ((VOID *)((UINT8 *)BufferToSort + ((LoopCount) * ElementSize)), Pivot) <= 0) {
-      //
-      // swap
-      //
-      CopyMem (BufferOneElement, (UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), ElementSize);
-      CopyMem ((UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), (UINT8 *)BufferToSort + ((LoopCount) * ElementSize), ElementSize);
-      CopyMem ((UINT8 *)BufferToSort + ((LoopCount)*ElementSize), BufferOneElement, ElementSize);
-
-      //
-      // increment NextSwapLocation
-      //
-      NextSwapLocation++;
-    }
-  }
-
-  //
-  // swap pivot to it's final position (NextSwapLocation)
-  //
-  CopyMem (BufferOneElement, Pivot, ElementSize);
-  CopyMem (Pivot, (UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), ElementSize);
-  CopyMem ((UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), BufferOneElement, ElementSize);
-
-  //
-  // Now recurse on 2 partial lists.  neither of these will have the 'pivot' element
-  // IE list is sorted left half, pivot element, sorted right half...
-  //
-  if (NextSwapLocation >= 2) {
-    QuickSort (
-      BufferToSort,
-      NextSwapLocation,
-      ElementSize,
-      CompareFunction,
-      BufferOneElement
-      );
-  }
-
-  if ((Count - NextSwapLocation - 1) >= 2) {
-    QuickSort (
-      (UINT8 *)BufferToSort + (NextSwapLocation + 1) * ElementSize,
-      Count - NextSwapLocation - 1,
-      ElementSize,
-      CompareFunction,
-      BufferOneElement
-      );
-  }
+  QuickSortWorker (
+    BufferToSort,
+    Count,
+    ElementSize,
+    CompareFunction,
+    BufferOneElement,
+    2 * (UINTN)HighBitSet64 (Count)
+    );
 }
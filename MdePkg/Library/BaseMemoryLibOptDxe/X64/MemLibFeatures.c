@@ -0,0 +1,122 @@
+/** @file
+  Processor feature selection for the X64 CopyMem() and SetMem() routines.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Register/Intel/Cpuid.h>
+
+//
+// Non-temporal threshold used when the last level cache size is not reported.
+//
+#define DEFAULT_NON_TEMPORAL_THRESHOLD  SIZE_1MB
+
+//
+// TRUE if REP MOVSB/STOSB are fast (ERMS or FSRM). Copies and fills below
+// mMemLibNonTemporalThreshold then use a single REP MOVSB/STOSB.
+//
+BOOLEAN  mMemLibFastRepString = FALSE;
+
+//
+// Copies and fills of at least this many bytes bypass the caches with
+// non-temporal stores, so that they do not evict the whole working set.
+//
+UINTN  mMemLibNonTemporalThreshold = MAX_UINTN;
+
+/**
+  Return the size of the largest cache reported by CPUID leaf 4.
+
+  @return The size in bytes of the last level cache, or 0 if not reported.
+
+**/
+STATIC
+UINTN
+GetLastLevelCacheSize (
+  VOID
+  )
+{
+  UINT32                  Index;
+  CPUID_CACHE_PARAMS_EAX  Eax;
+  CPUID_CACHE_PARAMS_EBX  Ebx;
+  UINT32                  Sets;
+  UINTN                   CacheSize;
+  UINTN                   LastLevelCacheSize;
+  UINT32                  LastLevel;
+
+  LastLevel          = 0;
+  LastLevelCacheSize = 0;
+  for (Index = 0; ; Index++) {
+    AsmCpuidEx (CPUID_CACHE_PARAMS, Index, &Eax.Uint32, &Ebx.Uint32, &Sets, NULL);
+    if (Eax.Bits.CacheType == CPUID_CACHE_PARAMS_CACHE_TYPE_NULL) {
+      break;
+    }
+
+    if ((Eax.Bits.CacheType == CPUID_CACHE_PARAMS_CACHE_TYPE_INSTRUCTION) ||
+        (Eax.Bits.CacheLevel < LastLevel))
+    {
+      continue;
+    }
+
+    CacheSize = (UINTN)(Ebx.Bits.Ways + 1) * (Ebx.Bits.LinePartitions + 1) *
+                (Ebx.Bits.LineSize + 1) * ((UINTN)Sets + 1);
+    if ((Eax.Bits.CacheLevel > LastLevel) || (CacheSize > LastLevelCacheSize)) {
+      LastLevel          = Eax.Bits.CacheLevel;
+      LastLevelCacheSize = CacheSize;
+    }
+  }
+
+  return LastLevelCacheSize;
+}
+
+/**
+  Select the CopyMem() and SetMem() strategies for this processor.
+
+  Until this runs, and in modules that execute in place where the globals
+  cannot be written, the routines keep their original behavior.
+
+  @retval RETURN_SUCCESS  The constructor always returns RETURN_SUCCESS.
+
+**/
+RETURN_STATUS
+EFIAPI
+BaseMemoryLibOptDxeConstructor (
+  VOID
+  )
+{
+  UINT32                                       MaxLeaf;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  Ebx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EDX  Edx;
+  UINTN                                        CacheSize;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+
+  if (MaxLeaf >= CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    AsmCpuidEx (
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+      NULL,
+      &Ebx.Uint32,
+      NULL,
+      &Edx.Uint32
+      );
+    mMemLibFastRepString = (BOOLEAN)(Ebx.Bits.EnhancedRepMovsbStosb == 1 ||
+                                     Edx.Bits.FastShortRepMovsb == 1);
+  }
+
+  CacheSize = 0;
+  if (MaxLeaf >= CPUID_CACHE_PARAMS) {
+    CacheSize = GetLastLevelCacheSize ();
+  }
+
+  if (CacheSize == 0) {
+    mMemLibNonTemporalThreshold = DEFAULT_NON_TEMPORAL_THRESHOLD;
+  } else {
+    mMemLibNonTemporalThreshold = CacheSize / 4 * 3;
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -935,6 +935,7 @@ PeCoffLoaderRelocateImage (
   PHYSICAL_ADDRESS                     BaseAddress;
   UINT32                               NumberOfRvaAndSizes;
   UINT32                               TeStrippedOffset;
+  BOOLEAN                              BlockInImage;
 
   ASSERT (ImageContext != NULL);
 
@@ -1069,14 +1070,44 @@ PeCoffLoaderRelocateImage (
         return RETURN_LOAD_ERROR;
       }
 
+      //
+      // If the whole 4 KB page covered by the block lies within the image, no
+      // record of the block can point outside of the image.
+      //
+      BlockInImage = (BOOLEAN)((UINT64)RelocBase->VirtualAddress + 0xFFF < ImageContext->ImageSize + TeStrippedOffset);
+
       //
       // Run this relocation record
       //
       while ((UINTN)Reloc < (UINTN)RelocEnd) {
-        Fixup = PeCoffLoaderImageAddress (ImageContext, RelocBase->VirtualAddress + (*Reloc & 0xFFF), TeStrippedOffset);
-        if (Fixup == NULL) {
-          ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-          return RETURN_LOAD_ERROR;
+        if (BlockInImage) {
+          //
+          // Apply runs of DIR64 records, which make up almost all relocations
+          // of 64-bit images, without going through the generic path.
+          //
+          while (((UINTN)Reloc < (UINTN)RelocEnd) && (((*Reloc) >> 12) == EFI_IMAGE_REL_BASED_DIR64)) {
+            Fixup64  = (UINT64 *)(FixupBase + (*Reloc & 0xFFF));
+            *Fixup64 = *Fixup64 + (UINT64)Adjust;
+            if (FixupData != NULL) {
+              FixupData              = ALIGN_POINTER (FixupData, sizeof (UINT64));
+              *(UINT64 *)(FixupData) = *Fixup64;
+              FixupData              = FixupData + sizeof (UINT64);
+            }
+
+            Reloc += 1;
+          }
+
+          if ((UINTN)Reloc >= (UINTN)RelocEnd) {
+            break;
+          }
+
+          Fixup = FixupBase + (*Reloc & 0xFFF);
+        } else {
+          Fixup = PeCoffLoaderImageAddress (ImageContext, RelocBase->VirtualAddress + (*Reloc & 0xFFF), TeStrippedOffset);
+          if (Fixup == NULL) {
+            ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+            return RETURN_LOAD_ERROR;
+          }
         }
 
         switch ((*Reloc) >> 12) {
@@ -1727,6 +1758,7 @@ PeCoffLoaderRelocateImageForRuntime (
   UINTN                                Adjust;
   RETURN_STATUS                        Status;
   PE_COFF_LOADER_IMAGE_CONTEXT         ImageContext;
+  BOOLEAN                              BlockInImage;
 
   if ((RelocationData == NULL) || (ImageBase == 0x0) || (VirtImageBase == 0x0)) {
     return;
@@ -1847,13 +1879,23 @@ PeCoffLoaderRelocateImageForRuntime (
         return;
       }
 
+      //
+      // If the whole 4 KB page covered by the block lies within the image, no
+      // record of the block can point outside of the image.
+      //
+      BlockInImage = (BOOLEAN)((UINT64)RelocBase->VirtualAddress + 0xFFF < ImageSize);
+
       //
       // Run this relocation record
       //
       while ((UINTN)Reloc < (UINTN)RelocEnd) {
-        Fixup = PeCoffLoaderImageAddress (&ImageContext, RelocBase->VirtualAddress + (*Reloc & 0xFFF), 0);
-        if (Fixup == NULL) {
-          return;
+        if (BlockInImage) {
+          Fixup = FixupBase + (*Reloc & 0xFFF);
+        } else {
+          Fixup = PeCoffLoaderImageAddress (&ImageContext, RelocBase->VirtualAddress + (*Reloc & 0xFFF), 0);
+          if (Fixup == NULL) {
+            return;
+          }
         }
 
         switch ((*Reloc) >> 12) {
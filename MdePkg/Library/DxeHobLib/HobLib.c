@@ -9,13 +9,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiDxe.h>
 
 #include <Guid/HobList.h>
+#include <Guid/HobGuidIndex.h>
 
 #include <Library/HobLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 
-VOID  *mHobList = NULL;
+VOID                  *mHobList     = NULL;
+EDKII_HOB_GUID_INDEX  *mHobGuidIndex = NULL;
 
 /**
   Returns the pointer to the HOB list.
@@ -56,6 +58,9 @@ GetHobList (
   The constructor function caches the pointer to HOB list by calling GetHobList()
   and will always return EFI_SUCCESS.
 
+  It also caches the sorted GUID HOB index published by the DXE Core, if present,
+  so that GetNextGuidHob() can use a binary search instead of a linear walk.
+
   @param  ImageHandle   The firmware allocated handle for the EFI image.
   @param  SystemTable   A pointer to the EFI System Table.
 
@@ -69,11 +74,71 @@ HobLibConstructor (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
+  EFI_STATUS  Status;
+
   GetHobList ();
 
+  Status = EfiGetSystemConfigurationTable (&gEdkiiHobGuidIndexTableGuid, (VOID **)&mHobGuidIndex);
+  if (EFI_ERROR (Status) ||
+      (mHobGuidIndex->Version != EDKII_HOB_GUID_INDEX_VERSION) ||
+      (mHobGuidIndex->HobListStart != (EFI_PHYSICAL_ADDRESS)(UINTN)mHobList))
+  {
+    mHobGuidIndex = NULL;
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Look up the next GUID HOB in the sorted GUID HOB index.
+
+  The index entries are sorted by GUID and then by HOB address, and HOB addresses
+  increase along the HOB list, so the first entry not less than (Guid, HobStart)
+  is the next matching GUID HOB at or after HobStart.
+
+  @param  Index         The sorted GUID HOB index.
+  @param  Guid          The GUID to match with in the HOB list.
+  @param  HobStart      A pointer to a Guid offset HOB within the indexed HOB list.
+
+  @return The next instance of the matched GUID HOB from the starting HOB, or NULL.
+
+**/
+STATIC
+VOID *
+LookupHobGuidIndex (
+  IN CONST EDKII_HOB_GUID_INDEX  *Index,
+  IN CONST EFI_GUID              *Guid,
+  IN CONST VOID                  *HobStart
+  )
+{
+  CONST EDKII_HOB_GUID_INDEX_ENTRY  *Entry;
+  EFI_PHYSICAL_ADDRESS              Start;
+  UINTN                             Low;
+  UINTN                             High;
+  UINTN                             Middle;
+  INTN                              Result;
+
+  Entry = (CONST EDKII_HOB_GUID_INDEX_ENTRY *)(Index + 1);
+  Start = (EFI_PHYSICAL_ADDRESS)(UINTN)HobStart;
+  Low   = 0;
+  High  = Index->Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareMem (&Entry[Middle].Name, Guid, sizeof (EFI_GUID));
+    if ((Result < 0) || ((Result == 0) && (Entry[Middle].Hob < Start))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->Count) && CompareGuid (&Entry[Low].Name, Guid)) {
+    return (VOID *)(UINTN)Entry[Low].Hob;
+  }
+
+  return NULL;
+}
+
 /**
   Returns the next instance of a HOB type from the starting HOB.
 
@@ -173,6 +238,13 @@ GetNextGuidHob (
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
 
+  if ((mHobGuidIndex != NULL) &&
+      ((EFI_PHYSICAL_ADDRESS)(UINTN)HobStart >= mHobGuidIndex->HobListStart) &&
+      ((EFI_PHYSICAL_ADDRESS)(UINTN)HobStart <= mHobGuidIndex->HobListEnd))
+  {
+    return LookupHobGuidIndex (mHobGuidIndex, Guid, HobStart);
+  }
+
   GuidHob.Raw = (UINT8 *)HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
     if (CompareGuid (Guid, &GuidHob.Guid->Name)) {
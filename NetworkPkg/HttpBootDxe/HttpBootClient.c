@@ -597,21 +597,24 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback function invoked by the HttpIo, or NULL.
+  @param[out]   HttpIo         The HttpIo to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootInitHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
@@ -636,15 +639,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = HttpBootInitHttpIo (Private, HttpBootHttpIoCallback, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -816,6 +838,176 @@ HttpBootGetFileFromCache (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Start the digest of a boot file, if the server sends the SHA-256 digest of
+  the file in the Repr-Digest or Digest header of the response.
+
+  @param[in]   HeaderCount     Number of HTTP header structures in Headers.
+  @param[in]   Headers         Array containing list of HTTP headers.
+  @param[out]  Digest          The digest to start. Its Sha256Context is NULL if
+                               the file isn't to be checked.
+
+  @retval EFI_SUCCESS          The digest is started, or not needed.
+  @retval EFI_OUT_OF_RESOURCES Could not allocate the hash context.
+  @retval EFI_DEVICE_ERROR     Failed to initialize the hash context.
+
+**/
+EFI_STATUS
+HttpBootInitDigest (
+  IN  UINTN             HeaderCount,
+  IN  EFI_HTTP_HEADER   *Headers,
+  OUT HTTP_BOOT_DIGEST  *Digest
+  )
+{
+  EFI_HTTP_HEADER  *Header;
+  CHAR8            *Value;
+  CHAR8            *End;
+  UINTN            Index;
+  UINTN            Size;
+  RETURN_STATUS    Status;
+
+  ZeroMem (Digest, sizeof (HTTP_BOOT_DIGEST));
+
+  if (!PcdGetBool (PcdHttpBootVerifyDigest)) {
+    return EFI_SUCCESS;
+  }
+
+  Header = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_REPR_DIGEST);
+  if (Header == NULL) {
+    Header = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_DIGEST);
+    if (Header == NULL) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  //
+  // The value is a list of "algorithm=digest", separated by commas. The
+  // digest is encoded in base64, and enclosed in colons in Repr-Digest.
+  //
+  Value = Header->FieldValue;
+  while (*Value != '\0') {
+    while ((*Value == ' ') || (*Value == ',')) {
+      Value++;
+    }
+
+    for (Index = 0; HTTP_BOOT_DIGEST_SHA256[Index] != '\0'; Index++) {
+      if (AsciiCharToUpper (Value[Index]) != HTTP_BOOT_DIGEST_SHA256[Index]) {
+        break;
+      }
+    }
+
+    if (HTTP_BOOT_DIGEST_SHA256[Index] == '\0') {
+      Value += Index;
+      if (*Value == ':') {
+        Value++;
+      }
+
+      End = Value;
+      while ((*End != '\0') && (*End != ',') && (*End != ':') && (*End != ' ')) {
+        End++;
+      }
+
+      Size   = sizeof (Digest->Expected);
+      Status = Base64Decode (Value, End - Value, Digest->Expected, &Size);
+      if (RETURN_ERROR (Status) || (Size != SHA256_DIGEST_SIZE)) {
+        DEBUG ((DEBUG_WARN, "HttpBootInitDigest: Ignore malformed digest \"%a\".\n", Header->FieldValue));
+        return EFI_SUCCESS;
+      }
+
+      Digest->Sha256Context = AllocatePool (Sha256GetContextSize ());
+      if (Digest->Sha256Context == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      if (!Sha256Init (Digest->Sha256Context)) {
+        FreePool (Digest->Sha256Context);
+        Digest->Sha256Context = NULL;
+        return EFI_DEVICE_ERROR;
+      }
+
+      return EFI_SUCCESS;
+    }
+
+    while ((*Value != '\0') && (*Value != ',')) {
+      Value++;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Add the next part of a boot file to its digest.
+
+  @param[in, out]  Digest      The digest of the boot file.
+  @param[in]       Data        The next part of the boot file.
+  @param[in]       Length      The length of Data in bytes.
+
+**/
+VOID
+HttpBootUpdateDigest (
+  IN OUT HTTP_BOOT_DIGEST  *Digest,
+  IN     CONST VOID        *Data,
+  IN     UINTN             Length
+  )
+{
+  if ((Digest->Sha256Context != NULL) && (Length != 0)) {
+    Sha256Update (Digest->Sha256Context, Data, Length);
+  }
+}
+
+/**
+  Check that a completely received boot file matches the digest sent by the
+  server, and release the digest.
+
+  @param[in, out]  Digest      The digest of the boot file.
+
+  @retval EFI_SUCCESS              The file matches the digest, or isn't checked.
+  @retval EFI_SECURITY_VIOLATION   The file doesn't match the digest.
+
+**/
+EFI_STATUS
+HttpBootCheckDigest (
+  IN OUT HTTP_BOOT_DIGEST  *Digest
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Actual[SHA256_DIGEST_SIZE];
+
+  if (Digest->Sha256Context == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Status = EFI_SUCCESS;
+  if (!Sha256Final (Digest->Sha256Context, Actual) ||
+      (CompareMem (Actual, Digest->Expected, SHA256_DIGEST_SIZE) != 0))
+  {
+    DEBUG ((DEBUG_ERROR, "HttpBootCheckDigest: The boot file doesn't match the digest sent by the server.\n"));
+    Status = EFI_SECURITY_VIOLATION;
+  }
+
+  FreePool (Digest->Sha256Context);
+  Digest->Sha256Context = NULL;
+  return Status;
+}
+
+/**
+  Release the digest of a boot file not completely received.
+
+  @param[in, out]  Digest      The digest of the boot file.
+
+**/
+VOID
+HttpBootFreeDigest (
+  IN OUT HTTP_BOOT_DIGEST  *Digest
+  )
+{
+  if (Digest->Sha256Context != NULL) {
+    FreePool (Digest->Sha256Context);
+    Digest->Sha256Context = NULL;
+  }
+}
+
 /**
   A callback function to intercept events during message parser.
 
@@ -854,6 +1046,8 @@ HttpBootGetBootFileCallback (
 
   CallbackData     = (HTTP_BOOT_CALLBACK_DATA *)Context;
   HttpBootCallback = CallbackData->Private->HttpBootCallback;
+
+  HttpBootUpdateDigest (&CallbackData->Digest, Data, Length);
   if (HttpBootCallback != NULL) {
     Status = HttpBootCallback->Callback (
                                  HttpBootCallback,
@@ -901,6 +1095,367 @@ HttpBootGetBootFileCallback (
   return EFI_SUCCESS;
 }
 
+/**
+  Release the resources of one connection of a parallel download.
+
+  @param[in]  Stream           The connection to release.
+
+**/
+VOID
+HttpBootFreeRangeStream (
+  IN HTTP_BOOT_RANGE_STREAM  *Stream
+  )
+{
+  UINTN  Index;
+
+  if (Stream->ResponseData.Headers != NULL) {
+    for (Index = 0; Index < Stream->ResponseData.HeaderCount; Index++) {
+      FreePool (Stream->ResponseData.Headers[Index].FieldName);
+      FreePool (Stream->ResponseData.Headers[Index].FieldValue);
+    }
+
+    FreePool (Stream->ResponseData.Headers);
+    Stream->ResponseData.Headers = NULL;
+  }
+
+  if (Stream->HttpIoHeader != NULL) {
+    HttpIoFreeHeader (Stream->HttpIoHeader);
+    Stream->HttpIoHeader = NULL;
+  }
+
+  if (Stream->HttpCreated) {
+    HttpIoDestroyIo (&Stream->HttpIo);
+    Stream->HttpCreated = FALSE;
+  }
+}
+
+/**
+  Open a new connection to the server and request a byte range of the boot file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in, out]  Stream          The connection, with Offset and End set to the
+                                   byte range to request.
+
+  @retval EFI_SUCCESS              The range was requested.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Failed to connect or send the request.
+
+**/
+EFI_STATUS
+HttpBootSendRangeRequest (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN OUT HTTP_BOOT_RANGE_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *HostName;
+  CHAR8       Range[sizeof ("bytes=18446744073709551615-18446744073709551615")];
+
+  Status = HttpBootInitHttpIo (Private, NULL, &Stream->HttpIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Stream->HttpCreated = TRUE;
+
+  //
+  // The same headers as HttpBootGetBootFile(), plus the Range.
+  //
+  Stream->HttpIoHeader = HttpIoCreateHeader (4);
+  if (Stream->HttpIoHeader == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIoSetHeader (Stream->HttpIoHeader, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIoSetHeader (Stream->HttpIoHeader, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIoSetHeader (Stream->HttpIoHeader, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  AsciiSPrint (
+    Range,
+    sizeof (Range),
+    "bytes=%Lu-%Lu",
+    (UINT64)Stream->Offset,
+    (UINT64)(Stream->End - 1)
+    );
+  Status = HttpIoSetHeader (Stream->HttpIoHeader, HTTP_HEADER_RANGE, Range);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Stream->RequestData.Method = HttpMethodGet;
+  Stream->RequestData.Url    = Url;
+
+  return HttpIoSendRequest (
+           &Stream->HttpIo,
+           &Stream->RequestData,
+           Stream->HttpIoHeader->HeaderCount,
+           Stream->HttpIoHeader->Headers,
+           0,
+           NULL
+           );
+}
+
+/**
+  Receive the response header of a range request, and check that the server
+  sends the requested byte range.
+
+  @param[in, out]  Stream          The connection the range was requested on.
+
+  @retval EFI_SUCCESS              The server sends the requested range.
+  @retval EFI_UNSUPPORTED          The server doesn't honor the range request.
+  @retval Others                   Failed to receive the response.
+
+**/
+EFI_STATUS
+HttpBootRecvRangeResponse (
+  IN OUT HTTP_BOOT_RANGE_STREAM  *Stream
+  )
+{
+  EFI_STATUS       Status;
+  EFI_HTTP_HEADER  *Header;
+  CHAR8            *String;
+  UINTN            First;
+  UINTN            Last;
+
+  Status = HttpIoRecvResponse (&Stream->HttpIo, TRUE, &Stream->ResponseData);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (EFI_ERROR (Stream->ResponseData.Status)) {
+    return Stream->ResponseData.Status;
+  }
+
+  if (Stream->ResponseData.Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Content-Range: bytes First-Last/Length
+  //
+  Header = HttpFindHeader (
+             Stream->ResponseData.HeaderCount,
+             Stream->ResponseData.Headers,
+             HTTP_HEADER_CONTENT_RANGE
+             );
+  if ((Header == NULL) ||
+      (AsciiStrnCmp (Header->FieldValue, "bytes ", sizeof ("bytes ") - 1) != 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  String = Header->FieldValue + sizeof ("bytes ") - 1;
+  if (EFI_ERROR (AsciiStrDecimalToUintnS (String, &String, &First)) || (*String != '-') ||
+      EFI_ERROR (AsciiStrDecimalToUintnS (String + 1, NULL, &Last)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((First != Stream->Offset) || (Last != Stream->End - 1)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file over several connections, each receiving a byte range
+  of the file directly into its place in Buffer.
+
+  The connections are serviced in turn. While one is waited for, the others
+  keep receiving into their TCP receive buffers, so the download runs as fast
+  as all the connections together.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file.
+  @param[out]      Buffer          The memory buffer to transfer the file to, at
+                                   least FileSize bytes.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The server doesn't honor range requests.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_ABORTED              The download was cancelled by the callback.
+  @retval EFI_SECURITY_VIOLATION   The file doesn't match the digest sent by the server.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  OUT UINT8                      *Buffer
+  )
+{
+  EFI_STATUS              Status;
+  HTTP_BOOT_RANGE_STREAM  *Streams;
+  HTTP_BOOT_RANGE_STREAM  *Stream;
+  HTTP_IO_RESPONSE_DATA   ResponseBody;
+  UINTN                   Count;
+  UINTN                   Index;
+  UINTN                   RangeSize;
+  UINTN                   Pending;
+  HTTP_BOOT_DIGEST        Digest;
+  UINTN                   HashIndex;
+  UINTN                   HashedSize;
+
+  Count   = MIN (PcdGet8 (PcdHttpBootDownloadConnections), HTTP_BOOT_MAX_DOWNLOAD_CONNECTIONS);
+  Streams = AllocateZeroPool (Count * sizeof (HTTP_BOOT_RANGE_STREAM));
+  if (Streams == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (&Digest, sizeof (HTTP_BOOT_DIGEST));
+
+  //
+  // Split the file in Count ranges, the last one takes the remainder.
+  //
+  RangeSize = FileSize / Count;
+  for (Index = 0; Index < Count; Index++) {
+    Streams[Index].Offset = Index * RangeSize;
+    Streams[Index].End    = (Index == Count - 1) ? FileSize : (Index + 1) * RangeSize;
+  }
+
+  //
+  // Request all the ranges first, so that the server sends them at once.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    Status = HttpBootSendRangeRequest (Private, Url, &Streams[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    if (Index == 0) {
+      Status = HttpBootHttpIoCallback (HttpIoRequest, Streams[0].HttpIo.ReqToken.Message, Private);
+      if (EFI_ERROR (Status)) {
+        Status = EFI_ABORTED;
+        goto ON_EXIT;
+      }
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = HttpBootRecvRangeResponse (&Streams[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Hash the file as it is received, if the server sends its digest. The
+  // digest headers of a range response are about the whole file.
+  //
+  Status = HttpBootInitDigest (
+             Streams[0].ResponseData.HeaderCount,
+             Streams[0].ResponseData.Headers,
+             &Digest
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  HashIndex  = 0;
+  HashedSize = 0;
+
+  //
+  // Receive the ranges in turn, each one directly into its place in Buffer.
+  //
+  Pending = Count;
+  while (Pending > 0) {
+    for (Index = 0; Index < Count; Index++) {
+      Stream = &Streams[Index];
+      if (Stream->Offset == Stream->End) {
+        continue;
+      }
+
+      ZeroMem (&ResponseBody, sizeof (HTTP_IO_RESPONSE_DATA));
+      ResponseBody.Body       = (CHAR8 *)Buffer + Stream->Offset;
+      ResponseBody.BodyLength = Stream->End - Stream->Offset;
+      Status                  = HttpIoRecvResponse (
+                                  &Stream->HttpIo,
+                                  FALSE,
+                                  &ResponseBody
+                                  );
+      if (EFI_ERROR (Status) || EFI_ERROR (ResponseBody.Status)) {
+        if (EFI_ERROR (ResponseBody.Status)) {
+          Status = ResponseBody.Status;
+        }
+
+        goto ON_EXIT;
+      }
+
+      Stream->Offset += ResponseBody.BodyLength;
+      if (Stream->Offset == Stream->End) {
+        Pending--;
+      }
+
+      //
+      // The file is hashed in order: hash the data received right after the
+      // part hashed so far, up to the first range not completely received.
+      //
+      while (HashIndex < Count) {
+        HttpBootUpdateDigest (&Digest, Buffer + HashedSize, Streams[HashIndex].Offset - HashedSize);
+        HashedSize = Streams[HashIndex].Offset;
+        if (HashedSize != Streams[HashIndex].End) {
+          break;
+        }
+
+        HashIndex++;
+      }
+
+      if (Private->HttpBootCallback != NULL) {
+        Status = Private->HttpBootCallback->Callback (
+                                              Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)ResponseBody.BodyLength,
+                                              ResponseBody.Body
+                                              );
+        if (EFI_ERROR (Status)) {
+          Status = EFI_ABORTED;
+          goto ON_EXIT;
+        }
+      }
+    }
+  }
+
+  Status = HttpBootCheckDigest (&Digest);
+
+ON_EXIT:
+  HttpBootFreeDigest (&Digest);
+  for (Index = 0; Index < Count; Index++) {
+    HttpBootFreeRangeStream (&Streams[Index]);
+  }
+
+  FreePool (Streams);
+  return Status;
+}
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -922,6 +1477,7 @@ HttpBootGetBootFileCallback (
   @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to read the current directory entry.
                                    BufferSize has been updated with the size needed to complete
                                    the request.
+  @retval EFI_SECURITY_VIOLATION   The file doesn't match the digest sent by the server.
   @retval Others                   Unexpected error happened.
 
 **/
@@ -951,6 +1507,7 @@ HttpBootGetBootFile (
   CHAR16                   *Url;
   BOOLEAN                  IdentityMode;
   UINTN                    ReceivedSize;
+  EFI_HTTP_HEADER          *Header;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -985,6 +1542,43 @@ HttpBootGetBootFile (
   // Not found in cache, try to download it through HTTP.
   //
 
+  //
+  // A large file goes faster over several connections, if the server serves
+  // byte ranges. Otherwise fall back to a single connection.
+  //
+  if (!HeaderOnly && (Buffer != NULL) && Private->BootFileRangeSupported &&
+      (Private->BootFileSize >= HTTP_BOOT_PARALLEL_MIN_SIZE) &&
+      (*BufferSize >= Private->BootFileSize) &&
+      (PcdGet8 (PcdHttpBootDownloadConnections) > 1))
+  {
+    //
+    // Release the HTTP child, so that the first range reuses the connection
+    // it keeps open to the server since the HEAD request.
+    //
+    HttpIoDestroyIo (&Private->HttpIo);
+    Private->HttpCreated = FALSE;
+
+    Status = HttpBootGetBootFileByRanges (Private, Url, Private->BootFileSize, Buffer);
+    if (!EFI_ERROR (Status) || (Status == EFI_ABORTED) || (Status == EFI_SECURITY_VIOLATION)) {
+      if (!EFI_ERROR (Status)) {
+        *BufferSize = Private->BootFileSize;
+        *ImageType  = Private->ImageType;
+      }
+
+      FreePool (Url);
+      return Status;
+    }
+
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFile: Range download failed, %r. Falling back to a single connection.\n", Status));
+    Private->BootFileRangeSupported = FALSE;
+
+    Status = HttpBootCreateHttpIo (Private);
+    if (EFI_ERROR (Status)) {
+      FreePool (Url);
+      return Status;
+    }
+  }
+
   //
   // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
   //
@@ -1140,6 +1734,30 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Record whether the server serves byte ranges of the boot file.
+  //
+  if (HeaderOnly) {
+    Header                          = HttpFindHeader (
+                                        ResponseData->HeaderCount,
+                                        ResponseData->Headers,
+                                        HTTP_HEADER_ACCEPT_RANGES
+                                        );
+    Private->BootFileRangeSupported = (BOOLEAN)((Header != NULL) &&
+                                                (AsciiStriCmp (Header->FieldValue, HTTP_ACCEPT_RANGES_BYTES) == 0));
+  }
+
+  //
+  // Hash the message-body as it is received, if the server sends its digest.
+  //
+  ZeroMem (&Context.Digest, sizeof (HTTP_BOOT_DIGEST));
+  if (!HeaderOnly) {
+    Status = HttpBootInitDigest (ResponseData->HeaderCount, ResponseData->Headers, &Context.Digest);
+    if (EFI_ERROR (Status)) {
+      goto ERROR_5;
+    }
+  }
+
   //
   // 3.2 Cache the response header.
   //
@@ -1216,6 +1834,7 @@ HttpBootGetBootFile (
         }
 
         ReceivedSize += ResponseBody.BodyLength;
+        HttpBootUpdateDigest (&Context.Digest, ResponseBody.Body, ResponseBody.BodyLength);
         if (Private->HttpBootCallback != NULL) {
           Status = Private->HttpBootCallback->Callback (
                                                 Private->HttpBootCallback,
@@ -1299,6 +1918,15 @@ HttpBootGetBootFile (
     Status = EFI_SUCCESS;
   }
 
+  //
+  // The whole message-body is received, check it against its digest before
+  // it is returned or cached.
+  //
+  if (!HeaderOnly && EFI_ERROR (HttpBootCheckDigest (&Context.Digest))) {
+    Status = EFI_SECURITY_VIOLATION;
+    goto ERROR_6;
+  }
+
   *BufferSize = ContentLength;
 
   //
@@ -1320,6 +1948,8 @@ ERROR_6:
     HttpFreeMsgParser (Parser);
   }
 
+  HttpBootFreeDigest (&Context.Digest);
+
   if (Context.Block != NULL) {
     FreePool (Context.Block);
   }
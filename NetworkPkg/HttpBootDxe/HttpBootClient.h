@@ -13,6 +13,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_BLOCK_SIZE           1500
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT  "UefiHttpBoot/1.0"
 
+//
+// Files smaller than this are not worth the handshakes of extra connections.
+//
+#define HTTP_BOOT_PARALLEL_MIN_SIZE         SIZE_8MB
+#define HTTP_BOOT_MAX_DOWNLOAD_CONNECTIONS  16
+
+//
+// The digest algorithm checked in the Repr-Digest and Digest headers, in
+// upper case.
+//
+#define HTTP_BOOT_DIGEST_SHA256  "SHA-256="
+
 //
 // Record the data length and start address of a data block.
 //
@@ -35,6 +47,14 @@ typedef struct {
   LIST_ENTRY               EntityDataList;    // Entity data (message-body)
 } HTTP_BOOT_CACHE_CONTENT;
 
+//
+// The digest of a boot file, computed as the file is received
+//
+typedef struct {
+  VOID     *Sha256Context;                // NULL if the server sends no digest
+  UINT8    Expected[SHA256_DIGEST_SIZE];  // The digest sent by the server
+} HTTP_BOOT_DIGEST;
+
 //
 // Callback data for HTTP_BODY_PARSER_CALLBACK()
 //
@@ -54,9 +74,24 @@ typedef struct {
   UINTN                      BufferSize;
   UINT8                      *Buffer;
 
+  HTTP_BOOT_DIGEST           Digest;
+
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// One connection of a parallel download, receiving a byte range of the file
+//
+typedef struct {
+  HTTP_IO                  HttpIo;
+  BOOLEAN                  HttpCreated;
+  HTTP_IO_HEADER           *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA    RequestData;
+  HTTP_IO_RESPONSE_DATA    ResponseData;
+  UINTN                    Offset;            // Next byte of the range to receive
+  UINTN                    End;               // One past the last byte of the range
+} HTTP_BOOT_RANGE_STREAM;
+
 /**
   Discover all the boot information for boot file.
 
@@ -106,6 +141,7 @@ HttpBootCreateHttpIo (
   @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to read the current directory entry.
                                    BufferSize has been updated with the size needed to complete
                                    the request.
+  @retval EFI_SECURITY_VIOLATION   The file doesn't match the digest sent by the server.
   @retval Others                   Unexpected error happened.
 
 **/
@@ -66,6 +66,7 @@ HttpCreateService (
   HttpService->ControllerHandle            = Controller;
   HttpService->ChildrenNumber              = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->IdleConnections);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -89,6 +90,8 @@ HttpCleanService (
     return;
   }
 
+  HttpFreeIdleConnections (HttpService, UsingIpv6);
+
   if (!UsingIpv6) {
     if (HttpService->Tcp4ChildHandle != NULL) {
       gBS->CloseProtocol (
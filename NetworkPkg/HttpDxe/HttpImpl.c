@@ -439,6 +439,14 @@ EfiHttpRequest (
       // Request() is called the first time.
       //
       ReConfigure = FALSE;
+
+      //
+      // Take over an idle connection to the same server if there is one.
+      //
+      if (HttpReuseConnection (HttpInstance, HostName, RemotePort)) {
+        Configure    = FALSE;
+        TlsConfigure = FALSE;
+      }
     } else {
       if ((HttpInstance->RemotePort == RemotePort) &&
           (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) &&
@@ -649,6 +657,11 @@ EfiHttpRequest (
     }
   }
 
+  //
+  // The connection may only be kept once the response is received.
+  //
+  HttpInstance->KeepAlive = FALSE;
+
   //
   // Transmit the request message.
   //
@@ -990,6 +1003,7 @@ HttpResponseWorker (
   UINTN             HdrLen;
   NET_FRAGMENT      Fragment;
   UINT32            TimeoutValue;
+  EFI_HTTP_HEADER   *Header;
 
   if ((Wrap == NULL) || (Wrap->HttpInstance == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1196,6 +1210,14 @@ HttpResponseWorker (
       FreePool (HttpHeaders);
       HttpHeaders = NULL;
 
+      //
+      // The connection is kept open after this response unless the server
+      // asks to close it.
+      //
+      Header                  = HttpFindHeader (HttpMsg->HeaderCount, HttpMsg->Headers, HTTP_HEADER_CONNECTION);
+      HttpInstance->KeepAlive = (BOOLEAN)((Header == NULL) ||
+                                          (AsciiStriCmp (Header->FieldValue, HTTP_CONNECTION_CLOSE) != 0));
+
       //
       // Init message-body parser by header information.
       //
@@ -1407,17 +1429,18 @@ HttpResponseWorker (
         FreePool (HttpInstance->CacheBody);
       }
 
-      HttpInstance->CacheBody = AllocateZeroPool (HttpInstance->CacheLen);
-      if (HttpInstance->CacheBody == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Error2;
-      }
-
-      CopyMem (HttpInstance->CacheBody, Fragment.Bulk + HttpMsg->BodyLength, HttpInstance->CacheLen);
-      HttpInstance->CacheOffset = 0;
+      //
+      // Keep the decrypted record as the cache, the data not returned yet
+      // starts at CacheOffset. This saves copying the rest of the record.
+      //
+      HttpInstance->CacheBody   = (CHAR8 *)Fragment.Bulk;
+      HttpInstance->CacheLen    = Fragment.Len;
+      HttpInstance->CacheOffset = HttpMsg->BodyLength;
       if (HttpInstance->NextMsg != NULL) {
-        HttpInstance->NextMsg = HttpInstance->CacheBody;
+        HttpInstance->NextMsg = HttpInstance->CacheBody + HttpInstance->CacheOffset;
       }
+
+      Fragment.Bulk = NULL;
     }
 
     if (Fragment.Bulk != NULL) {
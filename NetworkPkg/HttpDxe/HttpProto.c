@@ -819,6 +819,11 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   )
 {
+  //
+  // Keep the connection for a later request to the same server, otherwise
+  // close it.
+  //
+  HttpKeepConnection (HttpInstance);
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -927,6 +932,501 @@ HttpCleanProtocol (
   TlsCloseTxRxEvent (HttpInstance);
 }
 
+/**
+  Close an idle connection, and release it.
+
+  @param[in]  HttpService        The HTTP service keeping the connection.
+  @param[in]  Connection         The idle connection, already removed from
+                                 the list of the HTTP service.
+
+**/
+VOID
+HttpFreeIdleConnection (
+  IN HTTP_SERVICE          *HttpService,
+  IN HTTP_IDLE_CONNECTION  *Connection
+  )
+{
+  //
+  // Resetting the TCP child aborts the connection, the same way
+  // HttpCloseConnection() does.
+  //
+  if (!Connection->LocalAddressIsIPv6) {
+    Connection->Tcp4->Configure (Connection->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  } else {
+    Connection->Tcp6->Configure (Connection->Tcp6, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  }
+
+  if (Connection->TlsChildHandle != NULL) {
+    Connection->TlsSb->DestroyChild (Connection->TlsSb, Connection->TlsChildHandle);
+  }
+
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+}
+
+/**
+  Hand the established connection of the HTTP child over to its HTTP service,
+  so that a later HTTP child may reuse it.
+
+  The connection is only kept if the last response has been completely
+  received and the server didn't ask to close the connection.
+
+  @param[in, out]  HttpInstance       The HTTP child being reset or destroyed.
+
+  @retval TRUE                        The connection is kept by the HTTP service.
+  @retval FALSE                       The connection is still owned by the HTTP child.
+
+**/
+BOOLEAN
+HttpKeepConnection (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE               *HttpService;
+  HTTP_IDLE_CONNECTION       *Connection;
+  HTTP_IDLE_CONNECTION       *Oldest;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+  EFI_STATUS                 Status;
+  EFI_TPL                    OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if ((HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      !HttpInstance->KeepAlive ||
+      (HttpInstance->MsgParser != NULL) ||
+      (HttpInstance->RemoteHost == NULL) ||
+      !NetMapIsEmpty (&HttpInstance->TxTokens) ||
+      !NetMapIsEmpty (&HttpInstance->RxTokens))
+  {
+    return FALSE;
+  }
+
+  if (HttpInstance->UseHttps &&
+      ((HttpInstance->TlsChildHandle == NULL) ||
+       (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring)))
+  {
+    return FALSE;
+  }
+
+  //
+  // Don't keep a connection the server has closed already.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    if (HttpService->Tcp4ChildHandle == NULL) {
+      return FALSE;
+    }
+
+    Status = HttpInstance->Tcp4->GetModeData (HttpInstance->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    if (EFI_ERROR (Status) || (Tcp4State != Tcp4StateEstablished)) {
+      return FALSE;
+    }
+  } else {
+    if (HttpService->Tcp6ChildHandle == NULL) {
+      return FALSE;
+    }
+
+    Status = HttpInstance->Tcp6->GetModeData (HttpInstance->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+    if (EFI_ERROR (Status) || (Tcp6State != Tcp6StateEstablished)) {
+      return FALSE;
+    }
+  }
+
+  Connection = AllocateZeroPool (sizeof (HTTP_IDLE_CONNECTION));
+  if (Connection == NULL) {
+    return FALSE;
+  }
+
+  Connection->LocalAddressIsIPv6 = HttpInstance->LocalAddressIsIPv6;
+  Connection->UseHttps           = HttpInstance->UseHttps;
+  Connection->RemoteHost         = HttpInstance->RemoteHost;
+  Connection->RemotePort         = HttpInstance->RemotePort;
+  IP4_COPY_ADDRESS (&Connection->RemoteAddr, &HttpInstance->RemoteAddr);
+  IP6_COPY_ADDRESS (&Connection->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+  CopyMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (Connection->IPv4Node));
+  CopyMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Connection->Ipv6Node));
+
+  //
+  // The TCP child stays opened BY_DRIVER by the HTTP service, only the
+  // HTTP child lets it go.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    Connection->TcpChildHandle    = HttpInstance->Tcp4ChildHandle;
+    Connection->Tcp4              = HttpInstance->Tcp4;
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    Connection->TcpChildHandle    = HttpInstance->Tcp6ChildHandle;
+    Connection->Tcp6              = HttpInstance->Tcp6;
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  if (HttpInstance->UseHttps) {
+    Connection->TlsSb            = HttpInstance->TlsSb;
+    Connection->TlsChildHandle   = HttpInstance->TlsChildHandle;
+    Connection->Tls              = HttpInstance->Tls;
+    Connection->TlsConfiguration = HttpInstance->TlsConfiguration;
+    CopyMem (&Connection->TlsConfigData, &HttpInstance->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+
+    HttpInstance->TlsChildHandle   = NULL;
+    HttpInstance->Tls              = NULL;
+    HttpInstance->TlsConfiguration = NULL;
+    HttpInstance->TlsSessionState  = EfiTlsSessionNotStarted;
+  }
+
+  HttpInstance->RemoteHost = NULL;
+  HttpInstance->RemotePort = 0;
+  HttpInstance->KeepAlive  = FALSE;
+  HttpInstance->State      = HTTP_STATE_TCP_UNCONFIGED;
+
+  //
+  // Make room by closing the connection idle for the longest time.
+  //
+  Oldest = NULL;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (HttpService->IdleConnectionNumber >= HTTP_IDLE_CONNECTION_MAX) {
+    Oldest = NET_LIST_HEAD (&HttpService->IdleConnections, HTTP_IDLE_CONNECTION, Link);
+    RemoveEntryList (&Oldest->Link);
+    HttpService->IdleConnectionNumber--;
+  }
+
+  InsertTailList (&HttpService->IdleConnections, &Connection->Link);
+  HttpService->IdleConnectionNumber++;
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Oldest != NULL) {
+    HttpFreeIdleConnection (HttpService, Oldest);
+  }
+
+  return TRUE;
+}
+
+/**
+  Take the idle connection to a server out of the list of the HTTP service.
+
+  @param[in]  HttpInstance       The HTTP child requesting the server.
+  @param[in]  RemoteHost         The host name of the server.
+  @param[in]  RemotePort         The port of the server.
+
+  @return  The idle connection, or NULL if there is none to the server.
+
+**/
+HTTP_IDLE_CONNECTION *
+HttpRemoveIdleConnection (
+  IN HTTP_PROTOCOL  *HttpInstance,
+  IN CHAR8          *RemoteHost,
+  IN UINT16         RemotePort
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  HTTP_IDLE_CONNECTION  *Connection;
+  LIST_ENTRY            *Entry;
+  EFI_TPL               OldTpl;
+  BOOLEAN               Found;
+
+  HttpService = HttpInstance->Service;
+  Found       = FALSE;
+  OldTpl      = gBS->RaiseTPL (TPL_CALLBACK);
+
+  //
+  // Start with the most recently used connection, the least likely to
+  // have been closed by the server.
+  //
+  for (Entry = HttpService->IdleConnections.BackLink;
+       Entry != &HttpService->IdleConnections;
+       Entry = Entry->BackLink)
+  {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+
+    if ((Connection->LocalAddressIsIPv6 != HttpInstance->LocalAddressIsIPv6) ||
+        (Connection->UseHttps != HttpInstance->UseHttps) ||
+        (Connection->RemotePort != RemotePort) ||
+        (AsciiStrCmp (Connection->RemoteHost, RemoteHost) != 0))
+    {
+      continue;
+    }
+
+    //
+    // The local access point must be the same too.
+    //
+    if ((!HttpInstance->LocalAddressIsIPv6 &&
+         (CompareMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (Connection->IPv4Node)) != 0)) ||
+        (HttpInstance->LocalAddressIsIPv6 &&
+         (CompareMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Connection->Ipv6Node)) != 0)))
+    {
+      continue;
+    }
+
+    RemoveEntryList (&Connection->Link);
+    HttpService->IdleConnectionNumber--;
+    Found = TRUE;
+    break;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Found ? Connection : NULL;
+}
+
+/**
+  Take over an idle connection to the server of the request, kept by the
+  HTTP service, instead of connecting again.
+
+  @param[in, out]  HttpInstance       The HTTP child, not connected yet.
+  @param[in]       RemoteHost         The host name of the server.
+  @param[in]       RemotePort         The port of the server.
+
+  @retval TRUE                        The HTTP child is connected to the server.
+  @retval FALSE                       No idle connection to the server is available.
+
+**/
+BOOLEAN
+HttpReuseConnection (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *RemoteHost,
+  IN     UINT16         RemotePort
+  )
+{
+  HTTP_SERVICE               *HttpService;
+  HTTP_IDLE_CONNECTION       *Connection;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+  EFI_STATUS                 Status;
+  VOID                       *Interface;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpInstance->State != HTTP_STATE_HTTP_CONFIGED) {
+    return FALSE;
+  }
+
+  //
+  // Skip the connections closed by the server while they were idle.
+  //
+  while (TRUE) {
+    Connection = HttpRemoveIdleConnection (HttpInstance, RemoteHost, RemotePort);
+    if (Connection == NULL) {
+      return FALSE;
+    }
+
+    if (!Connection->LocalAddressIsIPv6) {
+      Status = Connection->Tcp4->GetModeData (Connection->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+      if (!EFI_ERROR (Status) && (Tcp4State == Tcp4StateEstablished)) {
+        break;
+      }
+    } else {
+      Status = Connection->Tcp6->GetModeData (Connection->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+      if (!EFI_ERROR (Status) && (Tcp6State == Tcp6StateEstablished)) {
+        break;
+      }
+    }
+
+    HttpFreeIdleConnection (HttpService, Connection);
+  }
+
+  //
+  // The HTTP child needs its own connection and close events, and TLS
+  // events for HTTPS, as if it had connected itself.
+  //
+  Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+  if (EFI_ERROR (Status)) {
+    HttpFreeIdleConnection (HttpService, Connection);
+    return FALSE;
+  }
+
+  if (Connection->UseHttps) {
+    Status = TlsCreateTxRxEvent (HttpInstance);
+    if (EFI_ERROR (Status)) {
+      HttpCloseTcpConnCloseEvent (HttpInstance);
+      HttpFreeIdleConnection (HttpService, Connection);
+      return FALSE;
+    }
+  }
+
+  //
+  // Swap the unused TCP child of the HTTP child for the connected one.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    Status = gBS->OpenProtocol (
+                    Connection->TcpChildHandle,
+                    &gEfiTcp4ProtocolGuid,
+                    (VOID **)&Interface,
+                    HttpService->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  } else {
+    Status = gBS->OpenProtocol (
+                    Connection->TcpChildHandle,
+                    &gEfiTcp6ProtocolGuid,
+                    (VOID **)&Interface,
+                    HttpService->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    TlsCloseTxRxEvent (HttpInstance);
+    HttpCloseTcpConnCloseEvent (HttpInstance);
+    HttpFreeIdleConnection (HttpService, Connection);
+    return FALSE;
+  }
+
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      HttpInstance->Tcp4ChildHandle
+      );
+
+    HttpInstance->Tcp4ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp4            = Connection->Tcp4;
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Connection->RemoteAddr);
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      HttpInstance->Tcp6ChildHandle
+      );
+
+    HttpInstance->Tcp6ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp6            = Connection->Tcp6;
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Connection->RemoteIpv6Addr);
+  }
+
+  //
+  // Replace the TLS child created for the request with the one of the
+  // established session.
+  //
+  if (Connection->UseHttps) {
+    if (HttpInstance->TlsChildHandle != NULL) {
+      HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+    }
+
+    HttpInstance->TlsSb            = Connection->TlsSb;
+    HttpInstance->TlsChildHandle   = Connection->TlsChildHandle;
+    HttpInstance->Tls              = Connection->Tls;
+    HttpInstance->TlsConfiguration = Connection->TlsConfiguration;
+    HttpInstance->TlsSessionState  = EfiTlsSessionDataTransferring;
+    CopyMem (&HttpInstance->TlsConfigData, &Connection->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+  }
+
+  HttpInstance->RemoteHost = Connection->RemoteHost;
+  HttpInstance->RemotePort = Connection->RemotePort;
+  HttpInstance->State      = HTTP_STATE_TCP_CONNECTED;
+
+  FreePool (Connection);
+
+  return TRUE;
+}
+
+/**
+  Close and release all the idle connections of one IP version kept by the
+  HTTP service.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Release the TCP6 connections if TRUE, the TCP4
+                                 connections otherwise.
+
+**/
+VOID
+HttpFreeIdleConnections (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  )
+{
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *Next;
+  HTTP_IDLE_CONNECTION  *Connection;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->IdleConnections) {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+    if (Connection->LocalAddressIsIPv6 != UsingIpv6) {
+      continue;
+    }
+
+    RemoveEntryList (&Connection->Link);
+    HttpService->IdleConnectionNumber--;
+    HttpFreeIdleConnection (HttpService, Connection);
+  }
+}
+
 /**
   Establish TCP connection with HTTP server.
 
@@ -1073,18 +1573,20 @@ HttpConfigureTcp4 (
   Tcp4AP->ActiveFlag  = TRUE;
   IP4_COPY_ADDRESS (&Tcp4AP->RemoteAddress, &HttpInstance->RemoteAddr);
 
-  Tcp4Option                    = Tcp4CfgData->ControlOption;
-  Tcp4Option->ReceiveBufferSize = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp4Option->SendBufferSize    = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp4Option->MaxSynBackLog     = HTTP_MAX_SYN_BACK_LOG;
-  Tcp4Option->ConnectionTimeout = HTTP_CONNECTION_TIMEOUT;
-  Tcp4Option->DataRetries       = HTTP_DATA_RETRIES;
-  Tcp4Option->FinTimeout        = HTTP_FIN_TIMEOUT;
-  Tcp4Option->KeepAliveProbes   = HTTP_KEEP_ALIVE_PROBES;
-  Tcp4Option->KeepAliveTime     = HTTP_KEEP_ALIVE_TIME;
-  Tcp4Option->KeepAliveInterval = HTTP_KEEP_ALIVE_INTERVAL;
-  Tcp4Option->EnableNagle       = TRUE;
-  Tcp4CfgData->ControlOption    = Tcp4Option;
+  Tcp4Option                      = Tcp4CfgData->ControlOption;
+  Tcp4Option->ReceiveBufferSize   = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp4Option->SendBufferSize      = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp4Option->MaxSynBackLog       = HTTP_MAX_SYN_BACK_LOG;
+  Tcp4Option->ConnectionTimeout   = HTTP_CONNECTION_TIMEOUT;
+  Tcp4Option->DataRetries         = HTTP_DATA_RETRIES;
+  Tcp4Option->FinTimeout          = HTTP_FIN_TIMEOUT;
+  Tcp4Option->KeepAliveProbes     = HTTP_KEEP_ALIVE_PROBES;
+  Tcp4Option->KeepAliveTime       = HTTP_KEEP_ALIVE_TIME;
+  Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
+  Tcp4Option->EnableNagle         = TRUE;
+  Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
+  Tcp4CfgData->ControlOption      = Tcp4Option;
 
   Status = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
   if (EFI_ERROR (Status)) {
@@ -1144,17 +1646,19 @@ HttpConfigureTcp6 (
   IP6_COPY_ADDRESS (&Tcp6Ap->StationAddress, &HttpInstance->Ipv6Node.LocalAddress);
   IP6_COPY_ADDRESS (&Tcp6Ap->RemoteAddress, &HttpInstance->RemoteIpv6Addr);
 
-  Tcp6Option                    = Tcp6CfgData->ControlOption;
-  Tcp6Option->ReceiveBufferSize = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp6Option->SendBufferSize    = HTTP_BUFFER_SIZE_DEAULT;
-  Tcp6Option->MaxSynBackLog     = HTTP_MAX_SYN_BACK_LOG;
-  Tcp6Option->ConnectionTimeout = HTTP_CONNECTION_TIMEOUT;
-  Tcp6Option->DataRetries       = HTTP_DATA_RETRIES;
-  Tcp6Option->FinTimeout        = HTTP_FIN_TIMEOUT;
-  Tcp6Option->KeepAliveProbes   = HTTP_KEEP_ALIVE_PROBES;
-  Tcp6Option->KeepAliveTime     = HTTP_KEEP_ALIVE_TIME;
-  Tcp6Option->KeepAliveInterval = HTTP_KEEP_ALIVE_INTERVAL;
-  Tcp6Option->EnableNagle       = TRUE;
+  Tcp6Option                      = Tcp6CfgData->ControlOption;
+  Tcp6Option->ReceiveBufferSize   = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp6Option->SendBufferSize      = HTTP_BUFFER_SIZE_DEAULT;
+  Tcp6Option->MaxSynBackLog       = HTTP_MAX_SYN_BACK_LOG;
+  Tcp6Option->ConnectionTimeout   = HTTP_CONNECTION_TIMEOUT;
+  Tcp6Option->DataRetries         = HTTP_DATA_RETRIES;
+  Tcp6Option->FinTimeout          = HTTP_FIN_TIMEOUT;
+  Tcp6Option->KeepAliveProbes     = HTTP_KEEP_ALIVE_PROBES;
+  Tcp6Option->KeepAliveTime       = HTTP_KEEP_ALIVE_TIME;
+  Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
+  Tcp6Option->EnableNagle         = TRUE;
+  Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   Status = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
   if (EFI_ERROR (Status)) {
@@ -48,6 +48,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_URL_BUFFER_LEN  4096
 
+//
+// The maximum number of idle connections kept by one HTTP service.
+//
+#define HTTP_IDLE_CONNECTION_MAX  8
+
 typedef struct _HTTP_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -59,6 +64,8 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                      ChildrenList;
   UINTN                           ChildrenNumber;
   INTN                            State;
+  LIST_ENTRY                      IdleConnections;
+  UINTN                           IdleConnectionNumber;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -84,6 +91,34 @@ typedef struct {
   EFI_TLS_SESSION_STATE     SessionState;
 } TLS_CONFIG_DATA;
 
+//
+// An established connection, and its TLS session for HTTPS, kept by the
+// HTTP service after the HTTP child that opened it is reset or destroyed.
+// A later HTTP child requesting the same server takes it over instead of
+// connecting again.
+//
+typedef struct {
+  LIST_ENTRY                        Link;
+  BOOLEAN                           LocalAddressIsIPv6;
+  BOOLEAN                           UseHttps;
+  CHAR8                             *RemoteHost;
+  UINT16                            RemotePort;
+  EFI_IPv4_ADDRESS                  RemoteAddr;
+  EFI_IPv6_ADDRESS                  RemoteIpv6Addr;
+  EFI_HTTPv4_ACCESS_POINT           IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT           Ipv6Node;
+
+  EFI_HANDLE                        TcpChildHandle;
+  EFI_TCP4_PROTOCOL                 *Tcp4;
+  EFI_TCP6_PROTOCOL                 *Tcp6;
+
+  EFI_SERVICE_BINDING_PROTOCOL      *TlsSb;
+  EFI_HANDLE                        TlsChildHandle;
+  TLS_CONFIG_DATA                   TlsConfigData;
+  EFI_TLS_PROTOCOL                  *Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL    *TlsConfiguration;
+} HTTP_IDLE_CONNECTION;
+
 //
 // Callback data for HTTP_PARSER_CALLBACK()
 //
@@ -105,6 +140,12 @@ typedef struct _HTTP_PROTOCOL {
 
   UINTN                             StatusCode;
 
+  //
+  // TRUE if the server keeps the connection open after the response
+  // being received.
+  //
+  BOOLEAN                           KeepAlive;
+
   EFI_EVENT                         TimeoutEvent;
 
   EFI_HANDLE                        Tcp4ChildHandle;
@@ -331,6 +372,58 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Hand the established connection of the HTTP child over to its HTTP service,
+  so that a later HTTP child may reuse it.
+
+  The connection is only kept if the last response has been completely
+  received and the server didn't ask to close the connection.
+
+  @param[in, out]  HttpInstance       The HTTP child being reset or destroyed.
+
+  @retval TRUE                        The connection is kept by the HTTP service.
+  @retval FALSE                       The connection is still owned by the HTTP child.
+
+**/
+BOOLEAN
+HttpKeepConnection (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Take over an idle connection to the server of the request, kept by the
+  HTTP service, instead of connecting again.
+
+  @param[in, out]  HttpInstance       The HTTP child, not connected yet.
+  @param[in]       RemoteHost         The host name of the server.
+  @param[in]       RemotePort         The port of the server.
+
+  @retval TRUE                        The HTTP child is connected to the server.
+  @retval FALSE                       No idle connection to the server is available.
+
+**/
+BOOLEAN
+HttpReuseConnection (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *RemoteHost,
+  IN     UINT16         RemotePort
+  );
+
+/**
+  Close and release all the idle connections of one IP version kept by the
+  HTTP service.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Release the TCP6 connections if TRUE, the TCP4
+                                 connections otherwise.
+
+**/
+VOID
+HttpFreeIdleConnections (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  );
+
 /**
   Establish TCP connection with HTTP server.
 
@@ -3145,8 +3145,12 @@ IScsiSessionInit (
   Session->MaxConnections       = ISCSI_MAX_CONNS_PER_SESSION;
   Session->InitialR2T           = FALSE;
   Session->ImmediateData        = TRUE;
-  Session->MaxBurstLength       = 262144;
-  Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
+  Session->MaxBurstLength       = PcdGet32 (PcdIScsiMaxBurstLength);
+  Session->MaxBurstLength       = MAX (Session->MaxBurstLength, ISCSI_MIN_BURST_LENGTH);
+  Session->MaxBurstLength       = MIN (Session->MaxBurstLength, ISCSI_MAX_BURST_LENGTH);
+  Session->FirstBurstLength     = PcdGet32 (PcdIScsiFirstBurstLength);
+  Session->FirstBurstLength     = MAX (Session->FirstBurstLength, ISCSI_MIN_BURST_LENGTH);
+  Session->FirstBurstLength     = MIN (Session->FirstBurstLength, Session->MaxBurstLength);
   Session->DefaultTime2Wait     = 2;
   Session->DefaultTime2Retain   = 20;
   Session->MaxOutstandingR2T    = DEFAULT_MAX_OUTSTANDING_R2T;
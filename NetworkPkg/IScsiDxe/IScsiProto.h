@@ -30,6 +30,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN  8192
 #define MAX_RECV_DATA_SEG_LEN_IN_FFP   65536
 #define DEFAULT_MAX_OUTSTANDING_R2T    1
+#define ISCSI_MIN_BURST_LENGTH         512
+#define ISCSI_MAX_BURST_LENGTH         0xFFFFFF
 
 #define ISCSI_VERSION_MAX  0x00
 #define ISCSI_VERSION_MIN  0x00
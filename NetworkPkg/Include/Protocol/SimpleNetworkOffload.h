@@ -0,0 +1,137 @@
+/** @file
+  This file defines the EDKII Simple Network Offload Protocol interface.
+
+  A Simple Network Protocol driver may install this protocol on the same handle
+  as the EFI_SIMPLE_NETWORK_PROTOCOL if the network interface can compute the
+  transport layer checksum of a transmitted frame, or split a large TCP frame
+  into segments, so that the network stack doesn't have to do it in software.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_SIMPLE_NETWORK_OFFLOAD_H_
+#define EDKII_SIMPLE_NETWORK_OFFLOAD_H_
+
+#include <Protocol/SimpleNetwork.h>
+
+#define EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL_GUID \
+  { \
+    0x8d2a7c1e, 0x4b36, 0x4f0b, {0x9e, 0x57, 0xa1, 0x3c, 0x64, 0xd8, 0x20, 0xfb} \
+  }
+
+typedef struct _EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL;
+
+///
+/// The network interface computes the checksum of the transport layer for a
+/// transmitted frame, from EDKII_SIMPLE_NETWORK_TX_OFFLOAD.ChecksumStart to the
+/// end of the frame.
+///
+#define EDKII_SIMPLE_NETWORK_OFFLOAD_TX_CHECKSUM  BIT0
+///
+/// The network interface splits a transmitted TCP over IPv4 frame into
+/// segments of EDKII_SIMPLE_NETWORK_TX_OFFLOAD.SegmentSize bytes of payload.
+///
+#define EDKII_SIMPLE_NETWORK_OFFLOAD_TX_TCP4_SEGMENTATION  BIT1
+
+///
+/// The offloads requested for one transmitted frame.
+///
+typedef struct {
+  ///
+  /// Offset from the start of the frame, media header included, of the
+  /// transport layer header. Only used if ChecksumOffset is not zero.
+  ///
+  UINT16    ChecksumStart;
+  ///
+  /// Offset of the checksum field from ChecksumStart, or zero if the checksum
+  /// is not offloaded. The caller initializes the field with the checksum of
+  /// the pseudo header, not complemented.
+  ///
+  UINT16    ChecksumOffset;
+  ///
+  /// The TCP payload size of each segment, or zero if the frame is not
+  /// segmented. Segmentation requires the checksum to be offloaded as well.
+  ///
+  UINT16    SegmentSize;
+  ///
+  /// The size of the media, IP and TCP headers copied to each segment. Only
+  /// used if SegmentSize is not zero.
+  ///
+  UINT16    HeaderSize;
+} EDKII_SIMPLE_NETWORK_TX_OFFLOAD;
+
+/**
+  Report the offloads supported by the network interface.
+
+  @param[in]   This             Pointer to the EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities     Bitmask of EDKII_SIMPLE_NETWORK_OFFLOAD_* values.
+  @param[out]  MaxFrameSize     The size of the largest frame Transmit() accepts,
+                                media header included.
+
+  @retval EFI_SUCCESS            The offloads were reported.
+  @retval EFI_NOT_STARTED        The network interface has not been initialized.
+  @retval EFI_INVALID_PARAMETER  One of the parameters is NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_OFFLOAD_GET_CAPABILITIES)(
+  IN  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  OUT UINT32                                 *Capabilities,
+  OUT UINTN                                  *MaxFrameSize
+  );
+
+/**
+  Places a packet in the transmit queue of a network interface, and have the
+  network interface complete it as described by Offload.
+
+  The parameters other than Offload, and the recycling of the transmitted
+  buffer through EFI_SIMPLE_NETWORK_PROTOCOL.GetStatus(), are identical to
+  EFI_SIMPLE_NETWORK_PROTOCOL.Transmit(). BufferSize may exceed the MTU if
+  the frame is segmented.
+
+  @param[in]  This        Pointer to the EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  HeaderSize  The size, in bytes, of the media header to be filled
+                          in by Transmit(), or zero.
+  @param[in]  BufferSize  The size, in bytes, of the entire packet.
+  @param[in]  Buffer      A pointer to the packet (media header followed by data).
+  @param[in]  SrcAddr     The source HW MAC address.
+  @param[in]  DestAddr    The destination HW MAC address.
+  @param[in]  Protocol    The type of header to build.
+  @param[in]  Offload     The offloads requested for the packet.
+
+  @retval EFI_SUCCESS            The packet was placed on the transmit queue.
+  @retval EFI_NOT_STARTED        The network interface has not been started.
+  @retval EFI_NOT_READY          The network interface is too busy to accept
+                                 this transmit request.
+  @retval EFI_BUFFER_TOO_SMALL   The BufferSize parameter is too small.
+  @retval EFI_INVALID_PARAMETER  One or more of the parameters has an
+                                 unsupported value.
+  @retval EFI_UNSUPPORTED        An offload in Offload is not supported.
+  @retval EFI_DEVICE_ERROR       The command could not be sent to the network
+                                 interface.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_OFFLOAD_TRANSMIT)(
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL,
+  IN EDKII_SIMPLE_NETWORK_TX_OFFLOAD        *Offload
+  );
+
+///
+/// EDKII Simple Network Offload Protocol delegates transmit checksums and
+/// segmentation to a network interface.
+///
+struct _EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL {
+  EDKII_SIMPLE_NETWORK_OFFLOAD_GET_CAPABILITIES    GetCapabilities;
+  EDKII_SIMPLE_NETWORK_OFFLOAD_TRANSMIT            Transmit;
+};
+
+extern EFI_GUID  gEdkiiSimpleNetworkOffloadProtocolGuid;
+
+#endif /* EDKII_SIMPLE_NETWORK_OFFLOAD_H_ */
@@ -0,0 +1,82 @@
+/** @file
+  This file defines the EDKII Simple Network Receive Loan Protocol interface.
+
+  A Simple Network Protocol driver may install this protocol on the same handle
+  as the EFI_SIMPLE_NETWORK_PROTOCOL to lend its receive buffers to the network
+  stack, instead of copying every received frame into the caller's buffer with
+  EFI_SIMPLE_NETWORK_PROTOCOL.Receive(). A lent buffer is not given back to the
+  network device until it is returned.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_SIMPLE_NETWORK_RX_LOAN_H_
+#define EDKII_SIMPLE_NETWORK_RX_LOAN_H_
+
+#define EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL_GUID \
+  { \
+    0x35b7f445, 0x615b, 0x4fc7, {0x89, 0xc0, 0x25, 0xfe, 0x0c, 0x88, 0xdb, 0x94} \
+  }
+
+typedef struct _EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL;
+
+/**
+  Receive a frame in a buffer lent by the network interface.
+
+  The buffer holds the whole frame, starting with the media header of
+  EFI_SIMPLE_NETWORK_MODE.MediaHeaderSize bytes. The caller may modify the
+  buffer, and must return it with Return() when done.
+
+  @param[in]   This           Pointer to the EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param[out]  Buffer         The buffer holding the received frame.
+  @param[out]  BufferSize     The size of the received frame.
+  @param[out]  Token          The token to return the buffer with.
+
+  @retval EFI_SUCCESS            A frame was received, and the buffer lent.
+  @retval EFI_NOT_STARTED        The network interface has not been started.
+  @retval EFI_NOT_READY          No frame has been received.
+  @retval EFI_OUT_OF_RESOURCES   Too many buffers are lent already. The frame
+                                 may still be received with
+                                 EFI_SIMPLE_NETWORK_PROTOCOL.Receive().
+  @retval EFI_DEVICE_ERROR       The network interface is not initialized, or
+                                 reported an error.
+  @retval EFI_INVALID_PARAMETER  One of the parameters is NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LOAN_RECEIVE)(
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT VOID                                   **Buffer,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Token
+  );
+
+/**
+  Return a buffer lent by Receive() to the network interface.
+
+  The buffer may be returned after the network interface is shut down, until
+  the protocol is uninstalled.
+
+  @param[in]  This            Pointer to the EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param[in]  Token           The token returned by Receive() with the buffer.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_SIMPLE_NETWORK_RX_LOAN_RETURN)(
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Token
+  );
+
+///
+/// EDKII Simple Network Receive Loan Protocol lends receive buffers of a
+/// network interface to its consumer.
+///
+struct _EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL {
+  EDKII_SIMPLE_NETWORK_RX_LOAN_RECEIVE    Receive;
+  EDKII_SIMPLE_NETWORK_RX_LOAN_RETURN     Return;
+};
+
+extern EFI_GUID  gEdkiiSimpleNetworkRxLoanProtocolGuid;
+
+#endif /* EDKII_SIMPLE_NETWORK_RX_LOAN_H_ */
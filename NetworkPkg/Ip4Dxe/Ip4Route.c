@@ -427,6 +427,9 @@ Ip4FindRouteCache (
   1. IP search the route table for a most specific match
   2. The local route entries have precedence over the default route entry.
 
+  This is only called on a route cache miss, see Ip4RouteTableLookup ().
+  Empty route areas cost one list head check each.
+
   @param[in]  RtTable               The route table to search from
   @param[in]  Dst                   The destination address to search
 
@@ -1604,6 +1604,11 @@ NetbufQueFlush (
 /**
   Compute the checksum for a bulk of data.
 
+  The one's complement sum of 16-bit words equals, once folded, the sum of
+  the 32-bit words they pair into. So the bulk of the data is added four
+  32-bit words at a time into a 64-bit accumulator, which cannot overflow
+  for any UINT32 length.
+
   @param[in]   Bulk                  Pointer to the data.
   @param[in]   Len                   Length of the data, in bytes.
 
@@ -1617,7 +1622,9 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64  Sum;
+  UINT32  *Word;
+  UINT32  Folded;
 
   Sum = 0;
 
@@ -1628,6 +1635,33 @@ NetblockChecksum (
     Sum += *(Bulk + Len - 1);
   }
 
+  //
+  // The 32-bit words must be aligned, and only an even address can be
+  // aligned without shifting the 16-bit words.
+  //
+  if (((UINTN)Bulk & 0x1) == 0) {
+    if ((((UINTN)Bulk & 0x2) != 0) && (Len > 1)) {
+      Sum  += *(UINT16 *)Bulk;
+      Bulk += 2;
+      Len  -= 2;
+    }
+
+    Word = (UINT32 *)Bulk;
+    while (Len >= 16) {
+      Sum  += (UINT64)Word[0] + Word[1] + Word[2] + Word[3];
+      Word += 4;
+      Len  -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Word;
+      Word++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *)Word;
+  }
+
   while (Len > 1) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
@@ -1635,13 +1669,17 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 16 bits
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  Folded = (UINT32)(Sum & 0xffff) +
+           (UINT32)(RShiftU64 (Sum, 16) & 0xffff) +
+           (UINT32)(RShiftU64 (Sum, 32) & 0xffff) +
+           (UINT32)RShiftU64 (Sum, 48);
+  while ((Folded >> 16) != 0) {
+    Folded = (Folded & 0xffff) + (Folded >> 16);
   }
 
-  return (UINT16)Sum;
+  return (UINT16)Folded;
 }
 
 /**
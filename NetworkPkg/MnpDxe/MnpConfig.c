@@ -181,7 +181,12 @@ MnpFreeNbuf (
 
   NET_PUT_REF (Nbuf);
 
-  if (Nbuf->RefCnt == 1) {
+  if ((Nbuf->RefCnt == 1) && (Nbuf->Vector->Free == MnpReturnRxLoan)) {
+    //
+    // The Nbuf wraps a buffer lent by SNP, free it to return the buffer.
+    //
+    NetbufFree (Nbuf);
+  } else if (Nbuf->RefCnt == 1) {
     //
     // Trim all buffer contained in the Nbuf, then append it to the NbufQue.
     //
@@ -457,6 +462,18 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // Receive in the SNP buffers directly if the SNP driver lends them.
+  //
+  Status = gBS->HandleProtocol (
+                  ControllerHandle,
+                  &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+                  (VOID **)&MnpDeviceData->RxLoan
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->RxLoan = NULL;
+  }
+
   //
   // Initialize the lists.
   //
@@ -528,6 +545,22 @@ MnpInitializeDeviceData (
     goto ERROR;
   }
 
+  //
+  // Create the timer bounding the time spent receiving in one system poll.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &MnpDeviceData->PollBudgetTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "MnpInitializeDeviceData: CreateEvent for poll budget timer failed.\n"));
+
+    goto ERROR;
+  }
+
   //
   // Create the timer for packet timeout check.
   //
@@ -581,6 +614,10 @@ ERROR:
       gBS->CloseEvent (MnpDeviceData->PollTimer);
     }
 
+    if (MnpDeviceData->PollBudgetTimer != NULL) {
+      gBS->CloseEvent (MnpDeviceData->PollBudgetTimer);
+    }
+
     if (MnpDeviceData->RxNbufCache != NULL) {
       MnpFreeNbuf (MnpDeviceData, MnpDeviceData->RxNbufCache);
     }
@@ -640,6 +677,7 @@ MnpDestroyDeviceData (
   gBS->CloseEvent (MnpDeviceData->TimeoutCheckTimer);
   gBS->CloseEvent (MnpDeviceData->MediaDetectTimer);
   gBS->CloseEvent (MnpDeviceData->PollTimer);
+  gBS->CloseEvent (MnpDeviceData->PollBudgetTimer);
 
   //
   // Free the Tx buffer pool.
@@ -1263,9 +1301,11 @@ MnpStart (
     // The EnableSystemPoll differs with the current state, disable or enable
     // the system poll.
     //
-    TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    TimerOpType                  = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    MnpDeviceData->PollInterval  = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->PollIdleCount = 0;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
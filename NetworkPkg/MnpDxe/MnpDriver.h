@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/ManagedNetwork.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkRxLoan.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
 
@@ -47,6 +48,10 @@ typedef struct {
   UINTN                          NumberOfVlan;
   CHAR16                         *MacString;
   EFI_SIMPLE_NETWORK_PROTOCOL    *Snp;
+  //
+  // Optional, lends the SNP receive buffers to avoid copying the frames
+  //
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL    *RxLoan;
 
   //
   // List of MNP_SERVICE_DATA
@@ -69,6 +74,13 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The system poll adapts its period to the receive rate, between
+  // MNP_SYS_POLL_MIN_INTERVAL and MNP_SYS_POLL_INTERVAL.
+  //
+  UINT64                         PollInterval;
+  UINT32                         PollIdleCount;
+  EFI_EVENT                      PollBudgetTimer;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -14,6 +14,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_MIN_INTERVAL    (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_SYS_POLL_BUDGET          (2 * TICKS_PER_MS)     // 2 milliseconds
+#define MNP_SYS_POLL_BATCH           64     // Max packets received in one system poll.
+#define MNP_SYS_POLL_IDLE_COUNT      8      // Idle system polls before the poll interval is doubled.
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -87,6 +91,11 @@ typedef struct {
   UINT64                              TimeoutTick;
 } MNP_RXDATA_WRAP;
 
+typedef struct {
+  MNP_DEVICE_DATA    *MnpDeviceData;
+  VOID               *Token;
+} MNP_RX_LOAN;
+
 #define MNP_TX_BUF_WRAP_SIGNATURE  SIGNATURE_32 ('M', 'T', 'B', 'W')
 
 typedef struct {
@@ -414,6 +423,19 @@ MnpRecycleRxData (
   IN VOID       *Context
   );
 
+/**
+  Return a receive buffer lent by SNP, once the last reference to the
+  NET_BUF wrapping it is gone.
+
+  @param[in]  Arg                 Pointer to the MNP_RX_LOAN of the buffer.
+
+**/
+VOID
+EFIAPI
+MnpReturnRxLoan (
+  IN VOID  *Arg
+  );
+
 /**
   Try to receive a packet and deliver it.
 
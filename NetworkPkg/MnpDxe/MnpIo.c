@@ -458,6 +458,29 @@ MnpRecycleRxData (
   FreePool (RxDataWrap);
 }
 
+/**
+  Return a receive buffer lent by SNP, once the last reference to the
+  NET_BUF wrapping it is gone.
+
+  @param[in]  Arg                 Pointer to the MNP_RX_LOAN of the buffer.
+
+**/
+VOID
+EFIAPI
+MnpReturnRxLoan (
+  IN VOID  *Arg
+  )
+{
+  MNP_RX_LOAN                            *Loan;
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *RxLoan;
+
+  Loan   = (MNP_RX_LOAN *)Arg;
+  RxLoan = Loan->MnpDeviceData->RxLoan;
+
+  RxLoan->Return (RxLoan, Loan->Token);
+  FreePool (Loan);
+}
+
 /**
   Queue the received packet into instance's receive queue.
 
@@ -813,6 +836,106 @@ MnpEnqueuePacket (
   }
 }
 
+/**
+  Try to receive a packet in a buffer lent by SNP and deliver it. The
+  packet is delivered in the lent buffer, without copying it.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+  @retval EFI_SUCCESS           A packet is received.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_OUT_OF_RESOURCES  SNP has no more buffers to lend, the packet
+                                should be received with Snp->Receive().
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceiveLoanedPacket (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_STATUS                             Status;
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *RxLoan;
+  NET_FRAGMENT                           Fragment;
+  NET_BUF                                *Nbuf;
+  VOID                                   *Buffer;
+  UINTN                                  BufLen;
+  VOID                                   *Token;
+  MNP_RX_LOAN                            *Loan;
+  MNP_SERVICE_DATA                       *MnpServiceData;
+  UINT16                                 VlanId;
+  BOOLEAN                                Delivered;
+
+  RxLoan = MnpDeviceData->RxLoan;
+
+  Status = RxLoan->Receive (RxLoan, &Buffer, &BufLen, &Token);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (BufLen < MnpDeviceData->Snp->Mode->MediaHeaderSize) {
+    DEBUG ((DEBUG_WARN, "MnpReceiveLoanedPacket: Size error, TL = %d.\n", BufLen));
+    RxLoan->Return (RxLoan, Token);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Loan = AllocatePool (sizeof (MNP_RX_LOAN));
+  if (Loan == NULL) {
+    RxLoan->Return (RxLoan, Token);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Loan->MnpDeviceData = MnpDeviceData;
+  Loan->Token         = Token;
+
+  Fragment.Bulk = Buffer;
+  Fragment.Len  = (UINT32)BufLen;
+
+  Nbuf = NetbufFromExt (&Fragment, 1, 0, 0, MnpReturnRxLoan, Loan);
+  if (Nbuf == NULL) {
+    MnpReturnRxLoan (Loan);
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Hold the Nbuf the same way as the one allocated by MnpAllocNbuf, so that
+  // the receivers release it with MnpFreeNbuf.
+  //
+  NET_GET_REF (Nbuf);
+
+  VlanId = 0;
+  if (MnpDeviceData->NumberOfVlan != 0) {
+    //
+    // VLAN is configured, remove the VLAN tag if any
+    //
+    MnpRemoveVlanTag (MnpDeviceData, Nbuf, &VlanId);
+  }
+
+  Delivered      = FALSE;
+  MnpServiceData = MnpFindServiceData (MnpDeviceData, VlanId);
+  if (MnpServiceData != NULL) {
+    //
+    // Enqueue the packet to the matched instances.
+    //
+    MnpEnqueuePacket (MnpServiceData, Nbuf);
+    Delivered = (BOOLEAN)(Nbuf->RefCnt > 2);
+  }
+
+  //
+  // Drop our reference, the buffer goes back to SNP if there is no receiver.
+  //
+  MnpFreeNbuf (MnpDeviceData, Nbuf);
+
+  if (Delivered) {
+    //
+    // Deliver the queued packets.
+    //
+    MnpDeliverPacket (MnpServiceData);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Try to receive a packet and deliver it.
 
@@ -850,6 +973,17 @@ MnpReceivePacket (
     return EFI_NOT_STARTED;
   }
 
+  if (MnpDeviceData->RxLoan != NULL) {
+    Status = MnpReceiveLoanedPacket (MnpDeviceData);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      return Status;
+    }
+
+    //
+    // All the lent buffers are still in use, fall back to copying.
+    //
+  }
+
   if (MnpDeviceData->RxNbufCache == NULL) {
     //
     // Try to get a new buffer as there may be buffers recycled.
@@ -1087,6 +1221,12 @@ MnpCheckMediaStatus (
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  Up to MNP_SYS_POLL_BATCH packets are received in one poll, as long as
+  MNP_SYS_POLL_BUDGET has not elapsed, so that a burst doesn't overrun the
+  receive ring of the network device between two polls. The poll interval
+  drops to MNP_SYS_POLL_MIN_INTERVAL while packets keep coming, and doubles
+  back up to MNP_SYS_POLL_INTERVAL once the link goes idle.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1099,17 +1239,66 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_STATUS       Status;
+  UINT32           Received;
+  UINT64           PollInterval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
-  //
-  // Try to receive packets from Snp.
-  //
-  MnpReceivePacket (MnpDeviceData);
+  gBS->SetTimer (MnpDeviceData->PollBudgetTimer, TimerRelative, MNP_SYS_POLL_BUDGET);
+
+  for (Received = 0; Received < MNP_SYS_POLL_BATCH; Received++) {
+    //
+    // Try to receive packets from Snp.
+    //
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events,
+    // the upper layer recycles its rx tokens there.
+    //
+    DispatchDpc ();
+
+    if (!EFI_ERROR (gBS->CheckEvent (MnpDeviceData->PollBudgetTimer))) {
+      Received++;
+      break;
+    }
+  }
+
+  gBS->SetTimer (MnpDeviceData->PollBudgetTimer, TimerCancel, 0);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    //
+    // The system poll was cancelled while this notification was pending.
+    //
+    return;
+  }
+
+  //
+  // Adapt the poll interval to the receive rate.
+  //
+  PollInterval = MnpDeviceData->PollInterval;
+  if (Received > 1) {
+    PollInterval                 = MNP_SYS_POLL_MIN_INTERVAL;
+    MnpDeviceData->PollIdleCount = 0;
+  } else if ((Received == 0) && (PollInterval < MNP_SYS_POLL_INTERVAL)) {
+    if (++MnpDeviceData->PollIdleCount >= MNP_SYS_POLL_IDLE_COUNT) {
+      PollInterval                 = MIN (PollInterval * 2, MNP_SYS_POLL_INTERVAL);
+      MnpDeviceData->PollIdleCount = 0;
+    }
+  }
+
+  if (PollInterval != MnpDeviceData->PollInterval) {
+    MnpDeviceData->PollInterval = PollInterval;
+    gBS->SetTimer (Event, TimerPeriodic, PollInterval);
+  }
 }
@@ -126,6 +126,13 @@ struct _MTFTP4_PROTOCOL {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Whether the gap at the next expected block has been acked already:
+  // with a window, all the blocks that follow a lost one arrive out of
+  // order, and each ACK of the gap makes the server resend the window.
+  //
+  BOOLEAN                   GapAcked;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
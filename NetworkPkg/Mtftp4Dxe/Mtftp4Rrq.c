@@ -263,7 +263,17 @@ Mtftp4RrqHandleData (
   // the ACK for the block we received, then restart receiving the
   // expected one. If we are passive (Slave), save the block.
   //
+  // The gap is acked only once (RFC7440): the rest of the window is out of
+  // order too, and the server resends the window for each ACK. If the
+  // resent window is lost as well, the timeout retransmits the ACK.
+  //
   if (Instance->Master && (Expected != BlockNum)) {
+    if (Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -276,6 +286,8 @@ Mtftp4RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
@@ -86,6 +86,13 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Whether the gap at the next expected block has been acked already:
+  // with a window, all the blocks that follow a lost one arrive out of
+  // order, and each ACK of the gap makes the server resend the window.
+  //
+  BOOLEAN                   GapAcked;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
@@ -241,6 +241,17 @@ Mtftp6RrqHandleData (
     NetbufFree (*UdpPacket);
     *UdpPacket = NULL;
 
+    //
+    // The gap is acked only once (RFC7440): the rest of the window is out
+    // of order too, and the server resends the window for each ACK. If the
+    // resent window is lost as well, the timeout retransmits the ACK.
+    //
+    if (Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -253,6 +264,8 @@ Mtftp6RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
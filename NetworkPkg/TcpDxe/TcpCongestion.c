@@ -0,0 +1,322 @@
+/** @file
+  TCP congestion control algorithms.
+
+  The loss detection and recovery (fast retransmission, NewReno or SACK
+  based fast recovery and the retransmission timeout) are common to all
+  connections. The algorithm only decides how the congestion window opens
+  on new ACKs and how far the slow start threshold drops after a loss.
+
+  NewReno follows RFC5681. CUBIC follows RFC8312 and trades the linear
+  growth in congestion avoidance for a cubic function of the time since
+  the last reduction, which refills long fat pipes in a few RTTs instead
+  of hundreds. All the CUBIC math is done with integers, time in ms and
+  windows in segments.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+#define TCP_CC_NEWRENO  0
+#define TCP_CC_CUBIC    1
+
+//
+// CUBIC constants. C is 0.4 segment/s^3 and beta is 0.7.
+//
+#define TCP_CUBIC_BETA_NUM  7
+#define TCP_CUBIC_BETA_DEN  10
+
+//
+// K = cubic_root (W_max * (1 - beta) / C), in ms: multiply
+// the window reduction in segments by 10^9 / C.
+//
+#define TCP_CUBIC_K_SCALE  2500000000U
+
+//
+// C * t^3 in segments with t in ms: 4 * t^3 / 10^10.
+//
+#define TCP_CUBIC_C_NUM  4
+#define TCP_CUBIC_C_DEN  10000000000ULL
+
+//
+// Cap of the time offset used in the cubic function, in ms. It
+// keeps C * t^3 within UINT64.
+//
+#define TCP_CUBIC_MAX_TIME  100000
+
+/**
+  Initialize the NewReno state. NewReno doesn't keep any.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpNewRenoInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+}
+
+/**
+  Open the congestion window per RFC5681: one SMSS per ACK in slow
+  start, and about one SMSS per RTT in congestion avoidance.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpNewRenoOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Compute the slow start threshold per RFC5681: half of the data
+  in flight, but at least two segments.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return          The new slow start threshold.
+
+**/
+UINT32
+TcpNewRenoSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  Compute the integer cube root.
+
+  @param[in]  Value    The value to compute the cube root of, less than 2^63.
+
+  @return     The largest integer whose cube isn't above Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT32  Root;
+  UINT32  Try;
+  INTN    Bit;
+
+  Root = 0;
+
+  for (Bit = 20; Bit >= 0; Bit--) {
+    Try = Root | (1U << Bit);
+
+    if (MultU64x32 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Initialize the CUBIC state.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->CubicWMax   = 0;
+  Tcb->CubicOrigin = 0;
+  Tcb->CubicK      = 0;
+  Tcb->CubicEpoch  = 0;
+  Tcb->CubicWEst   = 0;
+}
+
+/**
+  Open the congestion window per RFC8312. Slow start is the same
+  as NewReno. In congestion avoidance the window goes after the
+  cubic function W(t) = C * (t - K)^3 + W_max, or the window that
+  standard TCP would have reached, whichever is larger.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCubicOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  UINT32  CWndSeg;
+  UINT32  Time;
+  UINT32  Offset;
+  UINT64  Delta;
+  UINT64  Target;
+  UINT32  Inc;
+
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+    return;
+  }
+
+  CWndSeg = Tcb->CWnd / Tcb->SndMss;
+
+  //
+  // A new congestion avoidance epoch begins.
+  //
+  if (Tcb->CubicEpoch == 0) {
+    Tcb->CubicEpoch = MAX (mTcpTick, 1);
+    Tcb->CubicWEst  = Tcb->CWnd;
+
+    if (CWndSeg < Tcb->CubicWMax) {
+      Tcb->CubicK      = TcpCubicRoot (MultU64x32 (Tcb->CubicWMax - CWndSeg, TCP_CUBIC_K_SCALE));
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = CWndSeg;
+    }
+  }
+
+  //
+  // The target is where the window should be in one RTT.
+  //
+  Time = (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT)) * TCP_TICK;
+
+  if (Time < Tcb->CubicK) {
+    Offset = Tcb->CubicK - Time;
+  } else {
+    Offset = Time - Tcb->CubicK;
+  }
+
+  Offset = MIN (Offset, TCP_CUBIC_MAX_TIME);
+  Delta  = DivU64x64Remainder (
+             MultU64x32 (MultU64x32 (MultU64x32 (Offset, Offset), Offset), TCP_CUBIC_C_NUM),
+             TCP_CUBIC_C_DEN,
+             NULL
+             );
+
+  if (Time < Tcb->CubicK) {
+    Target = (Delta < Tcb->CubicOrigin) ? (Tcb->CubicOrigin - Delta) : 0;
+  } else {
+    Target = Tcb->CubicOrigin + Delta;
+  }
+
+  Target = MultU64x32 (Target, Tcb->SndMss);
+
+  //
+  // TCP friendly region: the window of standard TCP grows by
+  // 3 * (1 - beta) / (1 + beta) = 9 / 17 segment per RTT.
+  //
+  Tcb->CubicWEst += (UINT32)DivU64x64Remainder (
+                              MultU64x32 (MultU64x32 (Acked, Tcb->SndMss), 9),
+                              MultU64x32 (Tcb->CWnd, 17),
+                              NULL
+                              );
+
+  if (Target < Tcb->CubicWEst) {
+    Target = Tcb->CubicWEst;
+  }
+
+  if (Target > Tcb->CWnd) {
+    //
+    // Grow by (Target - CWnd) / CWnd segment per segment acked,
+    // but never faster than half a segment per segment acked.
+    //
+    Inc = (UINT32)MIN (
+                    DivU64x64Remainder (MultU64x32 (Target - Tcb->CWnd, Acked), Tcb->CWnd, NULL),
+                    MAX (Acked >> 1, 1)
+                    );
+    Inc = MAX (Inc, 1);
+  } else {
+    Inc = (UINT32)DivU64x64Remainder (MultU64x32 (Acked, Tcb->SndMss), MultU64x32 (Tcb->CWnd, 100), NULL);
+  }
+
+  Tcb->CWnd += Inc;
+}
+
+/**
+  Compute the slow start threshold per RFC8312: reduce the window
+  by beta, and remember the window size before the reduction as
+  the plateau of the cubic function. With the fast convergence,
+  a flow that loses earlier than last time releases bandwidth by
+  lowering the plateau further.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return          The new slow start threshold.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  CWndSeg;
+
+  CWndSeg = Tcb->CWnd / Tcb->SndMss;
+
+  if (CWndSeg < Tcb->CubicWMax) {
+    Tcb->CubicWMax = CWndSeg * (TCP_CUBIC_BETA_DEN + TCP_CUBIC_BETA_NUM) / (2 * TCP_CUBIC_BETA_DEN);
+  } else {
+    Tcb->CubicWMax = CWndSeg;
+  }
+
+  Tcb->CubicEpoch = 0;
+
+  return MAX (
+           (UINT32)DivU64x32 (MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN),
+           (UINT32)(2 * Tcb->SndMss)
+           );
+}
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST TCP_CONGESTION_OPS  mTcpNewReno = {
+  "NewReno",
+  TcpNewRenoInit,
+  TcpNewRenoOnAck,
+  TcpNewRenoSsthresh
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST TCP_CONGESTION_OPS  mTcpCubic = {
+  "CUBIC",
+  TcpCubicInit,
+  TcpCubicOnAck,
+  TcpCubicSsthresh
+};
+
+/**
+  Select the congestion control algorithm configured by
+  PcdTcpCongestionControl and initialize its state.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpInitCongestionControl (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CC_CUBIC) {
+    Tcb->CongestOps = &mTcpCubic;
+  } else {
+    Tcb->CongestOps = &mTcpNewReno;
+  }
+
+  Tcb->CongestOps->Init (Tcb);
+}
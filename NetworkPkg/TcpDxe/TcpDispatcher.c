@@ -118,7 +118,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -195,7 +195,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -551,6 +551,7 @@ TcpConfigurePcb (
     );
 
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_KEEPALIVE);
+  TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
   Tcb->State = TCP_CLOSED;
 
   Tcb->SndMss = 536;
@@ -610,7 +611,7 @@ TcpConfigurePcb (
       Sk,
       (UINT32)(TCP_COMP_VAL (
                  TCP_RCV_BUF_SIZE_MIN,
-                 TCP_RCV_BUF_SIZE,
+                 MAX (TCP_RCV_BUF_SIZE, PcdGet32 (PcdTcpMaxReceiveBufferSize)),
                  TCP_RCV_BUF_SIZE,
                  Option->ReceiveBufferSize
                  )
@@ -703,6 +704,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (Option->EnableSelectiveAck) {
+      TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
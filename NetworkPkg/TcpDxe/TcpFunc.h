@@ -498,6 +498,35 @@ TcpInput (
   IN UINT8           Version
   );
 
+/**
+  Forget the SACK scoreboard. The peer may renege the SACKed data,
+  so the scoreboard is dropped when the retransmission timer expires,
+  per RFC2018 section 8.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  );
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Select the congestion control algorithm configured by
+  PcdTcpCongestionControl and initialize its state.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpInitCongestionControl (
+  IN OUT TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -29,6 +29,119 @@ TcpSeqAcceptable (
           TCP_SEQ_LT (Seg->Seq, Tcb->RcvWl2 + Tcb->RcvWnd));
 }
 
+/**
+  Mark the segments in the retransmission queue that the peer
+  reported in the SACK option of the incoming segment.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      Pointer to the incoming segment.
+  @param[in]       Option   Pointer to the options parsed from the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEG     *Seg,
+  IN     TCP_OPTION  *Option
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Node;
+  UINT8       Index;
+
+  if (TCP_SEQ_LT (Tcb->SackHigh, Seg->Ack)) {
+    Tcb->SackHigh = Seg->Ack;
+  }
+
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    //
+    // Ignore the blocks below the cumulative ACK (D-SACK), and
+    // the bogus ones beyond what we have sent.
+    //
+    if (TCP_SEQ_LEQ (Option->SackLeft[Index], Seg->Ack) ||
+        TCP_SEQ_LEQ (Option->SackRight[Index], Option->SackLeft[Index]) ||
+        TCP_SEQ_GT (Option->SackRight[Index], Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+      Node = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      if (TCP_SEQ_GEQ (Node->Seq, Option->SackRight[Index])) {
+        break;
+      }
+
+      if (TCP_SEQ_LEQ (Option->SackLeft[Index], Node->Seq) &&
+          TCP_SEQ_LEQ (Node->End, Option->SackRight[Index]))
+      {
+        Node->Sacked = TRUE;
+      }
+    }
+
+    if (TCP_SEQ_GT (Option->SackRight[Index], Tcb->SackHigh)) {
+      Tcb->SackHigh = Option->SackRight[Index];
+    }
+  }
+}
+
+/**
+  Retransmit the first hole in the SACK scoreboard that hasn't been
+  retransmitted in this recovery, per the NextSeg () rule 1 of RFC6675.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackRetransmit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Node;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Node->Seq, Tcb->SackHigh)) {
+      break;
+    }
+
+    if (Node->Sacked || TCP_SEQ_LT (Node->Seq, Tcb->SackRetxNext) ||
+        TCP_SEQ_LT (Node->Seq, Tcb->SndUna))
+    {
+      continue;
+    }
+
+    Tcb->SackRetxNext = Node->End;
+    TcpRetransmit (Tcb, Node->Seq);
+    return;
+  }
+}
+
+/**
+  Forget the SACK scoreboard. The peer may renege the SACKed data,
+  so the scoreboard is dropped when the retransmission timer expires,
+  per RFC2018 section 8.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Sacked = FALSE;
+  }
+
+  Tcb->SackHigh     = Tcb->SndUna;
+  Tcb->SackRetxNext = Tcb->SndUna;
+}
+
 /**
   NewReno fast recovery defined in RFC3782.
 
@@ -52,9 +165,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -64,7 +175,8 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd         = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackRetxNext = Tcb->SndUna + 1;
 
     DEBUG (
       (DEBUG_NET,
@@ -88,6 +200,15 @@ TcpFastRecover (
     // by TcpToSendData
     //
     Tcb->CWnd += Tcb->SndMss;
+
+    //
+    // With SACK, every duplicated ACK also repairs the next hole
+    // instead of waiting one RTT per loss for a partial ACK.
+    //
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+      TcpSackRetransmit (Tcb);
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +240,18 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. If the hole at SEG.ACK has been
+      // retransmitted already on a SACK, go on with the next one.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+          TCP_SEQ_LT (Seg->Ack, Tcb->SackRetxNext))
+      {
+        TcpSackRetransmit (Tcb);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+        Tcb->SackRetxNext = Seg->Ack + 1;
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -336,6 +466,65 @@ TcpTrimSegment (
   return TcpVerifySegment (Nbuf);
 }
 
+/**
+  Grow the receive buffer to follow the rate the application consumes data at.
+
+  Once per round trip, the bytes the application took off the socket are
+  compared against the receive buffer. If it took more than half of it, the
+  buffer is too small to keep the pipe full while the sender ramps up, and is
+  grown to twice that amount, up to PcdTcpMaxReceiveBufferSize. The buffer is
+  never shrunk. The round trip is no shorter than one TCP tick here.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpTuneRcvBuffer (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  MaxSize;
+  UINT32  BufSize;
+  UINT32  Queued;
+  UINT32  Consumed;
+
+  MaxSize = PcdGet32 (PcdTcpMaxReceiveBufferSize);
+  BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
+
+  //
+  // Without window scaling, the peer can't be offered more than 64KB anyway.
+  //
+  if ((BufSize >= MaxSize) || !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_WS)) {
+    return;
+  }
+
+  if (TCP_SUB_TIME (mTcpTick, Tcb->RcvSpaceTime) < MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1)) {
+    return;
+  }
+
+  Queued   = (UINT32)GET_RCV_DATASIZE (Tcb->Sk);
+  Consumed = 0;
+  if (Tcb->RcvSpaceDelivered + Tcb->RcvSpaceQueued > Queued) {
+    Consumed = Tcb->RcvSpaceDelivered + Tcb->RcvSpaceQueued - Queued;
+  }
+
+  if (Consumed > BufSize / 2) {
+    BufSize = (UINT32)MIN ((UINT64)Consumed * 2, MaxSize);
+    SET_RCV_BUFFSIZE (Tcb->Sk, BufSize);
+
+    DEBUG (
+      (DEBUG_NET,
+       "TcpTuneRcvBuffer: receive buffer of TCB %p grown to %d bytes\n",
+       Tcb,
+       BufSize)
+      );
+  }
+
+  Tcb->RcvSpaceTime      = mTcpTick;
+  Tcb->RcvSpaceDelivered = 0;
+  Tcb->RcvSpaceQueued    = Queued;
+}
+
 /**
   Trim off the data outside the tcb's receive window.
 
@@ -521,6 +710,7 @@ TcpDeliverData (
         }
       }
 
+      Tcb->RcvSpaceDelivered += Nbuf->TotalSize;
       SockDataRcvd (Tcb->Sk, Nbuf, Urgent);
     }
 
@@ -531,6 +721,7 @@ TcpDeliverData (
     NetbufFree (Nbuf);
   }
 
+  TcpTuneRcvBuffer (Tcb);
   return 0;
 }
 
@@ -607,6 +798,7 @@ TcpQueueData (
   InsertHeadList (Prev, &Nbuf->List);
 
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_ACK_NOW);
+  Tcb->RcvSackSeq = Seg->Seq;
 
   //
   // Check the segments after the insert point.
@@ -1202,6 +1394,15 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard before the loss recovery uses it.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK))
+  {
+    TcpSackUpdate (Tcb, Seg, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1222,11 +1423,7 @@ TcpInput (
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
+      Tcb->CongestOps->OnAck (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
     }
@@ -75,6 +75,12 @@ TcpInitTcbLocal (
 
   Tcb->RcvWnd = GET_RCV_BUFFSIZE (Tcb->Sk);
 
+  Tcb->RcvSpaceTime = mTcpTick;
+
+  Tcb->SackHigh     = Tcb->Iss;
+  Tcb->SackRetxNext = Tcb->Iss;
+  TcpInitCongestionControl (Tcb);
+
   //
   // First window size is never scaled
   //
@@ -147,6 +153,10 @@ TcpInitTcbPeer (
     Tcb->RcvWndScale = 0;
   }
 
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
   if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_TS) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS)) {
     TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_TS);
     TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_TS);
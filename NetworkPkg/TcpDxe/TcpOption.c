@@ -82,7 +82,10 @@ TcpComputeScale (
 
   ASSERT ((Tcb != NULL) && (Tcb->Sk != NULL));
 
-  BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
+  //
+  // Leave room for the receive buffer to be auto-tuned up to its maximum.
+  //
+  BufSize = MAX (GET_RCV_BUFFSIZE (Tcb->Sk), PcdGet32 (PcdTcpMaxReceiveBufferSize));
 
   Scale = 0;
   while ((Scale < TCP_OPTION_MAX_WS) && ((UINT32)(TCP_OPTION_MAX_WIN << Scale) < BufSize)) {
@@ -160,6 +163,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when configured
+  // to use SACK, and either we are doing active open
+  // or we have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +197,130 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Get the next contiguous range of out-of-order data in the
+  receive queue, beyond RcvNxt.
+
+  @param[in]       Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in, out]  Entry   On input, the entry in RcvQue to start from. On
+                           output, the entry following the returned range.
+  @param[out]      Left    The first sequence number of the range.
+  @param[out]      Right   The sequence number following the range.
+
+  @retval          TRUE    A range is returned.
+  @retval          FALSE   There are no more ranges in the receive queue.
+
+**/
+BOOLEAN
+TcpGetRcvRange (
+  IN     TCP_CB      *Tcb,
+  IN OUT LIST_ENTRY  **Entry,
+  OUT    TCP_SEQNO   *Left,
+  OUT    TCP_SEQNO   *Right
+  )
+{
+  TCP_SEG  *Seg;
+  BOOLEAN  Found;
+
+  Found = FALSE;
+
+  while (*Entry != &Tcb->RcvQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (*Entry, NET_BUF, List));
+
+    if (TCP_SEQ_LEQ (Seg->End, Tcb->RcvNxt)) {
+      *Entry = (*Entry)->ForwardLink;
+      continue;
+    }
+
+    if (!Found) {
+      *Left  = Seg->Seq;
+      *Right = Seg->End;
+      Found  = TRUE;
+    } else if (TCP_SEQ_LEQ (Seg->Seq, *Right)) {
+      if (TCP_SEQ_GT (Seg->End, *Right)) {
+        *Right = Seg->End;
+      }
+    } else {
+      break;
+    }
+
+    *Entry = (*Entry)->ForwardLink;
+  }
+
+  return Found;
+}
+
+/**
+  Build the SACK option from the out-of-order data in the receive
+  queue. The block that contains the most recently received segment
+  is reported first, per RFC2018 section 4.
+
+  @param[in]  Tcb        Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Nbuf       Pointer to the buffer to store the option.
+  @param[in]  MaxBlocks  The maximum number of blocks that fit in the
+                         remaining option space.
+
+  @return                The length of the SACK option, aligned.
+
+**/
+UINT16
+TcpBuildSackOption (
+  IN TCP_CB   *Tcb,
+  IN NET_BUF  *Nbuf,
+  IN UINT8    MaxBlocks
+  )
+{
+  TCP_SEQNO   Left[TCP_OPTION_MAX_SACK_BLOCK];
+  TCP_SEQNO   Right[TCP_OPTION_MAX_SACK_BLOCK];
+  LIST_ENTRY  *Entry;
+  UINT8       *Data;
+  UINT8       Count;
+  UINT8       Index;
+  UINT16      Len;
+
+  Count = 0;
+  MaxBlocks = MIN (MaxBlocks, TCP_OPTION_MAX_SACK_BLOCK);
+
+  //
+  // Find the block holding the latest segment first.
+  //
+  Entry = Tcb->RcvQue.ForwardLink;
+  while (TcpGetRcvRange (Tcb, &Entry, &Left[0], &Right[0])) {
+    if (TCP_SEQ_BETWEEN (Left[0], Tcb->RcvSackSeq, Right[0]) &&
+        TCP_SEQ_LT (Tcb->RcvSackSeq, Right[0]))
+    {
+      Count = 1;
+      break;
+    }
+  }
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while ((Count < MaxBlocks) && TcpGetRcvRange (Tcb, &Entry, &Left[Count], &Right[Count])) {
+    if ((Count > 0) && (Left[Count] == Left[0])) {
+      continue;
+    }
+
+    Count++;
+  }
+
+  if (Count == 0) {
+    return 0;
+  }
+
+  Len  = (UINT16)(TCP_OPTION_SACK_HEAD_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN);
+  Data = NetbufAllocSpace (Nbuf, Len + 2, NET_BUF_HEAD);
+  ASSERT (Data != NULL);
+
+  TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | Len);
+
+  for (Index = 0; Index < Count; Index++) {
+    TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Left[Index]);
+    TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Right[Index]);
+  }
+
+  return (UINT16)(Len + 2);
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -214,6 +363,24 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Report the out-of-order data with the SACK option if
+  // the peer permitted it. Only pure ACKs carry it, the
+  // data segments are already sized to SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (Nbuf->TotalSize == 0) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    Len = (UINT16)(Len + TcpBuildSackOption (
+                           Tcb,
+                           Nbuf,
+                           (UINT8)((TCP_OPTION_MAX_LEN - Len - 4) / TCP_OPTION_SACK_BLOCK_LEN)
+                           ));
+  }
+
   return Len;
 }
 
@@ -239,10 +406,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +480,43 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < TCP_OPTION_SACK_HEAD_LEN + TCP_OPTION_SACK_BLOCK_LEN) ||
+            (((Len - TCP_OPTION_SACK_HEAD_LEN) % TCP_OPTION_SACK_BLOCK_LEN) != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackNum = (UINT8)MIN (
+                                   (Len - TCP_OPTION_SACK_HEAD_LEN) / TCP_OPTION_SACK_BLOCK_LEN,
+                                   TCP_OPTION_MAX_SACK_BLOCK
+                                   );
+
+        for (Index = 0; Index < Option->SackNum; Index++) {
+          Option->SackLeft[Index]  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->SackRight[Index] = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
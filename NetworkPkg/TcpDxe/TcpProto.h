@@ -70,6 +70,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -208,12 +210,13 @@
 /// TCP segmentation data.
 ///
 typedef struct _TCP_SEG {
-  TCP_SEQNO    Seq;  ///< Starting sequence number.
-  TCP_SEQNO    End;  ///< The sequence of the last byte + 1, include SYN/FIN. End-Seq = SEG.LEN.
-  TCP_SEQNO    Ack;  ///< ACK field in the segment.
-  UINT8        Flag; ///< TCP header flags.
-  UINT16       Urg;  ///< Valid if URG flag is set.
-  UINT32       Wnd;  ///< TCP window size field.
+  TCP_SEQNO    Seq;    ///< Starting sequence number.
+  TCP_SEQNO    End;    ///< The sequence of the last byte + 1, include SYN/FIN. End-Seq = SEG.LEN.
+  TCP_SEQNO    Ack;    ///< ACK field in the segment.
+  UINT8        Flag;   ///< TCP header flags.
+  UINT16       Urg;    ///< Valid if URG flag is set.
+  UINT32       Wnd;    ///< TCP window size field.
+  BOOLEAN      Sacked; ///< Valid in SndQue, TRUE if the peer has SACKed it.
 } TCP_SEG;
 
 ///
@@ -226,6 +229,59 @@ typedef struct _TCP_PEER {
 
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
+/**
+  Initialize the congestion control state of a connection.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_INIT)(
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Open the congestion window when new data is acknowledged
+  outside of the loss recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_ON_ACK)(
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+/**
+  Compute the slow start threshold after a loss is detected.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return          The new slow start threshold.
+
+**/
+typedef
+UINT32
+(*TCP_CONGEST_SSTHRESH)(
+  IN OUT TCP_CB  *Tcb
+  );
+
+///
+/// Congestion control algorithm. The loss recovery itself is
+/// common, the algorithm decides how the window grows and how
+/// much it is reduced.
+///
+typedef struct {
+  CHAR8                   *Name;
+  TCP_CONGEST_INIT        Init;
+  TCP_CONGEST_ON_ACK      OnAck;
+  TCP_CONGEST_SSTHRESH    Ssthresh;
+} TCP_CONGESTION_OPS;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -294,6 +350,13 @@ struct _TCP_CONTROL_BLOCK {
   UINT32              RttVar;     ///< RTT variance, scaled by 8.
   UINT32              Rto;        ///< Current RTO, not scaled.
 
+  //
+  // Receive buffer auto-tuning.
+  //
+  UINT32              RcvSpaceTime;      ///< When the current measurement started.
+  UINT32              RcvSpaceDelivered; ///< Bytes delivered to the socket since then.
+  UINT32              RcvSpaceQueued;    ///< Bytes queued in the socket back then.
+
   //
   // RFC2581, and 3782 variables.
   // Congestion control + NewReno fast recovery.
@@ -306,6 +369,25 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  CONST TCP_CONGESTION_OPS    *CongestOps; ///< Congestion control algorithm.
+
+  //
+  // CUBIC congestion control (RFC8312) state.
+  //
+  UINT32              CubicWMax;   ///< Window before the last reduction, in segments.
+  UINT32              CubicOrigin; ///< Window at the plateau of the cubic function, in segments.
+  UINT32              CubicK;      ///< Time to get back to CubicOrigin, in ms.
+  UINT32              CubicEpoch;  ///< When the current avoidance epoch started, 0 if none.
+  UINT32              CubicWEst;   ///< Estimated window of standard TCP, in bytes.
+
+  //
+  // RFC2018 and RFC6675 variables.
+  // Selective acknowledgment and SACK based loss recovery.
+  //
+  TCP_SEQNO           RcvSackSeq;   ///< Seq of the latest segment queued out of order.
+  TCP_SEQNO           SackHigh;     ///< Highest data SACKed by the peer, plus 1.
+  TCP_SEQNO           SackRetxNext; ///< Holes below it are retransmitted in this recovery.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -180,8 +180,6 @@ TcpRexmitTimeout (
   IN OUT TCP_CB  *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG (
     (DEBUG_WARN,
      "TcpRexmitTimeout: transmission timeout for TCB %p\n",
@@ -189,12 +187,10 @@ TcpRexmitTimeout (
     );
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window, the congestion control
+  // algorithm decides the new slow start threshold.
   //
-  FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
@@ -216,6 +212,7 @@ TcpRexmitTimeout (
   }
 
   TcpBackoffRto (Tcb);
+  TcpSackClear (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
 
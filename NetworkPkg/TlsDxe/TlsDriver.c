@@ -258,7 +258,8 @@ TlsDriverEntryPoint (
 
   //
   // Create a new SSL_CTX object as framework to establish TLS/SSL enabled
-  // connections. TLS 1.0 is used as the default version.
+  // connections. TLS 1.0 is used as the default version. The object also
+  // caches the sessions that the TLS children of the service resume.
   //
   TlsService->TlsCtx = TlsCtxNew (TLS10_PROTOCOL_VERSION_MAJOR, TLS10_PROTOCOL_VERSION_MINOR);
   if (TlsService->TlsCtx == NULL) {
@@ -2377,7 +2377,10 @@ EfiPxeLoadFile (
   Status     = EFI_DEVICE_ERROR;
 
   //
-  // Check media status before PXE start
+  // Check media status before PXE start, so that the boot manager moves on
+  // to the next NIC without a DHCP timeout when this one has no link. The
+  // DHCP discovery itself runs on this NIC only: it needs the NIC's single
+  // configurable DHCP4 child and owns its IP stack until PXE boot is done.
   //
   MediaStatus = EFI_SUCCESS;
   NetLibDetectMediaWaitTimeout (Private->Controller, PXEBC_CHECK_MEDIA_WAITING_TIME, &MediaStatus);
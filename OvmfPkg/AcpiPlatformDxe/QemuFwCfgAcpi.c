@@ -19,6 +19,7 @@
 #include <Library/QemuFwCfgS3Lib.h>           // QemuFwCfgS3Enabled()
 #include <Library/UefiBootServicesTableLib.h> // gBS
 
+#include <Protocol/AcpiTableBatch.h>
 #include <Protocol/QemuAcpiTableNotify.h>
 #include "AcpiPlatform.h"
 EFI_HANDLE                       mQemuAcpiHandle = NULL;
@@ -823,7 +824,7 @@ UndoCmdWritePointer (
 
 /**
   Process a QEMU_LOADER_ADD_POINTER command in order to see if its target byte
-  array is an ACPI table, and if so, install it.
+  array is an ACPI table, and if so, collect it for installation.
 
   This function assumes that the entire QEMU linker/loader command file has
   been processed successfully in a prior first pass.
@@ -833,22 +834,20 @@ UndoCmdWritePointer (
   @param[in] Tracker           The ORDERED_COLLECTION tracking the BLOB user
                                structures.
 
-  @param[in] AcpiProtocol      The ACPI table protocol used to install tables.
-
-  @param[in,out] InstalledKey  On input, an array of INSTALLED_TABLES_MAX UINTN
-                               elements, allocated by the caller. On output,
-                               the function will have stored (appended) the
-                               AcpiProtocol-internal key of the ACPI table that
-                               the function has installed, if the AddPointer
-                               command identified an ACPI table that is
-                               different from RSDT and XSDT.
-
-  @param[in,out] NumInstalled  On input, the number of entries already used in
-                               InstalledKey; it must be in [0,
-                               INSTALLED_TABLES_MAX] inclusive. On output, the
-                               parameter is incremented if the AddPointer
-                               command identified an ACPI table that is
-                               different from RSDT and XSDT.
+  @param[in,out] Tables        On input, an array of INSTALLED_TABLES_MAX
+                               EDKII_ACPI_TABLE_BATCH_ENTRY elements, allocated
+                               by the caller. On output, the function will
+                               have stored (appended) the address and size of
+                               the ACPI table, if the AddPointer command
+                               identified an ACPI table that is different from
+                               RSDT and XSDT.
+
+  @param[in,out] NumTables     On input, the number of entries already used in
+                               Tables; it must be in [0, INSTALLED_TABLES_MAX]
+                               inclusive. On output, the parameter is
+                               incremented if the AddPointer command identified
+                               an ACPI table that is different from RSDT and
+                               XSDT.
 
   @param[in,out] SeenPointers  The ORDERED_COLLECTION tracking the absolute
                                target addresses that have been pointed-to by
@@ -856,29 +855,29 @@ UndoCmdWritePointer (
                                target address is encountered for the first
                                time, and it identifies an ACPI table that is
                                different from RDST and XSDT, the table is
-                               installed. If a target address is seen for the
+                               collected. If a target address is seen for the
                                second or later times, it is skipped without
                                taking any action.
 
-  @retval EFI_INVALID_PARAMETER  NumInstalled was outside the allowed range on
+  @retval EFI_INVALID_PARAMETER  NumTables was outside the allowed range on
                                  input.
 
   @retval EFI_OUT_OF_RESOURCES   The AddPointer command identified an ACPI
                                  table different from RSDT and XSDT, but there
-                                 was no more room in InstalledKey.
+                                 was no more room in Tables.
 
   @retval EFI_SUCCESS            AddPointer has been processed. Either its
                                  absolute target address has been encountered
                                  before, or an ACPI table different from RSDT
-                                 and XSDT has been installed (reflected by
-                                 InstalledKey and NumInstalled), or RSDT or
-                                 XSDT has been identified but not installed, or
-                                 the fw_cfg blob pointed-into by AddPointer has
+                                 and XSDT has been collected (reflected by
+                                 Tables and NumTables), or RSDT or XSDT has
+                                 been identified but not collected, or the
+                                 fw_cfg blob pointed-into by AddPointer has
                                  been marked as hosting something else than
                                  just direct ACPI table contents.
 
   @return                        Error codes returned by
-                                 AcpiProtocol->InstallAcpiTable().
+                                 OrderedCollectionInsert().
 **/
 STATIC
 EFI_STATUS
@@ -886,9 +885,8 @@ EFIAPI
 Process2ndPassCmdAddPointer (
   IN     CONST QEMU_LOADER_ADD_POINTER  *AddPointer,
   IN     CONST ORDERED_COLLECTION       *Tracker,
-  IN     EFI_ACPI_TABLE_PROTOCOL        *AcpiProtocol,
-  IN OUT UINTN                          InstalledKey[INSTALLED_TABLES_MAX],
-  IN OUT INT32                          *NumInstalled,
+  IN OUT EDKII_ACPI_TABLE_BATCH_ENTRY   Tables[INSTALLED_TABLES_MAX],
+  IN OUT INT32                          *NumTables,
   IN OUT ORDERED_COLLECTION             *SeenPointers
   )
 {
@@ -905,7 +903,7 @@ Process2ndPassCmdAddPointer (
   CONST EFI_ACPI_DESCRIPTION_HEADER                   *Header;
   EFI_STATUS                                          Status;
 
-  if ((*NumInstalled < 0) || (*NumInstalled > INSTALLED_TABLES_MAX)) {
+  if ((*NumTables < 0) || (*NumTables > INSTALLED_TABLES_MAX)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -1024,39 +1022,121 @@ Process2ndPassCmdAddPointer (
     return EFI_SUCCESS;
   }
 
-  if (*NumInstalled == INSTALLED_TABLES_MAX) {
+  if (*NumTables == INSTALLED_TABLES_MAX) {
     DEBUG ((
       DEBUG_ERROR,
       "%a: can't install more than %d tables\n",
       __FUNCTION__,
       INSTALLED_TABLES_MAX
       ));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto RollbackSeenPointer;
+    OrderedCollectionDelete (SeenPointers, SeenPointerEntry, NULL);
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  Status = AcpiProtocol->InstallAcpiTable (
-                           AcpiProtocol,
-                           (VOID *)(UINTN)PointerValue,
-                           TableSize,
-                           &InstalledKey[*NumInstalled]
-                           );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: InstallAcpiTable(): %r\n",
-      __FUNCTION__,
-      Status
-      ));
-    goto RollbackSeenPointer;
+  Tables[*NumTables].AcpiTableBuffer     = (VOID *)(UINTN)PointerValue;
+  Tables[*NumTables].AcpiTableBufferSize = TableSize;
+  ++*NumTables;
+  return EFI_SUCCESS;
+}
+
+/**
+  Install the ACPI tables collected by Process2ndPassCmdAddPointer().
+
+  If the ACPI table driver produces EDKII_ACPI_TABLE_BATCH_PROTOCOL, the tables
+  are installed with a single request, so that the RSDT/XSDT are updated,
+  checksummed and published only once. Otherwise they are installed one by
+  one, stopping at the first failure.
+
+  @param[in] AcpiProtocol      The ACPI table protocol used to install tables.
+
+  @param[in,out] Tables        The NumTables tables to install. On output, the
+                               TableKey and Status fields of the entries are
+                               updated.
+
+  @param[in] NumTables         The number of entries in Tables.
+
+  @param[out] InstalledKey     An array of at least NumTables UINTN elements,
+                               allocated by the caller. On output, the
+                               AcpiProtocol-internal keys of the tables that
+                               have been installed, even in case of failure.
+
+  @param[out] NumInstalled     The number of keys stored in InstalledKey.
+
+  @retval EFI_SUCCESS  All the tables have been installed.
+
+  @return              Error codes returned by
+                       AcpiProtocol->InstallAcpiTable() or
+                       EDKII_ACPI_TABLE_BATCH_PROTOCOL.InstallAcpiTables().
+**/
+STATIC
+EFI_STATUS
+InstallCollectedTables (
+  IN     EFI_ACPI_TABLE_PROTOCOL       *AcpiProtocol,
+  IN OUT EDKII_ACPI_TABLE_BATCH_ENTRY  *Tables,
+  IN     INT32                         NumTables,
+  OUT    UINTN                         *InstalledKey,
+  OUT    INT32                         *NumInstalled
+  )
+{
+  EFI_STATUS                       Status;
+  EDKII_ACPI_TABLE_BATCH_PROTOCOL  *AcpiTableBatch;
+  INT32                            Index;
+
+  *NumInstalled = 0;
+  if (NumTables == 0) {
+    return EFI_SUCCESS;
   }
 
-  ++*NumInstalled;
-  return EFI_SUCCESS;
+  Status = gBS->LocateProtocol (
+                  &gEdkiiAcpiTableBatchProtocolGuid,
+                  NULL,
+                  (VOID **)&AcpiTableBatch
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = AcpiTableBatch->InstallAcpiTables (
+                               AcpiTableBatch,
+                               NumTables,
+                               Tables
+                               );
+    for (Index = 0; Index < NumTables; Index++) {
+      if (EFI_ERROR (Tables[Index].Status)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a: InstallAcpiTables(): table %d: %r\n",
+          __FUNCTION__,
+          Index,
+          Tables[Index].Status
+          ));
+      } else {
+        InstalledKey[(*NumInstalled)++] = Tables[Index].TableKey;
+      }
+    }
 
-RollbackSeenPointer:
-  OrderedCollectionDelete (SeenPointers, SeenPointerEntry, NULL);
-  return Status;
+    return Status;
+  }
+
+  for (Index = 0; Index < NumTables; Index++) {
+    Status = AcpiProtocol->InstallAcpiTable (
+                             AcpiProtocol,
+                             Tables[Index].AcpiTableBuffer,
+                             Tables[Index].AcpiTableBufferSize,
+                             &Tables[Index].TableKey
+                             );
+    Tables[Index].Status = Status;
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: InstallAcpiTable(): %r\n",
+        __FUNCTION__,
+        Status
+        ));
+      return Status;
+    }
+
+    InstalledKey[(*NumInstalled)++] = Tables[Index].TableKey;
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1078,7 +1158,8 @@ RollbackSeenPointer:
   @retval  EFI_PROTOCOL_ERROR    Found invalid fw_cfg contents.
 
   @return                        Status codes returned by
-                                 AcpiProtocol->InstallAcpiTable().
+                                 AcpiProtocol->InstallAcpiTable() or
+                                 EDKII_ACPI_TABLE_BATCH_PROTOCOL.InstallAcpiTables().
 
 **/
 EFI_STATUS
@@ -1087,22 +1168,24 @@ InstallQemuFwCfgTables (
   IN   EFI_ACPI_TABLE_PROTOCOL  *AcpiProtocol
   )
 {
-  EFI_STATUS                Status;
-  FIRMWARE_CONFIG_ITEM      FwCfgItem;
-  UINTN                     FwCfgSize;
-  QEMU_LOADER_ENTRY         *LoaderStart;
-  CONST QEMU_LOADER_ENTRY   *LoaderEntry, *LoaderEnd;
-  CONST QEMU_LOADER_ENTRY   *WritePointerSubsetEnd;
-  ORIGINAL_ATTRIBUTES       *OriginalPciAttributes;
-  UINTN                     OriginalPciAttributesCount;
-  ORDERED_COLLECTION        *AllocationsRestrictedTo32Bit;
-  S3_CONTEXT                *S3Context;
-  ORDERED_COLLECTION        *Tracker;
-  UINTN                     *InstalledKey;
-  INT32                     Installed;
-  ORDERED_COLLECTION_ENTRY  *TrackerEntry, *TrackerEntry2;
-  ORDERED_COLLECTION        *SeenPointers;
-  ORDERED_COLLECTION_ENTRY  *SeenPointerEntry, *SeenPointerEntry2;
+  EFI_STATUS                    Status;
+  FIRMWARE_CONFIG_ITEM          FwCfgItem;
+  UINTN                         FwCfgSize;
+  QEMU_LOADER_ENTRY             *LoaderStart;
+  CONST QEMU_LOADER_ENTRY       *LoaderEntry, *LoaderEnd;
+  CONST QEMU_LOADER_ENTRY       *WritePointerSubsetEnd;
+  ORIGINAL_ATTRIBUTES           *OriginalPciAttributes;
+  UINTN                         OriginalPciAttributesCount;
+  ORDERED_COLLECTION            *AllocationsRestrictedTo32Bit;
+  S3_CONTEXT                    *S3Context;
+  ORDERED_COLLECTION            *Tracker;
+  EDKII_ACPI_TABLE_BATCH_ENTRY  *Tables;
+  INT32                         NumTables;
+  UINTN                         *InstalledKey;
+  INT32                         Installed;
+  ORDERED_COLLECTION_ENTRY      *TrackerEntry, *TrackerEntry2;
+  ORDERED_COLLECTION            *SeenPointers;
+  ORDERED_COLLECTION_ENTRY      *SeenPointerEntry, *SeenPointerEntry2;
 
   Status = QemuFwCfgFindFile ("etc/table-loader", &FwCfgItem, &FwCfgSize);
   if (EFI_ERROR (Status)) {
@@ -1217,10 +1300,16 @@ InstallQemuFwCfgTables (
     }
   }
 
+  Tables = AllocatePool (INSTALLED_TABLES_MAX * sizeof *Tables);
+  if (Tables == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto RollbackWritePointersAndFreeTracker;
+  }
+
   InstalledKey = AllocatePool (INSTALLED_TABLES_MAX * sizeof *InstalledKey);
   if (InstalledKey == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
-    goto RollbackWritePointersAndFreeTracker;
+    goto FreeTables;
   }
 
   SeenPointers = OrderedCollectionInit (PointerCompare, PointerCompare);
@@ -1230,17 +1319,17 @@ InstallQemuFwCfgTables (
   }
 
   //
-  // second pass: identify and install ACPI tables
+  // second pass: identify ACPI tables, then install them all at once
   //
+  NumTables = 0;
   Installed = 0;
   for (LoaderEntry = LoaderStart; LoaderEntry < LoaderEnd; ++LoaderEntry) {
     if (LoaderEntry->Type == QemuLoaderCmdAddPointer) {
       Status = Process2ndPassCmdAddPointer (
                  &LoaderEntry->Command.AddPointer,
                  Tracker,
-                 AcpiProtocol,
-                 InstalledKey,
-                 &Installed,
+                 Tables,
+                 &NumTables,
                  SeenPointers
                  );
       if (EFI_ERROR (Status)) {
@@ -1249,6 +1338,17 @@ InstallQemuFwCfgTables (
     }
   }
 
+  Status = InstallCollectedTables (
+             AcpiProtocol,
+             Tables,
+             NumTables,
+             InstalledKey,
+             &Installed
+             );
+  if (EFI_ERROR (Status)) {
+    goto UninstallAcpiTables;
+  }
+
   //
   // Translating the condensed QEMU_LOADER_WRITE_POINTER commands to ACPI S3
   // Boot Script opcodes has to be the last operation in this function, because
@@ -1301,6 +1401,9 @@ UninstallAcpiTables:
 FreeKeys:
   FreePool (InstalledKey);
 
+FreeTables:
+  FreePool (Tables);
+
 RollbackWritePointersAndFreeTracker:
   //
   // In case of failure, revoke any allocation addresses that were communicated
@@ -34,6 +34,12 @@ typedef struct {
   UINT8                  Sectors;
   UINT32                 BlkSize;
   VIRTIO_BLK_TOPOLOGY    Topology;
+  //
+  // virtio-1.0, 5.2.4 Device configuration layout
+  //
+  UINT8                  WriteBack;
+  UINT8                  Unused0;
+  UINT16                 NumQueues;
 } VIRTIO_BLK_CONFIG;
 #pragma pack()
 
@@ -53,6 +59,7 @@ typedef struct {
 #define VIRTIO_BLK_F_SCSI      BIT7
 #define VIRTIO_BLK_F_FLUSH     BIT9  // identical to "write cache enabled"
 #define VIRTIO_BLK_F_TOPOLOGY  BIT10 // information on optimal I/O alignment
+#define VIRTIO_BLK_F_MQ        BIT12 // virtio-1.0: multiple request queues
 
 //
 // We keep the status byte separate from the rest of the virtio-blk request
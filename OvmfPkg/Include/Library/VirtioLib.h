@@ -210,6 +210,50 @@ VirtioFlush (
   OUT    UINT32                  *UsedLen    OPTIONAL
   );
 
+/**
+
+  Notify the host about several descriptor chains just built, and wait until
+  the host processes all of them. The host may process the chains in
+  parallel, and complete them in any order.
+
+  The chains are built one after the other with VirtioAppendDesc(), after a
+  single VirtioPrepare() call; the head of each chain is the
+  Indices->NextDescIdx value seen before appending its first descriptor. The
+  caller is responsible for ensuring that the descriptors of all chains fit
+  in the ring.
+
+  @param[in] VirtIo       The target virtio device to notify.
+
+  @param[in] VirtQueueId  Identifies the queue for the target device.
+
+  @param[in,out] Ring     The virtio ring with descriptors to submit.
+
+  @param[in] NumChains    The number of descriptor chains to submit.
+
+  @param[in] HeadDescIdx  Array of NumChains elements, identifying the head
+                          descriptors of the descriptor chains.
+
+  @param[out] UsedLen     On success, array of NumChains elements, each
+                          receiving the total number of bytes that the host
+                          wrote across the buffers of the corresponding chain.
+                          May be NULL if the caller doesn't care.
+
+  @return              Error code from VirtIo->SetQueueNotify() if it fails.
+
+  @retval EFI_SUCCESS  Otherwise, the host processed all descriptors.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioFlushChains (
+  IN     VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN     UINT16                  VirtQueueId,
+  IN OUT VRING                   *Ring,
+  IN     UINTN                   NumChains,
+  IN     CONST UINT16            *HeadDescIdx,
+  OUT    UINT32                  *UsedLen     OPTIONAL
+  );
+
 /**
 
   Report the feature bits to the VirtIo 1.0 device that the VirtIo 1.0 driver
@@ -37,6 +37,25 @@ STATIC LIST_ENTRY  mMapInfos = INITIALIZE_LIST_HEAD_VARIABLE (mMapInfos);
 
 #define COMMON_BUFFER_SIG  SIGNATURE_64 ('C', 'M', 'N', 'B', 'U', 'F', 'F', 'R')
 
+//
+// Changing the encryption attribute of a bounce buffer edits the page tables
+// and flushes the TLB, so IoMmuUnmap() keeps the plaintext bounce buffers of
+// BusMasterRead[64] and BusMasterWrite[64] operations for reuse by later
+// IoMmuMap() calls. The buffers are grouped in size classes of 1, 2, 4, ...
+// BOUNCE_BUFFER_CLASS_PAGES (BOUNCE_BUFFER_CLASSES - 1) pages, and at most
+// BOUNCE_BUFFER_DEPTH buffers are kept per class. Only buffers below 4GB are
+// kept, so that they suit every operation.
+//
+// The addresses are tracked in this driver's own (encrypted) data rather
+// than in the plaintext buffers, which the host can write.
+//
+#define BOUNCE_BUFFER_CLASSES             7
+#define BOUNCE_BUFFER_DEPTH               8
+#define BOUNCE_BUFFER_CLASS_PAGES(Class)  ((UINTN)1 << (Class))
+
+STATIC EFI_PHYSICAL_ADDRESS  mBounceBuffers[BOUNCE_BUFFER_CLASSES][BOUNCE_BUFFER_DEPTH];
+STATIC UINTN                 mBounceBufferCount[BOUNCE_BUFFER_CLASSES];
+
 //
 // ASCII names for EDKII_IOMMU_OPERATION constants, for debug logging.
 //
@@ -74,6 +93,140 @@ typedef struct {
 } COMMON_BUFFER_HEADER;
 #pragma pack ()
 
+/**
+  Remove the memory encryption (SEV) or set the shared bit (TDX) of a buffer,
+  so that it can be accessed by the host.
+
+  @param[in] Address    The base address of the buffer.
+  @param[in] Pages      The number of pages of the buffer.
+**/
+STATIC
+VOID
+SetBufferPlainText (
+  IN EFI_PHYSICAL_ADDRESS  Address,
+  IN UINTN                 Pages
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = EFI_UNSUPPORTED;
+  if (CC_GUEST_IS_SEV (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
+    //
+    // Clear the memory encryption mask on the plaintext buffer.
+    //
+    Status = MemEncryptSevClearPageEncMask (0, Address, Pages);
+  } else if (CC_GUEST_IS_TDX (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
+    //
+    // Set the memory shared bit.
+    //
+    Status = MemEncryptTdxSetPageSharedBit (0, Address, Pages);
+  } else {
+    ASSERT (FALSE);
+  }
+
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    CpuDeadLoop ();
+  }
+}
+
+/**
+  Restore the memory encryption (SEV) or clear the shared bit (TDX) of a
+  buffer which has been made plaintext with SetBufferPlainText().
+
+  @param[in] Address    The base address of the buffer.
+  @param[in] Pages      The number of pages of the buffer.
+**/
+STATIC
+VOID
+SetBufferCrypted (
+  IN EFI_PHYSICAL_ADDRESS  Address,
+  IN UINTN                 Pages
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = EFI_UNSUPPORTED;
+  if (CC_GUEST_IS_SEV (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
+    //
+    // Restore the memory encryption mask on the area we used to hold the
+    // plaintext.
+    //
+    Status = MemEncryptSevSetPageEncMask (0, Address, Pages);
+  } else if (CC_GUEST_IS_TDX (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
+    //
+    // Restore the memory shared bit mask on the area we used to hold the
+    // plaintext.
+    //
+    Status = MemEncryptTdxClearPageSharedBit (0, Address, Pages);
+  } else {
+    ASSERT (FALSE);
+  }
+
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    CpuDeadLoop ();
+  }
+}
+
+/**
+  Return the size class of a bounce buffer.
+
+  @param[in] Pages      The number of pages of the bounce buffer.
+
+  @return  The smallest class holding Pages, or BOUNCE_BUFFER_CLASSES if the
+           buffer is too large to be kept.
+**/
+STATIC
+UINTN
+GetBounceBufferClass (
+  IN UINTN  Pages
+  )
+{
+  UINTN  Class;
+
+  for (Class = 0; Class < BOUNCE_BUFFER_CLASSES; Class++) {
+    if (Pages <= BOUNCE_BUFFER_CLASS_PAGES (Class)) {
+      break;
+    }
+  }
+
+  return Class;
+}
+
+/**
+  Keep a plaintext bounce buffer for reuse.
+
+  @param[in] Address    The base address of the bounce buffer.
+  @param[in] Pages      The number of pages of the bounce buffer.
+
+  @retval TRUE          The buffer is kept, it must be neither re-encrypted
+                        nor freed.
+  @retval FALSE         The buffer is not kept.
+**/
+STATIC
+BOOLEAN
+KeepBounceBuffer (
+  IN EFI_PHYSICAL_ADDRESS  Address,
+  IN UINTN                 Pages
+  )
+{
+  UINTN  Class;
+
+  Class = GetBounceBufferClass (Pages);
+  if ((Class == BOUNCE_BUFFER_CLASSES) ||
+      (Pages != BOUNCE_BUFFER_CLASS_PAGES (Class)) ||
+      (mBounceBufferCount[Class] == BOUNCE_BUFFER_DEPTH) ||
+      (Address + EFI_PAGES_TO_SIZE (Pages) > BASE_4GB))
+  {
+    return FALSE;
+  }
+
+  mBounceBuffers[Class][mBounceBufferCount[Class]] = Address;
+  mBounceBufferCount[Class]++;
+  return TRUE;
+}
+
 /**
   Provides the controller-specific addresses required to access system memory
   from a DMA bus master. On SEV/TDX guest, the DMA operations must be performed on
@@ -120,6 +273,8 @@ IoMmuMap (
   EFI_ALLOCATE_TYPE     AllocateType;
   COMMON_BUFFER_HEADER  *CommonBufferHeader;
   VOID                  *DecryptionSource;
+  BOOLEAN               IsPlainText;
+  UINTN                 Class;
 
   DEBUG ((
     DEBUG_VERBOSE,
@@ -166,6 +321,7 @@ IoMmuMap (
   MapInfo->PlainTextAddress = MAX_ADDRESS;
   AllocateType              = AllocateAnyPages;
   DecryptionSource          = (VOID *)(UINTN)MapInfo->CryptedAddress;
+  IsPlainText               = FALSE;
   switch (Operation) {
     //
     // For BusMasterRead[64] and BusMasterWrite[64] operations, a bounce buffer
@@ -182,6 +338,21 @@ IoMmuMap (
     //
     case EdkiiIoMmuOperationBusMasterRead64:
     case EdkiiIoMmuOperationBusMasterWrite64:
+      //
+      // Round the bounce buffer up to its size class, and reuse a kept one
+      // if there is any. Kept buffers are below 4GB and plaintext already.
+      //
+      Class = GetBounceBufferClass (MapInfo->NumberOfPages);
+      if (Class < BOUNCE_BUFFER_CLASSES) {
+        MapInfo->NumberOfPages = BOUNCE_BUFFER_CLASS_PAGES (Class);
+        if (mBounceBufferCount[Class] > 0) {
+          mBounceBufferCount[Class]--;
+          MapInfo->PlainTextAddress = mBounceBuffers[Class][mBounceBufferCount[Class]];
+          IsPlainText               = TRUE;
+          break;
+        }
+      }
+
       //
       // Allocate the implicit plaintext bounce buffer.
       //
@@ -252,31 +423,8 @@ IoMmuMap (
       goto FreeMapInfo;
   }
 
-  if (CC_GUEST_IS_SEV (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
-    //
-    // Clear the memory encryption mask on the plaintext buffer.
-    //
-    Status = MemEncryptSevClearPageEncMask (
-               0,
-               MapInfo->PlainTextAddress,
-               MapInfo->NumberOfPages
-               );
-  } else if (CC_GUEST_IS_TDX (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
-    //
-    // Set the memory shared bit.
-    //
-    Status = MemEncryptTdxSetPageSharedBit (
-               0,
-               MapInfo->PlainTextAddress,
-               MapInfo->NumberOfPages
-               );
-  } else {
-    ASSERT (FALSE);
-  }
-
-  ASSERT_EFI_ERROR (Status);
-  if (EFI_ERROR (Status)) {
-    CpuDeadLoop ();
+  if (!IsPlainText) {
+    SetBufferPlainText (MapInfo->PlainTextAddress, MapInfo->NumberOfPages);
   }
 
   //
@@ -357,9 +505,9 @@ IoMmuUnmapWorker (
   )
 {
   MAP_INFO              *MapInfo;
-  EFI_STATUS            Status;
   COMMON_BUFFER_HEADER  *CommonBufferHeader;
   VOID                  *EncryptionTarget;
+  BOOLEAN               IsKept;
 
   DEBUG ((
     DEBUG_VERBOSE,
@@ -374,7 +522,6 @@ IoMmuUnmapWorker (
   }
 
   MapInfo = (MAP_INFO *)Mapping;
-  Status  = EFI_SUCCESS;
   //
   // set CommonBufferHeader to suppress incorrect compiler/analyzer warnings
   //
@@ -389,6 +536,7 @@ IoMmuUnmapWorker (
   // land in-place, so divert the encryption to the stash buffer first.
   //
   EncryptionTarget = (VOID *)(UINTN)MapInfo->CryptedAddress;
+  IsKept           = FALSE;
 
   switch (MapInfo->Operation) {
     case EdkiiIoMmuOperationBusMasterCommonBuffer:
@@ -420,33 +568,21 @@ IoMmuUnmapWorker (
       break;
   }
 
-  if (CC_GUEST_IS_SEV (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
-    //
-    // Restore the memory encryption mask on the area we used to hold the
-    // plaintext.
-    //
-    Status = MemEncryptSevSetPageEncMask (
-               0,
-               MapInfo->PlainTextAddress,
-               MapInfo->NumberOfPages
-               );
-  } else if (CC_GUEST_IS_TDX (PcdGet64 (PcdConfidentialComputingGuestAttr))) {
-    //
-    // Restore the memory shared bit mask on the area we used to hold the
-    // plaintext.
-    //
-    Status = MemEncryptTdxClearPageSharedBit (
-               0,
-               MapInfo->PlainTextAddress,
-               MapInfo->NumberOfPages
-               );
-  } else {
-    ASSERT (FALSE);
+  //
+  // Keep the plaintext bounce buffer of BusMasterRead[64] and
+  // BusMasterWrite[64] operations for reuse, unless the memory is being
+  // handed over to the OS. Its contents have been visible to the host
+  // already, so there is no need to zero it.
+  //
+  if (!MemoryMapLocked &&
+      (MapInfo->Operation != EdkiiIoMmuOperationBusMasterCommonBuffer) &&
+      (MapInfo->Operation != EdkiiIoMmuOperationBusMasterCommonBuffer64))
+  {
+    IsKept = KeepBounceBuffer (MapInfo->PlainTextAddress, MapInfo->NumberOfPages);
   }
 
-  ASSERT_EFI_ERROR (Status);
-  if (EFI_ERROR (Status)) {
-    CpuDeadLoop ();
+  if (!IsKept) {
+    SetBufferCrypted (MapInfo->PlainTextAddress, MapInfo->NumberOfPages);
   }
 
   //
@@ -455,7 +591,7 @@ IoMmuUnmapWorker (
   //
   // For all other operations, fill the late bounce buffer (which existed as
   // plaintext at some point) with zeros, and then release it (unless the UEFI
-  // memory map is locked).
+  // memory map is locked, or the buffer is kept for reuse).
   //
   if ((MapInfo->Operation == EdkiiIoMmuOperationBusMasterCommonBuffer) ||
       (MapInfo->Operation == EdkiiIoMmuOperationBusMasterCommonBuffer64))
@@ -465,7 +601,7 @@ IoMmuUnmapWorker (
       CommonBufferHeader->StashBuffer,
       MapInfo->NumberOfBytes
       );
-  } else {
+  } else if (!IsKept) {
     ZeroMem (
       (VOID *)(UINTN)MapInfo->PlainTextAddress,
       EFI_PAGES_TO_SIZE (MapInfo->NumberOfPages)
@@ -843,7 +979,8 @@ IoMmuExitBoot (
   events in the EFI_EVENT_GROUP_EXIT_BOOT_SERVICES event group. The same memory
   map restrictions apply.
 
-  This function unmaps all currently existing IOMMU mappings.
+  This function unmaps all currently existing IOMMU mappings, and re-encrypts
+  the bounce buffers kept for reuse.
 
   @param[in] Event    Event whose notification function is being invoked. Event
                       is permitted to request the queueing of this function
@@ -862,6 +999,8 @@ IoMmuUnmapAllMappings (
   LIST_ENTRY  *Node;
   LIST_ENTRY  *NextNode;
   MAP_INFO    *MapInfo;
+  UINTN       Class;
+  UINTN       Index;
 
   DEBUG ((DEBUG_VERBOSE, "%a\n", __FUNCTION__));
 
@@ -878,6 +1017,22 @@ IoMmuUnmapAllMappings (
       TRUE      // MemoryMapLocked
       );
   }
+
+  //
+  // Hand the kept bounce buffers back to the OS encrypted and zeroed. They
+  // cannot be released as the UEFI memory map is locked.
+  //
+  for (Class = 0; Class < BOUNCE_BUFFER_CLASSES; Class++) {
+    for (Index = 0; Index < mBounceBufferCount[Class]; Index++) {
+      SetBufferCrypted (mBounceBuffers[Class][Index], BOUNCE_BUFFER_CLASS_PAGES (Class));
+      ZeroMem (
+        (VOID *)(UINTN)mBounceBuffers[Class][Index],
+        EFI_PAGES_TO_SIZE (BOUNCE_BUFFER_CLASS_PAGES (Class))
+        );
+    }
+
+    mBounceBufferCount[Class] = 0;
+  }
 }
 
 /**
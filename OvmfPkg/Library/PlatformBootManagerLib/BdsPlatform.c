@@ -11,6 +11,7 @@
 #include <Guid/SerialPortLibVendor.h>
 #include <Protocol/FirmwareVolume2.h>
 #include <Library/PlatformBmPrintScLib.h>
+#include <Library/QemuFwCfgSimpleParserLib.h>
 #include <Library/Tcg2PhysicalPresenceLib.h>
 #include <Library/XenPlatformLib.h>
 
@@ -1635,6 +1636,208 @@ SaveS3BootScript (
   ASSERT_EFI_ERROR (Status);
 }
 
+//
+// Name of the non-volatile variable (in the gEfiCallerIdGuid namespace) that
+// records the fingerprint of the platform for which the boot options were last
+// refreshed.
+//
+#define BOOT_CHECKPOINT_VARIABLE_NAME  L"BootCheckpoint"
+
+//
+// Size of one FWCfgFile entry in the fw_cfg file directory.
+//
+#define FW_CFG_FILE_DIR_ENTRY_SIZE  64
+
+/**
+  Fold the CRC32 of a buffer into a running fingerprint.
+
+  @param[in] Fingerprint  The fingerprint so far.
+  @param[in] Buffer       The data to add.
+  @param[in] Size         The size of Buffer in bytes.
+
+  @return  The new fingerprint.
+**/
+STATIC
+UINT32
+FoldFingerprint (
+  IN UINT32      Fingerprint,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  )
+{
+  UINT32  Pair[2];
+
+  Pair[0] = Fingerprint;
+  Pair[1] = CalculateCrc32 ((VOID *)Buffer, Size);
+  return CalculateCrc32 (Pair, sizeof Pair);
+}
+
+/**
+  Calculate the fingerprint of the platform, as far as the boot options are
+  concerned: the fw_cfg file directory (which covers "bootorder" and the
+  firmware-visible configuration), and the device paths of the handles that
+  EfiBootManagerRefreshAllBootOption() creates boot options for.
+
+  @return  The fingerprint.
+**/
+STATIC
+UINT32
+GetBootCheckpointFingerprint (
+  VOID
+  )
+{
+  STATIC EFI_GUID *CONST    BootDeviceProtocols[] = {
+    &gEfiBlockIoProtocolGuid,
+    &gEfiSimpleFileSystemProtocolGuid,
+    &gEfiLoadFileProtocolGuid
+  };
+  UINT32                    Fingerprint;
+  UINT32                    Count;
+  UINT8                     Entry[FW_CFG_FILE_DIR_ENTRY_SIZE];
+  UINTN                     ProtocolIndex;
+  EFI_STATUS                Status;
+  UINTN                     HandleCount;
+  EFI_HANDLE                *Handles;
+  UINTN                     Index;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+
+  Fingerprint = 0;
+
+  if (QemuFwCfgIsAvailable ()) {
+    QemuFwCfgSelectItem (QemuFwCfgItemFileDir);
+    Count       = SwapBytes32 (QemuFwCfgRead32 ());
+    Fingerprint = FoldFingerprint (Fingerprint, &Count, sizeof Count);
+    while (Count > 0) {
+      QemuFwCfgReadBytes (sizeof Entry, Entry);
+      Fingerprint = FoldFingerprint (Fingerprint, Entry, sizeof Entry);
+      Count--;
+    }
+  }
+
+  for (ProtocolIndex = 0;
+       ProtocolIndex < ARRAY_SIZE (BootDeviceProtocols);
+       ProtocolIndex++)
+  {
+    Status = gBS->LocateHandleBuffer (
+                    ByProtocol,
+                    BootDeviceProtocols[ProtocolIndex],
+                    NULL,
+                    &HandleCount,
+                    &Handles
+                    );
+    if (EFI_ERROR (Status)) {
+      HandleCount = 0;
+      Handles     = NULL;
+    }
+
+    Fingerprint = FoldFingerprint (Fingerprint, &HandleCount, sizeof HandleCount);
+    for (Index = 0; Index < HandleCount; Index++) {
+      DevicePath = DevicePathFromHandle (Handles[Index]);
+      if (DevicePath != NULL) {
+        Fingerprint = FoldFingerprint (
+                        Fingerprint,
+                        DevicePath,
+                        GetDevicePathSize (DevicePath)
+                        );
+      }
+    }
+
+    if (Handles != NULL) {
+      FreePool (Handles);
+    }
+  }
+
+  return Fingerprint;
+}
+
+/**
+  Refresh the boot options, unless the host has enabled boot checkpoints with
+  "opt/org.tianocore/BootCheckpoint", and the platform fingerprint matches the
+  one recorded when the boot options were last refreshed.
+
+  Short-lived virtual machines tend to boot the same configuration over and
+  over; for them, enumerating the boot devices and rewriting the boot options
+  is redundant.
+**/
+STATIC
+VOID
+RefreshBootOptions (
+  VOID
+  )
+{
+  RETURN_STATUS  RetStatus;
+  BOOLEAN        Enabled;
+  UINT32         Fingerprint;
+  UINT32         SavedFingerprint;
+  UINTN          Size;
+  EFI_STATUS     Status;
+
+  RetStatus = QemuFwCfgParseBool ("opt/org.tianocore/BootCheckpoint", &Enabled);
+  if (RETURN_ERROR (RetStatus)) {
+    Enabled = FALSE;
+  }
+
+  Fingerprint = 0;
+  if (Enabled) {
+    Fingerprint = GetBootCheckpointFingerprint ();
+    Size        = sizeof SavedFingerprint;
+    Status      = gRT->GetVariable (
+                         BOOT_CHECKPOINT_VARIABLE_NAME,
+                         &gEfiCallerIdGuid,
+                         NULL,
+                         &Size,
+                         &SavedFingerprint
+                         );
+    if (!EFI_ERROR (Status) && (Size == sizeof SavedFingerprint) &&
+        (SavedFingerprint == Fingerprint))
+    {
+      //
+      // The boot options themselves must have survived too.
+      //
+      Size   = 0;
+      Status = gRT->GetVariable (
+                      EFI_BOOT_ORDER_VARIABLE_NAME,
+                      &gEfiGlobalVariableGuid,
+                      NULL,
+                      &Size,
+                      NULL
+                      );
+      if ((Status == EFI_BUFFER_TOO_SMALL) && (Size > 0)) {
+        DEBUG ((
+          DEBUG_INFO,
+          "%a: platform unchanged (0x%08x), keeping the boot options\n",
+          __FUNCTION__,
+          Fingerprint
+          ));
+        return;
+      }
+    }
+  }
+
+  EfiBootManagerRefreshAllBootOption ();
+
+  //
+  // Register UEFI Shell
+  //
+  PlatformRegisterFvBootOption (
+    &gUefiShellFileGuid,
+    L"EFI Internal Shell",
+    LOAD_OPTION_ACTIVE
+    );
+
+  RemoveStaleFvFileOptions ();
+
+  if (Enabled) {
+    gRT->SetVariable (
+           BOOT_CHECKPOINT_VARIABLE_NAME,
+           &gEfiCallerIdGuid,
+           EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+           sizeof Fingerprint,
+           &Fingerprint
+           );
+  }
+}
+
 /**
   Do the platform specific action after the console is ready
 
@@ -1704,18 +1907,7 @@ PlatformBootManagerAfterConsole (
   //
   PlatformBdsConnectSequence ();
 
-  EfiBootManagerRefreshAllBootOption ();
-
-  //
-  // Register UEFI Shell
-  //
-  PlatformRegisterFvBootOption (
-    &gUefiShellFileGuid,
-    L"EFI Internal Shell",
-    LOAD_OPTION_ACTIVE
-    );
-
-  RemoveStaleFvFileOptions ();
+  RefreshBootOptions ();
   SetBootOrderFromQemu ();
 
   PlatformBmPrintScRegisterHandler ();
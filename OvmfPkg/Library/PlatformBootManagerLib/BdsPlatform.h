@@ -45,7 +45,9 @@ Abstract:
 #include <Library/QemuFwCfgS3Lib.h>
 #include <Library/QemuBootOrderLib.h>
 
+#include <Protocol/BlockIo.h>
 #include <Protocol/Decompress.h>
+#include <Protocol/LoadFile.h>
 #include <Protocol/PciIo.h>
 #include <Protocol/FirmwareVolume2.h>
 #include <Protocol/SimpleFileSystem.h>
@@ -19,15 +19,135 @@
 #include <Library/QemuFwCfgLib.h>
 #include <Library/PeiServicesLib.h>
 #include <Library/TdxLib.h>
+#include <Library/TdxMailboxLib.h>
 #include <Library/SynchronizationLib.h>
 #include <WorkArea.h>
 #include <ConfidentialComputingGuestAttr.h>
 
-#define ALIGNED_2MB_MASK                0x1fffff
-#define EFI_RESOURCE_MEMORY_UNACCEPTED  7
+#define ALIGNED_2MB_MASK  0x1fffff
+
+//
+// The mailbox has room for the tallies and errors of 256 vCPUs.
+//
+#define MAX_ACCEPT_CPUS  256
+
+//
+// The upper size of the chunks the vCPUs accept in turn. It keeps the
+// vCPUs busy till the end even if some of them run slower.
+//
+#define ACCEPT_CHUNK_SIZE  SIZE_32MB
 
 /**
-  This function will be called to accept pages. Only BSP accepts pages.
+  Accept the chunks of a range which belong to one vCPU. The range is split
+  into ChunkSize chunks and chunk N belongs to the vCPU with index
+  (N % CpusNum). The APs run the same loop in the AcceptPages command
+  handler of SecEntry.nasm.
+
+  @param[in] CpuIndex          vCPU index
+  @param[in] CpusNum           Number of the vCPUs accepting the range
+  @param[in] PhysicalStart     Start physical address, aligned to AcceptPageSize
+  @param[in] PhysicalEnd       End physical address, aligned to AcceptPageSize
+  @param[in] ChunkSize         Chunk size, multiple of AcceptPageSize
+  @param[in] AcceptPageSize    Page size to accept
+
+  @retval    EFI_SUCCESS       Accept memory successfully
+  @retval    Others            Other errors as indicated
+**/
+STATIC
+EFI_STATUS
+AcceptMemoryChunks (
+  IN UINT32                CpuIndex,
+  IN UINT32                CpusNum,
+  IN EFI_PHYSICAL_ADDRESS  PhysicalStart,
+  IN EFI_PHYSICAL_ADDRESS  PhysicalEnd,
+  IN UINT64                ChunkSize,
+  IN UINT32                AcceptPageSize
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  ChunkStart;
+  UINT64                Length;
+
+  for (ChunkStart = PhysicalStart + MultU64x32 (ChunkSize, CpuIndex);
+       ChunkStart < PhysicalEnd;
+       ChunkStart += MultU64x32 (ChunkSize, CpusNum))
+  {
+    Length = MIN (ChunkSize, PhysicalEnd - ChunkStart);
+    Status = TdAcceptPages (ChunkStart, Length / AcceptPageSize, AcceptPageSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Accept pages with BSP and the APs parked on the mailbox. BSP hands the
+  range to the APs with the AcceptPages command and accepts its own share
+  of the chunks meanwhile.
+
+  @param[in] PhysicalStart     Start physical address, aligned to AcceptPageSize
+  @param[in] PhysicalEnd       End physical address, aligned to AcceptPageSize
+  @param[in] AcceptPageSize    Page size to accept
+
+  @retval    EFI_SUCCESS       Accept memory successfully
+  @retval    Others            Other errors as indicated
+**/
+STATIC
+EFI_STATUS
+MpAcceptMemoryResourceRange (
+  IN EFI_PHYSICAL_ADDRESS  PhysicalStart,
+  IN EFI_PHYSICAL_ADDRESS  PhysicalEnd,
+  IN UINT32                AcceptPageSize
+  )
+{
+  EFI_STATUS                  Status;
+  volatile MP_WAKEUP_MAILBOX  *MailBox;
+  UINT32                      CpusNum;
+  UINT32                      Index;
+  UINT64                      ChunkSize;
+
+  CpusNum   = MIN (GetCpusNum (), MAX_ACCEPT_CPUS);
+  ChunkSize = DivU64x32 (PhysicalEnd - PhysicalStart, CpusNum);
+  ChunkSize = MIN (ALIGN_VALUE (ChunkSize, AcceptPageSize), ACCEPT_CHUNK_SIZE);
+
+  DEBUG ((DEBUG_INFO, "   Mp   : %d vCPUs, Chunk 0x%llx\n", CpusNum, ChunkSize));
+
+  MailBox = (volatile MP_WAKEUP_MAILBOX *)GetTdxMailBox ();
+  ZeroMem ((VOID *)MailBox->Tallies, sizeof (MailBox->Tallies));
+  ZeroMem ((VOID *)MailBox->Errors, sizeof (MailBox->Errors));
+
+  MpSerializeStart ();
+  MpSendWakeupCommand (
+    MpProtectedModeWakeupCommandAcceptPages,
+    0,
+    PhysicalStart,
+    PhysicalEnd,
+    ChunkSize,
+    AcceptPageSize
+    );
+
+  Status = AcceptMemoryChunks (0, CpusNum, PhysicalStart, PhysicalEnd, ChunkSize, AcceptPageSize);
+
+  //
+  // Wait for the APs even if BSP failed, they still own the mailbox.
+  //
+  MpSerializeEnd ();
+
+  for (Index = 1; Index < CpusNum; Index++) {
+    if (MailBox->Errors[Index] != 0) {
+      DEBUG ((DEBUG_ERROR, "AP %d failed to accept pages, error %d\n", Index, MailBox->Errors[Index]));
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  This function will be called to accept pages. The 2M aligned part is
+  accepted by BSP together with the APs if there are several vCPUs.
 
   TDCALL(ACCEPT_PAGE) supports the accept page size of 4k and 2M. To
   simplify the implementation, the Memory to be accpeted is splitted
@@ -50,7 +170,7 @@
 **/
 EFI_STATUS
 EFIAPI
-BspAcceptMemoryResourceRange (
+AcceptMemoryResourceRange (
   IN EFI_PHYSICAL_ADDRESS  PhysicalAddress,
   IN EFI_PHYSICAL_ADDRESS  PhysicalEnd
   )
@@ -119,8 +239,13 @@ BspAcceptMemoryResourceRange (
   }
 
   if (Length2 > 0) {
-    Pages  = Length2 / AcceptPageSize;
-    Status = TdAcceptPages (StartAddress2, Pages, AcceptPageSize);
+    if ((GetCpusNum () > 1) && (Length2 > ACCEPT_CHUNK_SIZE)) {
+      Status = MpAcceptMemoryResourceRange (StartAddress2, StartAddress2 + Length2, AcceptPageSize);
+    } else {
+      Pages  = Length2 / AcceptPageSize;
+      Status = TdAcceptPages (StartAddress2, Pages, AcceptPageSize);
+    }
+
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -375,8 +500,10 @@ ProcessHobList (
   EFI_STATUS            Status;
   EFI_PEI_HOB_POINTERS  Hob;
   EFI_PHYSICAL_ADDRESS  PhysicalEnd;
+  EFI_PHYSICAL_ADDRESS  AcceptLimit;
 
-  Status = EFI_SUCCESS;
+  Status      = EFI_SUCCESS;
+  AcceptLimit = FixedPcdGet64 (PcdTdxAcceptMemoryLimit);
   ASSERT (VmmHobList != NULL);
   Hob.Raw = (UINT8 *)VmmHobList;
 
@@ -395,12 +522,18 @@ ProcessHobList (
 
         PhysicalEnd = Hob.ResourceDescriptor->PhysicalStart + Hob.ResourceDescriptor->ResourceLength;
 
-        Status = BspAcceptMemoryResourceRange (
-                   Hob.ResourceDescriptor->PhysicalStart,
-                   PhysicalEnd
-                   );
-        if (EFI_ERROR (Status)) {
-          break;
+        //
+        // The memory above PcdTdxAcceptMemoryLimit is accepted on demand
+        // after SEC, see TransferTdxHobList ().
+        //
+        if (Hob.ResourceDescriptor->PhysicalStart < AcceptLimit) {
+          Status = AcceptMemoryResourceRange (
+                     Hob.ResourceDescriptor->PhysicalStart,
+                     MIN (PhysicalEnd, AcceptLimit)
+                     );
+          if (EFI_ERROR (Status)) {
+            break;
+          }
         }
       }
     }
@@ -465,6 +598,10 @@ ProcessTdxHobList (
   The Hobs transferred in this function are ResourceDescriptor hob and
   MemoryAllocation hob.
 
+  The unaccepted memory below PcdTdxAcceptMemoryLimit has been accepted by
+  ProcessHobList () and is transferred as system memory. The part at or above
+  the limit is kept as unaccepted memory for the DXE Core.
+
   @param[in] VmmHobList    The Hoblist pass the firmware
 
 **/
@@ -477,6 +614,12 @@ TransferTdxHobList (
   EFI_PEI_HOB_POINTERS         Hob;
   EFI_RESOURCE_TYPE            ResourceType;
   EFI_RESOURCE_ATTRIBUTE_TYPE  ResourceAttribute;
+  EFI_PHYSICAL_ADDRESS         PhysicalStart;
+  UINT64                       ResourceLength;
+  UINT64                       AcceptedLength;
+  EFI_PHYSICAL_ADDRESS         AcceptLimit;
+
+  AcceptLimit = FixedPcdGet64 (PcdTdxAcceptMemoryLimit);
 
   //
   // PcdOvmfSecGhcbBase is used as the TD_HOB in Tdx guest.
@@ -487,17 +630,34 @@ TransferTdxHobList (
       case EFI_HOB_TYPE_RESOURCE_DESCRIPTOR:
         ResourceType      = Hob.ResourceDescriptor->ResourceType;
         ResourceAttribute = Hob.ResourceDescriptor->ResourceAttribute;
+        PhysicalStart     = Hob.ResourceDescriptor->PhysicalStart;
+        ResourceLength    = Hob.ResourceDescriptor->ResourceLength;
 
         if (ResourceType == EFI_RESOURCE_MEMORY_UNACCEPTED) {
-          ResourceType       = EFI_RESOURCE_SYSTEM_MEMORY;
           ResourceAttribute |= (EFI_RESOURCE_ATTRIBUTE_PRESENT | EFI_RESOURCE_ATTRIBUTE_INITIALIZED | EFI_RESOURCE_ATTRIBUTE_TESTED);
+
+          if (PhysicalStart < AcceptLimit) {
+            AcceptedLength = MIN (ResourceLength, AcceptLimit - PhysicalStart);
+            BuildResourceDescriptorHob (
+              EFI_RESOURCE_SYSTEM_MEMORY,
+              ResourceAttribute,
+              PhysicalStart,
+              AcceptedLength
+              );
+            PhysicalStart  += AcceptedLength;
+            ResourceLength -= AcceptedLength;
+          }
+
+          if (ResourceLength == 0) {
+            break;
+          }
         }
 
         BuildResourceDescriptorHob (
           ResourceType,
           ResourceAttribute,
-          Hob.ResourceDescriptor->PhysicalStart,
-          Hob.ResourceDescriptor->ResourceLength
+          PhysicalStart,
+          ResourceLength
           );
         break;
       case EFI_HOB_TYPE_MEMORY_ALLOCATION:
@@ -29,6 +29,16 @@ STATIC BOOLEAN  mQemuFwCfgDmaSupported;
 
 STATIC EDKII_IOMMU_PROTOCOL  *mIoMmuProtocol;
 
+//
+// The size of the shared bounce buffer which DMA transfers go through when
+// SEV or TDX is enabled.
+//
+#define FW_CFG_DMA_BUFFER_SIZE  SIZE_256KB
+
+STATIC volatile FW_CFG_DMA_ACCESS  *mDmaAccess;
+STATIC UINT8                       *mDmaBuffer;
+STATIC EFI_PHYSICAL_ADDRESS        mDmaBufferDeviceAddress;
+
 /**
   Returns a boolean indicating if the firmware configuration interface
   is available or not.
@@ -146,16 +156,17 @@ InternalQemuFwCfgDmaIsAvailable (
 }
 
 /**
-  Function is used for allocating a bi-directional FW_CFG_DMA_ACCESS used
-  between Host and device to exchange the information. The buffer must be free'd
-  using FreeFwCfgDmaAccessBuffer ().
+  Function is used for allocating the bi-directional FW_CFG_DMA_ACCESS and
+  the data bounce buffer used between Host and device to exchange the
+  information. They are allocated and mapped on the first DMA transfer, and
+  are kept mapped for the later transfers, so that the memory encryption
+  attributes are not changed for every transfer.
 
 **/
 STATIC
 VOID
-AllocFwCfgDmaAccessBuffer (
-  OUT   VOID  **Access,
-  OUT   VOID  **MapInfo
+AllocFwCfgDmaBuffers (
+  VOID
   )
 {
   UINTN                 Size;
@@ -165,8 +176,11 @@ AllocFwCfgDmaAccessBuffer (
   EFI_PHYSICAL_ADDRESS  DmaAddress;
   VOID                  *Mapping;
 
-  Size     = sizeof (FW_CFG_DMA_ACCESS);
-  NumPages = EFI_SIZE_TO_PAGES (Size);
+  //
+  // FW_CFG_DMA_ACCESS takes the first page, the data buffer the rest.
+  //
+  NumPages = 1 + EFI_SIZE_TO_PAGES (FW_CFG_DMA_BUFFER_SIZE);
+  Size     = EFI_PAGES_TO_SIZE (NumPages);
 
   //
   // As per UEFI spec, in order to map a host address with
@@ -221,7 +235,7 @@ AllocFwCfgDmaAccessBuffer (
     CpuDeadLoop ();
   }
 
-  if (Size < sizeof (FW_CFG_DMA_ACCESS)) {
+  if (Size < EFI_PAGES_TO_SIZE (NumPages)) {
     mIoMmuProtocol->Unmap (mIoMmuProtocol, Mapping);
     mIoMmuProtocol->FreeBuffer (mIoMmuProtocol, NumPages, HostAddress);
     DEBUG ((
@@ -229,143 +243,76 @@ AllocFwCfgDmaAccessBuffer (
       "%a:%a failed to Map() - requested 0x%Lx got 0x%Lx\n",
       gEfiCallerBaseName,
       __FUNCTION__,
-      (UINT64)sizeof (FW_CFG_DMA_ACCESS),
+      (UINT64)EFI_PAGES_TO_SIZE (NumPages),
       (UINT64)Size
       ));
     ASSERT (FALSE);
     CpuDeadLoop ();
   }
 
-  *Access  = HostAddress;
-  *MapInfo = Mapping;
+  mDmaAccess              = HostAddress;
+  mDmaBuffer              = (UINT8 *)HostAddress + EFI_PAGE_SIZE;
+  mDmaBufferDeviceAddress = DmaAddress + EFI_PAGE_SIZE;
 }
 
 /**
-  Function is to used for freeing the Access buffer allocated using
-  AllocFwCfgDmaAccessBuffer()
-
+  Perform one DMA transfer.
+
+  @param[in] Access   The FW_CFG_DMA_ACCESS structure to use, accessible by
+                      the host.
+  @param[in] Size     Size in bytes to transfer or skip.
+  @param[in] Address  Device address of the data, ignored for
+                      FW_CFG_DMA_CTL_SKIP.
+  @param[in] Control  One of FW_CFG_DMA_CTL_WRITE, FW_CFG_DMA_CTL_READ and
+                      FW_CFG_DMA_CTL_SKIP.
 **/
 STATIC
 VOID
-FreeFwCfgDmaAccessBuffer (
-  IN  VOID  *Access,
-  IN  VOID  *Mapping
+QemuFwCfgDmaTransfer (
+  IN volatile FW_CFG_DMA_ACCESS  *Access,
+  IN UINT32                      Size,
+  IN UINT64                      Address,
+  IN UINT32                      Control
   )
 {
-  UINTN       NumPages;
-  EFI_STATUS  Status;
-
-  NumPages = EFI_SIZE_TO_PAGES (sizeof (FW_CFG_DMA_ACCESS));
-
-  Status = mIoMmuProtocol->Unmap (mIoMmuProtocol, Mapping);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a:%a failed to UnMap() Mapping 0x%Lx\n",
-      gEfiCallerBaseName,
-      __FUNCTION__,
-      (UINT64)(UINTN)Mapping
-      ));
-    ASSERT (FALSE);
-    CpuDeadLoop ();
-  }
-
-  Status = mIoMmuProtocol->FreeBuffer (mIoMmuProtocol, NumPages, Access);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a:%a failed to Free() 0x%Lx\n",
-      gEfiCallerBaseName,
-      __FUNCTION__,
-      (UINT64)(UINTN)Access
-      ));
-    ASSERT (FALSE);
-    CpuDeadLoop ();
-  }
-}
+  UINT32  AccessHigh, AccessLow;
+  UINT32  Status;
 
-/**
-  Function is used for mapping host address to device address. The buffer must
-  be unmapped with UnmapDmaDataBuffer ().
+  Access->Control = SwapBytes32 (Control);
+  Access->Length  = SwapBytes32 (Size);
+  Access->Address = SwapBytes64 (Address);
 
-**/
-STATIC
-VOID
-MapFwCfgDmaDataBuffer (
-  IN  BOOLEAN               IsWrite,
-  IN  VOID                  *HostAddress,
-  IN  UINT32                Size,
-  OUT EFI_PHYSICAL_ADDRESS  *DeviceAddress,
-  OUT VOID                  **MapInfo
-  )
-{
-  EFI_STATUS            Status;
-  UINTN                 NumberOfBytes;
-  VOID                  *Mapping;
-  EFI_PHYSICAL_ADDRESS  PhysicalAddress;
-
-  NumberOfBytes = Size;
-  Status        = mIoMmuProtocol->Map (
-                                    mIoMmuProtocol,
-                                    (IsWrite ?
-                                     EdkiiIoMmuOperationBusMasterRead64 :
-                                     EdkiiIoMmuOperationBusMasterWrite64),
-                                    HostAddress,
-                                    &NumberOfBytes,
-                                    &PhysicalAddress,
-                                    &Mapping
-                                    );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a:%a failed to Map() Address 0x%Lx Size 0x%Lx\n",
-      gEfiCallerBaseName,
-      __FUNCTION__,
-      (UINT64)(UINTN)HostAddress,
-      (UINT64)Size
-      ));
-    ASSERT (FALSE);
-    CpuDeadLoop ();
-  }
+  //
+  // Delimit the transfer from (a) modifications to Access, (b) in case of a
+  // write, from writes to Buffer by the caller.
+  //
+  MemoryFence ();
 
-  if (NumberOfBytes < Size) {
-    mIoMmuProtocol->Unmap (mIoMmuProtocol, Mapping);
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a:%a failed to Map() - requested 0x%x got 0x%Lx\n",
-      gEfiCallerBaseName,
-      __FUNCTION__,
-      Size,
-      (UINT64)NumberOfBytes
-      ));
-    ASSERT (FALSE);
-    CpuDeadLoop ();
-  }
+  //
+  // Start the transfer.
+  //
+  AccessHigh = (UINT32)RShiftU64 ((UINTN)Access, 32);
+  AccessLow  = (UINT32)(UINTN)Access;
+  IoWrite32 (FW_CFG_IO_DMA_ADDRESS, SwapBytes32 (AccessHigh));
+  IoWrite32 (FW_CFG_IO_DMA_ADDRESS + 4, SwapBytes32 (AccessLow));
 
-  *DeviceAddress = PhysicalAddress;
-  *MapInfo       = Mapping;
-}
+  //
+  // Don't look at Access.Control before starting the transfer.
+  //
+  MemoryFence ();
 
-STATIC
-VOID
-UnmapFwCfgDmaDataBuffer (
-  IN  VOID  *Mapping
-  )
-{
-  EFI_STATUS  Status;
+  //
+  // Wait for the transfer to complete.
+  //
+  do {
+    Status = SwapBytes32 (Access->Control);
+    ASSERT ((Status & FW_CFG_DMA_CTL_ERROR) == 0);
+  } while (Status != 0);
 
-  Status = mIoMmuProtocol->Unmap (mIoMmuProtocol, Mapping);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a:%a failed to UnMap() Mapping 0x%Lx\n",
-      gEfiCallerBaseName,
-      __FUNCTION__,
-      (UINT64)(UINTN)Mapping
-      ));
-    ASSERT (FALSE);
-    CpuDeadLoop ();
-  }
+  //
+  // After a read, the caller will want to use Buffer.
+  //
+  MemoryFence ();
 }
 
 /**
@@ -391,11 +338,7 @@ InternalQemuFwCfgDmaBytes (
   )
 {
   volatile FW_CFG_DMA_ACCESS  LocalAccess;
-  volatile FW_CFG_DMA_ACCESS  *Access;
-  UINT32                      AccessHigh, AccessLow;
-  UINT32                      Status;
-  VOID                        *AccessMapping, *DataMapping;
-  VOID                        *DataBuffer;
+  UINT32                      Chunk;
 
   ASSERT (
     Control == FW_CFG_DMA_CTL_WRITE || Control == FW_CFG_DMA_CTL_READ ||
@@ -406,89 +349,38 @@ InternalQemuFwCfgDmaBytes (
     return;
   }
 
-  Access        = &LocalAccess;
-  AccessMapping = NULL;
-  DataMapping   = NULL;
-  DataBuffer    = Buffer;
-
-  //
-  // When SEV or TDX is enabled, map Buffer to DMA address before issuing the DMA
-  // request
-  //
-  if (MemEncryptSevIsEnabled () || MemEncryptTdxIsEnabled ()) {
-    VOID                  *AccessBuffer;
-    EFI_PHYSICAL_ADDRESS  DataBufferAddress;
-
-    //
-    // Allocate DMA Access buffer
-    //
-    AllocFwCfgDmaAccessBuffer (&AccessBuffer, &AccessMapping);
-
-    Access = AccessBuffer;
-
-    //
-    // Map actual data buffer
-    //
-    if (Control != FW_CFG_DMA_CTL_SKIP) {
-      MapFwCfgDmaDataBuffer (
-        Control == FW_CFG_DMA_CTL_WRITE,
-        Buffer,
-        Size,
-        &DataBufferAddress,
-        &DataMapping
-        );
-
-      DataBuffer = (VOID *)(UINTN)DataBufferAddress;
-    }
+  if (!MemEncryptSevIsEnabled () && !MemEncryptTdxIsEnabled ()) {
+    QemuFwCfgDmaTransfer (&LocalAccess, Size, (UINTN)Buffer, Control);
+    return;
   }
 
-  Access->Control = SwapBytes32 (Control);
-  Access->Length  = SwapBytes32 (Size);
-  Access->Address = SwapBytes64 ((UINTN)DataBuffer);
-
-  //
-  // Delimit the transfer from (a) modifications to Access, (b) in case of a
-  // write, from writes to Buffer by the caller.
-  //
-  MemoryFence ();
-
   //
-  // Start the transfer.
+  // When SEV or TDX is enabled, the host can only access shared memory.
+  // Transfer the data through the shared bounce buffer, in pieces of its
+  // size.
   //
-  AccessHigh = (UINT32)RShiftU64 ((UINTN)Access, 32);
-  AccessLow  = (UINT32)(UINTN)Access;
-  IoWrite32 (FW_CFG_IO_DMA_ADDRESS, SwapBytes32 (AccessHigh));
-  IoWrite32 (FW_CFG_IO_DMA_ADDRESS + 4, SwapBytes32 (AccessLow));
+  if (mDmaAccess == NULL) {
+    AllocFwCfgDmaBuffers ();
+  }
 
-  //
-  // Don't look at Access.Control before starting the transfer.
-  //
-  MemoryFence ();
+  if (Control == FW_CFG_DMA_CTL_SKIP) {
+    QemuFwCfgDmaTransfer (mDmaAccess, Size, 0, Control);
+    return;
+  }
 
-  //
-  // Wait for the transfer to complete.
-  //
-  do {
-    Status = SwapBytes32 (Access->Control);
-    ASSERT ((Status & FW_CFG_DMA_CTL_ERROR) == 0);
-  } while (Status != 0);
+  while (Size > 0) {
+    Chunk = MIN (Size, FW_CFG_DMA_BUFFER_SIZE);
+    if (Control == FW_CFG_DMA_CTL_WRITE) {
+      CopyMem (mDmaBuffer, Buffer, Chunk);
+    }
 
-  //
-  // After a read, the caller will want to use Buffer.
-  //
-  MemoryFence ();
+    QemuFwCfgDmaTransfer (mDmaAccess, Chunk, mDmaBufferDeviceAddress, Control);
 
-  //
-  // If Access buffer was dynamically allocated then free it.
-  //
-  if (AccessMapping != NULL) {
-    FreeFwCfgDmaAccessBuffer ((VOID *)Access, AccessMapping);
-  }
+    if (Control == FW_CFG_DMA_CTL_READ) {
+      CopyMem (Buffer, mDmaBuffer, Chunk);
+    }
 
-  //
-  // If DataBuffer was mapped then unmap it.
-  //
-  if (DataMapping != NULL) {
-    UnmapFwCfgDmaDataBuffer (DataMapping);
+    Buffer = (UINT8 *)Buffer + Chunk;
+    Size  -= Chunk;
   }
 }
@@ -349,6 +349,127 @@ VirtioFlush (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Notify the host about several descriptor chains just built, and wait until
+  the host processes all of them. The host may process the chains in
+  parallel, and complete them in any order.
+
+  The chains are built one after the other with VirtioAppendDesc(), after a
+  single VirtioPrepare() call; the head of each chain is the
+  Indices->NextDescIdx value seen before appending its first descriptor. The
+  caller is responsible for ensuring that the descriptors of all chains fit
+  in the ring.
+
+  @param[in] VirtIo       The target virtio device to notify.
+
+  @param[in] VirtQueueId  Identifies the queue for the target device.
+
+  @param[in,out] Ring     The virtio ring with descriptors to submit.
+
+  @param[in] NumChains    The number of descriptor chains to submit.
+
+  @param[in] HeadDescIdx  Array of NumChains elements, identifying the head
+                          descriptors of the descriptor chains.
+
+  @param[out] UsedLen     On success, array of NumChains elements, each
+                          receiving the total number of bytes that the host
+                          wrote across the buffers of the corresponding chain.
+                          May be NULL if the caller doesn't care.
+
+  @return              Error code from VirtIo->SetQueueNotify() if it fails.
+
+  @retval EFI_SUCCESS  Otherwise, the host processed all descriptors.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioFlushChains (
+  IN     VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN     UINT16                  VirtQueueId,
+  IN OUT VRING                   *Ring,
+  IN     UINTN                   NumChains,
+  IN     CONST UINT16            *HeadDescIdx,
+  OUT    UINT32                  *UsedLen     OPTIONAL
+  )
+{
+  UINT16      NextAvailIdx;
+  UINT16      LastUsedIdx;
+  UINTN       Chain;
+  UINTN       Used;
+  EFI_STATUS  Status;
+  UINTN       PollPeriodUsecs;
+
+  ASSERT (NumChains > 0 && NumChains <= Ring->QueueSize);
+
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
+  //
+  NextAvailIdx = *Ring->Avail.Idx;
+  LastUsedIdx  = NextAvailIdx;
+  for (Chain = 0; Chain < NumChains; Chain++) {
+    Ring->Avail.Ring[NextAvailIdx++ % Ring->QueueSize] =
+      HeadDescIdx[Chain] % Ring->QueueSize;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
+  //
+  MemoryFence ();
+  *Ring->Avail.Idx = NextAvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device -- a single notification
+  // covers all the chains.
+  //
+  MemoryFence ();
+  Status = VirtIo->SetQueueNotify (VirtIo, VirtQueueId);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  // Wait until the host has used all of our chains, with the same polling as
+  // VirtioFlush().
+  //
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (*Ring->Used.Idx != NextAvailIdx) {
+    gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
+
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    MemoryFence ();
+  }
+
+  MemoryFence ();
+
+  if (UsedLen != NULL) {
+    //
+    // The used elements may come in any order; match them to the chains by
+    // head descriptor index.
+    //
+    for (Used = 0; Used < NumChains; Used++) {
+      volatile CONST VRING_USED_ELEM  *UsedElem;
+
+      UsedElem = &Ring->Used.UsedElem[(UINT16)(LastUsedIdx + Used) % Ring->QueueSize];
+      for (Chain = 0; Chain < NumChains; Chain++) {
+        if (UsedElem->Id == HeadDescIdx[Chain] % Ring->QueueSize) {
+          UsedLen[Chain] = UsedElem->Len;
+          break;
+        }
+      }
+
+      ASSERT (Chain < NumChains);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Report the feature bits to the VirtIo 1.0 device that the VirtIo 1.0 driver
@@ -130,6 +130,28 @@ typedef struct {
 #define STUB_FILE_FROM_FILE(FilePointer) \
         CR (FilePointer, STUB_FILE, File, STUB_FILE_SIG)
 
+/**
+  Download the data of a blob in mKernelBlob from fw_cfg, and verify it. The
+  data is downloaded when it is first read rather than at driver start, so
+  that the blobs which are never read cost nothing.
+
+  (Forward declaration.)
+
+  @param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob whose
+                       data is to be filled from fw_cfg.
+
+  @retval EFI_SUCCESS           Blob->Data has been populated and verified, or
+                                it had been already.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory for Blob->Data.
+
+  @return                       Error codes from VerifyBlob().
+**/
+STATIC
+EFI_STATUS
+FetchBlob (
+  IN OUT KERNEL_BLOB  *Blob
+  );
+
 //
 // Protocol member functions for File.
 //
@@ -355,9 +377,10 @@ StubFileRead (
   OUT VOID              *Buffer
   )
 {
-  STUB_FILE          *StubFile;
-  CONST KERNEL_BLOB  *Blob;
-  UINT64             Left;
+  STUB_FILE    *StubFile;
+  KERNEL_BLOB  *Blob;
+  UINT64       Left;
+  EFI_STATUS   Status;
 
   StubFile = STUB_FILE_FROM_FILE (This);
 
@@ -365,8 +388,6 @@ StubFileRead (
   // Scanning the root directory?
   //
   if (StubFile->BlobType == KernelBlobTypeMax) {
-    EFI_STATUS  Status;
-
     if (StubFile->Position == KernelBlobTypeMax) {
       //
       // Scanning complete.
@@ -401,7 +422,12 @@ StubFileRead (
     *BufferSize = (UINTN)Left;
   }
 
-  if (Blob->Data != NULL) {
+  if (*BufferSize > 0) {
+    Status = FetchBlob (Blob);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
     CopyMem (Buffer, Blob->Data + StubFile->Position, *BufferSize);
   }
 
@@ -883,7 +909,8 @@ InitrdLoadFile2 (
   OUT     VOID                      *Buffer     OPTIONAL
   )
 {
-  CONST KERNEL_BLOB  *InitrdBlob = &mKernelBlob[KernelBlobTypeInitrd];
+  KERNEL_BLOB  *InitrdBlob = &mKernelBlob[KernelBlobTypeInitrd];
+  EFI_STATUS   Status;
 
   ASSERT (InitrdBlob->Size > 0);
 
@@ -906,6 +933,11 @@ InitrdLoadFile2 (
     return EFI_BUFFER_TOO_SMALL;
   }
 
+  Status = FetchBlob (InitrdBlob);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   CopyMem (Buffer, InitrdBlob->Data, InitrdBlob->Size);
 
   *BufferSize = InitrdBlob->Size;
@@ -921,30 +953,19 @@ STATIC CONST EFI_LOAD_FILE2_PROTOCOL  mInitrdLoadFile2 = {
 //
 
 /**
-  Populate a blob in mKernelBlob.
+  Read the size of a blob in mKernelBlob from fw_cfg.
 
-  param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob that is
-                      to be filled from fw_cfg.
-
-  @retval EFI_SUCCESS           Blob has been populated. If fw_cfg reported a
-                                size of zero for the blob, then Blob->Data has
-                                been left unchanged.
-
-  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory for Blob->Data.
+  @param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob whose
+                       size is to be filled from fw_cfg.
 **/
 STATIC
-EFI_STATUS
-FetchBlob (
+VOID
+FetchBlobSize (
   IN OUT KERNEL_BLOB  *Blob
   )
 {
-  UINT32  Left;
-  UINTN   Idx;
-  UINT8   *ChunkData;
+  UINTN  Idx;
 
-  //
-  // Read blob size.
-  //
   Blob->Size = 0;
   for (Idx = 0; Idx < ARRAY_SIZE (Blob->FwCfgItem); Idx++) {
     if (Blob->FwCfgItem[Idx].SizeKey == 0) {
@@ -955,8 +976,34 @@ FetchBlob (
     Blob->FwCfgItem[Idx].Size = QemuFwCfgRead32 ();
     Blob->Size               += Blob->FwCfgItem[Idx].Size;
   }
+}
+
+/**
+  Download the data of a blob in mKernelBlob from fw_cfg, and verify it. The
+  data is downloaded when it is first read rather than at driver start, so
+  that the blobs which are never read cost nothing.
+
+  @param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob whose
+                       data is to be filled from fw_cfg.
+
+  @retval EFI_SUCCESS           Blob->Data has been populated and verified, or
+                                it had been already.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory for Blob->Data.
+
+  @return                       Error codes from VerifyBlob().
+**/
+STATIC
+EFI_STATUS
+FetchBlob (
+  IN OUT KERNEL_BLOB  *Blob
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Left;
+  UINTN       Idx;
+  UINT8       *ChunkData;
 
-  if (Blob->Size == 0) {
+  if ((Blob->Data != NULL) || (Blob->Size == 0)) {
     return EFI_SUCCESS;
   }
 
@@ -1011,7 +1058,16 @@ FetchBlob (
     ChunkData += Blob->FwCfgItem[Idx].Size;
   }
 
-  return EFI_SUCCESS;
+  //
+  // Never serve data which failed verification.
+  //
+  Status = VerifyBlob (Blob->Name, Blob->Data, Blob->Size);
+  if (EFI_ERROR (Status)) {
+    FreePool (Blob->Data);
+    Blob->Data = NULL;
+  }
+
+  return Status;
 }
 
 //
@@ -1019,9 +1075,9 @@ FetchBlob (
 //
 
 /**
-  Download the kernel, the initial ramdisk, and the kernel command line from
+  Look up the kernel, the initial ramdisk, and the kernel command line in
   QEMU's fw_cfg. Construct a minimal SimpleFileSystem that contains the two
-  image files.
+  image files. The files are downloaded when they are first read.
 
   @retval EFI_NOT_FOUND         Kernel image was not found.
   @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
@@ -1056,22 +1112,17 @@ QemuKernelLoaderFsDxeEntrypoint (
   }
 
   //
-  // Fetch all blobs.
+  // Fetch the sizes of all blobs. The data is fetched and verified by
+  // FetchBlob() on first read; the empty blobs are verified right away.
   //
   for (BlobType = 0; BlobType < KernelBlobTypeMax; ++BlobType) {
     CurrentBlob = &mKernelBlob[BlobType];
-    Status      = FetchBlob (CurrentBlob);
-    if (EFI_ERROR (Status)) {
-      goto FreeBlobs;
-    }
-
-    Status = VerifyBlob (
-               CurrentBlob->Name,
-               CurrentBlob->Data,
-               CurrentBlob->Size
-               );
-    if (EFI_ERROR (Status)) {
-      goto FreeBlobs;
+    FetchBlobSize (CurrentBlob);
+    if (CurrentBlob->Size == 0) {
+      Status = VerifyBlob (CurrentBlob->Name, NULL, 0);
+      if (EFI_ERROR (Status)) {
+        goto FreeBlobs;
+      }
     }
 
     mTotalBlobBytes += CurrentBlob->Size;
@@ -1079,7 +1130,7 @@ QemuKernelLoaderFsDxeEntrypoint (
 
   KernelBlob = &mKernelBlob[KernelBlobTypeKernel];
 
-  if (KernelBlob->Data == NULL) {
+  if (KernelBlob->Size == 0) {
     Status = EFI_NOT_FOUND;
     goto FreeBlobs;
   }
@@ -7,6 +7,7 @@
     - Sets max logical cpus based on TDINFO
     - Sets PCI PCDs based on resource hobs
     - Alter MATD table to record address of Mailbox
+    - Install the memory accept protocol for the unaccepted memory
 
   Copyright (c) 2020 - 2021, Intel Corporation. All rights reserved.<BR>
 
@@ -23,6 +24,7 @@
 #include <Library/UefiLib.h>
 #include <Library/HobLib.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MemoryAccept.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <ConfidentialComputingGuestAttr.h>
 #include <IndustryStandard/Tdx.h>
@@ -208,6 +210,65 @@ SetMmioSharedBit (
   return EFI_SUCCESS;
 }
 
+/**
+  Accept a range of the unaccepted memory of the Td guest.
+
+  The range is accepted with the page size of PcdTdxAcceptPageSize, the
+  unaligned head and tail of it are accepted in 4K pages.
+
+  @param[in]  This              A pointer to the EDKII_MEMORY_ACCEPT_PROTOCOL instance.
+  @param[in]  StartAddress      The start address of the memory range, page aligned.
+  @param[in]  Size              The size in bytes of the memory range, page aligned.
+
+  @retval EFI_SUCCESS           The memory range has been accepted.
+  @retval EFI_INVALID_PARAMETER StartAddress or Size is not page aligned.
+  @retval Others                The memory range could not be accepted.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TdxAcceptMemory (
+  IN EDKII_MEMORY_ACCEPT_PROTOCOL  *This,
+  IN EFI_PHYSICAL_ADDRESS          StartAddress,
+  IN UINTN                         Size
+  )
+{
+  EFI_STATUS            Status;
+  UINT32                AcceptPageSize;
+  EFI_PHYSICAL_ADDRESS  EndAddress;
+  EFI_PHYSICAL_ADDRESS  AlignedStart;
+  EFI_PHYSICAL_ADDRESS  AlignedEnd;
+
+  if (((StartAddress & EFI_PAGE_MASK) != 0) || ((Size & EFI_PAGE_MASK) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  AcceptPageSize = FixedPcdGet32 (PcdTdxAcceptPageSize);
+  EndAddress     = StartAddress + Size;
+  AlignedStart   = ALIGN_VALUE (StartAddress, AcceptPageSize);
+  AlignedEnd     = EndAddress & ~(UINT64)(AcceptPageSize - 1);
+
+  if (AlignedStart >= AlignedEnd) {
+    return TdAcceptPages (StartAddress, EFI_SIZE_TO_PAGES (Size), SIZE_4KB);
+  }
+
+  Status = TdAcceptPages (StartAddress, EFI_SIZE_TO_PAGES ((UINTN)(AlignedStart - StartAddress)), SIZE_4KB);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = TdAcceptPages (AlignedStart, DivU64x32 (AlignedEnd - AlignedStart, AcceptPageSize), AcceptPageSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return TdAcceptPages (AlignedEnd, EFI_SIZE_TO_PAGES ((UINTN)(EndAddress - AlignedEnd)), SIZE_4KB);
+}
+
+STATIC EDKII_MEMORY_ACCEPT_PROTOCOL  mMemoryAcceptProtocol = {
+  TdxAcceptMemory
+};
+
 EFI_STATUS
 EFIAPI
 TdxDxeEntryPoint (
@@ -257,6 +318,18 @@ TdxDxeEntryPoint (
 
   SetMmioSharedBit ();
 
+  //
+  // The memory above PcdTdxAcceptMemoryLimit is not accepted in SEC. The DXE
+  // Core accepts it with the protocol when the accepted memory runs out.
+  //
+  Status = gBS->InstallProtocolInterface (
+                  &ImageHandle,
+                  &gEdkiiMemoryAcceptProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  &mMemoryAcceptProtocol
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   //
   // Call TDINFO to get actual number of cpus in domain
   //
@@ -1,14 +1,16 @@
 /** @file
 
-  This driver produces Block I/O Protocol instances for virtio-blk devices.
+  This driver produces Block I/O and Block I/O 2 Protocol instances for
+  virtio-blk devices.
 
   The implementation is basic:
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - EFI_BLOCK_IO_PROTOCOL requests are synchronous. The non-blocking
+    interfaces of EFI_BLOCK_IO2_PROTOCOL keep multiple virtio-blk requests in
+    flight, in fixed descriptor slots, and are completed by polling the used
+    ring from a timer event, since interrupts are not used.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -28,6 +30,13 @@
 
 #include "VirtioBlk.h"
 
+//
+// Period of the timer polling for completed asynchronous requests, and the
+// delay between polls while waiting for them to drain.
+//
+#define VBLK_ASYNC_POLL_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS (1)
+#define VBLK_ASYNC_DRAIN_STALL    10
+
 /**
 
   Convenience macros to read and write region 0 IO space elements of the
@@ -358,19 +367,19 @@ SynchronousRequest (
     goto UnmapDataBuffer;
   }
 
-  VirtioPrepare (&Dev->Ring, &Indices);
+  VirtioPrepare (&Dev->Ring[0], &Indices);
 
   //
   // ensured by VirtioBlkInit() -- this predicate, in combination with the
   // lock-step progress, ensures we don't have to track free descriptors.
   //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  ASSERT (Dev->Ring[0].QueueSize >= 3);
 
   //
   // virtio-blk header in first desc
   //
   VirtioAppendDesc (
-    &Dev->Ring,
+    &Dev->Ring[0],
     RequestDeviceAddress,
     sizeof Request,
     VRING_DESC_F_NEXT,
@@ -395,7 +404,7 @@ SynchronousRequest (
     // VRING_DESC_F_WRITE is interpreted from the host's point of view.
     //
     VirtioAppendDesc (
-      &Dev->Ring,
+      &Dev->Ring[0],
       BufferDeviceAddress,
       (UINT32)BufferSize,
       VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
@@ -407,7 +416,7 @@ SynchronousRequest (
   // host status in last (second or third) desc
   //
   VirtioAppendDesc (
-    &Dev->Ring,
+    &Dev->Ring[0],
     HostStatusDeviceAddress,
     sizeof *HostStatus,
     VRING_DESC_F_WRITE,
@@ -420,7 +429,7 @@ SynchronousRequest (
   if ((VirtioFlush (
          Dev->VirtIo,
          0,
-         &Dev->Ring,
+         &Dev->Ring[0],
          &Indices,
          NULL
          ) == EFI_SUCCESS) &&
@@ -457,6 +466,453 @@ FreeHostStatusBuffer:
   return Status;
 }
 
+/**
+
+  Submit an asynchronous (Block I/O 2) request to the device, in a free slot.
+
+  The request header and the host status byte are taken from the slot's
+  element of Dev->AsyncShared, which is mapped once, as a common buffer, by
+  VirtioBlkAsyncInit(). The data buffer (if any) is mapped here, and unmapped
+  by CompleteAsyncRequest().
+
+  The descriptor chain occupies the VBLK_DESC_PER_SLOT descriptors that belong
+  to Slot in its request queue, hence different slots never compete for
+  descriptors, and we don't have to track free descriptors.
+
+  Must be called at TPL_CALLBACK.
+
+  @param[in,out] Dev   The virtio-blk device the request is targeted at.
+
+  @param[in,out] Req   The request to submit; previously verified by
+                       VerifyReadWriteRequest() (for read/write only).
+
+  @param[in] Slot      The index of the free slot to place the request in.
+
+
+  @retval EFI_SUCCESS       The request is now in flight.
+
+  @retval EFI_DEVICE_ERROR  Failed to map the data buffer for a bus master
+                            operation.
+
+**/
+STATIC
+EFI_STATUS
+SubmitAsyncRequest (
+  IN OUT VBLK_DEV        *Dev,
+  IN OUT VBLK_ASYNC_REQ  *Req,
+  IN     UINT16          Slot
+  )
+{
+  VBLK_ASYNC_SHARED     *Shared;
+  EFI_PHYSICAL_ADDRESS  SharedDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  DESC_INDICES          Indices;
+  UINT16                Queue;
+  VRING                 *Ring;
+  UINT16                AvailIdx;
+  EFI_STATUS            Status;
+
+  ASSERT (Slot < Dev->AsyncSlots);
+  ASSERT (Dev->InFlight[Slot] == NULL);
+
+  Queue = Slot % Dev->NumQueues;
+  Ring  = &Dev->Ring[Queue];
+
+  Shared              = &Dev->AsyncShared[Slot];
+  SharedDeviceAddress = Dev->AsyncSharedAddr + Slot * sizeof *Shared;
+  BufferDeviceAddress = 0;
+
+  if (Req->BufferSize > 0) {
+    Status = VirtioMapAllBytesInSharedBuffer (
+               Dev->VirtIo,
+               (Req->RequestIsWrite ?
+                VirtioOperationBusMasterRead :
+                VirtioOperationBusMasterWrite),
+               Req->Buffer,
+               Req->BufferSize,
+               &BufferDeviceAddress,
+               &Req->BufferMapping
+               );
+    if (EFI_ERROR (Status)) {
+      Req->BufferMapping = NULL;
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  //
+  // Same request header as in SynchronousRequest(); preset a host status that
+  // we do not accept as success.
+  //
+  Shared->Request.Type = Req->RequestIsWrite ?
+                         (Req->BufferSize == 0 ?
+                          VIRTIO_BLK_T_FLUSH :
+                          VIRTIO_BLK_T_OUT) :
+                         VIRTIO_BLK_T_IN;
+  Shared->Request.IoPrio = 0;
+  Shared->Request.Sector = MultU64x32 (
+                             Req->Lba,
+                             Dev->BlockIoMedia.BlockSize / 512
+                             );
+  Shared->HostStatus = VIRTIO_BLK_S_IOERR;
+
+  //
+  // Build the descriptor chain in the slot's own descriptors, rather than at
+  // the start of the descriptor table, where VirtioPrepare() would put it.
+  //
+  VirtioPrepare (Ring, &Indices);
+  Indices.HeadDescIdx = (UINT16)(Slot / Dev->NumQueues * VBLK_DESC_PER_SLOT);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
+
+  VirtioAppendDesc (
+    Ring,
+    SharedDeviceAddress + OFFSET_OF (VBLK_ASYNC_SHARED, Request),
+    sizeof Shared->Request,
+    VRING_DESC_F_NEXT,
+    &Indices
+    );
+
+  if (Req->BufferSize > 0) {
+    //
+    // ensured by VerifyReadWriteRequest()
+    //
+    ASSERT (Req->BufferSize <= SIZE_1GB);
+
+    VirtioAppendDesc (
+      Ring,
+      BufferDeviceAddress,
+      (UINT32)Req->BufferSize,
+      VRING_DESC_F_NEXT | (Req->RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
+      &Indices
+      );
+  }
+
+  VirtioAppendDesc (
+    Ring,
+    SharedDeviceAddress + OFFSET_OF (VBLK_ASYNC_SHARED, HostStatus),
+    sizeof Shared->HostStatus,
+    VRING_DESC_F_WRITE,
+    &Indices
+    );
+
+  //
+  // With nothing in flight in this queue, the device has consumed everything
+  // that was ever made available to it -- including the requests of
+  // SynchronousRequest(), which bypasses our used ring tracking.
+  //
+  if (Dev->QueueInFlight[Queue] == 0) {
+    Dev->LastUsedIdx[Queue] = *Ring->Used.Idx;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field
+  //
+  AvailIdx                                     = *Ring->Avail.Idx;
+  Ring->Avail.Ring[AvailIdx % Ring->QueueSize] = Indices.HeadDescIdx;
+  MemoryFence ();
+  *Ring->Avail.Idx = (UINT16)(AvailIdx + 1);
+  MemoryFence ();
+
+  Dev->InFlight[Slot] = Req;
+  Dev->InFlightCount++;
+  Dev->QueueInFlight[Queue]++;
+
+  //
+  // A failed notification is not fatal here: the request is on the available
+  // ring already, and the device will find it at the next successful
+  // notification.
+  //
+  Dev->VirtIo->SetQueueNotify (Dev->VirtIo, Queue);
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Release the resources of an asynchronous request, and report its outcome to
+  the caller through the Block I/O 2 token.
+
+  @param[in,out] Dev     The virtio-blk device the request was targeted at.
+
+  @param[in] Req         The request to complete. It is freed, and must not
+                         be linked into any list, or referenced from
+                         Dev->InFlight.
+
+  @param[in] Status      The transaction status to report.
+
+**/
+STATIC
+VOID
+CompleteAsyncRequest (
+  IN OUT VBLK_DEV        *Dev,
+  IN     VBLK_ASYNC_REQ  *Req,
+  IN     EFI_STATUS      Status
+  )
+{
+  EFI_STATUS  UnmapStatus;
+
+  if (Req->BufferMapping != NULL) {
+    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (
+                                 Dev->VirtIo,
+                                 Req->BufferMapping
+                                 );
+    if (EFI_ERROR (UnmapStatus) && !Req->RequestIsWrite && !EFI_ERROR (Status)) {
+      //
+      // Data from the bus master may not reach the caller; fail the request.
+      //
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  Req->Token->TransactionStatus = Status;
+  gBS->SignalEvent (Req->Token->Event);
+  FreePool (Req);
+}
+
+/**
+
+  Reap the asynchronous requests that the device has completed, then move as
+  many pending requests into free slots as possible.
+
+  The poll timer is armed while there is any asynchronous work outstanding,
+  and cancelled otherwise.
+
+  Must be called at TPL_CALLBACK.
+
+  @param[in,out] Dev  The virtio-blk device to poll.
+
+**/
+STATIC
+VOID
+VirtioBlkAsyncPoll (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  UINT16          Queue;
+  VRING           *Ring;
+  UINT16          Slot;
+  VBLK_ASYNC_REQ  *Req;
+  EFI_STATUS      Status;
+  BOOLEAN         Busy;
+
+  for (Queue = 0; Queue < Dev->NumQueues; Queue++) {
+    Ring = &Dev->Ring[Queue];
+
+    while (Dev->QueueInFlight[Queue] > 0 &&
+           *Ring->Used.Idx != Dev->LastUsedIdx[Queue])
+    {
+      //
+      // Read the used element (and the host status it stands for) only after
+      // having seen the used ring index advance.
+      //
+      MemoryFence ();
+      Slot = (UINT16)(Ring->Used.UsedElem[Dev->LastUsedIdx[Queue] %
+                                          Ring->QueueSize].Id /
+                      VBLK_DESC_PER_SLOT * Dev->NumQueues + Queue);
+      Dev->LastUsedIdx[Queue]++;
+
+      ASSERT (Slot < Dev->AsyncSlots);
+      Req = Dev->InFlight[Slot];
+      ASSERT (Req != NULL);
+      Dev->InFlight[Slot] = NULL;
+      Dev->InFlightCount--;
+      Dev->QueueInFlight[Queue]--;
+
+      CompleteAsyncRequest (
+        Dev,
+        Req,
+        (Dev->AsyncShared[Slot].HostStatus == VIRTIO_BLK_S_OK ?
+         EFI_SUCCESS :
+         EFI_DEVICE_ERROR)
+        );
+    }
+  }
+
+  Slot = 0;
+  while (!IsListEmpty (&Dev->PendingRequests)) {
+    Req = VBLK_ASYNC_REQ_FROM_LINK (GetFirstNode (&Dev->PendingRequests));
+
+    //
+    // A flush request only covers the writes that the device has completed
+    // before. Keep it (and everything queued after it) waiting until the
+    // requests submitted earlier have been reaped.
+    //
+    if ((Req->BufferSize == 0) && (Dev->InFlightCount > 0)) {
+      break;
+    }
+
+    while (Slot < Dev->AsyncSlots && Dev->InFlight[Slot] != NULL) {
+      Slot++;
+    }
+
+    if (Slot == Dev->AsyncSlots) {
+      break;
+    }
+
+    RemoveEntryList (&Req->Link);
+    Status = SubmitAsyncRequest (Dev, Req, Slot);
+    if (EFI_ERROR (Status)) {
+      CompleteAsyncRequest (Dev, Req, Status);
+    }
+  }
+
+  Busy = (BOOLEAN)(Dev->InFlightCount > 0 ||
+                   !IsListEmpty (&Dev->PendingRequests));
+  if (Busy != Dev->AsyncTimerArmed) {
+    gBS->SetTimer (
+           Dev->AsyncTimer,
+           Busy ? TimerPeriodic : TimerCancel,
+           VBLK_ASYNC_POLL_INTERVAL
+           );
+    Dev->AsyncTimerArmed = Busy;
+  }
+}
+
+/**
+
+  Timer notification function polling the virtio-blk device for completed
+  asynchronous requests.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkAsyncTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VirtioBlkAsyncPoll (Context);
+}
+
+/**
+
+  Wait until all asynchronous requests, in flight or pending, complete.
+
+  Optionally, the pending requests (those that have not been submitted to the
+  device yet) are aborted first.
+
+  Must be called at TPL_CALLBACK.
+
+  @param[in,out] Dev           The virtio-blk device to drain.
+
+  @param[in] AbortPending      If TRUE, complete the pending requests with
+                               EFI_ABORTED, rather than submitting them.
+
+**/
+STATIC
+VOID
+VirtioBlkAsyncDrain (
+  IN OUT VBLK_DEV  *Dev,
+  IN     BOOLEAN   AbortPending
+  )
+{
+  VBLK_ASYNC_REQ  *Req;
+
+  while (AbortPending && !IsListEmpty (&Dev->PendingRequests)) {
+    Req = VBLK_ASYNC_REQ_FROM_LINK (GetFirstNode (&Dev->PendingRequests));
+    RemoveEntryList (&Req->Link);
+    CompleteAsyncRequest (Dev, Req, EFI_ABORTED);
+  }
+
+  for ( ; ;) {
+    VirtioBlkAsyncPoll (Dev);
+    if ((Dev->InFlightCount == 0) && IsListEmpty (&Dev->PendingRequests)) {
+      break;
+    }
+
+    gBS->Stall (VBLK_ASYNC_DRAIN_STALL);
+  }
+}
+
+/**
+
+  Queue an asynchronous (Block I/O 2) request, and kick off the processing of
+  the queue.
+
+  @param[in,out] Dev       The virtio-blk device the request is targeted at.
+
+  @param[in,out] Token     The Block I/O 2 token to complete the request
+                           through. Token->Event is not NULL.
+
+  For the rest of the parameters, see SynchronousRequest().
+
+
+  @retval EFI_SUCCESS           The request has been queued. Its outcome will
+                                be reported through Token.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+QueueAsyncRequest (
+  IN OUT VBLK_DEV             *Dev,
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token,
+  IN     EFI_LBA              Lba,
+  IN     UINTN                BufferSize,
+  IN OUT VOID                 *Buffer,
+  IN     BOOLEAN              RequestIsWrite
+  )
+{
+  VBLK_ASYNC_REQ  *Req;
+  EFI_TPL         OldTpl;
+
+  Req = AllocateZeroPool (sizeof *Req);
+  if (Req == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Req->Signature      = VBLK_ASYNC_REQ_SIG;
+  Req->Token          = Token;
+  Req->Lba            = Lba;
+  Req->BufferSize     = BufferSize;
+  Req->Buffer         = Buffer;
+  Req->RequestIsWrite = RequestIsWrite;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&Dev->PendingRequests, &Req->Link);
+  VirtioBlkAsyncPoll (Dev);
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Perform a blocking request, after waiting for the asynchronous requests
+  queued earlier to complete.
+
+  SynchronousRequest() drives the virtio ring in lock-step, therefore it must
+  not overlap with asynchronous requests.
+
+  For the parameters and the return values, see SynchronousRequest().
+
+**/
+STATIC
+EFI_STATUS
+BlockingRequest (
+  IN              VBLK_DEV  *Dev,
+  IN              EFI_LBA   Lba,
+  IN              UINTN     BufferSize,
+  IN OUT volatile VOID      *Buffer,
+  IN              BOOLEAN   RequestIsWrite
+  )
+{
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  VirtioBlkAsyncDrain (Dev, FALSE);
+  Status = SynchronousRequest (Dev, Lba, BufferSize, Buffer, RequestIsWrite);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
 /**
 
   ReadBlocks() operation for virtio-blk.
@@ -502,7 +958,7 @@ VirtioBlkReadBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return BlockingRequest (
            Dev,
            Lba,
            BufferSize,
@@ -556,7 +1012,7 @@ VirtioBlkWriteBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return BlockingRequest (
            Dev,
            Lba,
            BufferSize,
@@ -591,7 +1047,7 @@ VirtioBlkFlushBlocks (
 
   Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
   return Dev->BlockIoMedia.WriteCaching ?
-         SynchronousRequest (
+         BlockingRequest (
            Dev,
            0,      // Lba
            0,      // BufferSize
@@ -601,54 +1057,265 @@ VirtioBlkFlushBlocks (
          EFI_SUCCESS;
 }
 
-/**
-
-  Device probe function for this driver.
-
-  The DXE core calls this function for any given device in order to see if the
-  driver can drive the device.
-
-  Specs relevant in the general sense:
+//
+// UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol
+// Driver Writer's Guide for UEFI 2.3.1 v1.01,
+//   24.2 Block I/O Protocol Implementations
+//
 
-  - UEFI Spec 2.3.1 + Errata C:
-    - 6.3 Protocol Handler Services -- for accessing the underlying device
-    - 10.1 EFI Driver Binding Protocol -- for exporting ourselves
+/**
 
-  - Driver Writer's Guide for UEFI 2.3.1 v1.01:
-    - 5.1.3.4 OpenProtocol() and CloseProtocol() -- for accessing the
-      underlying device
-    - 9 Driver Binding Protocol -- for exporting ourselves
+  ResetEx() operation for virtio-blk.
 
-  @param[in]  This                The EFI_DRIVER_BINDING_PROTOCOL object
-                                  incorporating this driver (independently of
-                                  any device).
+  Requests that have not been submitted to the device yet are aborted; the
+  function waits for the requests in flight to complete.
 
-  @param[in] DeviceHandle         The device to probe.
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  VBLK_DEV  *Dev;
+  EFI_TPL   OldTpl;
 
-  @param[in] RemainingDevicePath  Relevant only for bus drivers, ignored.
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  VirtioBlkAsyncDrain (Dev, TRUE);
+  gBS->RestoreTPL (OldTpl);
 
+  return EFI_SUCCESS;
+}
 
-  @retval EFI_SUCCESS      The driver supports the device being probed.
+/**
 
-  @retval EFI_UNSUPPORTED  Based on virtio-blk discovery, we do not support
-                           the device.
+  Common code for ReadBlocksEx() and WriteBlocksEx().
 
-  @return                  Error codes from the OpenProtocol() boot service or
-                           the VirtIo protocol.
+  If Token is NULL, or Token->Event is NULL, the request is performed as a
+  blocking one, like with ReadBlocks() / WriteBlocks(). Otherwise the request
+  is queued, and its outcome is reported through Token.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-VirtioBlkDriverBindingSupported (
-  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
-  IN EFI_HANDLE                   DeviceHandle,
-  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+ReadWriteBlocksEx (
+  IN     VBLK_DEV             *Dev,
+  IN     EFI_LBA              Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token,
+  IN     UINTN                BufferSize,
+  IN OUT VOID                 *Buffer,
+  IN     BOOLEAN              RequestIsWrite
   )
 {
-  EFI_STATUS              Status;
-  VIRTIO_DEVICE_PROTOCOL  *VirtIo;
+  EFI_STATUS  Status;
+  BOOLEAN     Blocking;
 
-  //
+  Blocking = (BOOLEAN)(Token == NULL || Token->Event == NULL);
+
+  if (BufferSize == 0) {
+    if (!Blocking) {
+      Token->TransactionStatus = EFI_SUCCESS;
+      gBS->SignalEvent (Token->Event);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Blocking) {
+    return BlockingRequest (Dev, Lba, BufferSize, Buffer, RequestIsWrite);
+  }
+
+  return QueueAsyncRequest (
+           Dev,
+           Token,
+           Lba,
+           BufferSize,
+           Buffer,
+           RequestIsWrite
+           );
+}
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
+    ReadBlocksEx() Implementation.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  return ReadWriteBlocksEx (
+           VIRTIO_BLK_FROM_BLOCK_IO2 (This),
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           FALSE                              // RequestIsWrite
+           );
+}
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
+    WriteBlockEx() Implementation.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  return ReadWriteBlocksEx (
+           VIRTIO_BLK_FROM_BLOCK_IO2 (This),
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           TRUE                               // RequestIsWrite
+           );
+}
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
+    FlushBlocksEx() Implementation.
+
+  An asynchronous flush is submitted to the device only after the requests
+  queued before it have completed; see VirtioBlkAsyncPoll(). Without
+  write-caching, we do nothing, successfully, as in FlushBlocks().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  VBLK_DEV  *Dev;
+  BOOLEAN   Blocking;
+
+  Dev      = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  Blocking = (BOOLEAN)(Token == NULL || Token->Event == NULL);
+
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    if (!Blocking) {
+      Token->TransactionStatus = EFI_SUCCESS;
+      gBS->SignalEvent (Token->Event);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if (Blocking) {
+    return BlockingRequest (
+             Dev,
+             0,      // Lba
+             0,      // BufferSize
+             NULL,   // Buffer
+             TRUE    // RequestIsWrite
+             );
+  }
+
+  return QueueAsyncRequest (
+           Dev,
+           Token,
+           0,      // Lba
+           0,      // BufferSize
+           NULL,   // Buffer
+           TRUE    // RequestIsWrite
+           );
+}
+
+/**
+
+  Device probe function for this driver.
+
+  The DXE core calls this function for any given device in order to see if the
+  driver can drive the device.
+
+  Specs relevant in the general sense:
+
+  - UEFI Spec 2.3.1 + Errata C:
+    - 6.3 Protocol Handler Services -- for accessing the underlying device
+    - 10.1 EFI Driver Binding Protocol -- for exporting ourselves
+
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01:
+    - 5.1.3.4 OpenProtocol() and CloseProtocol() -- for accessing the
+      underlying device
+    - 9 Driver Binding Protocol -- for exporting ourselves
+
+  @param[in]  This                The EFI_DRIVER_BINDING_PROTOCOL object
+                                  incorporating this driver (independently of
+                                  any device).
+
+  @param[in] DeviceHandle         The device to probe.
+
+  @param[in] RemainingDevicePath  Relevant only for bus drivers, ignored.
+
+
+  @retval EFI_SUCCESS      The driver supports the device being probed.
+
+  @retval EFI_UNSUPPORTED  Based on virtio-blk discovery, we do not support
+                           the device.
+
+  @return                  Error codes from the OpenProtocol() boot service or
+                           the VirtIo protocol.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkDriverBindingSupported (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   DeviceHandle,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  )
+{
+  EFI_STATUS              Status;
+  VIRTIO_DEVICE_PROTOCOL  *VirtIo;
+
+  //
   // Attempt to open the device with the VirtIo set of interfaces. On success,
   // the protocol is "instantiated" for the VirtIo device. Covers duplicate
   // open attempts (EFI_ALREADY_STARTED).
@@ -684,6 +1351,104 @@ VirtioBlkDriverBindingSupported (
   return Status;
 }
 
+/**
+
+  Set up one request queue of a virtio-blk device, as part of VirtioBlkInit().
+
+  @param[in out] Dev         The driver instance being configured.
+
+  @param[in] QueueIndex      The index of the request queue to set up.
+
+  @retval EFI_SUCCESS      The queue has been allocated, mapped, and reported
+                           to the device.
+
+  @retval EFI_UNSUPPORTED  The queue is too small.
+
+  @return                  Error codes from VirtioRingInit(), VirtioRingMap(),
+                           or the VirtIo protocol.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkInitQueue (
+  IN OUT VBLK_DEV  *Dev,
+  IN     UINT16    QueueIndex
+  )
+{
+  EFI_STATUS  Status;
+  UINT16      QueueSize;
+  UINT64      RingBaseShift;
+
+  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, QueueIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (QueueSize < 3) {
+    // SynchronousRequest() uses at most three descriptors
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring[QueueIndex]);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // If anything fails from here on, we must release the ring resources
+  //
+  Status = VirtioRingMap (
+             Dev->VirtIo,
+             &Dev->Ring[QueueIndex],
+             &RingBaseShift,
+             &Dev->RingMap[QueueIndex]
+             );
+  if (EFI_ERROR (Status)) {
+    goto ReleaseQueue;
+  }
+
+  //
+  // Additional steps for MMIO: align the queue appropriately, and set the
+  // size. If anything fails from here on, we must unmap the ring resources.
+  //
+  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  //
+  // Report GPFN (guest-physical frame number) of queue.
+  //
+  Status = Dev->VirtIo->SetQueueAddress (
+                          Dev->VirtIo,
+                          &Dev->Ring[QueueIndex],
+                          RingBaseShift
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  return EFI_SUCCESS;
+
+UnmapQueue:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap[QueueIndex]);
+
+ReleaseQueue:
+  VirtioRingUninit (Dev->VirtIo, &Dev->Ring[QueueIndex]);
+
+  return Status;
+}
+
 /**
 
   Set up all BlockIo and virtio-blk aspects of this driver for the specified
@@ -719,8 +1484,8 @@ VirtioBlkInit (
   UINT8   PhysicalBlockExp;
   UINT8   AlignmentOffset;
   UINT32  OptIoSize;
-  UINT16  QueueSize;
-  UINT64  RingBaseShift;
+  UINT16  NumQueues;
+  UINT16  QueueIndex;
 
   PhysicalBlockExp = 0;
   AlignmentOffset  = 0;
@@ -819,82 +1584,50 @@ VirtioBlkInit (
     }
   }
 
-  Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
-
-  //
-  // In virtio-1.0, feature negotiation is expected to complete before queue
-  // discovery, and the device can also reject the selected set of features.
-  //
-  if (Dev->VirtIo->Revision >= VIRTIO_SPEC_REVISION (1, 0, 0)) {
-    Status = Virtio10WriteFeatures (Dev->VirtIo, Features, &NextDevStat);
+  NumQueues = 1;
+  if (Features & VIRTIO_BLK_F_MQ) {
+    Status = VIRTIO_CFG_READ (Dev, NumQueues, &NumQueues);
     if (EFI_ERROR (Status)) {
       goto Failed;
     }
-  }
 
-  //
-  // step 4b -- allocate virtqueue
-  //
-  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, 0);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
+    if (NumQueues == 0) {
+      Status = EFI_UNSUPPORTED;
+      goto Failed;
+    }
 
-  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
+    NumQueues = MIN (NumQueues, VBLK_MAX_QUEUES);
   }
 
-  if (QueueSize < 3) {
-    // SynchronousRequest() uses at most three descriptors
-    Status = EFI_UNSUPPORTED;
-    goto Failed;
+  if (NumQueues == 1) {
+    Features &= ~(UINT64)VIRTIO_BLK_F_MQ;
   }
 
-  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
+  Dev->NumQueues = NumQueues;
 
-  //
-  // If anything fails from here on, we must release the ring resources
-  //
-  Status = VirtioRingMap (
-             Dev->VirtIo,
-             &Dev->Ring,
-             &RingBaseShift,
-             &Dev->RingMap
-             );
-  if (EFI_ERROR (Status)) {
-    goto ReleaseQueue;
-  }
+  Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
+              VIRTIO_BLK_F_FLUSH | VIRTIO_BLK_F_MQ | VIRTIO_F_VERSION_1 |
+              VIRTIO_F_IOMMU_PLATFORM;
 
   //
-  // Additional steps for MMIO: align the queue appropriately, and set the
-  // size. If anything fails from here on, we must unmap the ring resources.
+  // In virtio-1.0, feature negotiation is expected to complete before queue
+  // discovery, and the device can also reject the selected set of features.
   //
-  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
-  }
-
-  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+  if (Dev->VirtIo->Revision >= VIRTIO_SPEC_REVISION (1, 0, 0)) {
+    Status = Virtio10WriteFeatures (Dev->VirtIo, Features, &NextDevStat);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
   }
 
   //
-  // step 4c -- Report GPFN (guest-physical frame number) of queue.
+  // step 4b -- allocate virtqueues, step 4c -- report their addresses
   //
-  Status = Dev->VirtIo->SetQueueAddress (
-                          Dev->VirtIo,
-                          &Dev->Ring,
-                          RingBaseShift
-                          );
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+  for (QueueIndex = 0; QueueIndex < Dev->NumQueues; QueueIndex++) {
+    Status = VirtioBlkInitQueue (Dev, QueueIndex);
+    if (EFI_ERROR (Status)) {
+      goto ReleaseQueues;
+    }
   }
 
   //
@@ -904,7 +1637,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto ReleaseQueues;
     }
   }
 
@@ -914,7 +1647,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto ReleaseQueues;
   }
 
   //
@@ -927,6 +1660,11 @@ VirtioBlkInit (
   Dev->BlockIo.ReadBlocks            = &VirtioBlkReadBlocks;
   Dev->BlockIo.WriteBlocks           = &VirtioBlkWriteBlocks;
   Dev->BlockIo.FlushBlocks           = &VirtioBlkFlushBlocks;
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
   Dev->BlockIoMedia.MediaId          = 0;
   Dev->BlockIoMedia.RemovableMedia   = FALSE;
   Dev->BlockIoMedia.MediaPresent     = TRUE;
@@ -972,11 +1710,12 @@ VirtioBlkInit (
 
   return EFI_SUCCESS;
 
-UnmapQueue:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-
-ReleaseQueue:
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+ReleaseQueues:
+  while (QueueIndex > 0) {
+    --QueueIndex;
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap[QueueIndex]);
+    VirtioRingUninit (Dev->VirtIo, &Dev->Ring[QueueIndex]);
+  }
 
 Failed:
   //
@@ -1004,6 +1743,8 @@ VirtioBlkUninit (
   IN OUT VBLK_DEV  *Dev
   )
 {
+  UINT16  QueueIndex;
+
   //
   // Reset the virtual device -- see virtio-0.9.5, 2.2.2.1 Device Status. When
   // VIRTIO_CFG_WRITE() returns, the host will have learned to stay away from
@@ -1011,13 +1752,139 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+  for (QueueIndex = 0; QueueIndex < Dev->NumQueues; QueueIndex++) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap[QueueIndex]);
+    VirtioRingUninit (Dev->VirtIo, &Dev->Ring[QueueIndex]);
+  }
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
+  SetMem (&Dev->BlockIo2, sizeof Dev->BlockIo2, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
+/**
+
+  Set up the resources for asynchronous (Block I/O 2) requests on a virtio-blk
+  device that has been successfully initialized with VirtioBlkInit().
+
+  @param[in,out] Dev  The device to set up.
+
+
+  @retval EFI_SUCCESS  Setup complete.
+
+  @return              Error codes from the VirtIo protocol, or the
+                       CreateEvent() boot service.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkAsyncInit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Buffer;
+  UINT16      SlotsPerQueue;
+  UINT16      QueueIndex;
+
+  //
+  // Every queue gets the same number of slots; see the interleaving in
+  // SubmitAsyncRequest().
+  //
+  SlotsPerQueue = VBLK_MAX_ASYNC_SLOTS / Dev->NumQueues;
+  for (QueueIndex = 0; QueueIndex < Dev->NumQueues; QueueIndex++) {
+    //
+    // ensured by VirtioBlkInitQueue()
+    //
+    ASSERT (Dev->Ring[QueueIndex].QueueSize >= VBLK_DESC_PER_SLOT);
+
+    SlotsPerQueue = MIN (
+                      SlotsPerQueue,
+                      Dev->Ring[QueueIndex].QueueSize / VBLK_DESC_PER_SLOT
+                      );
+  }
+
+  Dev->AsyncSlots = (UINT16)(SlotsPerQueue * Dev->NumQueues);
+  Dev->AsyncSharedPages = EFI_SIZE_TO_PAGES (
+                            Dev->AsyncSlots * sizeof *Dev->AsyncShared
+                            );
+  InitializeListHead (&Dev->PendingRequests);
+
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Dev->AsyncSharedPages,
+                          &Buffer
+                          );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (Buffer, EFI_PAGES_TO_SIZE (Dev->AsyncSharedPages));
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Buffer,
+             EFI_PAGES_TO_SIZE (Dev->AsyncSharedPages),
+             &Dev->AsyncSharedAddr,
+             &Dev->AsyncSharedMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeSharedPages;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  &VirtioBlkAsyncTimer,
+                  Dev,
+                  &Dev->AsyncTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto UnmapSharedPages;
+  }
+
+  Dev->AsyncShared = Buffer;
+  return EFI_SUCCESS;
+
+UnmapSharedPages:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->AsyncSharedMap);
+
+FreeSharedPages:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Dev->AsyncSharedPages, Buffer);
+
+  return Status;
+}
+
+/**
+
+  Release the resources set up with VirtioBlkAsyncInit(), aborting the pending
+  asynchronous requests, and waiting for the ones in flight.
+
+  @param[in,out] Dev  The device to clean up.
+
+**/
+STATIC
+VOID
+VirtioBlkAsyncUninit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  VirtioBlkAsyncDrain (Dev, TRUE);
+  gBS->RestoreTPL (OldTpl);
+
+  gBS->CloseEvent (Dev->AsyncTimer);
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->AsyncSharedMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 Dev->AsyncSharedPages,
+                 Dev->AsyncShared
+                 );
+}
+
 /**
 
   Event notification function enqueued by ExitBootServices().
@@ -1113,6 +1980,11 @@ VirtioBlkDriverBindingStart (
     goto CloseVirtIo;
   }
 
+  Status = VirtioBlkAsyncInit (Dev);
+  if (EFI_ERROR (Status)) {
+    goto UninitDev;
+  }
+
   Status = gBS->CreateEvent (
                   EVT_SIGNAL_EXIT_BOOT_SERVICES,
                   TPL_CALLBACK,
@@ -1121,18 +1993,21 @@ VirtioBlkDriverBindingStart (
                   &Dev->ExitBoot
                   );
   if (EFI_ERROR (Status)) {
-    goto UninitDev;
+    goto UninitAsync;
   }
 
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
     goto CloseExitBoot;
@@ -1143,6 +2018,9 @@ VirtioBlkDriverBindingStart (
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
+UninitAsync:
+  VirtioBlkAsyncUninit (Dev);
+
 UninitDev:
   VirtioBlkUninit (Dev);
 
@@ -1212,10 +2090,13 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
@@ -1223,6 +2104,8 @@ VirtioBlkDriverBindingStop (
 
   gBS->CloseEvent (Dev->ExitBoot);
 
+  VirtioBlkAsyncUninit (Dev);
+
   VirtioBlkUninit (Dev);
 
   gBS->CloseProtocol (
@@ -1,7 +1,7 @@
 /** @file
 
   Internal definitions for the virtio-blk driver, which produces Block I/O
-  Protocol instances for virtio-blk devices.
+  and Block I/O 2 Protocol instances for virtio-blk devices.
 
   Copyright (C) 2012, Red Hat, Inc.
 
@@ -13,13 +13,61 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Each asynchronous request occupies a fixed slot of three consecutive
+// descriptors in the virtqueue: request header, data buffer, status byte. This
+// is the upper limit on the number of slots (that is, on the number of
+// requests in flight simultaneously); the actual number also depends on the
+// queue size offered by the device.
+//
+#define VBLK_MAX_ASYNC_SLOTS  64
+#define VBLK_DESC_PER_SLOT    3
+
+//
+// Upper limit on the number of request queues used with VIRTIO_BLK_F_MQ.
+// Asynchronous request slots are interleaved between the queues: slot S lives
+// in queue (S % NumQueues). SynchronousRequest() always uses queue #0.
+//
+#define VBLK_MAX_QUEUES  4
+
+//
+// The device-visible part of an asynchronous request slot. An array of these
+// is allocated and mapped once, as a common buffer, for all slots.
+//
+typedef struct {
+  volatile VIRTIO_BLK_REQ    Request;
+  volatile UINT8             HostStatus;
+} VBLK_ASYNC_SHARED;
+
+#define VBLK_ASYNC_REQ_SIG  SIGNATURE_32 ('V', 'B', 'A', 'R')
+
+//
+// An asynchronous (Block I/O 2) request, either waiting for a free slot on
+// VBLK_DEV.PendingRequests, or in flight, referenced from VBLK_DEV.InFlight.
+//
+typedef struct {
+  UINT32                 Signature;
+  LIST_ENTRY             Link;
+  EFI_BLOCK_IO2_TOKEN    *Token;
+  EFI_LBA                Lba;
+  UINTN                  BufferSize;
+  VOID                   *Buffer;
+  BOOLEAN                RequestIsWrite;
+  VOID                   *BufferMapping;
+} VBLK_ASYNC_REQ;
+
+#define VBLK_ASYNC_REQ_FROM_LINK(LinkPointer) \
+        CR (LinkPointer, VBLK_ASYNC_REQ, Link, VBLK_ASYNC_REQ_SIG)
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -31,15 +79,37 @@ typedef struct {
   UINT32                    Signature;         // DriverBindingStart  0
   VIRTIO_DEVICE_PROTOCOL    *VirtIo;           // DriverBindingStart  0
   EFI_EVENT                 ExitBoot;          // DriverBindingStart  0
-  VRING                     Ring;              // VirtioRingInit      2
+  VRING                     Ring[VBLK_MAX_QUEUES];
+                                               // VirtioRingInit      3
   EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
-  VOID                      *RingMap;          // VirtioRingMap       2
+  VOID                      *RingMap[VBLK_MAX_QUEUES];
+                                               // VirtioRingMap       3
+  UINT16                    NumQueues;         // VirtioBlkInit       1
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;          // VirtioBlkInit       1
+  EFI_EVENT                 AsyncTimer;        // VirtioBlkAsyncInit  1
+  VBLK_ASYNC_SHARED         *AsyncShared;      // VirtioBlkAsyncInit  1
+  EFI_PHYSICAL_ADDRESS      AsyncSharedAddr;   // VirtioBlkAsyncInit  1
+  VOID                      *AsyncSharedMap;   // VirtioBlkAsyncInit  1
+  UINTN                     AsyncSharedPages;  // VirtioBlkAsyncInit  1
+  UINT16                    AsyncSlots;        // VirtioBlkAsyncInit  1
+  UINT16                    InFlightCount;     // VirtioBlkAsyncInit  1
+  UINT16                    LastUsedIdx[VBLK_MAX_QUEUES];
+                                               // VirtioBlkAsyncInit  1
+  UINT16                    QueueInFlight[VBLK_MAX_QUEUES];
+                                               // VirtioBlkAsyncInit  1
+  BOOLEAN                   AsyncTimerArmed;   // VirtioBlkAsyncInit  1
+  LIST_ENTRY                PendingRequests;   // VirtioBlkAsyncInit  1
+  VBLK_ASYNC_REQ            *InFlight[VBLK_MAX_ASYNC_SLOTS];
+                                               // VirtioBlkAsyncInit  1
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -244,6 +314,45 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
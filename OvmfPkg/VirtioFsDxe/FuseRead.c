@@ -1,5 +1,5 @@
 /** @file
-  FUSE_READ / FUSE_READDIRPLUS wrapper for the Virtio Filesystem device.
+  FUSE_READ / FUSE_READDIRPLUS wrappers for the Virtio Filesystem device.
 
   Copyright (C) 2020, Red Hat, Inc.
 
@@ -203,3 +203,214 @@ VirtioFsFuseReadFileOrDir (
   *Size = (UINT32)TailBufferFill;
   return EFI_SUCCESS;
 }
+
+/**
+  Read a range from a regular file, by splitting it into FUSE_READ requests of
+  up to VIRTIO_FS_PIPELINED_READ_SIZE bytes, and submitting up to
+  VIRTIO_FS_MAX_PIPELINED_REQUESTS requests to the Virtio Filesystem device at
+  once.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in,out] Size      On input, the number of bytes to read. On successful
+                           return, the number of bytes actually read, which may
+                           be smaller than the value on input. EOF can be
+                           detected by passing in a nonzero Size, and finding a
+                           zero Size on output.
+
+  @param[out] Data         Buffer to read the bytes from the regular file into.
+                           The caller is responsible for providing room for (at
+                           least) as many bytes in Data as Size is on input.
+
+  @retval EFI_SUCCESS  Read successful. The caller is responsible for checking
+                       Size to learn the actual byte count transferred. If a
+                       request other than the very first one fails, the bytes
+                       read until that request are reported with EFI_SUCCESS.
+
+  @return              The "errno" value mapped to an EFI_STATUS code, if the
+                       Virtio Filesystem device explicitly reported an error
+                       for the first request.
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest(),
+                       VirtioFsSgListsSubmitMultiple(),
+                       VirtioFsFuseCheckResponse().
+**/
+EFI_STATUS
+VirtioFsFuseReadFilePipelined (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST         CommonReq[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_FUSE_READ_REQUEST    ReadReq[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_IO_VECTOR            ReqIoVec[VIRTIO_FS_MAX_PIPELINED_REQUESTS][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_SCATTER_GATHER_LIST  *ReqSgListPtr[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_FUSE_RESPONSE        CommonResp[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_IO_VECTOR            RespIoVec[VIRTIO_FS_MAX_PIPELINED_REQUESTS][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_SCATTER_GATHER_LIST  *RespSgListPtr[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  UINTN                          MaxRequests;
+  UINTN                          NumRequests;
+  UINTN                          Index;
+  UINTN                          Remaining;
+  UINTN                          Transferred;
+  UINT32                         ChunkSize;
+  UINTN                          TailBufferFill;
+  EFI_STATUS                     Status;
+
+  //
+  // Every request takes four descriptors; make sure that all requests
+  // submitted at once fit in the ring.
+  //
+  MaxRequests = MIN (
+                  VIRTIO_FS_MAX_PIPELINED_REQUESTS,
+                  VirtioFs->QueueSize / (ARRAY_SIZE (ReqIoVec[0]) +
+                                         ARRAY_SIZE (RespIoVec[0]))
+                  );
+  if (MaxRequests == 0) {
+    MaxRequests = 1;
+  }
+
+  Transferred = 0;
+  Remaining   = *Size;
+  while (Remaining > 0) {
+    //
+    // Set up the scatter-gather lists for the next batch of requests.
+    //
+    NumRequests = 0;
+    while (NumRequests < MaxRequests && Remaining > 0) {
+      Index     = NumRequests;
+      ChunkSize = (UINT32)MIN (Remaining, VIRTIO_FS_PIPELINED_READ_SIZE);
+
+      ReqIoVec[Index][0].Buffer = &CommonReq[Index];
+      ReqIoVec[Index][0].Size   = sizeof CommonReq[Index];
+      ReqIoVec[Index][1].Buffer = &ReadReq[Index];
+      ReqIoVec[Index][1].Size   = sizeof ReadReq[Index];
+      ReqSgList[Index].IoVec    = ReqIoVec[Index];
+      ReqSgList[Index].NumVec   = ARRAY_SIZE (ReqIoVec[Index]);
+      ReqSgListPtr[Index]       = &ReqSgList[Index];
+
+      RespIoVec[Index][0].Buffer = &CommonResp[Index];
+      RespIoVec[Index][0].Size   = sizeof CommonResp[Index];
+      RespIoVec[Index][1].Buffer = (UINT8 *)Data + (*Size - Remaining);
+      RespIoVec[Index][1].Size   = ChunkSize;
+      RespSgList[Index].IoVec    = RespIoVec[Index];
+      RespSgList[Index].NumVec   = ARRAY_SIZE (RespIoVec[Index]);
+      RespSgListPtr[Index]       = &RespSgList[Index];
+
+      Status = VirtioFsSgListsValidate (
+                 VirtioFs,
+                 &ReqSgList[Index],
+                 &RespSgList[Index]
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Status = VirtioFsFuseNewRequest (
+                 VirtioFs,
+                 &CommonReq[Index],
+                 ReqSgList[Index].TotalSize,
+                 VirtioFsFuseOpRead,
+                 NodeId
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      ReadReq[Index].FileHandle = FuseHandle;
+      ReadReq[Index].Offset     = Offset + (*Size - Remaining);
+      ReadReq[Index].Size       = ChunkSize;
+      ReadReq[Index].ReadFlags  = 0;
+      ReadReq[Index].LockOwner  = 0;
+      ReadReq[Index].Flags      = 0;
+      ReadReq[Index].Padding    = 0;
+
+      Remaining -= ChunkSize;
+      NumRequests++;
+    }
+
+    //
+    // Submit the batch.
+    //
+    Status = VirtioFsSgListsSubmitMultiple (
+               VirtioFs,
+               NumRequests,
+               ReqSgListPtr,
+               RespSgListPtr
+               );
+    if (EFI_ERROR (Status)) {
+      if (Transferred > 0) {
+        break;
+      }
+
+      return Status;
+    }
+
+    //
+    // Verify the responses in file order. The data read is contiguous only up
+    // to the first short (or failed) read.
+    //
+    for (Index = 0; Index < NumRequests; Index++) {
+      Status = VirtioFsFuseCheckResponse (
+                 &RespSgList[Index],
+                 CommonReq[Index].Unique,
+                 &TailBufferFill
+                 );
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((
+            DEBUG_ERROR,
+            "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n",
+            __FUNCTION__,
+            VirtioFs->Label,
+            NodeId,
+            FuseHandle,
+            ReadReq[Index].Offset,
+            ReadReq[Index].Size,
+            CommonResp[Index].Error
+            ));
+          Status = VirtioFsErrnoToEfiStatus (CommonResp[Index].Error);
+        }
+
+        if (Transferred > 0) {
+          break;
+        }
+
+        return Status;
+      }
+
+      Transferred += TailBufferFill;
+      if (TailBufferFill < ReadReq[Index].Size) {
+        break;
+      }
+    }
+
+    if (Index < NumRequests) {
+      break;
+    }
+  }
+
+  *Size = Transferred;
+  return EFI_SUCCESS;
+}
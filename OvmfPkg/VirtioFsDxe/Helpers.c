@@ -486,212 +486,245 @@ VirtioFsSgListsValidate (
 }
 
 /**
-  Submit a validated pair of (request buffer list, response buffer list) to the
-  Virtio Filesystem device.
-
-  On input, the pair of VIRTIO_FS_SCATTER_GATHER_LIST objects must have been
-  validated together, using the VirtioFsSgListsValidate() function.
-
-  On output (on successful return), the following fields will be re-initialized
-  to zero (after temporarily setting them to different values):
-  - VIRTIO_FS_IO_VECTOR.Mapped,
-  - VIRTIO_FS_IO_VECTOR.MappedAddress,
-  - VIRTIO_FS_IO_VECTOR.Mapping.
+  Submit several validated pairs of (request buffer list, response buffer
+  list) to the Virtio Filesystem device at once. The device may process the
+  exchanges in parallel.
 
-  On output (on successful return), the following fields will be calculated:
-  - VIRTIO_FS_IO_VECTOR.Transferred.
+  Each pair must have been validated with VirtioFsSgListsValidate(). The
+  fields are updated like in VirtioFsSgListsSubmit(), for every pair.
 
   The function may only be called after VirtioFsInit() returns successfully and
   before VirtioFsUninit() is called.
 
   @param[in,out] VirtioFs        The Virtio Filesystem device that the
-                                 request-response exchange, expressed via
-                                 RequestSgList and ResponseSgList, should now
-                                 be submitted to.
+                                 request-response exchanges should now be
+                                 submitted to.
 
-  @param[in,out] RequestSgList   The scatter-gather list that describes the
-                                 request part of the exchange -- the buffers
-                                 that should be sent to the Virtio Filesystem
-                                 device in the virtio transfer.
+  @param[in] NumExchanges        The number of exchanges to submit, at most
+                                 VIRTIO_FS_MAX_PIPELINED_REQUESTS.
 
-  @param[in,out] ResponseSgList  The scatter-gather list that describes the
-                                 response part of the exchange -- the buffers
-                                 that the Virtio Filesystem device should
-                                 populate in the virtio transfer. May be NULL
-                                 if and only if NULL was passed to
-                                 VirtioFsSgListsValidate() as ResponseSgList.
+  @param[in,out] RequestSgList   Array of NumExchanges scatter-gather lists,
+                                 describing the request parts of the
+                                 exchanges.
+
+  @param[in,out] ResponseSgList  Array of NumExchanges scatter-gather lists,
+                                 describing the response parts of the
+                                 exchanges. An element may be NULL if and only
+                                 if NULL was passed to VirtioFsSgListsValidate()
+                                 as ResponseSgList for the pair.
 
   @retval EFI_SUCCESS       Transfer complete. The caller should investigate
-                            the VIRTIO_FS_IO_VECTOR.Transferred fields in
-                            ResponseSgList, to ensure coverage of the relevant
-                            response buffers. Subsequently, the caller should
-                            investigate the contents of those buffers.
+                            the VIRTIO_FS_IO_VECTOR.Transferred fields in each
+                            ResponseSgList element, like after
+                            VirtioFsSgListsSubmit().
+
+  @retval EFI_UNSUPPORTED   The exchanges need more descriptors than
+                            VirtioFs->QueueSize.
 
   @retval EFI_DEVICE_ERROR  The Virtio Filesystem device reported populating
-                            more response bytes than ResponseSgList->TotalSize.
+                            more response bytes than the TotalSize of a
+                            ResponseSgList element.
 
   @return                   Error codes propagated from
-                            VirtioMapAllBytesInSharedBuffer(), VirtioFlush(),
-                            or VirtioFs->Virtio->UnmapSharedBuffer().
+                            VirtioMapAllBytesInSharedBuffer(),
+                            VirtioFlushChains(), or
+                            VirtioFs->Virtio->UnmapSharedBuffer().
 **/
 EFI_STATUS
-VirtioFsSgListsSubmit (
+VirtioFsSgListsSubmitMultiple (
   IN OUT VIRTIO_FS                      *VirtioFs,
-  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgList,
-  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
+  IN     UINTN                          NumExchanges,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **RequestSgList,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **ResponseSgList
   )
 {
   VIRTIO_FS_SCATTER_GATHER_LIST  *SgListParam[2];
   VIRTIO_MAP_OPERATION           SgListVirtioMapOp[ARRAY_SIZE (SgListParam)];
   UINT16                         SgListDescriptorFlag[ARRAY_SIZE (SgListParam)];
+  UINTN                          Exchange;
   UINTN                          ListId;
   VIRTIO_FS_SCATTER_GATHER_LIST  *SgList;
   UINTN                          IoVecIdx;
   VIRTIO_FS_IO_VECTOR            *IoVec;
   EFI_STATUS                     Status;
   DESC_INDICES                   Indices;
-  UINT32                         TotalBytesWrittenByDevice;
+  UINTN                          DescriptorsNeeded;
+  UINT16                         HeadDescIdx[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  UINT32                         TotalBytesWrittenByDevice[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
   UINT32                         BytesPermittedForWrite;
 
-  SgListParam[0]          = RequestSgList;
+  ASSERT (NumExchanges > 0 && NumExchanges <= VIRTIO_FS_MAX_PIPELINED_REQUESTS);
+
   SgListVirtioMapOp[0]    = VirtioOperationBusMasterRead;
   SgListDescriptorFlag[0] = 0;
 
-  SgListParam[1]          = ResponseSgList;
   SgListVirtioMapOp[1]    = VirtioOperationBusMasterWrite;
   SgListDescriptorFlag[1] = VRING_DESC_F_WRITE;
 
   //
-  // Map all IO Vectors.
+  // All descriptor chains must fit in the ring at the same time.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  DescriptorsNeeded = 0;
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    DescriptorsNeeded += RequestSgList[Exchange]->NumVec;
+    if (ResponseSgList[Exchange] != NULL) {
+      DescriptorsNeeded += ResponseSgList[Exchange]->NumVec;
     }
+  }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Map this IO Vector.
-      //
-      Status = VirtioMapAllBytesInSharedBuffer (
-                 VirtioFs->Virtio,
-                 SgListVirtioMapOp[ListId],
-                 IoVec->Buffer,
-                 IoVec->Size,
-                 &IoVec->MappedAddress,
-                 &IoVec->Mapping
-                 );
-      if (EFI_ERROR (Status)) {
-        goto Unmap;
+  if (DescriptorsNeeded > VirtioFs->QueueSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Map all IO Vectors.
+  //
+  Status = EFI_SUCCESS;
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0] = RequestSgList[Exchange];
+    SgListParam[1] = ResponseSgList[Exchange];
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
       }
 
-      IoVec->Mapped = TRUE;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Map this IO Vector.
+        //
+        Status = VirtioMapAllBytesInSharedBuffer (
+                   VirtioFs->Virtio,
+                   SgListVirtioMapOp[ListId],
+                   IoVec->Buffer,
+                   IoVec->Size,
+                   &IoVec->MappedAddress,
+                   &IoVec->Mapping
+                   );
+        if (EFI_ERROR (Status)) {
+          goto Unmap;
+        }
+
+        IoVec->Mapped = TRUE;
+      }
     }
   }
 
   //
-  // Compose the descriptor chain.
+  // Compose the descriptor chains, one after the other.
   //
   VirtioPrepare (&VirtioFs->Ring, &Indices);
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0]        = RequestSgList[Exchange];
+    SgListParam[1]        = ResponseSgList[Exchange];
+    HeadDescIdx[Exchange] = Indices.NextDescIdx;
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      UINT16  NextFlag;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        UINT16  NextFlag;
 
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Set VRING_DESC_F_NEXT on all except the very last descriptor.
-      //
-      NextFlag = VRING_DESC_F_NEXT;
-      if ((ListId == ARRAY_SIZE (SgListParam) - 1) &&
-          (IoVecIdx == SgList->NumVec - 1))
-      {
-        NextFlag = 0;
-      }
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Set VRING_DESC_F_NEXT on all except the very last descriptor of the
+        // chain.
+        //
+        NextFlag = VRING_DESC_F_NEXT;
+        if (((ListId == ARRAY_SIZE (SgListParam) - 1) ||
+             (SgListParam[ARRAY_SIZE (SgListParam) - 1] == NULL)) &&
+            (IoVecIdx == SgList->NumVec - 1))
+        {
+          NextFlag = 0;
+        }
 
-      VirtioAppendDesc (
-        &VirtioFs->Ring,
-        IoVec->MappedAddress,
-        (UINT32)IoVec->Size,
-        SgListDescriptorFlag[ListId] | NextFlag,
-        &Indices
-        );
+        VirtioAppendDesc (
+          &VirtioFs->Ring,
+          IoVec->MappedAddress,
+          (UINT32)IoVec->Size,
+          SgListDescriptorFlag[ListId] | NextFlag,
+          &Indices
+          );
+      }
     }
   }
 
   //
-  // Submit the descriptor chain.
+  // Submit the descriptor chains.
   //
-  Status = VirtioFlush (
+  Status = VirtioFlushChains (
              VirtioFs->Virtio,
              VIRTIO_FS_REQUEST_QUEUE,
              &VirtioFs->Ring,
-             &Indices,
-             &TotalBytesWrittenByDevice
+             NumExchanges,
+             HeadDescIdx,
+             TotalBytesWrittenByDevice
              );
   if (EFI_ERROR (Status)) {
     goto Unmap;
   }
 
-  //
-  // Sanity-check: the Virtio Filesystem device should not have written more
-  // bytes than what we offered buffers for.
-  //
-  if (ResponseSgList == NULL) {
-    BytesPermittedForWrite = 0;
-  } else {
-    BytesPermittedForWrite = ResponseSgList->TotalSize;
-  }
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0] = RequestSgList[Exchange];
+    SgListParam[1] = ResponseSgList[Exchange];
 
-  if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
-    Status = EFI_DEVICE_ERROR;
-    goto Unmap;
-  }
+    //
+    // Sanity-check: the Virtio Filesystem device should not have written more
+    // bytes than what we offered buffers for.
+    //
+    if (SgListParam[1] == NULL) {
+      BytesPermittedForWrite = 0;
+    } else {
+      BytesPermittedForWrite = SgListParam[1]->TotalSize;
+    }
 
-  //
-  // Update the transfer sizes in the IO Vectors.
-  //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+    if (TotalBytesWrittenByDevice[Exchange] > BytesPermittedForWrite) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
     }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
-        //
-        // We report that the Virtio Filesystem device has read all buffers in
-        // the request.
-        //
-        IoVec->Transferred = IoVec->Size;
-      } else {
-        //
-        // Regarding the response, calculate how much of the current IO Vector
-        // has been populated by the Virtio Filesystem device. In
-        // "TotalBytesWrittenByDevice", VirtioFlush() reported the total count
-        // across all device-writeable descriptors, in the order they were
-        // chained on the ring.
-        //
-        IoVec->Transferred = MIN (
-                               (UINTN)TotalBytesWrittenByDevice,
-                               IoVec->Size
-                               );
-        TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+    //
+    // Update the transfer sizes in the IO Vectors.
+    //
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
+          //
+          // We report that the Virtio Filesystem device has read all buffers
+          // in the request.
+          //
+          IoVec->Transferred = IoVec->Size;
+        } else {
+          //
+          // Regarding the response, calculate how much of the current IO
+          // Vector has been populated by the Virtio Filesystem device. In
+          // "TotalBytesWrittenByDevice", VirtioFlushChains() reported the
+          // total count across all device-writeable descriptors of the chain,
+          // in the order they were chained on the ring.
+          //
+          IoVec->Transferred = MIN (
+                                 (UINTN)TotalBytesWrittenByDevice[Exchange],
+                                 IoVec->Size
+                                 );
+          TotalBytesWrittenByDevice[Exchange] -= (UINT32)IoVec->Transferred;
+        }
       }
     }
-  }
 
-  //
-  // By now, "TotalBytesWrittenByDevice" has been exhausted.
-  //
-  ASSERT (TotalBytesWrittenByDevice == 0);
+    //
+    // By now, "TotalBytesWrittenByDevice" has been exhausted.
+    //
+    ASSERT (TotalBytesWrittenByDevice[Exchange] == 0);
+  }
 
   //
   // We've succeeded; fall through.
@@ -702,49 +735,54 @@ Unmap:
   // unmapping occurs in reverse order of mapping, in an attempt to avoid
   // memory fragmentation.
   //
-  ListId = ARRAY_SIZE (SgListParam);
-  while (ListId > 0) {
-    --ListId;
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
-
-    IoVecIdx = SgList->NumVec;
-    while (IoVecIdx > 0) {
-      EFI_STATUS  UnmapStatus;
-
-      --IoVecIdx;
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Unmap this IO Vector, if it has been mapped.
-      //
-      if (!IoVec->Mapped) {
+  Exchange = NumExchanges;
+  while (Exchange > 0) {
+    --Exchange;
+    SgListParam[0] = RequestSgList[Exchange];
+    SgListParam[1] = ResponseSgList[Exchange];
+
+    ListId = ARRAY_SIZE (SgListParam);
+    while (ListId > 0) {
+      --ListId;
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
         continue;
       }
 
-      UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
-                                        VirtioFs->Virtio,
-                                        IoVec->Mapping
-                                        );
-      //
-      // Re-set the following fields to the values they initially got from
-      // VirtioFsSgListsValidate() -- the above unmapping attempt is considered
-      // final, even if it fails.
-      //
-      IoVec->Mapped        = FALSE;
-      IoVec->MappedAddress = 0;
-      IoVec->Mapping       = NULL;
+      IoVecIdx = SgList->NumVec;
+      while (IoVecIdx > 0) {
+        EFI_STATUS  UnmapStatus;
 
-      //
-      // If we are on the success path, but the unmapping failed, we need to
-      // transparently flip to the failure path -- the caller must learn they
-      // should not consult the response buffers.
-      //
-      // The branch below can be taken at most once.
-      //
-      if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
-        Status = UnmapStatus;
+        --IoVecIdx;
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Unmap this IO Vector, if it has been mapped.
+        //
+        if (!IoVec->Mapped) {
+          continue;
+        }
+
+        UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
+                                          VirtioFs->Virtio,
+                                          IoVec->Mapping
+                                          );
+        //
+        // Re-set the following fields to the values they initially got from
+        // VirtioFsSgListsValidate() -- the above unmapping attempt is
+        // considered final, even if it fails.
+        //
+        IoVec->Mapped        = FALSE;
+        IoVec->MappedAddress = 0;
+        IoVec->Mapping       = NULL;
+
+        //
+        // If we are on the success path, but the unmapping failed, we need to
+        // transparently flip to the failure path -- the caller must learn they
+        // should not consult the response buffers.
+        //
+        if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
+          Status = UnmapStatus;
+        }
       }
     }
   }
@@ -752,6 +790,69 @@ Unmap:
   return Status;
 }
 
+/**
+  Submit a validated pair of (request buffer list, response buffer list) to the
+  Virtio Filesystem device.
+
+  On input, the pair of VIRTIO_FS_SCATTER_GATHER_LIST objects must have been
+  validated together, using the VirtioFsSgListsValidate() function.
+
+  On output (on successful return), the following fields will be re-initialized
+  to zero (after temporarily setting them to different values):
+  - VIRTIO_FS_IO_VECTOR.Mapped,
+  - VIRTIO_FS_IO_VECTOR.MappedAddress,
+  - VIRTIO_FS_IO_VECTOR.Mapping.
+
+  On output (on successful return), the following fields will be calculated:
+  - VIRTIO_FS_IO_VECTOR.Transferred.
+
+  The function may only be called after VirtioFsInit() returns successfully and
+  before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs        The Virtio Filesystem device that the
+                                 request-response exchange, expressed via
+                                 RequestSgList and ResponseSgList, should now
+                                 be submitted to.
+
+  @param[in,out] RequestSgList   The scatter-gather list that describes the
+                                 request part of the exchange -- the buffers
+                                 that should be sent to the Virtio Filesystem
+                                 device in the virtio transfer.
+
+  @param[in,out] ResponseSgList  The scatter-gather list that describes the
+                                 response part of the exchange -- the buffers
+                                 that the Virtio Filesystem device should
+                                 populate in the virtio transfer. May be NULL
+                                 if and only if NULL was passed to
+                                 VirtioFsSgListsValidate() as ResponseSgList.
+
+  @retval EFI_SUCCESS       Transfer complete. The caller should investigate
+                            the VIRTIO_FS_IO_VECTOR.Transferred fields in
+                            ResponseSgList, to ensure coverage of the relevant
+                            response buffers. Subsequently, the caller should
+                            investigate the contents of those buffers.
+
+  @retval EFI_DEVICE_ERROR  The Virtio Filesystem device reported populating
+                            more response bytes than ResponseSgList->TotalSize.
+
+  @return                   Error codes propagated from
+                            VirtioFsSgListsSubmitMultiple().
+**/
+EFI_STATUS
+VirtioFsSgListsSubmit (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgList,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
+  )
+{
+  return VirtioFsSgListsSubmitMultiple (
+           VirtioFs,
+           1,
+           &RequestSgList,
+           &ResponseSgList
+           );
+}
+
 /**
   Set up the fields of a new VIRTIO_FS_FUSE_REQUEST object.
 
@@ -2523,3 +2624,30 @@ VirtioFsGetFuseModeUpdate (
   *Update = TRUE;
   return EFI_SUCCESS;
 }
+
+/**
+  Invalidate the read-ahead caches of all VIRTIO_FS_FILE objects that refer to
+  a given inode, after the contents or the size of the inode have been (or are
+  about to be) changed.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose open files should
+                           be searched.
+
+  @param[in] NodeId        The inode number whose cached contents are stale.
+**/
+VOID
+VirtioFsDropReadAhead (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  LIST_ENTRY      *OpenFilesEntry;
+  VIRTIO_FS_FILE  *VirtioFsFile;
+
+  BASE_LIST_FOR_EACH (OpenFilesEntry, &VirtioFs->OpenFiles) {
+    VirtioFsFile = VIRTIO_FS_FILE_FROM_OPEN_FILES_ENTRY (OpenFilesEntry);
+    if (VirtioFsFile->NodeId == NodeId) {
+      VirtioFsFile->ReadAheadSize = 0;
+    }
+  }
+}
@@ -546,6 +546,9 @@ VirtioFsSimpleFileOpen (
   NewVirtioFsFile->SingleFileInfoSize     = 0;
   NewVirtioFsFile->NumFileInfo            = 0;
   NewVirtioFsFile->NextFileInfo           = 0;
+  NewVirtioFsFile->ReadAheadBuffer        = NULL;
+  NewVirtioFsFile->ReadAheadOffset        = 0;
+  NewVirtioFsFile->ReadAheadSize          = 0;
 
   //
   // One more file is now open for the filesystem.
@@ -378,31 +378,95 @@ ReadRegularFile (
   VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  FuseAttr;
   UINTN                               Transferred;
   UINTN                               Left;
+  UINT64                              CacheOffset;
 
-  VirtioFs = VirtioFsFile->OwnerFs;
-  //
-  // The UEFI spec forbids reads that start beyond the end of the file.
-  //
-  Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
-  if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
-    return EFI_DEVICE_ERROR;
-  }
-
+  VirtioFs    = VirtioFsFile->OwnerFs;
   Status      = EFI_SUCCESS;
   Transferred = 0;
   Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32  ReadSize;
 
+  //
+  // Serve the read from the read-ahead cache, as far as possible.
+  //
+  if ((VirtioFsFile->FilePosition >= VirtioFsFile->ReadAheadOffset) &&
+      (VirtioFsFile->FilePosition - VirtioFsFile->ReadAheadOffset <
+       VirtioFsFile->ReadAheadSize))
+  {
+    CacheOffset = VirtioFsFile->FilePosition - VirtioFsFile->ReadAheadOffset;
+    Transferred = MIN (Left, VirtioFsFile->ReadAheadSize - (UINTN)CacheOffset);
+    CopyMem (
+      Buffer,
+      VirtioFsFile->ReadAheadBuffer + CacheOffset,
+      Transferred
+      );
+    Left -= Transferred;
+  } else {
     //
-    // FUSE_READ cannot express a >=4GB buffer size.
+    // The UEFI spec forbids reads that start beyond the end of the file.
     //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status   = VirtioFsFuseReadFileOrDir (
+    Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
+    if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  //
+  // Turn a small read into a read-ahead, unless the file may change through
+  // this handle.
+  //
+  if ((Left > 0) && (Left < VIRTIO_FS_READ_AHEAD_SIZE) &&
+      !VirtioFsFile->IsOpenForWriting)
+  {
+    if (VirtioFsFile->ReadAheadBuffer == NULL) {
+      VirtioFsFile->ReadAheadBuffer = AllocatePool (VIRTIO_FS_READ_AHEAD_SIZE);
+    }
+
+    if (VirtioFsFile->ReadAheadBuffer != NULL) {
+      UINT32  ReadSize;
+
+      ReadSize                      = VIRTIO_FS_READ_AHEAD_SIZE;
+      VirtioFsFile->ReadAheadOffset = VirtioFsFile->FilePosition + Transferred;
+      Status                        = VirtioFsFuseReadFileOrDir (
+                                        VirtioFs,
+                                        VirtioFsFile->NodeId,
+                                        VirtioFsFile->FuseHandle,
+                                        FALSE, // IsDir
+                                        VirtioFsFile->ReadAheadOffset,
+                                        &ReadSize,
+                                        VirtioFsFile->ReadAheadBuffer
+                                        );
+      if (EFI_ERROR (Status)) {
+        ReadSize = 0;
+      }
+
+      VirtioFsFile->ReadAheadSize = ReadSize;
+      CopyMem (
+        (UINT8 *)Buffer + Transferred,
+        VirtioFsFile->ReadAheadBuffer,
+        MIN (Left, ReadSize)
+        );
+      Transferred += MIN (Left, ReadSize);
+
+      //
+      // The read-ahead covers the request, unless it failed. A short
+      // read-ahead means EOF.
+      //
+      Left = 0;
+    }
+  }
+
+  //
+  // Read the rest with pipelined FUSE_READ requests, directly into the
+  // caller's buffer.
+  //
+  while (Left > 0) {
+    UINTN  ReadSize;
+
+    ReadSize = Left;
+    Status   = VirtioFsFuseReadFilePipelined (
                  VirtioFs,
                  VirtioFsFile->NodeId,
                  VirtioFsFile->FuseHandle,
-                 FALSE,                                  // IsDir
                  VirtioFsFile->FilePosition + Transferred,
                  &ReadSize,
                  (UINT8 *)Buffer + Transferred
@@ -447,8 +447,13 @@ UpdateAttributes (
   }
 
   //
-  // Send the FUSE_SETATTR request now.
+  // Send the FUSE_SETATTR request now. A truncation changes the contents that
+  // other handles may have read ahead.
   //
+  if (UpdateFileSize) {
+    VirtioFsDropReadAhead (VirtioFs, VirtioFsFile->NodeId);
+  }
+
   Status = VirtioFsFuseSetAttr (
              VirtioFs,
              VirtioFsFile->NodeId,
@@ -33,6 +33,12 @@ VirtioFsSimpleFileWrite (
     return EFI_ACCESS_DENIED;
   }
 
+  //
+  // Other handles to the same file may have read ahead the range being
+  // written.
+  //
+  VirtioFsDropReadAhead (VirtioFs, VirtioFsFile->NodeId);
+
   Status      = EFI_SUCCESS;
   Transferred = 0;
   Left        = *BufferSize;
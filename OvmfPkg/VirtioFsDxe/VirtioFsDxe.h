@@ -52,6 +52,21 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Maximum number of FUSE requests submitted to the device at once, and the
+// size of the file range each pipelined FUSE_READ request covers. Large
+// regular file reads are split into such requests, so that the device can
+// process them in parallel.
+//
+#define VIRTIO_FS_MAX_PIPELINED_REQUESTS  8
+#define VIRTIO_FS_PIPELINED_READ_SIZE     SIZE_1MB
+
+//
+// Size of the read-ahead buffer for regular files, see
+// VIRTIO_FS_FILE.ReadAheadBuffer.
+//
+#define VIRTIO_FS_READ_AHEAD_SIZE  SIZE_256KB
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -174,6 +189,20 @@ typedef struct {
   UINTN    SingleFileInfoSize;
   UINTN    NumFileInfo;
   UINTN    NextFileInfo;
+  //
+  // Read-ahead cache for a regular file that is not open for writing.
+  //
+  // Small sequential reads (such as those of a boot loader parsing an image)
+  // would cost a FUSE round trip each. When a read cannot be served from the
+  // cache, VIRTIO_FS_READ_AHEAD_SIZE bytes are fetched from the read position
+  // into ReadAheadBuffer, and the following reads are served from there.
+  // ReadAheadSize bytes of the file, starting at ReadAheadOffset, are valid
+  // in ReadAheadBuffer. The cache is dropped whenever the file is written or
+  // resized through any handle.
+  //
+  UINT8     *ReadAheadBuffer;
+  UINT64    ReadAheadOffset;
+  UINTN     ReadAheadSize;
 } VIRTIO_FS_FILE;
 
 #define VIRTIO_FS_FILE_FROM_SIMPLE_FILE(SimpleFileReference) \
@@ -211,6 +240,14 @@ VirtioFsSgListsValidate (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   );
 
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumExchanges,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **RequestSgList,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **ResponseSgList
+  );
+
 EFI_STATUS
 VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS                      *VirtioFs,
@@ -308,6 +345,12 @@ VirtioFsGetFuseModeUpdate (
   OUT UINT32            *Mode
   );
 
+VOID
+VirtioFsDropReadAhead (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
 //
 // Wrapper functions for FUSE commands (primitives).
 //
@@ -379,6 +422,16 @@ VirtioFsFuseReadFileOrDir (
   OUT VOID          *Data
   );
 
+EFI_STATUS
+VirtioFsFuseReadFilePipelined (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  );
+
 EFI_STATUS
 VirtioFsFuseWrite (
   IN OUT VIRTIO_FS  *VirtioFs,
@@ -433,6 +433,20 @@ InitVgpuGop (
     goto CloseVirtIoByChild;
   }
 
+  //
+  // Create the timer that flushes the display area damaged by Blt().
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  VgpuGopFlushTimer,
+                  VgpuGop,
+                  &VgpuGop->FlushTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto UninitGop;
+  }
+
   //
   // Install the Graphics Output Protocol on the child handle.
   //
@@ -443,7 +457,7 @@ InitVgpuGop (
                   &VgpuGop->Gop
                   );
   if (EFI_ERROR (Status)) {
-    goto UninitGop;
+    goto CloseFlushTimer;
   }
 
   //
@@ -453,6 +467,9 @@ InitVgpuGop (
   ParentBus->Child = VgpuGop;
   return EFI_SUCCESS;
 
+CloseFlushTimer:
+  gBS->CloseEvent (VgpuGop->FlushTimer);
+
 UninitGop:
   ReleaseGopResources (VgpuGop, TRUE /* DisableHead */);
 
@@ -524,8 +541,10 @@ UninitVgpuGop (
   ASSERT_EFI_ERROR (Status);
 
   //
-  // Uninitialize VgpuGop->Gop.
+  // Uninitialize VgpuGop->Gop. Any damage that is still pending is moot, as
+  // the head is about to be disabled.
   //
+  gBS->CloseEvent (VgpuGop->FlushTimer);
   ReleaseGopResources (VgpuGop, TRUE /* DisableHead */);
 
   Status = gBS->CloseProtocol (
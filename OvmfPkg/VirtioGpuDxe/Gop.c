@@ -9,6 +9,7 @@
 **/
 
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "VirtioGpu.h"
 
@@ -138,6 +139,74 @@ ReleaseGopResources (
   VgpuGop->ResourceId = 0;
 }
 
+/**
+  EFI_EVENT_NOTIFY function for the VGPU_GOP.FlushTimer event. It transfers the
+  area of BackingStore that Gop.Blt() has damaged to the host resource, and
+  flushes it to head (scanout) #0.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the associated VGPU_GOP object.
+**/
+VOID
+EFIAPI
+VgpuGopFlushTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  VGPU_GOP    *VgpuGop;
+  UINT32      X;
+  UINT32      Y;
+  UINT32      Width;
+  UINT32      Height;
+  UINTN       ResourceOffset;
+  EFI_STATUS  Status;
+
+  VgpuGop = Context;
+  if (!VgpuGop->Damaged) {
+    return;
+  }
+
+  X                = VgpuGop->DamageX1;
+  Y                = VgpuGop->DamageY1;
+  Width            = VgpuGop->DamageX2 - VgpuGop->DamageX1;
+  Height           = VgpuGop->DamageY2 - VgpuGop->DamageY1;
+  VgpuGop->Damaged = FALSE;
+
+  //
+  // Update the host resource from guest memory.
+  //
+  ResourceOffset = sizeof (UINT32) *
+                   (Y * VgpuGop->GopModeInfo.HorizontalResolution + X);
+  Status = VirtioGpuTransferToHost2d (
+             VgpuGop->ParentBus, // VgpuDev
+             X,                  // X
+             Y,                  // Y
+             Width,              // Width
+             Height,             // Height
+             ResourceOffset,     // Offset
+             VgpuGop->ResourceId // ResourceId
+             );
+  if (!EFI_ERROR (Status)) {
+    //
+    // Flush the updated resource to the display.
+    //
+    Status = VirtioGpuResourceFlush (
+               VgpuGop->ParentBus, // VgpuDev
+               X,                  // X
+               Y,                  // Y
+               Width,              // Width
+               Height,             // Height
+               VgpuGop->ResourceId // ResourceId
+               );
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %r\n", __FUNCTION__, Status));
+  }
+}
+
 //
 // The resolutions supported by this driver.
 //
@@ -244,6 +313,7 @@ GopSetMode (
 
   EFI_STATUS  Status;
   EFI_STATUS  Status2;
+  EFI_TPL     OldTpl;
 
   if (ModeNumber >= ARRAY_SIZE (mGopResolutions)) {
     return EFI_UNSUPPORTED;
@@ -251,6 +321,17 @@ GopSetMode (
 
   VgpuGop = VGPU_GOP_FROM_GOP (This);
 
+  //
+  // Drop the damage accumulated in the current mode; the new mode starts out
+  // fully flushed. This also keeps FlushTimer from racing the commands below.
+  //
+  if (VgpuGop->FlushTimer != NULL) {
+    OldTpl           = gBS->RaiseTPL (TPL_NOTIFY);
+    VgpuGop->Damaged = FALSE;
+    gBS->SetTimer (VgpuGop->FlushTimer, TimerCancel, 0);
+    gBS->RestoreTPL (OldTpl);
+  }
+
   //
   // Distinguish the first (internal) call from the other (protocol consumer)
   // calls.
@@ -454,13 +535,12 @@ GopBlt (
   IN  UINTN                              Delta         OPTIONAL
   )
 {
-  VGPU_GOP    *VgpuGop;
-  UINT32      CurrentHorizontal;
-  UINT32      CurrentVertical;
-  UINTN       SegmentSize;
-  UINTN       Y;
-  UINTN       ResourceOffset;
-  EFI_STATUS  Status;
+  VGPU_GOP  *VgpuGop;
+  UINT32    CurrentHorizontal;
+  UINT32    CurrentVertical;
+  UINTN     SegmentSize;
+  UINTN     Y;
+  EFI_TPL   OldTpl;
 
   VgpuGop           = VGPU_GOP_FROM_GOP (This);
   CurrentHorizontal = VgpuGop->GopModeInfo.HorizontalResolution;
@@ -626,37 +706,32 @@ GopBlt (
       return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // For operations that wrote to the display, submit the updated area to the
-  // host -- update the host resource from guest memory.
-  //
-  ResourceOffset = sizeof (UINT32) * (DestinationY * CurrentHorizontal +
-                                      DestinationX);
-  Status = VirtioGpuTransferToHost2d (
-             VgpuGop->ParentBus,   // VgpuDev
-             (UINT32)DestinationX, // X
-             (UINT32)DestinationY, // Y
-             (UINT32)Width,        // Width
-             (UINT32)Height,       // Height
-             ResourceOffset,       // Offset
-             VgpuGop->ResourceId   // ResourceId
-             );
-  if (EFI_ERROR (Status)) {
-    return Status;
+  if ((Width == 0) || (Height == 0)) {
+    return EFI_SUCCESS;
   }
 
   //
-  // Flush the updated resource to the display.
+  // For operations that wrote to the display, add the updated area to the
+  // damage. FlushTimer submits it to the host and flushes it to the display
+  // once the burst of Blt() calls is over.
   //
-  Status = VirtioGpuResourceFlush (
-             VgpuGop->ParentBus,   // VgpuDev
-             (UINT32)DestinationX, // X
-             (UINT32)DestinationY, // Y
-             (UINT32)Width,        // Width
-             (UINT32)Height,       // Height
-             VgpuGop->ResourceId   // ResourceId
-             );
-  return Status;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (!VgpuGop->Damaged) {
+    VgpuGop->Damaged  = TRUE;
+    VgpuGop->DamageX1 = (UINT32)DestinationX;
+    VgpuGop->DamageY1 = (UINT32)DestinationY;
+    VgpuGop->DamageX2 = (UINT32)(DestinationX + Width);
+    VgpuGop->DamageY2 = (UINT32)(DestinationY + Height);
+    gBS->SetTimer (VgpuGop->FlushTimer, TimerRelative, VGPU_GOP_FLUSH_DELAY);
+  } else {
+    VgpuGop->DamageX1 = MIN (VgpuGop->DamageX1, (UINT32)DestinationX);
+    VgpuGop->DamageY1 = MIN (VgpuGop->DamageY1, (UINT32)DestinationY);
+    VgpuGop->DamageX2 = MAX (VgpuGop->DamageX2, (UINT32)(DestinationX + Width));
+    VgpuGop->DamageY2 = MAX (VgpuGop->DamageY2, (UINT32)(DestinationY + Height));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
 }
 
 //
@@ -23,6 +23,14 @@
 //
 typedef struct VGPU_GOP_STRUCT VGPU_GOP;
 
+//
+// How long Gop.Blt() lets damage to the display accumulate before the damaged
+// area is transferred to the host and flushed to head (scanout) #0, in 100ns
+// units. Text output and setup UI redraws issue many small Blt() calls in a
+// row; each would otherwise cost two synchronous VirtIo GPU commands.
+//
+#define VGPU_GOP_FLUSH_DELAY  EFI_TIMER_PERIOD_MILLISECONDS (20)
+
 //
 // The abstraction that directly corresponds to a Virtio GPU device.
 //
@@ -151,6 +159,24 @@ struct VGPU_GOP_STRUCT {
   // BackingStore is non-NULL.
   //
   VOID                                    *BackingStoreMap;
+
+  //
+  // One-shot timer, at TPL_NOTIFY, that flushes the damaged area to the
+  // display. Armed by Gop.Blt() when it damages a clean display.
+  //
+  EFI_EVENT                               FlushTimer;
+
+  //
+  // The bounding rectangle of the display area that Gop.Blt() has written to
+  // BackingStore since the last flush. DamageX2 and DamageY2 are exclusive.
+  // The rectangle is only valid if Damaged is TRUE. These fields are only
+  // accessed at TPL_NOTIFY.
+  //
+  BOOLEAN                                 Damaged;
+  UINT32                                  DamageX1;
+  UINT32                                  DamageY1;
+  UINT32                                  DamageX2;
+  UINT32                                  DamageY2;
 };
 
 //
@@ -395,6 +421,22 @@ ReleaseGopResources (
   IN     BOOLEAN   DisableHead
   );
 
+/**
+  EFI_EVENT_NOTIFY function for the VGPU_GOP.FlushTimer event. It transfers the
+  area of BackingStore that Gop.Blt() has damaged to the host resource, and
+  flushes it to head (scanout) #0.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the associated VGPU_GOP object.
+**/
+VOID
+EFIAPI
+VgpuGopFlushTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 //
 // Template for initializing VGPU_GOP.Gop.
 //
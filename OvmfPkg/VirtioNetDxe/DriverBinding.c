@@ -207,6 +207,12 @@ VirtioNetSnpPopulate (
   Dev->Snp.Receive        = &VirtioNetReceive;
   Dev->Snp.Mode           = &Dev->Snm;
 
+  Dev->RxLoan.Receive = &VirtioNetRxLoanReceive;
+  Dev->RxLoan.Return  = &VirtioNetRxLoanReturn;
+
+  Dev->Offload.GetCapabilities = &VirtioNetOffloadGetCapabilities;
+  Dev->Offload.Transmit        = &VirtioNetOffloadTransmit;
+
   Dev->Snm.State           = EfiSimpleNetworkStopped;
   Dev->Snm.HwAddressSize   = SIZE_OF_VNET (Mac);
   Dev->Snm.MediaHeaderSize = SIZE_OF_VNET (Mac) +       // dst MAC
@@ -531,6 +537,10 @@ VirtioNetDriverBindingStart (
                   &Dev->MacHandle,
                   &gEfiSimpleNetworkProtocolGuid,
                   &Dev->Snp,
+                  &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+                  &Dev->RxLoan,
+                  &gEdkiiSimpleNetworkOffloadProtocolGuid,
+                  &Dev->Offload,
                   &gEfiDevicePathProtocolGuid,
                   Dev->MacDevicePath,
                   NULL
@@ -562,6 +572,10 @@ UninstallMultiple:
          Dev->MacHandle,
          &gEfiDevicePathProtocolGuid,
          Dev->MacDevicePath,
+         &gEdkiiSimpleNetworkOffloadProtocolGuid,
+         &Dev->Offload,
+         &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+         &Dev->RxLoan,
          &gEfiSimpleNetworkProtocolGuid,
          &Dev->Snp,
          NULL
@@ -675,6 +689,10 @@ VirtioNetDriverBindingStop (
              Dev->MacHandle,
              &gEfiDevicePathProtocolGuid,
              Dev->MacDevicePath,
+             &gEdkiiSimpleNetworkOffloadProtocolGuid,
+             &Dev->Offload,
+             &gEdkiiSimpleNetworkRxLoanProtocolGuid,
+             &Dev->RxLoan,
              &gEfiSimpleNetworkProtocolGuid,
              &Dev->Snp,
              NULL
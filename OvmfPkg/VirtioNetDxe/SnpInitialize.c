@@ -156,6 +156,7 @@ VirtioNetInitTx (
   )
 {
   UINTN                 TxSharedReqSize;
+  UINTN                 TxSharedReqAreaSize;
   UINTN                 PktIdx;
   EFI_STATUS            Status;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
@@ -184,25 +185,33 @@ VirtioNetInitTx (
   }
 
   //
-  // Allocate TxSharedReq header and map with BusMasterCommonBuffer so that it
-  // can be accessed equally by both processor and device.
+  // Allocate the TxSharedReq headers, one for each possibly pending packet so
+  // that the offloads can be requested per packet, and map them with
+  // BusMasterCommonBuffer so that they can be accessed equally by both
+  // processor and device.
   //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *Dev->TxSharedReq),
-                          &TxSharedReqBuffer
-                          );
+  TxSharedReqAreaSize = Dev->TxMaxPending * sizeof *Dev->TxSharedReq;
+  Status              = Dev->VirtIo->AllocateSharedPages (
+                                       Dev->VirtIo,
+                                       EFI_SIZE_TO_PAGES (TxSharedReqAreaSize),
+                                       &TxSharedReqBuffer
+                                       );
   if (EFI_ERROR (Status)) {
     goto UninitTxBufCollection;
   }
 
-  ZeroMem (TxSharedReqBuffer, sizeof *Dev->TxSharedReq);
+  //
+  // virtio-0.9.5, Appendix C, Packet Transmission: zero Flags and GsoType
+  // (VIRTIO_NET_HDR_GSO_NONE) request no offload. For VirtIo 1.0 only, the
+  // NumBuffers field exists, but it is unused.
+  //
+  ZeroMem (TxSharedReqBuffer, TxSharedReqAreaSize);
 
   Status = VirtioMapAllBytesInSharedBuffer (
              Dev->VirtIo,
              VirtioOperationBusMasterCommonBuffer,
              TxSharedReqBuffer,
-             sizeof *(Dev->TxSharedReq),
+             TxSharedReqAreaSize,
              &DeviceAddress,
              &Dev->TxSharedReqMap
              );
@@ -227,10 +236,10 @@ VirtioNetInitTx (
     Dev->TxFreeStack[PktIdx] = DescIdx;
 
     //
-    // For each possibly pending packet, lay out the descriptor for the common
+    // For each possibly pending packet, lay out the descriptor for its own
     // (unmodified by the host) virtio-net request header.
     //
-    Dev->TxRing.Desc[DescIdx].Addr  = DeviceAddress;
+    Dev->TxRing.Desc[DescIdx].Addr  = DeviceAddress + PktIdx * sizeof *Dev->TxSharedReq;
     Dev->TxRing.Desc[DescIdx].Len   = (UINT32)TxSharedReqSize;
     Dev->TxRing.Desc[DescIdx].Flags = VRING_DESC_F_NEXT;
     Dev->TxRing.Desc[DescIdx].Next  = (UINT16)(DescIdx + 1);
@@ -242,17 +251,6 @@ VirtioNetInitTx (
     Dev->TxRing.Desc[DescIdx + 1].Flags = 0;
   }
 
-  //
-  // virtio-0.9.5, Appendix C, Packet Transmission
-  //
-  Dev->TxSharedReq->V0_9_5.Flags   = 0;
-  Dev->TxSharedReq->V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_NONE;
-
-  //
-  // For VirtIo 1.0 only -- the field exists, but it is unused
-  //
-  Dev->TxSharedReq->NumBuffers = 0;
-
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
   //
@@ -270,7 +268,7 @@ VirtioNetInitTx (
 FreeTxSharedReqBuffer:
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *(Dev->TxSharedReq)),
+                 EFI_SIZE_TO_PAGES (TxSharedReqAreaSize),
                  TxSharedReqBuffer
                  );
 
@@ -302,6 +300,7 @@ FreeTxFreeStack:
   @return                       Status codes from VIRTIO_CFG_WRITE() or
                                 VIRTIO_DEVICE_PROTOCOL.AllocateSharedPages or
                                 VirtioMapAllBytesInSharedBuffer().
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the RX loan pool.
   @retval EFI_SUCCESS           RX setup successful. The device is live and may
                                 already be writing to the receive area.
 */
@@ -378,6 +377,25 @@ VirtioNetInitRx (
 
   Dev->RxBuf = RxBuffer;
 
+  //
+  // Track the RX packets lent through EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL.
+  // Never lend more than half of them, so that the device always has RX
+  // packets to fill even if the consumer holds on to the lent ones.
+  //
+  Dev->RxLoanPool = AllocateZeroPool (
+                      sizeof (VNET_RX_LOAN_POOL) +
+                      RxAlwaysPending * sizeof (VNET_RX_LOAN)
+                      );
+  if (Dev->RxLoanPool == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto UnmapSharedBuffer;
+  }
+
+  Dev->RxLoanPool->Dev          = Dev;
+  Dev->RxLoanPool->VirtIo       = Dev->VirtIo;
+  Dev->RxLoanPool->MaxLentCount = RxAlwaysPending / 2;
+  Dev->RxLoanPool->Loans        = (VNET_RX_LOAN *)(Dev->RxLoanPool + 1);
+
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
   //
@@ -438,11 +456,14 @@ VirtioNetInitRx (
   Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
   if (EFI_ERROR (Status)) {
     Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
-    goto UnmapSharedBuffer;
+    goto FreeLoanPool;
   }
 
   return Status;
 
+FreeLoanPool:
+  FreePool (Dev->RxLoanPool);
+
 UnmapSharedBuffer:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
 
@@ -558,7 +579,15 @@ VirtioNetInitialize (
     );
 
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_NET_F_CSUM |
+              VIRTIO_NET_F_HOST_TSO4;
+
+  //
+  // TSO requires the host to complete the partial checksum of each segment.
+  //
+  if ((Features & VIRTIO_NET_F_CSUM) == 0) {
+    Features &= ~(UINT64)VIRTIO_NET_F_HOST_TSO4;
+  }
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -627,6 +656,15 @@ VirtioNetInitialize (
     goto ReleaseTxAux;
   }
 
+  Dev->TxOffloads = 0;
+  if ((Features & VIRTIO_NET_F_CSUM) != 0) {
+    Dev->TxOffloads |= EDKII_SIMPLE_NETWORK_OFFLOAD_TX_CHECKSUM;
+  }
+
+  if ((Features & VIRTIO_NET_F_HOST_TSO4) != 0) {
+    Dev->TxOffloads |= EDKII_SIMPLE_NETWORK_OFFLOAD_TX_TCP4_SEGMENTATION;
+  }
+
   Dev->Snm.State = EfiSimpleNetworkInitialized;
   gBS->RestoreTPL (OldTpl);
   return EFI_SUCCESS;
@@ -0,0 +1,108 @@
+/** @file
+
+  Implementation of the EDKII Simple Network Offload Protocol, which lets the
+  virtio-net device compute the transport layer checksum of transmitted frames
+  (VIRTIO_NET_F_CSUM) and split large TCP over IPv4 frames into segments
+  (VIRTIO_NET_F_HOST_TSO4).
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+/**
+  Report the offloads negotiated with the virtio-net device.
+
+  @param[in]   This             Pointer to the EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities     Bitmask of EDKII_SIMPLE_NETWORK_OFFLOAD_* values.
+  @param[out]  MaxFrameSize     The size of the largest frame VirtioNetOffloadTransmit()
+                                accepts, media header included.
+
+  @retval EFI_SUCCESS            The offloads were reported.
+  @retval EFI_NOT_STARTED        The network interface has not been initialized.
+  @retval EFI_INVALID_PARAMETER  One of the parameters is NULL.
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetOffloadGetCapabilities (
+  IN  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  OUT UINT32                                 *Capabilities,
+  OUT UINTN                                  *MaxFrameSize
+  )
+{
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+
+  if ((This == NULL) || (Capabilities == NULL) || (MaxFrameSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev    = VIRTIO_NET_FROM_OFFLOAD (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Dev->Snm.State != EfiSimpleNetworkInitialized) {
+    Status = EFI_NOT_STARTED;
+    goto Exit;
+  }
+
+  *Capabilities = Dev->TxOffloads;
+  if ((Dev->TxOffloads & EDKII_SIMPLE_NETWORK_OFFLOAD_TX_TCP4_SEGMENTATION) != 0) {
+    *MaxFrameSize = Dev->Snm.MediaHeaderSize + MAX_UINT16;
+  } else {
+    *MaxFrameSize = Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize;
+  }
+
+  Status = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Places a packet in the transmit queue of the virtio-net device, and have the
+  device complete it as described by Offload.
+
+  @param[in]  This        Pointer to the EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  HeaderSize  See VirtioNetTransmit().
+  @param[in]  BufferSize  See VirtioNetTransmit().
+  @param[in]  Buffer      See VirtioNetTransmit().
+  @param[in]  SrcAddr     See VirtioNetTransmit().
+  @param[in]  DestAddr    See VirtioNetTransmit().
+  @param[in]  Protocol    See VirtioNetTransmit().
+  @param[in]  Offload     The offloads requested for the packet.
+
+  @retval EFI_UNSUPPORTED  The device doesn't support the offloads in Offload.
+  @return                  See VirtioNetTransmit().
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetOffloadTransmit (
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL,
+  IN EDKII_SIMPLE_NETWORK_TX_OFFLOAD        *Offload
+  )
+{
+  if ((This == NULL) || (Offload == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return VirtioNetTransmitPacket (
+           VIRTIO_NET_FROM_OFFLOAD (This),
+           HeaderSize,
+           BufferSize,
+           Buffer,
+           SrcAddr,
+           DestAddr,
+           Protocol,
+           Offload
+           );
+}
@@ -73,7 +73,6 @@ VirtioNetReceive (
   UINT32      RxLen;
   UINTN       OrigBufferSize;
   UINT8       *RxPtr;
-  UINT16      AvailIdx;
   EFI_STATUS  NotifyStatus;
   UINTN       RxBufOffset;
 
@@ -165,18 +164,7 @@ VirtioNetReceive (
 RecycleDesc:
   ++Dev->RxLastUsed;
 
-  //
-  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
-  //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
-
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+  NotifyStatus = VirtioNetRecycleRxDesc (Dev, (UINT16)DescIdx);
   if (!EFI_ERROR (Status)) {
     // earlier error takes precedence
     Status = NotifyStatus;
@@ -0,0 +1,179 @@
+/** @file
+
+  Implementation of the EDKII Simple Network Receive Loan Protocol, which lends
+  the RX packets of the virtio-net device to the consumer instead of copying
+  them out like SNP.Receive() does.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "VirtioNet.h"
+
+/**
+  Receive a frame in a buffer lent by the network interface.
+
+  @param[in]   This           Pointer to the EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param[out]  Buffer         The buffer holding the received frame.
+  @param[out]  BufferSize     The size of the received frame.
+  @param[out]  Token          The token to return the buffer with.
+
+  @retval EFI_SUCCESS            A frame was received, and the buffer lent.
+  @retval EFI_NOT_STARTED        The network interface has not been started.
+  @retval EFI_NOT_READY          No frame has been received.
+  @retval EFI_OUT_OF_RESOURCES   Too many buffers are lent already.
+  @retval EFI_DEVICE_ERROR       The network interface is not initialized, or
+                                 received a short frame.
+  @retval EFI_INVALID_PARAMETER  One of the parameters is NULL.
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetRxLoanReceive (
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT VOID                                   **Buffer,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Token
+  )
+{
+  VNET_DEV           *Dev;
+  VNET_RX_LOAN_POOL  *Pool;
+  VNET_RX_LOAN       *Loan;
+  EFI_TPL            OldTpl;
+  EFI_TPL            PoolTpl;
+  EFI_STATUS         Status;
+  UINT16             RxCurUsed;
+  UINT16             UsedElemIdx;
+  UINT32             DescIdx;
+  UINT32             RxLen;
+  UINTN              RxBufOffset;
+
+  if ((This == NULL) || (Buffer == NULL) || (BufferSize == NULL) || (Token == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dev    = VIRTIO_NET_FROM_RX_LOAN (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  switch (Dev->Snm.State) {
+    case EfiSimpleNetworkStopped:
+      Status = EFI_NOT_STARTED;
+      goto Exit;
+    case EfiSimpleNetworkStarted:
+      Status = EFI_DEVICE_ERROR;
+      goto Exit;
+    default:
+      break;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  RxCurUsed = *Dev->RxRing.Used.Idx;
+  MemoryFence ();
+
+  if (Dev->RxLastUsed == RxCurUsed) {
+    Status = EFI_NOT_READY;
+    goto Exit;
+  }
+
+  Pool = Dev->RxLoanPool;
+  if (Pool->LentCount >= Pool->MaxLentCount) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit; // keep the packet for SNP.Receive()
+  }
+
+  UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
+  DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+
+  //
+  // the virtio-net request header must be complete; we skip it
+  //
+  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
+  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
+  //
+  // the host must not have filled in more data than requested
+  //
+  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+
+  ++Dev->RxLastUsed;
+
+  if (RxLen < Dev->Snm.MediaHeaderSize) {
+    //
+    // drop useless short packet
+    //
+    VirtioNetRecycleRxDesc (Dev, (UINT16)DescIdx);
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  Loan          = &Pool->Loans[DescIdx / 2];
+  Loan->Pool    = Pool;
+  Loan->DescIdx = (UINT16)DescIdx;
+
+  PoolTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  ++Pool->LentCount;
+  gBS->RestoreTPL (PoolTpl);
+
+  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
+                        Dev->RxBufDeviceBase);
+  *Buffer     = Dev->RxBuf + RxBufOffset;
+  *BufferSize = RxLen;
+  *Token      = Loan;
+  Status      = EFI_SUCCESS;
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Return a buffer lent by VirtioNetRxLoanReceive() to the network interface.
+
+  This may be called at TPL_NOTIFY, and after the network interface is shut
+  down.
+
+  @param[in]  This            Pointer to the EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL instance.
+  @param[in]  Token           The token returned by VirtioNetRxLoanReceive() with the buffer.
+
+**/
+VOID
+EFIAPI
+VirtioNetRxLoanReturn (
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Token
+  )
+{
+  VNET_RX_LOAN       *Loan;
+  VNET_RX_LOAN_POOL  *Pool;
+  EFI_TPL            OldTpl;
+
+  Loan = (VNET_RX_LOAN *)Token;
+  Pool = Loan->Pool;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  ASSERT (Pool->LentCount > 0);
+  --Pool->LentCount;
+
+  if (Pool->Dev != NULL) {
+    VirtioNetRecycleRxDesc (Pool->Dev, Loan->DescIdx);
+  } else if (Pool->LentCount == 0) {
+    //
+    // The RX ring has been shut down, and this is the last lent packet of it.
+    //
+    Pool->VirtIo->UnmapSharedBuffer (Pool->VirtIo, Pool->RxBufMap);
+    Pool->VirtIo->FreeSharedPages (
+                    Pool->VirtIo,
+                    Pool->RxBufNrPages,
+                    Pool->RxBuf
+                    );
+    FreePool (Pool);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
@@ -8,7 +8,9 @@
 
 **/
 
+#include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "VirtioNet.h"
 
@@ -42,6 +44,28 @@ VirtioNetShutdownRx (
   IN OUT VNET_DEV  *Dev
   )
 {
+  VNET_RX_LOAN_POOL  *Pool;
+  EFI_TPL            OldTpl;
+
+  //
+  // The device has been reset, it doesn't write the RX buffers any longer. If
+  // some of them are still lent, leave the RX buffer area to the loan pool;
+  // the last VirtioNetRxLoanReturn() call releases it.
+  //
+  Pool   = Dev->RxLoanPool;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Pool->LentCount > 0) {
+    Pool->Dev          = NULL;
+    Pool->RxBuf        = Dev->RxBuf;
+    Pool->RxBufNrPages = Dev->RxBufNrPages;
+    Pool->RxBufMap     = Dev->RxBufMap;
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  FreePool (Pool);
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RxBufMap);
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
@@ -50,6 +74,44 @@ VirtioNetShutdownRx (
                  );
 }
 
+/**
+  Resubmit an RX packet to the device.
+
+  The available ring is updated at TPL_NOTIFY, as lent packets may be returned
+  at that level, interrupting VirtioNetReceive().
+
+  @param[in,out] Dev      The VNET_DEV driver instance.
+  @param[in]     DescIdx  The head descriptor of the RX packet.
+
+  @return  Status codes from VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetRecycleRxDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT16    DescIdx
+  )
+{
+  EFI_TPL  OldTpl;
+  UINT16   AvailIdx;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  //
+  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
+  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] = DescIdx;
+
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = AvailIdx;
+
+  gBS->RestoreTPL (OldTpl);
+
+  MemoryFence ();
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
 VOID
 EFIAPI
 VirtioNetShutdownTx (
@@ -63,7 +125,7 @@ VirtioNetShutdownTx (
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->TxSharedReqMap);
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *(Dev->TxSharedReq)),
+                 EFI_SIZE_TO_PAGES (Dev->TxMaxPending * sizeof *(Dev->TxSharedReq)),
                  Dev->TxSharedReq
                  );
 
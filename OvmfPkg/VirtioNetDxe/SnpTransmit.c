@@ -1,6 +1,7 @@
 /** @file
 
-  Implementation of the SNP.Transmit() function and its private helpers if any.
+  Implementation of the SNP.Transmit() function and its private helpers if any,
+  shared with the EDKII Simple Network Offload Protocol.
 
   Copyright (C) 2013, Red Hat, Inc.
   Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
@@ -66,18 +67,65 @@ VirtioNetTransmit (
   IN UINT16                       *Protocol OPTIONAL
   )
 {
-  VNET_DEV              *Dev;
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return VirtioNetTransmitPacket (
+           VIRTIO_NET_FROM_SNP (This),
+           HeaderSize,
+           BufferSize,
+           Buffer,
+           SrcAddr,
+           DestAddr,
+           Protocol,
+           NULL
+           );
+}
+
+/**
+  Places a packet in the transmit queue of the virtio-net device, with the
+  offloads requested by the caller if any.
+
+  @param[in] Dev         The VNET_DEV driver instance.
+  @param[in] HeaderSize  See VirtioNetTransmit().
+  @param[in] BufferSize  See VirtioNetTransmit(). If the packet is segmented,
+                         it may exceed the MTU.
+  @param[in] Buffer      See VirtioNetTransmit().
+  @param[in] SrcAddr     See VirtioNetTransmit().
+  @param[in] DestAddr    See VirtioNetTransmit().
+  @param[in] Protocol    See VirtioNetTransmit().
+  @param[in] Offload     The offloads requested for the packet, or NULL.
+
+  @retval EFI_UNSUPPORTED  The device doesn't support the offloads in Offload.
+  @return                  See VirtioNetTransmit().
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetTransmitPacket (
+  IN VNET_DEV                         *Dev,
+  IN UINTN                            HeaderSize,
+  IN UINTN                            BufferSize,
+  IN VOID                             *Buffer,
+  IN EFI_MAC_ADDRESS                  *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                  *DestAddr OPTIONAL,
+  IN UINT16                           *Protocol OPTIONAL,
+  IN EDKII_SIMPLE_NETWORK_TX_OFFLOAD  *Offload  OPTIONAL
+  )
+{
   EFI_TPL               OldTpl;
   EFI_STATUS            Status;
   UINT16                DescIdx;
   UINT16                AvailIdx;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  UINTN                 MaxBufferSize;
+  VIRTIO_1_0_NET_REQ    *Req;
 
-  if ((This == NULL) || (BufferSize == 0) || (Buffer == NULL)) {
+  if ((BufferSize == 0) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  Dev    = VIRTIO_NET_FROM_SNP (This);
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
   switch (Dev->Snm.State) {
     case EfiSimpleNetworkStopped:
@@ -95,7 +143,40 @@ VirtioNetTransmit (
     goto Exit;
   }
 
-  if (BufferSize > Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize) {
+  MaxBufferSize = Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize;
+
+  if (Offload != NULL) {
+    if (Offload->ChecksumOffset != 0) {
+      if ((Dev->TxOffloads & EDKII_SIMPLE_NETWORK_OFFLOAD_TX_CHECKSUM) == 0) {
+        Status = EFI_UNSUPPORTED;
+        goto Exit;
+      }
+
+      if ((UINTN)Offload->ChecksumStart + Offload->ChecksumOffset + sizeof (UINT16) > BufferSize) {
+        Status = EFI_INVALID_PARAMETER;
+        goto Exit;
+      }
+    }
+
+    if (Offload->SegmentSize != 0) {
+      if ((Dev->TxOffloads & EDKII_SIMPLE_NETWORK_OFFLOAD_TX_TCP4_SEGMENTATION) == 0) {
+        Status = EFI_UNSUPPORTED;
+        goto Exit;
+      }
+
+      if ((Offload->ChecksumOffset == 0) ||
+          (Offload->HeaderSize <= Offload->ChecksumStart) ||
+          (Offload->HeaderSize > BufferSize))
+      {
+        Status = EFI_INVALID_PARAMETER;
+        goto Exit;
+      }
+
+      MaxBufferSize = Dev->Snm.MediaHeaderSize + MAX_UINT16;
+    }
+  }
+
+  if (BufferSize > MaxBufferSize) {
     Status = EFI_INVALID_PARAMETER;
     goto Exit;
   }
@@ -163,6 +244,27 @@ VirtioNetTransmit (
   Dev->TxRing.Desc[DescIdx + 1].Addr = DeviceAddress;
   Dev->TxRing.Desc[DescIdx + 1].Len  = (UINT32)BufferSize;
 
+  //
+  // virtio-0.9.5, Appendix C, Packet Transmission: fill in the request header
+  // of this packet.
+  //
+  Req = &Dev->TxSharedReq[DescIdx / 2];
+  if ((Offload != NULL) && (Offload->ChecksumOffset != 0)) {
+    Req->V0_9_5.Flags      = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+    Req->V0_9_5.CsumStart  = Offload->ChecksumStart;
+    Req->V0_9_5.CsumOffset = Offload->ChecksumOffset;
+  } else {
+    Req->V0_9_5.Flags = 0;
+  }
+
+  if ((Offload != NULL) && (Offload->SegmentSize != 0)) {
+    Req->V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_TCPV4;
+    Req->V0_9_5.GsoSize = Offload->SegmentSize;
+    Req->V0_9_5.HdrLen  = Offload->HeaderSize;
+  } else {
+    Req->V0_9_5.GsoType = VIRTIO_NET_HDR_GSO_NONE;
+  }
+
   //
   // the available index is never written by the host, we can read it back
   // without a barrier
@@ -20,6 +20,8 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkOffload.h>
+#include <Protocol/SimpleNetworkRxLoan.h>
 #include <Library/OrderedCollectionLib.h>
 
 #define VNET_SIG  SIGNATURE_32 ('V', 'N', 'E', 'T')
@@ -61,6 +63,8 @@
 //                               Receive are callable.
 //
 
+typedef struct _VNET_RX_LOAN_POOL VNET_RX_LOAN_POOL;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -69,35 +73,62 @@ typedef struct {
   //
   //                          field              init function
   //                          ------------------ ------------------------------
-  UINT32                         Signature;      // VirtioNetDriverBindingStart
-  VIRTIO_DEVICE_PROTOCOL         *VirtIo;        // VirtioNetDriverBindingStart
-  EFI_SIMPLE_NETWORK_PROTOCOL    Snp;            // VirtioNetSnpPopulate
-  EFI_SIMPLE_NETWORK_MODE        Snm;            // VirtioNetSnpPopulate
-  EFI_EVENT                      ExitBoot;       // VirtioNetSnpPopulate
-  EFI_DEVICE_PATH_PROTOCOL       *MacDevicePath; // VirtioNetDriverBindingStart
-  EFI_HANDLE                     MacHandle;      // VirtioNetDriverBindingStart
-
-  VRING                          RxRing;          // VirtioNetInitRing
-  VOID                           *RxRingMap;      // VirtioRingMap and
-                                                  // VirtioNetInitRing
-  UINT8                          *RxBuf;          // VirtioNetInitRx
-  UINT16                         RxLastUsed;      // VirtioNetInitRx
-  UINTN                          RxBufNrPages;    // VirtioNetInitRx
-  EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
-  VOID                           *RxBufMap;       // VirtioNetInitRx
-
-  VRING                          TxRing;           // VirtioNetInitRing
-  VOID                           *TxRingMap;       // VirtioRingMap and
-                                                   // VirtioNetInitRing
-  UINT16                         TxMaxPending;     // VirtioNetInitTx
-  UINT16                         TxCurPending;     // VirtioNetInitTx
-  UINT16                         *TxFreeStack;     // VirtioNetInitTx
-  VIRTIO_1_0_NET_REQ             *TxSharedReq;     // VirtioNetInitTx
-  VOID                           *TxSharedReqMap;  // VirtioNetInitTx
-  UINT16                         TxLastUsed;       // VirtioNetInitTx
-  ORDERED_COLLECTION             *TxBufCollection; // VirtioNetInitTx
+  UINT32                                   Signature;      // VirtioNetDriverBindingStart
+  VIRTIO_DEVICE_PROTOCOL                   *VirtIo;        // VirtioNetDriverBindingStart
+  EFI_SIMPLE_NETWORK_PROTOCOL              Snp;            // VirtioNetSnpPopulate
+  EFI_SIMPLE_NETWORK_MODE                  Snm;            // VirtioNetSnpPopulate
+  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL    RxLoan;         // VirtioNetSnpPopulate
+  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL    Offload;        // VirtioNetSnpPopulate
+  UINT32                                   TxOffloads;     // VirtioNetInitialize
+  EFI_EVENT                                ExitBoot;       // VirtioNetSnpPopulate
+  EFI_DEVICE_PATH_PROTOCOL                 *MacDevicePath; // VirtioNetDriverBindingStart
+  EFI_HANDLE                               MacHandle;      // VirtioNetDriverBindingStart
+
+  VRING                                    RxRing;          // VirtioNetInitRing
+  VOID                                     *RxRingMap;      // VirtioRingMap and
+                                                            // VirtioNetInitRing
+  UINT8                                    *RxBuf;          // VirtioNetInitRx
+  UINT16                                   RxLastUsed;      // VirtioNetInitRx
+  UINTN                                    RxBufNrPages;    // VirtioNetInitRx
+  EFI_PHYSICAL_ADDRESS                     RxBufDeviceBase; // VirtioNetInitRx
+  VOID                                     *RxBufMap;       // VirtioNetInitRx
+  VNET_RX_LOAN_POOL                        *RxLoanPool;     // VirtioNetInitRx
+
+  VRING                                    TxRing;           // VirtioNetInitRing
+  VOID                                     *TxRingMap;       // VirtioRingMap and
+                                                             // VirtioNetInitRing
+  UINT16                                   TxMaxPending;     // VirtioNetInitTx
+  UINT16                                   TxCurPending;     // VirtioNetInitTx
+  UINT16                                   *TxFreeStack;     // VirtioNetInitTx
+  VIRTIO_1_0_NET_REQ                       *TxSharedReq;     // VirtioNetInitTx,
+                                                             // one per packet
+  VOID                                     *TxSharedReqMap;  // VirtioNetInitTx
+  UINT16                                   TxLastUsed;       // VirtioNetInitTx
+  ORDERED_COLLECTION                       *TxBufCollection; // VirtioNetInitTx
 } VNET_DEV;
 
+//
+// RX packets lent through EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL. A lent packet
+// is not resubmitted to the device until it is returned. If the RX ring is shut
+// down while packets are still lent, the pool takes over the RX buffer area and
+// releases it when the last packet comes back.
+//
+typedef struct {
+  VNET_RX_LOAN_POOL    *Pool;
+  UINT16               DescIdx;
+} VNET_RX_LOAN;
+
+struct _VNET_RX_LOAN_POOL {
+  VNET_DEV                  *Dev;          // NULL once the RX ring is shut down
+  VIRTIO_DEVICE_PROTOCOL    *VirtIo;
+  UINT8                     *RxBuf;        // valid once the RX ring is shut down
+  UINTN                     RxBufNrPages;  // valid once the RX ring is shut down
+  VOID                      *RxBufMap;     // valid once the RX ring is shut down
+  UINT16                    LentCount;
+  UINT16                    MaxLentCount;
+  VNET_RX_LOAN              *Loans;        // indexed by head descriptor / 2
+};
+
 //
 // In order to avoid duplication of interface documentation, please find all
 // leading comments near the respective function / variable definitions (not
@@ -111,6 +142,12 @@ typedef struct {
 #define VIRTIO_NET_FROM_SNP(SnpPointer) \
         CR (SnpPointer, VNET_DEV, Snp, VNET_SIG)
 
+#define VIRTIO_NET_FROM_RX_LOAN(RxLoanPointer) \
+        CR (RxLoanPointer, VNET_DEV, RxLoan, VNET_SIG)
+
+#define VIRTIO_NET_FROM_OFFLOAD(OffloadPointer) \
+        CR (OffloadPointer, VNET_DEV, Offload, VNET_SIG)
+
 #define VIRTIO_CFG_WRITE(Dev, Field, Value)  ((Dev)->VirtIo->WriteDevice (  \
                                                 (Dev)->VirtIo,              \
                                                 OFFSET_OF_VNET (Field),     \
@@ -252,15 +289,78 @@ VirtioNetReceive (
   OUT UINT16                      *Protocol   OPTIONAL
   );
 
+//
+// member functions implementing the EDKII Simple Network Receive Loan Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetRxLoanReceive (
+  IN  EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  OUT VOID                                   **Buffer,
+  OUT UINTN                                  *BufferSize,
+  OUT VOID                                   **Token
+  );
+
+VOID
+EFIAPI
+VirtioNetRxLoanReturn (
+  IN EDKII_SIMPLE_NETWORK_RX_LOAN_PROTOCOL  *This,
+  IN VOID                                   *Token
+  );
+
+//
+// member functions implementing the EDKII Simple Network Offload Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetOffloadGetCapabilities (
+  IN  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  OUT UINT32                                 *Capabilities,
+  OUT UINTN                                  *MaxFrameSize
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioNetOffloadTransmit (
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL,
+  IN EDKII_SIMPLE_NETWORK_TX_OFFLOAD        *Offload
+  );
+
 //
 // utility functions shared by various SNP member functions
 //
+EFI_STATUS
+EFIAPI
+VirtioNetTransmitPacket (
+  IN VNET_DEV                         *Dev,
+  IN UINTN                            HeaderSize,
+  IN UINTN                            BufferSize,
+  IN VOID                             *Buffer,
+  IN EFI_MAC_ADDRESS                  *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                  *DestAddr OPTIONAL,
+  IN UINT16                           *Protocol OPTIONAL,
+  IN EDKII_SIMPLE_NETWORK_TX_OFFLOAD  *Offload  OPTIONAL
+  );
+
 VOID
 EFIAPI
 VirtioNetShutdownRx (
   IN OUT VNET_DEV  *Dev
   );
 
+EFI_STATUS
+EFIAPI
+VirtioNetRecycleRxDesc (
+  IN OUT VNET_DEV  *Dev,
+  IN     UINT16    DescIdx
+  );
+
 VOID
 EFIAPI
 VirtioNetShutdownTx (
@@ -71,13 +71,24 @@ XenPvBlockFree (
   )
 {
   XENBUS_PROTOCOL  *XenBusIo = Dev->XenBusIo;
+  UINTN            Index;
 
-  if (Dev->RingRef != 0) {
-    XenBusIo->GrantEndAccess (XenBusIo, Dev->RingRef);
+  for (Index = 0; Index < Dev->PoolSize; Index++) {
+    XenBusIo->GrantEndAccess (XenBusIo, Dev->PoolRef[Index]);
+  }
+
+  if (Dev->PoolPages != NULL) {
+    FreePages (Dev->PoolPages, Dev->PoolSize);
+  }
+
+  for (Index = 0; Index < ((UINTN)1 << Dev->RingPageOrder); Index++) {
+    if (Dev->RingRef[Index] != 0) {
+      XenBusIo->GrantEndAccess (XenBusIo, Dev->RingRef[Index]);
+    }
   }
 
   if (Dev->Ring.sring != NULL) {
-    FreePages (Dev->Ring.sring, 1);
+    FreePages (Dev->Ring.sring, (UINTN)1 << Dev->RingPageOrder);
   }
 
   if (Dev->EventChannel != 0) {
@@ -147,6 +158,37 @@ XenPvBlkWaitForBackendState (
   return Status;
 }
 
+/**
+  Remove the nodes written by XenPvBlockFrontInitialization() from XenStore.
+
+  @param Dev  A XEN_BLOCK_FRONT_DEVICE instance.
+**/
+STATIC
+VOID
+XenPvBlockRemoveFrontendNodes (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev
+  )
+{
+  XENBUS_PROTOCOL  *XenBusIo = Dev->XenBusIo;
+  CHAR8            RingRefNode[sizeof "ring-ref" + 2];
+  UINTN            Index;
+
+  if (Dev->RingPageOrder == 0) {
+    XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
+  } else {
+    for (Index = 0; Index < ((UINTN)1 << Dev->RingPageOrder); Index++) {
+      AsciiSPrint (RingRefNode, sizeof RingRefNode, "ring-ref%Lu", (UINT64)Index);
+      XenBusIo->XsRemove (XenBusIo, XST_NIL, RingRefNode);
+    }
+
+    XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-page-order");
+  }
+
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "feature-persistent");
+}
+
 EFI_STATUS
 XenPvBlockFrontInitialization (
   IN  XENBUS_PROTOCOL         *XenBusIo,
@@ -162,6 +204,8 @@ XenPvBlockFrontInitialization (
   XenbusState             State;
   UINT64                  Value;
   CHAR8                   *Params;
+  UINTN                   Index;
+  CHAR8                   RingRefNode[sizeof "ring-ref" + 2];
 
   ASSERT (NodeName != NULL);
 
@@ -213,16 +257,30 @@ XenPvBlockFrontInitialization (
   Dev->DomainId = (domid_t)Value;
   XenBusIo->EventChannelAllocate (XenBusIo, Dev->DomainId, &Dev->EventChannel);
 
-  SharedRing = (blkif_sring_t *)AllocatePages (1);
+  //
+  // Use a multi-page ring if the backend supports it, so that more requests
+  // can be in flight.
+  //
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "max-ring-page-order", TRUE, &Value);
+  Dev->RingPageOrder = (UINT32)MIN (Value, XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER);
+
+  SharedRing = (blkif_sring_t *)AllocatePages ((UINTN)1 << Dev->RingPageOrder);
+  if (SharedRing == NULL) {
+    goto Error;
+  }
+
   SHARED_RING_INIT (SharedRing);
-  FRONT_RING_INIT (&Dev->Ring, SharedRing, EFI_PAGE_SIZE);
-  XenBusIo->GrantAccess (
-              XenBusIo,
-              Dev->DomainId,
-              (INTN)SharedRing >> EFI_PAGE_SHIFT,
-              FALSE,
-              &Dev->RingRef
-              );
+  FRONT_RING_INIT (&Dev->Ring, SharedRing, EFI_PAGE_SIZE << Dev->RingPageOrder);
+  for (Index = 0; Index < ((UINTN)1 << Dev->RingPageOrder); Index++) {
+    XenBusIo->GrantAccess (
+                XenBusIo,
+                Dev->DomainId,
+                ((INTN)SharedRing >> EFI_PAGE_SHIFT) + Index,
+                FALSE,
+                &Dev->RingRef[Index]
+                );
+  }
 
 Again:
   Status = XenBusIo->XsTransactionStart (XenBusIo, &Transaction);
@@ -231,17 +289,48 @@ Again:
     goto Error;
   }
 
-  Status = XenBusIo->XsPrintf (
-                       XenBusIo,
-                       &Transaction,
-                       NodeName,
-                       "ring-ref",
-                       "%d",
-                       Dev->RingRef
-                       );
-  if (Status != XENSTORE_STATUS_SUCCESS) {
-    DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write ring-ref.\n"));
-    goto AbortTransaction;
+  if (Dev->RingPageOrder == 0) {
+    Status = XenBusIo->XsPrintf (
+                         XenBusIo,
+                         &Transaction,
+                         NodeName,
+                         "ring-ref",
+                         "%d",
+                         Dev->RingRef[0]
+                         );
+    if (Status != XENSTORE_STATUS_SUCCESS) {
+      DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write ring-ref.\n"));
+      goto AbortTransaction;
+    }
+  } else {
+    Status = XenBusIo->XsPrintf (
+                         XenBusIo,
+                         &Transaction,
+                         NodeName,
+                         "ring-page-order",
+                         "%d",
+                         Dev->RingPageOrder
+                         );
+    if (Status != XENSTORE_STATUS_SUCCESS) {
+      DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write ring-page-order.\n"));
+      goto AbortTransaction;
+    }
+
+    for (Index = 0; Index < ((UINTN)1 << Dev->RingPageOrder); Index++) {
+      AsciiSPrint (RingRefNode, sizeof RingRefNode, "ring-ref%Lu", (UINT64)Index);
+      Status = XenBusIo->XsPrintf (
+                           XenBusIo,
+                           &Transaction,
+                           NodeName,
+                           RingRefNode,
+                           "%d",
+                           Dev->RingRef[Index]
+                           );
+      if (Status != XENSTORE_STATUS_SUCCESS) {
+        DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write %a.\n", RingRefNode));
+        goto AbortTransaction;
+      }
+    }
   }
 
   Status = XenBusIo->XsPrintf (
@@ -270,6 +359,19 @@ Again:
     goto AbortTransaction;
   }
 
+  Status = XenBusIo->XsPrintf (
+                       XenBusIo,
+                       &Transaction,
+                       NodeName,
+                       "feature-persistent",
+                       "%d",
+                       1
+                       );
+  if (Status != XENSTORE_STATUS_SUCCESS) {
+    DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write feature-persistent.\n"));
+    goto AbortTransaction;
+  }
+
   Status = XenBusIo->SetState (XenBusIo, &Transaction, XenbusStateConnected);
   if (Status != XENSTORE_STATUS_SUCCESS) {
     DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to switch state.\n"));
@@ -354,11 +456,67 @@ Again:
     Dev->MediaInfo.FeatureFlushCache = FALSE;
   }
 
+  // Default value
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "feature-persistent", TRUE, &Value);
+  if (Value == 1) {
+    Dev->MediaInfo.FeaturePersistent = TRUE;
+  } else {
+    Dev->MediaInfo.FeaturePersistent = FALSE;
+  }
+
+  // Default value
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "feature-max-indirect-segments", TRUE, &Value);
+  if (Value > BLKIF_MAX_SEGMENTS_PER_REQUEST) {
+    Dev->MediaInfo.MaxIndirectSegments = (UINT32)MIN (
+                                                   Value,
+                                                   XEN_BLOCK_FRONT_MAX_SEGMENTS
+                                                   );
+  } else {
+    Dev->MediaInfo.MaxIndirectSegments = 0;
+  }
+
+  //
+  // Grant the pages that are reused by all requests: the indirect segment
+  // pages, and with persistent grants, the data pages too.
+  //
+  if (Dev->MediaInfo.FeaturePersistent) {
+    Dev->PoolSize = XEN_BLOCK_FRONT_GRANT_POOL_SIZE;
+  } else if (Dev->MediaInfo.MaxIndirectSegments > 0) {
+    Dev->PoolSize = XEN_BLOCK_FRONT_MAX_IO_IN_FLIGHT;
+  }
+
+  if (Dev->PoolSize > 0) {
+    Dev->PoolPages = AllocatePages (Dev->PoolSize);
+    if (Dev->PoolPages == NULL) {
+      Dev->PoolSize = 0;
+      goto Error2;
+    }
+
+    for (Index = 0; Index < Dev->PoolSize; Index++) {
+      XenBusIo->GrantAccess (
+                  XenBusIo,
+                  Dev->DomainId,
+                  ((UINTN)Dev->PoolPages >> EFI_PAGE_SHIFT) + Index,
+                  FALSE,
+                  &Dev->PoolRef[Index]
+                  );
+      Dev->FreePoolGrant[Index] = (UINT16)(Dev->PoolSize - 1 - Index);
+    }
+
+    Dev->NumFreePoolGrant = Dev->PoolSize;
+  }
+
   DEBUG ((
     DEBUG_INFO,
-    "XenPvBlk: New disk with %ld sectors of %d bytes\n",
+    "XenPvBlk: New disk with %ld sectors of %d bytes, ring pages %d, "
+    "persistent grants %d, indirect segments %d\n",
     Dev->MediaInfo.Sectors,
-    Dev->MediaInfo.SectorSize
+    Dev->MediaInfo.SectorSize,
+    1 << Dev->RingPageOrder,
+    Dev->MediaInfo.FeaturePersistent,
+    Dev->MediaInfo.MaxIndirectSegments
     ));
 
   *DevPtr = Dev;
@@ -366,9 +524,7 @@ Again:
 
 Error2:
   XenBusIo->UnregisterWatch (XenBusIo, Dev->StateWatchToken);
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenPvBlockRemoveFrontendNodes (Dev);
   goto Error;
 AbortTransaction:
   XenBusIo->XsTransactionEnd (XenBusIo, &Transaction, TRUE);
@@ -464,9 +620,7 @@ XenPvBlockFrontShutdown (
 
 Close:
   XenBusIo->UnregisterWatch (XenBusIo, Dev->StateWatchToken);
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenPvBlockRemoveFrontendNodes (Dev);
 
   XenPvBlockFree (Dev);
 }
@@ -490,19 +644,133 @@ XenPvBlockWaitSlot (
   }
 }
 
+/**
+  Take a page from the pool of pages granted once to the backend, waiting for
+  the completion of requests if none is free.
+
+  @param Dev  A XEN_BLOCK_FRONT_DEVICE instance.
+
+  @return The index of the page in the pool.
+**/
+STATIC
+UINT16
+XenPvBlockGetPoolGrant (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev
+  )
+{
+  ASSERT (Dev->PoolSize > 0);
+  while (Dev->NumFreePoolGrant == 0) {
+    XenPvBlockAsyncIoPoll (Dev);
+  }
+
+  return Dev->FreePoolGrant[--Dev->NumFreePoolGrant];
+}
+
+/**
+  Return the page of the grant pool that holds a data segment of a request.
+
+  @param IoData  The request.
+  @param Index   The index of the segment in the request.
+**/
+STATIC
+UINT8 *
+XenPvBlockPoolPage (
+  IN XEN_BLOCK_FRONT_IO  *IoData,
+  IN INT32               Index
+  )
+{
+  return IoData->Dev->PoolPages + IoData->PoolGrant[Index] * EFI_PAGE_SIZE;
+}
+
+/**
+  Copy the part of the buffer of a request that falls in a data segment to or
+  from the page of the grant pool that backs the segment.
+
+  The segment keeps the offset of the data within the page, so that the
+  first_sect and last_sect fields are the same as without persistent grants.
+
+  @param IoData  The request.
+  @param Index   The index of the segment in the request.
+  @param ToPool  TRUE to copy the buffer to the pool page, FALSE to copy the
+                 pool page to the buffer.
+**/
+STATIC
+VOID
+XenPvBlockCopySegment (
+  IN XEN_BLOCK_FRONT_IO  *IoData,
+  IN INT32               Index,
+  IN BOOLEAN             ToPool
+  )
+{
+  UINTN  PageStart;
+  UINTN  Start;
+  UINTN  End;
+
+  PageStart = ((UINTN)IoData->Buffer & ~EFI_PAGE_MASK) + Index * EFI_PAGE_SIZE;
+  Start     = MAX (PageStart, (UINTN)IoData->Buffer);
+  End       = MIN (PageStart + EFI_PAGE_SIZE, (UINTN)IoData->Buffer + IoData->Size);
+
+  if (ToPool) {
+    CopyMem (
+      XenPvBlockPoolPage (IoData, Index) + (Start - PageStart),
+      (VOID *)Start,
+      End - Start
+      );
+  } else {
+    CopyMem (
+      (VOID *)Start,
+      XenPvBlockPoolPage (IoData, Index) + (Start - PageStart),
+      End - Start
+      );
+  }
+}
+
+/**
+  Return the largest size of a single request, for a buffer.
+
+  @param Dev     A XEN_BLOCK_FRONT_DEVICE instance.
+  @param Buffer  The buffer of the request.
+
+  @return The largest IoData->Size for XenPvBlockAsyncIo().
+**/
+UINTN
+XenPvBlockMaxIoSize (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev,
+  IN UINT8                   *Buffer
+  )
+{
+  UINTN  MaxSegments;
+
+  if (Dev->MediaInfo.MaxIndirectSegments > 0) {
+    MaxSegments = Dev->MediaInfo.MaxIndirectSegments;
+  } else {
+    MaxSegments = BLKIF_MAX_SEGMENTS_PER_REQUEST;
+  }
+
+  if (((UINTN)Buffer & EFI_PAGE_MASK) != 0) {
+    MaxSegments--;
+  }
+
+  return MaxSegments * EFI_PAGE_SIZE;
+}
+
 VOID
 XenPvBlockAsyncIo (
   IN OUT XEN_BLOCK_FRONT_IO  *IoData,
   IN     BOOLEAN             IsWrite
   )
 {
-  XEN_BLOCK_FRONT_DEVICE  *Dev      = IoData->Dev;
-  XENBUS_PROTOCOL         *XenBusIo = Dev->XenBusIo;
-  blkif_request_t         *Request;
-  RING_IDX                RingIndex;
-  BOOLEAN                 Notify;
-  INT32                   NumSegments, Index;
-  UINTN                   Start, End;
+  XEN_BLOCK_FRONT_DEVICE        *Dev      = IoData->Dev;
+  XENBUS_PROTOCOL               *XenBusIo = Dev->XenBusIo;
+  blkif_request_t               *Request;
+  blkif_request_indirect_t      *IndirectRequest;
+  struct blkif_request_segment  *Segment;
+  RING_IDX                      RingIndex;
+  BOOLEAN                       Notify;
+  BOOLEAN                       Indirect;
+  INT32                         NumSegments, Index;
+  UINT16                        IndirectGrant;
+  UINTN                         Start, End;
 
   // Can't io at non-sector-aligned location
   ASSERT (!(IoData->Sector & ((Dev->MediaInfo.SectorSize / 512) - 1)));
@@ -511,40 +779,87 @@ XenPvBlockAsyncIo (
   // Can't io non-sector-aligned buffer
   ASSERT (!((UINTN)IoData->Buffer & (Dev->MediaInfo.SectorSize - 1)));
 
-  Start          = (UINTN)IoData->Buffer & ~EFI_PAGE_MASK;
-  End            = ((UINTN)IoData->Buffer + IoData->Size + EFI_PAGE_SIZE - 1) & ~EFI_PAGE_MASK;
-  IoData->NumRef = NumSegments = (INT32)((End - Start) / EFI_PAGE_SIZE);
+  Start       = (UINTN)IoData->Buffer & ~EFI_PAGE_MASK;
+  End         = ((UINTN)IoData->Buffer + IoData->Size + EFI_PAGE_SIZE - 1) & ~EFI_PAGE_MASK;
+  NumSegments = (INT32)((End - Start) / EFI_PAGE_SIZE);
+  Indirect    = (BOOLEAN)(NumSegments > BLKIF_MAX_SEGMENTS_PER_REQUEST);
+
+  ASSERT (
+    NumSegments <= BLKIF_MAX_SEGMENTS_PER_REQUEST ||
+    NumSegments <= (INT32)Dev->MediaInfo.MaxIndirectSegments
+    );
+
+  IoData->IsWrite      = IsWrite;
+  IoData->NumSegments  = NumSegments;
+  IoData->NumRef       = 0;
+  IoData->NumPoolGrant = 0;
+
+  //
+  // Take the pool pages before the ring slot: waiting for a free page may
+  // consume responses, but must not race with a half-built request.
+  //
+  if (Dev->MediaInfo.FeaturePersistent) {
+    for (Index = 0; Index < NumSegments; Index++) {
+      IoData->PoolGrant[IoData->NumPoolGrant++] = XenPvBlockGetPoolGrant (Dev);
+      if (IsWrite) {
+        XenPvBlockCopySegment (IoData, Index, TRUE);
+      }
+    }
+  }
 
-  ASSERT (NumSegments <= BLKIF_MAX_SEGMENTS_PER_REQUEST);
+  IndirectGrant = 0;
+  if (Indirect) {
+    IndirectGrant                             = XenPvBlockGetPoolGrant (Dev);
+    IoData->PoolGrant[IoData->NumPoolGrant++] = IndirectGrant;
+  }
 
   XenPvBlockWaitSlot (Dev);
   RingIndex = Dev->Ring.req_prod_pvt;
   Request   = RING_GET_REQUEST (&Dev->Ring, RingIndex);
 
-  Request->operation     = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
-  Request->nr_segments   = (UINT8)NumSegments;
-  Request->handle        = Dev->DeviceId;
-  Request->id            = (UINTN)IoData;
-  Request->sector_number = IoData->Sector;
+  if (Indirect) {
+    IndirectRequest                    = (blkif_request_indirect_t *)Request;
+    IndirectRequest->operation         = BLKIF_OP_INDIRECT;
+    IndirectRequest->indirect_op       = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
+    IndirectRequest->nr_segments       = (UINT16)NumSegments;
+    IndirectRequest->handle            = Dev->DeviceId;
+    IndirectRequest->id                = (UINTN)IoData;
+    IndirectRequest->sector_number     = IoData->Sector;
+    IndirectRequest->indirect_grefs[0] = Dev->PoolRef[IndirectGrant];
+    Segment                            = (VOID *)(Dev->PoolPages + IndirectGrant * EFI_PAGE_SIZE);
+  } else {
+    Request->operation     = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
+    Request->nr_segments   = (UINT8)NumSegments;
+    Request->handle        = Dev->DeviceId;
+    Request->id            = (UINTN)IoData;
+    Request->sector_number = IoData->Sector;
+    Segment                = Request->seg;
+  }
 
   for (Index = 0; Index < NumSegments; Index++) {
-    Request->seg[Index].first_sect = 0;
-    Request->seg[Index].last_sect  = EFI_PAGE_SIZE / 512 - 1;
+    Segment[Index].first_sect = 0;
+    Segment[Index].last_sect  = EFI_PAGE_SIZE / 512 - 1;
   }
 
-  Request->seg[0].first_sect              = (UINT8)(((UINTN)IoData->Buffer & EFI_PAGE_MASK) / 512);
-  Request->seg[NumSegments - 1].last_sect =
+  Segment[0].first_sect              = (UINT8)(((UINTN)IoData->Buffer & EFI_PAGE_MASK) / 512);
+  Segment[NumSegments - 1].last_sect =
     (UINT8)((((UINTN)IoData->Buffer + IoData->Size - 1) & EFI_PAGE_MASK) / 512);
   for (Index = 0; Index < NumSegments; Index++) {
     UINTN  Data = Start + Index * EFI_PAGE_SIZE;
+
+    if (Dev->MediaInfo.FeaturePersistent) {
+      Segment[Index].gref = Dev->PoolRef[IoData->PoolGrant[Index]];
+      continue;
+    }
+
     XenBusIo->GrantAccess (
                 XenBusIo,
                 Dev->DomainId,
                 Data >> EFI_PAGE_SHIFT,
                 IsWrite,
-                &Request->seg[Index].gref
+                &Segment[Index].gref
                 );
-    IoData->GrantRef[Index] = Request->seg[Index].gref;
+    IoData->GrantRef[IoData->NumRef++] = Segment[Index].gref;
   }
 
   Dev->Ring.req_prod_pvt = RingIndex + 1;
@@ -673,6 +988,7 @@ XenPvBlockAsyncIoPoll (
       switch (Response->operation) {
         case BLKIF_OP_READ:
         case BLKIF_OP_WRITE:
+        case BLKIF_OP_INDIRECT:
         {
           INT32  Index;
 
@@ -681,18 +997,26 @@ XenPvBlockAsyncIoPoll (
               DEBUG_ERROR,
               "XenPvBlk: "
               "%a error %d on %a at sector %Lx, num bytes %Lx\n",
-              Response->operation == BLKIF_OP_READ ? "read" : "write",
+              IoData->IsWrite ? "write" : "read",
               Status,
               IoData->Dev->NodeName,
               (UINT64)IoData->Sector,
               (UINT64)IoData->Size
               ));
+          } else if (!IoData->IsWrite && Dev->MediaInfo.FeaturePersistent) {
+            for (Index = 0; Index < IoData->NumSegments; Index++) {
+              XenPvBlockCopySegment (IoData, Index, FALSE);
+            }
           }
 
           for (Index = 0; Index < IoData->NumRef; Index++) {
             Dev->XenBusIo->GrantEndAccess (Dev->XenBusIo, IoData->GrantRef[Index]);
           }
 
+          for (Index = 0; Index < IoData->NumPoolGrant; Index++) {
+            Dev->FreePoolGrant[Dev->NumFreePoolGrant++] = IoData->PoolGrant[Index];
+          }
+
           break;
         }
 
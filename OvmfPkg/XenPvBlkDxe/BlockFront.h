@@ -14,15 +14,56 @@
 typedef struct _XEN_BLOCK_FRONT_DEVICE  XEN_BLOCK_FRONT_DEVICE;
 typedef struct _XEN_BLOCK_FRONT_IO      XEN_BLOCK_FRONT_IO;
 
+//
+// Largest shared ring the frontend offers, in lb(pages).
+//
+#define XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER  4
+#define XEN_BLOCK_FRONT_MAX_RING_PAGES       (1 << XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER)
+
+//
+// Largest number of data segments (pages) in a single request. Requests with
+// more than BLKIF_MAX_SEGMENTS_PER_REQUEST segments are sent as
+// BLKIF_OP_INDIRECT requests, whose segments fit in a single indirect page.
+//
+#define XEN_BLOCK_FRONT_MAX_SEGMENTS  64
+
+//
+// Number of requests XenPvBlkDxe keeps in flight for one BlockIo call.
+//
+#define XEN_BLOCK_FRONT_MAX_IO_IN_FLIGHT  4
+
+//
+// Number of pages the frontend grants to the backend once and then reuses,
+// for the indirect segment pages, and -- with feature-persistent -- for the
+// data of every request. A request takes at most
+// (XEN_BLOCK_FRONT_MAX_SEGMENTS + 1) pages, so the pool never runs dry for
+// XEN_BLOCK_FRONT_MAX_IO_IN_FLIGHT requests.
+//
+#define XEN_BLOCK_FRONT_GRANT_POOL_SIZE \
+  (XEN_BLOCK_FRONT_MAX_IO_IN_FLIGHT * (XEN_BLOCK_FRONT_MAX_SEGMENTS + 1))
+
 struct _XEN_BLOCK_FRONT_IO {
   XEN_BLOCK_FRONT_DEVICE    *Dev;
   UINT8                     *Buffer;
   UINTN                     Size;
   UINTN                     Sector; ///< 512 bytes sector.
+  BOOLEAN                   IsWrite;
 
-  grant_ref_t               GrantRef[BLKIF_MAX_SEGMENTS_PER_REQUEST];
+  //
+  // Pages of Buffer granted for the duration of the request, when the
+  // backend does not support persistent grants.
+  //
+  grant_ref_t               GrantRef[XEN_BLOCK_FRONT_MAX_SEGMENTS];
   INT32                     NumRef;
 
+  //
+  // Indices of the pool grants the request uses. With persistent grants,
+  // the first NumSegments of them hold the data.
+  //
+  UINT16                    PoolGrant[XEN_BLOCK_FRONT_MAX_SEGMENTS + 1];
+  INT32                     NumPoolGrant;
+  INT32                     NumSegments;
+
   EFI_STATUS                Status;
 };
 
@@ -34,6 +75,8 @@ typedef struct {
   BOOLEAN    CdRom;
   BOOLEAN    FeatureBarrier;
   BOOLEAN    FeatureFlushCache;
+  BOOLEAN    FeaturePersistent;
+  UINT32     MaxIndirectSegments;
 } XEN_BLOCK_FRONT_MEDIA_INFO;
 
 #define XEN_BLOCK_FRONT_SIGNATURE  SIGNATURE_32 ('X', 'p', 'v', 'B')
@@ -43,8 +86,15 @@ struct _XEN_BLOCK_FRONT_DEVICE {
   domid_t                       DomainId;
 
   blkif_front_ring_t            Ring;
-  grant_ref_t                   RingRef;
+  UINT32                        RingPageOrder;
+  grant_ref_t                   RingRef[XEN_BLOCK_FRONT_MAX_RING_PAGES];
   evtchn_port_t                 EventChannel;
+
+  UINT8                         *PoolPages;
+  UINTN                         PoolSize;
+  grant_ref_t                   PoolRef[XEN_BLOCK_FRONT_GRANT_POOL_SIZE];
+  UINT16                        FreePoolGrant[XEN_BLOCK_FRONT_GRANT_POOL_SIZE];
+  UINTN                         NumFreePoolGrant;
   blkif_vdev_t                  DeviceId;
 
   CONST CHAR8                   *NodeName;
@@ -82,6 +132,12 @@ XenPvBlockIo (
   IN     BOOLEAN             IsWrite
   );
 
+UINTN
+XenPvBlockMaxIoSize (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev,
+  IN UINT8                   *Buffer
+  );
+
 VOID
 XenPvBlockAsyncIoPoll (
   IN XEN_BLOCK_FRONT_DEVICE  *Dev
@@ -73,10 +73,13 @@ XenPvBlkDxeBlockIoReadWriteBlocks (
   IN     BOOLEAN                IsWrite
   )
 {
-  XEN_BLOCK_FRONT_IO  IoData;
-  EFI_BLOCK_IO_MEDIA  *Media = This->Media;
-  UINTN               Sector;
-  EFI_STATUS          Status;
+  XEN_BLOCK_FRONT_DEVICE  *Dev;
+  XEN_BLOCK_FRONT_IO      IoData[XEN_BLOCK_FRONT_MAX_IO_IN_FLIGHT];
+  EFI_BLOCK_IO_MEDIA      *Media = This->Media;
+  UINTN                   Sector;
+  UINTN                   NumIo;
+  UINTN                   Index;
+  EFI_STATUS              Status;
 
   if (Buffer == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -150,28 +153,39 @@ XenPvBlkDxeBlockIoReadWriteBlocks (
     return Status;
   }
 
-  IoData.Dev = XEN_BLOCK_FRONT_FROM_BLOCK_IO (This);
-  Sector     = (UINTN)MultU64x32 (Lba, Media->BlockSize / 512);
+  Dev    = XEN_BLOCK_FRONT_FROM_BLOCK_IO (This);
+  Sector = (UINTN)MultU64x32 (Lba, Media->BlockSize / 512);
 
   while (BufferSize > 0) {
-    if (((UINTN)Buffer & EFI_PAGE_MASK) == 0) {
-      IoData.Size = MIN (
-                      BLKIF_MAX_SEGMENTS_PER_REQUEST * EFI_PAGE_SIZE,
-                      BufferSize
-                      );
-    } else {
-      IoData.Size = MIN (
-                      (BLKIF_MAX_SEGMENTS_PER_REQUEST - 1) * EFI_PAGE_SIZE,
-                      BufferSize
-                      );
+    //
+    // Keep several requests in flight, and wait for all of them.
+    //
+    for (NumIo = 0; NumIo < ARRAY_SIZE (IoData) && BufferSize > 0; NumIo++) {
+      IoData[NumIo].Dev    = Dev;
+      IoData[NumIo].Size   = MIN (XenPvBlockMaxIoSize (Dev, Buffer), BufferSize);
+      IoData[NumIo].Buffer = Buffer;
+      IoData[NumIo].Sector = Sector;
+      BufferSize          -= IoData[NumIo].Size;
+      Buffer               = (VOID *)((UINTN)Buffer + IoData[NumIo].Size);
+      Sector              += IoData[NumIo].Size / 512;
+      //
+      // Status value that correspond to an IO in progress.
+      //
+      IoData[NumIo].Status = EFI_ALREADY_STARTED;
+      XenPvBlockAsyncIo (&IoData[NumIo], IsWrite);
+    }
+
+    Status = EFI_SUCCESS;
+    for (Index = 0; Index < NumIo; Index++) {
+      while (IoData[Index].Status == EFI_ALREADY_STARTED) {
+        XenPvBlockAsyncIoPoll (Dev);
+      }
+
+      if (EFI_ERROR (IoData[Index].Status)) {
+        Status = IoData[Index].Status;
+      }
     }
 
-    IoData.Buffer = Buffer;
-    IoData.Sector = Sector;
-    BufferSize   -= IoData.Size;
-    Buffer        = (VOID *)((UINTN)Buffer + IoData.Size);
-    Sector       += IoData.Size / 512;
-    Status        = XenPvBlockIo (&IoData, IsWrite);
     if (EFI_ERROR (Status)) {
       DEBUG ((
         DEBUG_ERROR,
@@ -77,4 +77,17 @@ RedfishContentDecode (
   OUT UINTN  *DecodedLength
   );
 
+/**
+  Return the content codings RedfishContentDecode supports, to be sent
+  in the Accept-Encoding header of the requests.
+
+  @return  The Accept-Encoding header value, or NULL if only the
+           identity coding is supported.
+
+**/
+CONST CHAR8 *
+RedfishContentAcceptEncoding (
+  VOID
+  );
+
 #endif
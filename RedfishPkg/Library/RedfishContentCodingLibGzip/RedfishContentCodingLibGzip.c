@@ -0,0 +1,987 @@
+/** @file
+  gzip and deflate instance of RedfishContentCodingLib.
+
+  Decodes the "gzip" (RFC 1952) and "deflate" (RFC 1950) HTTP content
+  codings, so that large Redfish payloads such as BIOS attribute
+  registries can be transferred compressed. Encoding is not supported,
+  Redfish requests are small.
+
+  Copyright (c) 2022, Arm Limited. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <IndustryStandard/Http11.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/RedfishContentCodingLib.h>
+
+#define HTTP_CONTENT_ENCODING_X_GZIP  "x-gzip"
+
+///
+/// Deflate limits, RFC 1951.
+///
+#define DEFLATE_MAX_BITS      15
+#define DEFLATE_MAX_LCODES    286
+#define DEFLATE_MAX_DCODES    30
+#define DEFLATE_FIXED_LCODES  288
+#define DEFLATE_MAX_RATIO     1032
+
+///
+/// gzip header, RFC 1952.
+///
+#define GZIP_ID1        0x1F
+#define GZIP_ID2        0x8B
+#define GZIP_CM_DEFLATE 8
+#define GZIP_FHCRC      BIT1
+#define GZIP_FEXTRA     BIT2
+#define GZIP_FNAME      BIT3
+#define GZIP_FCOMMENT   BIT4
+#define GZIP_HEADER_SIZE   10
+#define GZIP_TRAILER_SIZE  8
+
+///
+/// zlib header, RFC 1950.
+///
+#define ZLIB_CM_DEFLATE    8
+#define ZLIB_FDICT         BIT5
+#define ZLIB_TRAILER_SIZE  4
+
+typedef struct {
+  /// Number of symbols of each code length.
+  UINT16    Count[DEFLATE_MAX_BITS + 1];
+  /// Symbols ordered by code.
+  UINT16    *Symbol;
+} HUFFMAN_TABLE;
+
+typedef struct {
+  CONST UINT8    *Input;
+  UINTN          InputLength;
+  UINTN          InputIndex;
+  UINT32         BitBuffer;
+  UINTN          BitCount;
+  UINT8          *Output;
+  UINTN          OutputSize;
+  UINTN          OutputIndex;
+} INFLATE_STATE;
+
+STATIC CONST UINT16  mLengthBase[29] = {
+  3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+STATIC CONST UINT8  mLengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+STATIC CONST UINT16  mDistanceBase[30] = {
+  1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+  33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+  1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+STATIC CONST UINT8  mDistanceExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+  6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+STATIC CONST UINT8  mCodeLengthOrder[19] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/**
+  Read bits from the compressed stream, least significant bit first.
+
+  @param[in, out]  State  The inflate state.
+  @param[in]       Need   Number of bits to read, up to 16.
+  @param[out]      Value  The bits read.
+
+  @retval EFI_SUCCESS            The bits are read.
+  @retval EFI_INVALID_PARAMETER  The stream is truncated.
+
+**/
+STATIC
+EFI_STATUS
+InflateGetBits (
+  IN OUT INFLATE_STATE  *State,
+  IN     UINTN          Need,
+  OUT    UINT32         *Value
+  )
+{
+  while (State->BitCount < Need) {
+    if (State->InputIndex == State->InputLength) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    State->BitBuffer |= (UINT32)State->Input[State->InputIndex++] << State->BitCount;
+    State->BitCount  += 8;
+  }
+
+  *Value             = State->BitBuffer & ((1U << Need) - 1);
+  State->BitBuffer >>= Need;
+  State->BitCount   -= Need;
+  return EFI_SUCCESS;
+}
+
+/**
+  Make room for output bytes, growing the output buffer if needed.
+
+  @param[in, out]  State  The inflate state.
+  @param[in]       Size   Number of bytes to be written.
+
+  @retval EFI_SUCCESS           There is room for Size bytes.
+  @retval EFI_OUT_OF_RESOURCES  The buffer cannot be grown.
+
+**/
+STATIC
+EFI_STATUS
+InflateReserveOutput (
+  IN OUT INFLATE_STATE  *State,
+  IN     UINTN          Size
+  )
+{
+  UINTN  NewSize;
+  UINT8  *NewOutput;
+
+  if (State->OutputSize - State->OutputIndex >= Size) {
+    return EFI_SUCCESS;
+  }
+
+  NewSize = MAX (State->OutputSize * 2, State->OutputIndex + Size);
+  NewSize = MAX (NewSize, SIZE_64KB);
+  if (NewSize > State->InputLength * DEFLATE_MAX_RATIO + SIZE_64KB) {
+    NewSize = State->InputLength * DEFLATE_MAX_RATIO + SIZE_64KB;
+    if (NewSize - State->OutputIndex < Size) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  NewOutput = ReallocatePool (State->OutputSize, NewSize, State->Output);
+  if (NewOutput == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  State->Output     = NewOutput;
+  State->OutputSize = NewSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Build a canonical Huffman decoding table from code lengths.
+
+  @param[out]  Table    The table to build. Symbol must have room for
+                        Count entries.
+  @param[in]   Lengths  The code length of each symbol.
+  @param[in]   Count    Number of symbols.
+
+  @retval EFI_SUCCESS            The table is built.
+  @retval EFI_INVALID_PARAMETER  The code lengths are over-subscribed.
+
+**/
+STATIC
+EFI_STATUS
+InflateBuildTable (
+  OUT HUFFMAN_TABLE  *Table,
+  IN  CONST UINT8    *Lengths,
+  IN  UINTN          Count
+  )
+{
+  UINT16  Offsets[DEFLATE_MAX_BITS + 1];
+  INT32   Left;
+  UINTN   Length;
+  UINTN   Symbol;
+
+  ZeroMem (Table->Count, sizeof (Table->Count));
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    Table->Count[Lengths[Symbol]]++;
+  }
+
+  //
+  // An incomplete code is accepted; decoding an unused code fails.
+  //
+  Left = 1;
+  for (Length = 1; Length <= DEFLATE_MAX_BITS; Length++) {
+    Left <<= 1;
+    Left  -= Table->Count[Length];
+    if (Left < 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Offsets[1] = 0;
+  for (Length = 1; Length < DEFLATE_MAX_BITS; Length++) {
+    Offsets[Length + 1] = Offsets[Length] + Table->Count[Length];
+  }
+
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    if (Lengths[Symbol] != 0) {
+      Table->Symbol[Offsets[Lengths[Symbol]]++] = (UINT16)Symbol;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode one symbol.
+
+  @param[in, out]  State   The inflate state.
+  @param[in]       Table   The Huffman table.
+  @param[out]      Symbol  The decoded symbol.
+
+  @retval EFI_SUCCESS            The symbol is decoded.
+  @retval EFI_INVALID_PARAMETER  The stream is truncated or uses an
+                                 unused code.
+
+**/
+STATIC
+EFI_STATUS
+InflateDecode (
+  IN OUT INFLATE_STATE        *State,
+  IN     CONST HUFFMAN_TABLE  *Table,
+  OUT    UINTN                *Symbol
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Bit;
+  UINTN       Code;
+  UINTN       First;
+  UINTN       Index;
+  UINTN       Length;
+
+  Code  = 0;
+  First = 0;
+  Index = 0;
+  for (Length = 1; Length <= DEFLATE_MAX_BITS; Length++) {
+    Status = InflateGetBits (State, 1, &Bit);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Code |= Bit;
+    if (Code < First + Table->Count[Length]) {
+      *Symbol = Table->Symbol[Index + (Code - First)];
+      return EFI_SUCCESS;
+    }
+
+    Index  += Table->Count[Length];
+    First  += Table->Count[Length];
+    First <<= 1;
+    Code  <<= 1;
+  }
+
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  Inflate a stored block.
+
+  @param[in, out]  State  The inflate state.
+
+  @retval EFI_SUCCESS            The block is inflated.
+  @retval EFI_INVALID_PARAMETER  The block is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+InflateStored (
+  IN OUT INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+
+  //
+  // Discard the bits left in the current byte.
+  //
+  State->BitBuffer = 0;
+  State->BitCount  = 0;
+
+  if (State->InputLength - State->InputIndex < 4) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Length = State->Input[State->InputIndex] | (State->Input[State->InputIndex + 1] << 8);
+  if ((State->Input[State->InputIndex + 2] != (UINT8)~Length) ||
+      (State->Input[State->InputIndex + 3] != (UINT8)(~Length >> 8)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  State->InputIndex += 4;
+  if (State->InputLength - State->InputIndex < Length) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = InflateReserveOutput (State, Length);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CopyMem (State->Output + State->OutputIndex, State->Input + State->InputIndex, Length);
+  State->OutputIndex += Length;
+  State->InputIndex  += Length;
+  return EFI_SUCCESS;
+}
+
+/**
+  Inflate the codes of a Huffman compressed block.
+
+  @param[in, out]  State         The inflate state.
+  @param[in]       LengthTable   The literal/length table.
+  @param[in]       DistanceTable The distance table.
+
+  @retval EFI_SUCCESS            The block is inflated.
+  @retval EFI_INVALID_PARAMETER  The block is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+InflateCodes (
+  IN OUT INFLATE_STATE        *State,
+  IN     CONST HUFFMAN_TABLE  *LengthTable,
+  IN     CONST HUFFMAN_TABLE  *DistanceTable
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Symbol;
+  UINT32      Extra;
+  UINTN       Length;
+  UINTN       Distance;
+  UINT8       *Copy;
+
+  while (TRUE) {
+    Status = InflateDecode (State, LengthTable, &Symbol);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Symbol < 256) {
+      Status = InflateReserveOutput (State, 1);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      State->Output[State->OutputIndex++] = (UINT8)Symbol;
+      continue;
+    }
+
+    if (Symbol == 256) {
+      return EFI_SUCCESS;
+    }
+
+    Symbol -= 257;
+    if (Symbol >= ARRAY_SIZE (mLengthBase)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = InflateGetBits (State, mLengthExtra[Symbol], &Extra);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Length = mLengthBase[Symbol] + Extra;
+
+    Status = InflateDecode (State, DistanceTable, &Symbol);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Symbol >= ARRAY_SIZE (mDistanceBase)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = InflateGetBits (State, mDistanceExtra[Symbol], &Extra);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Distance = mDistanceBase[Symbol] + Extra;
+    if (Distance > State->OutputIndex) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = InflateReserveOutput (State, Length);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    //
+    // The source and destination may overlap, copy forward byte by byte.
+    //
+    Copy = State->Output + State->OutputIndex;
+    State->OutputIndex += Length;
+    while (Length-- != 0) {
+      *Copy = *(Copy - Distance);
+      Copy++;
+    }
+  }
+}
+
+/**
+  Inflate a block compressed with the fixed Huffman codes.
+
+  @param[in, out]  State  The inflate state.
+
+  @retval EFI_SUCCESS            The block is inflated.
+  @retval EFI_INVALID_PARAMETER  The block is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+InflateFixed (
+  IN OUT INFLATE_STATE  *State
+  )
+{
+  STATIC BOOLEAN        Built = FALSE;
+  STATIC UINT16         LengthSymbol[DEFLATE_FIXED_LCODES];
+  STATIC UINT16         DistanceSymbol[DEFLATE_MAX_DCODES];
+  STATIC HUFFMAN_TABLE  LengthTable = { { 0 }, LengthSymbol };
+  STATIC HUFFMAN_TABLE  DistanceTable = { { 0 }, DistanceSymbol };
+  UINT8                 Lengths[DEFLATE_FIXED_LCODES];
+  UINTN                 Symbol;
+
+  if (!Built) {
+    for (Symbol = 0; Symbol < 144; Symbol++) {
+      Lengths[Symbol] = 8;
+    }
+
+    for ( ; Symbol < 256; Symbol++) {
+      Lengths[Symbol] = 9;
+    }
+
+    for ( ; Symbol < 280; Symbol++) {
+      Lengths[Symbol] = 7;
+    }
+
+    for ( ; Symbol < DEFLATE_FIXED_LCODES; Symbol++) {
+      Lengths[Symbol] = 8;
+    }
+
+    InflateBuildTable (&LengthTable, Lengths, DEFLATE_FIXED_LCODES);
+
+    SetMem (Lengths, DEFLATE_MAX_DCODES, 5);
+    InflateBuildTable (&DistanceTable, Lengths, DEFLATE_MAX_DCODES);
+    Built = TRUE;
+  }
+
+  return InflateCodes (State, &LengthTable, &DistanceTable);
+}
+
+/**
+  Inflate a block compressed with dynamic Huffman codes.
+
+  @param[in, out]  State  The inflate state.
+
+  @retval EFI_SUCCESS            The block is inflated.
+  @retval EFI_INVALID_PARAMETER  The block is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+InflateDynamic (
+  IN OUT INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS     Status;
+  UINT8          Lengths[DEFLATE_MAX_LCODES + DEFLATE_MAX_DCODES];
+  UINT16         LengthSymbol[DEFLATE_MAX_LCODES];
+  UINT16         DistanceSymbol[DEFLATE_MAX_DCODES];
+  HUFFMAN_TABLE  LengthTable;
+  HUFFMAN_TABLE  DistanceTable;
+  UINT32         LengthCount;
+  UINT32         DistanceCount;
+  UINT32         CodeCount;
+  UINT32         Value;
+  UINTN          Index;
+  UINTN          Symbol;
+  UINTN          Repeat;
+  UINT8          Length;
+
+  LengthTable.Symbol   = LengthSymbol;
+  DistanceTable.Symbol = DistanceSymbol;
+
+  Status = InflateGetBits (State, 5, &LengthCount);
+  if (!EFI_ERROR (Status)) {
+    Status = InflateGetBits (State, 5, &DistanceCount);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = InflateGetBits (State, 4, &CodeCount);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  LengthCount   += 257;
+  DistanceCount += 1;
+  CodeCount     += 4;
+  if ((LengthCount > DEFLATE_MAX_LCODES) || (DistanceCount > DEFLATE_MAX_DCODES)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Read the code length code lengths, then the code lengths.
+  //
+  ZeroMem (Lengths, sizeof (Lengths));
+  for (Index = 0; Index < CodeCount; Index++) {
+    Status = InflateGetBits (State, 3, &Value);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Lengths[mCodeLengthOrder[Index]] = (UINT8)Value;
+  }
+
+  Status = InflateBuildTable (&LengthTable, Lengths, ARRAY_SIZE (mCodeLengthOrder));
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Index = 0;
+  while (Index < LengthCount + DistanceCount) {
+    Status = InflateDecode (State, &LengthTable, &Symbol);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Symbol < 16) {
+      Lengths[Index++] = (UINT8)Symbol;
+      continue;
+    }
+
+    Length = 0;
+    if (Symbol == 16) {
+      if (Index == 0) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      Length = Lengths[Index - 1];
+      Status = InflateGetBits (State, 2, &Value);
+      Repeat = 3 + Value;
+    } else if (Symbol == 17) {
+      Status = InflateGetBits (State, 3, &Value);
+      Repeat = 3 + Value;
+    } else {
+      Status = InflateGetBits (State, 7, &Value);
+      Repeat = 11 + Value;
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Index + Repeat > LengthCount + DistanceCount) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    while (Repeat-- != 0) {
+      Lengths[Index++] = Length;
+    }
+  }
+
+  //
+  // The end-of-block code must be present.
+  //
+  if (Lengths[256] == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = InflateBuildTable (&LengthTable, Lengths, LengthCount);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = InflateBuildTable (&DistanceTable, Lengths + LengthCount, DistanceCount);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return InflateCodes (State, &LengthTable, &DistanceTable);
+}
+
+/**
+  Inflate a raw deflate stream, RFC 1951.
+
+  @param[in, out]  State  The inflate state. Output may be NULL, the
+                          output buffer is grown as needed. On return
+                          InputIndex is the first byte after the stream.
+
+  @retval EFI_SUCCESS            The stream is inflated.
+  @retval EFI_INVALID_PARAMETER  The stream is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+Inflate (
+  IN OUT INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Last;
+  UINT32      Type;
+
+  do {
+    Status = InflateGetBits (State, 1, &Last);
+    if (!EFI_ERROR (Status)) {
+      Status = InflateGetBits (State, 2, &Type);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    switch (Type) {
+      case 0:
+        Status = InflateStored (State);
+        break;
+      case 1:
+        Status = InflateFixed (State);
+        break;
+      case 2:
+        Status = InflateDynamic (State);
+        break;
+      default:
+        Status = EFI_INVALID_PARAMETER;
+        break;
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  } while (Last == 0);
+
+  //
+  // Give back the unused bytes of the bit buffer.
+  //
+  State->InputIndex -= State->BitCount / 8;
+  State->BitBuffer   = 0;
+  State->BitCount    = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Skip a NULL terminated string of the gzip header.
+
+  @param[in]      Content  The gzip content.
+  @param[in]      Length   Length of the gzip content.
+  @param[in, out] Index    Index of the string, index of the byte
+                           following the string on return.
+
+  @retval EFI_SUCCESS            The string is skipped.
+  @retval EFI_INVALID_PARAMETER  The string is not terminated.
+
+**/
+STATIC
+EFI_STATUS
+GzipSkipString (
+  IN     CONST UINT8  *Content,
+  IN     UINTN        Length,
+  IN OUT UINTN        *Index
+  )
+{
+  while (*Index < Length) {
+    if (Content[(*Index)++] == 0) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  Decode gzip content, RFC 1952.
+
+  @param[in]   Content        The gzip content.
+  @param[in]   ContentLength  Length of the gzip content.
+  @param[out]  State          The inflate state receiving the output.
+
+  @retval EFI_SUCCESS            The content is decoded.
+  @retval EFI_INVALID_PARAMETER  The content is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+GzipDecode (
+  IN  CONST UINT8    *Content,
+  IN  UINTN          ContentLength,
+  OUT INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINT8       Flags;
+  UINT32      Crc;
+  UINT32      Size;
+
+  if ((ContentLength < GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE) ||
+      (Content[0] != GZIP_ID1) ||
+      (Content[1] != GZIP_ID2) ||
+      (Content[2] != GZIP_CM_DEFLATE))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Flags = Content[3];
+  Index = GZIP_HEADER_SIZE;
+  if ((Flags & GZIP_FEXTRA) != 0) {
+    if (ContentLength - Index < 2) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Index += 2 + (Content[Index] | (Content[Index + 1] << 8));
+  }
+
+  if ((Flags & GZIP_FNAME) != 0) {
+    Status = GzipSkipString (Content, ContentLength, &Index);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if ((Flags & GZIP_FCOMMENT) != 0) {
+    Status = GzipSkipString (Content, ContentLength, &Index);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if ((Flags & GZIP_FHCRC) != 0) {
+    Index += 2;
+  }
+
+  if ((Index > ContentLength) || (ContentLength - Index < GZIP_TRAILER_SIZE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The trailer has the size of the original data, modulo 2^32. Use it
+  // to allocate the output buffer once when it is plausible.
+  //
+  Size = ReadUnaligned32 ((UINT32 *)(Content + ContentLength - 4));
+  if (Size <= (ContentLength - Index) * DEFLATE_MAX_RATIO) {
+    State->Output = AllocatePool (MAX (Size, 1));
+    if (State->Output == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    State->OutputSize = MAX (Size, 1);
+  }
+
+  State->Input       = Content;
+  State->InputLength = ContentLength - GZIP_TRAILER_SIZE;
+  State->InputIndex  = Index;
+  Status             = Inflate (State);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Crc = ReadUnaligned32 ((UINT32 *)(Content + ContentLength - GZIP_TRAILER_SIZE));
+  if ((State->OutputIndex != Size) ||
+      (CalculateCrc32 (State->Output, State->OutputIndex) != Crc))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode deflate content. RFC 7230 defines it as the zlib format,
+  a raw deflate stream is accepted as well.
+
+  @param[in]   Content        The deflate content.
+  @param[in]   ContentLength  Length of the deflate content.
+  @param[out]  State          The inflate state receiving the output.
+
+  @retval EFI_SUCCESS            The content is decoded.
+  @retval EFI_INVALID_PARAMETER  The content is corrupted.
+  @retval EFI_OUT_OF_RESOURCES   Memory allocation failed.
+
+**/
+STATIC
+EFI_STATUS
+DeflateDecode (
+  IN  CONST UINT8    *Content,
+  IN  UINTN          ContentLength,
+  OUT INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Adler;
+  UINT32      A;
+  UINT32      B;
+  UINTN       Index;
+
+  State->Input       = Content;
+  State->InputLength = ContentLength;
+
+  if ((ContentLength < 2 + ZLIB_TRAILER_SIZE) ||
+      ((Content[0] & 0x0F) != ZLIB_CM_DEFLATE) ||
+      ((Content[0] >> 4) > 7) ||
+      ((Content[1] & ZLIB_FDICT) != 0) ||
+      ((((UINT32)Content[0] << 8) | Content[1]) % 31 != 0))
+  {
+    return Inflate (State);
+  }
+
+  State->InputLength = ContentLength - ZLIB_TRAILER_SIZE;
+  State->InputIndex  = 2;
+  Status             = Inflate (State);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  A = 1;
+  B = 0;
+  for (Index = 0; Index < State->OutputIndex; Index++) {
+    A = (A + State->Output[Index]) % 65521;
+    B = (B + A) % 65521;
+  }
+
+  Adler = SwapBytes32 (ReadUnaligned32 ((UINT32 *)(Content + ContentLength - ZLIB_TRAILER_SIZE)));
+  if (Adler != ((B << 16) | A)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This is the function to encode the content use the
+  algorithm indicated in ContentEncodedValue. The naming of
+  ContentEncodedValue is follow HTTP spec or could be a
+  platform-specific value.
+
+  @param[in]   ContentEncodedValue   HTTP conent encoded value.
+                                     The value could be one of below
+                                     or any which is platform-specific.
+                                       - HTTP_CONTENT_ENCODING_IDENTITY "identity"
+                                       - HTTP_CONTENT_ENCODING_GZIP     "gzip"
+                                       - HTTP_CONTENT_ENCODING_COMPRESS "compress"
+                                       - HTTP_CONTENT_ENCODING_DEFLATE  "deflate"
+                                       - HTTP_CONTENT_ENCODING_BROTLI   "br"
+  @param[in]   OriginalContent       Original content.
+  @param[in]   OriginalContentLength The length of original content.
+  @param[out]  EncodedContentPointer Pointer to receive the encoded content pointer.
+  @param[out]  EncodedContentLength  Length of encoded content.
+
+  @retval EFI_SUCCESS              Content is encoded successfully.
+  @retval EFI_UNSUPPORTED          No supported encoding funciton,
+  @retval EFI_INVALID_PARAMETER    One of the given parameter is invalid.
+
+**/
+EFI_STATUS
+RedfishContentEncode  (
+  IN CHAR8   *ContentEncodedValue,
+  IN CHAR8   *OriginalContent,
+  IN UINTN   OriginalContentLength,
+  OUT VOID   **EncodedContentPointer,
+  OUT UINTN  *EncodedContentLength
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  This is the function to decode the content use the
+  algorithm indicated in ContentEncodedValue. The naming of
+  ContentEncodedValue is follow HTTP spec or could be a
+  platform-specific value.
+
+  @param[in]   ContentDecodedValue   HTTP conent decoded value.
+                                     The value could be one of below
+                                     or any which is platform-specific.
+                                       - HTTP_CONTENT_ENCODING_IDENTITY "identity"
+                                       - HTTP_CONTENT_ENCODING_GZIP     "gzip"
+                                       - HTTP_CONTENT_ENCODING_COMPRESS "compress"
+                                       - HTTP_CONTENT_ENCODING_DEFLATE  "deflate"
+                                       - HTTP_CONTENT_ENCODING_BROTLI   "br"
+  @param[in]   ContentPointer        Original content.
+  @param[in]   ContentLength         The length of original content.
+  @param[out]  DecodedContentPointer Pointer to receive decoded content pointer.
+  @param[out]  DecodedContentLength  Length of decoded content.
+
+  @retval EFI_SUCCESS              Content is decoded successfully.
+  @retval EFI_UNSUPPORTED          No supported decoding funciton,
+  @retval EFI_INVALID_PARAMETER    One of the given parameter is invalid.
+  @retval EFI_OUT_OF_RESOURCES     Memory allocation failed.
+
+**/
+EFI_STATUS
+RedfishContentDecode (
+  IN CHAR8   *ContentDecodedValue,
+  IN VOID    *ContentPointer,
+  IN UINTN   ContentLength,
+  OUT VOID   **DecodedContentPointer,
+  OUT UINTN  *DecodedContentLength
+  )
+{
+  EFI_STATUS     Status;
+  INFLATE_STATE  State;
+
+  if ((ContentDecodedValue == NULL) || (ContentPointer == NULL) ||
+      (DecodedContentPointer == NULL) || (DecodedContentLength == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (&State, sizeof (State));
+  if (AsciiStriCmp (ContentDecodedValue, HTTP_CONTENT_ENCODING_IDENTITY) == 0) {
+    State.Output = AllocateCopyPool (ContentLength, ContentPointer);
+    if (State.Output == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    State.OutputIndex = ContentLength;
+    Status            = EFI_SUCCESS;
+  } else if ((AsciiStriCmp (ContentDecodedValue, HTTP_CONTENT_ENCODING_GZIP) == 0) ||
+             (AsciiStriCmp (ContentDecodedValue, HTTP_CONTENT_ENCODING_X_GZIP) == 0))
+  {
+    Status = GzipDecode (ContentPointer, ContentLength, &State);
+  } else if (AsciiStriCmp (ContentDecodedValue, HTTP_CONTENT_ENCODING_DEFLATE) == 0) {
+    Status = DeflateDecode (ContentPointer, ContentLength, &State);
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to decode %a content: %r\n", __FUNCTION__, ContentDecodedValue, Status));
+    if (State.Output != NULL) {
+      FreePool (State.Output);
+    }
+
+    return Status;
+  }
+
+  *DecodedContentPointer = State.Output;
+  *DecodedContentLength  = State.OutputIndex;
+  return EFI_SUCCESS;
+}
+
+/**
+  Return the content codings RedfishContentDecode supports, to be sent
+  in the Accept-Encoding header of the requests.
+
+  @return  The Accept-Encoding header value, or NULL if only the
+           identity coding is supported.
+
+**/
+CONST CHAR8 *
+RedfishContentAcceptEncoding (
+  VOID
+  )
+{
+  return HTTP_CONTENT_ENCODING_GZIP ", " HTTP_CONTENT_ENCODING_DEFLATE;
+}
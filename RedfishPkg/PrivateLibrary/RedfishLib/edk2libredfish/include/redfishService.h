@@ -26,7 +26,10 @@
 #include <Library/HttpLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/NetLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
 #include <Library/RedfishContentCodingLib.h>
+#include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
@@ -74,6 +77,27 @@ typedef struct {
 ///
 #define REDFISH_FIRST_URL  L"/redfish/v1"
 
+///
+/// Redfish resource cache, one variable per resource named
+/// REDFISH_ETAG_CACHE_VARIABLE_PREFIX followed by the CRC32 of the URL.
+///
+#define REDFISH_ETAG_CACHE_VARIABLE_PREFIX     L"RedfishETag"
+#define REDFISH_ETAG_CACHE_VARIABLE_NAME_SIZE  20
+#define REDFISH_ETAG_CACHE_VARIABLE_OVERHEAD   0x40
+
+///
+/// A cached resource, followed by the NULL terminated URL and ETag, and the body.
+///
+typedef struct {
+  UINT32    UrlSize;
+  UINT32    ETagSize;
+  UINT32    BodyLength;
+} REDFISH_ETAG_CACHE_ENTRY;
+
+#define REDFISH_ETAG_CACHE_URL(Entry)   ((CHAR8 *)((Entry) + 1))
+#define REDFISH_ETAG_CACHE_ETAG(Entry)  (REDFISH_ETAG_CACHE_URL (Entry) + (Entry)->UrlSize)
+#define REDFISH_ETAG_CACHE_BODY(Entry)  (REDFISH_ETAG_CACHE_ETAG (Entry) + (Entry)->ETagSize)
+
 typedef struct {
   unsigned int    authType;
   union {
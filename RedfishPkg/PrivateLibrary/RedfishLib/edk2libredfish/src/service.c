@@ -260,6 +260,146 @@ DecodeResponseContent (
   return Status;
 }
 
+/**
+  Build the name of the variable caching the resource at a URL.
+
+  @param[in]   Url        The URL of the resource.
+  @param[out]  Name       Buffer receiving the variable name.
+  @param[in]   NameSize   Size in bytes of the Name buffer.
+
+**/
+STATIC
+VOID
+GetETagCacheVariableName (
+  IN  CONST CHAR8  *Url,
+  OUT CHAR16       *Name,
+  IN  UINTN        NameSize
+  )
+{
+  UnicodeSPrint (
+    Name,
+    NameSize,
+    L"%s%08x",
+    REDFISH_ETAG_CACHE_VARIABLE_PREFIX,
+    CalculateCrc32 ((VOID *)Url, AsciiStrLen (Url))
+    );
+}
+
+/**
+  Read the cached copy of the resource at a URL.
+
+  @param[in]   Url        The URL of the resource.
+
+  @return  The cache entry, to be freed by the caller, or NULL if the
+           resource is not cached.
+
+**/
+STATIC
+REDFISH_ETAG_CACHE_ENTRY *
+ReadETagCache (
+  IN CONST CHAR8  *Url
+  )
+{
+  EFI_STATUS                Status;
+  CHAR16                    Name[REDFISH_ETAG_CACHE_VARIABLE_NAME_SIZE];
+  REDFISH_ETAG_CACHE_ENTRY  *Entry;
+  UINTN                     Size;
+
+  GetETagCacheVariableName (Url, Name, sizeof (Name));
+  Status = GetVariable2 (Name, &gEdkIIRedfishETagCacheVariableGuid, (VOID **)&Entry, &Size);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  //
+  // Check the entry, different URLs may share a variable.
+  //
+  if ((Size < sizeof (REDFISH_ETAG_CACHE_ENTRY)) ||
+      (Entry->UrlSize != AsciiStrSize (Url)) ||
+      (Entry->ETagSize == 0) ||
+      (Size != sizeof (REDFISH_ETAG_CACHE_ENTRY) + (UINTN)Entry->UrlSize + Entry->ETagSize + Entry->BodyLength) ||
+      (AsciiStrCmp (REDFISH_ETAG_CACHE_URL (Entry), Url) != 0) ||
+      (REDFISH_ETAG_CACHE_ETAG (Entry)[Entry->ETagSize - 1] != '\0'))
+  {
+    FreePool (Entry);
+    return NULL;
+  }
+
+  return Entry;
+}
+
+/**
+  Cache the resource at a URL with its ETag.
+
+  Resources that do not fit in a variable are not cached.
+
+  @param[in]   Url         The URL of the resource.
+  @param[in]   ETag        The ETag of the resource.
+  @param[in]   Body        The resource.
+  @param[in]   BodyLength  Length of the resource.
+
+**/
+STATIC
+VOID
+WriteETagCache (
+  IN CONST CHAR8  *Url,
+  IN CONST CHAR8  *ETag,
+  IN CONST VOID   *Body,
+  IN UINTN        BodyLength
+  )
+{
+  CHAR16                    Name[REDFISH_ETAG_CACHE_VARIABLE_NAME_SIZE];
+  REDFISH_ETAG_CACHE_ENTRY  *Entry;
+  REDFISH_ETAG_CACHE_ENTRY  *OldEntry;
+  UINTN                     Size;
+
+  GetETagCacheVariableName (Url, Name, sizeof (Name));
+
+  Size = sizeof (REDFISH_ETAG_CACHE_ENTRY) + AsciiStrSize (Url) + AsciiStrSize (ETag) + BodyLength;
+  if (Size + sizeof (Name) + REDFISH_ETAG_CACHE_VARIABLE_OVERHEAD > PcdGet32 (PcdMaxVariableSize)) {
+    //
+    // Remove a cached copy which is out of date.
+    //
+    gRT->SetVariable (Name, &gEdkIIRedfishETagCacheVariableGuid, 0, 0, NULL);
+    return;
+  }
+
+  Entry = AllocatePool (Size);
+  if (Entry == NULL) {
+    return;
+  }
+
+  Entry->UrlSize    = (UINT32)AsciiStrSize (Url);
+  Entry->ETagSize   = (UINT32)AsciiStrSize (ETag);
+  Entry->BodyLength = (UINT32)BodyLength;
+  CopyMem (REDFISH_ETAG_CACHE_URL (Entry), Url, Entry->UrlSize);
+  CopyMem (REDFISH_ETAG_CACHE_ETAG (Entry), ETag, Entry->ETagSize);
+  CopyMem (REDFISH_ETAG_CACHE_BODY (Entry), Body, BodyLength);
+
+  //
+  // Do not rewrite an identical entry, when the server ignores If-None-Match.
+  //
+  OldEntry = ReadETagCache (Url);
+  if ((OldEntry == NULL) ||
+      (CompareMem (OldEntry, Entry, sizeof (REDFISH_ETAG_CACHE_ENTRY)) != 0) ||
+      (CompareMem (OldEntry, Entry, Size) != 0))
+  {
+    gRT->SetVariable (
+           Name,
+           &gEdkIIRedfishETagCacheVariableGuid,
+           EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+           Size,
+           Entry
+           );
+  }
+
+  if (OldEntry != NULL) {
+    FreePool (OldEntry);
+  }
+
+  FreePool (Entry);
+}
+
 /**
   Create a HTTP URL string for specific Redfish resource.
 
@@ -408,14 +548,18 @@ getUriFromService (
   EFI_HTTP_STATUS_CODE  **StatusCode
   )
 {
-  char                   *url;
-  json_t                 *ret;
-  HTTP_IO_HEADER         *HttpIoHeader = NULL;
-  EFI_STATUS             Status;
-  EFI_HTTP_REQUEST_DATA  *RequestData = NULL;
-  EFI_HTTP_MESSAGE       *RequestMsg  = NULL;
-  EFI_HTTP_MESSAGE       ResponseMsg;
-  EFI_HTTP_HEADER        *ContentEncodedHeader;
+  char                      *url;
+  json_t                    *ret;
+  HTTP_IO_HEADER            *HttpIoHeader = NULL;
+  EFI_STATUS                Status;
+  EFI_HTTP_REQUEST_DATA     *RequestData = NULL;
+  EFI_HTTP_MESSAGE          *RequestMsg  = NULL;
+  EFI_HTTP_MESSAGE          ResponseMsg;
+  EFI_HTTP_HEADER           *ContentEncodedHeader;
+  EFI_HTTP_HEADER           *ETagHeader;
+  CONST CHAR8               *AcceptEncoding;
+  UINTN                     HeaderCount;
+  REDFISH_ETAG_CACHE_ENTRY  *CacheEntry;
 
   if ((service == NULL) || (uri == NULL) || (StatusCode == NULL)) {
     return NULL;
@@ -430,10 +574,32 @@ getUriFromService (
 
   DEBUG ((DEBUG_INFO, "libredfish: getUriFromService(): %a\n", url));
 
+  //
+  // Validate the cached copy of the resource, if any.
+  //
+  CacheEntry = NULL;
+  if (FeaturePcdGet (PcdRedfishETagCacheEnable)) {
+    CacheEntry = ReadETagCache (url);
+  }
+
   //
   // Step 1: Create HTTP request message with 4 headers:
   //
-  HttpIoHeader = HttpIoCreateHeader ((service->sessionToken || service->basicAuthStr) ? 6 : 5);
+  HeaderCount = (service->sessionToken || service->basicAuthStr) ? 6 : 5;
+
+  //
+  // Ask for a compressed payload if it can be decoded.
+  //
+  AcceptEncoding = RedfishContentAcceptEncoding ();
+  if (AcceptEncoding != NULL) {
+    HeaderCount++;
+  }
+
+  if (CacheEntry != NULL) {
+    HeaderCount++;
+  }
+
+  HttpIoHeader = HttpIoCreateHeader (HeaderCount);
   if (HttpIoHeader == NULL) {
     ret = NULL;
     goto ON_EXIT;
@@ -457,6 +623,15 @@ getUriFromService (
   ASSERT_EFI_ERROR (Status);
   Status = HttpIoSetHeader (HttpIoHeader, "Connection", "Keep-Alive");
   ASSERT_EFI_ERROR (Status);
+  if (AcceptEncoding != NULL) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_ACCEPT_ENCODING, (CHAR8 *)AcceptEncoding);
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  if (CacheEntry != NULL) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_IF_NONE_MATCH, REDFISH_ETAG_CACHE_ETAG (CacheEntry));
+    ASSERT_EFI_ERROR (Status);
+  }
 
   //
   // Step 2: build the rest of HTTP request info.
@@ -508,6 +683,17 @@ getUriFromService (
     // The caller shall take the responsibility to free the buffer.
     //
     **StatusCode = ResponseMsg.Data.Response->StatusCode;
+
+    if ((**StatusCode == HTTP_STATUS_304_NOT_MODIFIED) && (CacheEntry != NULL)) {
+      //
+      // The cached copy is up to date. Callers expect a 2XX status code
+      // with the payload, as for an unconditional request.
+      //
+      DEBUG ((DEBUG_INFO, "libredfish: %a not modified, using the cached copy\n", url));
+      **StatusCode = HTTP_STATUS_200_OK;
+      ret          = json_loadb (REDFISH_ETAG_CACHE_BODY (CacheEntry), CacheEntry->BodyLength, 0, NULL);
+      goto ON_EXIT;
+    }
   }
 
   if ((ResponseMsg.BodyLength != 0) && (ResponseMsg.Body != NULL)) {
@@ -528,6 +714,15 @@ getUriFromService (
     }
 
     ret = json_loadb (ResponseMsg.Body, ResponseMsg.BodyLength, 0, NULL);
+
+    if (FeaturePcdGet (PcdRedfishETagCacheEnable) && (ret != NULL) &&
+        (*StatusCode != NULL) && (**StatusCode == HTTP_STATUS_200_OK))
+    {
+      ETagHeader = HttpFindHeader (ResponseMsg.HeaderCount, ResponseMsg.Headers, HTTP_HEADER_ETAG);
+      if ((ETagHeader != NULL) && (ETagHeader->FieldValue != NULL)) {
+        WriteETagCache (url, ETagHeader->FieldValue, ResponseMsg.Body, ResponseMsg.BodyLength);
+      }
+    }
   } else {
     //
     // There is no message body returned from server.
@@ -540,6 +735,10 @@ ON_EXIT:
     free (url);
   }
 
+  if (CacheEntry != NULL) {
+    FreePool (CacheEntry);
+  }
+
   if (HttpIoHeader != NULL) {
     HttpIoFreeHeader (HttpIoHeader);
   }
@@ -228,6 +228,11 @@ ReSendRequest:;
       SendChunkProcess++;
       goto ReSendRequest;
     }
+  } else if (ResponseData->Response.StatusCode == HTTP_STATUS_304_NOT_MODIFIED) {
+    //
+    // The response to a conditional request, the caller has the content.
+    //
+    DEBUG ((DEBUG_INFO, "HTTP_STATUS_304_NOT_MODIFIED\n"));
   } else if (ResponseData->Response.StatusCode == HTTP_STATUS_413_REQUEST_ENTITY_TOO_LARGE) {
     DEBUG ((DEBUG_INFO, "HTTP_STATUS_413_REQUEST_ENTITY_TOO_LARGE\n"));
 
@@ -2065,6 +2065,9 @@ VerifyTimeBasedPayload (
 
     //
     // Ready to verify Pkcs7 SignedData. Go through KEK Signature Database to find out X.509 CertList.
+    // Pkcs7Verify() only takes DER certificates, so each trusted certificate is parsed again on
+    // every call. Parsed certificates are not cached across calls: a stale cache entry would be a
+    // trust decision that outlives its KEK, and KEK rarely holds more than a few certificates.
     //
     KekDataSize = (UINT32)DataSize;
     CertList    = (EFI_SIGNATURE_LIST *)Data;
@@ -71,6 +71,15 @@ HASH_TABLE  mHash[] = {
 
 EFI_STRING  mHashTypeStr;
 
+//
+// SHA-256 digests of the images that passed verification, valid as long as
+// the security databases still have mSecurityDatabaseDigest as digest.
+//
+UINT8  mSecurityDatabaseDigest[SHA256_DIGEST_SIZE];
+UINT8  mVerifiedImageDigest[VERIFIED_IMAGE_CACHE_SIZE][SHA256_DIGEST_SIZE];
+UINTN  mVerifiedImageCount = 0;
+UINTN  mVerifiedImageNext  = 0;
+
 /**
   SecureBoot Hook for processing image verification.
 
@@ -1606,6 +1615,118 @@ Done:
   return VerifyStatus;
 }
 
+/**
+  Calculate the SHA-256 digest of the security databases db, dbx and dbt, which
+  the verification of an image depends on.
+
+  @param[out]  Digest    The digest of the security databases.
+
+  @retval TRUE   The digest is calculated.
+  @retval FALSE  The digest cannot be calculated.
+**/
+BOOLEAN
+GetSecurityDatabaseDigest (
+  OUT UINT8  *Digest
+  )
+{
+  STATIC CHAR16  *DatabaseName[] = {
+    EFI_IMAGE_SECURITY_DATABASE,
+    EFI_IMAGE_SECURITY_DATABASE1,
+    EFI_IMAGE_SECURITY_DATABASE2
+  };
+  VOID           *HashCtx;
+  VOID           *Data;
+  UINTN          DataSize;
+  UINTN          Index;
+  BOOLEAN        Status;
+
+  HashCtx = AllocatePool (Sha256GetContextSize ());
+  if (HashCtx == NULL) {
+    return FALSE;
+  }
+
+  Status = Sha256Init (HashCtx);
+  for (Index = 0; Status && (Index < ARRAY_SIZE (DatabaseName)); Index++) {
+    Data     = NULL;
+    DataSize = 0;
+    GetVariable2 (DatabaseName[Index], &gEfiImageSecurityDatabaseGuid, &Data, &DataSize);
+
+    //
+    // The size tells a missing database from an empty one and delimits the
+    // databases.
+    //
+    Status = Sha256Update (HashCtx, &DataSize, sizeof (DataSize));
+    if (Status && (Data != NULL)) {
+      Status = Sha256Update (HashCtx, Data, DataSize);
+    }
+
+    if (Data != NULL) {
+      FreePool (Data);
+    }
+  }
+
+  if (Status) {
+    Status = Sha256Final (HashCtx, Digest);
+  }
+
+  FreePool (HashCtx);
+  return Status;
+}
+
+/**
+  Check whether an image passed verification before, with the same security
+  databases.
+
+  The remembered images are forgotten when the security databases change.
+
+  @param[in]  DatabaseDigest     The digest of the current security databases.
+  @param[in]  ImageDigest        The SHA-256 digest of the image file.
+
+  @retval TRUE   The image passed verification before.
+  @retval FALSE  The image has to be verified.
+**/
+BOOLEAN
+IsImageVerifiedBefore (
+  IN CONST UINT8  *DatabaseDigest,
+  IN CONST UINT8  *ImageDigest
+  )
+{
+  UINTN  Index;
+
+  if (CompareMem (DatabaseDigest, mSecurityDatabaseDigest, SHA256_DIGEST_SIZE) != 0) {
+    CopyMem (mSecurityDatabaseDigest, DatabaseDigest, SHA256_DIGEST_SIZE);
+    mVerifiedImageCount = 0;
+    mVerifiedImageNext  = 0;
+    return FALSE;
+  }
+
+  for (Index = 0; Index < mVerifiedImageCount; Index++) {
+    if (CompareMem (mVerifiedImageDigest[Index], ImageDigest, SHA256_DIGEST_SIZE) == 0) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Remember an image which passed verification, replacing the oldest one when
+  the cache is full.
+
+  @param[in]  ImageDigest        The SHA-256 digest of the image file.
+**/
+VOID
+AddVerifiedImage (
+  IN CONST UINT8  *ImageDigest
+  )
+{
+  CopyMem (mVerifiedImageDigest[mVerifiedImageNext], ImageDigest, SHA256_DIGEST_SIZE);
+  mVerifiedImageNext = (mVerifiedImageNext + 1) % VERIFIED_IMAGE_CACHE_SIZE;
+  if (mVerifiedImageCount < VERIFIED_IMAGE_CACHE_SIZE) {
+    mVerifiedImageCount++;
+  }
+}
+
 /**
   Provide verification service for signed images, which include both signature validation
   and platform policy control. For signature types, both UEFI WIN_CERTIFICATE_UEFI_GUID and
@@ -1687,6 +1808,9 @@ DxeImageVerificationHandler (
   EFI_STATUS                    HashStatus;
   EFI_STATUS                    DbStatus;
   BOOLEAN                       IsFound;
+  BOOLEAN                       IsCacheable;
+  UINT8                         DatabaseDigest[SHA256_DIGEST_SIZE];
+  UINT8                         FileDigest[SHA256_DIGEST_SIZE];
 
   SignatureList     = NULL;
   SignatureListSize = 0;
@@ -1767,6 +1891,17 @@ DxeImageVerificationHandler (
     return EFI_ACCESS_DENIED;
   }
 
+  //
+  // Skip verification if the very same image passed it before, and the
+  // security databases have not changed since.
+  //
+  IsCacheable = (BOOLEAN)(GetSecurityDatabaseDigest (DatabaseDigest) &&
+                          Sha256HashAll (FileBuffer, FileSize, FileDigest));
+  if (IsCacheable && IsImageVerifiedBefore (DatabaseDigest, FileDigest)) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image passed verification before.\n"));
+    return EFI_SUCCESS;
+  }
+
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
 
@@ -1866,6 +2001,10 @@ DxeImageVerificationHandler (
       //
       // Image Hash is in allowed database (DB).
       //
+      if (IsCacheable) {
+        AddVerifiedImage (FileDigest);
+      }
+
       return EFI_SUCCESS;
     }
 
@@ -2001,6 +2140,10 @@ DxeImageVerificationHandler (
   }
 
   if (IsVerified) {
+    if (IsCacheable) {
+      AddVerifiedImage (FileDigest);
+    }
+
     return EFI_SUCCESS;
   }
 
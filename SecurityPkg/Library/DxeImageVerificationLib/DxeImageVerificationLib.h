@@ -73,6 +73,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
+
+//
+// Number of the images that passed verification remembered, so that they are
+// not verified again while the security databases are unchanged.
+//
+#define VERIFIED_IMAGE_CACHE_SIZE  32
 //
 //
 // PKCS7 Certificate definition
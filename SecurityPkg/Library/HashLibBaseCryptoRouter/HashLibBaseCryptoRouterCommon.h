@@ -9,6 +9,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// The size of the chunks HashUpdate() feeds to all the hash algorithms in
+// turn, small enough for the chunk to stay in the cache meanwhile.
+//
+#define HASH_LIB_UPDATE_CHUNK_SIZE  SIZE_64KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -109,6 +109,8 @@ HashUpdate (
   HASH_HANDLE  *HashCtx;
   UINTN        Index;
   UINT32       HashMask;
+  UINTN        Offset;
+  UINTN        ChunkLen;
 
   if (mHashInterfaceCount == 0) {
     return EFI_UNSUPPORTED;
@@ -118,10 +120,17 @@ HashUpdate (
 
   HashCtx = (HASH_HANDLE *)HashHandle;
 
-  for (Index = 0; Index < mHashInterfaceCount; Index++) {
-    HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
-    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
+  //
+  // Feed the data to all the hash algorithms one chunk at a time, so that it
+  // is read once from memory or flash, and stays in the cache for all of them.
+  //
+  for (Offset = 0; Offset < DataToHashLen; Offset += ChunkLen) {
+    ChunkLen = MIN (DataToHashLen - Offset, HASH_LIB_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < mHashInterfaceCount; Index++) {
+      HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
+      if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
+        mHashInterface[Index].HashUpdate (HashCtx[Index], (UINT8 *)DataToHash + Offset, ChunkLen);
+      }
     }
   }
 
@@ -161,13 +170,14 @@ HashCompleteAndExtend (
 
   CheckSupportedHashMaskMismatch ();
 
+  HashUpdate (HashHandle, DataToHash, DataToHashLen);
+
   HashCtx = (HASH_HANDLE *)HashHandle;
   ZeroMem (DigestList, sizeof (*DigestList));
 
   for (Index = 0; Index < mHashInterfaceCount; Index++) {
     HashMask = Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid);
     if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      mHashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
       mHashInterface[Index].HashFinal (HashCtx[Index], &Digest);
       Tpm2SetHashToDigestList (DigestList, &Digest);
     }
@@ -187,6 +187,8 @@ HashUpdate (
   HASH_HANDLE         *HashCtx;
   UINTN               Index;
   UINT32              HashMask;
+  UINTN               Offset;
+  UINTN               ChunkLen;
 
   HashInterfaceHob = InternalGetHashInterfaceHob (&gEfiCallerIdGuid);
   if (HashInterfaceHob == NULL) {
@@ -201,10 +203,17 @@ HashUpdate (
 
   HashCtx = (HASH_HANDLE *)HashHandle;
 
-  for (Index = 0; Index < HashInterfaceHob->HashInterfaceCount; Index++) {
-    HashMask = Tpm2GetHashMaskFromAlgo (&HashInterfaceHob->HashInterface[Index].HashGuid);
-    if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      HashInterfaceHob->HashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
+  //
+  // Feed the data to all the hash algorithms one chunk at a time, so that it
+  // is read once from memory or flash, and stays in the cache for all of them.
+  //
+  for (Offset = 0; Offset < DataToHashLen; Offset += ChunkLen) {
+    ChunkLen = MIN (DataToHashLen - Offset, HASH_LIB_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < HashInterfaceHob->HashInterfaceCount; Index++) {
+      HashMask = Tpm2GetHashMaskFromAlgo (&HashInterfaceHob->HashInterface[Index].HashGuid);
+      if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
+        HashInterfaceHob->HashInterface[Index].HashUpdate (HashCtx[Index], (UINT8 *)DataToHash + Offset, ChunkLen);
+      }
     }
   }
 
@@ -250,13 +259,14 @@ HashCompleteAndExtend (
 
   CheckSupportedHashMaskMismatch (HashInterfaceHob);
 
+  HashUpdate (HashHandle, DataToHash, DataToHashLen);
+
   HashCtx = (HASH_HANDLE *)HashHandle;
   ZeroMem (DigestList, sizeof (*DigestList));
 
   for (Index = 0; Index < HashInterfaceHob->HashInterfaceCount; Index++) {
     HashMask = Tpm2GetHashMaskFromAlgo (&HashInterfaceHob->HashInterface[Index].HashGuid);
     if ((HashMask & PcdGet32 (PcdTpm2HashMask)) != 0) {
-      HashInterfaceHob->HashInterface[Index].HashUpdate (HashCtx[Index], DataToHash, DataToHashLen);
       HashInterfaceHob->HashInterface[Index].HashFinal (HashCtx[Index], &Digest);
       Tpm2SetHashToDigestList (DigestList, &Digest);
     }
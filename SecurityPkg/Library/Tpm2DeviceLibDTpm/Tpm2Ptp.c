@@ -93,6 +93,75 @@ PtpCrbWaitRegisterBits (
   return EFI_TIMEOUT;
 }
 
+/**
+  Copy data to the CRB data buffer.
+
+  The data buffer is accessed with aligned 32-bit MMIO writes where possible,
+  so a command takes a quarter of the MMIO transactions of byte writes.
+
+  @param[in] CrbReg     Pointer to CRB register.
+  @param[in] Offset     Offset in the CRB data buffer to copy to.
+  @param[in] Buffer     The data to copy.
+  @param[in] Size       Size of the data in bytes.
+**/
+STATIC
+VOID
+PtpCrbWriteDataBuffer (
+  IN PTP_CRB_REGISTERS_PTR  CrbReg,
+  IN UINT32                 Offset,
+  IN UINT8                  *Buffer,
+  IN UINT32                 Size
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Size && ((Offset + Index) % sizeof (UINT32)) != 0; Index++) {
+    MmioWrite8 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index], Buffer[Index]);
+  }
+
+  for ( ; Index + sizeof (UINT32) <= Size; Index += sizeof (UINT32)) {
+    MmioWrite32 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index], ReadUnaligned32 ((UINT32 *)&Buffer[Index]));
+  }
+
+  for ( ; Index < Size; Index++) {
+    MmioWrite8 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index], Buffer[Index]);
+  }
+}
+
+/**
+  Copy data from the CRB data buffer.
+
+  The data buffer is accessed with aligned 32-bit MMIO reads where possible.
+
+  @param[in]  CrbReg    Pointer to CRB register.
+  @param[in]  Offset    Offset in the CRB data buffer to copy from.
+  @param[out] Buffer    The buffer to copy the data to.
+  @param[in]  Size      Size of the data in bytes.
+**/
+STATIC
+VOID
+PtpCrbReadDataBuffer (
+  IN  PTP_CRB_REGISTERS_PTR  CrbReg,
+  IN  UINT32                 Offset,
+  OUT UINT8                  *Buffer,
+  IN  UINT32                 Size
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Size && ((Offset + Index) % sizeof (UINT32)) != 0; Index++) {
+    Buffer[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index]);
+  }
+
+  for ( ; Index + sizeof (UINT32) <= Size; Index += sizeof (UINT32)) {
+    WriteUnaligned32 ((UINT32 *)&Buffer[Index], MmioRead32 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index]));
+  }
+
+  for ( ; Index < Size; Index++) {
+    Buffer[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Offset + Index]);
+  }
+}
+
 /**
   Get the control of TPM chip.
 
@@ -234,9 +303,7 @@ PtpCrbTpmCommand (
   // first byte of a command to the Command Buffer and the receipt of a write
   // of 1 to Start.
   //
-  for (Index = 0; Index < SizeIn; Index++) {
-    MmioWrite8 ((UINTN)&CrbReg->CrbDataBuffer[Index], BufferIn[Index]);
-  }
+  PtpCrbWriteDataBuffer (CrbReg, 0, BufferIn, SizeIn);
 
   MmioWrite32 ((UINTN)&CrbReg->CrbControlCommandAddressHigh, (UINT32)RShiftU64 ((UINTN)CrbReg->CrbDataBuffer, 32));
   MmioWrite32 ((UINTN)&CrbReg->CrbControlCommandAddressLow, (UINT32)(UINTN)CrbReg->CrbDataBuffer);
@@ -290,9 +357,7 @@ PtpCrbTpmCommand (
   //
   // Get response data header
   //
-  for (Index = 0; Index < sizeof (TPM2_RESPONSE_HEADER); Index++) {
-    BufferOut[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Index]);
-  }
+  PtpCrbReadDataBuffer (CrbReg, 0, BufferOut, sizeof (TPM2_RESPONSE_HEADER));
 
   DEBUG_CODE_BEGIN ();
   DEBUG ((DEBUG_VERBOSE, "PtpCrbTpmCommand ReceiveHeader - "));
@@ -327,8 +392,13 @@ PtpCrbTpmCommand (
   //
   // Continue reading the remaining data
   //
-  for (Index = sizeof (TPM2_RESPONSE_HEADER); Index < TpmOutSize; Index++) {
-    BufferOut[Index] = MmioRead8 ((UINTN)&CrbReg->CrbDataBuffer[Index]);
+  if (TpmOutSize > sizeof (TPM2_RESPONSE_HEADER)) {
+    PtpCrbReadDataBuffer (
+      CrbReg,
+      sizeof (TPM2_RESPONSE_HEADER),
+      BufferOut + sizeof (TPM2_RESPONSE_HEADER),
+      TpmOutSize - sizeof (TPM2_RESPONSE_HEADER)
+      );
   }
 
   DEBUG_CODE_BEGIN ();
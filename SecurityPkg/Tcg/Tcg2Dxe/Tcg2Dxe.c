@@ -1553,7 +1553,7 @@ SetupEventLog (
   EFI_PHYSICAL_ADDRESS             Lasa;
   UINTN                            Index;
   VOID                             *DigestListBin;
-  TPML_DIGEST_VALUES               TempDigestListBin;
+  TCG_PCR_EVENT2_HDR               TcgPcrEvent2Hdr;
   UINT32                           DigestListBinSize;
   UINT8                            *Event;
   UINT32                           EventSize;
@@ -1824,8 +1824,7 @@ SetupEventLog (
       while (!EFI_ERROR (Status) &&
              (GuidHob.Raw = GetNextGuidHob (mTcg2EventInfo[Index].EventGuid, GuidHob.Raw)) != NULL)
       {
-        TcgEvent = AllocateCopyPool (GET_GUID_HOB_DATA_SIZE (GuidHob.Guid), GET_GUID_HOB_DATA (GuidHob.Guid));
-        ASSERT (TcgEvent != NULL);
+        TcgEvent    = GET_GUID_HOB_DATA (GuidHob.Guid);
         GuidHob.Raw = GET_NEXT_HOB (GuidHob);
         switch (mTcg2EventInfo[Index].LogFormat) {
           case EFI_TCG2_EVENT_LOG_FORMAT_TCG_1_2:
@@ -1846,12 +1845,14 @@ SetupEventLog (
             CopyMem (&EventSize, (UINT8 *)DigestListBin + DigestListBinSize, sizeof (UINT32));
             Event = (UINT8 *)DigestListBin + DigestListBinSize + sizeof (UINT32);
             //
-            // Filter inactive digest in the event2 log from PEI HOB.
+            // Filter inactive digest in the event2 log from PEI HOB. The filtered
+            // header is built on the stack so that the event data can be logged
+            // from the HOB directly, without a copy of the whole event.
             //
-            CopyMem (&TempDigestListBin, DigestListBin, GetDigestListBinSize (DigestListBin));
+            CopyMem (&TcgPcrEvent2Hdr, TcgEvent, sizeof (TCG_PCRINDEX) + sizeof (TCG_EVENTTYPE));
             EventSizePtr = CopyDigestListBinToBuffer (
+                             &TcgPcrEvent2Hdr.Digests,
                              DigestListBin,
-                             &TempDigestListBin,
                              mTcgDxeData.BsCap.ActivePcrBanks,
                              &HashAlgorithmMaskCopied
                              );
@@ -1868,19 +1869,17 @@ SetupEventLog (
             // Restore event size.
             //
             CopyMem (EventSizePtr, &EventSize, sizeof (UINT32));
-            DigestListBinSize = GetDigestListBinSize (DigestListBin);
+            DigestListBinSize = GetDigestListBinSize (&TcgPcrEvent2Hdr.Digests);
 
             Status = TcgDxeLogEvent (
                        mTcg2EventInfo[Index].LogFormat,
-                       TcgEvent,
+                       &TcgPcrEvent2Hdr,
                        sizeof (TCG_PCRINDEX) + sizeof (TCG_EVENTTYPE) + DigestListBinSize + sizeof (UINT32),
                        Event,
                        EventSize
                        );
             break;
         }
-
-        FreePool (TcgEvent);
       }
     }
   }
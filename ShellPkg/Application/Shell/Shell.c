@@ -3044,98 +3044,118 @@ RunScriptFileHandle (
         )
   {
     ASSERT (CommandLine2 != NULL);
-    StrnCpyS (
-      CommandLine2,
-      PrintBuffSize/sizeof (CHAR16),
-      NewScriptFile->CurrentCommand->Cl,
-      PrintBuffSize/sizeof (CHAR16) - 1
-      );
-
     SaveBufferList (&OldBufferList);
 
     //
-    // NULL out comments
+    // Lines of loops are run many times, so remove the comments only the
+    // first time a line is run and keep the result with the line.
     //
-    for (CommandLine3 = CommandLine2; CommandLine3 != NULL && *CommandLine3 != CHAR_NULL; CommandLine3++) {
-      if (*CommandLine3 == L'^') {
-        if ( *(CommandLine3+1) == L':') {
-          CopyMem (CommandLine3, CommandLine3+1, StrSize (CommandLine3) - sizeof (CommandLine3[0]));
-        } else if (*(CommandLine3+1) == L'#') {
-          CommandLine3++;
-        }
-      } else if (*CommandLine3 == L'#') {
-        *CommandLine3 = CHAR_NULL;
-      }
-    }
-
-    if ((CommandLine2 != NULL) && (StrLen (CommandLine2) >= 1)) {
-      //
-      // Due to variability in starting the find and replace action we need to have both buffers the same.
-      //
+    if (NewScriptFile->CurrentCommand->StrippedCl == NULL) {
       StrnCpyS (
-        CommandLine,
-        PrintBuffSize/sizeof (CHAR16),
         CommandLine2,
+        PrintBuffSize/sizeof (CHAR16),
+        NewScriptFile->CurrentCommand->Cl,
         PrintBuffSize/sizeof (CHAR16) - 1
         );
 
       //
-      // Remove the %0 to %9 from the command line (if we have some arguments)
+      // NULL out comments
       //
-      if (NewScriptFile->Argv != NULL) {
-        switch (NewScriptFile->Argc) {
-          default:
-            Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%9", NewScriptFile->Argv[9], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 9:
-            Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%8", NewScriptFile->Argv[8], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 8:
-            Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%7", NewScriptFile->Argv[7], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 7:
-            Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%6", NewScriptFile->Argv[6], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 6:
-            Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%5", NewScriptFile->Argv[5], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 5:
-            Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%4", NewScriptFile->Argv[4], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 4:
-            Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%3", NewScriptFile->Argv[3], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 3:
-            Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%2", NewScriptFile->Argv[2], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 2:
-            Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%1", NewScriptFile->Argv[1], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-          case 1:
-            Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%0", NewScriptFile->Argv[0], FALSE, FALSE);
-            ASSERT_EFI_ERROR (Status);
-            break;
-          case 0:
-            break;
+      for (CommandLine3 = CommandLine2; CommandLine3 != NULL && *CommandLine3 != CHAR_NULL; CommandLine3++) {
+        if (*CommandLine3 == L'^') {
+          if ( *(CommandLine3+1) == L':') {
+            CopyMem (CommandLine3, CommandLine3+1, StrSize (CommandLine3) - sizeof (CommandLine3[0]));
+          } else if (*(CommandLine3+1) == L'#') {
+            CommandLine3++;
+          }
+        } else if (*CommandLine3 == L'#') {
+          *CommandLine3 = CHAR_NULL;
         }
       }
 
-      Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%1", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%2", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%3", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%4", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%5", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%6", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%7", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%8", L"\"\"", FALSE, FALSE);
-      Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%9", L"\"\"", FALSE, FALSE);
-
+      NewScriptFile->CurrentCommand->StrippedCl = AllocateCopyPool (StrSize (CommandLine2), CommandLine2);
+    } else {
       StrnCpyS (
         CommandLine2,
         PrintBuffSize/sizeof (CHAR16),
-        CommandLine,
+        NewScriptFile->CurrentCommand->StrippedCl,
         PrintBuffSize/sizeof (CHAR16) - 1
         );
+    }
+
+    if ((CommandLine2 != NULL) && (StrLen (CommandLine2) >= 1)) {
+      //
+      // Without a '%' there are no script parameters to replace.
+      //
+      if (StrStr (CommandLine2, L"%") != NULL) {
+        //
+        // Due to variability in starting the find and replace action we need to have both buffers the same.
+        //
+        StrnCpyS (
+          CommandLine,
+          PrintBuffSize/sizeof (CHAR16),
+          CommandLine2,
+          PrintBuffSize/sizeof (CHAR16) - 1
+          );
+
+        //
+        // Remove the %0 to %9 from the command line (if we have some arguments)
+        //
+        if (NewScriptFile->Argv != NULL) {
+          switch (NewScriptFile->Argc) {
+            default:
+              Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%9", NewScriptFile->Argv[9], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 9:
+              Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%8", NewScriptFile->Argv[8], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 8:
+              Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%7", NewScriptFile->Argv[7], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 7:
+              Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%6", NewScriptFile->Argv[6], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 6:
+              Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%5", NewScriptFile->Argv[5], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 5:
+              Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%4", NewScriptFile->Argv[4], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 4:
+              Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%3", NewScriptFile->Argv[3], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 3:
+              Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%2", NewScriptFile->Argv[2], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 2:
+              Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%1", NewScriptFile->Argv[1], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+            case 1:
+              Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%0", NewScriptFile->Argv[0], FALSE, FALSE);
+              ASSERT_EFI_ERROR (Status);
+              break;
+            case 0:
+              break;
+          }
+        }
+
+        Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%1", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%2", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%3", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%4", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%5", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%6", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%7", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine, CommandLine2, PrintBuffSize, L"%8", L"\"\"", FALSE, FALSE);
+        Status = ShellCopySearchAndReplace (CommandLine2, CommandLine, PrintBuffSize, L"%9", L"\"\"", FALSE, FALSE);
+
+        StrnCpyS (
+          CommandLine2,
+          PrintBuffSize/sizeof (CHAR16),
+          CommandLine,
+          PrintBuffSize/sizeof (CHAR16) - 1
+          );
+      }
 
       LastCommand = NewScriptFile->CurrentCommand;
 
@@ -16,6 +16,66 @@
 //
 ENV_VAR_LIST  gShellEnvVarList;
 
+//
+// The nodes of gShellEnvVarList hashed by their key, so that scripts looking
+// up variables do not walk the whole list each time.
+//
+#define ENV_VAR_HASH_BUCKETS  64
+
+STATIC LIST_ENTRY  mShellEnvVarHash[ENV_VAR_HASH_BUCKETS];
+
+/**
+  Get the hash bucket of an environment variable in gShellEnvVarList.
+
+  @param Key        The name of the environment variable.
+
+  @return The list head of the bucket.
+**/
+STATIC
+LIST_ENTRY *
+ShellEnvVarHashBucket (
+  IN CONST CHAR16  *Key
+  )
+{
+  UINT32  Hash;
+
+  Hash = 0;
+  while (*Key != CHAR_NULL) {
+    Hash = Hash * 31 + *Key;
+    Key++;
+  }
+
+  return &mShellEnvVarHash[Hash % ENV_VAR_HASH_BUCKETS];
+}
+
+/**
+  Find the node of an environment variable in gShellEnvVarList.
+
+  @param Key        The name of the environment variable.
+
+  @return The node of the variable, or NULL if it is not in the list.
+**/
+STATIC
+ENV_VAR_LIST *
+ShellFindEnvVarNode (
+  IN CONST CHAR16  *Key
+  )
+{
+  LIST_ENTRY    *Bucket;
+  LIST_ENTRY    *Entry;
+  ENV_VAR_LIST  *Node;
+
+  Bucket = ShellEnvVarHashBucket (Key);
+  for (Entry = GetFirstNode (Bucket); !IsNull (Bucket, Entry); Entry = GetNextNode (Bucket, Entry)) {
+    Node = BASE_CR (Entry, ENV_VAR_LIST, HashLink);
+    if ((Node->Key != NULL) && (StrCmp (Key, Node->Key) == 0)) {
+      return Node;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Reports whether an environment variable is Volatile or Non-Volatile.
 
@@ -436,23 +496,18 @@ ShellFindEnvVarInList (
     return SHELL_INVALID_PARAMETER;
   }
 
-  for ( Node = (ENV_VAR_LIST *)GetFirstNode (&gShellEnvVarList.Link)
-        ; !IsNull (&gShellEnvVarList.Link, &Node->Link)
-        ; Node = (ENV_VAR_LIST *)GetNextNode (&gShellEnvVarList.Link, &Node->Link)
-        )
-  {
-    if ((Node->Key != NULL) && (StrCmp (Key, Node->Key) == 0)) {
-      *Value     = AllocateCopyPool (StrSize (Node->Val), Node->Val);
-      *ValueSize = StrSize (Node->Val);
-      if (Atts != NULL) {
-        *Atts = Node->Atts;
-      }
+  Node = ShellFindEnvVarNode (Key);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
+  }
 
-      return EFI_SUCCESS;
-    }
+  *Value     = AllocateCopyPool (StrSize (Node->Val), Node->Val);
+  *ValueSize = StrSize (Node->Val);
+  if (Atts != NULL) {
+    *Atts = Node->Atts;
   }
 
-  return EFI_NOT_FOUND;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -492,17 +547,12 @@ ShellAddEnvVarToList (
   //
   // Update the variable value if it exists in gShellEnvVarList.
   //
-  for ( Node = (ENV_VAR_LIST *)GetFirstNode (&gShellEnvVarList.Link)
-        ; !IsNull (&gShellEnvVarList.Link, &Node->Link)
-        ; Node = (ENV_VAR_LIST *)GetNextNode (&gShellEnvVarList.Link, &Node->Link)
-        )
-  {
-    if ((Node->Key != NULL) && (StrCmp (Key, Node->Key) == 0)) {
-      Node->Atts = Atts;
-      SHELL_FREE_NON_NULL (Node->Val);
-      Node->Val = LocalValue;
-      return EFI_SUCCESS;
-    }
+  Node = ShellFindEnvVarNode (Key);
+  if (Node != NULL) {
+    Node->Atts = Atts;
+    SHELL_FREE_NON_NULL (Node->Val);
+    Node->Val = LocalValue;
+    return EFI_SUCCESS;
   }
 
   //
@@ -526,6 +576,7 @@ ShellAddEnvVarToList (
   Node->Val  = LocalValue;
   Node->Atts = Atts;
   InsertTailList (&gShellEnvVarList.Link, &Node->Link);
+  InsertTailList (ShellEnvVarHashBucket (Key), &Node->HashLink);
 
   return EFI_SUCCESS;
 }
@@ -550,21 +601,17 @@ ShellRemvoeEnvVarFromList (
     return EFI_INVALID_PARAMETER;
   }
 
-  for ( Node = (ENV_VAR_LIST *)GetFirstNode (&gShellEnvVarList.Link)
-        ; !IsNull (&gShellEnvVarList.Link, &Node->Link)
-        ; Node = (ENV_VAR_LIST *)GetNextNode (&gShellEnvVarList.Link, &Node->Link)
-        )
-  {
-    if ((Node->Key != NULL) && (StrCmp (Key, Node->Key) == 0)) {
-      SHELL_FREE_NON_NULL (Node->Key);
-      SHELL_FREE_NON_NULL (Node->Val);
-      RemoveEntryList (&Node->Link);
-      SHELL_FREE_NON_NULL (Node);
-      return EFI_SUCCESS;
-    }
+  Node = ShellFindEnvVarNode (Key);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  SHELL_FREE_NON_NULL (Node->Key);
+  SHELL_FREE_NON_NULL (Node->Val);
+  RemoveEntryList (&Node->Link);
+  RemoveEntryList (&Node->HashLink);
+  SHELL_FREE_NON_NULL (Node);
+  return EFI_SUCCESS;
 }
 
 /**
@@ -577,11 +624,25 @@ ShellInitEnvVarList (
   VOID
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS    Status;
+  UINTN         Index;
+  ENV_VAR_LIST  *Node;
 
   InitializeListHead (&gShellEnvVarList.Link);
   Status = GetEnvironmentVariableList (&gShellEnvVarList.Link);
 
+  for (Index = 0; Index < ENV_VAR_HASH_BUCKETS; Index++) {
+    InitializeListHead (&mShellEnvVarHash[Index]);
+  }
+
+  for ( Node = (ENV_VAR_LIST *)GetFirstNode (&gShellEnvVarList.Link)
+        ; !IsNull (&gShellEnvVarList.Link, &Node->Link)
+        ; Node = (ENV_VAR_LIST *)GetNextNode (&gShellEnvVarList.Link, &Node->Link)
+        )
+  {
+    InsertTailList (ShellEnvVarHashBucket (Node->Key), &Node->HashLink);
+  }
+
   return Status;
 }
 
@@ -594,8 +655,14 @@ ShellFreeEnvVarList (
   VOID
   )
 {
+  UINTN  Index;
+
   FreeEnvironmentVariableList (&gShellEnvVarList.Link);
   InitializeListHead (&gShellEnvVarList.Link);
 
+  for (Index = 0; Index < ENV_VAR_HASH_BUCKETS; Index++) {
+    InitializeListHead (&mShellEnvVarHash[Index]);
+  }
+
   return;
 }
@@ -84,6 +84,7 @@ STATIC CONST SHELL_PARAM_ITEM  ParamList[] = {
   { L"-c", TypeValue }, // -c   Display cumulative data.
   { L"-n", TypeValue }, // -n # Number of records to display for A and R
   { L"-t", TypeValue }, // -t # Threshold of interest
+  { L"-o", TypeValue }, // -o   Export a Chrome trace to a file
   { NULL,  TypeMax   }
 };
 
@@ -668,6 +669,7 @@ RunDp (
   BOOLEAN        ExcludeMode;
   BOOLEAN        CumulativeMode;
   CONST CHAR16   *CustomCumulativeToken;
+  CONST CHAR16   *TraceFileName;
   PERF_CUM_DATA  *CustomCumulativeData;
   UINTN          NameSize;
   SHELL_STATUS   ShellStatus;
@@ -682,6 +684,7 @@ RunDp (
   ExcludeMode          = FALSE;
   CumulativeMode       = FALSE;
   CustomCumulativeData = NULL;
+  TraceFileName        = NULL;
   ShellStatus          = SHELL_SUCCESS;
 
   //
@@ -791,6 +794,15 @@ RunDp (
     }
   }
 
+  if (ShellCommandLineGetFlag (ParamPackage, L"-o")) {
+    TraceFileName = ShellCommandLineGetValue (ParamPackage, L"-o");
+    if (TraceFileName == NULL) {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_TOO_FEW), mDpHiiHandle);
+      ShellStatus = SHELL_INVALID_PARAMETER;
+      goto Done;
+    }
+  }
+
   //
   // DP dump performance data by parsing FPDT table in ACPI table.
   // Folloing 3 steps are to get the measurement form the FPDT table.
@@ -897,7 +909,18 @@ RunDp (
   ****    Cooked (Default)
   ****************************************************************************/
   GatherStatistics (CustomCumulativeData);
-  if (CumulativeMode) {
+  if (TraceFileName != NULL) {
+    Status = DumpChromeTrace (TraceFileName);
+    if (Status == EFI_ABORTED) {
+      ShellStatus = SHELL_ABORTED;
+      goto Done;
+    } else if (EFI_ERROR (Status)) {
+      ShellStatus = SHELL_DEVICE_ERROR;
+      goto Done;
+    }
+
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_TRACE_EXPORTED), mDpHiiHandle, TraceFileName);
+  } else if (CumulativeMode) {
     ProcessCumulative (CustomCumulativeData);
   } else if (AllMode) {
     Status = DumpAllTrace (Number2Display, ExcludeMode);
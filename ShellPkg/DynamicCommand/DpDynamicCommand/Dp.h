@@ -38,7 +38,7 @@
 extern EFI_HII_HANDLE  mDpHiiHandle;
 
 #define DP_MAJOR_VERSION  2
-#define DP_MINOR_VERSION  5
+#define DP_MINOR_VERSION  6
 
 /**
   * The value assigned to DP_DEBUG controls which debug output
@@ -15,6 +15,8 @@
 #define _DP_INTELNAL_H_
 
 #define DP_GAUGE_STRING_LENGTH  36
+#define DP_TRACE_NAME_SIZE      0x200
+#define DP_TRACE_LINE_SIZE      0x600
 
 //
 /// Module-Global Variables
@@ -243,6 +245,27 @@ DumpRawTrace (
   IN BOOLEAN  ExcludeFlag
   );
 
+/**
+  Export all Trace Records as a Chrome trace event JSON file.
+
+  Each complete measurement becomes a duration event and each incomplete
+  measurement an instant event, with time stamps in microseconds. The events
+  are grouped into the Phases, PEIMs, Drivers and General tracks so that the
+  file can be loaded into chrome://tracing or the Perfetto UI to see the
+  order, length and gaps of the SEC/PEI/DXE/BDS phases and of every module.
+
+  @param[in]  FileName    The name of the file to create. An existing file is replaced.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @retval EFI_OUT_OF_RESOURCES  A buffer could not be allocated.
+  @return Others                The file could not be created or written.
+**/
+EFI_STATUS
+DumpChromeTrace (
+  IN CONST CHAR16  *FileName
+  );
+
 /**
   Gather and print Major Phase metrics.
 
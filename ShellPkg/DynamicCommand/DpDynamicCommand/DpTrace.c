@@ -1039,3 +1039,235 @@ ProcessCumulative (
       );
   }
 }
+
+/**
+  Copy a Unicode string into an ASCII buffer as the body of a JSON string.
+
+  Quotes, backslashes and control characters are escaped, and characters
+  outside the ASCII range are replaced with '?'. The result is truncated,
+  if necessary, so that Destination is not overrun.
+
+  @param[in]  Source           The Null-terminated Unicode string to convert.
+  @param[out] Destination      The buffer that receives the escaped ASCII string.
+  @param[in]  DestinationSize  The size, in bytes, of Destination.
+
+**/
+STATIC
+VOID
+DpJsonEscapeString (
+  IN  CONST CHAR16  *Source,
+  OUT CHAR8         *Destination,
+  IN  UINTN         DestinationSize
+  )
+{
+  UINTN  Index;
+
+  Index = 0;
+  for ( ; *Source != L'\0'; Source++) {
+    if (Index + 7 > DestinationSize) {
+      break;
+    }
+
+    if ((*Source == L'"') || (*Source == L'\\')) {
+      Destination[Index++] = '\\';
+      Destination[Index++] = (CHAR8)*Source;
+    } else if (*Source < 0x20) {
+      Index += AsciiSPrint (&Destination[Index], DestinationSize - Index, "\\u%04x", *Source);
+    } else if (*Source >= 0x80) {
+      Destination[Index++] = '?';
+    } else {
+      Destination[Index++] = (CHAR8)*Source;
+    }
+  }
+
+  Destination[Index] = '\0';
+}
+
+/**
+  Export all Trace Records as a Chrome trace event JSON file.
+
+  Each complete measurement becomes a duration event and each incomplete
+  measurement an instant event, with time stamps in microseconds. The events
+  are grouped into the Phases, PEIMs, Drivers and General tracks so that the
+  file can be loaded into chrome://tracing or the Perfetto UI to see the
+  order, length and gaps of the SEC/PEI/DXE/BDS phases and of every module.
+
+  @param[in]  FileName    The name of the file to create. An existing file is replaced.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @retval EFI_OUT_OF_RESOURCES  A buffer could not be allocated.
+  @return Others                The file could not be created or written.
+**/
+EFI_STATUS
+DumpChromeTrace (
+  IN CONST CHAR16  *FileName
+  )
+{
+  MEASUREMENT_RECORD  Measurement;
+  SHELL_FILE_HANDLE   FileHandle;
+  EFI_HANDLE          *HandleBuffer;
+  UINTN               HandleCount;
+  UINTN               LogEntryKey;
+  UINTN               Index;
+  UINTN               Size;
+  UINT64              Duration;
+  UINT32              Remainder;
+  UINT32              DurRemainder;
+  UINT32              TrackId;
+  CHAR8               *Line;
+  CHAR8               *Name;
+  CHAR8               *Category;
+  EFI_STATUS          Status;
+
+  HandleBuffer = NULL;
+  HandleCount  = 0;
+  Line         = AllocatePool (DP_TRACE_LINE_SIZE);
+  Name         = AllocatePool (DP_TRACE_NAME_SIZE);
+  Category     = AllocatePool (DP_TRACE_NAME_SIZE);
+  if ((Line == NULL) || (Name == NULL) || (Category == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  //
+  // Replace the file if it already exists.
+  //
+  Status = ShellOpenFileByName (FileName, &FileHandle, EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+  if (!EFI_ERROR (Status)) {
+    ShellDeleteFile (&FileHandle);
+  }
+
+  Status = ShellOpenFileByName (FileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
+  if (EFI_ERROR (Status)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_OPEN_FAIL), mDpHiiHandle, FileName, Status);
+    goto Done;
+  }
+
+  //
+  // Image handles are only resolved to driver names if they are still valid.
+  //
+  gBS->LocateHandleBuffer (AllHandles, NULL, NULL, &HandleCount, &HandleBuffer);
+
+  Size = AsciiSPrint (
+           Line,
+           DP_TRACE_LINE_SIZE,
+           "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+           "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Firmware Boot\"}},\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Phases\"}},\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"PEIMs\"}},\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"Drivers\"}},\n"
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":4,\"args\":{\"name\":\"General\"}}"
+           );
+  Status = ShellWriteFile (FileHandle, &Size, Line);
+
+  LogEntryKey = 0;
+  while (!EFI_ERROR (Status) &&
+         ((LogEntryKey = GetPerformanceMeasurementRecord (
+                           LogEntryKey,
+                           &Measurement.Handle,
+                           &Measurement.Token,
+                           &Measurement.Module,
+                           &Measurement.StartTimeStamp,
+                           &Measurement.EndTimeStamp,
+                           &Measurement.Identifier
+                           )) != 0))
+  {
+    if (Measurement.Token == NULL) {
+      continue;
+    }
+
+    //
+    // Pick the track and a human readable name for the measurement.
+    //
+    mGaugeString[0] = 0;
+    if (IsPhase (&Measurement)) {
+      TrackId = 1;
+    } else if (AsciiStrCmp (Measurement.Token, ALit_PEIM) == 0) {
+      TrackId = 2;
+      if ((Measurement.Module == NULL) || (AsciiStrCmp (Measurement.Module, ALit_PEIM) == 0)) {
+        UnicodeSPrint (mGaugeString, sizeof (mGaugeString), L"%g", Measurement.Handle);
+      }
+    } else if (IsCorePerf (&Measurement)) {
+      TrackId = 3;
+    } else {
+      TrackId = 4;
+    }
+
+    if ((mGaugeString[0] == 0) && (Measurement.Module != NULL) &&
+        (Measurement.Module[0] != '\0') && (AsciiStrCmp (Measurement.Module, Measurement.Token) != 0))
+    {
+      AsciiStrnToUnicodeStrS (Measurement.Module, DP_GAUGE_STRING_LENGTH, mGaugeString, ARRAY_SIZE (mGaugeString), &Size);
+    }
+
+    if ((mGaugeString[0] == 0) && (Measurement.Handle != NULL)) {
+      for (Index = 0; Index < HandleCount; Index++) {
+        if (Measurement.Handle == HandleBuffer[Index]) {
+          DpGetNameFromHandle (HandleBuffer[Index]); // Name is put into mGaugeString
+          break;
+        }
+      }
+    }
+
+    AsciiStrnToUnicodeStrS (Measurement.Token, DXE_PERFORMANCE_STRING_LENGTH, mUnicodeToken, ARRAY_SIZE (mUnicodeToken), &Size);
+    mGaugeString[DP_GAUGE_STRING_LENGTH] = 0;
+    DpJsonEscapeString ((mGaugeString[0] == 0) ? mUnicodeToken : mGaugeString, Name, DP_TRACE_NAME_SIZE);
+    DpJsonEscapeString (mUnicodeToken, Category, DP_TRACE_NAME_SIZE);
+
+    //
+    // Time stamps are in nanoseconds, trace events in microseconds.
+    //
+    if (Measurement.EndTimeStamp != 0) {
+      Duration = GetDuration (&Measurement);
+      Size     = AsciiSPrint (
+                   Line,
+                   DP_TRACE_LINE_SIZE,
+                   ",\n{\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%Ld.%03d,\"dur\":%Ld.%03d,\"args\":{\"id\":%d}}",
+                   Name,
+                   Category,
+                   TrackId,
+                   DivU64x32Remainder (Measurement.StartTimeStamp, 1000, &Remainder),
+                   Remainder,
+                   DivU64x32Remainder (Duration, 1000, &DurRemainder),
+                   DurRemainder,
+                   Measurement.Identifier
+                   );
+    } else {
+      Size = AsciiSPrint (
+               Line,
+               DP_TRACE_LINE_SIZE,
+               ",\n{\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%Ld.%03d,\"args\":{\"id\":%d}}",
+               Name,
+               Category,
+               TrackId,
+               DivU64x32Remainder (Measurement.StartTimeStamp, 1000, &Remainder),
+               Remainder,
+               Measurement.Identifier
+               );
+    }
+
+    Status = ShellWriteFile (FileHandle, &Size, Line);
+
+    if (ShellGetExecutionBreakFlag ()) {
+      Status = EFI_ABORTED;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Size   = AsciiSPrint (Line, DP_TRACE_LINE_SIZE, "\n]}\n");
+    Status = ShellWriteFile (FileHandle, &Size, Line);
+  }
+
+  ShellCloseFile (&FileHandle);
+
+  if (EFI_ERROR (Status) && (Status != EFI_ABORTED)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_WRITE_FAIL), mDpHiiHandle, FileName, Status);
+  }
+
+Done:
+  SHELL_FREE_NON_NULL (HandleBuffer);
+  SHELL_FREE_NON_NULL (Line);
+  SHELL_FREE_NON_NULL (Name);
+  SHELL_FREE_NON_NULL (Category);
+  return Status;
+}
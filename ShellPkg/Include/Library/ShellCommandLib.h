@@ -382,6 +382,7 @@ typedef struct {
   CHAR16        *Cl;        ///< The original command line.
   VOID          *Data;      ///< The data structure format dependant upon Command. (not always used)
   BOOLEAN       Reset;      ///< Reset the command (it must be treated like a initial run (but it may have data already))
+  CHAR16        *StrippedCl; ///< Cl with the comments removed, cached the first time the line is run.
 } SCRIPT_COMMAND_LIST;
 
 typedef struct {
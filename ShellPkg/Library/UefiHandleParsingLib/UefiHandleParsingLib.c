@@ -127,6 +127,8 @@ ConvertMemoryType (
       break;
     case EfiPalCode:                  StrnCatGrow (&RetVal, NULL, L"EfiPalCode", 0);
       break;
+    case EfiUnacceptedMemoryType:     StrnCatGrow (&RetVal, NULL, L"EfiUnacceptedMemoryType", 0);
+      break;
     case EfiMaxMemoryType:            StrnCatGrow (&RetVal, NULL, L"EfiMaxMemoryType", 0);
       break;
     default: ASSERT (FALSE);
@@ -1169,6 +1169,8 @@ DeleteScriptFileStruct (
         SHELL_FREE_NON_NULL (Script->CurrentCommand->Data);
       }
 
+      SHELL_FREE_NON_NULL (Script->CurrentCommand->StrippedCl);
+
       SHELL_FREE_NON_NULL (Script->CurrentCommand);
     }
   }
@@ -11,6 +11,13 @@
 #include <Guid/FileSystemInfo.h>
 #include <Guid/FileSystemVolumeLabelInfo.h>
 
+//
+// Size of each of the two buffers data is copied through. While one buffer is
+// written to the destination, the next block of the source is read into the
+// other one.
+//
+#define CP_BUFFER_SIZE  SIZE_1MB
+
 /**
   Function to take a list of files to copy and a destination location and do
   the verification and copying of those files to that location.  This function
@@ -37,6 +44,215 @@ ValidateAndCopyFiles (
   IN VOID                       **Resp
   );
 
+/**
+  Start a read or a write on a file. It is queued with ReadEx() or WriteEx()
+  when the file supports asynchronous I/O, and is done right away otherwise.
+
+  @param[in] File       The file to read from or write to.
+  @param[in] Write      TRUE to write, FALSE to read.
+  @param[in, out] Token The token describing the transfer. Token->Event is
+                        signaled when the transfer is done.
+
+  @retval EFI_SUCCESS   The transfer is started, wait for Token->Event and
+                        check Token->Status.
+  @retval other         The transfer could not be started.
+**/
+STATIC
+EFI_STATUS
+CpStartFileIo (
+  IN     EFI_FILE_PROTOCOL  *File,
+  IN     BOOLEAN            Write,
+  IN OUT EFI_FILE_IO_TOKEN  *Token
+  )
+{
+  EFI_STATUS  Status;
+
+  if (File->Revision >= EFI_FILE_PROTOCOL_REVISION2) {
+    Token->Status = EFI_NOT_READY;
+    if (Write) {
+      Status = File->WriteEx (File, Token);
+    } else {
+      Status = File->ReadEx (File, Token);
+    }
+
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
+  if (Write) {
+    Token->Status = File->Write (File, &Token->BufferSize, Token->Buffer);
+  } else {
+    Token->Status = File->Read (File, &Token->BufferSize, Token->Buffer);
+  }
+
+  return gBS->SignalEvent (Token->Event);
+}
+
+/**
+  Wait for a transfer started by CpStartFileIo() to finish.
+
+  @param[in] Token      The token of the transfer.
+
+  @return The status of the transfer.
+**/
+STATIC
+EFI_STATUS
+CpWaitFileIo (
+  IN EFI_FILE_IO_TOKEN  *Token
+  )
+{
+  UINTN  Index;
+
+  gBS->WaitForEvent (1, &Token->Event, &Index);
+  return Token->Status;
+}
+
+/**
+  Copy the data of one file to another one, reading the next block of the
+  source while the previous one is written to the destination.
+
+  @param[in] Source       The file to copy from, at its start.
+  @param[in] Dest         The file to copy to, empty.
+  @param[out] BytesCopied The number of bytes written to Dest.
+  @param[out] ReadFailed  TRUE if the copy failed reading Source, FALSE if it
+                          failed writing Dest.
+
+  @retval EFI_SUCCESS           All of the data was copied.
+  @retval EFI_OUT_OF_RESOURCES  The buffers could not be allocated.
+  @retval other                 Reading or writing the files failed.
+**/
+STATIC
+EFI_STATUS
+CpCopyFileData (
+  IN  EFI_FILE_PROTOCOL  *Source,
+  IN  EFI_FILE_PROTOCOL  *Dest,
+  OUT UINT64             *BytesCopied,
+  OUT BOOLEAN            *ReadFailed
+  )
+{
+  EFI_STATUS         Status;
+  EFI_STATUS         ReadStatus;
+  UINT8              *Buffer[2];
+  UINTN              BufferSize;
+  UINTN              Current;
+  EFI_FILE_IO_TOKEN  ReadToken;
+  EFI_FILE_IO_TOKEN  WriteToken;
+
+  *BytesCopied = 0;
+  *ReadFailed  = FALSE;
+
+  ZeroMem (&ReadToken, sizeof (ReadToken));
+  ZeroMem (&WriteToken, sizeof (WriteToken));
+
+  BufferSize = MAX (CP_BUFFER_SIZE, PcdGet32 (PcdShellFileOperationSize));
+  Buffer[0]  = AllocatePool (BufferSize);
+  Buffer[1]  = AllocatePool (BufferSize);
+  if ((Buffer[0] == NULL) || (Buffer[1] == NULL)) {
+    //
+    // Fall back to the regular file operation size.
+    //
+    SHELL_FREE_NON_NULL (Buffer[0]);
+    SHELL_FREE_NON_NULL (Buffer[1]);
+    BufferSize = PcdGet32 (PcdShellFileOperationSize);
+    Buffer[0]  = AllocatePool (BufferSize);
+    Buffer[1]  = AllocatePool (BufferSize);
+    if ((Buffer[0] == NULL) || (Buffer[1] == NULL)) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Done;
+    }
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &ReadToken.Event);
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->CreateEvent (0, 0, NULL, NULL, &WriteToken.Event);
+  }
+
+  if (EFI_ERROR (Status)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  //
+  // Read the first block.
+  //
+  Current              = 0;
+  ReadToken.Buffer     = Buffer[Current];
+  ReadToken.BufferSize = BufferSize;
+  Status               = CpStartFileIo (Source, FALSE, &ReadToken);
+  if (!EFI_ERROR (Status)) {
+    Status = CpWaitFileIo (&ReadToken);
+  }
+
+  if (EFI_ERROR (Status)) {
+    *ReadFailed = TRUE;
+    goto Done;
+  }
+
+  while (ReadToken.BufferSize != 0) {
+    //
+    // Write the block which was just read, and read the next one into the
+    // other buffer in the meantime.
+    //
+    WriteToken.Buffer     = Buffer[Current];
+    WriteToken.BufferSize = ReadToken.BufferSize;
+    Status                = CpStartFileIo (Dest, TRUE, &WriteToken);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Current              ^= 1;
+    ReadToken.Buffer      = Buffer[Current];
+    ReadToken.BufferSize  = BufferSize;
+    ReadStatus            = CpStartFileIo (Source, FALSE, &ReadToken);
+    if (!EFI_ERROR (ReadStatus)) {
+      ReadStatus = CpWaitFileIo (&ReadToken);
+    }
+
+    Status = CpWaitFileIo (&WriteToken);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    *BytesCopied += WriteToken.BufferSize;
+
+    if (EFI_ERROR (ReadStatus)) {
+      Status      = ReadStatus;
+      *ReadFailed = TRUE;
+      break;
+    }
+  }
+
+Done:
+  if (ReadToken.Event != NULL) {
+    gBS->CloseEvent (ReadToken.Event);
+  }
+
+  if (WriteToken.Event != NULL) {
+    gBS->CloseEvent (WriteToken.Event);
+  }
+
+  SHELL_FREE_NON_NULL (Buffer[0]);
+  SHELL_FREE_NON_NULL (Buffer[1]);
+  return Status;
+}
+
+/**
+  Get a time of day in milliseconds.
+
+  @param[in] Time       The time to convert.
+
+  @return The number of milliseconds since midnight.
+**/
+STATIC
+UINT64
+CpTimeOfDayInMs (
+  IN CONST EFI_TIME  *Time
+  )
+{
+  return (((UINT64)Time->Hour * 60 + Time->Minute) * 60 + Time->Second) * 1000 + Time->Nanosecond / 1000000;
+}
+
 /**
   Function to Copy one file to another location
 
@@ -60,11 +276,9 @@ CopySingleFile (
   )
 {
   VOID                  *Response;
-  UINTN                 ReadSize;
   SHELL_FILE_HANDLE     SourceHandle;
   SHELL_FILE_HANDLE     DestHandle;
   EFI_STATUS            Status;
-  VOID                  *Buffer;
   CHAR16                *TempName;
   UINTN                 Size;
   EFI_SHELL_FILE_INFO   *List;
@@ -74,6 +288,11 @@ CopySingleFile (
   EFI_FILE_PROTOCOL     *DestVolumeFP;
   EFI_FILE_SYSTEM_INFO  *DestVolumeInfo;
   UINTN                 DestVolumeInfoSize;
+  UINT64                BytesCopied;
+  BOOLEAN               ReadFailed;
+  EFI_TIME              StartTime;
+  EFI_TIME              EndTime;
+  UINT64                ElapsedMs;
 
   ASSERT (Resp != NULL);
 
@@ -84,7 +303,6 @@ CopySingleFile (
   DestVolumeInfo = NULL;
   ShellStatus    = SHELL_SUCCESS;
 
-  ReadSize = PcdGet32 (PcdShellFileOperationSize);
   // Why bother copying a file to itself
   if (StrCmp (Source, Dest) == 0) {
     return (SHELL_SUCCESS);
@@ -225,25 +443,48 @@ CopySingleFile (
       //
       // copy data between files
       //
-      Buffer = AllocateZeroPool (ReadSize);
-      if (Buffer == NULL) {
-        ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_OUT_MEM), gShellLevel2HiiHandle, CmdName);
-        return SHELL_OUT_OF_RESOURCES;
+      if (EFI_ERROR (gRT->GetTime (&StartTime, NULL))) {
+        ZeroMem (&StartTime, sizeof (StartTime));
       }
 
-      while (ReadSize == PcdGet32 (PcdShellFileOperationSize) && !EFI_ERROR (Status)) {
-        Status = ShellReadFile (SourceHandle, &ReadSize, Buffer);
-        if (!EFI_ERROR (Status)) {
-          Status = ShellWriteFile (DestHandle, &ReadSize, Buffer);
-          if (EFI_ERROR (Status)) {
-            ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
-            ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_WRITE_ERROR), gShellLevel2HiiHandle, CmdName, Dest);
-            break;
-          }
-        } else {
-          ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
+      Status = CpCopyFileData (
+                 ConvertShellHandleToEfiFileProtocol (SourceHandle),
+                 DestVolumeFP,
+                 &BytesCopied,
+                 &ReadFailed
+                 );
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        ShellStatus = SHELL_OUT_OF_RESOURCES;
+        ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_OUT_MEM), gShellLevel2HiiHandle, CmdName);
+      } else if (EFI_ERROR (Status)) {
+        ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
+        if (ReadFailed) {
           ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_READ_ERROR), gShellLevel2HiiHandle, CmdName, Source);
-          break;
+        } else {
+          ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_WRITE_ERROR), gShellLevel2HiiHandle, CmdName, Dest);
+        }
+      } else if (!SilentMode && !EFI_ERROR (gRT->GetTime (&EndTime, NULL))) {
+        //
+        // Report the throughput of copies which take a noticeable time.
+        //
+        ElapsedMs = CpTimeOfDayInMs (&EndTime);
+        if (ElapsedMs < CpTimeOfDayInMs (&StartTime)) {
+          ElapsedMs += 24 * 60 * 60 * 1000;
+        }
+
+        ElapsedMs -= CpTimeOfDayInMs (&StartTime);
+        if (ElapsedMs >= 1000) {
+          ShellPrintHiiEx (
+            -1,
+            -1,
+            NULL,
+            STRING_TOKEN (STR_CP_THROUGHPUT),
+            gShellLevel2HiiHandle,
+            BytesCopied,
+            (UINTN)DivU64x32 (ElapsedMs, 1000),
+            (UINTN)ModU64x32 (ElapsedMs, 1000),
+            DivU64x64Remainder (BytesCopied, ElapsedMs, NULL)
+            );
         }
       }
     }
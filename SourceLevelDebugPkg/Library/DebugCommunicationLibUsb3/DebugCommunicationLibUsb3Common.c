@@ -881,7 +881,6 @@ DebugPortReadBuffer (
   )
 {
   USB3_DEBUG_PORT_HANDLE  *UsbDebugPortHandle;
-  UINT8                   Index;
   UINT8                   *Data;
 
   if ((NumberOfBytes != 1) || (Buffer == NULL) || (Timeout != 0)) {
@@ -916,22 +915,20 @@ DebugPortReadBuffer (
   Data = (UINT8 *)(UINTN)UsbDebugPortHandle->Data;
 
   //
-  // Read data from buffer
+  // Read data from buffer. Advance the offset instead of moving the rest of
+  // the data down, as the debug agent reads one byte at a time.
   //
   if (UsbDebugPortHandle->DataCount < 1) {
     return 0;
   } else {
-    *Buffer = Data[0];
-
-    for (Index = 0; Index < UsbDebugPortHandle->DataCount - 1; Index++) {
-      if ((Index + 1) >= XHCI_DEBUG_DEVICE_MAX_PACKET_SIZE) {
-        return 0;
-      }
-
-      Data[Index] = Data[Index + 1];
+    if (UsbDebugPortHandle->DataOffset >= XHCI_DEBUG_DEVICE_MAX_PACKET_SIZE) {
+      return 0;
     }
 
-    UsbDebugPortHandle->DataCount = (UINT8)(UsbDebugPortHandle->DataCount - 1);
+    *Buffer = Data[UsbDebugPortHandle->DataOffset];
+
+    UsbDebugPortHandle->DataOffset = (UINT16)(UsbDebugPortHandle->DataOffset + 1);
+    UsbDebugPortHandle->DataCount  = (UINT16)(UsbDebugPortHandle->DataCount - 1);
     return 1;
   }
 }
@@ -1089,7 +1086,8 @@ DebugPortPollBuffer (
   //
   // Store data into internal buffer for use later
   //
-  UsbDebugPortHandle->DataCount = (UINT8)Length;
+  UsbDebugPortHandle->DataCount  = (UINT16)Length;
+  UsbDebugPortHandle->DataOffset = 0;
   return TRUE;
 }
 
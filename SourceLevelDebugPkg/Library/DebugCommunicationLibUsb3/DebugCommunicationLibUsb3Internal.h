@@ -529,7 +529,11 @@ typedef struct _USB3_DEBUG_PORT_INSTANCE {
   //
   // The available data length in the following data buffer.
   //
-  UINT8                   DataCount;
+  UINT16                  DataCount;
+  //
+  // The offset of the available data in the following data buffer.
+  //
+  UINT16                  DataOffset;
   //
   // The data buffer address for data read and poll.
   //
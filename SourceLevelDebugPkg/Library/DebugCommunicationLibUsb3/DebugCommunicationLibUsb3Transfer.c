@@ -255,7 +255,8 @@ XhcCheckUrbResult (
       // If it is read event and it should be generated by poll, and current operation is write, we need save data into internal buffer.
       // Internal buffer is used by next read.
       //
-      Handle->DataCount = (UINT8)(Handle->UrbIn.DataLen - EvtTrb->Length);
+      Handle->DataCount  = (UINT16)(Handle->UrbIn.DataLen - EvtTrb->Length);
+      Handle->DataOffset = 0;
       CopyMem ((VOID *)(UINTN)Handle->Data, (VOID *)(UINTN)Handle->UrbIn.Data, Handle->DataCount);
       //
       // Fill this TRB complete with CycleBit, otherwise next read will fail with old TRB.
@@ -341,7 +341,7 @@ MmEntryPoint (
   EFI_STATUS                 Status;
   EFI_MM_COMMUNICATE_HEADER  *CommunicateHeader;
 
-  DEBUG ((DEBUG_INFO, "MmEntryPoint ...\n"));
+  DEBUG ((DEBUG_VERBOSE, "MmEntryPoint ...\n"));
 
   //
   // Update MMST using the context
@@ -409,7 +409,7 @@ MmEntryPoint (
   //
   gMmCorePrivate->InMm = FALSE;
 
-  DEBUG ((DEBUG_INFO, "MmEntryPoint Done\n"));
+  DEBUG ((DEBUG_VERBOSE, "MmEntryPoint Done\n"));
 }
 
 /** Register the MM Entry Point provided by the MM Core with the
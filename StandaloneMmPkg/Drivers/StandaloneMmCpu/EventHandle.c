@@ -59,6 +59,48 @@ EFI_MM_CONFIGURATION_PROTOCOL  mMmConfig = {
 
 STATIC EFI_MM_ENTRY_POINT  mMmEntryPoint = NULL;
 
+//
+// The partition is only ever entered on one CPU at a time, so all the events
+// share a single secure world copy of the communication buffer. It only grows,
+// to avoid a pool allocation and free for every MM communication.
+//
+STATIC EFI_MM_COMMUNICATE_HEADER  *mGuidedEventBuffer     = NULL;
+STATIC UINTN                      mGuidedEventBufferSize = 0;
+
+/**
+  Return a secure world buffer large enough for an event context.
+
+  @param  [in] Size               The size of the event context.
+
+  @return The buffer, or NULL if it could not be allocated.
+**/
+STATIC
+EFI_MM_COMMUNICATE_HEADER *
+GetGuidedEventBuffer (
+  IN UINTN  Size
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Buffer;
+
+  if (Size <= mGuidedEventBufferSize) {
+    return mGuidedEventBuffer;
+  }
+
+  Status = mMmst->MmAllocatePool (EfiRuntimeServicesData, Size, &Buffer);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  if (mGuidedEventBuffer != NULL) {
+    mMmst->MmFreePool (mGuidedEventBuffer);
+  }
+
+  mGuidedEventBuffer     = Buffer;
+  mGuidedEventBufferSize = Size;
+  return mGuidedEventBuffer;
+}
+
 /**
   The PI Standalone MM entry point for the TF-A CPU driver.
 
@@ -84,7 +126,7 @@ PiMmStandaloneArmTfCpuDriverEntry (
   EFI_STATUS                 Status;
   UINTN                      NsCommBufferSize;
 
-  DEBUG ((DEBUG_INFO, "Received event - 0x%x on cpu %d\n", EventId, CpuNumber));
+  DEBUG ((DEBUG_VERBOSE, "Received event - 0x%x on cpu %d\n", EventId, CpuNumber));
 
   Status = EFI_SUCCESS;
   //
@@ -125,16 +167,10 @@ PiMmStandaloneArmTfCpuDriverEntry (
     return EFI_ACCESS_DENIED;
   }
 
-  GuidedEventContext = NULL;
-  // Now that the secure world can see the normal world buffer, allocate
+  // Now that the secure world can see the normal world buffer, get the
   // memory to copy the communication buffer to the secure world.
-  Status = mMmst->MmAllocatePool (
-                    EfiRuntimeServicesData,
-                    NsCommBufferSize,
-                    (VOID **)&GuidedEventContext
-                    );
-
-  if (Status != EFI_SUCCESS) {
+  GuidedEventContext = GetGuidedEventBuffer (NsCommBufferSize);
+  if (GuidedEventContext == NULL) {
     DEBUG ((DEBUG_INFO, "Mem alloc failed - 0x%x\n", EventId));
     return EFI_OUT_OF_RESOURCES;
   }
@@ -164,15 +200,9 @@ PiMmStandaloneArmTfCpuDriverEntry (
 
   mMmEntryPoint (&MmEntryPointContext);
 
-  // Free the memory allocation done earlier and reset the per-cpu context
-  ASSERT (GuidedEventContext);
+  // Copy the result back and reset the per-cpu context
   CopyMem ((VOID *)NsCommBufferAddr, (CONST VOID *)GuidedEventContext, NsCommBufferSize);
 
-  Status = mMmst->MmFreePool ((VOID *)GuidedEventContext);
-  if (Status != EFI_SUCCESS) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
   PerCpuGuidedEventContext[CpuNumber] = NULL;
 
   return Status;
@@ -236,7 +266,7 @@ PiMmCpuTpFwRootMmiHandler (
   }
 
   DEBUG ((
-    DEBUG_INFO,
+    DEBUG_VERBOSE,
     "CommBuffer - 0x%x, CommBufferSize - 0x%x\n",
     PerCpuGuidedEventContext[CpuNumber],
     PerCpuGuidedEventContext[CpuNumber]->MessageLength
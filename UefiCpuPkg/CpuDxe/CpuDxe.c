@@ -21,6 +21,12 @@ UINT64      mValidMtrrAddressMask;
 UINT64      mValidMtrrBitsMask;
 UINT64      mTimerPeriod = 0;
 
+//
+// The MTRR settings accumulated by the MTRR transaction in progress.
+//
+BOOLEAN        mMtrrTransactionInProgress = FALSE;
+MTRR_SETTINGS  mMtrrTransactionSettings;
+
 FIXED_MTRR  mFixedMtrrTable[] = {
   {
     MSR_IA32_MTRR_FIX64K_00000,
@@ -339,6 +345,108 @@ SetMtrrsFromBuffer (
   MtrrSetAllMtrrs (Buffer);
 }
 
+/**
+  Program the MTRR settings of the BSP on all APs.
+
+  @param[in] MtrrSettings  The MTRR settings of the BSP.
+**/
+VOID
+SyncMtrrsWithAllAps (
+  IN MTRR_SETTINGS  *MtrrSettings
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpService;
+
+  Status = gBS->LocateProtocol (
+                  &gEfiMpServiceProtocolGuid,
+                  NULL,
+                  (VOID **)&MpService
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = MpService->StartupAllAPs (
+                          MpService,          // This
+                          SetMtrrsFromBuffer, // Procedure
+                          FALSE,              // SingleThread
+                          NULL,               // WaitEvent
+                          0,                  // TimeoutInMicrosecsond
+                          MtrrSettings,       // ProcedureArgument
+                          NULL                // FailedCpuList
+                          );
+    ASSERT (Status == EFI_SUCCESS || Status == EFI_NOT_STARTED);
+  }
+}
+
+/**
+  Begin an MTRR transaction.
+
+  Until the transaction is committed, CpuSetMemoryAttributes() only checks and
+  accumulates the cache attribute changes in mMtrrTransactionSettings.
+
+  @param[in]  This              The EDKII_MTRR_TRANSACTION_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The transaction is begun.
+  @retval EFI_ALREADY_STARTED   A transaction is in progress already.
+  @retval EFI_UNSUPPORTED       The processor does not support MTRRs.
+**/
+EFI_STATUS
+EFIAPI
+MtrrTransactionBegin (
+  IN EDKII_MTRR_TRANSACTION_PROTOCOL  *This
+  )
+{
+  if (!IsMtrrSupported ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (mMtrrTransactionInProgress) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  MtrrGetAllMtrrs (&mMtrrTransactionSettings);
+  mMtrrTransactionInProgress = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Commit the MTRR transaction in progress.
+
+  The accumulated MTRR settings are programmed on the BSP and then on all APs,
+  only once and only if they differ from the current ones.
+
+  @param[in]  This              The EDKII_MTRR_TRANSACTION_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The transaction is committed.
+  @retval EFI_NOT_STARTED       No transaction is in progress.
+**/
+EFI_STATUS
+EFIAPI
+MtrrTransactionCommit (
+  IN EDKII_MTRR_TRANSACTION_PROTOCOL  *This
+  )
+{
+  MTRR_SETTINGS  MtrrSettings;
+
+  if (!mMtrrTransactionInProgress) {
+    return EFI_NOT_STARTED;
+  }
+
+  mMtrrTransactionInProgress = FALSE;
+
+  MtrrGetAllMtrrs (&MtrrSettings);
+  if (CompareMem (&MtrrSettings, &mMtrrTransactionSettings, sizeof (MtrrSettings)) != 0) {
+    MtrrSetAllMtrrs (&mMtrrTransactionSettings);
+    SyncMtrrsWithAllAps (&mMtrrTransactionSettings);
+  }
+
+  return EFI_SUCCESS;
+}
+
+EDKII_MTRR_TRANSACTION_PROTOCOL  mMtrrTransaction = {
+  MtrrTransactionBegin,
+  MtrrTransactionCommit
+};
+
 /**
   Implementation of SetMemoryAttributes() service of CPU Architecture Protocol.
 
@@ -373,14 +481,12 @@ CpuSetMemoryAttributes (
   IN UINT64                 Attributes
   )
 {
-  RETURN_STATUS             Status;
-  MTRR_MEMORY_CACHE_TYPE    CacheType;
-  EFI_STATUS                MpStatus;
-  EFI_MP_SERVICES_PROTOCOL  *MpService;
-  MTRR_SETTINGS             MtrrSettings;
-  UINT64                    CacheAttributes;
-  UINT64                    MemoryAttributes;
-  MTRR_MEMORY_CACHE_TYPE    CurrentCacheType;
+  RETURN_STATUS           Status;
+  MTRR_MEMORY_CACHE_TYPE  CacheType;
+  MTRR_SETTINGS           MtrrSettings;
+  UINT64                  CacheAttributes;
+  UINT64                  MemoryAttributes;
+  MTRR_MEMORY_CACHE_TYPE  CurrentCacheType;
 
   //
   // If this function is called because GCD SetMemorySpaceAttributes () is called
@@ -445,43 +551,43 @@ CpuSetMemoryAttributes (
         return EFI_INVALID_PARAMETER;
     }
 
-    CurrentCacheType = MtrrGetMemoryAttribute (BaseAddress);
-    if (CurrentCacheType != CacheType) {
+    if (mMtrrTransactionInProgress) {
       //
-      // call MTRR library function
+      // Only check and accumulate the change, MtrrTransactionCommit() programs
+      // the MTRRs of all processors.
       //
-      Status = MtrrSetMemoryAttribute (
+      Status = MtrrSetMemoryAttributeInMtrrSettings (
+                 &mMtrrTransactionSettings,
                  BaseAddress,
                  Length,
                  CacheType
                  );
-
-      if (!RETURN_ERROR (Status)) {
-        MpStatus = gBS->LocateProtocol (
-                          &gEfiMpServiceProtocolGuid,
-                          NULL,
-                          (VOID **)&MpService
-                          );
+      if (RETURN_ERROR (Status)) {
+        return Status;
+      }
+    } else {
+      CurrentCacheType = MtrrGetMemoryAttribute (BaseAddress);
+      if (CurrentCacheType != CacheType) {
         //
-        // Synchronize the update with all APs
+        // call MTRR library function
         //
-        if (!EFI_ERROR (MpStatus)) {
+        Status = MtrrSetMemoryAttribute (
+                   BaseAddress,
+                   Length,
+                   CacheType
+                   );
+
+        if (!RETURN_ERROR (Status)) {
+          //
+          // Synchronize the update with all APs
+          //
           MtrrGetAllMtrrs (&MtrrSettings);
-          MpStatus = MpService->StartupAllAPs (
-                                  MpService,          // This
-                                  SetMtrrsFromBuffer, // Procedure
-                                  FALSE,              // SingleThread
-                                  NULL,               // WaitEvent
-                                  0,                  // TimeoutInMicrosecsond
-                                  &MtrrSettings,      // ProcedureArgument
-                                  NULL                // FailedCpuList
-                                  );
-          ASSERT (MpStatus == EFI_SUCCESS || MpStatus == EFI_NOT_STARTED);
+          SyncMtrrsWithAllAps (&MtrrSettings);
         }
-      }
 
-      if (EFI_ERROR (Status)) {
-        return Status;
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
       }
     }
   }
@@ -1221,12 +1327,14 @@ InitializeCpu (
   InitInterruptDescriptorTable ();
 
   //
-  // Install CPU Architectural Protocol
+  // Install CPU Architectural Protocol and MTRR Transaction Protocol
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mCpuHandle,
                   &gEfiCpuArchProtocolGuid,
                   &gCpu,
+                  &gEdkiiMtrrTransactionProtocolGuid,
+                  &mMtrrTransaction,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -13,6 +13,7 @@
 
 #include <Protocol/Cpu.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MtrrTransaction.h>
 #include <Register/Intel/Msr.h>
 
 #include <Ppi/SecPlatformInformation.h>
@@ -87,6 +87,7 @@ PAGE_ATTRIBUTE_TABLE  mPageAttributeTable[] = {
 
 PAGE_TABLE_POOL                *mPageTablePool    = NULL;
 BOOLEAN                        mPageTablePoolLock = FALSE;
+VOID                           *mPageTableFreeList = NULL;
 PAGE_TABLE_LIB_PAGING_CONTEXT  mPagingContext;
 EFI_SMM_BASE2_PROTOCOL         *mSmmBase2 = NULL;
 
@@ -269,28 +270,45 @@ PageAttributeToMask (
 }
 
 /**
-  Return page table entry to match the address.
+  Return the address encryption mask of page table entries.
+
+  @return The address encryption mask.
+**/
+UINT64
+GetPageTableAddressEncMask (
+  VOID
+  )
+{
+  UINT64  AddressEncMask;
+
+  // Make sure AddressEncMask is contained to smallest supported address field.
+  //
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+  if (AddressEncMask == 0) {
+    AddressEncMask = PcdGet64 (PcdTdxSharedBitMask) & PAGING_1G_ADDRESS_MASK_64;
+  }
+
+  return AddressEncMask;
+}
+
+/**
+  Return page directory pointer table entry to match the address.
 
   @param[in]  PagingContext     The paging context.
   @param[in]  Address           The address to be checked.
-  @param[out] PageAttributes    The page attribute of the page entry.
 
-  @return The page entry.
+  @return The page directory pointer table entry, or NULL if the address is
+          not mapped at the upper levels.
 **/
-VOID *
-GetPageTableEntry (
+UINT64 *
+GetPageDirectoryPointerEntry (
   IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
-  IN  PHYSICAL_ADDRESS               Address,
-  OUT PAGE_ATTRIBUTE                 *PageAttribute
+  IN  PHYSICAL_ADDRESS               Address
   )
 {
-  UINTN   Index1;
-  UINTN   Index2;
   UINTN   Index3;
   UINTN   Index4;
   UINTN   Index5;
-  UINT64  *L1PageTable;
-  UINT64  *L2PageTable;
   UINT64  *L3PageTable;
   UINT64  *L4PageTable;
   UINT64  *L5PageTable;
@@ -301,21 +319,13 @@ GetPageTableEntry (
   Index5 = ((UINTN)RShiftU64 (Address, 48)) & PAGING_PAE_INDEX_MASK;
   Index4 = ((UINTN)RShiftU64 (Address, 39)) & PAGING_PAE_INDEX_MASK;
   Index3 = ((UINTN)Address >> 30) & PAGING_PAE_INDEX_MASK;
-  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
-  Index1 = ((UINTN)Address >> 12) & PAGING_PAE_INDEX_MASK;
 
-  // Make sure AddressEncMask is contained to smallest supported address field.
-  //
-  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
-  if (AddressEncMask == 0) {
-    AddressEncMask = PcdGet64 (PcdTdxSharedBitMask) & PAGING_1G_ADDRESS_MASK_64;
-  }
+  AddressEncMask = GetPageTableAddressEncMask ();
 
   if (PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) {
     if ((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_5_LEVEL) != 0) {
       L5PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.X64.PageTableBase;
       if (L5PageTable[Index5] == 0) {
-        *PageAttribute = PageNone;
         return NULL;
       }
 
@@ -325,7 +335,6 @@ GetPageTableEntry (
     }
 
     if (L4PageTable[Index4] == 0) {
-      *PageAttribute = PageNone;
       return NULL;
     }
 
@@ -335,18 +344,50 @@ GetPageTableEntry (
     L3PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.Ia32.PageTableBase;
   }
 
-  if (L3PageTable[Index3] == 0) {
+  return &L3PageTable[Index3];
+}
+
+/**
+  Return page table entry to match the address.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  Address           The address to be checked.
+  @param[out] PageAttributes    The page attribute of the page entry.
+
+  @return The page entry.
+**/
+VOID *
+GetPageTableEntry (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               Address,
+  OUT PAGE_ATTRIBUTE                 *PageAttribute
+  )
+{
+  UINTN   Index1;
+  UINTN   Index2;
+  UINT64  *L1PageTable;
+  UINT64  *L2PageTable;
+  UINT64  *L3PageEntry;
+  UINT64  AddressEncMask;
+
+  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
+  Index1 = ((UINTN)Address >> 12) & PAGING_PAE_INDEX_MASK;
+
+  AddressEncMask = GetPageTableAddressEncMask ();
+
+  L3PageEntry = GetPageDirectoryPointerEntry (PagingContext, Address);
+  if ((L3PageEntry == NULL) || (*L3PageEntry == 0)) {
     *PageAttribute = PageNone;
     return NULL;
   }
 
-  if ((L3PageTable[Index3] & IA32_PG_PS) != 0) {
+  if ((*L3PageEntry & IA32_PG_PS) != 0) {
     // 1G
     *PageAttribute = Page1G;
-    return &L3PageTable[Index3];
+    return L3PageEntry;
   }
 
-  L2PageTable = (UINT64 *)(UINTN)(L3PageTable[Index3] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  L2PageTable = (UINT64 *)(UINTN)(*L3PageEntry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
   if (L2PageTable[Index2] == 0) {
     *PageAttribute = PageNone;
     return NULL;
@@ -616,6 +657,171 @@ SplitPage (
   }
 }
 
+/**
+  This function merges the page table pointed to by one page entry back into
+  one large page, if all entries of the page table map contiguous memory with
+  the same attributes.
+
+  The page table is freed. The caller must flush the TLB before the freed page
+  table is reused.
+
+  @param[in, out] PageEntry         The page entry pointing to the page table to be merged.
+  @param[in]      PageAttribute     Page2M to merge 4K pages, Page1G to merge 2M pages.
+
+  @retval TRUE    The page table is merged.
+  @retval FALSE   The page table cannot be merged.
+**/
+BOOLEAN
+MergePage (
+  IN OUT UINT64          *PageEntry,
+  IN     PAGE_ATTRIBUTE  PageAttribute
+  )
+{
+  UINT64  AddressEncMask;
+  UINT64  *PageTable;
+  UINT64  FirstEntry;
+  UINT64  ExpectedEntry;
+  UINT64  AccessedDirty;
+  UINT64  NewPageEntry;
+  UINTN   EntryLength;
+  UINTN   EntryAddressMask;
+  UINTN   Index;
+
+  ASSERT (PageAttribute == Page2M || PageAttribute == Page1G);
+
+  if (((*PageEntry & IA32_PG_P) == 0) || ((*PageEntry & IA32_PG_PS) != 0)) {
+    return FALSE;
+  }
+
+  AddressEncMask = GetPageTableAddressEncMask ();
+  PageTable      = (UINT64 *)(UINTN)(*PageEntry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+
+  //
+  // Entries of a 4K page table carry the PAT bit at the PS bit position, so
+  // only entries of a 2M page table must have PS set to be merged.
+  //
+  if (PageAttribute == Page2M) {
+    EntryLength      = SIZE_4KB;
+    EntryAddressMask = PageAttributeToMask (Page4K);
+  } else {
+    EntryLength      = SIZE_2MB;
+    EntryAddressMask = PageAttributeToMask (Page2M);
+    if ((PageTable[0] & IA32_PG_PS) == 0) {
+      return FALSE;
+    }
+  }
+
+  //
+  // The first entry must map the start of the large page. Each of the others
+  // must only differ from it by the address, ignoring accessed and dirty.
+  //
+  FirstEntry = PageTable[0] & ~(UINT64)(IA32_PG_A | IA32_PG_D);
+  if ((FirstEntry & ~AddressEncMask & EntryAddressMask & (PageAttributeToLength (PageAttribute) - 1)) != 0) {
+    return FALSE;
+  }
+
+  ExpectedEntry = FirstEntry;
+  AccessedDirty = 0;
+  for (Index = 0; Index < SIZE_4KB / sizeof (UINT64); Index++) {
+    if ((PageTable[Index] & ~(UINT64)(IA32_PG_A | IA32_PG_D)) != ExpectedEntry) {
+      return FALSE;
+    }
+
+    AccessedDirty |= PageTable[Index] & (IA32_PG_A | IA32_PG_D);
+    ExpectedEntry += EntryLength;
+  }
+
+  NewPageEntry = FirstEntry | AccessedDirty;
+  if (PageAttribute == Page2M) {
+    NewPageEntry |= IA32_PG_PS;
+    if ((FirstEntry & IA32_PG_PAT_4K) != 0) {
+      NewPageEntry |= IA32_PG_PAT_2M;
+    }
+  }
+
+  //
+  // Keep the access rights of the page table itself, which restrict the
+  // access rights of its entries.
+  //
+  NewPageEntry &= *PageEntry | ~(UINT64)(IA32_PG_P | IA32_PG_RW | IA32_PG_U);
+  NewPageEntry |= *PageEntry & IA32_PG_NX;
+
+  DEBUG ((DEBUG_VERBOSE, "Merge - 0x%x\n", PageTable));
+  *PageEntry = NewPageEntry;
+  FreePageTableMemory (PageTable);
+  return TRUE;
+}
+
+/**
+  This function merges the page tables covering one memory region back into
+  large pages wherever all their entries map memory with the same attributes.
+
+  The page tables split for the boundaries of the region are checked, as well
+  as the ones inside it. The caller must flush the TLB before the freed page
+  tables are reused.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  BaseAddress       The physical address that is the start address of a memory region.
+  @param[in]  Length            The size in bytes of the memory region.
+
+  @retval TRUE    Some page tables are merged.
+  @retval FALSE   No page table is merged.
+**/
+BOOLEAN
+CoalesceMemoryPages (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               BaseAddress,
+  IN  UINT64                         Length
+  )
+{
+  PHYSICAL_ADDRESS  Address;
+  PHYSICAL_ADDRESS  LastAddress;
+  UINT64            *L3PageEntry;
+  UINT64            *L2PageTable;
+  UINT64            AddressEncMask;
+  UINTN             Index;
+  UINTN             LastIndex;
+  BOOLEAN           Is1GPageSupported;
+  BOOLEAN           IsMerged;
+
+  AddressEncMask    = GetPageTableAddressEncMask ();
+  Is1GPageSupported = (BOOLEAN)((PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) &&
+                                ((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAGE_1G_SUPPORT) != 0));
+  IsMerged    = FALSE;
+  Address     = BaseAddress & ~(UINT64)PAGING_1G_MASK;
+  LastAddress = BaseAddress + Length - 1;
+
+  while (Address <= LastAddress) {
+    L3PageEntry = GetPageDirectoryPointerEntry (PagingContext, Address);
+    if ((L3PageEntry != NULL) && ((*L3PageEntry & IA32_PG_P) != 0) && ((*L3PageEntry & IA32_PG_PS) == 0)) {
+      //
+      // Only check the 2M entries overlapping the memory region.
+      //
+      Index     = (Address < BaseAddress) ? (((UINTN)BaseAddress >> 21) & PAGING_PAE_INDEX_MASK) : 0;
+      LastIndex = (LastAddress - Address < SIZE_1GB) ? (((UINTN)LastAddress >> 21) & PAGING_PAE_INDEX_MASK) : PAGING_PAE_INDEX_MASK;
+
+      L2PageTable = (UINT64 *)(UINTN)(*L3PageEntry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+      for ( ; Index <= LastIndex; Index++) {
+        if (MergePage (&L2PageTable[Index], Page2M)) {
+          IsMerged = TRUE;
+        }
+      }
+
+      if (Is1GPageSupported && MergePage (L3PageEntry, Page1G)) {
+        IsMerged = TRUE;
+      }
+    }
+
+    if (LastAddress - Address < SIZE_1GB) {
+      break;
+    }
+
+    Address += SIZE_1GB;
+  }
+
+  return IsMerged;
+}
+
 /**
  Check the WP status in CR0 register. This bit is used to lock or unlock write
  access to pages marked as read-only.
@@ -915,25 +1121,137 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES  AllocatePagesFunc OPTIONAL
   )
 {
-  RETURN_STATUS  Status;
-  BOOLEAN        IsModified;
-  BOOLEAN        IsSplitted;
+  PAGE_TABLE_LIB_MEMORY_RANGE  Range;
 
   //  DEBUG((DEBUG_INFO, "AssignMemoryPageAttributes: 0x%lx - 0x%lx (0x%lx)\n", BaseAddress, Length, Attributes));
-  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified);
-  if (!EFI_ERROR (Status)) {
-    if ((PagingContext == NULL) && IsModified) {
-      //
-      // Flush TLB as last step.
-      //
-      // Note: Since APs will always init CR3 register in HLT loop mode or do
-      // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
-      // here.
-      //
-      CpuFlushTlb ();
+  Range.BaseAddress = BaseAddress;
+  Range.Length      = Length;
+  Range.Attributes  = Attributes;
+  return AssignMemoryPageAttributesList (PagingContext, &Range, 1, AllocatePagesFunc);
+}
+
+/**
+  This function assigns the page attributes for a list of memory regions, each
+  from their current attributes to the attributes specified for it.
+
+  Caller should make sure the base address and length of each region is at page
+  boundary.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  If PagingContext is NULL, the page tables split for the regions are merged
+  back into large pages when the attributes allow, and the TLB is flushed once
+  after all regions are assigned. Contiguous regions are merged as one, so
+  each page table is checked only once.
+
+  @param[in]  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param[in]  Ranges            The memory regions and the bit mask of attributes to set for each.
+  @param[in]  RangeCount        The number of memory regions in Ranges.
+  @param[in]  AllocatePagesFunc If page split is needed, this function is used to allocate more pages.
+                                NULL mean page split is unsupported.
+
+  @retval RETURN_SUCCESS           The attributes were assigned for all memory regions.
+  @retval RETURN_ACCESS_DENIED     The attributes for one memory resource range cannot be modified.
+  @retval RETURN_INVALID_PARAMETER The length of one memory region is zero.
+                                   Attributes specified an illegal combination of attributes that
+                                   cannot be set together.
+  @retval RETURN_OUT_OF_RESOURCES  There are not enough system resources to modify the attributes of
+                                   the memory resource ranges.
+  @retval RETURN_UNSUPPORTED       The processor does not support one or more bytes of one memory
+                                   resource range.
+                                   The bit mask of attributes is not support for one memory resource
+                                   range.
+**/
+RETURN_STATUS
+EFIAPI
+AssignMemoryPageAttributesList (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT      *PagingContext OPTIONAL,
+  IN  CONST PAGE_TABLE_LIB_MEMORY_RANGE  *Ranges,
+  IN  UINTN                              RangeCount,
+  IN  PAGE_TABLE_LIB_ALLOCATE_PAGES      AllocatePagesFunc OPTIONAL
+  )
+{
+  PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
+  RETURN_STATUS                  Status;
+  BOOLEAN                        IsModified;
+  BOOLEAN                        IsRangeModified;
+  BOOLEAN                        IsSplitted;
+  BOOLEAN                        IsWpEnabled;
+  PHYSICAL_ADDRESS               CoalesceBase;
+  UINT64                         CoalesceLength;
+  UINTN                          AssignedCount;
+  UINTN                          Index;
+
+  Status     = RETURN_SUCCESS;
+  IsModified = FALSE;
+  for (Index = 0; Index < RangeCount; Index++) {
+    IsRangeModified = FALSE;
+    Status          = ConvertMemoryPageAttributes (
+                        PagingContext,
+                        Ranges[Index].BaseAddress,
+                        Ranges[Index].Length,
+                        Ranges[Index].Attributes,
+                        PageActionAssign,
+                        AllocatePagesFunc,
+                        &IsSplitted,
+                        &IsRangeModified
+                        );
+    if (IsRangeModified) {
+      IsModified = TRUE;
+    }
+
+    if (RETURN_ERROR (Status)) {
+      break;
     }
   }
 
+  AssignedCount = Index;
+
+  if ((PagingContext == NULL) && IsModified) {
+    //
+    // Merge the page tables of the assigned regions back where possible. The
+    // page tables are not checked for the failed region and the ones after it.
+    //
+    GetCurrentPagingContext (&CurrentPagingContext);
+    IsWpEnabled = IsReadOnlyPageWriteProtected ();
+    if (IsWpEnabled) {
+      DisableReadOnlyPageWriteProtect ();
+    }
+
+    CoalesceBase   = 0;
+    CoalesceLength = 0;
+    for (Index = 0; Index < AssignedCount; Index++) {
+      if ((CoalesceLength != 0) && (CoalesceBase + CoalesceLength == Ranges[Index].BaseAddress)) {
+        CoalesceLength += Ranges[Index].Length;
+        continue;
+      }
+
+      if (CoalesceLength != 0) {
+        CoalesceMemoryPages (&CurrentPagingContext, CoalesceBase, CoalesceLength);
+      }
+
+      CoalesceBase   = Ranges[Index].BaseAddress;
+      CoalesceLength = Ranges[Index].Length;
+    }
+
+    if (CoalesceLength != 0) {
+      CoalesceMemoryPages (&CurrentPagingContext, CoalesceBase, CoalesceLength);
+    }
+
+    if (IsWpEnabled) {
+      EnableReadOnlyPageWriteProtect ();
+    }
+
+    //
+    // Flush TLB as last step.
+    //
+    // Note: Since APs will always init CR3 register in HLT loop mode or do
+    // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
+    // here.
+    //
+    CpuFlushTlb ();
+  }
+
   return Status;
 }
 
@@ -1215,6 +1533,15 @@ AllocatePageTableMemory (
     return NULL;
   }
 
+  //
+  // Reuse a page table freed by merging large pages first.
+  //
+  if ((Pages == 1) && (mPageTableFreeList != NULL)) {
+    Buffer             = mPageTableFreeList;
+    mPageTableFreeList = *(VOID **)Buffer;
+    return Buffer;
+  }
+
   //
   // Renew the pool if necessary.
   //
@@ -1234,6 +1561,25 @@ AllocatePageTableMemory (
   return Buffer;
 }
 
+/**
+  This API frees one page of page table for reuse.
+
+  The page may come from AllocatePageTableMemory() or the page tables built
+  before this driver. It is kept for page table use only.
+
+  @param  Buffer                The page to free.
+
+**/
+VOID
+EFIAPI
+FreePageTableMemory (
+  IN VOID  *Buffer
+  )
+{
+  *(VOID **)Buffer   = mPageTableFreeList;
+  mPageTableFreeList = Buffer;
+}
+
 /**
   Special handler for #DB exception, which will restore the page attributes
   (not-present). It should work with #PF handler which will set pages to
@@ -57,6 +57,12 @@ typedef struct {
   UINTN    FreePages;
 } PAGE_TABLE_POOL;
 
+typedef struct {
+  PHYSICAL_ADDRESS    BaseAddress;
+  UINT64              Length;
+  UINT64              Attributes;
+} PAGE_TABLE_LIB_MEMORY_RANGE;
+
 /**
   Allocates one or more 4KB pages for page table.
 
@@ -109,6 +115,46 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES  AllocatePagesFunc OPTIONAL
   );
 
+/**
+  This function assigns the page attributes for a list of memory regions, each
+  from their current attributes to the attributes specified for it.
+
+  Caller should make sure the base address and length of each region is at page
+  boundary.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  If PagingContext is NULL, the page tables split for the regions are merged
+  back into large pages when the attributes allow, and the TLB is flushed once
+  after all regions are assigned.
+
+  @param  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param  Ranges            The memory regions and the bit mask of attributes to set for each.
+  @param  RangeCount        The number of memory regions in Ranges.
+  @param  AllocatePagesFunc If page split is needed, this function is used to allocate more pages.
+                            NULL mean page split is unsupported.
+
+  @retval RETURN_SUCCESS           The attributes were assigned for all memory regions.
+  @retval RETURN_ACCESS_DENIED     The attributes for one memory resource range cannot be modified.
+  @retval RETURN_INVALID_PARAMETER The length of one memory region is zero.
+                                   Attributes specified an illegal combination of attributes that
+                                   cannot be set together.
+  @retval RETURN_OUT_OF_RESOURCES  There are not enough system resources to modify the attributes of
+                                   the memory resource ranges.
+  @retval RETURN_UNSUPPORTED       The processor does not support one or more bytes of one memory
+                                   resource range.
+                                   The bit mask of attributes is not support for one memory resource
+                                   range.
+**/
+RETURN_STATUS
+EFIAPI
+AssignMemoryPageAttributesList (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT      *PagingContext OPTIONAL,
+  IN  CONST PAGE_TABLE_LIB_MEMORY_RANGE  *Ranges,
+  IN  UINTN                              RangeCount,
+  IN  PAGE_TABLE_LIB_ALLOCATE_PAGES      AllocatePagesFunc OPTIONAL
+  );
+
 /**
   Initialize the Page Table lib.
 **/
@@ -138,6 +184,18 @@ AllocatePageTableMemory (
   IN UINTN  Pages
   );
 
+/**
+  This API frees one page of page table for reuse by AllocatePageTableMemory().
+
+  @param  Buffer                The page to free.
+
+**/
+VOID
+EFIAPI
+FreePageTableMemory (
+  IN VOID  *Buffer
+  );
+
 /**
   Get paging details.
 
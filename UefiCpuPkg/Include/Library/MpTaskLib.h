@@ -0,0 +1,121 @@
+/** @file
+  Header file for the MP Task Library.
+
+  The library runs many small independent tasks across all the enabled
+  processors. Every processor works off its own deque of tasks, and steals
+  tasks from the other deques when its own runs empty, so the load stays
+  balanced without the caller dividing up the work.
+
+  Tasks run on the APs: they must not use any boot or PEI service, nor any
+  library that does, like MemoryAllocationLib.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MP_TASK_LIB_H_
+#define MP_TASK_LIB_H_
+
+typedef struct _MP_TASK_QUEUE   MP_TASK_QUEUE;
+typedef struct _MP_TASK_WORKER  MP_TASK_WORKER;
+
+/**
+  The procedure of a task.
+
+  @param[in]  Worker     The worker running the task, to spawn more tasks with
+                         MpTaskSpawn().
+  @param[in]  Context    The context the task was submitted with.
+**/
+typedef
+VOID
+(EFIAPI *MP_TASK_PROCEDURE)(
+  IN MP_TASK_WORKER  *Worker,
+  IN VOID            *Context
+  );
+
+/**
+  Create a task queue, with a worker for each enabled processor.
+
+  @param[in]   Capacity     The number of tasks each worker may hold before
+                            they are run. A task submitted to a full worker
+                            is run right away instead.
+  @param[out]  Queue        The created task queue.
+
+  @retval RETURN_SUCCESS            The queue is created.
+  @retval RETURN_INVALID_PARAMETER  Capacity is 0, or Queue is NULL.
+  @retval RETURN_OUT_OF_RESOURCES   The queue couldn't be allocated.
+**/
+RETURN_STATUS
+EFIAPI
+MpTaskQueueCreate (
+  IN  UINTN          Capacity,
+  OUT MP_TASK_QUEUE  **Queue
+  );
+
+/**
+  Free a task queue.
+
+  @param[in]  Queue      The task queue, which must not be running.
+**/
+VOID
+EFIAPI
+MpTaskQueueFree (
+  IN MP_TASK_QUEUE  *Queue
+  );
+
+/**
+  Submit a task to a task queue, to run on the next MpTaskQueueRun().
+
+  This must be called on the BSP, while the queue is not running. The tasks
+  are spread over the workers in turn.
+
+  @param[in]  Queue      The task queue.
+  @param[in]  Procedure  The procedure of the task.
+  @param[in]  Context    The context passed to Procedure.
+**/
+VOID
+EFIAPI
+MpTaskSubmit (
+  IN MP_TASK_QUEUE      *Queue,
+  IN MP_TASK_PROCEDURE  Procedure,
+  IN VOID               *Context
+  );
+
+/**
+  Spawn a task from a running task.
+
+  The task is pushed to the deque of the worker, to be run by it or stolen
+  by another one. MpTaskQueueRun() doesn't return before it is done.
+
+  @param[in]  Worker     The worker running the current task.
+  @param[in]  Procedure  The procedure of the task.
+  @param[in]  Context    The context passed to Procedure.
+**/
+VOID
+EFIAPI
+MpTaskSpawn (
+  IN MP_TASK_WORKER     *Worker,
+  IN MP_TASK_PROCEDURE  Procedure,
+  IN VOID               *Context
+  );
+
+/**
+  Run all the tasks of a task queue, on the BSP and all the enabled APs.
+
+  The function returns when all the submitted and spawned tasks are done.
+  The tasks run on the BSP alone if the APs can't be started.
+
+  In DXE, this must be called below TPL_NOTIFY.
+
+  @param[in]  Queue      The task queue.
+
+  @retval RETURN_SUCCESS            All the tasks are done.
+  @retval RETURN_INVALID_PARAMETER  Queue is NULL.
+**/
+RETURN_STATUS
+EFIAPI
+MpTaskQueueRun (
+  IN MP_TASK_QUEUE  *Queue
+  );
+
+#endif
@@ -0,0 +1,69 @@
+/** @file
+  MTRR Transaction Protocol is related to EDK II-specific implementation of the
+  CPU driver and intended for use as a means to change the cache attributes of
+  many memory regions with the MTRRs reprogrammed only once on every processor.
+
+  Between Begin() and Commit(), the cache attributes set with the
+  SetMemoryAttributes() service of the CPU Architecture Protocol, or with the
+  GCD SetMemorySpaceAttributes() service, are checked and accumulated in a copy
+  of the MTRR settings. They only take effect when the transaction is committed.
+  The paging attributes still take effect immediately.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_MTRR_TRANSACTION_H_
+#define EDKII_MTRR_TRANSACTION_H_
+
+#define EDKII_MTRR_TRANSACTION_PROTOCOL_GUID \
+  { \
+    0x81fce9ae, 0x574c, 0x42d2, { 0xa9, 0x22, 0xe5, 0x46, 0x76, 0x61, 0x8d, 0x58 } \
+  }
+
+typedef struct _EDKII_MTRR_TRANSACTION_PROTOCOL EDKII_MTRR_TRANSACTION_PROTOCOL;
+
+/**
+  Begin an MTRR transaction.
+
+  @param[in]  This              The EDKII_MTRR_TRANSACTION_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The transaction is begun.
+  @retval EFI_ALREADY_STARTED   A transaction is in progress already.
+  @retval EFI_UNSUPPORTED       The processor does not support MTRRs.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MTRR_TRANSACTION_BEGIN)(
+  IN EDKII_MTRR_TRANSACTION_PROTOCOL  *This
+  );
+
+/**
+  Commit the MTRR transaction in progress.
+
+  The MTRR settings accumulated since Begin() are programmed on all processors,
+  if they differ from the current ones.
+
+  @param[in]  This              The EDKII_MTRR_TRANSACTION_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The transaction is committed.
+  @retval EFI_NOT_STARTED       No transaction is in progress.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MTRR_TRANSACTION_COMMIT)(
+  IN EDKII_MTRR_TRANSACTION_PROTOCOL  *This
+  );
+
+///
+/// MTRR Transaction Protocol defers the MTRR programming of several cache
+/// attribute changes to a single pass on all processors.
+///
+struct _EDKII_MTRR_TRANSACTION_PROTOCOL {
+  EDKII_MTRR_TRANSACTION_BEGIN     Begin;
+  EDKII_MTRR_TRANSACTION_COMMIT    Commit;
+};
+
+extern EFI_GUID  gEdkiiMtrrTransactionProtocolGuid;
+
+#endif
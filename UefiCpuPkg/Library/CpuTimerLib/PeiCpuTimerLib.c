@@ -0,0 +1,62 @@
+/** @file
+  CPUID Leaf 0x15 for Core Crystal Clock frequency instance as PEI Timer Library.
+
+  The frequency is calculated once and saved in a GUIDed HOB, which the later
+  PEIMs and the DXE instance of this library read back.
+
+  Copyright (c) 2019 Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/TimerLib.h>
+#include <Library/BaseLib.h>
+#include <Library/HobLib.h>
+#include <Library/DebugLib.h>
+
+extern GUID  mCpuCrystalFrequencyHobGuid;
+
+/**
+  CPUID Leaf 0x15 for Core Crystal Clock Frequency.
+
+  The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
+  In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
+  @return The number of TSC counts per second.
+
+**/
+UINT64
+CpuidCoreClockCalculateTscFrequency (
+  VOID
+  );
+
+/**
+  Internal function to retrieves the 64-bit frequency in Hz.
+
+  Internal function to retrieves the 64-bit frequency in Hz.
+
+  @return The frequency in Hz.
+
+**/
+UINT64
+InternalGetPerformanceCounterFrequency (
+  VOID
+  )
+{
+  UINT64             *CpuCrystalCounterFrequency;
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  GuidHob = GetFirstGuidHob (&mCpuCrystalFrequencyHobGuid);
+  if (GuidHob != NULL) {
+    return *(UINT64 *)GET_GUID_HOB_DATA (GuidHob);
+  }
+
+  CpuCrystalCounterFrequency = (UINT64 *)BuildGuidHob (&mCpuCrystalFrequencyHobGuid, sizeof (*CpuCrystalCounterFrequency));
+  if (CpuCrystalCounterFrequency == NULL) {
+    ASSERT (CpuCrystalCounterFrequency != NULL);
+    return CpuidCoreClockCalculateTscFrequency ();
+  }
+
+  *CpuCrystalCounterFrequency = CpuidCoreClockCalculateTscFrequency ();
+  return *CpuCrystalCounterFrequency;
+}
@@ -65,6 +65,9 @@ MicrocodeDetect (
 
   //
   // BSP or AP which is different from BSP runs here
+  // The region scanned below only holds the patches shadowed for the processor IDs found on
+  // this platform, and APs run this routine in parallel with one thread per core, so a scan
+  // is short and is not worth sharing between APs through CpuMpData.
   // Use 0 as the starting revision to search for microcode because MicrocodePatchInfo HOB needs
   // the latest microcode location even it's loaded to the processor.
   //
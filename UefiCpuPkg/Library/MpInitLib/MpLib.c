@@ -437,6 +437,12 @@ ApInitializeSync (
 /**
   Find the current Processor number by APIC ID.
 
+  Every AP looks up its number each time it is woken up, so with hundreds of
+  processors a linear search costs each AP hundreds of cache misses on the
+  shared CPU_INFO_IN_HOB array. SortApicId() sorts the array by APIC ID, so
+  it is binary searched first. The linear search remains for the lookups
+  before the array is sorted, or after an APIC ID changed.
+
   @param[in]  CpuMpData         Pointer to PEI CPU MP Data
   @param[out] ProcessorNumber   Return the pocessor number found
 
@@ -451,6 +457,8 @@ GetProcessorNumber (
 {
   UINTN            TotalProcessorNumber;
   UINTN            Index;
+  UINTN            Low;
+  UINTN            High;
   CPU_INFO_IN_HOB  *CpuInfoInHob;
   UINT32           CurrentApicId;
 
@@ -458,6 +466,23 @@ GetProcessorNumber (
 
   TotalProcessorNumber = CpuMpData->CpuCount;
   CurrentApicId        = GetApicId ();
+
+  Low  = 0;
+  High = TotalProcessorNumber;
+  while (Low < High) {
+    Index = (Low + High) / 2;
+    if (CpuInfoInHob[Index].ApicId == CurrentApicId) {
+      *ProcessorNumber = Index;
+      return EFI_SUCCESS;
+    }
+
+    if (CpuInfoInHob[Index].ApicId < CurrentApicId) {
+      Low = Index + 1;
+    } else {
+      High = Index;
+    }
+  }
+
   for (Index = 0; Index < TotalProcessorNumber; Index++) {
     if (CpuInfoInHob[Index].ApicId == CurrentApicId) {
       *ProcessorNumber = Index;
@@ -603,6 +628,82 @@ InitializeApData (
   SetApState (&CpuMpData->CpuData[ProcessorNumber], CpuStateIdle);
 }
 
+/**
+  Record the latency from the BSP signaling this AP to the AP function about
+  to start.
+
+  The BSP and the APs are assumed to share an invariant, synchronized TSC. A
+  sample taken on a TSC behind the BSP's is dropped.
+
+  @param[in, out] CpuData       Pointer to the CPU_AP_DATA of this AP
+
+**/
+VOID
+ApRecordWakeupLatency (
+  IN OUT CPU_AP_DATA  *CpuData
+  )
+{
+  UINT64  WakeupTsc;
+  UINT64  Tsc;
+  UINT64  Latency;
+
+  WakeupTsc = CpuData->WakeupTsc;
+  if (WakeupTsc == 0) {
+    return;
+  }
+
+  CpuData->WakeupTsc = 0;
+  Tsc                = AsmReadTsc ();
+  if (Tsc < WakeupTsc) {
+    return;
+  }
+
+  Latency                      = Tsc - WakeupTsc;
+  CpuData->WakeupCount        += 1;
+  CpuData->WakeupLatencyTotal += Latency;
+  if (Latency > CpuData->WakeupLatencyMax) {
+    CpuData->WakeupLatencyMax = Latency;
+  }
+}
+
+/**
+  Report the AP dispatch latency measured with PcdCpuApWakeupLatencyTrace.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+
+**/
+VOID
+DumpApWakeupLatency (
+  IN CPU_MP_DATA  *CpuMpData
+  )
+{
+  CPU_AP_DATA      *CpuData;
+  CPU_INFO_IN_HOB  *CpuInfoInHob;
+  UINTN            Index;
+
+  if (!FeaturePcdGet (PcdCpuApWakeupLatencyTrace)) {
+    return;
+  }
+
+  CpuInfoInHob = (CPU_INFO_IN_HOB *)(UINTN)CpuMpData->CpuInfoInHob;
+  DEBUG ((DEBUG_INFO, "AP dispatch latency in TSC ticks:\n"));
+  for (Index = 0; Index < CpuMpData->CpuCount; Index++) {
+    CpuData = &CpuMpData->CpuData[Index];
+    if ((Index == CpuMpData->BspNumber) || (CpuData->WakeupCount == 0)) {
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  APIC ID 0x%x: %ld dispatches, average %ld, max %ld\n",
+      CpuInfoInHob[Index].ApicId,
+      CpuData->WakeupCount,
+      DivU64x64Remainder (CpuData->WakeupLatencyTotal, CpuData->WakeupCount, NULL),
+      CpuData->WakeupLatencyMax
+      ));
+  }
+}
+
 /**
   This function will be called from AP reset code if BSP uses WakeUpAP.
 
@@ -709,6 +810,10 @@ ApWakeupFunction (
           // Enable source debugging on AP function
           //
           EnableDebugAgent ();
+          if (FeaturePcdGet (PcdCpuApWakeupLatencyTrace)) {
+            ApRecordWakeupLatency (&CpuMpData->CpuData[ProcessorNumber]);
+          }
+
           //
           // Invoke AP function here
           //
@@ -1194,6 +1299,10 @@ WakeUpAP (
         CpuData->ApFunctionArgument = (UINTN)ProcedureArgument;
         SetApState (CpuData, CpuStateReady);
         if (CpuMpData->InitFlag != ApInitConfig) {
+          if (FeaturePcdGet (PcdCpuApWakeupLatencyTrace)) {
+            CpuData->WakeupTsc = AsmReadTsc ();
+          }
+
           *(UINT32 *)CpuData->StartupApSignal = WAKEUP_AP_SIGNAL;
         }
       }
@@ -1304,6 +1413,10 @@ WakeUpAP (
     // Wakeup specified AP
     //
     ASSERT (CpuMpData->InitFlag != ApInitConfig);
+    if (FeaturePcdGet (PcdCpuApWakeupLatencyTrace)) {
+      CpuData->WakeupTsc = AsmReadTsc ();
+    }
+
     *(UINT32 *)CpuData->StartupApSignal = WAKEUP_AP_SIGNAL;
     if (ResetVectorRequired) {
       CpuInfoInHob = (CPU_INFO_IN_HOB *)(UINTN)CpuMpData->CpuInfoInHob;
@@ -1947,6 +2060,7 @@ MpInitLibInitialize (
     // APs have been wakeup before, just get the CPU Information
     // from HOB
     //
+    DumpApWakeupLatency (OldCpuMpData);
     OldCpuMpData->NewCpuMpData = CpuMpData;
     CpuMpData->CpuCount        = OldCpuMpData->CpuCount;
     CpuMpData->BspNumber       = OldCpuMpData->BspNumber;
@@ -152,6 +152,14 @@ typedef struct {
   UINT64                    MicrocodeEntryAddr;
   UINT32                    MicrocodeRevision;
   SEV_ES_SAVE_AREA          *SevEsSaveArea;
+  //
+  // AP dispatch latency in TSC ticks, when PcdCpuApWakeupLatencyTrace is TRUE.
+  // WakeupTsc is the TSC when the BSP last signaled the AP, 0 once consumed.
+  //
+  volatile UINT64           WakeupTsc;
+  UINT64                    WakeupCount;
+  UINT64                    WakeupLatencyTotal;
+  UINT64                    WakeupLatencyMax;
 } CPU_AP_DATA;
 
 //
@@ -734,6 +742,17 @@ GetProcessorNumber (
   OUT UINTN       *ProcessorNumber
   );
 
+/**
+  Report the AP dispatch latency measured with PcdCpuApWakeupLatencyTrace.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+
+**/
+VOID
+DumpApWakeupLatency (
+  IN CPU_MP_DATA  *CpuMpData
+  );
+
 /**
   This funtion will try to invoke platform specific microcode shadow logic to
   relocate microcode update patches into memory.
@@ -0,0 +1,78 @@
+/** @file
+  Internal header file for the MP Task Library.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef INTERNAL_MP_TASK_LIB_H_
+#define INTERNAL_MP_TASK_LIB_H_
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/MpTaskLib.h>
+
+typedef struct {
+  MP_TASK_PROCEDURE    Procedure;
+  VOID                 *Context;
+} MP_TASK;
+
+//
+// The deque of tasks of a worker, a ring of Capacity tasks. The worker pushes
+// and pops tasks at the bottom, so it runs the task it spawned last, which
+// works on data still in its caches. The other workers steal at the top, the
+// oldest tasks, which tend to be the largest ones.
+//
+struct _MP_TASK_WORKER {
+  SPIN_LOCK        Lock;
+  MP_TASK          *Tasks;
+  volatile UINTN   Top;
+  volatile UINTN   Bottom;
+  UINT32           Seed;
+  MP_TASK_QUEUE    *Queue;
+};
+
+struct _MP_TASK_QUEUE {
+  UINTN                Capacity;
+  UINTN                WorkerCount;
+  MP_TASK_WORKER       *Workers;
+  UINTN                NextWorker;
+  //
+  // The number of tasks submitted or spawned, and not done yet.
+  //
+  volatile UINT32      Pending;
+  //
+  // The number of processors that joined the current run.
+  //
+  volatile UINT32      Started;
+};
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+MpTaskGetProcessorCount (
+  VOID
+  );
+
+/**
+  Run a procedure on the BSP and all the enabled APs, and wait for them.
+
+  If the APs can't be started, the procedure runs on the BSP alone.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+MpTaskStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  );
+
+#endif
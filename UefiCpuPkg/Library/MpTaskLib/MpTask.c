@@ -0,0 +1,375 @@
+/** @file
+  MP Task Library common functions: the task deques and the worker loop.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalMpTaskLib.h"
+
+/**
+  Create a task queue, with a worker for each enabled processor.
+
+  @param[in]   Capacity     The number of tasks each worker may hold before
+                            they are run. A task submitted to a full worker
+                            is run right away instead.
+  @param[out]  Queue        The created task queue.
+
+  @retval RETURN_SUCCESS            The queue is created.
+  @retval RETURN_INVALID_PARAMETER  Capacity is 0, or Queue is NULL.
+  @retval RETURN_OUT_OF_RESOURCES   The queue couldn't be allocated.
+**/
+RETURN_STATUS
+EFIAPI
+MpTaskQueueCreate (
+  IN  UINTN          Capacity,
+  OUT MP_TASK_QUEUE  **Queue
+  )
+{
+  MP_TASK_QUEUE   *NewQueue;
+  MP_TASK_WORKER  *Worker;
+  MP_TASK         *Tasks;
+  UINTN           Index;
+
+  if ((Capacity == 0) || (Queue == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  NewQueue = AllocateZeroPool (sizeof (MP_TASK_QUEUE));
+  if (NewQueue == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  NewQueue->Capacity    = Capacity;
+  NewQueue->WorkerCount = MpTaskGetProcessorCount ();
+  NewQueue->Workers     = AllocateZeroPool (NewQueue->WorkerCount * sizeof (MP_TASK_WORKER));
+  Tasks                 = AllocatePool (NewQueue->WorkerCount * Capacity * sizeof (MP_TASK));
+  if ((NewQueue->Workers == NULL) || (Tasks == NULL)) {
+    if (NewQueue->Workers != NULL) {
+      FreePool (NewQueue->Workers);
+    }
+
+    if (Tasks != NULL) {
+      FreePool (Tasks);
+    }
+
+    FreePool (NewQueue);
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < NewQueue->WorkerCount; Index++) {
+    Worker        = &NewQueue->Workers[Index];
+    Worker->Tasks = &Tasks[Index * Capacity];
+    Worker->Seed  = (UINT32)Index + 1;
+    Worker->Queue = NewQueue;
+    InitializeSpinLock (&Worker->Lock);
+  }
+
+  *Queue = NewQueue;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Free a task queue.
+
+  @param[in]  Queue      The task queue, which must not be running.
+**/
+VOID
+EFIAPI
+MpTaskQueueFree (
+  IN MP_TASK_QUEUE  *Queue
+  )
+{
+  if (Queue == NULL) {
+    return;
+  }
+
+  ASSERT (Queue->Pending == 0);
+
+  FreePool (Queue->Workers[0].Tasks);
+  FreePool (Queue->Workers);
+  FreePool (Queue);
+}
+
+/**
+  Push a task to the bottom of the deque of a worker.
+
+  @param[in]  Worker     The worker.
+  @param[in]  Procedure  The procedure of the task.
+  @param[in]  Context    The context passed to Procedure.
+
+  @retval TRUE   The task is pushed, and counted as pending.
+  @retval FALSE  The deque is full.
+**/
+STATIC
+BOOLEAN
+MpTaskPush (
+  IN MP_TASK_WORKER     *Worker,
+  IN MP_TASK_PROCEDURE  Procedure,
+  IN VOID               *Context
+  )
+{
+  MP_TASK  *Task;
+  BOOLEAN  Pushed;
+
+  Pushed = FALSE;
+
+  AcquireSpinLock (&Worker->Lock);
+  if (Worker->Bottom - Worker->Top < Worker->Queue->Capacity) {
+    //
+    // Count the task before any worker can take it.
+    //
+    InterlockedIncrement (&Worker->Queue->Pending);
+
+    Task            = &Worker->Tasks[Worker->Bottom % Worker->Queue->Capacity];
+    Task->Procedure = Procedure;
+    Task->Context   = Context;
+    Worker->Bottom++;
+    Pushed = TRUE;
+  }
+
+  ReleaseSpinLock (&Worker->Lock);
+
+  return Pushed;
+}
+
+/**
+  Take a task from the deque of a worker.
+
+  @param[in]   Worker     The worker.
+  @param[in]   Steal      TRUE to take the oldest task, as a thief does, FALSE
+                          to take the newest one, as the owner does.
+  @param[out]  Task       The task taken.
+
+  @retval TRUE   A task is taken.
+  @retval FALSE  The deque is empty.
+**/
+STATIC
+BOOLEAN
+MpTaskTake (
+  IN  MP_TASK_WORKER  *Worker,
+  IN  BOOLEAN         Steal,
+  OUT MP_TASK         *Task
+  )
+{
+  BOOLEAN  Taken;
+
+  //
+  // Don't take the lock of an empty deque: the idle workers keep looking
+  // at all the deques.
+  //
+  if (Worker->Bottom == Worker->Top) {
+    return FALSE;
+  }
+
+  Taken = FALSE;
+
+  AcquireSpinLock (&Worker->Lock);
+  if (Worker->Bottom != Worker->Top) {
+    if (Steal) {
+      *Task = Worker->Tasks[Worker->Top % Worker->Queue->Capacity];
+      Worker->Top++;
+    } else {
+      Worker->Bottom--;
+      *Task = Worker->Tasks[Worker->Bottom % Worker->Queue->Capacity];
+    }
+
+    Taken = TRUE;
+  }
+
+  ReleaseSpinLock (&Worker->Lock);
+
+  return Taken;
+}
+
+/**
+  Submit a task to a task queue, to run on the next MpTaskQueueRun().
+
+  This must be called on the BSP, while the queue is not running. The tasks
+  are spread over the workers in turn.
+
+  @param[in]  Queue      The task queue.
+  @param[in]  Procedure  The procedure of the task.
+  @param[in]  Context    The context passed to Procedure.
+**/
+VOID
+EFIAPI
+MpTaskSubmit (
+  IN MP_TASK_QUEUE      *Queue,
+  IN MP_TASK_PROCEDURE  Procedure,
+  IN VOID               *Context
+  )
+{
+  MP_TASK_WORKER  *Worker;
+
+  ASSERT (Queue != NULL);
+  ASSERT (Procedure != NULL);
+
+  Worker            = &Queue->Workers[Queue->NextWorker];
+  Queue->NextWorker = (Queue->NextWorker + 1) % Queue->WorkerCount;
+
+  if (!MpTaskPush (Worker, Procedure, Context)) {
+    Procedure (Worker, Context);
+  }
+}
+
+/**
+  Spawn a task from a running task.
+
+  The task is pushed to the deque of the worker, to be run by it or stolen
+  by another one. MpTaskQueueRun() doesn't return before it is done.
+
+  @param[in]  Worker     The worker running the current task.
+  @param[in]  Procedure  The procedure of the task.
+  @param[in]  Context    The context passed to Procedure.
+**/
+VOID
+EFIAPI
+MpTaskSpawn (
+  IN MP_TASK_WORKER     *Worker,
+  IN MP_TASK_PROCEDURE  Procedure,
+  IN VOID               *Context
+  )
+{
+  ASSERT (Worker != NULL);
+  ASSERT (Procedure != NULL);
+
+  //
+  // The current task is still pending, so the queue can't be seen idle
+  // before the new one is counted.
+  //
+  if (!MpTaskPush (Worker, Procedure, Context)) {
+    Procedure (Worker, Context);
+  }
+}
+
+/**
+  Steal a task from the other workers.
+
+  The search starts at a pseudo random worker, so that the thieves don't all
+  hit the same deque.
+
+  @param[in]   Worker     The worker looking for a task.
+  @param[out]  Task       The task stolen.
+
+  @retval TRUE   A task is stolen.
+  @retval FALSE  All the other deques are empty.
+**/
+STATIC
+BOOLEAN
+MpTaskSteal (
+  IN  MP_TASK_WORKER  *Worker,
+  OUT MP_TASK         *Task
+  )
+{
+  MP_TASK_QUEUE  *Queue;
+  UINTN          Victim;
+  UINTN          Index;
+
+  Queue = Worker->Queue;
+
+  //
+  // xorshift32
+  //
+  Worker->Seed ^= Worker->Seed << 13;
+  Worker->Seed ^= Worker->Seed >> 17;
+  Worker->Seed ^= Worker->Seed << 5;
+
+  Victim = Worker->Seed % Queue->WorkerCount;
+  for (Index = 0; Index < Queue->WorkerCount; Index++) {
+    if ((&Queue->Workers[Victim] != Worker) &&
+        MpTaskTake (&Queue->Workers[Victim], TRUE, Task))
+    {
+      return TRUE;
+    }
+
+    Victim = (Victim + 1) % Queue->WorkerCount;
+  }
+
+  return FALSE;
+}
+
+/**
+  The worker loop, run on every processor: run the tasks of the own deque,
+  steal from the others when it is empty, and return when no task is left.
+
+  @param[in]  Buffer    The task queue.
+**/
+STATIC
+VOID
+EFIAPI
+MpTaskWorkerLoop (
+  IN VOID  *Buffer
+  )
+{
+  MP_TASK_QUEUE   *Queue;
+  MP_TASK_WORKER  *Worker;
+  MP_TASK         Task;
+  UINT32          Index;
+
+  Queue = (MP_TASK_QUEUE *)Buffer;
+
+  //
+  // The processors take the workers in the order they join.
+  //
+  Index = InterlockedIncrement (&Queue->Started) - 1;
+  if (Index >= Queue->WorkerCount) {
+    return;
+  }
+
+  Worker = &Queue->Workers[Index];
+
+  while (TRUE) {
+    if (MpTaskTake (Worker, FALSE, &Task) || MpTaskSteal (Worker, &Task)) {
+      Task.Procedure (Worker, Task.Context);
+      InterlockedDecrement (&Queue->Pending);
+      continue;
+    }
+
+    if (Queue->Pending == 0) {
+      break;
+    }
+
+    CpuPause ();
+  }
+}
+
+/**
+  Run all the tasks of a task queue, on the BSP and all the enabled APs.
+
+  The function returns when all the submitted and spawned tasks are done.
+  The tasks run on the BSP alone if the APs can't be started.
+
+  In DXE, this must be called below TPL_NOTIFY.
+
+  @param[in]  Queue      The task queue.
+
+  @retval RETURN_SUCCESS            All the tasks are done.
+  @retval RETURN_INVALID_PARAMETER  Queue is NULL.
+**/
+RETURN_STATUS
+EFIAPI
+MpTaskQueueRun (
+  IN MP_TASK_QUEUE  *Queue
+  )
+{
+  if (Queue == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Queue->Pending == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  Queue->Started = 0;
+  if (Queue->WorkerCount > 1) {
+    MpTaskStartupAllCpus (MpTaskWorkerLoop, Queue);
+  } else {
+    MpTaskWorkerLoop (Queue);
+  }
+
+  ASSERT (Queue->Pending == 0);
+  Queue->NextWorker = 0;
+
+  return RETURN_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/** @file
+  MP Task Library functions for PEI, over EDKII_PEI_MP_SERVICES2_PPI.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Ppi/MpServices2.h>
+#include <Library/PeiServicesLib.h>
+
+#include "InternalMpTaskLib.h"
+
+/**
+  Get the number of enabled processors.
+
+  @return  The number of enabled processors, 1 if the MP services are not
+           available.
+**/
+UINTN
+MpTaskGetProcessorCount (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices;
+  UINTN                       NumberOfProcessors;
+  UINTN                       NumberOfEnabledProcessors;
+
+  Status = PeiServicesLocatePpi (&gEdkiiPeiMpServices2PpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  return NumberOfEnabledProcessors;
+}
+
+/**
+  Run a procedure on the BSP and all the enabled APs, and wait for them.
+
+  @param[in]  Procedure   The procedure to run.
+  @param[in]  Argument    The argument passed to Procedure.
+**/
+VOID
+MpTaskStartupAllCpus (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices;
+
+  Status = PeiServicesLocatePpi (&gEdkiiPeiMpServices2PpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->StartupAllCPUs (MpServices, Procedure, 0, Argument);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: APs not started - %r\n", __FUNCTION__, Status));
+    Procedure (Argument);
+  }
+}
@@ -770,6 +770,8 @@ AnalysisProcessorFeatures (
         //
         // Get the biggest dependence and add semaphore for it.
         // PackageDepType > CoreDepType > ThreadDepType > NoneDepType.
+        // Thread scope needs no semaphore, processors run through such
+        // features without waiting for each other.
         //
         BeforeDep = BiggestDep (BeforeDep, AfterDep, NoneNeibBeforeDep, NoneNeibAfterDep);
         if (BeforeDep > ThreadDepType) {
@@ -21,6 +21,8 @@ SMM_CPU_SEMAPHORES           mSmmCpuSemaphores;
 UINTN                        mSemaphoreSize;
 SPIN_LOCK                    *mPFLock = NULL;
 SMM_CPU_SYNC_MODE            mCpuSmmSyncMode;
+UINTN                        mSmmCpuSyncGroupSize;
+SMI_RENDEZVOUS_HISTOGRAM     *mSmiRendezvousHistogram = NULL;
 BOOLEAN                      mMachineCheckSupported = FALSE;
 MM_COMPLETION                mSmmStartupThisApToken;
 
@@ -121,6 +123,9 @@ LockdownSemaphore (
 /**
   Wait all APs to performs an atomic compare exchange operation to release semaphore.
 
+  With PcdCpuSmmSyncGroupSize, the APs check in with the counter of their group
+  instead of the BSP's semaphore, and the BSP collects the counters.
+
   @param   NumberOfAPs      AP number
 
 **/
@@ -129,11 +134,59 @@ WaitForAllAPs (
   IN      UINTN  NumberOfAPs
   )
 {
-  UINTN  BspIndex;
+  UINTN            BspIndex;
+  UINTN            Index;
+  volatile UINT32  *Arrival;
+  UINT32           Value;
 
-  BspIndex = mSmmMpSyncData->BspIndex;
-  while (NumberOfAPs-- > 0) {
-    WaitForSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  if (mSmmCpuSyncGroupSize == 0) {
+    BspIndex = mSmmMpSyncData->BspIndex;
+    while (NumberOfAPs-- > 0) {
+      WaitForSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    }
+
+    return;
+  }
+
+  while (NumberOfAPs > 0) {
+    for (Index = 0; Index < mMaxNumberOfCpus; Index += mSmmCpuSyncGroupSize) {
+      Arrival = mSmmMpSyncData->CpuData[Index].Arrival;
+      if (*Arrival == 0) {
+        continue;
+      }
+
+      //
+      // Take all the check-ins of the group at once
+      //
+      do {
+        Value = *Arrival;
+      } while (InterlockedCompareExchange32 ((UINT32 *)Arrival, Value, 0) != Value);
+
+      ASSERT (Value <= NumberOfAPs);
+      NumberOfAPs -= Value;
+    }
+
+    CpuPause ();
+  }
+}
+
+/**
+  Notify BSP of the arrival of an AP.
+
+  @param   CpuIndex      The AP index which calls this function.
+  @param   BspIndex      The BSP index.
+
+**/
+VOID
+SignalBsp (
+  IN UINTN  CpuIndex,
+  IN UINTN  BspIndex
+  )
+{
+  if (mSmmCpuSyncGroupSize == 0) {
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  } else {
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex - CpuIndex % mSmmCpuSyncGroupSize].Arrival);
   }
 }
 
@@ -141,6 +194,10 @@ WaitForAllAPs (
   Performs an atomic compare exchange operation to release semaphore
   for each AP.
 
+  With PcdCpuSmmSyncGroupSize, once all APs are in sync, only the first
+  present AP of each group is released, and releases the rest of its group
+  in WaitForBsp (). Before that the present APs may still change.
+
 **/
 VOID
 ReleaseAllAPs (
@@ -148,10 +205,55 @@ ReleaseAllAPs (
   )
 {
   UINTN  Index;
+  UINTN  GroupEnd;
 
-  for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
-    if (IsPresentAp (Index)) {
-      ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+  if ((mSmmCpuSyncGroupSize == 0) || !*mSmmMpSyncData->AllCpusInSync) {
+    for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
+      if (IsPresentAp (Index)) {
+        ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+      }
+    }
+
+    return;
+  }
+
+  for (Index = 0; Index < mMaxNumberOfCpus; Index = GroupEnd) {
+    GroupEnd = MIN (Index + mSmmCpuSyncGroupSize, mMaxNumberOfCpus);
+    for ( ; Index < GroupEnd; Index++) {
+      if (IsPresentAp (Index)) {
+        *(mSmmMpSyncData->CpuData[Index].ReleaseGroup) = TRUE;
+        ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+        break;
+      }
+    }
+  }
+}
+
+/**
+  Wait for the signal from BSP, and release the rest of the group of this AP
+  if BSP asks so.
+
+  @param   CpuIndex      The AP index which calls this function.
+
+**/
+VOID
+WaitForBsp (
+  IN UINTN  CpuIndex
+  )
+{
+  UINTN  Index;
+  UINTN  GroupEnd;
+
+  WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+
+  if (*(mSmmMpSyncData->CpuData[CpuIndex].ReleaseGroup)) {
+    *(mSmmMpSyncData->CpuData[CpuIndex].ReleaseGroup) = FALSE;
+
+    GroupEnd = MIN (CpuIndex - CpuIndex % mSmmCpuSyncGroupSize + mSmmCpuSyncGroupSize, mMaxNumberOfCpus);
+    for (Index = CpuIndex + 1; Index < GroupEnd; Index++) {
+      if (IsPresentAp (Index)) {
+        ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+      }
     }
   }
 }
@@ -462,6 +564,63 @@ ResetTokens (
   gSmmCpuPrivate->FirstFreeToken = GetFirstNode (&gSmmCpuPrivate->TokenList);
 }
 
+/**
+  Count a time in a SMI rendezvous histogram.
+
+  @param     Buckets          The buckets of the histogram.
+  @param     Max              The maximum time in the histogram.
+  @param     Ticks            The time in performance counter ticks.
+
+**/
+VOID
+CountSmiRendezvousTime (
+  IN OUT UINT64  *Buckets,
+  IN OUT UINT64  *Max,
+  IN     UINT64  Ticks
+  )
+{
+  UINT64  Time;
+  UINTN   Bucket;
+
+  Time = DivU64x32 (GetTimeInNanoSecond (Ticks), 1000);
+  if (Time > *Max) {
+    *Max = Time;
+  }
+
+  Bucket = 0;
+  if (Time != 0) {
+    Bucket = MIN ((UINTN)HighBitSet64 (Time) + 1, SMI_RENDEZVOUS_HISTOGRAM_BUCKET_COUNT - 1);
+  }
+
+  Buckets[Bucket]++;
+}
+
+/**
+  Record the time of an SMI in the SMI rendezvous histogram.
+
+  @param     SmiTime          The time of the SMI on BSP in performance counter ticks.
+  @param     SmmCoreTime      The time in the SMM Foundation entry point in performance counter ticks.
+
+**/
+VOID
+RecordSmiRendezvousTime (
+  IN UINT64  SmiTime,
+  IN UINT64  SmmCoreTime
+  )
+{
+  mSmiRendezvousHistogram->SmiCount++;
+  CountSmiRendezvousTime (
+    mSmiRendezvousHistogram->RendezvousTime,
+    &mSmiRendezvousHistogram->MaxRendezvousTime,
+    SmiTime - MIN (SmmCoreTime, SmiTime)
+    );
+  CountSmiRendezvousTime (
+    mSmiRendezvousHistogram->TotalTime,
+    &mSmiRendezvousHistogram->MaxTotalTime,
+    SmiTime
+    );
+}
+
 /**
   SMI handler for BSP.
 
@@ -480,9 +639,16 @@ BSPHandler (
   UINTN          ApCount;
   BOOLEAN        ClearTopLevelSmiResult;
   UINTN          PresentCount;
+  UINT64         SmiStartTime;
+  UINT64         SmmCoreTime;
 
   ASSERT (CpuIndex == mSmmMpSyncData->BspIndex);
-  ApCount = 0;
+  ApCount      = 0;
+  SmiStartTime = 0;
+  SmmCoreTime  = 0;
+  if (mSmiRendezvousHistogram != NULL) {
+    SmiStartTime = StartSyncTimer ();
+  }
 
   //
   // Flag BSP's presence
@@ -585,8 +751,16 @@ BSPHandler (
   //
   // Invoke SMM Foundation EntryPoint with the processor information context.
   //
+  if (mSmiRendezvousHistogram != NULL) {
+    SmmCoreTime = StartSyncTimer ();
+  }
+
   gSmmCpuPrivate->SmmCoreEntry (&gSmmCpuPrivate->SmmCoreEntryContext);
 
+  if (mSmiRendezvousHistogram != NULL) {
+    SmmCoreTime = GetSyncTimerElapsed (SmmCoreTime);
+  }
+
   //
   // Make sure all APs have completed their pending none-block tasks
   //
@@ -681,6 +855,10 @@ BSPHandler (
   //
   WaitForAllAPs (ApCount);
 
+  if (mSmiRendezvousHistogram != NULL) {
+    RecordSmiRendezvousTime (GetSyncTimerElapsed (SmiStartTime), SmmCoreTime);
+  }
+
   //
   // Reset the tokens buffer.
   //
@@ -789,14 +967,14 @@ APHandler (
     //
     // Notify BSP of arrival at this point
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    SignalBsp (CpuIndex, BspIndex);
   }
 
   if (SmmCpuFeaturesNeedConfigureMtrrs ()) {
     //
     // Wait for the signal from BSP to backup MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Backup OS MTRRs
@@ -806,12 +984,12 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    SignalBsp (CpuIndex, BspIndex);
 
     //
     // Wait for BSP's signal to program MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Replace OS MTRRs with SMI MTRRs
@@ -821,14 +999,14 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    SignalBsp (CpuIndex, BspIndex);
   }
 
   while (TRUE) {
     //
     // Wait for something to happen
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Check if BSP wants to exit SMM
@@ -868,12 +1046,12 @@ APHandler (
     //
     // Notify BSP the readiness of this AP to program MTRRs
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    SignalBsp (CpuIndex, BspIndex);
 
     //
     // Wait for the signal from BSP to program MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Restore OS MTRRs
@@ -885,12 +1063,12 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to Reset states/semaphore for this processor
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  SignalBsp (CpuIndex, BspIndex);
 
   //
   // Wait for the signal from BSP to Reset states/semaphore for this processor
   //
-  WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+  WaitForBsp (CpuIndex);
 
   //
   // Reset states/semaphore for this processor
@@ -900,7 +1078,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to exit SMM
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  SignalBsp (CpuIndex, BspIndex);
 }
 
 /**
@@ -1842,12 +2020,16 @@ InitializeSmmCpuSemaphores (
                  = (SPIN_LOCK *)SemaphoreAddr;
   SemaphoreAddr += SemaphoreSize;
 
-  SemaphoreAddr                          = (UINTN)SemaphoreBlock + GlobalSemaphoresSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Busy    = (SPIN_LOCK *)SemaphoreAddr;
-  SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Run     = (UINT32 *)SemaphoreAddr;
-  SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Present = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr                               = (UINTN)SemaphoreBlock + GlobalSemaphoresSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Busy         = (SPIN_LOCK *)SemaphoreAddr;
+  SemaphoreAddr                              += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Run          = (UINT32 *)SemaphoreAddr;
+  SemaphoreAddr                              += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Present      = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr                              += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Arrival      = (UINT32 *)SemaphoreAddr;
+  SemaphoreAddr                              += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.ReleaseGroup = (BOOLEAN *)SemaphoreAddr;
 
   mPFLock                       = mSmmCpuSemaphores.SemaphoreGlobal.PFLock;
   mConfigSmmCodeAccessCheckLock = mSmmCpuSemaphores.SemaphoreGlobal.CodeAccessCheckLock;
@@ -1904,9 +2086,15 @@ InitializeMpSyncData (
         (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Run + mSemaphoreSize * CpuIndex);
       mSmmMpSyncData->CpuData[CpuIndex].Present =
         (BOOLEAN *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Present + mSemaphoreSize * CpuIndex);
-      *(mSmmMpSyncData->CpuData[CpuIndex].Busy)    = 0;
-      *(mSmmMpSyncData->CpuData[CpuIndex].Run)     = 0;
-      *(mSmmMpSyncData->CpuData[CpuIndex].Present) = FALSE;
+      mSmmMpSyncData->CpuData[CpuIndex].Arrival =
+        (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Arrival + mSemaphoreSize * CpuIndex);
+      mSmmMpSyncData->CpuData[CpuIndex].ReleaseGroup =
+        (BOOLEAN *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.ReleaseGroup + mSemaphoreSize * CpuIndex);
+      *(mSmmMpSyncData->CpuData[CpuIndex].Busy)         = 0;
+      *(mSmmMpSyncData->CpuData[CpuIndex].Run)          = 0;
+      *(mSmmMpSyncData->CpuData[CpuIndex].Present)      = FALSE;
+      *(mSmmMpSyncData->CpuData[CpuIndex].Arrival)      = 0;
+      *(mSmmMpSyncData->CpuData[CpuIndex].ReleaseGroup) = FALSE;
     }
   }
 }
@@ -1933,6 +2121,7 @@ InitializeMpServiceData (
   CPUID_VERSION_INFO_EDX          RegEdx;
   UINT32                          MaxExtendedFunction;
   CPUID_VIR_PHY_ADDRESS_SIZE_EAX  VirPhyAddressSize;
+  EFI_STATUS                      Status;
 
   //
   // Determine if this CPU supports machine check
@@ -1952,7 +2141,26 @@ InitializeMpServiceData (
                        (sizeof (SMM_CPU_DATA_BLOCK) + sizeof (BOOLEAN)) * gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
   mSmmMpSyncData = (SMM_DISPATCHER_MP_SYNC_DATA *)AllocatePages (EFI_SIZE_TO_PAGES (mSmmMpSyncDataSize));
   ASSERT (mSmmMpSyncData != NULL);
-  mCpuSmmSyncMode = (SMM_CPU_SYNC_MODE)PcdGet8 (PcdCpuSmmSyncMode);
+  mCpuSmmSyncMode      = (SMM_CPU_SYNC_MODE)PcdGet8 (PcdCpuSmmSyncMode);
+  mSmmCpuSyncGroupSize = PcdGet32 (PcdCpuSmmSyncGroupSize);
+
+  //
+  // Publish the SMI rendezvous histogram for the SMI handler profile.
+  //
+  if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x3) == 0x3) {
+    mSmiRendezvousHistogram = AllocateZeroPool (sizeof (SMI_RENDEZVOUS_HISTOGRAM));
+    ASSERT (mSmiRendezvousHistogram != NULL);
+    if (mSmiRendezvousHistogram != NULL) {
+      Status = gSmst->SmmInstallConfigurationTable (
+                        gSmst,
+                        &gSmiRendezvousHistogramGuid,
+                        mSmiRendezvousHistogram,
+                        sizeof (SMI_RENDEZVOUS_HISTOGRAM)
+                        );
+      ASSERT_EFI_ERROR (Status);
+    }
+  }
+
   InitializeMpSyncData ();
 
   //
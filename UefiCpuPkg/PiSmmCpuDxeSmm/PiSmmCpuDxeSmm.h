@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AcpiS3Context.h>
 #include <Guid/MemoryAttributesTable.h>
 #include <Guid/PiSmmMemoryAttributesTable.h>
+#include <Guid/SmiHandlerProfile.h>
 
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
@@ -407,6 +408,12 @@ typedef struct {
   volatile BOOLEAN              *Present;
   PROCEDURE_TOKEN               *Token;
   EFI_STATUS                    *Status;
+  //
+  // Check-in counter of the synchronization group headed by this processor,
+  // and the flag for this processor to release the rest of its group.
+  //
+  volatile UINT32               *Arrival;
+  volatile BOOLEAN              *ReleaseGroup;
 } SMM_CPU_DATA_BLOCK;
 
 typedef enum {
@@ -454,6 +461,8 @@ typedef struct {
   volatile UINT32     *Run;
   volatile BOOLEAN    *Present;
   SPIN_LOCK           *Token;
+  volatile UINT32     *Arrival;
+  volatile BOOLEAN    *ReleaseGroup;
 } SMM_CPU_SEMAPHORE_CPU;
 
 ///
@@ -547,6 +556,19 @@ IsSyncTimerTimeout (
   IN      UINT64  Timer
   );
 
+/**
+  Get the time elapsed since a start timer.
+
+  @param Timer  The start timer from the begin.
+
+  @return The time elapsed in performance counter ticks.
+
+**/
+UINT64
+GetSyncTimerElapsed (
+  IN      UINT64  Timer
+  );
+
 /**
   Initialize IDT for SMM Stack Guard.
 
@@ -43,6 +43,7 @@ CHAR8  *mMemoryTypeStr[] = {
   "EfiMemoryMappedIOPortSpace",
   "EfiPalCode",
   "EfiPersistentMemory",
+  "EfiUnacceptedMemoryType",
   "EfiMaxMemoryType"
 };
 
@@ -54,7 +55,8 @@ CHAR8  *mResource_Type_List[] = {
   "EFI_RESOURCE_MEMORY_MAPPED_IO_PORT  ", // 0x00000004
   "EFI_RESOURCE_MEMORY_RESERVED        ", // 0x00000005
   "EFI_RESOURCE_IO_RESERVED            ", // 0x00000006
-  "EFI_RESOURCE_MAX_MEMORY_TYPE        "  // 0x00000007
+  "EFI_RESOURCE_MEMORY_UNACCEPTED      ", // 0x00000007
+  "EFI_RESOURCE_MAX_MEMORY_TYPE        "  // 0x00000008
 };
 
 typedef
@@ -391,6 +391,8 @@ BuildHobs (
 
   //
   // Get DXE FV location
+  // The DXE FV is used in place, where the bootloader loaded it, and so are the ACPI and
+  // SMBIOS tables the GUID HOBs above point to. Only the HOBs themselves are copied.
   //
   GuidHob = GetFirstGuidHob (&gUniversalPayloadExtraDataGuid);
   ASSERT (GuidHob != NULL);
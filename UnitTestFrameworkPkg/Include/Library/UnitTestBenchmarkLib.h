@@ -0,0 +1,101 @@
+/** @file
+  Provides a simple benchmark harness for host-based tests.
+
+  A benchmark runs a function a number of times to warm up caches, then a
+  number of timed repetitions. The timings of each benchmark are summarized
+  and kept, so they can be printed and written to a result file at the end of
+  the run.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef __UNIT_TEST_BENCHMARK_LIB_H__
+#define __UNIT_TEST_BENCHMARK_LIB_H__
+
+///
+/// The maximum length of a benchmark name, including the terminating NULL.
+///
+#define UNIT_TEST_BENCHMARK_NAME_LENGTH  64
+
+///
+/// Summary of the timed repetitions of a benchmark. All times are in
+/// nanoseconds.
+///
+typedef struct {
+  CHAR8     Name[UNIT_TEST_BENCHMARK_NAME_LENGTH];
+  UINT64    Repetitions;
+  UINT64    MinNs;
+  UINT64    MaxNs;
+  UINT64    MeanNs;
+  UINT64    MedianNs;
+  UINT64    StdDevNs;
+} UNIT_TEST_BENCHMARK_RESULT;
+
+/**
+  The prototype for the function a benchmark times.
+
+  A function that runs for less than a few microseconds should loop over
+  the operation itself, so that the timer resolution does not dominate the
+  timings.
+
+  @param[in]  Context  The context passed to UnitTestBenchmarkRun().
+
+**/
+typedef
+VOID
+(EFIAPI *UNIT_TEST_BENCHMARK_FUNCTION)(
+  IN VOID  *Context
+  );
+
+/**
+  Run a benchmark and record its summary.
+
+  Function is called WarmUpCount times without timing, then RepeatCount
+  times with each call timed on its own.
+
+  @param[in]   Name         The name of the benchmark. It's truncated to
+                            UNIT_TEST_BENCHMARK_NAME_LENGTH - 1 characters.
+  @param[in]   Function     The function to time.
+  @param[in]   Context      The context passed to Function.
+  @param[in]   WarmUpCount  The number of untimed calls to Function.
+  @param[in]   RepeatCount  The number of timed calls to Function.
+  @param[out]  Result       Return the summary of the timed calls.
+
+  @retval EFI_SUCCESS            The benchmark ran and its summary is recorded.
+  @retval EFI_INVALID_PARAMETER  Name or Function is NULL, or RepeatCount is 0.
+  @retval EFI_OUT_OF_RESOURCES   There is no memory for the timings.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestBenchmarkRun (
+  IN  CONST CHAR8                   *Name,
+  IN  UNIT_TEST_BENCHMARK_FUNCTION  Function,
+  IN  VOID                          *Context      OPTIONAL,
+  IN  UINTN                         WarmUpCount,
+  IN  UINTN                         RepeatCount,
+  OUT UNIT_TEST_BENCHMARK_RESULT    *Result       OPTIONAL
+  );
+
+/**
+  Print the summaries of all the benchmarks run so far, and write them to
+  the result file.
+
+  The result file is selected by two environment variables:
+    UNIT_TEST_BENCHMARK_OUTPUT=json|xml
+    UNIT_TEST_BENCHMARK_FILE=<path of the result file>
+  "xml" writes a JUnit style report with one test case per benchmark.
+  No file is written when UNIT_TEST_BENCHMARK_FILE is not set.
+
+  @retval EFI_SUCCESS       The summaries are printed and written.
+  @retval EFI_DEVICE_ERROR  The result file could not be written.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestBenchmarkSaveResults (
+  VOID
+  );
+
+#endif
@@ -0,0 +1,382 @@
+/** @file
+  Instance of Unit Test Benchmark Library based on POSIX APIs
+
+  Uses timespec_get() to time the repetitions and stdio to report the results.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+///
+/// Summaries of the benchmarks run so far.
+///
+STATIC UNIT_TEST_BENCHMARK_RESULT  *mBenchmarkResults     = NULL;
+STATIC UINTN                       mBenchmarkResultCount  = 0;
+STATIC UINTN                       mBenchmarkResultMaxNum = 0;
+
+/**
+  Return the current time in nanoseconds.
+
+  @return  The current time in nanoseconds.
+
+**/
+STATIC
+UINT64
+BenchmarkGetTimeNs (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  timespec_get (&Now, TIME_UTC);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Compare two timings for qsort().
+
+  @param[in]  Left   Pointer to the first timing.
+  @param[in]  Right  Pointer to the second timing.
+
+  @return  <0, 0 or >0 as Left is below, equal to or above Right.
+
+**/
+STATIC
+int
+BenchmarkCompareTime (
+  IN CONST VOID  *Left,
+  IN CONST VOID  *Right
+  )
+{
+  UINT64  L;
+  UINT64  R;
+
+  L = *(CONST UINT64 *)Left;
+  R = *(CONST UINT64 *)Right;
+  return (L < R) ? -1 : ((L > R) ? 1 : 0);
+}
+
+/**
+  Return the integer square root of a value.
+
+  @param[in]  Value  The value.
+
+  @return  The largest integer whose square is not above Value.
+
+**/
+STATIC
+UINT64
+BenchmarkSqrt (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Next;
+
+  if (Value < 2) {
+    return Value;
+  }
+
+  //
+  // Newton's method, starting above the root so that it decreases.
+  //
+  Root = Value;
+  Next = (Root + 1) / 2;
+  while (Next < Root) {
+    Root = Next;
+    Next = (Root + Value / Root) / 2;
+  }
+
+  return Root;
+}
+
+/**
+  Summarize the timings of a benchmark.
+
+  @param[in]   Times   The timings, they are sorted on return.
+  @param[in]   Count   The number of timings.
+  @param[out]  Result  Return the summary.
+
+**/
+STATIC
+VOID
+BenchmarkSummarize (
+  IN  UINT64                      *Times,
+  IN  UINTN                       Count,
+  OUT UNIT_TEST_BENCHMARK_RESULT  *Result
+  )
+{
+  UINTN   Index;
+  UINT64  Sum;
+  UINT64  Delta;
+  double  SquareSum;
+
+  qsort (Times, Count, sizeof (UINT64), BenchmarkCompareTime);
+
+  Sum = 0;
+  for (Index = 0; Index < Count; Index++) {
+    Sum += Times[Index];
+  }
+
+  Result->Repetitions = Count;
+  Result->MinNs       = Times[0];
+  Result->MaxNs       = Times[Count - 1];
+  Result->MeanNs      = Sum / Count;
+  if ((Count % 2) == 0) {
+    Result->MedianNs = (Times[Count / 2 - 1] + Times[Count / 2]) / 2;
+  } else {
+    Result->MedianNs = Times[Count / 2];
+  }
+
+  SquareSum = 0;
+  for (Index = 0; Index < Count; Index++) {
+    Delta      = (Times[Index] > Result->MeanNs) ? (Times[Index] - Result->MeanNs) : (Result->MeanNs - Times[Index]);
+    SquareSum += (double)Delta * (double)Delta;
+  }
+
+  Result->StdDevNs = (Count > 1) ? BenchmarkSqrt ((UINT64)(SquareSum / (Count - 1))) : 0;
+}
+
+/**
+  Run a benchmark and record its summary.
+
+  Function is called WarmUpCount times without timing, then RepeatCount
+  times with each call timed on its own.
+
+  @param[in]   Name         The name of the benchmark. It's truncated to
+                            UNIT_TEST_BENCHMARK_NAME_LENGTH - 1 characters.
+  @param[in]   Function     The function to time.
+  @param[in]   Context      The context passed to Function.
+  @param[in]   WarmUpCount  The number of untimed calls to Function.
+  @param[in]   RepeatCount  The number of timed calls to Function.
+  @param[out]  Result       Return the summary of the timed calls.
+
+  @retval EFI_SUCCESS            The benchmark ran and its summary is recorded.
+  @retval EFI_INVALID_PARAMETER  Name or Function is NULL, or RepeatCount is 0.
+  @retval EFI_OUT_OF_RESOURCES   There is no memory for the timings.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestBenchmarkRun (
+  IN  CONST CHAR8                   *Name,
+  IN  UNIT_TEST_BENCHMARK_FUNCTION  Function,
+  IN  VOID                          *Context      OPTIONAL,
+  IN  UINTN                         WarmUpCount,
+  IN  UINTN                         RepeatCount,
+  OUT UNIT_TEST_BENCHMARK_RESULT    *Result       OPTIONAL
+  )
+{
+  UINT64                      *Times;
+  UINT64                      Start;
+  UINTN                       Index;
+  UNIT_TEST_BENCHMARK_RESULT  *NewResults;
+  UNIT_TEST_BENCHMARK_RESULT  *Summary;
+
+  if ((Name == NULL) || (Function == NULL) || (RepeatCount == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mBenchmarkResultCount == mBenchmarkResultMaxNum) {
+    NewResults = realloc (mBenchmarkResults, (mBenchmarkResultMaxNum + 16) * sizeof (UNIT_TEST_BENCHMARK_RESULT));
+    if (NewResults == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mBenchmarkResults       = NewResults;
+    mBenchmarkResultMaxNum += 16;
+  }
+
+  Times = malloc (RepeatCount * sizeof (UINT64));
+  if (Times == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < WarmUpCount; Index++) {
+    Function (Context);
+  }
+
+  for (Index = 0; Index < RepeatCount; Index++) {
+    Start = BenchmarkGetTimeNs ();
+    Function (Context);
+    Times[Index] = BenchmarkGetTimeNs () - Start;
+  }
+
+  Summary = &mBenchmarkResults[mBenchmarkResultCount++];
+  memset (Summary, 0, sizeof (*Summary));
+  strncpy (Summary->Name, Name, UNIT_TEST_BENCHMARK_NAME_LENGTH - 1);
+  BenchmarkSummarize (Times, RepeatCount, Summary);
+  free (Times);
+
+  if (Result != NULL) {
+    *Result = *Summary;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write a benchmark name to a result file, escaping the characters the file
+  format reserves.
+
+  @param[in]  File  The result file.
+  @param[in]  Name  The benchmark name.
+  @param[in]  Xml   TRUE to escape for XML, FALSE to escape for JSON.
+
+**/
+STATIC
+VOID
+BenchmarkWriteName (
+  IN FILE         *File,
+  IN CONST CHAR8  *Name,
+  IN BOOLEAN      Xml
+  )
+{
+  for ( ; *Name != '\0'; Name++) {
+    if (Xml && (*Name == '&')) {
+      fputs ("&amp;", File);
+    } else if (Xml && (*Name == '<')) {
+      fputs ("&lt;", File);
+    } else if (Xml && (*Name == '>')) {
+      fputs ("&gt;", File);
+    } else if (Xml && (*Name == '"')) {
+      fputs ("&quot;", File);
+    } else if (!Xml && ((*Name == '"') || (*Name == '\\'))) {
+      fputc ('\\', File);
+      fputc (*Name, File);
+    } else if ((UINT8)*Name < 0x20) {
+      fputc (' ', File);
+    } else {
+      fputc (*Name, File);
+    }
+  }
+}
+
+/**
+  Print the summaries of all the benchmarks run so far, and write them to
+  the result file.
+
+  The result file is selected by two environment variables:
+    UNIT_TEST_BENCHMARK_OUTPUT=json|xml
+    UNIT_TEST_BENCHMARK_FILE=<path of the result file>
+  "xml" writes a JUnit style report with one test case per benchmark.
+  No file is written when UNIT_TEST_BENCHMARK_FILE is not set.
+
+  @retval EFI_SUCCESS       The summaries are printed and written.
+  @retval EFI_DEVICE_ERROR  The result file could not be written.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestBenchmarkSaveResults (
+  VOID
+  )
+{
+  UINTN                       Index;
+  UNIT_TEST_BENCHMARK_RESULT  *Result;
+  CONST CHAR8                 *Output;
+  CONST CHAR8                 *FileName;
+  FILE                        *File;
+  BOOLEAN                     Xml;
+  UINT64                      TotalNs;
+
+  printf ("%-40s %10s %12s %12s %12s %12s %12s\n", "Benchmark", "Reps", "Min(ns)", "Median(ns)", "Mean(ns)", "Max(ns)", "StdDev(ns)");
+  for (Index = 0; Index < mBenchmarkResultCount; Index++) {
+    Result = &mBenchmarkResults[Index];
+    printf (
+      "%-40s %10llu %12llu %12llu %12llu %12llu %12llu\n",
+      Result->Name,
+      (unsigned long long)Result->Repetitions,
+      (unsigned long long)Result->MinNs,
+      (unsigned long long)Result->MedianNs,
+      (unsigned long long)Result->MeanNs,
+      (unsigned long long)Result->MaxNs,
+      (unsigned long long)Result->StdDevNs
+      );
+  }
+
+  FileName = getenv ("UNIT_TEST_BENCHMARK_FILE");
+  if (FileName == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Output = getenv ("UNIT_TEST_BENCHMARK_OUTPUT");
+  Xml    = (BOOLEAN)((Output != NULL) && (strcmp (Output, "xml") == 0));
+
+  File = fopen (FileName, "w");
+  if (File == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Xml) {
+    TotalNs = 0;
+    for (Index = 0; Index < mBenchmarkResultCount; Index++) {
+      TotalNs += mBenchmarkResults[Index].MeanNs * mBenchmarkResults[Index].Repetitions;
+    }
+
+    fprintf (File, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+    fprintf (File, "<testsuites>\n");
+    fprintf (
+      File,
+      "  <testsuite name=\"Benchmarks\" tests=\"%u\" failures=\"0\" errors=\"0\" time=\"%.6f\">\n",
+      (unsigned)mBenchmarkResultCount,
+      (double)TotalNs / 1e9
+      );
+  } else {
+    fprintf (File, "{\n  \"benchmarks\": [");
+  }
+
+  for (Index = 0; Index < mBenchmarkResultCount; Index++) {
+    Result = &mBenchmarkResults[Index];
+    if (Xml) {
+      //
+      // JUnit has no place for the spread, the time of a test case is the
+      // mean and the rest goes into properties.
+      //
+      fprintf (File, "    <testcase name=\"");
+      BenchmarkWriteName (File, Result->Name, TRUE);
+      fprintf (File, "\" time=\"%.9f\">\n", (double)Result->MeanNs / 1e9);
+      fprintf (File, "      <properties>\n");
+      fprintf (File, "        <property name=\"repetitions\" value=\"%llu\" />\n", (unsigned long long)Result->Repetitions);
+      fprintf (File, "        <property name=\"min_ns\" value=\"%llu\" />\n", (unsigned long long)Result->MinNs);
+      fprintf (File, "        <property name=\"median_ns\" value=\"%llu\" />\n", (unsigned long long)Result->MedianNs);
+      fprintf (File, "        <property name=\"max_ns\" value=\"%llu\" />\n", (unsigned long long)Result->MaxNs);
+      fprintf (File, "        <property name=\"stddev_ns\" value=\"%llu\" />\n", (unsigned long long)Result->StdDevNs);
+      fprintf (File, "      </properties>\n");
+      fprintf (File, "    </testcase>\n");
+    } else {
+      fprintf (File, "%s\n    {\"name\": \"", (Index == 0) ? "" : ",");
+      BenchmarkWriteName (File, Result->Name, FALSE);
+      fprintf (
+        File,
+        "\", \"repetitions\": %llu, \"min_ns\": %llu, \"median_ns\": %llu, \"mean_ns\": %llu, \"max_ns\": %llu, \"stddev_ns\": %llu}",
+        (unsigned long long)Result->Repetitions,
+        (unsigned long long)Result->MinNs,
+        (unsigned long long)Result->MedianNs,
+        (unsigned long long)Result->MeanNs,
+        (unsigned long long)Result->MaxNs,
+        (unsigned long long)Result->StdDevNs
+        );
+    }
+  }
+
+  if (Xml) {
+    fprintf (File, "  </testsuite>\n</testsuites>\n");
+  } else {
+    fprintf (File, "\n  ]\n}\n");
+  }
+
+  if (fclose (File) != 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}